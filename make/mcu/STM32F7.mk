@@ -147,6 +147,15 @@ $(error Unknown MCU for F7 target)
 endif
 DEVICE_FLAGS    += -DHSE_VALUE=$(HSE_VALUE)
 
+# TCM_PROFILE=<file> links the functions and variables listed in it into
+# ITCM / DTCM, see support/tcm_profile.py. Do a clean build when changing it.
+ifneq ($(TCM_PROFILE),)
+ARCH_FLAGS     += -ffunction-sections -fdata-sections
+endif
+TCM_PROFILE_DIR = $(OBJECT_DIR)/$(TARGET)/tcm_profile
+LD_SCRIPT_DIRS  = $(TCM_PROFILE_DIR)
+LD_SCRIPT_DEPS  = $(TCM_PROFILE_DIR)/tcm_profile_code.ld
+
 TARGET_FLAGS    = -D$(TARGET)
 
 VCP_SRC = \
@@ -162,6 +171,7 @@ MCU_COMMON_SRC = \
             drivers/adc_stm32f7xx.c \
             drivers/audio_stm32f7xx.c \
             drivers/bus_i2c_hal.c \
+            drivers/crc_hw_stm32f7xx.c \
             drivers/dma_stm32f7xx.c \
             drivers/light_ws2811strip_hal.c \
             drivers/transponder_ir_io_hal.c \
@@ -1,5 +1,9 @@
 COMMON_SRC = \
             build/build_config.c \
+            build/cycle_profile.c \
+            build/cycle_bench.c \
+            build/loop_jitter.c \
+            build/loop_rate.c \
             build/debug.c \
             build/version.c \
             $(TARGET_DIR_SRC) \
@@ -33,6 +37,7 @@ COMMON_SRC = \
             drivers/system.c \
             drivers/timer_common.c \
             drivers/timer.c \
+            drivers/transponder_ir.c \
             drivers/transponder_ir_arcitimer.c \
             drivers/transponder_ir_ilap.c \
             drivers/transponder_ir_erlt.c \
@@ -61,6 +66,7 @@ COMMON_SRC = \
             sensors/voltage.c \
             target/config_helper.c \
             fc/fc_init.c \
+            fc/warm_boot.c \
             fc/controlrate_profile.c \
             drivers/camera_control.c \
             drivers/accgyro/gyro_sync.c \
@@ -82,6 +88,8 @@ COMMON_SRC = \
             flight/mixer.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
+            flight/dyn_lpf.c \
+            flight/rpm_filter.c \
             flight/servos.c \
             flight/servos_tricopter.c \
             interface/cli.c \
@@ -230,6 +238,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             flight/imu.c \
             flight/mixer.c \
             flight/pid.c \
+            flight/rpm_filter.c \
             rx/ibus.c \
             rx/rx.c \
             rx/rx_spi.c \
@@ -247,6 +256,8 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/gyroanalyse.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
+            build/cycle_profile.c \
+            build/loop_jitter.c \
             common/kalman.c \
             common/lulu.c \
 
@@ -34,11 +34,14 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/loop_jitter.h"
 #include "build/version.h"
 
 #include "common/axis.h"
 #include "common/encoding.h"
 #include "common/maths.h"
+#include "common/memory.h"
+#include "common/ringbuffer.h"
 #include "common/time.h"
 #include "common/utils.h"
 
@@ -88,16 +91,23 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 5);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
                   .p_ratio = 48,
                   .device = DEFAULT_BLACKBOX_DEVICE,
                   .record_acc = 1,
-                  .mode = BLACKBOX_MODE_NORMAL
+                  .mode = BLACKBOX_MODE_NORMAL,
+                  .gyro_capture_ms = 0,
+                  .gyro_capture_delta = 1,
+                  .adaptive_rate = 0,
+                  .fields_disabled_mask = 0,
+                  .compression = 0
                  );
 
 #define BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS 200
+// Header steps per loop while disarmed, for the devices that aren't rate limited
+#define BLACKBOX_DISARMED_HEADER_STEPS 8
 
 // Some macros to make writing FLIGHT_LOG_FIELD_* constants shorter:
 
@@ -176,31 +186,31 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     {"loopIteration", -1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS)},
     /* Time advances pretty steadily so the P-frame prediction is a straight line */
     {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
+    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
+    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
     /* I terms get special packed encoding in P frames: */
-    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
+    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(PID)},
+    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(PID)},
+    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(PID)},
     {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0)},
     {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1)},
     {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2)},
-    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
+    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
+    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(PID)},
     /* rcCommands are encoded together as a group in P-frames: */
-    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(RC_COMMANDS)},
+    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(RC_COMMANDS)},
+    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(RC_COMMANDS)},
     /* Throttle is always in the range [minthrottle..maxthrottle]: */
-    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(MINTHROTTLE), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(MINTHROTTLE), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_4S16), CONDITION(RC_COMMANDS)},
 
     // setpoint - define 4 fields like rcCommand to use the same encoding. setpoint[4] contains the mixer throttle
-    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(SETPOINT)},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(SETPOINT)},
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(SETPOINT)},
+    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(SETPOINT)},
 
     {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT},
     {"amperageLatest", -1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC},
@@ -219,9 +229,9 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI},
 
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
-    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(GYRO)},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(GYRO)},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(GYRO)},
     {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
     {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
     {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
@@ -229,6 +239,10 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
     {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
     {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
+    {"debug",       4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_2},
+    {"debug",       5, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_2},
+    {"debug",       6, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_2},
+    {"debug",       7, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_2},
     /* Motors only rarely drops under minthrottle (when stick falls below mincommand), so predict minthrottle for it and use *unsigned* encoding (which is large for negative numbers but more compact for positive ones): */
     {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1)},
     /* Subsequent motors base their I-frame values on the first one, P-frame values on the average of last two frames: */
@@ -285,6 +299,7 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_SEND_SYSINFO,
     BLACKBOX_STATE_PAUSED,
     BLACKBOX_STATE_RUNNING,
+    BLACKBOX_STATE_SEND_LOOP_JITTER,
     BLACKBOX_STATE_SHUTTING_DOWN,
     BLACKBOX_STATE_START_ERASE,
     BLACKBOX_STATE_ERASING,
@@ -338,9 +353,6 @@ typedef struct blackboxSlowState_s {
     bool rxFlightChannelsValid;
 } __attribute__((__packed__)) blackboxSlowState_t; // We pack this struct so that padding doesn't interfere with memcmp()
 
-//From rc_controls.c
-extern boxBitmask_t rcModeActivationMask;
-
 static BlackboxState blackboxState = BLACKBOX_STATE_DISABLED;
 
 static uint32_t blackboxLastArmingBeep = 0;
@@ -373,6 +385,18 @@ STATIC_UNIT_TESTED int16_t blackboxIInterval = 0;
 // number of flight loop iterations before logging P-frame
 STATIC_UNIT_TESTED int16_t blackboxPInterval = 0;
 STATIC_UNIT_TESTED int32_t blackboxSInterval = 0;
+
+#define BLACKBOX_ADAPTIVE_WINDOW_IFRAMES 8  // rate decisions every 8 I-frames, about a quarter of a second
+#define BLACKBOX_ADAPTIVE_RAISE_WINDOWS  8  // windows with plenty of room before logging faster again
+
+static struct {
+    uint8_t shift;              // P-frames are logged every blackboxPInterval << shift iterations
+    uint8_t quietWindows;       // consecutive windows that kept most of the buffer free
+    bool starved;               // the buffer ran low before a main frame in this window
+    int32_t maxFreeSpace;       // largest free space seen, taken as the size of the device buffer
+    int32_t minFreeSpace;       // smallest free space seen in this window
+} blackboxAdaptive;
+
 STATIC_UNIT_TESTED int32_t blackboxSlowFrameIterationTimer;
 static bool blackboxLoggedAnyFrames;
 
@@ -392,6 +416,52 @@ static blackboxMainState_t blackboxHistoryRing[3];
 // These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
 static blackboxMainState_t* blackboxHistory[3];
 
+#ifdef USE_BLACKBOX_ENCODE_TASK
+/*
+ * Main state snapshots captured by blackboxUpdate() in the pid loop, waiting to be predicted, encoded and written
+ * out by the blackbox encode task. Must be a power of two.
+ */
+#define BLACKBOX_CAPTURE_QUEUE_LENGTH 16
+
+typedef struct blackboxCapture_s {
+    blackboxMainState_t state;
+    uint32_t iteration;
+    bool intraframe;
+} blackboxCapture_t;
+
+static blackboxCapture_t blackboxCaptureQueue[BLACKBOX_CAPTURE_QUEUE_LENGTH];
+static uint8_t blackboxCaptureHead;
+static uint8_t blackboxCaptureTail;
+
+static void blackboxEncodeCapturedFrames(void);
+#endif
+
+#ifdef USE_GYRO_CAPTURE
+/*
+ * Raw gyro capture: for gyro_capture_ms after the log starts the main frames are replaced by 'R' frames carrying
+ * every gyro sample the filter chain sees, at the full gyro rate, so the raw data can be replayed offline. Each
+ * frame is the sample count and the number of samples dropped since the last frame (both unsigned VB), followed
+ * by x/y/z int16 triplets, or their signed VB deltas to the previous sample with gyro_capture_delta.
+ */
+#define BLACKBOX_GYRO_CAPTURE_RING_SIZE 1024 // bytes, power of two
+#define BLACKBOX_GYRO_CAPTURE_FRAME_SAMPLES 16
+
+typedef enum {
+    GYRO_CAPTURE_IDLE = 0,
+    GYRO_CAPTURE_RUNNING,
+    GYRO_CAPTURE_RESUMING                    // waiting for an I frame iteration to continue with the main frames
+} gyroCaptureState_e;
+
+static uint8_t *blackboxGyroCaptureBuffer;      // only allocated when the log goes to flash with gyro_capture_ms set
+static ringBuffer_t blackboxGyroCaptureRing;
+static gyroCaptureState_e blackboxGyroCaptureState;
+static timeMs_t blackboxGyroCaptureEndMs;
+static uint32_t blackboxGyroCaptureDroppedLogged;
+static int16_t blackboxGyroCapturePrevious[XYZ_AXIS_COUNT];
+
+static void blackboxGyroCaptureEnd(void);
+#endif
+
 static bool blackboxModeActivationConditionPresent = false;
 
 /**
@@ -405,6 +475,10 @@ static bool blackboxIsOnlyLoggingIntraframes(void) {
     return blackboxConfig()->p_ratio == 0;
 }
 
+static bool isFieldEnabled(FlightLogFieldSelect_e field) {
+    return (blackboxConfig()->fields_disabled_mask & (1 << field)) == 0;
+}
+
 static bool testBlackboxConditionUncached(FlightLogFieldCondition condition) {
     switch (condition) {
     case FLIGHT_LOG_FIELD_CONDITION_ALWAYS:
@@ -417,43 +491,54 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition) {
     case FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_6:
     case FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_7:
     case FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_8:
-        return getMotorCount() >= condition - FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_1 + 1;
+        return getMotorCount() >= condition - FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_1 + 1 && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_MOTOR);
     case FLIGHT_LOG_FIELD_CONDITION_TRICOPTER:
-        return mixerConfig()->mixerMode == MIXER_TRI || mixerConfig()->mixerMode == MIXER_CUSTOM_TRI;
+        return (mixerConfig()->mixerMode == MIXER_TRI || mixerConfig()->mixerMode == MIXER_CUSTOM_TRI) && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_MOTOR);
     case FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0:
     case FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_1:
     case FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_2:
-        return currentPidProfile->pid[condition - FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0].D != 0;
+        return currentPidProfile->pid[condition - FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0].D != 0 && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_PID);
     case FLIGHT_LOG_FIELD_CONDITION_MAG:
 #ifdef USE_MAG
-        return sensors(SENSOR_MAG);
+        return sensors(SENSOR_MAG) && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_MAG);
 #else
         return false;
 #endif
     case FLIGHT_LOG_FIELD_CONDITION_BARO:
 #ifdef USE_BARO
-        return sensors(SENSOR_BARO);
+        return sensors(SENSOR_BARO) && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_ALTITUDE);
 #else
         return false;
 #endif
     case FLIGHT_LOG_FIELD_CONDITION_VBAT:
-        return batteryConfig()->voltageMeterSource != VOLTAGE_METER_NONE;
+        return batteryConfig()->voltageMeterSource != VOLTAGE_METER_NONE && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_BATTERY);
     case FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC:
-        return (batteryConfig()->currentMeterSource != CURRENT_METER_NONE) && (batteryConfig()->currentMeterSource != CURRENT_METER_VIRTUAL);
+        return (batteryConfig()->currentMeterSource != CURRENT_METER_NONE) && (batteryConfig()->currentMeterSource != CURRENT_METER_VIRTUAL)
+               && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_BATTERY);
     case FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER:
 #ifdef USE_RANGEFINDER
-        return sensors(SENSOR_RANGEFINDER);
+        return sensors(SENSOR_RANGEFINDER) && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_ALTITUDE);
 #else
         return false;
 #endif
     case FLIGHT_LOG_FIELD_CONDITION_RSSI:
-        return isRssiConfigured();
+        return isRssiConfigured() && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_RSSI);
     case FLIGHT_LOG_FIELD_CONDITION_NOT_LOGGING_EVERY_FRAME:
         return blackboxConfig()->p_ratio != 1;
     case FLIGHT_LOG_FIELD_CONDITION_ACC:
-        return sensors(SENSOR_ACC) && blackboxConfig()->record_acc;
+        return sensors(SENSOR_ACC) && blackboxConfig()->record_acc && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_ACC);
     case FLIGHT_LOG_FIELD_CONDITION_DEBUG:
-        return debugMode != DEBUG_NONE;
+        return debugModes[0] != DEBUG_NONE && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_DEBUG);
+    case FLIGHT_LOG_FIELD_CONDITION_DEBUG_2:
+        return debugModes[1] != DEBUG_NONE && isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_DEBUG);
+    case FLIGHT_LOG_FIELD_CONDITION_PID:
+        return isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_PID);
+    case FLIGHT_LOG_FIELD_CONDITION_RC_COMMANDS:
+        return isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_RC_COMMANDS);
+    case FLIGHT_LOG_FIELD_CONDITION_SETPOINT:
+        return isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_SETPOINT);
+    case FLIGHT_LOG_FIELD_CONDITION_GYRO:
+        return isFieldEnabled(FLIGHT_LOG_FIELD_SELECT_GYRO);
     case FLIGHT_LOG_FIELD_CONDITION_NEVER:
         return false;
     default:
@@ -475,10 +560,23 @@ static bool testBlackboxCondition(FlightLogFieldCondition condition) {
 }
 
 static void blackboxSetState(BlackboxState newState) {
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    // Frames captured in the old state belong in front of anything the new state writes
+    blackboxEncodeCapturedFrames();
+#endif
+#ifdef USE_GYRO_CAPTURE
+    if (newState != BLACKBOX_STATE_RUNNING) {
+        blackboxGyroCaptureEnd();
+        blackboxGyroCaptureState = GYRO_CAPTURE_IDLE;
+    }
+#endif
     //Perform initial setup required for the new state
     switch (newState) {
     case BLACKBOX_STATE_PREPARE_LOG_FILE:
         blackboxLoggedAnyFrames = false;
+#ifdef USE_BLACKBOX_ENCODE_TASK
+        blackboxCaptureHead = blackboxCaptureTail = 0;
+#endif
         break;
     case BLACKBOX_STATE_SEND_HEADER:
         blackboxHeaderBudget = 0;
@@ -493,6 +591,7 @@ static void blackboxSetState(BlackboxState newState) {
         xmitState.u.fieldIndex = -1;
         break;
     case BLACKBOX_STATE_SEND_SYSINFO:
+    case BLACKBOX_STATE_SEND_LOOP_JITTER:
         xmitState.headerIndex = 0;
         break;
     case BLACKBOX_STATE_RUNNING:
@@ -507,29 +606,36 @@ static void blackboxSetState(BlackboxState newState) {
     blackboxState = newState;
 }
 
-static void writeIntraframe(void) {
+static void writeIntraframe(uint32_t iteration) {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
+    blackboxFrameBegin();
     blackboxWrite('I');
-    blackboxWriteUnsignedVB(blackboxIteration);
+    blackboxWriteUnsignedVB(iteration);
     blackboxWriteUnsignedVB(blackboxCurrent->time);
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
-    // Don't bother writing the current D term if the corresponding PID setting is zero
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x]);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_PID)) {
+        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
+        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
+        // Don't bother writing the current D term if the corresponding PID setting is zero
+        for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
+            if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
+                blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x]);
+            }
         }
+        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RC_COMMANDS)) {
+        // Write roll, pitch and yaw first:
+        blackboxWriteSigned16VBArray(blackboxCurrent->rcCommand, 3);
+        /*
+         * Write the throttle separately from the rest of the RC data so we can apply a predictor to it.
+         * Throttle lies in range [minthrottle..maxthrottle]:
+         */
+        blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE] - motorConfig()->minthrottle);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_SETPOINT)) {
+        // Write setpoint roll, pitch, yaw, and throttle
+        blackboxWriteSigned16VBArray(blackboxCurrent->setpoint, 4);
     }
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
-    // Write roll, pitch and yaw first:
-    blackboxWriteSigned16VBArray(blackboxCurrent->rcCommand, 3);
-    /*
-     * Write the throttle separately from the rest of the RC data so we can apply a predictor to it.
-     * Throttle lies in range [minthrottle..maxthrottle]:
-     */
-    blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE] - motorConfig()->minthrottle);
-    // Write setpoint roll, pitch, yaw, and throttle
-    blackboxWriteSigned16VBArray(blackboxCurrent->setpoint, 4);
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
         /*
          * Our voltage is expected to decrease over the course of the flight, so store our difference from
@@ -561,24 +667,32 @@ static void writeIntraframe(void) {
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
         blackboxWriteUnsignedVB(blackboxCurrent->rssi);
     }
-    blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GYRO)) {
+        blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
+    }
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
         blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
     }
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG16_VALUE_COUNT);
+        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG_MODE_VALUE_COUNT);
     }
-    //Motors can be below minimum output when disarmed, but that doesn't happen much
-    blackboxWriteUnsignedVB(blackboxCurrent->motor[0] - motorOutputLow);
-    //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
-    const int motorCount = getMotorCount();
-    for (int x = 1; x < motorCount; x++) {
-        blackboxWriteSignedVB(blackboxCurrent->motor[x] - blackboxCurrent->motor[0]);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG_2)) {
+        blackboxWriteSigned16VBArray(&blackboxCurrent->debug[DEBUG_MODE_VALUE_COUNT], DEBUG_MODE_VALUE_COUNT);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_1)) {
+        //Motors can be below minimum output when disarmed, but that doesn't happen much
+        blackboxWriteUnsignedVB(blackboxCurrent->motor[0] - motorOutputLow);
+        //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
+        const int motorCount = getMotorCount();
+        for (int x = 1; x < motorCount; x++) {
+            blackboxWriteSignedVB(blackboxCurrent->motor[x] - blackboxCurrent->motor[0]);
+        }
     }
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
         //Assume the tail spends most of its time around the center
         blackboxWriteSignedVB(blackboxCurrent->servo[5] - 1500);
     }
+    blackboxFrameEnd();
     //Rotate our history buffers:
     //The current state becomes the new "before" state
     blackboxHistory[1] = blackboxHistory[0];
@@ -603,6 +717,7 @@ static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHist
 static void writeInterframe(void) {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
     blackboxMainState_t *blackboxLast = blackboxHistory[1];
+    blackboxFrameBegin();
     blackboxWrite('P');
     //No need to store iteration count since its delta is always 1
     /*
@@ -612,25 +727,27 @@ static void writeInterframe(void) {
     blackboxWriteSignedVB((int32_t) (blackboxHistory[0]->time - 2 * blackboxHistory[1]->time + blackboxHistory[2]->time));
     int32_t deltas[8];
     int32_t setpointDeltas[4];
-    arraySubInt32(deltas, blackboxCurrent->axisPID_P, blackboxLast->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
-    /*
-     * The PID I field changes very slowly, most of the time +-2, so use an encoding
-     * that can pack all three fields into one byte in that situation.
-     */
-    arraySubInt32(deltas, blackboxCurrent->axisPID_I, blackboxLast->axisPID_I, XYZ_AXIS_COUNT);
-    blackboxWriteTag2_3S32(deltas);
-    /*
-     * The PID D term is frequently set to zero for yaw, which makes the result from the calculation
-     * always zero. So don't bother recording D results when PID D terms are zero.
-     */
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x] - blackboxLast->axisPID_D[x]);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_PID)) {
+        arraySubInt32(deltas, blackboxCurrent->axisPID_P, blackboxLast->axisPID_P, XYZ_AXIS_COUNT);
+        blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
+        /*
+         * The PID I field changes very slowly, most of the time +-2, so use an encoding
+         * that can pack all three fields into one byte in that situation.
+         */
+        arraySubInt32(deltas, blackboxCurrent->axisPID_I, blackboxLast->axisPID_I, XYZ_AXIS_COUNT);
+        blackboxWriteTag2_3S32(deltas);
+        /*
+         * The PID D term is frequently set to zero for yaw, which makes the result from the calculation
+         * always zero. So don't bother recording D results when PID D terms are zero.
+         */
+        for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
+            if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
+                blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x] - blackboxLast->axisPID_D[x]);
+            }
         }
+        arraySubInt32(deltas, blackboxCurrent->axisPID_F, blackboxLast->axisPID_F, XYZ_AXIS_COUNT);
+        blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
     }
-    arraySubInt32(deltas, blackboxCurrent->axisPID_F, blackboxLast->axisPID_F, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
     /*
      * RC tends to stay the same or fairly small for many frames at a time, so use an encoding that
      * can pack multiple values per byte:
@@ -639,8 +756,12 @@ static void writeInterframe(void) {
         deltas[x] = blackboxCurrent->rcCommand[x] - blackboxLast->rcCommand[x];
         setpointDeltas[x] = blackboxCurrent->setpoint[x] - blackboxLast->setpoint[x];
     }
-    blackboxWriteTag8_4S16(deltas);
-    blackboxWriteTag8_4S16(setpointDeltas);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RC_COMMANDS)) {
+        blackboxWriteTag8_4S16(deltas);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_SETPOINT)) {
+        blackboxWriteTag8_4S16(setpointDeltas);
+    }
     //Check for sensors that are updated periodically (so deltas are normally zero)
     int optionalFieldCount = 0;
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
@@ -671,17 +792,25 @@ static void writeInterframe(void) {
     }
     blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
     //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GYRO)) {
+        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC), XYZ_AXIS_COUNT);
+    }
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
         blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
     }
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG16_VALUE_COUNT);
+        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG_MODE_VALUE_COUNT);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG_2)) {
+        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug) + DEBUG_MODE_VALUE_COUNT * sizeof(int16_t), DEBUG_MODE_VALUE_COUNT);
+    }
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AT_LEAST_MOTORS_1)) {
+        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor), getMotorCount());
     }
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
         blackboxWriteSignedVB(blackboxCurrent->servo[5] - blackboxLast->servo[5]);
     }
+    blackboxFrameEnd();
     //Rotate our history buffers
     blackboxHistory[2] = blackboxHistory[1];
     blackboxHistory[1] = blackboxHistory[0];
@@ -689,10 +818,34 @@ static void writeInterframe(void) {
     blackboxLoggedAnyFrames = true;
 }
 
+#ifdef USE_BLACKBOX_ENCODE_TASK
+// Run the predictors and encoders over every captured snapshot, in capture order
+static void blackboxEncodeCapturedFrames(void) {
+    while (blackboxCaptureTail != blackboxCaptureHead) {
+        const blackboxCapture_t *capture = &blackboxCaptureQueue[blackboxCaptureTail & (BLACKBOX_CAPTURE_QUEUE_LENGTH - 1)];
+        *blackboxHistory[0] = capture->state;
+        if (capture->intraframe) {
+            writeIntraframe(capture->iteration);
+        } else {
+            writeInterframe();
+        }
+        blackboxCaptureTail++;
+    }
+}
+
+void blackboxEncodeUpdate(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    blackboxEncodeCapturedFrames();
+}
+#endif
+
 /* Write the contents of the global "slowHistory" to the log as an "S" frame. Because this data is logged so
  * infrequently, delta updates are not reasonable, so we log independent frames. */
 static void writeSlowFrame(void) {
     int32_t values[3];
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    blackboxEncodeCapturedFrames();
+#endif
     blackboxWrite('S');
     blackboxWriteUnsignedVB(slowHistory.flightModeFlags);
     blackboxWriteUnsignedVB(slowHistory.stateFlags);
@@ -754,6 +907,9 @@ void blackboxValidateConfig(void) {
     case BLACKBOX_DEVICE_SDCARD:
 #endif
     case BLACKBOX_DEVICE_SERIAL:
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+#endif
         // Device supported, leave the setting alone
         break;
     default:
@@ -767,6 +923,52 @@ static void blackboxResetIterationTimers(void) {
     blackboxIFrameIndex = 0;
     blackboxPFrameIndex = 0;
     blackboxSlowFrameIterationTimer = 0;
+    // Every log starts at the configured rate
+    memset(&blackboxAdaptive, 0, sizeof(blackboxAdaptive));
+    blackboxAdaptive.minFreeSpace = INT32_MAX;
+}
+
+/*
+ * Adaptive rate: before each main frame see how much room the device has left. The largest free space seen is
+ * taken as the size of its buffer, it is reached whenever the device catches up. Once per window the P interval is
+ * doubled if the buffer ran low, and halved again after a few windows that kept most of it free. Changes take effect
+ * at an I-frame and are marked with a LOGGING_RATE event. The fields logged stay those declared in the header.
+ */
+static void blackboxAdaptiveRateSample(void) {
+    const int32_t freeSpace = blackboxDeviceGetFreeSpace();
+    blackboxAdaptive.maxFreeSpace = MAX(blackboxAdaptive.maxFreeSpace, freeSpace);
+    blackboxAdaptive.minFreeSpace = MIN(blackboxAdaptive.minFreeSpace, freeSpace);
+    if (freeSpace < blackboxAdaptive.maxFreeSpace / 4) {
+        blackboxAdaptive.starved = true;
+    }
+}
+
+static void blackboxAdaptiveRateUpdate(void) {
+    uint8_t shift = blackboxAdaptive.shift;
+    if (blackboxAdaptive.starved) {
+        if ((blackboxPInterval << (shift + 1)) <= blackboxIInterval) {
+            shift++;
+        }
+        blackboxAdaptive.quietWindows = 0;
+    } else if (blackboxAdaptive.minFreeSpace >= blackboxAdaptive.maxFreeSpace * 3 / 4) {
+        if (++blackboxAdaptive.quietWindows >= BLACKBOX_ADAPTIVE_RAISE_WINDOWS && shift > 0) {
+            shift--;
+            blackboxAdaptive.quietWindows = 0;
+        }
+    } else {
+        blackboxAdaptive.quietWindows = 0;
+    }
+    blackboxAdaptive.starved = false;
+    blackboxAdaptive.minFreeSpace = INT32_MAX;
+
+    if (shift != blackboxAdaptive.shift) {
+        blackboxAdaptive.shift = shift;
+        flightLogEvent_loggingRate_t rate = {
+            .logIteration = blackboxIteration,
+            .pInterval = blackboxPInterval << shift,
+        };
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RATE, (flightLogEventData_t *)&rate);
+    }
 }
 
 /**
@@ -808,13 +1010,22 @@ void blackboxFinish(void) {
     switch (blackboxState) {
     case BLACKBOX_STATE_DISABLED:
     case BLACKBOX_STATE_STOPPED:
+    case BLACKBOX_STATE_SEND_LOOP_JITTER:
     case BLACKBOX_STATE_SHUTTING_DOWN:
         // We're already stopped/shutting down
         break;
     case BLACKBOX_STATE_RUNNING:
     case BLACKBOX_STATE_PAUSED:
+#ifdef USE_GYRO_CAPTURE
+        blackboxGyroCaptureEnd();
+#endif
         blackboxLogEvent(FLIGHT_LOG_EVENT_LOG_END, NULL);
+#ifdef USE_LOOP_JITTER
+        blackboxSetState(BLACKBOX_STATE_SEND_LOOP_JITTER);
+        break;
+#else
         FALLTHROUGH;
+#endif
     default:
         blackboxSetState(BLACKBOX_STATE_SHUTTING_DOWN);
     }
@@ -844,6 +1055,24 @@ static void stopInTestMode(void) {
         startedLoggingInTestMode = false;
     }
 }
+
+/**
+ * Pre-arm Blackbox Logging
+ *
+ * With a pre-arm switch the log is opened and its headers are written while disarmed, so the first
+ * frames land as soon as the craft arms. Frames aren't logged until then.
+ */
+static bool startedLoggingOnPrearm = false;
+
+static bool shouldStartOnPrearm(void) {
+    if (!isModeActivationConditionPresent(BOXPREARM) || !IS_RC_MODE_ACTIVE(BOXPREARM) || ARMING_FLAG(WAS_ARMED_WITH_PREARM)) {
+        return false;
+    }
+    if (blackboxConfig()->device == BLACKBOX_DEVICE_SERIAL && findSharedSerialPort(FUNCTION_BLACKBOX, FUNCTION_MSP)) {
+        return false; // the configurator still needs the port while disarmed
+    }
+    return true;
+}
 /**
  * We are going to monitor the MSP_SET_MOTOR target variables motor_disarmed[] for values other than minthrottle
  * on reading a value (i.e. the user is testing the motors), then we enable test mode logging;
@@ -868,6 +1097,9 @@ static bool inMotorTestMode(void) {
 
 #ifdef USE_GPS
 static void writeGPSHomeFrame(void) {
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    blackboxEncodeCapturedFrames();
+#endif
     blackboxWrite('H');
     blackboxWriteSignedVB(GPS_home[0]);
     blackboxWriteSignedVB(GPS_home[1]);
@@ -877,6 +1109,9 @@ static void writeGPSHomeFrame(void) {
 }
 
 static void writeGPSFrame(timeUs_t currentTimeUs) {
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    blackboxEncodeCapturedFrames();
+#endif
     blackboxWrite('G');
     /*
      * If we're logging every frame, then a GPS frame always appears just after a frame with the
@@ -903,9 +1138,8 @@ static void writeGPSFrame(timeUs_t currentTimeUs) {
 /**
  * Fill the current state of the blackbox using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs) {
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs) {
 #ifndef UNIT_TEST
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
     blackboxCurrent->time = currentTimeUs;
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
         blackboxCurrent->axisPID_P[i] = pidData[i].P;
@@ -935,8 +1169,8 @@ static void loadMainState(timeUs_t currentTimeUs) {
     for (int i = 0; i < motorCount; i++) {
         blackboxCurrent->motor[i] = motor[i];
     }
-    blackboxCurrent->vbatLatest = getBatteryVoltageLatest();
-    blackboxCurrent->amperageLatest = getAmperageLatest();
+    blackboxCurrent->vbatLatest = getBatteryVoltageSample();
+    blackboxCurrent->amperageLatest = getAmperageSample();
 #ifdef USE_BARO
     blackboxCurrent->BaroAlt = baro.BaroAlt;
 #endif
@@ -950,6 +1184,7 @@ static void loadMainState(timeUs_t currentTimeUs) {
     blackboxCurrent->servo[5] = servo[5];
 #endif
 #else
+    UNUSED(blackboxCurrent);
     UNUSED(currentTimeUs);
 #endif // UNIT_TEST
 }
@@ -1121,6 +1356,12 @@ static bool blackboxWriteSysinfo(void) {
         }
         );
         BLACKBOX_PRINT_HEADER_LINE("looptime", "%d",                        gyro.targetLooptime);
+#ifdef USE_GYRO_CAPTURE
+        BLACKBOX_PRINT_HEADER_LINE("gyro_capture", "%d,%d",                 blackboxConfig()->gyro_capture_ms, blackboxConfig()->gyro_capture_delta);
+        BLACKBOX_PRINT_HEADER_LINE("adaptive_rate", "%d",                   blackboxConfig()->adaptive_rate);
+        BLACKBOX_PRINT_HEADER_LINE("fields_disabled_mask", "%d",            blackboxConfig()->fields_disabled_mask);
+        BLACKBOX_PRINT_HEADER_LINE("gyro_capture_scale", "0x%x",            castFloatBytesToInt(gyroCaptureScale()));
+#endif
         BLACKBOX_PRINT_HEADER_LINE("gyro_sync_denom", "%d",                 gyroConfig()->gyro_sync_denom);
         BLACKBOX_PRINT_HEADER_LINE("pid_process_denom", "%d",               pidConfig()->pid_process_denom);
         BLACKBOX_PRINT_HEADER_LINE("thr_mid", "%d",                         currentControlRateProfile->thrMid8);
@@ -1180,6 +1421,10 @@ static bool blackboxWriteSysinfo(void) {
         BLACKBOX_PRINT_HEADER_LINE("dterm_lowpass2_hz_roll", "%d",          currentPidProfile->dFilter[ROLL].dLpf2);
         BLACKBOX_PRINT_HEADER_LINE("dterm_lowpass2_hz_pitch", "%d",         currentPidProfile->dFilter[PITCH].dLpf2);
         BLACKBOX_PRINT_HEADER_LINE("dterm_lowpass2_hz_yaw", "%d",           currentPidProfile->dFilter[YAW].dLpf2);
+#ifdef USE_DYN_LPF
+        BLACKBOX_PRINT_HEADER_LINE("dyn_lpf_dterm_hz", "%d,%d",             currentPidProfile->dyn_lpf_dterm_min_hz,
+                                   currentPidProfile->dyn_lpf_dterm_max_hz);
+#endif
 #ifdef USE_GYRO_DATA_ANALYSE
         BLACKBOX_PRINT_HEADER_LINE("dterm_dyn_notch_enable", "%d",          currentPidProfile->dtermDynNotch);
         BLACKBOX_PRINT_HEADER_LINE("dterm_dyn_notch_q", "%d",               currentPidProfile->dterm_dyn_notch_q);
@@ -1232,6 +1477,11 @@ static bool blackboxWriteSysinfo(void) {
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_hz_roll", "%d",            gyroConfig()->gyro_lowpass_hz[ROLL]);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_hz_pitch", "%d",           gyroConfig()->gyro_lowpass_hz[PITCH]);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_hz_yaw", "%d",             gyroConfig()->gyro_lowpass_hz[YAW]);
+#ifdef USE_DYN_LPF
+        BLACKBOX_PRINT_HEADER_LINE("dyn_lpf_gyro_hz", "%d,%d",              gyroConfig()->dyn_lpf_gyro_min_hz,
+                                   gyroConfig()->dyn_lpf_gyro_max_hz);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_lpf_source", "%d",                  gyroConfig()->dyn_lpf_source);
+#endif
 #ifdef USE_GYRO_LPF2
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass2_type", "%d",              gyroConfig()->gyro_lowpass2_type);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass2_hz_roll", "%d",           gyroConfig()->gyro_lowpass2_hz[ROLL]);
@@ -1277,6 +1527,7 @@ static bool blackboxWriteSysinfo(void) {
         BLACKBOX_PRINT_HEADER_LINE("dshot_idle_value", "%d",                motorConfig()->digitalIdleOffsetValue);
         BLACKBOX_PRINT_HEADER_LINE("motor_poles", "%d",                     motorConfig()->motorPoleCount);
         BLACKBOX_PRINT_HEADER_LINE("debug_mode", "%d",                      systemConfig()->debug_mode);
+        BLACKBOX_PRINT_HEADER_LINE("debug_mode_2", "%d",                    systemConfig()->debug_mode_2);
         BLACKBOX_PRINT_HEADER_LINE("features", "%d",                        featureConfig()->enabledFeatures);
 #ifdef USE_RC_SMOOTHING_FILTER
         BLACKBOX_PRINT_HEADER_LINE("rc_smoothing_type", "%d",               rxConfig()->rc_smoothing_type);
@@ -1307,6 +1558,52 @@ static bool blackboxWriteSysinfo(void) {
     return false;
 }
 
+#ifdef USE_LOOP_JITTER
+#define BLACKBOX_LOOP_JITTER_BUCKETS_PER_LINE 11
+
+/**
+ * Transmit a portion of the loop jitter histogram recorded over the flight. It follows the "End of log" event, where
+ * log decoders stop parsing, so the header style lines don't disturb the frame stream. Call the first time with
+ * xmitState.headerIndex == 0. Returns true iff transmission is complete.
+ */
+static bool blackboxWriteLoopJitter(void) {
+    // Longest line is a full row of buckets with ten digit counts, give up on a port whose buffer can never hold it
+    const blackboxBufferReserveStatus_e reserveStatus = blackboxDeviceReserveBufferSpace(160);
+    if (reserveStatus != BLACKBOX_RESERVE_SUCCESS) {
+        return reserveStatus == BLACKBOX_RESERVE_PERMANENT_FAILURE;
+    }
+    const loopJitter_t *jitter = getLoopJitter();
+    switch (xmitState.headerIndex) {
+    case 0:
+        blackboxPrintfHeaderLine("loop_jitter_looptime", "%u", jitter->targetLooptimeUs);
+        break;
+    case 1:
+        blackboxPrintfHeaderLine("loop_jitter_samples", "%u", jitter->count);
+        break;
+    case 2:
+        blackboxPrintfHeaderLine("loop_jitter_min_max", "%d,%d", jitter->minDeviationUs, jitter->maxDeviationUs);
+        break;
+    default: {
+        // One line per row of buckets, named after the deviation of its first bucket
+        const int firstBucket = (xmitState.headerIndex - 3) * BLACKBOX_LOOP_JITTER_BUCKETS_PER_LINE;
+        if (firstBucket >= LOOP_JITTER_BUCKET_COUNT) {
+            return true;
+        }
+        const int lastBucket = MIN(firstBucket + BLACKBOX_LOOP_JITTER_BUCKETS_PER_LINE, LOOP_JITTER_BUCKET_COUNT);
+        blackboxHeaderBudget -= blackboxPrintf("H loop_jitter_%d:", loopJitterBucketDeviationUs(firstBucket));
+        for (int i = firstBucket; i < lastBucket; i++) {
+            blackboxHeaderBudget -= blackboxPrintf(i == firstBucket ? "%u" : ",%u", jitter->buckets[i]);
+        }
+        blackboxWrite('\n');
+        blackboxHeaderBudget--;
+        break;
+    }
+    }
+    xmitState.headerIndex++;
+    return false;
+}
+#endif
+
 /**
  * Write the given event to the log immediately
  */
@@ -1315,6 +1612,9 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data) {
     if (!(blackboxState == BLACKBOX_STATE_RUNNING || blackboxState == BLACKBOX_STATE_PAUSED)) {
         return;
     }
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    blackboxEncodeCapturedFrames();
+#endif
     //Shared header for event frames
     blackboxWrite('E');
     blackboxWrite(event);
@@ -1340,6 +1640,10 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data) {
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
         break;
+    case FLIGHT_LOG_EVENT_LOGGING_RATE:
+        blackboxWriteUnsignedVB(data->loggingRate.logIteration);
+        blackboxWriteUnsignedVB(data->loggingRate.pInterval);
+        break;
     case FLIGHT_LOG_EVENT_LOG_END:
         blackboxWriteString("End of log");
         blackboxWrite(0);
@@ -1403,15 +1707,126 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void) {
         blackboxLoopIndex = 0;
         blackboxIFrameIndex++;
         blackboxPFrameIndex = 0;
-    } else if (++blackboxPFrameIndex >= blackboxPInterval) {
+    } else if (++blackboxPFrameIndex >= blackboxPInterval << blackboxAdaptive.shift) {
         blackboxPFrameIndex = 0;
     }
 }
 
+#ifdef USE_GYRO_CAPTURE
+static void blackboxGyroCaptureBegin(void) {
+    if (!blackboxConfig()->gyro_capture_ms || blackboxConfig()->device != BLACKBOX_DEVICE_FLASH || !blackboxGyroCaptureBuffer) {
+        return;
+    }
+    ringBufferInit(&blackboxGyroCaptureRing, blackboxGyroCaptureBuffer, BLACKBOX_GYRO_CAPTURE_RING_SIZE);
+    memset(blackboxGyroCapturePrevious, 0, sizeof(blackboxGyroCapturePrevious));
+    blackboxGyroCaptureDroppedLogged = 0;
+    blackboxGyroCaptureEndMs = millis() + blackboxConfig()->gyro_capture_ms;
+    blackboxGyroCaptureState = GYRO_CAPTURE_RUNNING;
+    gyroCaptureStart(&blackboxGyroCaptureRing);
+}
+
+static void writeGyroCaptureFrame(int sampleCount) {
+    const uint32_t dropped = gyroCaptureDropped();
+    blackboxFrameBegin();
+    blackboxWrite('R');
+    blackboxWriteUnsignedVB(sampleCount);
+    blackboxWriteUnsignedVB(dropped - blackboxGyroCaptureDroppedLogged);
+    blackboxGyroCaptureDroppedLogged = dropped;
+    for (int i = 0; i < sampleCount; i++) {
+        int16_t sample[XYZ_AXIS_COUNT];
+        ringBufferRead(&blackboxGyroCaptureRing, sample, sizeof(sample));
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            if (blackboxConfig()->gyro_capture_delta) {
+                blackboxWriteSignedVB(sample[axis] - blackboxGyroCapturePrevious[axis]);
+                blackboxGyroCapturePrevious[axis] = sample[axis];
+            } else {
+                blackboxWriteS16(sample[axis]);
+            }
+        }
+    }
+    blackboxFrameEnd();
+}
+
+// Write out the captured samples in frames of BLACKBOX_GYRO_CAPTURE_FRAME_SAMPLES, or all of them with flush
+static void writeGyroCaptureFrames(bool flush) {
+    int pending = ringBufferUsed(&blackboxGyroCaptureRing) / (XYZ_AXIS_COUNT * sizeof(int16_t));
+    while (pending >= BLACKBOX_GYRO_CAPTURE_FRAME_SAMPLES || (flush && pending > 0)) {
+        const int sampleCount = MIN(pending, BLACKBOX_GYRO_CAPTURE_FRAME_SAMPLES);
+        writeGyroCaptureFrame(sampleCount);
+        pending -= sampleCount;
+    }
+}
+
+static void blackboxGyroCaptureEnd(void) {
+    if (blackboxGyroCaptureState == GYRO_CAPTURE_RUNNING) {
+        gyroCaptureStop();
+        writeGyroCaptureFrames(true);
+        blackboxGyroCaptureState = GYRO_CAPTURE_RESUMING;
+    }
+}
+
+// Returns true while the capture takes the place of the main frames
+static bool blackboxGyroCaptureUpdate(timeUs_t currentTimeUs) {
+    switch (blackboxGyroCaptureState) {
+    case GYRO_CAPTURE_RUNNING:
+        if (cmp32(millis(), blackboxGyroCaptureEndMs) >= 0) {
+            blackboxGyroCaptureEnd();
+        } else {
+            writeGyroCaptureFrames(false);
+        }
+        return true;
+    case GYRO_CAPTURE_RESUMING:
+        // P frames need an I frame to predict from, and the decoder needs to know about the time skip
+        if (!blackboxShouldLogIFrame()) {
+            return true;
+        }
+        flightLogEvent_loggingResume_t resume;
+        resume.logIteration = blackboxIteration;
+        resume.currentTime = currentTimeUs;
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *) &resume);
+        blackboxGyroCaptureState = GYRO_CAPTURE_IDLE;
+        return false;
+    default:
+        return false;
+    }
+}
+#endif
+
+/*
+ * Log an I or P frame of the current state. With the encode task the pid loop only takes a snapshot, the task
+ * encodes and writes it out later.
+ */
+static void logMainFrame(timeUs_t currentTimeUs, bool intraframe) {
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    if ((uint8_t)(blackboxCaptureHead - blackboxCaptureTail) == BLACKBOX_CAPTURE_QUEUE_LENGTH) {
+        // The encode task fell behind, catch up here rather than lose a frame the next P frames are predicted from
+        blackboxEncodeCapturedFrames();
+    }
+    blackboxCapture_t *capture = &blackboxCaptureQueue[blackboxCaptureHead & (BLACKBOX_CAPTURE_QUEUE_LENGTH - 1)];
+    loadMainState(&capture->state, currentTimeUs);
+    capture->iteration = blackboxIteration;
+    capture->intraframe = intraframe;
+    blackboxCaptureHead++;
+#else
+    loadMainState(blackboxHistory[0], currentTimeUs);
+    if (intraframe) {
+        writeIntraframe(blackboxIteration);
+    } else {
+        writeInterframe();
+    }
+#endif
+}
+
 // Called once every FC loop in order to log the current state
 STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
     // Write a keyframe every blackboxIInterval frames so we can resynchronise upon missing frames
     if (blackboxShouldLogIFrame()) {
+        if (blackboxConfig()->adaptive_rate && blackboxPInterval) {
+            blackboxAdaptiveRateSample();
+            if (blackboxIFrameIndex % BLACKBOX_ADAPTIVE_WINDOW_IFRAMES == 0) {
+                blackboxAdaptiveRateUpdate();
+            }
+        }
         /*
          * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
          * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
@@ -1419,8 +1834,7 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
         if (blackboxIsOnlyLoggingIntraframes()) {
             writeSlowFrameIfNeeded();
         }
-        loadMainState(currentTimeUs);
-        writeIntraframe();
+        logMainFrame(currentTimeUs, true);
     } else {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
@@ -1429,9 +1843,11 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
              * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
              * So only log slow frames during loop iterations where we log a main frame.
              */
+            if (blackboxConfig()->adaptive_rate) {
+                blackboxAdaptiveRateSample();
+            }
             writeSlowFrameIfNeeded();
-            loadMainState(currentTimeUs);
-            writeInterframe();
+            logMainFrame(currentTimeUs, false);
         }
 #ifdef USE_GPS
         if (feature(FEATURE_GPS)) {
@@ -1452,26 +1868,10 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
 }
 
 /**
- * Call each flight loop iteration to perform blackbox logging.
+ * Take one step through the log headers, or the wait for them to drain, in the SEND_* states.
  */
-void blackboxUpdate(timeUs_t currentTimeUs) {
+static void blackboxSendHeaderStep(void) {
     switch (blackboxState) {
-    case BLACKBOX_STATE_STOPPED:
-        if (ARMING_FLAG(ARMED)) {
-            blackboxOpen();
-            blackboxStart();
-        }
-#ifdef USE_FLASHFS
-        if (IS_RC_MODE_ACTIVE(BOXBLACKBOXERASE)) {
-            blackboxSetState(BLACKBOX_STATE_START_ERASE);
-        }
-#endif
-        break;
-    case BLACKBOX_STATE_PREPARE_LOG_FILE:
-        if (blackboxDeviceBeginLog()) {
-            blackboxSetState(BLACKBOX_STATE_SEND_HEADER);
-        }
-        break;
     case BLACKBOX_STATE_SEND_HEADER:
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0 and startTime is intialised
@@ -1479,7 +1879,7 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
          * Once the UART has had time to init, transmit the header in chunks so we don't overflow its transmit
          * buffer, overflow the OpenLog's buffer, or keep the main loop busy for too long.
          */
-        if (millis() > xmitState.u.startTime + 100) {
+        if (blackboxConfig()->device != BLACKBOX_DEVICE_SERIAL || millis() > xmitState.u.startTime + 100) {
             if (blackboxDeviceReserveBufferSpace(BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION) == BLACKBOX_RESERVE_SUCCESS) {
                 for (int i = 0; i < BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION && blackboxHeader[xmitState.headerIndex] != '\0'; i++, xmitState.headerIndex++) {
                     blackboxWrite(blackboxHeader[xmitState.headerIndex]);
@@ -1542,9 +1942,71 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
              */
             if (blackboxDeviceFlushForce()) {
                 blackboxSetState(BLACKBOX_STATE_RUNNING);
+#ifdef USE_GYRO_CAPTURE
+                if (!startedLoggingOnPrearm) {
+                    blackboxGyroCaptureBegin();
+                }
+#endif
             }
         }
         break;
+    default:
+        break;
+    }
+}
+
+static bool blackboxIsSendingHeader(void) {
+    return blackboxState >= BLACKBOX_STATE_SEND_HEADER && blackboxState <= BLACKBOX_STATE_SEND_SYSINFO;
+}
+
+/**
+ * Call each flight loop iteration to perform blackbox logging.
+ */
+void blackboxUpdate(timeUs_t currentTimeUs) {
+    if (startedLoggingOnPrearm && !ARMING_FLAG(ARMED) && !IS_RC_MODE_ACTIVE(BOXPREARM)) {
+        // Pre-arm released without arming, close the log that was waiting for it
+        startedLoggingOnPrearm = false;
+        blackboxFinish();
+    }
+    switch (blackboxState) {
+    case BLACKBOX_STATE_STOPPED:
+        if (ARMING_FLAG(ARMED) || (blackboxConfig()->mode == BLACKBOX_MODE_NORMAL && shouldStartOnPrearm())) {
+            blackboxOpen();
+            blackboxStart();
+            startedLoggingOnPrearm = !ARMING_FLAG(ARMED);
+        }
+#ifdef USE_FLASHFS
+        if (IS_RC_MODE_ACTIVE(BOXBLACKBOXERASE)) {
+            blackboxSetState(BLACKBOX_STATE_START_ERASE);
+        }
+#endif
+        if (blackboxState == BLACKBOX_STATE_STOPPED) {
+            blackboxDeviceIdle();
+        }
+        break;
+    case BLACKBOX_STATE_PREPARE_LOG_FILE:
+        if (blackboxDeviceBeginLog()) {
+            blackboxSetState(BLACKBOX_STATE_SEND_HEADER);
+        }
+        break;
+    case BLACKBOX_STATE_SEND_HEADER:
+    case BLACKBOX_STATE_SEND_MAIN_FIELD_HEADER:
+#ifdef USE_GPS
+    case BLACKBOX_STATE_SEND_GPS_H_HEADER:
+    case BLACKBOX_STATE_SEND_GPS_G_HEADER:
+#endif
+    case BLACKBOX_STATE_SEND_SLOW_HEADER:
+    case BLACKBOX_STATE_SEND_SYSINFO: {
+        /*
+         * Disarmed the loop has time to spare, so take several steps while the device has room for them. A serial
+         * logger stays at one step, its header budget is what keeps the OpenLog from overflowing.
+         */
+        const int steps = (ARMING_FLAG(ARMED) || blackboxConfig()->device == BLACKBOX_DEVICE_SERIAL) ? 1 : BLACKBOX_DISARMED_HEADER_STEPS;
+        for (int i = 0; i < steps && blackboxIsSendingHeader(); i++) {
+            blackboxSendHeaderStep();
+        }
+        break;
+    }
     case BLACKBOX_STATE_PAUSED:
         // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
@@ -1561,14 +2023,36 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
         break;
     case BLACKBOX_STATE_RUNNING:
         // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
+        if (startedLoggingOnPrearm) {
+            if (!ARMING_FLAG(ARMED)) {
+                // Headers are out, hold the iteration at 0 so the first armed loop writes an I-frame
+                break;
+            }
+            startedLoggingOnPrearm = false;
+#ifdef USE_GYRO_CAPTURE
+            blackboxGyroCaptureBegin();
+#endif
+        }
         // Prevent the Pausing of the log on the mode switch if in Motor Test Mode
         if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
             blackboxSetState(BLACKBOX_STATE_PAUSED);
         } else {
-            blackboxLogIteration(currentTimeUs);
+#ifdef USE_GYRO_CAPTURE
+            if (!blackboxGyroCaptureUpdate(currentTimeUs))
+#endif
+                blackboxLogIteration(currentTimeUs);
         }
         blackboxAdvanceIterationTimers();
         break;
+#ifdef USE_LOOP_JITTER
+    case BLACKBOX_STATE_SEND_LOOP_JITTER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0
+        if (blackboxWriteLoopJitter()) {
+            blackboxSetState(BLACKBOX_STATE_SHUTTING_DOWN);
+        }
+        break;
+#endif
     case BLACKBOX_STATE_SHUTTING_DOWN:
         //On entry of this state, startTime is set
         /*
@@ -1677,6 +2161,17 @@ void blackboxInit(void) {
         blackboxPInterval = blackboxIInterval /  blackboxConfig()->p_ratio;
     }
     if (blackboxConfig()->device) {
+        blackboxFrameBufferInit();
+#ifdef USE_BLACKBOX_COMPRESSION
+        if (blackboxConfig()->compression && blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
+            blackboxCompressionInit();
+        }
+#endif
+#ifdef USE_GYRO_CAPTURE
+        if (blackboxConfig()->gyro_capture_ms && blackboxConfig()->device == BLACKBOX_DEVICE_FLASH && !blackboxGyroCaptureBuffer) {
+            blackboxGyroCaptureBuffer = memAllocate(BLACKBOX_GYRO_CAPTURE_RING_SIZE);
+        }
+#endif
         blackboxSetState(BLACKBOX_STATE_STOPPED);
     } else {
         blackboxSetState(BLACKBOX_STATE_DISABLED);
@@ -33,7 +33,10 @@ typedef enum BlackboxDevice {
 #ifdef USE_SDCARD
     BLACKBOX_DEVICE_SDCARD = 2,
 #endif
-    BLACKBOX_DEVICE_SERIAL = 3
+    BLACKBOX_DEVICE_SERIAL = 3,
+#ifdef USE_VCP
+    BLACKBOX_DEVICE_USB = 4,    // framed stream on the USB VCP for tethered bench logging
+#endif
 } BlackboxDevice_e;
 
 typedef enum BlackboxMode {
@@ -47,14 +50,36 @@ typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT = 13,
     FLIGHT_LOG_EVENT_LOGGING_RESUME = 14,
     FLIGHT_LOG_EVENT_FLIGHTMODE = 30, // Add new event type for flight mode status.
+    FLIGHT_LOG_EVENT_LOGGING_RATE = 31, // The adaptive rate changed the P interval
     FLIGHT_LOG_EVENT_LOG_END = 255
 } FlightLogEvent;
 
+// Groups of main frame fields that can be left out of the log, bits of blackboxConfig()->fields_disabled_mask
+typedef enum {
+    FLIGHT_LOG_FIELD_SELECT_PID = 0,
+    FLIGHT_LOG_FIELD_SELECT_RC_COMMANDS,
+    FLIGHT_LOG_FIELD_SELECT_SETPOINT,
+    FLIGHT_LOG_FIELD_SELECT_BATTERY,
+    FLIGHT_LOG_FIELD_SELECT_MAG,
+    FLIGHT_LOG_FIELD_SELECT_ALTITUDE,
+    FLIGHT_LOG_FIELD_SELECT_RSSI,
+    FLIGHT_LOG_FIELD_SELECT_GYRO,
+    FLIGHT_LOG_FIELD_SELECT_ACC,
+    FLIGHT_LOG_FIELD_SELECT_DEBUG,
+    FLIGHT_LOG_FIELD_SELECT_MOTOR,
+    FLIGHT_LOG_FIELD_SELECT_COUNT
+} FlightLogFieldSelect_e;
+
 typedef struct blackboxConfig_s {
     uint16_t p_ratio; // I-frame interval / P-frame interval
     uint8_t device;
     uint8_t record_acc;
     uint8_t mode;
+    uint16_t gyro_capture_ms;   // raw gyro capture window after the log starts, 0 to disable
+    uint8_t gyro_capture_delta; // delta encode the captured samples
+    uint8_t adaptive_rate;      // log fewer P-frames while the device can't keep up
+    uint16_t fields_disabled_mask; // FlightLogFieldSelect_e groups left out of the main frames
+    uint8_t compression;        // huffman code the log in blocks on the flash
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -64,6 +89,9 @@ void blackboxLogEvent(FlightLogEvent event, union flightLogEventData_u *data);
 
 void blackboxInit(void);
 void blackboxUpdate(timeUs_t currentTimeUs);
+#ifdef USE_BLACKBOX_ENCODE_TASK
+void blackboxEncodeUpdate(timeUs_t currentTimeUs);
+#endif
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 int blackboxCalculatePDenom(int rateNum, int rateDenom);
 uint8_t blackboxGetRateDenom(void);
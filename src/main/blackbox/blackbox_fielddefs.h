@@ -47,6 +47,12 @@ typedef enum FlightLogFieldCondition {
 
     FLIGHT_LOG_FIELD_CONDITION_ACC,
     FLIGHT_LOG_FIELD_CONDITION_DEBUG,
+    FLIGHT_LOG_FIELD_CONDITION_DEBUG_2,
+
+    FLIGHT_LOG_FIELD_CONDITION_PID,
+    FLIGHT_LOG_FIELD_CONDITION_RC_COMMANDS,
+    FLIGHT_LOG_FIELD_CONDITION_SETPOINT,
+    FLIGHT_LOG_FIELD_CONDITION_GYRO,
 
     FLIGHT_LOG_FIELD_CONDITION_NEVER,
 
@@ -130,6 +136,11 @@ typedef struct flightLogEvent_loggingResume_s {
     uint32_t currentTime;
 } flightLogEvent_loggingResume_t;
 
+typedef struct flightLogEvent_loggingRate_s {
+    uint32_t logIteration;
+    uint16_t pInterval;     // loop iterations per P-frame from this I-frame on
+} flightLogEvent_loggingRate_t;
+
 #define FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT_FUNCTION_FLOAT_VALUE_FLAG 128
 
 typedef union flightLogEventData_u {
@@ -137,6 +148,7 @@ typedef union flightLogEventData_u {
     flightLogEvent_flightMode_t flightMode; // New event data
     flightLogEvent_inflightAdjustment_t inflightAdjustment;
     flightLogEvent_loggingResume_t loggingResume;
+    flightLogEvent_loggingRate_t loggingRate;
 } flightLogEventData_t;
 
 typedef struct flightLogEvent_s {
@@ -31,7 +31,11 @@
 #include "blackbox.h"
 #include "blackbox_io.h"
 
+#include "common/crc.h"
+#include "common/huffman.h"
 #include "common/maths.h"
+#include "common/memory.h"
+#include "common/time.h"
 
 #include "flight/pid.h"
 
@@ -52,12 +56,126 @@ int32_t blackboxHeaderBudget;
 static serialPort_t *blackboxPort = NULL;
 static portSharing_e blackboxPortSharing;
 
+// Main frames are assembled here and handed to the device in one write, allocated when a log device is configured
+static uint8_t *blackboxFrameBuffer;
+static uint16_t blackboxFrameLength;
+static bool blackboxFrameAssembling = false;
+
+#ifdef USE_FLASHFS
+// Where the log being written started on the flash, for its table of contents entry
+static uint32_t blackboxFlashLogStart;
+static bool blackboxFlashLogOpen = false;
+#endif
+
+#ifdef USE_BLACKBOX_COMPRESSION
+/*
+ * Compressed flash logs are written as blocks of
+ *
+ *     'B' 'Z', method, log byte count, payload length, payload
+ *
+ * where the payload is the huffman code of the log bytes, with the table MSP_DATAFLASH_READ compresses with, or the
+ * log bytes themselves when the code isn't shorter. A block is at most half the flashfs write buffer, so it fits in
+ * one write. support/blackbox_inflate.py turns a flash dump back into plain logs.
+ */
+#define BLACKBOX_COMPRESS_BLOCK_SIZE    MIN(255, FLASHFS_WRITE_BUFFER_SIZE / 2)
+#define BLACKBOX_COMPRESS_HEADER_SIZE   5
+// huffmanEncodeBuf() can run a byte past the length it's given before it gives up
+#define BLACKBOX_COMPRESS_SLACK         4
+
+typedef enum {
+    BLACKBOX_COMPRESS_STORED = 0,
+    BLACKBOX_COMPRESS_HUFFMAN
+} blackboxCompressMethod_e;
+
+// The log bytes of the block being collected, followed by the room to code them into
+static uint8_t *blackboxCompressBuffer;
+static uint16_t blackboxCompressLength;
+#endif
+
+#ifdef USE_VCP
+/*
+ * Tethered logging streams the log over the USB VCP in packets of
+ *
+ *     0xBB 0x7E, sequence, payload length (u16 LE), payload, crc16 ccitt of sequence to payload (u16 LE)
+ *
+ * so a bench logger can pick them out from MSP replies on the same port and spot lost packets. The writes of one loop
+ * iteration are collected into one packet, and a packet that doesn't fit the USB buffer is dropped instead of
+ * stalling the loop.
+ */
+#define BLACKBOX_TETHER_SYNC1           0xBB
+#define BLACKBOX_TETHER_SYNC2           0x7E
+#define BLACKBOX_TETHER_HEADER_SIZE     5
+#define BLACKBOX_TETHER_CRC_SIZE        2
+#define BLACKBOX_TETHER_PAYLOAD_SIZE    512
+
+static struct {
+    serialPort_t *port;
+    uint8_t sequence;
+    uint16_t length;
+    uint8_t packet[BLACKBOX_TETHER_HEADER_SIZE + BLACKBOX_TETHER_PAYLOAD_SIZE + BLACKBOX_TETHER_CRC_SIZE];
+} blackboxTether;
+
+static void blackboxTetherSend(void) {
+    const uint16_t length = blackboxTether.length;
+    if (!length) {
+        return;
+    }
+    blackboxTether.length = 0;
+    uint8_t *packet = blackboxTether.packet;
+    packet[0] = BLACKBOX_TETHER_SYNC1;
+    packet[1] = BLACKBOX_TETHER_SYNC2;
+    packet[2] = blackboxTether.sequence++;
+    packet[3] = length & 0xFF;
+    packet[4] = length >> 8;
+    const uint16_t crc = crc16_ccitt_update(0, &packet[2], BLACKBOX_TETHER_HEADER_SIZE - 2 + length);
+    packet[BLACKBOX_TETHER_HEADER_SIZE + length] = crc & 0xFF;
+    packet[BLACKBOX_TETHER_HEADER_SIZE + length + 1] = crc >> 8;
+    const uint32_t size = BLACKBOX_TETHER_HEADER_SIZE + length + BLACKBOX_TETHER_CRC_SIZE;
+    if (serialTxBytesFree(blackboxTether.port) >= size) {
+        serialWriteBuf(blackboxTether.port, packet, size);
+    }
+}
+
+static void blackboxTetherWrite(const uint8_t *data, unsigned int len) {
+    while (len > 0) {
+        if (blackboxTether.length == BLACKBOX_TETHER_PAYLOAD_SIZE) {
+            blackboxTetherSend();
+        }
+        const unsigned int chunk = MIN(len, (unsigned int)(BLACKBOX_TETHER_PAYLOAD_SIZE - blackboxTether.length));
+        memcpy(&blackboxTether.packet[BLACKBOX_TETHER_HEADER_SIZE + blackboxTether.length], data, chunk);
+        blackboxTether.length += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+static bool blackboxTetherOpen(void) {
+    blackboxTether.length = 0;
+    blackboxTether.sequence = 0;
+    if (blackboxTether.port) {
+        return true;
+    }
+    // Use the VCP as MSP already has it open. Closing and opening it again would reset the USB connection, so a port
+    // opened here stays open after the log ends too
+    const serialPortUsage_t *usage = findSerialPortUsageByIdentifier(SERIAL_PORT_USB_VCP);
+    if (!usage) {
+        return false;
+    }
+    blackboxTether.port = usage->serialPort;
+    if (!blackboxTether.port) {
+        blackboxTether.port = openSerialPort(SERIAL_PORT_USB_VCP, FUNCTION_BLACKBOX, NULL, NULL, 115200, BLACKBOX_SERIAL_PORT_MODE, SERIAL_NOT_INVERTED);
+    }
+    return blackboxTether.port != NULL;
+}
+#endif // USE_VCP
+
 #ifdef USE_SDCARD
 
 static struct {
     afatfsFilePtr_t logFile;
     afatfsFilePtr_t logDirectory;
     afatfsFinder_t logDirectoryFinder;
+    uint32_t logDirectoryEntries;   // entries before the directory's terminator, where new logs can go
     uint32_t largestLogFileNumber;
 
     enum {
@@ -66,6 +184,7 @@ static struct {
         BLACKBOX_SDCARD_ENUMERATE_FILES,
         BLACKBOX_SDCARD_CHANGE_INTO_LOG_DIRECTORY,
         BLACKBOX_SDCARD_READY_TO_CREATE_LOG,
+        BLACKBOX_SDCARD_PREALLOCATE,
         BLACKBOX_SDCARD_READY_TO_LOG
     } state;
 } blackboxSDCard;
@@ -73,6 +192,9 @@ static struct {
 #define LOGFILE_PREFIX "LOG"
 #define LOGFILE_SUFFIX "BFL"
 
+// Space reserved for each new log up front, so the FAT and directory don't need updating while logging
+#define LOGFILE_PREALLOCATE_SIZE (16 * 1024 * 1024)
+
 #endif // USE_SDCARD
 
 void blackboxOpen(void) {
@@ -82,10 +204,135 @@ void blackboxOpen(void) {
     }
 }
 
+#ifdef USE_FLASHFS
+#ifdef USE_BLACKBOX_COMPRESSION
+void blackboxCompressionInit(void) {
+    if (!blackboxCompressBuffer) {
+        blackboxCompressBuffer = memAllocate(BLACKBOX_COMPRESS_BLOCK_SIZE + BLACKBOX_COMPRESS_HEADER_SIZE + BLACKBOX_COMPRESS_BLOCK_SIZE + BLACKBOX_COMPRESS_SLACK);
+    }
+}
+
+// Code the collected log bytes and hand the block to the flash
+static void blackboxCompressBlock(void) {
+    if (!blackboxCompressLength) {
+        return;
+    }
+    uint8_t *block = blackboxCompressBuffer + BLACKBOX_COMPRESS_BLOCK_SIZE;
+    uint8_t *payload = block + BLACKBOX_COMPRESS_HEADER_SIZE;
+    uint8_t method = BLACKBOX_COMPRESS_HUFFMAN;
+    int payloadLength = huffmanEncodeBuf(payload, blackboxCompressLength - 1, blackboxCompressBuffer, blackboxCompressLength, huffmanTable);
+    if (payloadLength < 0 || payloadLength >= blackboxCompressLength) {
+        method = BLACKBOX_COMPRESS_STORED;
+        memcpy(payload, blackboxCompressBuffer, blackboxCompressLength);
+        payloadLength = blackboxCompressLength;
+    }
+    block[0] = 'B';
+    block[1] = 'Z';
+    block[2] = method;
+    block[3] = blackboxCompressLength;
+    block[4] = payloadLength;
+    flashfsWrite(block, BLACKBOX_COMPRESS_HEADER_SIZE + payloadLength, false);
+    blackboxCompressLength = 0;
+}
+#endif
+
+static void blackboxFlashWrite(const uint8_t *data, unsigned int len) {
+#ifdef USE_BLACKBOX_COMPRESSION
+    if (blackboxCompressBuffer) {
+        while (len) {
+            const unsigned int chunk = MIN(len, (unsigned int)(BLACKBOX_COMPRESS_BLOCK_SIZE - blackboxCompressLength));
+            memcpy(blackboxCompressBuffer + blackboxCompressLength, data, chunk);
+            blackboxCompressLength += chunk;
+            data += chunk;
+            len -= chunk;
+            if (blackboxCompressLength == BLACKBOX_COMPRESS_BLOCK_SIZE) {
+                blackboxCompressBlock();
+            }
+        }
+        return;
+    }
+#endif
+    flashfsWrite(data, len, false); // Write asynchronously
+}
+
+// Write out a partly collected block, before waiting for the flash to drain or closing the log
+static void blackboxFlashWritePending(void) {
+#ifdef USE_BLACKBOX_COMPRESSION
+    if (blackboxCompressBuffer) {
+        blackboxCompressBlock();
+    }
+#endif
+}
+#endif // USE_FLASHFS
+
+static void blackboxWriteBuf(const uint8_t *data, unsigned int len) {
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        blackboxFlashWrite(data, len);
+        break;
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        afatfs_fwrite(blackboxSDCard.logFile, data, len); // Ignore failures due to buffers filling up
+        break;
+#endif
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxTetherWrite(data, len);
+        break;
+#endif
+    case BLACKBOX_DEVICE_SERIAL:
+    default:
+        serialWriteBuf(blackboxPort, data, len);
+        break;
+    }
+}
+
+/*
+ * Start assembling a frame: until blackboxFrameEnd() every blackboxWrite() only appends to the frame buffer, so the
+ * encoders don't go through the device switch and the device's single byte write for every byte they produce.
+ */
+void blackboxFrameBegin(void) {
+    blackboxFrameLength = 0;
+    // without a buffer the bytes go to the device one at a time
+    blackboxFrameAssembling = blackboxFrameBuffer != NULL;
+}
+
+void blackboxFrameBufferInit(void) {
+    if (!blackboxFrameBuffer) {
+        blackboxFrameBuffer = memAllocate(BLACKBOX_FRAME_BUFFER_SIZE);
+    }
+}
+
+// Hand the assembled frame to the device in one write
+void blackboxFrameEnd(void) {
+    blackboxFrameAssembling = false;
+    if (blackboxFrameLength) {
+        blackboxWriteBuf(blackboxFrameBuffer, blackboxFrameLength);
+        blackboxFrameLength = 0;
+    }
+}
+
 void blackboxWrite(uint8_t value) {
+    if (blackboxFrameAssembling) {
+        if (blackboxFrameLength == BLACKBOX_FRAME_BUFFER_SIZE) {
+            // Oversized frame, spill what we have so far rather than lose data
+            blackboxWriteBuf(blackboxFrameBuffer, blackboxFrameLength);
+            blackboxFrameLength = 0;
+        }
+        blackboxFrameBuffer[blackboxFrameLength++] = value;
+        return;
+    }
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
+#ifdef USE_BLACKBOX_COMPRESSION
+        if (blackboxCompressBuffer) {
+            blackboxFlashWrite(&value, 1);
+            break;
+        }
+#endif
         flashfsWriteByte(value); // Write byte asynchronously
         break;
 #endif
@@ -93,6 +340,11 @@ void blackboxWrite(uint8_t value) {
     case BLACKBOX_DEVICE_SDCARD:
         afatfs_fputc(blackboxSDCard.logFile, value);
         break;
+#endif
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxTetherWrite(&value, 1);
+        break;
 #endif
     case BLACKBOX_DEVICE_SERIAL:
     default:
@@ -109,7 +361,7 @@ int blackboxWriteString(const char *s) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
         length = strlen(s);
-        flashfsWrite((const uint8_t*) s, length, false); // Write asynchronously
+        blackboxFlashWrite((const uint8_t*) s, length);
         break;
 #endif // USE_FLASHFS
 #ifdef USE_SDCARD
@@ -118,6 +370,12 @@ int blackboxWriteString(const char *s) {
         afatfs_fwrite(blackboxSDCard.logFile, (const uint8_t*) s, length); // Ignore failures due to buffers filling up
         break;
 #endif // USE_SDCARD
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        length = strlen(s);
+        blackboxTetherWrite((const uint8_t*) s, length);
+        break;
+#endif
     case BLACKBOX_DEVICE_SERIAL:
     default:
         pos = (uint8_t*) s;
@@ -147,6 +405,11 @@ void blackboxDeviceFlush(void) {
         flashfsFlushAsync();
         break;
 #endif // USE_FLASHFS
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxTetherSend();
+        break;
+#endif
     default:
         ;
     }
@@ -162,8 +425,14 @@ bool blackboxDeviceFlushForce(void) {
     case BLACKBOX_DEVICE_SERIAL:
         // Nothing to speed up flushing on serial, as serial is continuously being drained out of its buffer
         return isSerialTransmitBufferEmpty(blackboxPort);
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxTetherSend();
+        return isSerialTransmitBufferEmpty(blackboxTether.port);
+#endif
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
+        blackboxFlashWritePending();
         return flashfsFlushAsync();
 #endif // USE_FLASHFS
 #ifdef USE_SDCARD
@@ -232,6 +501,11 @@ bool blackboxDeviceOpen(void) {
         return blackboxPort != NULL;
     }
     break;
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
+        return blackboxTetherOpen();
+#endif
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
         if (!flashfsIsSupported() || isBlackboxDeviceFull()) {
@@ -309,6 +583,11 @@ void blackboxDeviceClose(void) {
         // Some flash device, e.g., NAND devices, require explicit close to flush internally buffered data.
         flashfsClose();
         break;
+#endif
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        blackboxTetherSend();
+        break;
 #endif
     default:
         ;
@@ -320,6 +599,7 @@ void blackboxDeviceClose(void) {
 static void blackboxLogDirCreated(afatfsFilePtr_t directory) {
     if (directory) {
         blackboxSDCard.logDirectory = directory;
+        blackboxSDCard.logDirectoryEntries = 0;
         afatfs_findFirst(blackboxSDCard.logDirectory, &blackboxSDCard.logDirectoryFinder);
         blackboxSDCard.state = BLACKBOX_SDCARD_ENUMERATE_FILES;
     } else {
@@ -332,7 +612,7 @@ static void blackboxLogFileCreated(afatfsFilePtr_t file) {
     if (file) {
         blackboxSDCard.logFile = file;
         blackboxSDCard.largestLogFileNumber++;
-        blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_LOG;
+        blackboxSDCard.state = BLACKBOX_SDCARD_PREALLOCATE;
     } else {
         // Retry
         blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_CREATE_LOG;
@@ -347,7 +627,8 @@ static void blackboxCreateLogFile(void) {
         remainder /= 10;
     }
     blackboxSDCard.state = BLACKBOX_SDCARD_WAITING;
-    afatfs_fopen(filename, "as", blackboxLogFileCreated);
+    // The number is past every log in the directory, so it need not be searched for
+    afatfs_fopen(filename, "asn", blackboxLogFileCreated);
 }
 
 /**
@@ -371,6 +652,7 @@ doMore:
     case BLACKBOX_SDCARD_ENUMERATE_FILES:
         while (afatfs_findNext(blackboxSDCard.logDirectory, &blackboxSDCard.logDirectoryFinder, &directoryEntry) == AFATFS_OPERATION_SUCCESS) {
             if (directoryEntry && !fat_isDirectoryEntryTerminator(directoryEntry)) {
+                blackboxSDCard.logDirectoryEntries++;
                 // If this is a log file, parse the log number from the filename
                 if (strncmp(directoryEntry->filename, LOGFILE_PREFIX, strlen(LOGFILE_PREFIX)) == 0
                         && strncmp(directoryEntry->filename + 8, LOGFILE_SUFFIX, strlen(LOGFILE_SUFFIX)) == 0) {
@@ -393,6 +675,7 @@ doMore:
             // We no longer need our open handle on the log directory
             afatfs_fclose(blackboxSDCard.logDirectory, NULL);
             blackboxSDCard.logDirectory = NULL;
+            afatfs_hintFreeDirectoryEntry(blackboxSDCard.logDirectoryEntries);
             blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_CREATE_LOG;
             goto doMore;
         }
@@ -400,6 +683,13 @@ doMore:
     case BLACKBOX_SDCARD_READY_TO_CREATE_LOG:
         blackboxCreateLogFile();
         break;
+    case BLACKBOX_SDCARD_PREALLOCATE:
+        // If the card is too full to reserve it all, the log just grows one supercluster at a time instead
+        if (afatfs_fpreallocate(blackboxSDCard.logFile, LOGFILE_PREALLOCATE_SIZE) != AFATFS_OPERATION_IN_PROGRESS) {
+            blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_LOG;
+            goto doMore;
+        }
+        break;
     case BLACKBOX_SDCARD_READY_TO_LOG:
         return true; // Log has been created!
     }
@@ -409,6 +699,29 @@ doMore:
 
 #endif // USE_SDCARD
 
+/**
+ * Let the device prepare for the next log while none is open
+ */
+void blackboxDeviceIdle(void) {
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        flashfsEraseAhead();
+        break;
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        // Find the next log number and change into the log directory while disarmed, leaving only the file to create
+        if (blackboxSDCard.state < BLACKBOX_SDCARD_READY_TO_CREATE_LOG) {
+            blackboxSDCardBeginLog();
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
 /**
  * Begin a new log (for devices which support separations between the logs of multiple flights).
  *
@@ -416,6 +729,14 @@ doMore:
  */
 bool blackboxDeviceBeginLog(void) {
     switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        // Start each log on a free space block so the USB mass storage view lists it as a file of its own
+        flashfsSeekToNextBlock();
+        blackboxFlashLogStart = flashfsGetOffset();
+        blackboxFlashLogOpen = true;
+        return true;
+#endif // USE_FLASHFS
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
         return blackboxSDCardBeginLog();
@@ -433,10 +754,31 @@ bool blackboxDeviceBeginLog(void) {
  * Keep calling until this returns true
  */
 bool blackboxDeviceEndLog(bool retainLog) {
-#ifndef USE_SDCARD
+#if !defined(USE_SDCARD) && !defined(USE_FLASHFS)
     UNUSED(retainLog);
 #endif
     switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        blackboxFlashWritePending();
+        // Called until the shutdown completes, list the log the first time only
+        if (blackboxFlashLogOpen && retainLog && flashfsGetOffset() > blackboxFlashLogStart) {
+            flashfsTocEntry_t entry = {
+                .start = blackboxFlashLogStart,
+                .length = flashfsGetOffset() - blackboxFlashLogStart,
+                .timestamp = 0,
+            };
+#ifdef USE_RTC_TIME
+            rtcTime_t now;
+            if (rtcGet(&now)) {
+                entry.timestamp = rtcTimeGetSeconds(&now);
+            }
+#endif
+            flashfsTocAppend(&entry);
+        }
+        blackboxFlashLogOpen = false;
+        return true;
+#endif // USE_FLASHFS
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
         // Keep retrying until the close operation queues
@@ -459,6 +801,9 @@ bool blackboxDeviceEndLog(bool retainLog) {
 bool isBlackboxDeviceFull(void) {
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+#endif
         return false;
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
@@ -473,6 +818,19 @@ bool isBlackboxDeviceFull(void) {
     }
 }
 
+// True for the devices that only pass the log on and don't store it
+bool isBlackboxDeviceStream(void) {
+    switch (blackboxConfig()->device) {
+    case BLACKBOX_DEVICE_SERIAL:
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
 unsigned int blackboxGetLogNumber(void) {
 #ifdef USE_SDCARD
     return blackboxSDCard.largestLogFileNumber;
@@ -481,28 +839,41 @@ unsigned int blackboxGetLogNumber(void) {
 }
 
 /**
- * Call once every loop iteration in order to maintain the global blackboxHeaderBudget with the number of bytes we can
- * transmit this iteration.
+ * Get the number of bytes the device can currently accept without dropping any.
  */
-void blackboxReplenishHeaderBudget(void) {
-    int32_t freeSpace;
+int32_t blackboxDeviceGetFreeSpace(void) {
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
-        freeSpace = serialTxBytesFree(blackboxPort);
-        break;
+        return serialTxBytesFree(blackboxPort);
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        return (int32_t)serialTxBytesFree(blackboxTether.port) - BLACKBOX_TETHER_HEADER_SIZE - BLACKBOX_TETHER_CRC_SIZE;
+#endif
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        freeSpace = flashfsGetWriteBufferFreeSpace();
-        break;
+        return flashfsGetWriteBufferFreeSpace();
 #endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        freeSpace = afatfs_getFreeBufferSpace();
-        break;
+        return afatfs_getFreeBufferSpace();
 #endif
     default:
-        freeSpace = 0;
+        return 0;
     }
+}
+
+/**
+ * Call once every loop iteration in order to maintain the global blackboxHeaderBudget with the number of bytes we can
+ * transmit this iteration.
+ */
+void blackboxReplenishHeaderBudget(void) {
+#ifdef USE_VCP
+    if (blackboxConfig()->device == BLACKBOX_DEVICE_USB) {
+        // header writes don't go through blackboxDeviceFlush(), send what the last iteration wrote
+        blackboxTetherSend();
+    }
+#endif
+    const int32_t freeSpace = blackboxDeviceGetFreeSpace();
     blackboxHeaderBudget = MIN(MIN(freeSpace, blackboxHeaderBudget + blackboxMaxHeaderBytesPerIteration), BLACKBOX_MAX_ACCUMULATED_HEADER_BUDGET);
 }
 
@@ -539,6 +910,13 @@ blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes) {
             return BLACKBOX_RESERVE_PERMANENT_FAILURE;
         }
         return BLACKBOX_RESERVE_TEMPORARY_FAILURE;
+#ifdef USE_VCP
+    case BLACKBOX_DEVICE_USB:
+        if (bytes > BLACKBOX_TETHER_PAYLOAD_SIZE) {
+            return BLACKBOX_RESERVE_PERMANENT_FAILURE;
+        }
+        return BLACKBOX_RESERVE_TEMPORARY_FAILURE;
+#endif
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
         if (bytes > (int32_t) flashfsGetWriteBufferSize()) {
@@ -38,11 +38,21 @@ typedef enum {
  */
 #define BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION 64
 
+/*
+ * Size of the buffer main frames are assembled in before being written to the device. A P frame with all fields
+ * enabled fits; anything larger is spilled to the device in chunks of this size.
+ */
+#define BLACKBOX_FRAME_BUFFER_SIZE 256
+
 extern int32_t blackboxHeaderBudget;
 
 void blackboxOpen(void);
 void blackboxWrite(uint8_t value);
 int blackboxWriteString(const char *s);
+void blackboxFrameBufferInit(void);
+void blackboxCompressionInit(void);
+void blackboxFrameBegin(void);
+void blackboxFrameEnd(void);
 
 void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
@@ -50,14 +60,17 @@ bool blackboxDeviceOpen(void);
 void blackboxDeviceClose(void);
 
 void blackboxEraseAll(void);
+void blackboxDeviceIdle(void);
 bool isBlackboxErased(void);
 
 bool blackboxDeviceBeginLog(void);
 bool blackboxDeviceEndLog(bool retainLog);
 
 bool isBlackboxDeviceFull(void);
+bool isBlackboxDeviceStream(void);
 bool isBlackboxDeviceWorking(void);
 unsigned int blackboxGetLogNumber(void);
 
+int32_t blackboxDeviceGetFreeSpace(void);
 void blackboxReplenishHeaderBudget(void);
 blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes);
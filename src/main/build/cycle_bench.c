@@ -0,0 +1,294 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_CYCLE_BENCH
+
+#include "build/atomic.h"
+#include "build/cycle_bench.h"
+#include "build/cycle_profile.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/kalman.h"
+#include "common/lulu.h"
+#include "common/maths.h"
+#include "common/sdft.h"
+#include "common/time.h"
+#include "common/utils.h"
+
+#include "drivers/nvic.h"
+#include "drivers/time.h"
+
+#include "fc/config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/gyro.h"
+
+#define CYCLE_BENCH_INPUT_COUNT     64  // power of two
+#define CYCLE_BENCH_LOOPTIME_US     125
+#define CYCLE_BENCH_SDFT_BATCHES    6   // what gyroanalyse.c uses at 8k with the default 600Hz dyn notch max
+
+typedef struct cycleBench_s {
+    const char *name;
+    void (*init)(void);
+    float (*apply)(float input);
+} cycleBench_t;
+
+// the cases run one after another, so their filters can share the ram
+static union {
+    pt1Filter_t pt1;
+    biquadFilter_t biquad;
+    ptnFilter_t ptn;
+    alphaBetaGammaFilter_t abg;
+#ifdef USE_LULU
+    luluFilter_t lulu;
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    struct {
+        sdft_t sdft;
+        uint8_t batchIdx;
+    } sdft;
+#endif
+} benchState;
+
+static float benchInput[CYCLE_BENCH_INPUT_COUNT];
+static timeUs_t benchTimeUs;
+
+static const float benchDt = CYCLE_BENCH_LOOPTIME_US * 1e-6f;
+
+// gyro like input in deg/s, a slow ramp with pseudo random noise on top
+static void cycleBenchInitInput(void) {
+    uint32_t seed = 1;
+    for (int i = 0; i < CYCLE_BENCH_INPUT_COUNT; i++) {
+        seed = seed * 1664525 + 1013904223;
+        benchInput[i] = (i - CYCLE_BENCH_INPUT_COUNT / 2) * 4.0f + (int32_t)(seed >> 24) * 0.1f - 12.8f;
+    }
+}
+
+// the timing overhead taken out of every other case
+static NOINLINE float applyNull(float input) {
+    return input;
+}
+
+static void initPt1(void) {
+    pt1FilterInit(&benchState.pt1, pt1FilterGain(100, benchDt));
+}
+
+static float applyPt1(float input) {
+    return pt1FilterApply(&benchState.pt1, input);
+}
+
+static void initBiquad(void) {
+    biquadFilterInitLPF(&benchState.biquad, 150, CYCLE_BENCH_LOOPTIME_US);
+}
+
+static float applyBiquad(float input) {
+    return biquadFilterApply(&benchState.biquad, input);
+}
+
+static float applyBiquadDF1(float input) {
+    return biquadFilterApplyDF1(&benchState.biquad, input);
+}
+
+static void initPt4(void) {
+    ptnFilterInit(&benchState.ptn, FILTER_PT4, 100, benchDt);
+}
+
+static float applyPtn(float input) {
+    return ptnFilterApply(&benchState.ptn, input);
+}
+
+static float applyPt4(float input) {
+    return pt4FilterApply(&benchState.ptn, input);
+}
+
+static void initAbg(void) {
+    ABGInit(&benchState.abg, 0.3f, 35, 50, benchDt);
+}
+
+static float applyAbg(float input) {
+    return alphaBetaGammaApply(&benchState.abg, input);
+}
+
+#ifdef USE_LULU
+static void initLulu(void) {
+    luluFilterInit(&benchState.lulu, 2);
+}
+
+static float applyLulu(float input) {
+    return luluFilterApply(&benchState.lulu, input);
+}
+#endif
+
+#ifndef USE_GYRO_IMUF9001
+// runs on the live state, the gyro loop settles it again within a few ms
+static float applyKalman(float input) {
+    float axes[XYZ_AXIS_COUNT] = { input, input, input };
+    kalman_update_x3(axes);
+    return axes[FD_ROLL];
+}
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+static void initSdft(void) {
+    sdftInit(&benchState.sdft.sdft, 2, SDFT_BIN_COUNT - 1, CYCLE_BENCH_SDFT_BATCHES);
+    benchState.sdft.batchIdx = 0;
+}
+
+static float applySdft(float input) {
+    sdftPushBatch(&benchState.sdft.sdft, &input, &benchState.sdft.batchIdx);
+    if (++benchState.sdft.batchIdx == CYCLE_BENCH_SDFT_BATCHES) {
+        benchState.sdft.batchIdx = 0;
+    }
+    return input;
+}
+#endif
+
+static void initTime(void) {
+    benchTimeUs = micros();
+}
+
+static float applyGyroFilter(float input) {
+    UNUSED(input);
+    gyroFilterBenchmark();
+    return 0;
+}
+
+static float applyPid(float input) {
+    UNUSED(input);
+    benchTimeUs += gyro.targetLooptime;
+    pidController(currentPidProfile, &accelerometerConfig()->accelerometerTrims, benchTimeUs);
+    return 0;
+}
+
+static float applyMixer(float input) {
+    UNUSED(input);
+    benchTimeUs += gyro.targetLooptime;
+    mixTable(benchTimeUs);
+    return 0;
+}
+
+static const cycleBench_t cycleBenches[] = {
+    { "overhead",       NULL,       applyNull },
+    { "pt1",            initPt1,    applyPt1 },
+    { "biquad",         initBiquad, applyBiquad },
+    { "biquad df1",     initBiquad, applyBiquadDF1 },
+    { "ptn pt4",        initPt4,    applyPtn },
+    { "pt4",            initPt4,    applyPt4 },
+    { "abg",            initAbg,    applyAbg },
+#ifdef USE_LULU
+    { "lulu",           initLulu,   applyLulu },
+#endif
+#ifndef USE_GYRO_IMUF9001
+    { "kalman",         NULL,       applyKalman },
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    { "sdft batch",     initSdft,   applySdft },
+#endif
+    { "gyro filter",    NULL,       applyGyroFilter },
+    { "pid",            initTime,   applyPid },
+    { "mixer",          initTime,   applyMixer },
+};
+
+static volatile float benchSink;
+
+int cycleBenchCount(void) {
+    return ARRAYLEN(cycleBenches);
+}
+
+const char *cycleBenchName(int index) {
+    return cycleBenches[index].name;
+}
+
+// Each call is timed on its own with the interrupts masked, so neither the
+// gyro interrupt nor the scheduler land in the count or touch the live state.
+static uint64_t cycleBenchMeasure(const cycleBench_t *bench, uint32_t iterations) {
+    if (bench->init) {
+        bench->init();
+    }
+    uint64_t totalCycles = 0;
+    float sink = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        const float input = benchInput[i & (CYCLE_BENCH_INPUT_COUNT - 1)];
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            const uint32_t start = CYCLE_COUNTER_NOW();
+            sink += bench->apply(input);
+            totalCycles += CYCLE_COUNTER_NOW() - start;
+        }
+    }
+    benchSink = sink;
+    return totalCycles;
+}
+
+uint32_t cycleBenchRun(int index, uint32_t iterations) {
+    if (index < 0 || index >= cycleBenchCount() || iterations == 0) {
+        return 0;
+    }
+    cycleCounterEnable();
+    cycleBenchInitInput();
+    const uint64_t overhead = cycleBenchMeasure(&cycleBenches[0], iterations);
+    if (index == 0) {
+        return overhead / iterations;
+    }
+    const uint64_t total = cycleBenchMeasure(&cycleBenches[index], iterations);
+    return total > overhead ? (total - overhead) / iterations : 0;
+}
+
+static uint32_t cycleBenchSectionMax(cycleSection_e section) {
+    if (!cycleProfileEnabled) {
+        return 0;
+    }
+    cycleProfileInfo_t info;
+    getSectionCycleInfo(section, &info);
+    return info.count ? info.maxCycles : 0;
+}
+
+void cycleBenchLoopWcet(uint32_t iterations, cycleBenchWcet_t *wcet) {
+    cycleCounterEnable();
+    initTime();
+    uint32_t gyroMax = 0;
+    uint32_t pidMax = 0;
+    uint32_t overhead = UINT32_MAX;
+    for (uint32_t i = 0; i < iterations; i++) {
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            const uint32_t start = CYCLE_COUNTER_NOW();
+            const uint32_t gyroStart = CYCLE_COUNTER_NOW();
+            gyroFilterBenchmark();
+            const uint32_t pidStart = CYCLE_COUNTER_NOW();
+            applyPid(0);
+            applyMixer(0);
+            const uint32_t end = CYCLE_COUNTER_NOW();
+            overhead = MIN(overhead, gyroStart - start);
+            gyroMax = MAX(gyroMax, pidStart - gyroStart);
+            pidMax = MAX(pidMax, end - pidStart);
+        }
+    }
+    wcet->gyroCycles = (gyroMax > overhead ? gyroMax - overhead : 0) + cycleBenchSectionMax(CYCLE_SECTION_GYRO_READ);
+    wcet->pidCycles = (pidMax > overhead ? pidMax - overhead : 0) + cycleBenchSectionMax(CYCLE_SECTION_MOTOR_WRITE);
+}
+#endif
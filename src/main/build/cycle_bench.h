@@ -0,0 +1,43 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CYCLE_BENCH_DEFAULT_ITERATIONS  10000
+#define CYCLE_BENCH_MAX_ITERATIONS      50000
+
+#ifdef USE_CYCLE_BENCH
+int cycleBenchCount(void);
+const char *cycleBenchName(int index);
+// Average cycles of one call, with the cost of the timing itself taken out.
+// The full path cases run on the live gyro, pid and mixer state, only call this disarmed.
+uint32_t cycleBenchRun(int index, uint32_t iterations);
+
+typedef struct cycleBenchWcet_s {
+    uint32_t gyroCycles;            // gyro filter chain, plus the slowest sensor read the cycle profile saw
+    uint32_t pidCycles;             // pid and mixer, plus the slowest motor write the cycle profile saw
+} cycleBenchWcet_t;
+
+// Worst case cycles of the gyro and the pid path over the calls, on the live state like the full path cases
+void cycleBenchLoopWcet(uint32_t iterations, cycleBenchWcet_t *wcet);
+#endif
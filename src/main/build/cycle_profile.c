@@ -0,0 +1,208 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_CYCLE_PROFILE
+
+#include "build/atomic.h"
+
+#include "common/maths.h"
+
+#include "drivers/nvic.h"
+
+#include "build/cycle_profile.h"
+
+#define CYCLE_PROFILE_FIRST_OCTAVE  4   // bucket 0 also holds everything below 16 cycles
+
+bool cycleProfileEnabled;
+
+static cycleProfile_t taskCycleProfiles[TASK_COUNT];
+static cycleProfile_t sectionCycleProfiles[CYCLE_SECTION_COUNT];
+
+volatile uint32_t cycleIsrTotalCycles;
+static volatile uint32_t isrCycles[CYCLE_ISR_COUNT];
+static cycleLoad_t cycleLoad;
+
+static const char * const cycleSectionNames[CYCLE_SECTION_COUNT] = {
+    "GYRO READ",
+    "GYRO FILTER",
+    "GYRO FFT",
+    "FFT WINDOW",
+    "FFT DETECT",
+    "FFT CALC",
+    "FFT UPDATE",
+    "PID",
+    "MIXER",
+    "MOTOR WRITE",
+};
+
+static const char * const cycleIsrNames[CYCLE_ISR_COUNT] = {
+    "EXTI",
+    "DMA",
+    "TIMER",
+    "UART",
+    "SYSTICK",
+    "PID",
+};
+
+void cycleProfileReset(void) {
+    memset(taskCycleProfiles, 0, sizeof(taskCycleProfiles));
+    memset(sectionCycleProfiles, 0, sizeof(sectionCycleProfiles));
+}
+
+void cycleCounterEnable(void) {
+    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+        return;
+    }
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#ifdef STM32F7
+    DWT->LAR = 0xC5ACCE55; // unlock the DWT registers
+#endif
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void cycleProfileInit(bool enabled) {
+    cycleProfileReset();
+    if (enabled) {
+        cycleCounterEnable();
+    }
+    cycleProfileEnabled = enabled;
+}
+
+// Two buckets per octave, split at 1.5 * 2^octave
+static FAST_CODE int cycleProfileBucket(uint32_t cycles) {
+    const int octave = 31 - __builtin_clz(cycles | 1);
+    if (octave < CYCLE_PROFILE_FIRST_OCTAVE) {
+        return 0;
+    }
+    const int bucket = (octave - CYCLE_PROFILE_FIRST_OCTAVE) * 2 + ((cycles >> (octave - 1)) & 1);
+    return MIN(bucket, CYCLE_PROFILE_BUCKET_COUNT - 1);
+}
+
+static uint32_t cycleProfileBucketUpperEdge(int bucket) {
+    const int octave = CYCLE_PROFILE_FIRST_OCTAVE + bucket / 2;
+    return (bucket & 1) ? (1U << (octave + 1)) : (3U << (octave - 1));
+}
+
+static FAST_CODE void cycleProfileRecord(cycleProfile_t *profile, uint32_t cycles) {
+    if (profile->count == 0 || cycles < profile->minCycles) {
+        profile->minCycles = cycles;
+    }
+    profile->maxCycles = MAX(profile->maxCycles, cycles);
+    profile->totalCycles += cycles;
+    profile->count++;
+    uint16_t *bucket = &profile->buckets[cycleProfileBucket(cycles)];
+    if (*bucket == UINT16_MAX) {
+        // halve the whole histogram so it keeps its shape over a long flight
+        for (int i = 0; i < CYCLE_PROFILE_BUCKET_COUNT; i++) {
+            profile->buckets[i] >>= 1;
+        }
+    }
+    (*bucket)++;
+}
+
+FAST_CODE void cycleProfileRecordTask(cfTaskId_e taskId, uint32_t cycles) {
+    if (taskId < TASK_COUNT) {
+        cycleProfileRecord(&taskCycleProfiles[taskId], cycles);
+    }
+}
+
+FAST_CODE void cycleProfileRecordSection(cycleSection_e section, uint32_t cycles) {
+    cycleProfileRecord(&sectionCycleProfiles[section], cycles);
+}
+
+FAST_CODE void cycleProfileRecordIsr(cycleIsr_e isr, uint32_t cycles, uint32_t nestedStartCycles) {
+    // a higher priority handler may come in between, and adds its own cycles to the totals
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        const uint32_t ownCycles = cycles - (cycleIsrTotalCycles - nestedStartCycles);
+        cycleIsrTotalCycles += ownCycles;
+        isrCycles[isr] += ownCycles;
+    }
+}
+
+// Called once per system load period with the cycles the scheduler spent finding nothing to run
+void cycleProfileUpdateLoad(uint32_t idleCycles) {
+    static uint32_t lastCycles;
+    static uint32_t lastIsrTotalCycles;
+    static uint32_t lastIsrCycles[CYCLE_ISR_COUNT];
+    const uint32_t nowCycles = CYCLE_COUNTER_NOW();
+    const uint32_t elapsedCycles = nowCycles - lastCycles;
+    lastCycles = nowCycles;
+    if (!elapsedCycles) {
+        return;
+    }
+    for (int i = 0; i < CYCLE_ISR_COUNT; i++) {
+        const uint32_t cycles = isrCycles[i];
+        cycleLoad.isrSharePermille[i] = MIN(1000, (uint64_t)(cycles - lastIsrCycles[i]) * 1000 / elapsedCycles);
+        lastIsrCycles[i] = cycles;
+    }
+    const uint32_t isrTotalCycles = cycleIsrTotalCycles;
+    cycleLoad.isrPermille = MIN(1000, (uint64_t)(isrTotalCycles - lastIsrTotalCycles) * 1000 / elapsedCycles);
+    lastIsrTotalCycles = isrTotalCycles;
+    cycleLoad.busyPermille = 1000 - MIN(1000, (uint64_t)idleCycles * 1000 / elapsedCycles);
+}
+
+const cycleLoad_t *getCycleLoad(void) {
+    return &cycleLoad;
+}
+
+const char *getCycleIsrName(cycleIsr_e isr) {
+    return cycleIsrNames[isr];
+}
+
+static void getCycleProfileInfo(const cycleProfile_t *profile, cycleProfileInfo_t *info) {
+    info->count = profile->count;
+    info->minCycles = profile->minCycles;
+    info->maxCycles = profile->maxCycles;
+    info->averageCycles = profile->count ? profile->totalCycles / profile->count : 0;
+    uint32_t histogramCount = 0;
+    for (int i = 0; i < CYCLE_PROFILE_BUCKET_COUNT; i++) {
+        histogramCount += profile->buckets[i];
+    }
+    info->p99Cycles = 0;
+    const uint32_t p99Count = histogramCount - histogramCount / 100;
+    uint32_t count = 0;
+    for (int i = 0; i < CYCLE_PROFILE_BUCKET_COUNT && histogramCount; i++) {
+        count += profile->buckets[i];
+        if (count >= p99Count) {
+            info->p99Cycles = MIN(cycleProfileBucketUpperEdge(i), profile->maxCycles);
+            break;
+        }
+    }
+}
+
+void getTaskCycleInfo(cfTaskId_e taskId, cycleProfileInfo_t *info) {
+    getCycleProfileInfo(&taskCycleProfiles[taskId], info);
+}
+
+void getSectionCycleInfo(cycleSection_e section, cycleProfileInfo_t *info) {
+    getCycleProfileInfo(&sectionCycleProfiles[section], info);
+}
+
+const char *getCycleSectionName(cycleSection_e section) {
+    return cycleSectionNames[section];
+}
+#endif
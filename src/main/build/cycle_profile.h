@@ -0,0 +1,123 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "scheduler/scheduler.h"
+
+// Hot sections timed with the DWT cycle counter, in the order they run in the pid loop
+typedef enum {
+    CYCLE_SECTION_GYRO_READ = 0,
+    CYCLE_SECTION_GYRO_FILTER,
+    CYCLE_SECTION_GYRO_FFT,
+    CYCLE_SECTION_FFT_WINDOW,       // the four dynamic notch steps, each call runs one of them inside GYRO_FFT
+    CYCLE_SECTION_FFT_DETECT,
+    CYCLE_SECTION_FFT_CALC,
+    CYCLE_SECTION_FFT_UPDATE,
+    CYCLE_SECTION_PID,
+    CYCLE_SECTION_MIXER,
+    CYCLE_SECTION_MOTOR_WRITE,
+    CYCLE_SECTION_COUNT
+} cycleSection_e;
+
+// Interrupt handlers timed with the DWT cycle counter, by the peripheral that raised them
+typedef enum {
+    CYCLE_ISR_EXTI = 0,             // gyro data ready and other pin interrupts
+    CYCLE_ISR_DMA,                  // SPI, DShot and UART transfer completions
+    CYCLE_ISR_TIMER,
+    CYCLE_ISR_UART,
+    CYCLE_ISR_SYSTICK,
+    CYCLE_ISR_PID,                  // gyro and pid run from the software interrupt
+    CYCLE_ISR_COUNT
+} cycleIsr_e;
+
+// Share of the last system load period, in 0.1%
+typedef struct cycleLoad_s {
+    uint16_t busyPermille;          // tasks, scheduler and interrupts, everything but the idle scheduler passes
+    uint16_t isrPermille;           // the timed interrupt handlers together
+    uint16_t isrSharePermille[CYCLE_ISR_COUNT];
+} cycleLoad_t;
+
+#define CYCLE_PROFILE_BUCKET_COUNT  32  // two buckets per octave from 16 to 1M cycles
+
+typedef struct cycleProfile_s {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint16_t buckets[CYCLE_PROFILE_BUCKET_COUNT];
+} cycleProfile_t;
+
+typedef struct cycleProfileInfo_s {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t averageCycles;
+    uint32_t maxCycles;
+    uint32_t p99Cycles;             // upper edge of the histogram bucket holding the 99th percentile
+} cycleProfileInfo_t;
+
+#ifdef USE_CYCLE_PROFILE
+extern bool cycleProfileEnabled;
+
+#define CYCLE_COUNTER_NOW() (DWT->CYCCNT)
+
+#define CYCLE_SECTION_BEGIN(section) \
+    const uint32_t cycleSectionStart_##section = CYCLE_COUNTER_NOW()
+
+#define CYCLE_SECTION_END(section) { \
+    if (cycleProfileEnabled) { \
+        cycleProfileRecordSection(CYCLE_SECTION_##section, CYCLE_COUNTER_NOW() - cycleSectionStart_##section); \
+    } \
+}
+
+// Cycles of all handlers so far, a handler takes off what the handlers nested in it added meanwhile
+extern volatile uint32_t cycleIsrTotalCycles;
+
+#define CYCLE_ISR_BEGIN() \
+    const uint32_t cycleIsrStart = CYCLE_COUNTER_NOW(); \
+    const uint32_t cycleIsrNestedStart = cycleIsrTotalCycles
+
+#define CYCLE_ISR_END(isr) { \
+    if (cycleProfileEnabled) { \
+        cycleProfileRecordIsr(CYCLE_ISR_##isr, CYCLE_COUNTER_NOW() - cycleIsrStart, cycleIsrNestedStart); \
+    } \
+}
+
+void cycleCounterEnable(void);
+void cycleProfileInit(bool enabled);
+void cycleProfileReset(void);
+void cycleProfileRecordTask(cfTaskId_e taskId, uint32_t cycles);
+void cycleProfileRecordSection(cycleSection_e section, uint32_t cycles);
+void cycleProfileRecordIsr(cycleIsr_e isr, uint32_t cycles, uint32_t nestedStartCycles);
+void cycleProfileUpdateLoad(uint32_t idleCycles);
+const cycleLoad_t *getCycleLoad(void);
+const char *getCycleIsrName(cycleIsr_e isr);
+void getTaskCycleInfo(cfTaskId_e taskId, cycleProfileInfo_t *info);
+void getSectionCycleInfo(cycleSection_e section, cycleProfileInfo_t *info);
+const char *getCycleSectionName(cycleSection_e section);
+#else
+#define CYCLE_SECTION_BEGIN(section)
+#define CYCLE_SECTION_END(section)
+#define CYCLE_ISR_BEGIN()
+#define CYCLE_ISR_END(isr)
+#endif
@@ -25,6 +25,8 @@
 
 int16_t debug[DEBUG16_VALUE_COUNT];
 uint8_t debugMode;
+uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+uint8_t debugModeSlot[DEBUG_COUNT];
 
 #ifdef DEBUG_SECTION_TIMES
 uint32_t sectionTimes[2][4];
@@ -78,5 +80,28 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "KALMAN",
     "ANGLE",
     "HORIZON",
-    "LULU"
+    "LULU",
+    "RPM_FILTER",
+    "DSHOT_RPM_TELEMETRY",
+    "RX_LATENCY",
+    "RPM_MOTOR_HEALTH",
+    "DYN_LPF",
+    "DSHOT_OUTPUT_ALIGN"
 };
+
+/*
+ * Build the mode to slot table from the mode of each group of four debug values. A mode selected twice only
+ * writes to its first group.
+ */
+void debugInit(const uint8_t *modes) {
+    for (int i = 0; i < DEBUG_COUNT; i++) {
+        debugModeSlot[i] = DEBUG_SLOT_NONE;
+    }
+    for (int i = 0; i < DEBUG_MODE_SLOT_COUNT; i++) {
+        debugModes[i] = modes[i] < DEBUG_COUNT ? modes[i] : DEBUG_NONE;
+        if (debugModes[i] != DEBUG_NONE && debugModeSlot[debugModes[i]] == DEBUG_SLOT_NONE) {
+            debugModeSlot[debugModes[i]] = i * DEBUG_MODE_VALUE_COUNT;
+        }
+    }
+    debugMode = debugModes[0];
+}
@@ -20,11 +20,19 @@
 
 #pragma once
 
-#define DEBUG16_VALUE_COUNT 4
+#define DEBUG16_VALUE_COUNT 8
+// Each debug mode writes four values, so two modes can be logged side by side
+#define DEBUG_MODE_VALUE_COUNT 4
+#define DEBUG_MODE_SLOT_COUNT (DEBUG16_VALUE_COUNT / DEBUG_MODE_VALUE_COUNT)
+#define DEBUG_SLOT_NONE 0xFF
+
 extern int16_t debug[DEBUG16_VALUE_COUNT];
-extern uint8_t debugMode;
+extern uint8_t debugMode;                           // the mode in debug[0..3]
+extern uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];   // the mode in each group of four values
+extern uint8_t debugModeSlot[];                     // first debug[] value of each mode, DEBUG_SLOT_NONE when not selected
 
-#define DEBUG_SET(mode, index, value) {if (debugMode == (mode)) {debug[(index)] = (value);}}
+#define debugModeIsActive(mode) (debugModeSlot[(mode)] != DEBUG_SLOT_NONE)
+#define DEBUG_SET(mode, index, value) {const uint8_t debugSlot_ = debugModeSlot[(mode)]; if (debugSlot_ != DEBUG_SLOT_NONE) {debug[debugSlot_ + (index)] = (value);}}
 
 #define DEBUG_SECTION_TIMES
 
@@ -97,7 +105,15 @@ typedef enum {
     DEBUG_ANGLE,
     DEBUG_HORIZON,
     DEBUG_LULU,
+    DEBUG_RPM_FILTER,
+    DEBUG_DSHOT_RPM_TELEMETRY,
+    DEBUG_RX_LATENCY,
+    DEBUG_RPM_MOTOR_HEALTH,
+    DEBUG_DYN_LPF,
+    DEBUG_DSHOT_OUTPUT_ALIGN,
     DEBUG_COUNT
 } debugType_e;
 
 extern const char * const debugModeNames[DEBUG_COUNT];
+
+void debugInit(const uint8_t *modes);
@@ -0,0 +1,57 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LOOP_JITTER
+
+#include "common/maths.h"
+
+#include "build/loop_jitter.h"
+
+static loopJitter_t loopJitter;
+
+void loopJitterReset(uint32_t targetLooptimeUs) {
+    memset(&loopJitter, 0, sizeof(loopJitter));
+    loopJitter.targetLooptimeUs = targetLooptimeUs;
+}
+
+FAST_CODE void loopJitterRecord(timeDelta_t loopTimeUs) {
+    const int32_t deviationUs = loopTimeUs - (int32_t)loopJitter.targetLooptimeUs;
+    if (loopJitter.count == 0) {
+        loopJitter.minDeviationUs = deviationUs;
+        loopJitter.maxDeviationUs = deviationUs;
+    } else {
+        loopJitter.minDeviationUs = MIN(loopJitter.minDeviationUs, deviationUs);
+        loopJitter.maxDeviationUs = MAX(loopJitter.maxDeviationUs, deviationUs);
+    }
+    loopJitter.count++;
+    loopJitter.buckets[constrain(deviationUs, -LOOP_JITTER_RANGE_US, LOOP_JITTER_RANGE_US) + LOOP_JITTER_RANGE_US]++;
+}
+
+const loopJitter_t *getLoopJitter(void) {
+    return &loopJitter;
+}
+
+#endif // USE_LOOP_JITTER
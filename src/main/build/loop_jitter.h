@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+// One bucket per microsecond of deviation from the target looptime, the outer buckets also hold everything beyond them
+#define LOOP_JITTER_RANGE_US        16
+#define LOOP_JITTER_BUCKET_COUNT    (2 * LOOP_JITTER_RANGE_US + 1)
+
+typedef struct loopJitter_s {
+    uint32_t targetLooptimeUs;
+    uint32_t count;
+    int32_t minDeviationUs;
+    int32_t maxDeviationUs;
+    uint32_t buckets[LOOP_JITTER_BUCKET_COUNT];
+} loopJitter_t;
+
+void loopJitterReset(uint32_t targetLooptimeUs);
+void loopJitterRecord(timeDelta_t loopTimeUs);
+const loopJitter_t *getLoopJitter(void);
+
+static inline int loopJitterBucketDeviationUs(int bucket) {
+    return bucket - LOOP_JITTER_RANGE_US;
+}
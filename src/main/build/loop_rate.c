@@ -0,0 +1,71 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "build/loop_rate.h"
+
+uint32_t loopRatePidLooptimeUs(const loopRate_t *rate) {
+    return rate->samplePeriodUs * rate->gyroSyncDenom * rate->pidProcessDenom;
+}
+
+// one pid period runs the gyro path pidProcessDenom times and the pid path once, in 0.1us
+static uint32_t loopRateBusyTenthsUs(const loopRate_t *rate, const loopWcet_t *wcet) {
+    return (uint32_t)wcet->gyro * rate->pidProcessDenom + wcet->pid;
+}
+
+uint32_t loopRateLoadPermille(const loopRate_t *rate, const loopWcet_t *wcet) {
+    const uint32_t period = loopRatePidLooptimeUs(rate) * 10;
+    return period ? loopRateBusyTenthsUs(rate, wcet) * 1000 / period : UINT32_MAX;
+}
+
+bool loopRateFits(const loopRate_t *rate, const loopWcet_t *wcet) {
+    const uint32_t period = loopRatePidLooptimeUs(rate) * 10;
+    return period && loopRateBusyTenthsUs(rate, wcet) * 100 <= period * (100 - LOOP_RATE_MARGIN_PERCENT);
+}
+
+bool loopRateRecommend(loopRate_t *rate, uint8_t maxGyroSyncDenom, uint8_t maxPidProcessDenom, const loopWcet_t *wcet) {
+    loopRate_t best = { 0 };
+    for (int gyroSyncDenom = 1; gyroSyncDenom <= maxGyroSyncDenom; gyroSyncDenom++) {
+        for (int pidProcessDenom = 1; pidProcessDenom <= maxPidProcessDenom; pidProcessDenom++) {
+            const loopRate_t candidate = {
+                .samplePeriodUs = rate->samplePeriodUs,
+                .gyroSyncDenom = gyroSyncDenom,
+                .pidProcessDenom = pidProcessDenom,
+            };
+            if (!loopRateFits(&candidate, wcet)) {
+                continue;
+            }
+            // the lowest denominator fits first, the faster gyro rate of an equal product goes first
+            if (!best.gyroSyncDenom || gyroSyncDenom * pidProcessDenom < best.gyroSyncDenom * best.pidProcessDenom) {
+                best = candidate;
+            }
+            break;
+        }
+    }
+    if (!best.gyroSyncDenom) {
+        return false;
+    }
+    *rate = best;
+    return true;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// share of each pid period left to the other tasks and the interrupts
+#define LOOP_RATE_MARGIN_PERCENT    25
+
+typedef struct loopRate_s {
+    uint32_t samplePeriodUs;        // gyro sample period before gyro_sync_denom
+    uint8_t gyroSyncDenom;
+    uint8_t pidProcessDenom;
+} loopRate_t;
+
+// Worst case time of one pass, in 0.1us
+typedef struct loopWcet_s {
+    uint16_t gyro;                  // sensor read and filters, every gyro sample
+    uint16_t pid;                   // pid, mixer and motor write, every pid_process_denom samples
+} loopWcet_t;
+
+uint32_t loopRatePidLooptimeUs(const loopRate_t *rate);
+// Load of the gyro and pid path in 0.1%. A rate fits when it leaves the margin to the rest
+uint32_t loopRateLoadPermille(const loopRate_t *rate, const loopWcet_t *wcet);
+bool loopRateFits(const loopRate_t *rate, const loopWcet_t *wcet);
+// Highest pid rate that fits, the faster gyro rate of the equal ones. Keeps samplePeriodUs
+bool loopRateRecommend(loopRate_t *rate, uint8_t maxGyroSyncDenom, uint8_t maxPidProcessDenom, const loopWcet_t *wcet);
@@ -295,17 +295,51 @@ static void cmsPadToSize(char *buf, int size) {
 #endif
 }
 
+/*
+ * Every screen row remembers the value last written on it, so polled entries and entries redrawn after a key press
+ * only go to the display when their text changed. Slow display ports (CRSF, SRXL, MSP) then carry the changed rows
+ * only. The cache is dropped whenever the screen is cleared or resynced.
+ */
+#define CMS_VALUE_CACHE_ROWS    20
+#define CMS_VALUE_CACHE_LEN     16
+#define CMS_VALUE_CACHE_UNUSED  0xff
+
+typedef struct cmsValueCache_s {
+    uint8_t col;
+    char text[CMS_VALUE_CACHE_LEN + 1];
+} cmsValueCache_t;
+
+static cmsValueCache_t cmsValueCache[CMS_VALUE_CACHE_ROWS];
+static displayPort_t *cmsValueCacheDisplay;
+
+static void cmsValueCacheInvalidate(displayPort_t *pDisplay) {
+    for (int i = 0; i < CMS_VALUE_CACHE_ROWS; i++) {
+        cmsValueCache[i].col = CMS_VALUE_CACHE_UNUSED;
+    }
+    cmsValueCacheDisplay = pDisplay;
+}
+
+static int cmsWriteValue(displayPort_t *pDisplay, uint8_t col, uint8_t row, const char *text) {
+    if (row < CMS_VALUE_CACHE_ROWS && pDisplay == cmsValueCacheDisplay && strlen(text) <= CMS_VALUE_CACHE_LEN) {
+        cmsValueCache_t *cached = &cmsValueCache[row];
+        if (cached->col == col && strcmp(cached->text, text) == 0) {
+            return 0;
+        }
+        cached->col = col;
+        strcpy(cached->text, text);
+    }
+    return displayWrite(pDisplay, col, row, text);
+}
+
 static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row, uint8_t maxSize) {
     int colpos;
-    int cnt;
     cmsPadToSize(buff, maxSize);
 #ifdef CMS_OSD_RIGHT_ALIGNED_VALUES
     colpos = rightMenuColumn - maxSize;
 #else
     colpos = smallScreen ? rightMenuColumn - maxSize : rightMenuColumn;
 #endif
-    cnt = displayWrite(pDisplay, colpos, row, buff);
-    return cnt;
+    return cmsWriteValue(pDisplay, colpos, row, buff);
 }
 
 static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row) {
@@ -376,7 +410,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row)
     case OME_UINT8:
         if (IS_PRINTVALUE(p) && p->data) {
             OSD_UINT8_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
+            formatInt(buff, *ptr->val, 0, ' ');
             cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(p);
         }
@@ -384,7 +418,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row)
     case OME_INT8:
         if (IS_PRINTVALUE(p) && p->data) {
             OSD_INT8_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
+            formatInt(buff, *ptr->val, 0, ' ');
             cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(p);
         }
@@ -392,7 +426,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row)
     case OME_UINT16:
         if (IS_PRINTVALUE(p) && p->data) {
             OSD_UINT16_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
+            formatInt(buff, *ptr->val, 0, ' ');
             cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(p);
         }
@@ -400,7 +434,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row)
     case OME_INT16:
         if (IS_PRINTVALUE(p) && p->data) {
             OSD_UINT16_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
+            formatInt(buff, *ptr->val, 0, ' ');
             cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(p);
         }
@@ -416,7 +450,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, OSD_Entry *p, uint8_t row)
     case OME_Label:
         if (IS_PRINTVALUE(p) && p->data) {
             // A label with optional string, immediately following text
-            cnt = displayWrite(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, p->data);
+            cnt = cmsWriteValue(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, p->data);
             CLR_PRINTVALUE(p);
         }
         break;
@@ -454,12 +488,13 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs) {
         lastPolledUs = currentTimeUs;
     }
     uint32_t room = displayTxBytesFree(pDisplay);
-    if (pDisplay->cleared) {
+    if (pDisplay->cleared || pDisplay != cmsValueCacheDisplay) {
         for (p = pageTop, i = 0; p->type != OME_END; p++, i++) {
             SET_PRINTLABEL(p);
             SET_PRINTVALUE(p);
         }
         pDisplay->cleared = false;
+        cmsValueCacheInvalidate(pDisplay);
     } else if (drawPolled) {
         for (p = pageTop ; p <= pageTop + pageMaxRow ; p++) {
             if (IS_DYNAMIC(p))
@@ -28,6 +28,7 @@
 #if defined(USE_CMS) && defined(USE_VTX_SMARTAUDIO)
 
 #include "common/printf.h"
+#include "common/typeconversion.h"
 #include "common/utils.h"
 
 #include "cms/cms.h"
@@ -420,13 +421,13 @@ static long saCmsSetPORFreq(displayPort_t *pDisp, const void *self) {
 
 static char *saCmsORFreqGetString(void) {
     static char pbuf[5];
-    tfp_sprintf(pbuf, "%4d", saCmsORFreq);
+    formatInt(pbuf, saCmsORFreq, 4, ' ');
     return pbuf;
 }
 
 static char *saCmsUserFreqGetString(void) {
     static char pbuf[5];
-    tfp_sprintf(pbuf, "%4d", saCmsUserFreq);
+    formatInt(pbuf, saCmsUserFreq, 4, ' ');
     return pbuf;
 }
 
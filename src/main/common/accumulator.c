@@ -0,0 +1,74 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/accumulator.h"
+
+// same ordering as the ring buffer, the acquire / release builtins emit a dmb on cortex-m
+#define ACCUMULATOR_LOAD_ACQUIRE(seq)           __atomic_load_n(&(seq), __ATOMIC_ACQUIRE)
+#define ACCUMULATOR_STORE_RELEASE(seq, value)   __atomic_store_n(&(seq), (value), __ATOMIC_RELEASE)
+
+FAST_CODE void accumulatorAdd(accumulator_t *accumulator, const float *sample) {
+    // both copies are equal outside of this function
+    accumulatorSums_t sums = accumulator->copy[1];
+    const uint32_t takenSeq = ACCUMULATOR_LOAD_ACQUIRE(accumulator->takenSeq);
+    const bool handedBack = takenSeq != accumulator->appliedSeq;
+    if (handedBack) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sums.sum[axis] -= accumulator->taken.sum[axis];
+        }
+        sums.count -= accumulator->taken.count;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sums.sum[axis] += sample[axis];
+    }
+    sums.count++;
+    const uint32_t seq = accumulator->seq;
+    ACCUMULATOR_STORE_RELEASE(accumulator->seq, seq + 1);
+    accumulator->copy[0] = sums;
+    ACCUMULATOR_STORE_RELEASE(accumulator->seq, seq + 2);
+    accumulator->copy[1] = sums;
+    if (handedBack) {
+        // only now are both copies free of the taken samples
+        ACCUMULATOR_STORE_RELEASE(accumulator->appliedSeq, takenSeq);
+    }
+}
+
+bool accumulatorTake(accumulator_t *accumulator, accumulatorSums_t *sums) {
+    // the producer hasn't run since the last take, so there's nothing new either
+    if (ACCUMULATOR_LOAD_ACQUIRE(accumulator->appliedSeq) != accumulator->takenSeq) {
+        return false;
+    }
+    uint32_t seq;
+    do {
+        seq = ACCUMULATOR_LOAD_ACQUIRE(accumulator->seq);
+        *sums = accumulator->copy[seq & 1];
+    } while (ACCUMULATOR_LOAD_ACQUIRE(accumulator->seq) != seq);
+    if (sums->count == 0) {
+        return false;
+    }
+    accumulator->taken = *sums;
+    ACCUMULATOR_STORE_RELEASE(accumulator->takenSeq, accumulator->takenSeq + 1);
+    return true;
+}
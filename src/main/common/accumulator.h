@@ -0,0 +1,54 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+
+// lock free hand off of running sensor sums from one context to another, e.g. the gyro loop
+// to the attitude task, whichever of the two may preempt the other.
+// The producer keeps two copies of the sums and flips between them while writing (a latch), so
+// the consumer always finds one complete copy. The consumer hands back what it took and the
+// producer removes that from the sums on its next add, which keeps the sums small and loses no
+// sample that arrived while the consumer was reading.
+
+typedef struct accumulatorSums_s {
+    float sum[XYZ_AXIS_COUNT];
+    uint32_t count;
+} accumulatorSums_t;
+
+typedef struct accumulator_s {
+    accumulatorSums_t copy[2];
+    accumulatorSums_t taken;    // written by the consumer before it bumps takenSeq
+    uint32_t seq;               // producer only, odd while copy[0] is written, even while copy[1] is
+    uint32_t takenSeq;          // consumer only, counts the hand backs
+    uint32_t appliedSeq;        // producer only, hand backs already removed from the sums
+} accumulator_t;
+
+// a zeroed accumulator_t is empty, so static storage needs no init
+
+// producer
+void accumulatorAdd(accumulator_t *accumulator, const float *sample);
+
+// consumer, false when nothing was added since the last take
+bool accumulatorTake(accumulator_t *accumulator, accumulatorSums_t *sums);
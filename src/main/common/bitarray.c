@@ -24,32 +24,21 @@
 
 #include "bitarray.h"
 
-#define BITARRAY_BIT_OP(array, bit, op) ((array)[(bit) / (sizeof((array)[0]) * 8)] op (1 << ((bit) % (sizeof((array)[0]) * 8))))
-
-bool bitArrayGet(const void *array, unsigned bit) {
-    return BITARRAY_BIT_OP((uint32_t*)array, bit, &);
-}
-
-void bitArraySet(void *array, unsigned bit) {
-    BITARRAY_BIT_OP((uint32_t*)array, bit, |= );
-}
-
-void bitArrayClr(void *array, unsigned bit) {
-    BITARRAY_BIT_OP((uint32_t*)array, bit, &= ~);
-}
-
 void bitArrayXor(void *dest, size_t size, void *op1, void *op2) {
-    for (size_t i = 0; i < size; i++) {
+    // whole words first, bit arrays are always a multiple of them but size is in bytes
+    const size_t words = size / sizeof(bitarrayElement_t);
+    for (size_t i = 0; i < words; i++) {
+        ((bitarrayElement_t *)dest)[i] = ((bitarrayElement_t *)op1)[i] ^ ((bitarrayElement_t *)op2)[i];
+    }
+    for (size_t i = words * sizeof(bitarrayElement_t); i < size; i++) {
         ((uint8_t*)dest)[i] = ((uint8_t*)op1)[i] ^ ((uint8_t*)op2)[i];
     }
 }
 
 void bitArrayCopy(void *array, unsigned from, unsigned to) {
-    if (bitArrayGet(array, from)) {
-        bitArraySet(array, to);
-    } else {
-        bitArrayClr(array, to);
-    }
+    bitarrayElement_t *word = (bitarrayElement_t *)array + to / 32;
+    const bitarrayElement_t mask = 1U << (to % 32);
+    *word = (*word & ~mask) | (bitArrayGet(array, from) ? mask : 0);
 }
 
 void bitArrayClrAll(bitarrayElement_t *array, size_t size)
@@ -65,11 +54,11 @@ __attribute__((always_inline)) static inline uint8_t __CTZ(uint32_t val)
     // For other architectures, explicitely implement the same
     // semantics.
 #ifdef __arm__
-    uint8_t zc;
-    __asm__ volatile ("rbit %1, %1\n\t"
-                      "clz %0, %1"
-                    : "=r" (zc)
-                    : "r" (val) );
+    uint32_t zc;
+    __asm__ ("rbit %0, %1\n\t"
+             "clz %0, %0"
+             : "=r" (zc)
+             : "r" (val) );
     return zc;
 #else
     // __builtin_clz is not defined for zero, since it's arch
@@ -20,11 +20,27 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 typedef uint32_t bitarrayElement_t;
 
-bool bitArrayGet(const void *array, unsigned bit);
-void bitArraySet(void *array, unsigned bit);
-void bitArrayClr(void *array, unsigned bit);
+// single bit access is inline, mode and task checks run it many times per loop
+#define BITARRAY_BIT_OP(array, bit, op) ((array)[(bit) / (sizeof((array)[0]) * 8)] op (1U << ((bit) % (sizeof((array)[0]) * 8))))
+
+static inline bool bitArrayGet(const void *array, unsigned bit) {
+    return BITARRAY_BIT_OP((const bitarrayElement_t *)array, bit, &);
+}
+
+static inline void bitArraySet(void *array, unsigned bit) {
+    BITARRAY_BIT_OP((bitarrayElement_t *)array, bit, |= );
+}
+
+static inline void bitArrayClr(void *array, unsigned bit) {
+    BITARRAY_BIT_OP((bitarrayElement_t *)array, bit, &= ~);
+}
+
 void bitArrayXor(void *dest, size_t size, void *op1, void *op2);
 void bitArrayCopy(void *array, unsigned from, unsigned to);
 void bitArrayClrAll(bitarrayElement_t *array, size_t size);
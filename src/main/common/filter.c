@@ -147,6 +147,15 @@ FAST_CODE void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint
     filter->a2 /= a0;
 }
 
+// Takes the coefficients of src and keeps the state of dst, so the output carries on without a step
+FAST_CODE void biquadFilterCopyCoeffs(biquadFilter_t *dst, const biquadFilter_t *src) {
+    dst->b0 = src->b0;
+    dst->b1 = src->b1;
+    dst->b2 = src->b2;
+    dst->a1 = src->a1;
+    dst->a2 = src->a2;
+}
+
 FAST_CODE void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate) {
     biquadFilterUpdate(filter, filterFreq, refreshRate, BIQUAD_Q, FILTER_LPF);
 }
@@ -164,6 +173,20 @@ FAST_CODE float biquadFilterApplyDF1(biquadFilter_t *filter, float input) {
     return result;
 }
 
+/* Computes a chain of count biquadFilter_t filters in direct form 1 on a sample, same result as calling biquadFilterApplyDF1() for each */
+FAST_CODE float biquadFilterCascadeApplyDF1(biquadFilter_t *filters, int count, float input) {
+    for (int i = 0; i < count; i++) {
+        biquadFilter_t *filter = &filters[i];
+        const float result = filter->b0 * input + filter->b1 * filter->x1 + filter->b2 * filter->x2 - filter->a1 * filter->y1 - filter->a2 * filter->y2;
+        filter->x2 = filter->x1;
+        filter->x1 = input;
+        filter->y2 = filter->y1;
+        filter->y1 = result;
+        input = result;
+    }
+    return input;
+}
+
 /* Computes a biquadFilter_t filter in direct form 2 on a sample (higher precision but can't handle changes in coefficients */
 FAST_CODE float biquadFilterApply(biquadFilter_t *filter, float input) {
     const float result = filter->b0 * input + filter->x1;
@@ -172,80 +195,180 @@ FAST_CODE float biquadFilterApply(biquadFilter_t *filter, float input) {
     return result;
 }
 
+/* sets up all three channels of a biquadFilterX3_t with the same response */
+void biquadFilterInitX3(biquadFilterX3_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType) {
+    biquadFilter_t single;
+    biquadFilterInit(&single, filterFreq, refreshRate, Q, filterType);
+    for (int i = 0; i < 3; i++) {
+        filter->b0[i] = single.b0;
+        filter->b1[i] = single.b1;
+        filter->b2[i] = single.b2;
+        filter->a1[i] = single.a1;
+        filter->a2[i] = single.a2;
+        filter->x1[i] = filter->x2[i] = 0;
+    }
+}
+
+FAST_CODE void biquadFilterCopyCoeffsX3(biquadFilterX3_t *dst, const biquadFilterX3_t *src) {
+    for (int i = 0; i < 3; i++) {
+        dst->b0[i] = src->b0[i];
+        dst->b1[i] = src->b1[i];
+        dst->b2[i] = src->b2[i];
+        dst->a1[i] = src->a1[i];
+        dst->a2[i] = src->a2[i];
+    }
+}
+
+/* Computes three direct form 2 transposed biquads in place, same result as biquadFilterApply() per channel */
+FAST_CODE void biquadFilterApplyX3(biquadFilterX3_t *filter, float input[3]) {
+    for (int i = 0; i < 3; i++) {
+        const float result = filter->b0[i] * input[i] + filter->x1[i];
+        filter->x1[i] = filter->b1[i] * input[i] - filter->a1[i] * result + filter->x2[i];
+        filter->x2[i] = filter->b2[i] * input[i] - filter->a2[i] * result;
+        input[i] = result;
+    }
+}
+
+// Fixed point filters, the float designs above are quantised to Q30 at init and run with a 64 bit accumulator
+
+static int32_t filterFixedCoeff(float coeff) {
+    // biquad coefficients of stable low order sections stay inside (-2, 2), which is the Q30 range
+    return lrintf(constrainf(coeff, -1.999999f, 1.999999f) * (1 << FILTER_FIXED_COEFF_SHIFT));
+}
+
+void pt1FilterFixedInit(pt1FilterFixed_t *filter, float k) {
+    filter->state = 0;
+    filter->k = filterFixedCoeff(k);
+}
+
+void pt1FilterFixedUpdateCutoff(pt1FilterFixed_t *filter, float k) {
+    filter->k = filterFixedCoeff(k);
+}
+
+FAST_CODE int32_t pt1FilterFixedApply(pt1FilterFixed_t *filter, int32_t input) {
+    filter->state += (int32_t)(((int64_t)filter->k * (input - filter->state)) >> FILTER_FIXED_COEFF_SHIFT);
+    return filter->state;
+}
+
+void biquadFilterFixedInit(biquadFilterFixed_t *filter, float b0, float b1, float b2, float a1, float a2) {
+    biquadFilterFixedUpdate(filter, b0, b1, b2, a1, a2);
+    filter->x1 = filter->x2 = 0;
+    filter->y1 = filter->y2 = 0;
+}
+
+void biquadFilterFixedUpdate(biquadFilterFixed_t *filter, float b0, float b1, float b2, float a1, float a2) {
+    filter->b0 = filterFixedCoeff(b0);
+    filter->b1 = filterFixedCoeff(b1);
+    filter->b2 = filterFixedCoeff(b2);
+    filter->a1 = filterFixedCoeff(a1);
+    filter->a2 = filterFixedCoeff(a2);
+}
+
+/* Computes a biquadFilterFixed_t filter in direct form 1, the state never holds a rounded intermediate so it stays stable in fixed point */
+FAST_CODE int32_t biquadFilterFixedApply(biquadFilterFixed_t *filter, int32_t input) {
+    const int64_t acc = (int64_t)filter->b0 * input + (int64_t)filter->b1 * filter->x1 + (int64_t)filter->b2 * filter->x2
+        - (int64_t)filter->a1 * filter->y1 - (int64_t)filter->a2 * filter->y2;
+    const int32_t result = (int32_t)((acc + (1 << (FILTER_FIXED_COEFF_SHIFT - 1))) >> FILTER_FIXED_COEFF_SHIFT);
+    filter->x2 = filter->x1;
+    filter->x1 = input;
+    filter->y2 = filter->y1;
+    filter->y1 = result;
+    return result;
+}
+
 // Robert Bouwens AlphaBetaGamma
 
-void ABGInit(alphaBetaGammaFilter_t *filter, float alpha, int boostGain, int halfLife, float dT) {
-	const float Alpha = alpha * 0.001f;
+static void ABGInitCoeffs(alphaBetaGammaCoeffs_t *c, float alpha, int boostGain, int halfLife, float dT) {
+  const float Alpha = alpha * 0.001f;
   // beta, gamma, and eta gains all derived from
   // http://yadda.icm.edu.pl/yadda/element/bwmeta1.element.baztech-922ff6cb-e991-417f-93f0-77448f1ef4ec/c/A_Study_Jeong_1_2017.pdf
 
   const float xi = powf(-Alpha + 1.0f, 0.25); // fourth rool of -a + 1
+  const float b = (1.0f / 6.0f) * powf(1.0f - xi, 2) * (11.0f + 14.0f * xi + 11 * xi * xi);
+  const float g = 2 * powf(1.0f - xi, 3) * (1 + xi);
+  const float e = (1.0f / 6.0f) * powf(1 - xi, 4);
+  const float dT2 = dT * dT;
+  const float dT3 = dT * dT * dT;
+  c->xGain = Alpha;
+  c->vGain = b / dT;
+  c->aGain = g / (2.0f * dT2);
+  c->jGain = e / (6.0f * dT3);
+
+  // give the filter limited history, the decay is folded into the state prediction
+  const float decay = halfLife != 0 ?
+            powf(0.5f, dT / (halfLife / 100.0f)): 1.0f;
+  c->decay = decay;
+  c->decayDT = decay * dT;
+  c->decayDT2 = decay * (1.0f / 2.0f) * dT2;
+  c->decayDT3 = decay * (1.0f / 6.0f) * dT3;
+
+  c->boostK = pt1FilterGain(100, dT);
+  c->velK = pt1FilterGain(75, dT);
+  c->accK = pt1FilterGain(50, dT);
+  c->jerkK = pt1FilterGain(25, dT);
+
+  c->boost = (boostGain * boostGain / 1000000) * 0.003;
+}
+
+void ABGInit(alphaBetaGammaFilter_t *filter, float alpha, int boostGain, int halfLife, float dT) {
+  ABGInitCoeffs(&filter->c, alpha, boostGain, halfLife, dT);
   filter->xk = 0.0f;
   filter->vk = 0.0f;
   filter->ak = 0.0f;
   filter->jk = 0.0f;
-  filter->a = Alpha;
-  filter->b = (1.0f / 6.0f) * powf(1.0f - xi, 2) * (11.0f + 14.0f * xi + 11 * xi * xi);
-  filter->g = 2 * powf(1.0f - xi, 3) * (1 + xi);
-  filter->e = (1.0f / 6.0f) * powf(1 - xi, 4);
-  filter->dT = dT;
-  filter->dT2 = dT * dT;
-  filter->dT3 = dT * dT * dT;
-
-  pt1FilterInit(&filter->boostFilter, pt1FilterGain(100, dT));
-  pt1FilterInit(&filter->velFilter, pt1FilterGain(75, dT));
-  pt1FilterInit(&filter->accFilter, pt1FilterGain(50, dT));
-  pt1FilterInit(&filter->jerkFilter, pt1FilterGain(25, dT));
-
-  filter->boost = (boostGain * boostGain / 1000000) * 0.003;
-  filter->halfLife = halfLife != 0 ?
-            powf(0.5f, dT / (halfLife / 100.0f)): 1.0f;
-
+  filter->boostState = 0.0f;
 } // ABGInit
 
-FAST_CODE float alphaBetaGammaApply(alphaBetaGammaFilter_t *filter, float input) {
-  // float xk;   // current system state (ie: position)
-  // float vk;   // derivative of system state (ie: velocity)
-  // float ak;   // derivative of system velociy (ie: acceleration)
-  // float jk;   // derivative of system acceleration (ie: jerk)
-  float rk;   // residual error
-
-  // give the filter limited history
-  filter->xk *= filter->halfLife;
-  filter->vk *= filter->halfLife;
-  filter->ak *= filter->halfLife;
-  filter->jk *= filter->halfLife;
-
-  // update our (estimated) state 'x' from the system (ie pos = pos + vel (last).dT)
-  filter->xk += filter->dT * filter->vk + (1.0f / 2.0f) * filter->dT2 * filter->ak + (1.0f / 6.0f) * filter->dT3 * filter->jk;
-  // update (estimated) velocity
-  filter->vk += filter->dT * filter->ak + 0.5f * filter->dT2 * filter->jk;
-  filter->ak += filter->dT * filter->jk;
-  
+void ABGInitX3(alphaBetaGammaFilterX3_t *filter, float alpha, int boostGain, int halfLife, float dT) {
+  ABGInitCoeffs(&filter->c, alpha, boostGain, halfLife, dT);
+  for (int i = 0; i < 3; i++) {
+    filter->xk[i] = 0.0f;
+    filter->vk[i] = 0.0f;
+    filter->ak[i] = 0.0f;
+    filter->jk[i] = 0.0f;
+    filter->boostState[i] = 0.0f;
+  }
+}
+
+// xk is the system state (ie: position), vk, ak and jk its velocity, acceleration and jerk. Between
+// steps vk, ak and jk hold the outputs of their pt1s, which are what the pt1s carry on from
+static inline float ABGStep(const alphaBetaGammaCoeffs_t *c, float *xk, float *vk, float *ak, float *jk, float *boostState, float input) {
+  const float v = *vk;
+  const float a = *ak;
+  const float j = *jk;
+
+  // update our (estimated) state 'x' from the system (ie pos = pos + vel (last).dT), with limited history
+  const float x = c->decay * *xk + c->decayDT * v + c->decayDT2 * a + c->decayDT3 * j;
+
   // what is our residual error (measured - estimated)
-  rk = input - filter->xk;
-  
+  float rk = input - x;
+
   // artificially boost the error to increase the response of the filter
-  rk += pt1FilterApply(&filter->boostFilter, (fabsf(rk) * rk * filter->boost));
-  filter->rk = rk; // for logging
-  
-  // update our estimates given the residual error.
-  filter->xk += filter->a * rk;
-  filter->vk += filter->b / filter->dT * rk;
-  filter->ak += filter->g / (2.0f * filter->dT2) * rk;
-  filter->jk += filter->e / (6.0f * filter->dT3) * rk;
-
-  filter->vk = pt1FilterApply(&filter->velFilter, filter->vk);
-  filter->ak = pt1FilterApply(&filter->accFilter, filter->ak);
-  filter->jk = pt1FilterApply(&filter->jerkFilter, filter->jk);
-
-  return filter->xk;
+  *boostState += c->boostK * (fabsf(rk) * rk * c->boost - *boostState);
+  rk += *boostState;
+
+  // update our estimates given the residual error, velocity, acceleration and jerk through their pt1s
+  *xk = x + c->xGain * rk;
+  *vk = v + c->velK * (c->decay * v + c->decayDT * a + c->decayDT2 * j + c->vGain * rk - v);
+  *ak = a + c->accK * (c->decay * a + c->decayDT * j + c->aGain * rk - a);
+  *jk = j + c->jerkK * (c->decay * j + c->jGain * rk - j);
+  return *xk;
+}
+
+FAST_CODE float alphaBetaGammaApply(alphaBetaGammaFilter_t *filter, float input) {
+  return ABGStep(&filter->c, &filter->xk, &filter->vk, &filter->ak, &filter->jk, &filter->boostState, input);
 } // ABGUpdate
 
-FAST_CODE void ptnFilterInit(ptnFilter_t *filter, uint8_t order, uint16_t f_cut, float dT) {
+FAST_CODE void alphaBetaGammaApplyX3(alphaBetaGammaFilterX3_t *filter, float input[3]) {
+  for (int i = 0; i < 3; i++) {
+    input[i] = ABGStep(&filter->c, &filter->xk[i], &filter->vk[i], &filter->ak[i], &filter->jk[i], &filter->boostState[i], input[i]);
+  }
+}
 
-	  // AdjCutHz = CutHz /(sqrtf(powf(2, 1/Order) -1))
-    const float ScaleF[] = { 1.0f, 1.553773974f, 1.961459177f, 2.298959223f };
+// AdjCutHz = CutHz /(sqrtf(powf(2, 1/Order) -1))
+static const float ptnCutoffScale[] = { 1.0f, 1.553773974f, 1.961459177f, 2.298959223f };
+
+FAST_CODE void ptnFilterInit(ptnFilter_t *filter, uint8_t order, uint16_t f_cut, float dT) {
     float Adj_f_cut;
 
 	  filter->order = (order > 4) ? 4 : order;
@@ -253,7 +376,7 @@ FAST_CODE void ptnFilterInit(ptnFilter_t *filter, uint8_t order, uint16_t f_cut,
 		    filter->state[n] = 0.0f;
     }
 
-	  Adj_f_cut = (float)f_cut * ScaleF[filter->order - 1];
+	  Adj_f_cut = (float)f_cut * ptnCutoffScale[filter->order - 1];
 
 	  filter->k = dT / ((1.0f / (2.0f * M_PIf * Adj_f_cut)) + dT);
 } // ptnFilterInit
@@ -264,6 +387,11 @@ FAST_CODE void ptnFilterUpdate(ptnFilter_t *filter, float f_cut, float ScaleF, f
     filter->k = dT / ((1.0f / (2.0f * M_PIf * Adj_f_cut)) + dT);
 }
 
+// ptnFilterUpdate() with the scale of the order the filter was initialised with
+FAST_CODE void ptnFilterUpdateCutoff(ptnFilter_t *filter, float f_cut, float dT) {
+    ptnFilterUpdate(filter, f_cut, ptnCutoffScale[filter->order - 1], dT);
+}
+
 FAST_CODE float ptnFilterApply(ptnFilter_t *filter, float input) {
     filter->state[0] = input;
 
@@ -273,3 +401,28 @@ FAST_CODE float ptnFilterApply(ptnFilter_t *filter, float input) {
 
 	  return filter->state[filter->order];
 } // ptnFilterApply
+
+// ptnFilterApply() for a known order, straight line code without the loop over filter->order
+FAST_CODE float pt2FilterApply(ptnFilter_t *filter, float input) {
+    const float k = filter->k;
+    filter->state[1] += (input - filter->state[1]) * k;
+    filter->state[2] += (filter->state[1] - filter->state[2]) * k;
+    return filter->state[2];
+}
+
+FAST_CODE float pt3FilterApply(ptnFilter_t *filter, float input) {
+    const float k = filter->k;
+    filter->state[1] += (input - filter->state[1]) * k;
+    filter->state[2] += (filter->state[1] - filter->state[2]) * k;
+    filter->state[3] += (filter->state[2] - filter->state[3]) * k;
+    return filter->state[3];
+}
+
+FAST_CODE float pt4FilterApply(ptnFilter_t *filter, float input) {
+    const float k = filter->k;
+    filter->state[1] += (input - filter->state[1]) * k;
+    filter->state[2] += (filter->state[1] - filter->state[2]) * k;
+    filter->state[3] += (filter->state[2] - filter->state[3]) * k;
+    filter->state[4] += (filter->state[3] - filter->state[4]) * k;
+    return filter->state[4];
+}
@@ -41,14 +41,46 @@ typedef struct biquadFilter_s {
     float x1, x2, y1, y2;
 } biquadFilter_t;
 
+/* three biquads stepped together, one per axis, stored as struct of arrays */
+typedef struct biquadFilterX3_s {
+    float b0[3], b1[3], b2[3], a1[3], a2[3];
+    float x1[3], x2[3];
+} biquadFilterX3_t;
+
+/* fixed point variants for targets without an FPU, coefficients are Q30 and samples are plain int32 */
+#define FILTER_FIXED_COEFF_SHIFT 30
+
+typedef struct pt1FilterFixed_s {
+    int32_t state;
+    int32_t k;
+} pt1FilterFixed_t;
+
+typedef struct biquadFilterFixed_s {
+    int32_t b0, b1, b2, a1, a2;
+    int32_t x1, x2, y1, y2;
+} biquadFilterFixed_t;
+
+/* everything of an alpha beta gamma filter that doesn't change between samples, folded at init */
+typedef struct alphaBetaGammaCoeffs_s {
+    float decay, decayDT, decayDT2, decayDT3;   // history decay, times dT, dT^2 / 2 and dT^3 / 6
+    float xGain, vGain, aGain, jGain;           // alpha, beta / dT, gamma / 2dT^2 and eta / 6dT^3
+    float boost;
+    float boostK, velK, accK, jerkK;            // pt1 gains on the boost, velocity, acceleration and jerk
+} alphaBetaGammaCoeffs_t;
+
 typedef struct alphaBetaGammaFilter_s {
-    float a, b, g, e;
-    float ak, vk, xk, jk, rk;
-    float dT, dT2, dT3;
-    float halfLife, boost;
-    pt1Filter_t boostFilter, velFilter, accFilter, jerkFilter;
+    alphaBetaGammaCoeffs_t c;
+    float xk, vk, ak, jk;
+    float boostState;
 } alphaBetaGammaFilter_t;
 
+/* three alpha beta gamma filters with the same coefficients stepped together, one per axis */
+typedef struct alphaBetaGammaFilterX3_s {
+    alphaBetaGammaCoeffs_t c;
+    float xk[3], vk[3], ak[3], jk[3];
+    float boostState[3];
+} alphaBetaGammaFilterX3_t;
+
 typedef struct ptnFilter_s {
     float state[5];
     float k;
@@ -81,21 +113,39 @@ void biquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, uint32_t refr
 void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilterCopyCoeffs(biquadFilter_t *dst, const biquadFilter_t *src);
 
 float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
 float biquadFilterApply(biquadFilter_t *filter, float input);
+float biquadFilterCascadeApplyDF1(biquadFilter_t *filters, int count, float input);
+void biquadFilterInitX3(biquadFilterX3_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
+void biquadFilterApplyX3(biquadFilterX3_t *filter, float input[3]);
+void biquadFilterCopyCoeffsX3(biquadFilterX3_t *dst, const biquadFilterX3_t *src);
 float filterGetNotchQ(float centerFreq, float cutoffFreq);
 float pt1FilterGain(uint16_t f_cut, float dT);
 void pt1FilterInit(pt1Filter_t *filter, float k);
 void pt1FilterUpdateCutoff(pt1Filter_t *filter, float k);
 float pt1FilterApply(pt1Filter_t *filter, float input);
 
+void pt1FilterFixedInit(pt1FilterFixed_t *filter, float k);
+void pt1FilterFixedUpdateCutoff(pt1FilterFixed_t *filter, float k);
+int32_t pt1FilterFixedApply(pt1FilterFixed_t *filter, int32_t input);
+void biquadFilterFixedInit(biquadFilterFixed_t *filter, float b0, float b1, float b2, float a1, float a2);
+void biquadFilterFixedUpdate(biquadFilterFixed_t *filter, float b0, float b1, float b2, float a1, float a2);
+int32_t biquadFilterFixedApply(biquadFilterFixed_t *filter, int32_t input);
+
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
 
 void ABGInit(alphaBetaGammaFilter_t *filter, float alpha, int boostGain, int halfLife, float dT);
 float alphaBetaGammaApply(alphaBetaGammaFilter_t *filter, float input);
+void ABGInitX3(alphaBetaGammaFilterX3_t *filter, float alpha, int boostGain, int halfLife, float dT);
+void alphaBetaGammaApplyX3(alphaBetaGammaFilterX3_t *filter, float input[3]);
 
 void ptnFilterInit(ptnFilter_t *filter, uint8_t order, uint16_t f_cut, float dT);
 void ptnFilterUpdate(ptnFilter_t *filter, float f_cut, float ScaleF, float dt);
+void ptnFilterUpdateCutoff(ptnFilter_t *filter, float f_cut, float dT);
 float ptnFilterApply(ptnFilter_t *filter, float input);
+float pt2FilterApply(ptnFilter_t *filter, float input);
+float pt3FilterApply(ptnFilter_t *filter, float input);
+float pt4FilterApply(ptnFilter_t *filter, float input);
@@ -25,86 +25,116 @@
 #include "fc/fc_rc.h"
 #include "build/debug.h"
 
+#ifdef USE_KALMAN_STREAMING_VARIANCE
+FAST_RAM_ZERO_INIT kalman_t kalmanFilterStateRate[XYZ_AXIS_COUNT];
+#else
 kalman_t    kalmanFilterStateRate[XYZ_AXIS_COUNT];
+#endif
+FAST_RAM_ZERO_INIT kalmanX3_t kalmanX3;
+
+// q grows with the measurement noise: e runs from 0.005 to 0.9 with r and is bent by -0.7 (e - 1)^2 + 0.3 (e - 1) + 1
+static float kalman_shaped_q(float q, float r) {
+    const float d = constrainf(r / 45.0f + 0.005f, 0.005f, 0.9f) - 1.0f;
+    return q * (1.0f + d * (0.3f - 0.7f * d));
+}
 
-void init_kalman(kalman_t *filter, float q) {
+static void init_kalman(int axis, float q) {
+    kalman_t *filter = &kalmanFilterStateRate[axis];
     memset(filter, 0, sizeof(kalman_t));
-    filter->q = q * 0.0001f;             //add multiplier to make tuning easier
-    filter->r = 88.0f;                  //seeding R at 88.0f
-    filter->p = 30.0f;                  //seeding P at 30.0f
-    filter->e = 1.0f;
     filter->w = gyroConfig()->imuf_w;
     filter->inverseN = 1.0f / (float)(filter->w);
 
-    pt1FilterInit(&filter->kFilter, pt1FilterGain(50, gyro.targetLooptime * 1e-6f));
+    kalmanX3.q[axis] = q * 0.0001f;      //add multiplier to make tuning easier
+    kalmanX3.r[axis] = 88.0f;            //seeding R at 88.0f
+    kalmanX3.p[axis] = 30.0f;            //seeding P at 30.0f
+    kalmanX3.qe[axis] = kalman_shaped_q(kalmanX3.q[axis], kalmanX3.r[axis]);
 }
 
-
 void kalman_init(void) {
     isSetpointNew = 0;
-    init_kalman(&kalmanFilterStateRate[X],  gyroConfig()->imuf_roll_q);
-    init_kalman(&kalmanFilterStateRate[Y],  gyroConfig()->imuf_pitch_q);
-    init_kalman(&kalmanFilterStateRate[Z],  gyroConfig()->imuf_yaw_q);
+    memset(&kalmanX3, 0, sizeof(kalmanX3));
+    kalmanX3.kGain = pt1FilterGain(50, gyro.targetLooptime * 1e-6f);
+    kalmanX3.rCountdown = KALMAN_R_UPDATE_INTERVAL;
+    kalmanX3.active = gyroConfig()->imuf_w >= 3;
+    init_kalman(X, gyroConfig()->imuf_roll_q);
+    init_kalman(Y, gyroConfig()->imuf_pitch_q);
+    init_kalman(Z, gyroConfig()->imuf_yaw_q);
 }
 
-void update_kalman_covariance(float rate, int axis) {
-    kalmanFilterStateRate[axis].axisWindow[kalmanFilterStateRate[axis].windex] = rate;
-    kalmanFilterStateRate[axis].axisSumMean += kalmanFilterStateRate[axis].axisWindow[kalmanFilterStateRate[axis].windex];
-    float varianceElement = kalmanFilterStateRate[axis].axisWindow[kalmanFilterStateRate[axis].windex] - kalmanFilterStateRate[axis].axisMean;
+#ifdef USE_KALMAN_STREAMING_VARIANCE
+// exponentially weighted Welford update, a smoothing factor of 1/w gives the window's time constant
+static FAST_CODE void update_kalman_variance(kalman_t *kalmanState, float rate) {
+    const float delta = rate - kalmanState->axisMean;
+    const float increment = kalmanState->inverseN * delta;
+    kalmanState->axisMean += increment;
+    kalmanState->axisVar = (1.0f - kalmanState->inverseN) * (kalmanState->axisVar + delta * increment);
+}
+#else
+static void update_kalman_variance(kalman_t *kalmanState, float rate) {
+    kalmanState->axisWindow[kalmanState->windex] = rate;
+    kalmanState->axisSumMean += kalmanState->axisWindow[kalmanState->windex];
+    float varianceElement = kalmanState->axisWindow[kalmanState->windex] - kalmanState->axisMean;
     varianceElement = varianceElement * varianceElement;
-    kalmanFilterStateRate[axis].axisSumVar += varianceElement;
-    kalmanFilterStateRate[axis].varianceWindow[kalmanFilterStateRate[axis].windex] = varianceElement;
-    kalmanFilterStateRate[axis].windex++;
-    if (kalmanFilterStateRate[axis].windex > kalmanFilterStateRate[axis].w) {
-        kalmanFilterStateRate[axis].windex = 0;
+    kalmanState->axisSumVar += varianceElement;
+    kalmanState->varianceWindow[kalmanState->windex] = varianceElement;
+    kalmanState->windex++;
+    if (kalmanState->windex > kalmanState->w) {
+        kalmanState->windex = 0;
     }
-    kalmanFilterStateRate[axis].axisSumMean -= kalmanFilterStateRate[axis].axisWindow[kalmanFilterStateRate[axis].windex];
-    kalmanFilterStateRate[axis].axisSumVar -= kalmanFilterStateRate[axis].varianceWindow[kalmanFilterStateRate[axis].windex];
+    kalmanState->axisSumMean -= kalmanState->axisWindow[kalmanState->windex];
+    kalmanState->axisSumVar -= kalmanState->varianceWindow[kalmanState->windex];
     //New mean
-    kalmanFilterStateRate[axis].axisMean = kalmanFilterStateRate[axis].axisSumMean * kalmanFilterStateRate[axis].inverseN;
-    kalmanFilterStateRate[axis].axisVar = kalmanFilterStateRate[axis].axisSumVar * kalmanFilterStateRate[axis].inverseN;
-    float squirt;
-    arm_sqrt_f32(kalmanFilterStateRate[axis].axisVar, &squirt);
-    kalmanFilterStateRate[axis].r = squirt * VARIANCE_SCALE;
+    kalmanState->axisMean = kalmanState->axisSumMean * kalmanState->inverseN;
+    kalmanState->axisVar = kalmanState->axisSumVar * kalmanState->inverseN;
 }
+#endif
 
-FAST_CODE float kalman_process(kalman_t* kalmanState, float input) {
-    //project the state ahead using acceleration
-    kalmanState->x += (kalmanState->x - kalmanState->lastX) * kalmanState->k;
-    //figure out how much to boost or reduce our error in the estimate based on setpoint target.
-    //this should be close to 0 as we approach the sepoint and really high the futher away we are from the setpoint.
-    //update last state
-    kalmanState->lastX = kalmanState->x;
+// The variance follows every sample, the square root for r and the q shaping it drives
+// only every KALMAN_R_UPDATE_INTERVAL samples, r moves slowly next to the sample rate
+FAST_CODE void update_kalman_covariance_x3(const float rate[XYZ_AXIS_COUNT]) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        update_kalman_variance(&kalmanFilterStateRate[axis], rate[axis]);
+    }
+    if (--kalmanX3.rCountdown) {
+        return;
+    }
+    kalmanX3.rCountdown = KALMAN_R_UPDATE_INTERVAL;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float squirt;
+        arm_sqrt_f32(kalmanFilterStateRate[axis].axisVar, &squirt);
+        kalmanX3.r[axis] = squirt * VARIANCE_SCALE;
+        kalmanX3.qe[axis] = kalman_shaped_q(kalmanX3.q[axis], kalmanX3.r[axis]);
+    }
+}
 
-    float e = constrainf(kalmanState->r / 45.0f + 0.005f, 0.005f, 0.9f);
-    //make the 1 a configurable value for testing purposes
-    e = -powf(e - 1.0f, 2) * 0.7f + (e - 1.0f) * (1.0f - 0.7f) + 1.0f;
-    kalmanState->e = e;
+// Filters the three axes of input in place
+FAST_CODE void kalman_update_x3(float input[XYZ_AXIS_COUNT]) {
+    DEBUG_SET(DEBUG_KALMAN, 0, input[X]); // prefiltered
+    if (kalmanX3.active) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            //project the state ahead using acceleration
+            float x = kalmanX3.x[axis];
+            x += (x - kalmanX3.lastX[axis]) * kalmanX3.k[axis];
+            //update last state
+            kalmanX3.lastX[axis] = x;
 
-    //prediction update
-    kalmanState->p = kalmanState->p + (kalmanState->q * kalmanState->e);
+            //prediction update
+            float p = kalmanX3.p[axis] + kalmanX3.qe[axis];
 
-    //measurement update
-    kalmanState->k = kalmanState->p / (kalmanState->p + 10.0f);
-    kalmanState->k = pt1FilterApply(&kalmanState->kFilter, kalmanState->k);
-    kalmanState->x += kalmanState->k * (input - kalmanState->x);
-    kalmanState->p = (1.0f - kalmanState->k) * kalmanState->p;
-    return kalmanState->x;
-}
+            //measurement update, the gain goes through its pt1 on the way
+            float k = kalmanX3.k[axis];
+            k += kalmanX3.kGain * (p / (p + 10.0f) - k);
+            x += k * (input[axis] - x);
+            p = (1.0f - k) * p;
 
-FAST_CODE float kalman_update(float input, int axis) {
-    float preFiltered;
-    preFiltered = input;
-    if (gyroConfig()->imuf_w >= 3) {
-        input = kalman_process(&kalmanFilterStateRate[axis], input);
-    }
-    if (axis == FD_ROLL) {
-        DEBUG_SET(DEBUG_KALMAN, 0, preFiltered); // prefiltered
-        DEBUG_SET(DEBUG_KALMAN, 1, input); // postfiltered
-        DEBUG_SET(DEBUG_KALMAN, 2, kalmanFilterStateRate[axis].r * 1000.0f); // covariance
-        DEBUG_SET(DEBUG_KALMAN, 3, kalmanFilterStateRate[axis].k * 1000.0f); // gain
+            kalmanX3.x[axis] = x;
+            kalmanX3.p[axis] = p;
+            kalmanX3.k[axis] = k;
+            input[axis] = x;
+        }
     }
-
-    return input;
+    DEBUG_SET(DEBUG_KALMAN, 1, input[X]); // postfiltered
+    DEBUG_SET(DEBUG_KALMAN, 2, kalmanX3.r[X] * 1000.0f); // covariance
+    DEBUG_SET(DEBUG_KALMAN, 3, kalmanX3.k[X] * 1000.0f); // gain
 }
 #endif
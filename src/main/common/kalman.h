@@ -28,27 +28,38 @@
 #define VARIANCE_SCALE 1.0f
 
 
+// r, and the process noise shaped by it, follow the measurement variance at this fraction of the sample rate
+#define KALMAN_R_UPDATE_INTERVAL 4
+
+// measurement variance of one axis
 typedef struct kalman_s {
-    float q;     //process noise covariance
-    float r;     //measurement noise covariance
-    float p;     //estimation error covariance matrix
-    float k;     //kalman gain
-    float x;     //state
-    float lastX; //previous state
-    float e;
     float axisVar;
+#ifndef USE_KALMAN_STREAMING_VARIANCE
     uint16_t windex;
     float axisWindow[MAX_KALMAN_WINDOW_SIZE + 1];
     float varianceWindow[MAX_KALMAN_WINDOW_SIZE + 1];
     float axisSumMean;
-    float axisMean;
     float axisSumVar;
+#endif
+    float axisMean;
     float inverseN;
     uint16_t w;
-
-    pt1Filter_t kFilter;
 } kalman_t;
 
+// the filter state of the three axes side by side, one pass steps all of them
+typedef struct kalmanX3_s {
+    float x[XYZ_AXIS_COUNT];     //state
+    float lastX[XYZ_AXIS_COUNT]; //state after the last prediction
+    float p[XYZ_AXIS_COUNT];     //estimation error covariance matrix
+    float k[XYZ_AXIS_COUNT];     //kalman gain, the output of its pt1
+    float qe[XYZ_AXIS_COUNT];    //process noise covariance shaped by r, what p grows by each sample
+    float q[XYZ_AXIS_COUNT];     //process noise covariance
+    float r[XYZ_AXIS_COUNT];     //measurement noise covariance
+    float kGain;                 //gain of the pt1 on k
+    uint8_t rCountdown;          //samples until r and qe follow the variance again
+    bool active;
+} kalmanX3_t;
+
 extern void kalman_init(void);
-extern float kalman_update(float input, int axis);
-extern void update_kalman_covariance(float rate, int axis);
+extern void kalman_update_x3(float input[XYZ_AXIS_COUNT]);
+extern void update_kalman_covariance_x3(const float rate[XYZ_AXIS_COUNT]);
@@ -17,108 +17,76 @@
 #include <fenv.h>
 
 void luluFilterInit(luluFilter_t *filter, int N) {
-    if (N > 15) {
-        N = 15;
+    if (N > LULU_MAX_N) {
+        N = LULU_MAX_N;
     }
     if (N < 1) {
         N = 1;
     }
     filter->N = N;
-    filter->windowSize = filter->N * 2 + 1;
     filter->windowBufIndex = 0;
 
-    memset(filter->luluInterim, 0, sizeof(float) * (filter->windowSize));
-    memset(filter->luluInterimB, 0, sizeof(float) * (filter->windowSize));
+    memset(filter->luluInterim, 0, sizeof(filter->luluInterim));
+    memset(filter->luluInterimB, 0, sizeof(filter->luluInterimB));
 }
 
-FAST_CODE float fixRoad(float *series, float *seriesB, int index, int filterN, int windowSize) {
-    register float curVal = 0;
-    register float curValB = 0;
+// Each pass only touches the N samples between index - 2N and index - N, the ring keeps at least the
+// 2N + 1 newest ones so the masked offsets land on the same samples a 2N + 1 ring would hold.
+// index is biased by the buffer size so the offsets never go negative.
+static FAST_CODE float fixRoad(float *series, float *seriesB, int index, int filterN) {
+    index += LULU_BUFFER_SIZE;
     for (int N = 1; N <= filterN; N++) {
-        int indexNeg = (index + windowSize - 2 * N) % windowSize;
-        register int curIndex = (indexNeg + 1) % windowSize;
-        register float prevVal = series[indexNeg];
-        register float prevValB = seriesB[indexNeg];
-        register int indexPos = (curIndex + N) % windowSize;
-        for (int i = windowSize - 2 * N; i < windowSize - N; i++) {
-            if (indexPos >= windowSize) {
-                indexPos = 0;
-            }
-            if (curIndex >= windowSize) {
-                curIndex = 0;
-            }
-
-            curVal = series[curIndex];
-            curValB = seriesB[curIndex];
-            register float nextVal = series[indexPos];
-            register float nextValB = seriesB[indexPos];
-
+        const int indexNeg = index - 2 * N;
+        const int indexLast = index - N;
+        // flatten peaks of width N
+        float prevVal = series[indexNeg & LULU_BUFFER_MASK];
+        float prevValB = seriesB[indexNeg & LULU_BUFFER_MASK];
+        for (int i = indexNeg + 1; i <= indexLast; i++) {
+            const int curIndex = i & LULU_BUFFER_MASK;
+            const int nextIndex = (i + N) & LULU_BUFFER_MASK;
+            const float curVal = series[curIndex];
+            const float curValB = seriesB[curIndex];
+            const float nextVal = series[nextIndex];
+            const float nextValB = seriesB[nextIndex];
             if (prevVal < curVal && curVal > nextVal) {
-                float maxValue = MAX(prevVal, nextVal);
-                series[curIndex] = maxValue;
+                series[curIndex] = MAX(prevVal, nextVal);
             }
-
             if (prevValB < curValB && curValB > nextValB) {
-                float maxValue = MAX(prevValB, nextValB);
-                seriesB[curIndex] = maxValue;
+                seriesB[curIndex] = MAX(prevValB, nextValB);
             }
             prevVal = curVal;
             prevValB = curValB;
-            curIndex++;
-            indexPos++;
         }
-
-        curIndex = (indexNeg + 1) % windowSize;
-        prevVal = series[indexNeg];
-        prevValB = seriesB[indexNeg];
-        indexPos = (curIndex + N) % windowSize;
-        for (int i = windowSize - 2 * N; i < windowSize - N; i++) {
-            if (indexPos >= windowSize) {
-                indexPos = 0;
-            }
-            if (curIndex >= windowSize) {
-                curIndex = 0;
-            }
-
-            curVal = series[curIndex];
-            curValB = seriesB[curIndex];
-            register float nextVal = series[indexPos];
-            register float nextValB = seriesB[indexPos];
-
+        // then fill pits of width N
+        prevVal = series[indexNeg & LULU_BUFFER_MASK];
+        prevValB = seriesB[indexNeg & LULU_BUFFER_MASK];
+        for (int i = indexNeg + 1; i <= indexLast; i++) {
+            const int curIndex = i & LULU_BUFFER_MASK;
+            const int nextIndex = (i + N) & LULU_BUFFER_MASK;
+            const float curVal = series[curIndex];
+            const float curValB = seriesB[curIndex];
+            const float nextVal = series[nextIndex];
+            const float nextValB = seriesB[nextIndex];
             if (prevVal > curVal && curVal < nextVal) {
-                float minValue = MIN(prevVal, nextVal);
-                series[curIndex] = minValue;
+                series[curIndex] = MIN(prevVal, nextVal);
             }
-
             if (prevValB > curValB && curValB < nextValB) {
-                float minValue = MIN(prevValB, nextValB);
-                seriesB[curIndex] = minValue;
+                seriesB[curIndex] = MIN(prevValB, nextValB);
             }
             prevVal = curVal;
-            prevValB = curValB; 
-            curIndex++;
-            indexPos++;
+            prevValB = curValB;
         }
     }
-    int finalIndex = (index + windowSize - filterN) % windowSize;
-    curVal = series[finalIndex];
-    curValB = seriesB[finalIndex];
-    return (curVal - curValB) / 2;
+    const int finalIndex = (index - filterN) & LULU_BUFFER_MASK;
+    return (series[finalIndex] - seriesB[finalIndex]) / 2;
 }
 
 FAST_CODE float luluFilterPartialApply(luluFilter_t *filter, float input) {
-    // This is the value N of the LULU filter.
-    register int filterN = filter->N;
-    // This is the total window size for the rolling buffer
-    register int filterWindow = filter->windowSize;
-
-    register int windowIndex = filter->windowBufIndex;
-    register float inputVal = input;
-    register int newIndex = (windowIndex + 1) % filterWindow;
-    filter->windowBufIndex = newIndex;
-    filter->luluInterim[windowIndex] = inputVal;
-    filter->luluInterimB[windowIndex] = -inputVal;
-    return fixRoad(filter->luluInterim, filter->luluInterimB, windowIndex, filterN, filterWindow);
+    const int windowIndex = filter->windowBufIndex;
+    filter->windowBufIndex = (windowIndex + 1) & LULU_BUFFER_MASK;
+    filter->luluInterim[windowIndex] = input;
+    filter->luluInterimB[windowIndex] = -input;
+    return fixRoad(filter->luluInterim, filter->luluInterimB, windowIndex, filter->N);
 }
 
 FAST_CODE float luluFilterApply(luluFilter_t *filter, float input) {
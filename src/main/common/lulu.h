@@ -1,12 +1,15 @@
 #pragma once
 
-//Max N = 15
+#define LULU_MAX_N 15
+// power of two ring holding the 2N+1 newest samples, indexed with a mask instead of a modulo
+#define LULU_BUFFER_SIZE 32
+#define LULU_BUFFER_MASK (LULU_BUFFER_SIZE - 1)
+
 typedef struct {
-    int windowSize;
     int windowBufIndex;
     int N;
-    float luluInterim[32] __attribute__ ((aligned (128)));
-    float luluInterimB[32];
+    float luluInterim[LULU_BUFFER_SIZE] __attribute__ ((aligned (128)));
+    float luluInterimB[LULU_BUFFER_SIZE];
 } luluFilter_t;
 
 void luluFilterInit(luluFilter_t *filter, int N);
@@ -183,16 +183,123 @@ typedef struct {
 } quaternionProducts;
 #define QUATERNION_PRODUCTS_INITIALIZE  {.ww=1, .wx=0, .wy=0, .wz=0, .xx=0, .xy=0, .xz=0, .yy=0, .yz=0, .zz=0}
 
-void quaternionComputeProducts(quaternion *qIn, quaternionProducts *qPout);
-void quaternionTransformVectorBodyToEarth(quaternion *qVector, quaternion *qReference);
-void quaternionTransformVectorEarthToBody(quaternion *qVector, quaternion *qReference);
-void quaternionMultiply(quaternion *l, quaternion *r, quaternion *o);
-void quaternionNormalize(quaternion *q);
-void quaternionAdd(quaternion *l, quaternion *r, quaternion *o);
-void quaternionCopy(quaternion *s, quaternion *d);
-void quaternionConjugate(quaternion *i, quaternion *o);
-float quaternionDotProduct(quaternion *l, quaternion *r);
-float quaternionNorm(quaternion *q);
-float quaternionModulus(quaternion *q);
-void quaternionInitQuaternion(quaternion *i);
-void quaternionInitVector(quaternion *i);
+// 1/sqrt(x) for x > 0, the bit trick estimate and two Newton steps, relative error below 5e-6
+static inline float invSqrtf(float x) {
+    union {
+        float f;
+        int32_t i;
+    } xu;
+    const float halfX = 0.5f * x;
+    xu.f = x;
+    xu.i = 0x5f3759df - (xu.i >> 1);
+    float y = xu.f;
+    y = y * (1.5f - halfX * y * y);
+    y = y * (1.5f - halfX * y * y);
+    return y;
+}
+
+// The quaternion helpers run in the IMU and headfree paths every loop, they live here so they
+// inline. Sums of products stay in one expression so -ffast-math contracts them to FMA.
+static inline void quaternionComputeProducts(quaternion *qIn, quaternionProducts *qPout) {
+    qPout->ww = qIn->w * qIn->w;
+    qPout->wx = qIn->w * qIn->x;
+    qPout->wy = qIn->w * qIn->y;
+    qPout->wz = qIn->w * qIn->z;
+    qPout->xx = qIn->x * qIn->x;
+    qPout->xy = qIn->x * qIn->y;
+    qPout->xz = qIn->x * qIn->z;
+    qPout->yy = qIn->y * qIn->y;
+    qPout->yz = qIn->y * qIn->z;
+    qPout->zz = qIn->z * qIn->z;
+}
+
+static inline void quaternionMultiply(quaternion *l, quaternion *r, quaternion *o) {
+    const float w = l->w * r->w - l->x * r->x - l->y * r->y - l->z * r->z;
+    const float x = l->w * r->x + l->x * r->w + l->y * r->z - l->z * r->y;
+    const float y = l->w * r->y - l->x * r->z + l->y * r->w + l->z * r->x;
+    const float z = l->w * r->z + l->x * r->y - l->y * r->x + l->z * r->w;
+    o->w = w;
+    o->x = x;
+    o->y = y;
+    o->z = z;
+}
+
+static inline void quaternionAdd(quaternion *l, quaternion *r, quaternion *o) {
+    o->w = l->w + r->w;
+    o->x = l->x + r->x;
+    o->y = l->y + r->y;
+    o->z = l->z + r->z;
+}
+
+static inline void quaternionCopy(quaternion *s, quaternion *d) {
+    *d = *s;
+}
+
+static inline void quaternionConjugate(quaternion *i, quaternion *o) {
+    o->w = + i->w;
+    o->x = - i->x;
+    o->y = - i->y;
+    o->z = - i->z;
+}
+
+static inline float quaternionDotProduct(quaternion *l, quaternion *r) {
+    return l->w * r->w + l->x * r->x + l->y * r->y + l->z * r->z;
+}
+
+static inline float quaternionNorm(quaternion *q) {
+    return q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z;
+}
+
+static inline float quaternionModulus(quaternion *q) {
+    return fast_fsqrtf(quaternionNorm(q));
+}
+
+static inline void quaternionNormalize(quaternion *q) {
+    const float norm = quaternionNorm(q);
+    if (norm == 0) {
+        // normalization not possible
+        return;
+    }
+    const float invModulus = invSqrtf(norm);
+    q->w *= invModulus;
+    q->x *= invModulus;
+    q->y *= invModulus;
+    q->z *= invModulus;
+}
+
+// v' = v + w * t + q x t with t = 2 * (q x v), the rotation by a unit reference without the
+// two full quaternion products of q * v * q'
+static inline void quaternionRotateVector(quaternion *qVector, float w, float x, float y, float z) {
+    const float tx = 2.0f * (y * qVector->z - z * qVector->y);
+    const float ty = 2.0f * (z * qVector->x - x * qVector->z);
+    const float tz = 2.0f * (x * qVector->y - y * qVector->x);
+    const float vx = qVector->x + w * tx + y * tz - z * ty;
+    const float vy = qVector->y + w * ty + z * tx - x * tz;
+    const float vz = qVector->z + w * tz + x * ty - y * tx;
+    qVector->w = 0;
+    qVector->x = vx;
+    qVector->y = vy;
+    qVector->z = vz;
+}
+
+static inline void quaternionTransformVectorBodyToEarth(quaternion *qVector, quaternion *qReference) {
+    quaternionRotateVector(qVector, qReference->w, qReference->x, qReference->y, qReference->z);
+}
+
+static inline void quaternionTransformVectorEarthToBody(quaternion *qVector, quaternion *qReference) {
+    quaternionRotateVector(qVector, qReference->w, -qReference->x, -qReference->y, -qReference->z);
+}
+
+static inline void quaternionInitQuaternion(quaternion *i) {
+    i->w = 1;
+    i->x = 0;
+    i->y = 0;
+    i->z = 0;
+}
+
+static inline void quaternionInitVector(quaternion *i) {
+    i->w = 0;
+    i->x = 0;
+    i->y = 0;
+    i->z = 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/memory.h"
+
+// The arena is the RAM the linker script leaves between the last RAM section and the stack (.free_ram).
+// Hosted builds have no such gap and reserve it.
+#if defined(SIMULATOR_BUILD) || defined(UNIT_TEST)
+#ifndef MEM_ARENA_SIZE
+#define MEM_ARENA_SIZE 40960
+#endif
+static uint8_t memArena[MEM_ARENA_SIZE] __attribute__((aligned(4)));
+#define MEM_ARENA_START memArena
+#define MEM_ARENA_END (memArena + sizeof(memArena))
+#else
+extern uint8_t __free_ram_start__[];
+extern uint8_t __free_ram_end__[];
+#define MEM_ARENA_START __free_ram_start__
+#define MEM_ARENA_END __free_ram_end__
+#endif
+
+static size_t memUsed;
+
+void *memAllocate(size_t size) {
+    size = (size + 3) & ~3;
+    if (size > memGetAvailableBytes()) {
+        return NULL;
+    }
+    uint8_t *allocation = MEM_ARENA_START + memUsed;
+    memUsed += size;
+    // .free_ram is NOLOAD, nothing clears it at startup
+    memset(allocation, 0, size);
+    return allocation;
+}
+
+size_t memGetUsedBytes(void) {
+    return memUsed;
+}
+
+size_t memGetAvailableBytes(void) {
+    return (size_t)(MEM_ARENA_END - MEM_ARENA_START) - memUsed;
+}
+
+uint8_t *memUnallocated(void) {
+    return MEM_ARENA_START + memUsed;
+}
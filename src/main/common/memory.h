@@ -0,0 +1,33 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Boot time arena for the buffers of optional subsystems, so a feature that is off takes no RAM.
+// Allocations are made from the init functions only and never freed; they are zeroed and 4 byte aligned.
+// What the arena has left is the RAM of the parameter group copies, see pgCopy().
+
+void *memAllocate(size_t size);
+size_t memGetUsedBytes(void);
+size_t memGetAvailableBytes(void);
+uint8_t *memUnallocated(void);
@@ -0,0 +1,95 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/ringbuffer.h"
+
+// the acquire / release builtins emit a dmb on cortex-m, which also keeps the m7 write buffer in order
+#define RING_LOAD_ACQUIRE(index)            __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(index, value)    __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+void ringBufferInit(ringBuffer_t *ring, uint8_t *buffer, uint32_t size) {
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+uint32_t ringBufferUsed(const ringBuffer_t *ring) {
+    return RING_LOAD_ACQUIRE(ring->head) - RING_LOAD_ACQUIRE(ring->tail);
+}
+
+uint32_t ringBufferFree(const ringBuffer_t *ring) {
+    return ring->mask + 1 - ringBufferUsed(ring);
+}
+
+FAST_CODE bool ringBufferPush(ringBuffer_t *ring, uint8_t data) {
+    const uint32_t head = ring->head;
+    if (head - RING_LOAD_ACQUIRE(ring->tail) > ring->mask) {
+        return false;
+    }
+    ring->buffer[head & ring->mask] = data;
+    RING_STORE_RELEASE(ring->head, head + 1);
+    return true;
+}
+
+bool ringBufferWrite(ringBuffer_t *ring, const void *data, uint32_t len) {
+    const uint32_t head = ring->head;
+    if (ring->mask + 1 - (head - RING_LOAD_ACQUIRE(ring->tail)) < len) {
+        return false;
+    }
+    const uint8_t *src = data;
+    for (uint32_t i = 0; i < len; i++) {
+        ring->buffer[(head + i) & ring->mask] = src[i];
+    }
+    RING_STORE_RELEASE(ring->head, head + len);
+    return true;
+}
+
+FAST_CODE bool ringBufferPop(ringBuffer_t *ring, uint8_t *data) {
+    const uint32_t tail = ring->tail;
+    if (RING_LOAD_ACQUIRE(ring->head) == tail) {
+        return false;
+    }
+    *data = ring->buffer[tail & ring->mask];
+    RING_STORE_RELEASE(ring->tail, tail + 1);
+    return true;
+}
+
+bool ringBufferRead(ringBuffer_t *ring, void *data, uint32_t len) {
+    const uint32_t tail = ring->tail;
+    if (RING_LOAD_ACQUIRE(ring->head) - tail < len) {
+        return false;
+    }
+    uint8_t *dst = data;
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = ring->buffer[(tail + i) & ring->mask];
+    }
+    RING_STORE_RELEASE(ring->tail, tail + len);
+    return true;
+}
+
+void ringBufferFlush(ringBuffer_t *ring) {
+    RING_STORE_RELEASE(ring->tail, RING_LOAD_ACQUIRE(ring->head));
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// lock free single producer / single consumer byte fifo, e.g. an interrupt handing data to a task.
+// The size must be a power of two. head and tail run freely and are only ever written by one side,
+// the acquire / release ordering on them makes the data visible before the index that publishes it.
+
+typedef struct ringBuffer_s {
+    uint8_t *buffer;
+    uint32_t mask;              // size - 1
+    uint32_t head;              // written by the producer only
+    uint32_t tail;              // written by the consumer only
+} ringBuffer_t;
+
+void ringBufferInit(ringBuffer_t *ring, uint8_t *buffer, uint32_t size);
+
+// either side
+uint32_t ringBufferUsed(const ringBuffer_t *ring);
+uint32_t ringBufferFree(const ringBuffer_t *ring);
+
+// producer side
+bool ringBufferPush(ringBuffer_t *ring, uint8_t data);
+bool ringBufferWrite(ringBuffer_t *ring, const void *data, uint32_t len);   // all or nothing
+
+// consumer side
+bool ringBufferPop(ringBuffer_t *ring, uint8_t *data);
+bool ringBufferRead(ringBuffer_t *ring, void *data, uint32_t len);          // all or nothing
+void ringBufferFlush(ringBuffer_t *ring);
@@ -28,23 +28,67 @@
 
 #define SDFT_R 0.9999f  // damping factor for guaranteed SDFT stability (r < 1.0f)
 
+#ifdef USE_SDFT_FIXED_POINT
+#define SDFT_Q31_ONE 2147483648.0f
+
+static FAST_RAM_ZERO_INIT int32_t   rPowerN;  // SDFT_R to the power of SDFT_SAMPLE_SIZE in Q31
+#else
 static FAST_RAM_ZERO_INIT float     rPowerN;  // SDFT_R to the power of SDFT_SAMPLE_SIZE
+#endif
 static FAST_RAM_ZERO_INIT bool      isInitialized;
-static FAST_RAM_ZERO_INIT complex_t twiddle[SDFT_BIN_COUNT];
+static FAST_RAM_ZERO_INIT sdftComplex_t twiddle[SDFT_BIN_COUNT];
 
 static void applySqrt(const sdft_t *sdft, float *data);
 
+#ifdef USE_SDFT_FIXED_POINT
+static inline int32_t mulQ31(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 31);
+}
+
+// twiddle * (bin + delta), delta only has a real part
+static inline sdftComplex_t sdftRotate(const sdftComplex_t *twiddle, const sdftComplex_t *bin, int32_t delta)
+{
+    const int32_t re = bin->re + delta;
+    sdftComplex_t result;
+    result.re = (int32_t)(((int64_t)twiddle->re * re - (int64_t)twiddle->im * bin->im) >> 31);
+    result.im = (int32_t)(((int64_t)twiddle->re * bin->im + (int64_t)twiddle->im * re) >> 31);
+    return result;
+}
+
+static inline sdftSample_t sdftToSample(float sample)
+{
+    return lrintf(sample * SDFT_SAMPLE_SCALE);
+}
+
+static inline float sdftMagSqOf(int32_t re, int32_t im)
+{
+    const float fre = re * (1.0f / SDFT_SAMPLE_SCALE);
+    const float fim = im * (1.0f / SDFT_SAMPLE_SCALE);
+    return fre * fre + fim * fim;
+}
+#endif
+
 
 void sdftInit(sdft_t *sdft, const uint8_t startBin, const uint8_t endBin, const uint8_t numBatches)
 {
     if (!isInitialized) {
-        rPowerN = powf(SDFT_R, SDFT_SAMPLE_SIZE);
         const float c = 2.0f * M_PIf / (float)SDFT_SAMPLE_SIZE;
+#ifdef USE_SDFT_FIXED_POINT
+        rPowerN = lrintf(powf(SDFT_R, SDFT_SAMPLE_SIZE) * SDFT_Q31_ONE);
+        for (uint8_t i = 0; i < SDFT_BIN_COUNT; i++) {
+            const float phi = c * i;
+            twiddle[i].re = lrintf(SDFT_R * cos_approx(phi) * SDFT_Q31_ONE);
+            twiddle[i].im = lrintf(SDFT_R * sin_approx(phi) * SDFT_Q31_ONE);
+        }
+#else
+        rPowerN = powf(SDFT_R, SDFT_SAMPLE_SIZE);
         for (uint8_t i = 0; i < SDFT_BIN_COUNT; i++) {
             float phi = 0.0f;
             phi = c * i;
             twiddle[i] = SDFT_R * (cos_approx(phi) + _Complex_I * sin_approx(phi));
         }
+#endif
         isInitialized = true;
     }
 
@@ -55,11 +99,16 @@ void sdftInit(sdft_t *sdft, const uint8_t startBin, const uint8_t endBin, const
     sdft->batchSize = (sdft->endBin - sdft->startBin + 1) / sdft->numBatches + 1;
 
     for (uint8_t i = 0; i < SDFT_SAMPLE_SIZE; i++) {
-        sdft->samples[i] = 0.0f;
+        sdft->samples[i] = 0;
     }
 
     for (uint8_t i = 0; i < SDFT_BIN_COUNT; i++) {
+#ifdef USE_SDFT_FIXED_POINT
+        sdft->data[i].re = 0;
+        sdft->data[i].im = 0;
+#else
         sdft->data[i] = 0.0f;
+#endif
     }
 }
 
@@ -67,6 +116,17 @@ void sdftInit(sdft_t *sdft, const uint8_t startBin, const uint8_t endBin, const
 // Add new sample to frequency spectrum
 FAST_CODE void sdftPush(sdft_t *sdft, const float *sample)
 {
+#ifdef USE_SDFT_FIXED_POINT
+    const sdftSample_t newSample = sdftToSample(*sample);
+    const int32_t delta = newSample - mulQ31(rPowerN, sdft->samples[sdft->idx]);
+
+    sdft->samples[sdft->idx] = newSample;
+    sdft->idx = (sdft->idx + 1) % SDFT_SAMPLE_SIZE;
+
+    for (uint8_t i = sdft->startBin; i <= sdft->endBin; i++) {
+        sdft->data[i] = sdftRotate(&twiddle[i], &sdft->data[i], delta);
+    }
+#else
     const float delta = *sample - rPowerN * sdft->samples[sdft->idx];
 
     sdft->samples[sdft->idx] = *sample;
@@ -75,6 +135,7 @@ FAST_CODE void sdftPush(sdft_t *sdft, const float *sample)
     for (uint8_t i = sdft->startBin; i <= sdft->endBin; i++) {
         sdft->data[i] = twiddle[i] * (sdft->data[i] + delta);
     }
+#endif
 }
 
 
@@ -84,10 +145,16 @@ FAST_CODE void sdftPushBatch(sdft_t* sdft, const float *sample, const uint8_t *b
     const uint8_t batchStart = sdft->batchSize * *batchIdx;
     uint8_t batchEnd = batchStart;
 
-    const float delta = *sample - rPowerN * sdft->samples[sdft->idx];
+#ifdef USE_SDFT_FIXED_POINT
+    const sdftSample_t newSample = sdftToSample(*sample);
+    const int32_t delta = newSample - mulQ31(rPowerN, sdft->samples[sdft->idx]);
+#else
+    const sdftSample_t newSample = *sample;
+    const float delta = newSample - rPowerN * sdft->samples[sdft->idx];
+#endif
 
     if (*batchIdx == sdft->numBatches - 1) {
-        sdft->samples[sdft->idx] = *sample;
+        sdft->samples[sdft->idx] = newSample;
         sdft->idx = (sdft->idx + 1) % SDFT_SAMPLE_SIZE;
         batchEnd += sdft->endBin - batchStart + 1;
     } else {
@@ -95,7 +162,11 @@ FAST_CODE void sdftPushBatch(sdft_t* sdft, const float *sample, const uint8_t *b
     }
 
     for (uint8_t i = batchStart; i < batchEnd; i++) {
+#ifdef USE_SDFT_FIXED_POINT
+        sdft->data[i] = sdftRotate(&twiddle[i], &sdft->data[i], delta);
+#else
         sdft->data[i] = twiddle[i] * (sdft->data[i] + delta);
+#endif
     }
 }
 
@@ -104,9 +175,13 @@ FAST_CODE void sdftPushBatch(sdft_t* sdft, const float *sample, const uint8_t *b
 FAST_CODE void sdftMagSq(const sdft_t *sdft, float *output)
 {
     for (uint8_t i = sdft->startBin; i <= sdft->endBin; i++) {
+#ifdef USE_SDFT_FIXED_POINT
+        output[i] = sdftMagSqOf(sdft->data[i].re, sdft->data[i].im);
+#else
         float re = crealf(sdft->data[i]);
         float im = cimagf(sdft->data[i]);
         output[i] = re * re + im * im;
+#endif
     }
 }
 
@@ -123,16 +198,41 @@ FAST_CODE void sdftMagnitude(const sdft_t *sdft, float *output)
 // Hann window in frequency domain: X[k] = -0.25 * X[k-1] +0.5 * X[k] -0.25 * X[k+1]
 FAST_CODE void sdftWinSq(const sdft_t *sdft, float *output)
 {
+    sdftWinSqBins(sdft, sdft->data, output);
+}
+
+
+// Same as sdftWinSq() but on bins copied out of the sdft with sdftCopyBins()
+FAST_CODE void sdftWinSqBins(const sdft_t *sdft, const sdftComplex_t *bins, float *output)
+{
+#ifdef USE_SDFT_FIXED_POINT
+    for (uint8_t i = (sdft->startBin + 1); i < sdft->endBin; i++) {
+        // multiply by 2 to save one multiplication
+        const int32_t re = bins[i].re - ((bins[i - 1].re + bins[i + 1].re) >> 1);
+        const int32_t im = bins[i].im - ((bins[i - 1].im + bins[i + 1].im) >> 1);
+        output[i] = sdftMagSqOf(re, im);
+    }
+#else
     complex_t val;
 
     for (uint8_t i = (sdft->startBin + 1); i < sdft->endBin; i++) {
         float re;
         float im;
-        val = sdft->data[i] - 0.5f * (sdft->data[i - 1] + sdft->data[i + 1]); // multiply by 2 to save one multiplication
+        val = bins[i] - 0.5f * (bins[i - 1] + bins[i + 1]); // multiply by 2 to save one multiplication
         re = crealf(val);
         im = cimagf(val);
         output[i] = re * re + im * im;
     }
+#endif
+}
+
+
+// Copies the bins sdftWinSq() looks at, startBin to endBin
+FAST_CODE void sdftCopyBins(const sdft_t *sdft, sdftComplex_t *bins)
+{
+    for (uint8_t i = sdft->startBin; i <= sdft->endBin; i++) {
+        bins[i] = sdft->data[i];
+    }
 }
 
 
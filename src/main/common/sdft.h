@@ -25,25 +25,48 @@
 
 #include <stdint.h>
 #include <complex.h>
+
+#include "common/utils.h"
+
 #undef I  // avoid collision of imaginary unit I with variable I in pid.h
 typedef float complex complex_t; // Better readability for type "float complex"
 
+// window length, a target may override it to trade frequency resolution against loop time
+#ifndef SDFT_SAMPLE_SIZE
 #define SDFT_SAMPLE_SIZE 72
+#endif
 #define SDFT_BIN_COUNT   (SDFT_SAMPLE_SIZE / 2)
 
+#ifdef USE_SDFT_FIXED_POINT
+// Q31 twiddles and integer samples in 1/SDFT_SAMPLE_SCALE deg/s, for targets where complex float is slow.
+// The scale leaves headroom for a full scale gyro signal summed over the whole window.
+#define SDFT_SAMPLE_SCALE 256
+
+typedef struct sdftComplex_s {
+    int32_t re;
+    int32_t im;
+} sdftComplex_t;
+
+typedef int32_t sdftSample_t;
+#else
+typedef complex_t sdftComplex_t;
+typedef float sdftSample_t;
+#endif
+
 typedef struct sdft_s {
 
-    uint8_t idx;                       // circular buffer index
+    uint8_t idx;                            // circular buffer index
     uint8_t startBin;
     uint8_t endBin;
     uint8_t batchSize;
     uint8_t numBatches;
-    float samples[SDFT_SAMPLE_SIZE];   // circular buffer
-    complex_t data[SDFT_BIN_COUNT];    // complex frequency spectrum
+    sdftSample_t samples[SDFT_SAMPLE_SIZE]; // circular buffer
+    sdftComplex_t data[SDFT_BIN_COUNT];     // complex frequency spectrum
 
 } sdft_t;
 
 STATIC_ASSERT(SDFT_SAMPLE_SIZE <= (uint8_t)-1, window_size_greater_than_underlying_type);
+STATIC_ASSERT(SDFT_SAMPLE_SIZE % 2 == 0, window_size_must_be_even);
 
 void sdftInit(sdft_t *sdft, const uint8_t startBin, const uint8_t endBin, const uint8_t numBatches);
 void sdftPush(sdft_t *sdft, const float *sample);
@@ -51,4 +74,6 @@ void sdftPushBatch(sdft_t *sdft, const float *sample, const uint8_t *batchIdx);
 void sdftMagSq(const sdft_t *sdft, float *output);
 void sdftMagnitude(const sdft_t *sdft, float *output);
 void sdftWinSq(const sdft_t *sdft, float *output);
+void sdftWinSqBins(const sdft_t *sdft, const sdftComplex_t *bins, float *output);
+void sdftCopyBins(const sdft_t *sdft, sdftComplex_t *bins);
 void sdftWindow(const sdft_t *sdft, float *output);
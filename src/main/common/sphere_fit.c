@@ -0,0 +1,110 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "common/sphere_fit.h"
+
+#define SPHERE_FIT_MIN_WEIGHT 10.0f
+#define SPHERE_FIT_MIN_PIVOT  1e-6f
+
+void sphereFitInit(sphereFit_t *fit, const float reference[3], float scale) {
+    memset(fit, 0, sizeof(*fit));
+    for (int i = 0; i < 3; i++) {
+        fit->reference[i] = reference[i];
+    }
+    fit->scale = (scale > 0.0f) ? scale : 1.0f;
+}
+
+// |p - c|^2 = r^2 is linear in (c, r^2 - |c|^2): 2p.c + (r^2 - |c|^2) = |p|^2
+void sphereFitAddSample(sphereFit_t *fit, const float sample[3]) {
+    float row[4];
+    float b = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        const float p = (sample[i] - fit->reference[i]) / fit->scale;
+        row[i] = 2.0f * p;
+        b += p * p;
+    }
+    row[3] = 1.0f;
+    for (int i = 0; i < 4; i++) {
+        for (int j = i; j < 4; j++) {
+            fit->ata[i][j] += row[i] * row[j];
+        }
+        fit->atb[i] += row[i] * b;
+    }
+    fit->weight += 1.0f;
+}
+
+bool sphereFitSolve(const sphereFit_t *fit, float center[3], float *radius) {
+    if (fit->weight < SPHERE_FIT_MIN_WEIGHT) {
+        return false;
+    }
+    float m[4][5];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            m[i][j] = (j >= i ? fit->ata[i][j] : fit->ata[j][i]) / fit->weight;
+        }
+        m[i][4] = fit->atb[i] / fit->weight;
+    }
+    // gaussian elimination with partial pivoting, a small pivot means the
+    // samples don't span enough of the sphere to pin down its center
+    for (int col = 0; col < 4; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 4; row++) {
+            if (fabsf(m[row][col]) > fabsf(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (fabsf(m[pivot][col]) < SPHERE_FIT_MIN_PIVOT) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int k = col; k < 5; k++) {
+                const float t = m[col][k];
+                m[col][k] = m[pivot][k];
+                m[pivot][k] = t;
+            }
+        }
+        for (int row = col + 1; row < 4; row++) {
+            const float f = m[row][col] / m[col][col];
+            for (int k = col; k < 5; k++) {
+                m[row][k] -= f * m[col][k];
+            }
+        }
+    }
+    float x[4];
+    for (int row = 3; row >= 0; row--) {
+        float s = m[row][4];
+        for (int k = row + 1; k < 4; k++) {
+            s -= m[row][k] * x[k];
+        }
+        x[row] = s / m[row][row];
+    }
+    const float r2 = x[3] + x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    if (r2 <= 0.0f) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        center[i] = fit->reference[i] + x[i] * fit->scale;
+    }
+    *radius = sqrtf(r2) * fit->scale;
+    return true;
+}
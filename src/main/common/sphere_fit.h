@@ -0,0 +1,38 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// Least squares sphere fit kept as running normal equations, so samples are
+// added one at a time without being stored. Samples are taken relative to a
+// reference point and scaled to about unit size to keep the sums in float range.
+typedef struct sphereFit_s {
+    float ata[4][4];
+    float atb[4];
+    float reference[3];
+    float scale;
+    float weight;
+} sphereFit_t;
+
+void sphereFitInit(sphereFit_t *fit, const float reference[3], float scale);
+void sphereFitAddSample(sphereFit_t *fit, const float sample[3]);
+bool sphereFitSolve(const sphereFit_t *fit, float center[3], float *radius);
@@ -134,6 +134,53 @@ char *itoa(int i, char *a, int base) {
 
 #endif
 
+// value right aligned in at least width characters, with a point ahead of the last decimals digits.
+// Padding with '0' goes between the sign and the digits
+static char *formatNumber(char *buf, int value, int decimals, int width, char pad) {
+    char digits[16];
+    int count = 0;
+    unsigned magnitude = value < 0 ? -(unsigned)value : (unsigned)value;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude || count <= decimals);
+    int length = count + (decimals > 0) + (value < 0);
+    if (value < 0 && pad == '0') {
+        *buf++ = '-';
+    }
+    for (; length < width; length++) {
+        *buf++ = pad;
+    }
+    if (value < 0 && pad != '0') {
+        *buf++ = '-';
+    }
+    while (count) {
+        *buf++ = digits[--count];
+        if (decimals && count == decimals) {
+            *buf++ = '.';
+        }
+    }
+    *buf = '\0';
+    return buf;
+}
+
+// "%<width>d", or "%0<width>d" for a '0' pad
+char *formatInt(char *buf, int value, int width, char pad) {
+    return formatNumber(buf, value, 0, width, pad);
+}
+
+// value in units of 10^-decimals, space padded to width, formatFixed(buf, -1234, 2, 7) gives " -12.34"
+char *formatFixed(char *buf, int value, int decimals, int width) {
+    return formatNumber(buf, value, MIN(decimals, 9), width, ' ');
+}
+
+// mm:ss, minutes take more digits past 99
+char *formatTime(char *buf, int seconds) {
+    buf = formatNumber(buf, seconds / 60, 0, 2, '0');
+    *buf++ = ':';
+    return formatNumber(buf, seconds % 60, 0, 2, '0');
+}
+
 char *ftoa(float x, char *floatString) {
     int32_t value;
     char intString1[12];
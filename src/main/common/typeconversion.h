@@ -30,6 +30,13 @@ char a2i(char ch, const char **src, int base, int *nump);
 char *ftoa(float x, char *floatString);
 float fastA2F(const char *p);
 
+// Formatters for values redrawn every OSD or telemetry frame, cheaper than tfp_sprintf() as
+// there is no format string to parse. Each one terminates the string and returns a pointer
+// to the terminating zero, so calls can be chained.
+char *formatInt(char *buf, int value, int width, char pad);
+char *formatFixed(char *buf, int value, int decimals, int width);
+char *formatTime(char *buf, int seconds);
+
 #ifndef HAVE_ITOA_FUNCTION
 char *itoa(int i, char *a, int r);
 #endif
@@ -43,6 +43,16 @@ extern uint8_t __config_end;
 
 static uint16_t eepromConfigSize;
 
+/*
+ * A save appends the records that changed since the last one as a delta after the stored config, so the flash
+ * sector is only erased when the deltas no longer fit and the whole config is rewritten. Later records replace
+ * earlier ones with the same pgn. A delta that was cut short fails its CRC and is ignored along with the space
+ * after it, which the next save then reclaims by rewriting everything.
+ */
+static const uint8_t *configDeltasStart;    // first delta, just after the stored config
+static const uint8_t *configDeltasEnd;      // where the next delta goes
+static bool configDeltasAppendable;         // the flash from configDeltasEnd onwards has never been written
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -77,6 +87,17 @@ typedef struct {
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+#define CONFIG_DELTA_MAGIC      0xDE17
+#define CONFIG_DELTA_ERASED     0xFFFF
+
+// Header for each delta, followed by its records and checksum. Deltas start on a word boundary.
+typedef struct {
+    uint16_t size;              // header, records and checksum
+    uint16_t magic;             // CONFIG_DELTA_MAGIC
+} PG_PACKED configDeltaHeader_t;
+
+#define CONFIG_WORD_ALIGN(size) (((size) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -90,6 +111,7 @@ void initEEPROM(void) {
     BUILD_BUG_ON(sizeof(packingTest_t) != 5);
     BUILD_BUG_ON(sizeof(configFooter_t) != 2);
     BUILD_BUG_ON(sizeof(configRecord_t) != 6);
+    BUILD_BUG_ON(sizeof(configDeltaHeader_t) != 4);
 }
 
 bool isEEPROMVersionValid(void) {
@@ -101,8 +123,41 @@ bool isEEPROMVersionValid(void) {
     return true;
 }
 
+static bool isDeltaValid(const configDeltaHeader_t *delta) {
+    const uint8_t *p = (const uint8_t *)delta;
+    if (delta->magic != CONFIG_DELTA_MAGIC
+            || delta->size < sizeof(*delta) + sizeof(uint16_t)
+            || p + delta->size > &__config_end) {
+        return false;
+    }
+    const uint16_t crc = crc16_ccitt_update(CRC_START_VALUE, p, delta->size);
+    return crc == CRC_CHECK_VALUE;
+}
+
+// Find the deltas following the stored config that ends at p
+static void scanDeltas(const uint8_t *p) {
+    p = &__config_start + CONFIG_WORD_ALIGN(p - &__config_start);
+    configDeltasStart = p;
+    configDeltasAppendable = false;
+    while (p + sizeof(configDeltaHeader_t) <= &__config_end) {
+        const configDeltaHeader_t *delta = (const configDeltaHeader_t *)p;
+        if (delta->size == CONFIG_DELTA_ERASED && delta->magic == CONFIG_DELTA_ERASED) {
+            configDeltasAppendable = true;
+            break;
+        }
+        if (!isDeltaValid(delta)) {
+            break;
+        }
+        p += CONFIG_WORD_ALIGN(delta->size);
+    }
+    configDeltasEnd = p;
+}
+
 // Scan the EEPROM config. Returns true if the config is valid.
 bool isEEPROMStructureValid(void) {
+    configDeltasStart = NULL;
+    configDeltasEnd = NULL;
+    configDeltasAppendable = false;
     const uint8_t *p = &__config_start;
     const configHeader_t *header = (const configHeader_t *)p;
     if (header->magic_be != 0xBE) {
@@ -134,23 +189,25 @@ bool isEEPROMStructureValid(void) {
     p += sizeof(storedCrc);
     eepromConfigSize = p - &__config_start;
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    if (crc != CRC_CHECK_VALUE) {
+        return false;
+    }
+    scanDeltas((const uint8_t *)storedCrc + sizeof(*storedCrc));
+    eepromConfigSize = configDeltasEnd - &__config_start;
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void) {
     return eepromConfigSize;
 }
 
-// find config record for reg + classification (profile info) in EEPROM
+// find config record for reg + classification (profile info) in the records between p and end
 // return NULL when record is not found
-// this function assumes that EEPROM content is valid
-static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification) {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
+static const configRecord_t *findRecord(const uint8_t *p, const uint8_t *end, const pgRegistry_t *reg, configRecordFlags_e classification) {
+    while (p + sizeof(configRecord_t) <= end) {
         const configRecord_t *record = (const configRecord_t *)p;
         if (record->size == 0
-                || p + record->size >= &__config_end
+                || p + record->size >= end
                 || record->size < sizeof(*record))
             break;
         if (pgN(reg) == record->pgn
@@ -162,6 +219,23 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
     return NULL;
 }
 
+// find the latest config record for reg + classification (profile info) in EEPROM
+// return NULL when record is not found
+// this function assumes that EEPROM content is valid
+static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification) {
+    const configRecord_t *found = findRecord(&__config_start + sizeof(configHeader_t), &__config_end, reg, classification);
+    for (const uint8_t *p = configDeltasStart; p && p < configDeltasEnd; ) {
+        const configDeltaHeader_t *delta = (const configDeltaHeader_t *)p;
+        // the checksum ends the records, the search may look at it but not past it
+        const configRecord_t *record = findRecord(p + sizeof(*delta), p + delta->size, reg, classification);
+        if (record) {
+            found = record;
+        }
+        p += CONFIG_WORD_ALIGN(delta->size);
+    }
+    return found;
+}
+
 // Initialize all PG records from EEPROM.
 // This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
 //   but each PG is loaded/initialized exactly once and in defined order.
@@ -220,7 +294,75 @@ static bool writeSettingsToEEPROM(void) {
     return success;
 }
 
+static bool isRecordUnchanged(const pgRegistry_t *reg) {
+    const configRecord_t *record = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+    return record
+           && record->version == pgVersion(reg)
+           && record->size == sizeof(configRecord_t) + pgSize(reg)
+           && memcmp(record->pg, reg->address, pgSize(reg)) == 0;
+}
+
+// Append the records that changed as a delta, returns false if the config has to be rewritten instead
+static bool appendChangedSettingsToEEPROM(void) {
+    if (!configDeltasAppendable || !isEEPROMVersionValid()) {
+        return false;
+    }
+    uint32_t deltaSize = sizeof(configDeltaHeader_t) + sizeof(uint16_t);
+    PG_FOREACH(reg) {
+        if (!isRecordUnchanged(reg)) {
+            deltaSize += sizeof(configRecord_t) + pgSize(reg);
+        }
+    }
+    if (deltaSize == sizeof(configDeltaHeader_t) + sizeof(uint16_t)) {
+        // nothing to save
+        return true;
+    }
+    if (deltaSize >= CONFIG_DELTA_ERASED || configDeltasEnd + CONFIG_WORD_ALIGN(deltaSize) > &__config_end) {
+        return false;
+    }
+    for (const uint8_t *p = configDeltasEnd; p < configDeltasEnd + CONFIG_WORD_ALIGN(deltaSize); p++) {
+        if (*p != 0xFF) {
+            return false;
+        }
+    }
+    // The delta never starts on a flash page boundary, so the streamer doesn't erase anything
+    const configDeltaHeader_t *delta = (const configDeltaHeader_t *)configDeltasEnd;
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+    config_streamer_start(&streamer, (uintptr_t)configDeltasEnd, &__config_end - configDeltasEnd);
+    const configDeltaHeader_t header = {
+        .size = deltaSize,
+        .magic = CONFIG_DELTA_MAGIC,
+    };
+    config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
+    uint16_t crc = CRC_START_VALUE;
+    crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
+    PG_FOREACH(reg) {
+        if (isRecordUnchanged(reg)) {
+            continue;
+        }
+        const uint16_t regSize = pgSize(reg);
+        const configRecord_t record = {
+            .size = sizeof(configRecord_t) + regSize,
+            .pgn = pgN(reg),
+            .version = pgVersion(reg),
+            .flags = CR_CLASSICATION_SYSTEM
+        };
+        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
+        crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
+        config_streamer_write(&streamer, reg->address, regSize);
+        crc = crc16_ccitt_update(crc, reg->address, regSize);
+    }
+    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
+    config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
+    config_streamer_flush(&streamer);
+    return config_streamer_finish(&streamer) == 0 && isDeltaValid(delta);
+}
+
 void writeConfigToEEPROM(void) {
+    if (appendChangedSettingsToEEPROM() && isEEPROMStructureValid()) {
+        return;
+    }
     bool success = false;
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
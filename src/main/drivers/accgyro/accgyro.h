@@ -23,6 +23,7 @@
 #include "platform.h"
 
 #include "common/axis.h"
+#include "common/time.h"
 #include "drivers/exti.h"
 #include "drivers/bus.h"
 #include "drivers/sensor.h"
@@ -74,6 +75,14 @@
 #define GYRO_RATE_16_kHz    64.0f
 #define GYRO_RATE_32_kHz    32.0f
 
+#ifdef USE_GYRO_SPI_DMA
+#define GYRO_SPI_DMA_BUFFER_SIZE 7                          // register address plus three big endian axes
+#endif
+
+#ifdef USE_GYRO_ACC_BURST
+#define GYRO_ACC_BURST_BUFFER_SIZE 15                       // register address plus acc, temperature and gyro data
+#endif
+
 typedef struct gyroDev_s {
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
     pthread_mutex_t lock;
@@ -100,10 +109,34 @@ typedef struct gyroDev_s {
     uint8_t hardware_32khz_lpf;
     uint8_t mpuDividerDrops;
     ioTag_t mpuIntExtiTag;
+    bool dataReadyInterrupt;                                // the EXTI is set up and fires on every sample
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    volatile timeUs_t dataReadyAtUs;                        // microsISR() of the last data ready interrupt, 0 without one
+#endif
     uint8_t gyroHasOverflowProtection;
     gyroSensor_e gyroHardware;
     uint8_t accDataReg;
     uint8_t gyroDataReg;
+#ifdef USE_GYRO_FIFO_BATCH
+    uint8_t fifoBatchSize;                                  // samples per fifo watermark, 1 reads the data registers
+    uint8_t fifoSampleCount;                                // samples drained by the last read
+    int16_t gyroADCRawFifo[GYRO_FIFO_BATCH_MAX][XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_GYRO_ACC_BURST
+    bool accBurst;                                          // gyro reads start at accDataReg and fetch the acc too
+    uint8_t accBurstLength;                                 // register address up to the end of the gyro data
+    volatile bool accBurstDataReady;                        // accADCRawBurst holds a sample the acc hasn't copied yet
+    int16_t accADCRawBurst[XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_GYRO_SPI_DMA
+    bool useSpiDma;                                         // data register read is started from the EXTI
+    volatile bool spiDmaDataReady;                          // gyroADCRaw was filled by the DMA completion
+    sensorGyroReadFuncPtr spiDmaFallbackReadFn;             // blocking read used when no DMA sample is pending
+    struct spiDmaJob_s *spiDmaJob;                          // points at DMA reachable buffers, gyroDev_t may sit in CCM
+#ifdef USE_GYRO_PID_INTERRUPT
+    void (*spiDmaSampleFn)(void);                           // run in the DMA completion interrupt once gyroADCRaw is filled
+#endif
+#endif
 } gyroDev_t;
 
 typedef struct accDev_s {
@@ -120,6 +153,9 @@ typedef struct accDev_s {
     bool dataReady;
     bool acc_high_fsr;
     char revisionCode;                                      // a revision code for the sensor, if known
+#ifdef USE_GYRO_ACC_BURST
+    gyroDev_t *burstGyro;                                   // gyro whose reads also carry this acc's data
+#endif
 } accDev_t;
 
 static inline void accDevLock(accDev_t *acc) {
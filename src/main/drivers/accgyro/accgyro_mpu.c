@@ -117,6 +117,166 @@ static void mpu6050FindRevision(gyroDev_t *gyro) {
 }
 #endif
 
+#ifdef USE_GYRO_ACC_BURST
+// data holds the register address followed by the registers from accDataReg on
+FAST_CODE static void mpuGyroParseAccBurst(gyroDev_t *gyro, const uint8_t *data) {
+    const uint8_t *gyroData = data + 1 + gyro->gyroDataReg - gyro->accDataReg;
+    gyro->accADCRawBurst[X] = (int16_t)((data[1] << 8) | data[2]);
+    gyro->accADCRawBurst[Y] = (int16_t)((data[3] << 8) | data[4]);
+    gyro->accADCRawBurst[Z] = (int16_t)((data[5] << 8) | data[6]);
+    gyro->accBurstDataReady = true;
+    gyro->gyroADCRaw[X] = (int16_t)((gyroData[0] << 8) | gyroData[1]);
+    gyro->gyroADCRaw[Y] = (int16_t)((gyroData[2] << 8) | gyroData[3]);
+    gyro->gyroADCRaw[Z] = (int16_t)((gyroData[4] << 8) | gyroData[5]);
+}
+
+FAST_CODE static bool mpuGyroReadSPIAccBurst(gyroDev_t *gyro) {
+    uint8_t dataToSend[GYRO_ACC_BURST_BUFFER_SIZE];
+    uint8_t data[GYRO_ACC_BURST_BUFFER_SIZE];
+    memset(dataToSend, 0xFF, gyro->accBurstLength);
+    dataToSend[0] = gyro->accDataReg | 0x80;
+    if (!spiBusTransfer(&gyro->bus, dataToSend, data, gyro->accBurstLength)) {
+        return false;
+    }
+    mpuGyroParseAccBurst(gyro, data);
+    return true;
+}
+
+// Makes every gyro read a single transfer from the acc data registers to the end of the
+// gyro ones, on the sensors where those are adjacent and big endian, so the acc no longer
+// needs its own bus transaction. Must run before mpuGyroSpiDmaInit().
+bool mpuGyroAccBurstInit(gyroDev_t *gyro) {
+    if (gyro->bus.bustype != BUSTYPE_SPI || !gyro->accDataReg || gyro->gyroDataReg <= gyro->accDataReg) {
+        return false;
+    }
+    const int length = 1 + gyro->gyroDataReg - gyro->accDataReg + 6;
+    if (gyro->gyroDataReg - gyro->accDataReg < 6 || length > GYRO_ACC_BURST_BUFFER_SIZE) {
+        return false;
+    }
+#ifdef USE_GYRO_FIFO_BATCH
+    // the fifo packets are gyro only
+    if (gyro->fifoBatchSize > 1) {
+        return false;
+    }
+#endif
+#ifdef USE_GYRO_SPI_DMA
+    if (gyro->useSpiDma) {
+        return false;
+    }
+#endif
+    gyro->accBurstLength = length;
+    gyro->accBurstDataReady = false;
+    gyro->readFn = mpuGyroReadSPIAccBurst;
+    gyro->accBurst = true;
+    return true;
+}
+
+bool mpuAccReadGyroBurst(accDev_t *acc) {
+    gyroDev_t *gyro = acc->burstGyro;
+    if (!gyro->accBurstDataReady) {
+        return false;
+    }
+    // the gyro read may preempt the copy, take the sample again if it did
+    do {
+        gyro->accBurstDataReady = false;
+        acc->ADCRaw[X] = gyro->accADCRawBurst[X];
+        acc->ADCRaw[Y] = gyro->accADCRawBurst[Y];
+        acc->ADCRaw[Z] = gyro->accADCRawBurst[Z];
+    } while (gyro->accBurstDataReady);
+    return true;
+}
+#endif
+
+#ifdef USE_GYRO_SPI_DMA
+#ifdef USE_DUAL_GYRO
+#define MPU_SPI_DMA_GYRO_COUNT 2
+#else
+#define MPU_SPI_DMA_GYRO_COUNT 1
+#endif
+// Not FAST_RAM, on the F405 that is CCM which the DMA controllers cannot reach, DMA_RAM on the F7
+#ifdef USE_GYRO_ACC_BURST
+#define MPU_SPI_DMA_BUFFER_SIZE GYRO_ACC_BURST_BUFFER_SIZE
+#else
+#define MPU_SPI_DMA_BUFFER_SIZE GYRO_SPI_DMA_BUFFER_SIZE
+#endif
+static DMA_RAM uint8_t mpuSpiDmaTxBuf[MPU_SPI_DMA_GYRO_COUNT][MPU_SPI_DMA_BUFFER_SIZE];
+static DMA_RAM uint8_t mpuSpiDmaRxBuf[MPU_SPI_DMA_GYRO_COUNT][MPU_SPI_DMA_BUFFER_SIZE];
+static spiDmaJob_t mpuSpiDmaJob[MPU_SPI_DMA_GYRO_COUNT];
+static uint8_t mpuSpiDmaGyroCount;
+
+FAST_CODE static void mpuGyroSpiDmaComplete(uint32_t arg) {
+    gyroDev_t *gyro = (gyroDev_t *)arg;
+    const uint8_t *data = gyro->spiDmaJob->rxData;
+#ifdef USE_GYRO_ACC_BURST
+    if (gyro->accBurst) {
+        mpuGyroParseAccBurst(gyro, data);
+    } else
+#endif
+    {
+        gyro->gyroADCRaw[X] = (int16_t)((data[1] << 8) | data[2]);
+        gyro->gyroADCRaw[Y] = (int16_t)((data[3] << 8) | data[4]);
+        gyro->gyroADCRaw[Z] = (int16_t)((data[5] << 8) | data[6]);
+    }
+    gyro->spiDmaDataReady = true;
+    gyro->dataReady = true;
+#ifdef USE_GYRO_PID_INTERRUPT
+    if (gyro->spiDmaSampleFn) {
+        gyro->spiDmaSampleFn();
+    }
+#endif
+}
+
+FAST_CODE static bool mpuGyroReadSPIDma(gyroDev_t *gyro) {
+    if (gyro->spiDmaDataReady) {
+        gyro->spiDmaDataReady = false;
+        return true;
+    }
+    // no interrupt driven sample yet, or the last one is still queued behind another bus user
+    return gyro->spiDmaFallbackReadFn(gyro);
+}
+
+bool mpuGyroSpiDmaInit(gyroDev_t *gyro) {
+    if (gyro->bus.bustype != BUSTYPE_SPI || gyro->mpuIntExtiTag == IO_TAG_NONE || !gyro->gyroDataReg) {
+        return false;
+    }
+#ifdef USE_GYRO_FIFO_BATCH
+    if (gyro->fifoBatchSize > 1) {
+        return false;
+    }
+#endif
+    if (mpuSpiDmaGyroCount >= MPU_SPI_DMA_GYRO_COUNT || !spiBusDmaInit(&gyro->bus)) {
+        return false;
+    }
+    uint8_t *txBuf = mpuSpiDmaTxBuf[mpuSpiDmaGyroCount];
+    spiDmaJob_t *job = &mpuSpiDmaJob[mpuSpiDmaGyroCount];
+    job->bus = &gyro->bus;
+    job->txData = txBuf;
+    job->rxData = mpuSpiDmaRxBuf[mpuSpiDmaGyroCount];
+    job->callback = mpuGyroSpiDmaComplete;
+    job->callbackArg = (uint32_t)gyro;
+    job->priority = SPI_DMA_PRIORITY_GYRO;
+    mpuSpiDmaGyroCount++;
+    memset(txBuf, 0xFF, MPU_SPI_DMA_BUFFER_SIZE);
+#ifdef USE_GYRO_ACC_BURST
+    if (gyro->accBurst) {
+        job->length = gyro->accBurstLength;
+        txBuf[0] = gyro->accDataReg | 0x80;
+    } else
+#endif
+    {
+        job->length = GYRO_SPI_DMA_BUFFER_SIZE;
+        txBuf[0] = gyro->gyroDataReg | 0x80;
+    }
+    gyro->spiDmaJob = job;
+    gyro->spiDmaDataReady = false;
+    gyro->spiDmaFallbackReadFn = gyro->readFn;
+    gyro->readFn = mpuGyroReadSPIDma;
+    // last, the EXTI may fire at any time
+    gyro->useSpiDma = true;
+    return true;
+}
+#endif
+
 /*
  * Gyro interrupt service routine
  */
@@ -134,6 +294,15 @@ FAST_CODE static void mpuIntExtiHandler(extiCallbackRec_t *cb) {
     lastCalledAtUs = nowUs;
 #endif
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    gyro->dataReadyAtUs = microsISR();
+#endif
+#ifdef USE_GYRO_SPI_DMA
+    if (gyro->useSpiDma && spiBusQueueDma(gyro->spiDmaJob)) {
+        // dataReady is raised by the completion handler, the read waits its turn if the bus is busy
+        return;
+    }
+#endif
     gyro->dataReady = true;
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     const uint32_t now2Us = micros();
@@ -164,6 +333,7 @@ static void mpuIntExtiInit(gyroDev_t *gyro) {
     EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, EXTI_Trigger_Rising);
 #endif
     EXTIEnable(mpuIntIO, true);
+    gyro->dataReadyInterrupt = true;
 }
 #endif // MPU_INT_EXTI
 
@@ -180,6 +350,22 @@ bool mpuAccRead(accDev_t *acc) {
 }
 
 #ifdef USE_DMA_SPI_DEVICE
+#ifdef USE_GYRO_IMUF9001
+// The IMU-F clocks out a gyro frame while it clocks in our tx buffer, so the setpoint frame
+// stays in the buffer and rides along with every gyro transfer until a newer setpoint replaces it.
+static FAST_CODE void imufWriteSetpointFrame(void) {
+    imufCommand_t *command = (imufCommand_t *)dmaTxBuffer;
+    command->command = IMUF_COMMAND_SETPOINT;
+    command->param1  = getSetpointRateInt(0);
+    command->param2  = getSetpointRateInt(1);
+    command->param3  = getSetpointRateInt(2);
+    // the crc word sits past the end of the shorter streaming frames and is never sent, skip the calculation then
+    if (gyroConfig()->imuf_mode >= sizeof(imufCommand_t)) {
+        command->crc = getCrcImuf9001((uint32_t *)dmaTxBuffer, 11); //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
+    }
+}
+#endif
+
 FAST_CODE bool mpuGyroDmaSpiReadStart(gyroDev_t * gyro) {
     (void)(gyro); ///not used at this time
     //no reason not to get acc and gyro data at the same time
@@ -199,19 +385,15 @@ FAST_CODE bool mpuGyroDmaSpiReadStart(gyroDev_t * gyro) {
         (*(imufCommand_t *)(dmaTxBuffer)).command = 0;
         (*(imufCommand_t *)(dmaTxBuffer)).crc     = 0; //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
         imufEndCalibration();
+        isSetpointNew = 1; //put the setpoint frame back on the next transfer instead of waiting for the next rc frame
     } else {
         if (isSetpointNew) {
             //send setpoint and arm status
-            (*(imufCommand_t *)(dmaTxBuffer)).command = IMUF_COMMAND_SETPOINT;
-            (*(imufCommand_t *)(dmaTxBuffer)).param1  = getSetpointRateInt(0);
-            (*(imufCommand_t *)(dmaTxBuffer)).param2  = getSetpointRateInt(1);
-            (*(imufCommand_t *)(dmaTxBuffer)).param3  = getSetpointRateInt(2);
-            (*(imufCommand_t *)(dmaTxBuffer)).crc     = getCrcImuf9001((uint32_t *)dmaTxBuffer, 11); //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
+            imufWriteSetpointFrame();
             isSetpointNew = 0;
         }
     }
-    memset(dmaRxBuffer, 0, gyroConfig()->imuf_mode); //clear buffer
-    //send and receive data using SPI and DMA
+    //send and receive data using SPI and DMA, the rx buffer is overwritten in full and checked by crc so it is not cleared first
     dmaSpiTransmitReceive(dmaTxBuffer, dmaRxBuffer, gyroConfig()->imuf_mode, 0);
 #else
     dmaTxBuffer[0] = MPU_RA_ACCEL_XOUT_H | 0x80;
@@ -223,7 +405,7 @@ FAST_CODE bool mpuGyroDmaSpiReadStart(gyroDev_t * gyro) {
 FAST_CODE void mpuGyroDmaSpiReadFinish(gyroDev_t * gyro) {
     //spi rx dma callback
 #ifdef USE_GYRO_IMUF9001
-    memcpy(&imufData, dmaRxBuffer, sizeof(imufData_t));
+    memcpy(&imufData, dmaRxBuffer, sizeof(gyroFrame_t)); //only the gyro frame is clocked in, the rest of imufData is never used
     acc.dev.ADCRaw[X]    = (int16_t)(imufData.accX * acc.dev.acc_1G);
     acc.dev.ADCRaw[Y]    = (int16_t)(imufData.accY * acc.dev.acc_1G);
     acc.dev.ADCRaw[Z]    = (int16_t)(imufData.accZ * acc.dev.acc_1G);
@@ -425,7 +607,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro) {
 
 void mpuDetect(gyroDev_t *gyro) {
     // MPU datasheet specifies 30ms.
-    delay(35);
+    delaySincePowerOn(35);
 #if defined(USE_I2C) && !defined(USE_DMA_SPI_DEVICE)
     if (gyro->bus.bustype == BUSTYPE_NONE) {
         // if no bustype is selected try I2C first.
@@ -463,6 +645,8 @@ void mpuDetect(gyroDev_t *gyro) {
 }
 
 void mpuGyroInit(gyroDev_t *gyro) {
+    gyro->accDataReg = MPU_RA_ACCEL_XOUT_H;
+    gyro->gyroDataReg = MPU_RA_GYRO_XOUT_H;
 #ifdef MPU_INT_EXTI
     mpuIntExtiInit(gyro);
 #else
@@ -244,6 +244,15 @@ uint8_t mpuGyroReadRegister(const busDevice_t *bus, uint8_t reg);
 struct accDev_s;
 bool mpuAccRead(struct accDev_s *acc);
 
+#ifdef USE_GYRO_SPI_DMA
+bool mpuGyroSpiDmaInit(struct gyroDev_s *gyro);
+#endif
+
+#ifdef USE_GYRO_ACC_BURST
+bool mpuGyroAccBurstInit(struct gyroDev_s *gyro);
+bool mpuAccReadGyroBurst(struct accDev_s *acc);
+#endif
+
 #ifdef USE_DMA_SPI_DEVICE
 extern bool mpuGyroDmaSpiReadStart(struct gyroDev_s *gyro);
 extern void mpuGyroDmaSpiReadFinish(struct gyroDev_s *gyro);
@@ -64,7 +64,7 @@ static uint8_t mpu3050GetDLPF(uint8_t lpf) {
 }
 
 static void mpu3050Init(gyroDev_t *gyro) {
-    delay(25); // datasheet page 13 says 20ms. other stuff could have been running meanwhile. but we'll be safe
+    delaySincePowerOn(25); // datasheet page 13 says 20ms. other stuff could have been running meanwhile. but we'll be safe
     const bool ack = busWriteRegister(&gyro->bus, MPU3050_SMPLRT_DIV, 0);
     if (!ack) {
         failureMode(FAILURE_ACC_INIT);
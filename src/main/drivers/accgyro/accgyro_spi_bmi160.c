@@ -227,6 +227,7 @@ static void bmi160IntExtiInit(gyroDev_t *gyro) {
     EXTIHandlerInit(&gyro->exti, bmi160ExtiHandler);
     EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, EXTI_Trigger_Rising);
     EXTIEnable(mpuIntIO, true);
+    gyro->dataReadyInterrupt = true;
     bmi160ExtiInitDone = true;
 }
 
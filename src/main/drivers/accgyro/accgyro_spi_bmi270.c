@@ -25,6 +25,8 @@
 
 #ifdef USE_ACCGYRO_BMI270
 
+#include "common/maths.h"
+
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/accgyro/accgyro_spi_bmi270.h"
 #include "drivers/bus_spi.h"
@@ -140,6 +142,7 @@ typedef enum {
     BMI270_VAL_FIFO_CONFIG_0 = 0x00,         // don't stop when full, disable sensortime frame
     BMI270_VAL_FIFO_CONFIG_1 = 0x80,         // only gyro data in FIFO, use headerless mode
     BMI270_VAL_FIFO_DOWNS = 0x00,            // select unfiltered gyro data with no downsampling (6.4KHz samples)
+    BMI270_VAL_FIFO_DOWNS_FILTERED = 0x08,   // select filtered gyro data with no downsampling (3.2KHz samples)
     BMI270_VAL_FIFO_WTM_0 = 0x06,            // set the FIFO watermark level to 1 gyro sample (6 bytes)
     BMI270_VAL_FIFO_WTM_1 = 0x00,            // FIFO watermark MSB
 } bmi270ConfigValues_e;
@@ -226,10 +229,17 @@ static void bmi270Config(const gyroDev_t *gyro)
     // If running in hardware_lpf experimental mode then switch to FIFO-based,
     // 6.4KHz sampling, unfiltered data vs. the default 3.2KHz with hardware filtering
 #ifdef USE_GYRO_DLPF_EXPERIMENTAL
-    const bool fifoMode = (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL);
+    const bool experimentalMode = (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL);
+#else
+    const bool experimentalMode = false;
+#endif
+    // Batched reads drain several samples per watermark interrupt, the watermark is set to one batch
+#ifdef USE_GYRO_FIFO_BATCH
+    const uint16_t fifoWatermark = BMI270_FIFO_FRAME_SIZE * MAX(gyro->fifoBatchSize, 1);
 #else
-    const bool fifoMode = false;
+    const uint16_t fifoWatermark = BMI270_FIFO_FRAME_SIZE;
 #endif
+    const bool fifoMode = experimentalMode || (fifoWatermark > BMI270_FIFO_FRAME_SIZE);
 
     // Perform a soft reset to set all configuration to default
     // Delay 100ms before continuing configuration
@@ -244,9 +254,9 @@ static void bmi270Config(const gyroDev_t *gyro)
     if (fifoMode) {
         bmi270RegisterWrite(bus, BMI270_REG_FIFO_CONFIG_0, BMI270_VAL_FIFO_CONFIG_0, 1);
         bmi270RegisterWrite(bus, BMI270_REG_FIFO_CONFIG_1, BMI270_VAL_FIFO_CONFIG_1, 1);
-        bmi270RegisterWrite(bus, BMI270_REG_FIFO_DOWNS, BMI270_VAL_FIFO_DOWNS, 1);
-        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_0, BMI270_VAL_FIFO_WTM_0, 1);
-        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_1, BMI270_VAL_FIFO_WTM_1, 1);
+        bmi270RegisterWrite(bus, BMI270_REG_FIFO_DOWNS, experimentalMode ? BMI270_VAL_FIFO_DOWNS : BMI270_VAL_FIFO_DOWNS_FILTERED, 1);
+        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_0, fifoWatermark & 0xFF, 1);
+        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_1, fifoWatermark >> 8, 1);
     }
 
     // Configure the accelerometer
@@ -306,6 +316,7 @@ static void bmi270IntExtiInit(gyroDev_t *gyro)
     EXTIHandlerInit(&gyro->exti, bmi270ExtiHandler);
     EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, IOCFG_IN_FLOATING );
     EXTIEnable(mpuIntIO, true);
+    gyro->dataReadyInterrupt = true;
 }
 #endif
 
@@ -430,8 +441,72 @@ static bool bmi270GyroReadFifo(gyroDev_t *gyro)
 }
 #endif
 
+#ifdef USE_GYRO_FIFO_BATCH
+static bool bmi270GyroReadFifoBatch(gyroDev_t *gyro)
+{
+    enum {
+        IDX_REG = 0,
+        IDX_SKIP,
+        IDX_FIFO_LENGTH_L,
+        IDX_FIFO_LENGTH_H,
+        IDX_FIFO_DATA,
+        BUFFER_SIZE = IDX_FIFO_DATA + GYRO_FIFO_BATCH_MAX * BMI270_FIFO_FRAME_SIZE,
+    };
+
+    static const uint8_t bmi270_tx_buf[BUFFER_SIZE] = {BMI270_REG_FIFO_LENGTH_LSB | 0x80};
+    uint8_t bmi270_rx_buf[BUFFER_SIZE];
+
+    // Burst read the FIFO length followed by up to GYRO_FIFO_BATCH_MAX frames. FIFO_DATA does
+    // not auto increment so the whole batch comes out of a single transaction; frames beyond
+    // the fill level read back as 0x8000 and are discarded below.
+    IOLo(gyro->bus.busdev_u.spi.csnPin);
+    spiTransfer(gyro->bus.busdev_u.spi.instance, bmi270_tx_buf, bmi270_rx_buf, BUFFER_SIZE);   // receive response
+    IOHi(gyro->bus.busdev_u.spi.csnPin);
+
+    const int fifoLength = (uint16_t)((bmi270_rx_buf[IDX_FIFO_LENGTH_H] << 8) | bmi270_rx_buf[IDX_FIFO_LENGTH_L]);
+    const int frames = MIN(fifoLength / BMI270_FIFO_FRAME_SIZE, GYRO_FIFO_BATCH_MAX);
+
+    gyro->fifoSampleCount = 0;
+    for (int i = 0; i < frames; i++) {
+        const uint8_t *frame = &bmi270_rx_buf[IDX_FIFO_DATA + i * BMI270_FIFO_FRAME_SIZE];
+        const int16_t gyroX = (int16_t)((frame[1] << 8) | frame[0]);
+        const int16_t gyroY = (int16_t)((frame[3] << 8) | frame[2]);
+        const int16_t gyroZ = (int16_t)((frame[5] << 8) | frame[4]);
+        if ((gyroX == INT16_MIN) && (gyroY == INT16_MIN) && (gyroZ == INT16_MIN)) {
+            continue;
+        }
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][X] = gyroX;
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][Y] = gyroY;
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][Z] = gyroZ;
+        gyro->fifoSampleCount++;
+    }
+
+    // Whole frames left behind are picked up by the next read, but a partial frame would
+    // never be removed from the queue so flush in that case (see bmi270GyroReadFifo).
+    if (fifoLength % BMI270_FIFO_FRAME_SIZE) {
+        bmi270RegisterWrite(&gyro->bus, BMI270_REG_CMD, BMI270_VAL_CMD_FIFOFLUSH, 0);
+    }
+
+    if (gyro->fifoSampleCount == 0) {
+        return false;
+    }
+
+    gyro->gyroADCRaw[X] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][Z];
+
+    return true;
+}
+#endif
+
 static bool bmi270GyroRead(gyroDev_t *gyro)
 {
+#ifdef USE_GYRO_FIFO_BATCH
+    if (gyro->fifoBatchSize > 1) {
+        // running in batched FIFO mode
+        return bmi270GyroReadFifoBatch(gyro);
+    }
+#endif
 #ifdef USE_GYRO_DLPF_EXPERIMENTAL
     if (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL) {
         // running in 6.4KHz FIFO mode
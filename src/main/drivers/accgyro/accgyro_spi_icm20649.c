@@ -105,6 +105,8 @@ bool icm20649SpiAccDetect(accDev_t *acc) {
 
 void icm20649GyroInit(gyroDev_t *gyro) {
     mpuGyroInit(gyro);
+    gyro->accDataReg = ICM20649_RA_ACCEL_XOUT_H;
+    gyro->gyroDataReg = ICM20649_RA_GYRO_XOUT_H;
     spiSetDivisor(gyro->bus.busdev_u.spi.instance, SPI_CLOCK_STANDARD); // ensure proper speed
     spiBusWriteRegister(&gyro->bus, ICM20649_RA_REG_BANK_SEL, 0 << 4); // select bank 0 just to be safe
     delay(15);
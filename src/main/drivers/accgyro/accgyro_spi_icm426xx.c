@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -105,6 +106,25 @@
 #define ICM426XX_RA_INT_SOURCE0                     0x65  // User Bank 0
 #define ICM426XX_UI_DRDY_INT1_EN_DISABLED           (0 << 3)
 #define ICM426XX_UI_DRDY_INT1_EN_ENABLED            (1 << 3)
+#define ICM426XX_FIFO_THS_INT1_EN_ENABLED           (1 << 2)
+
+// --- Registers for the gyro FIFO --------------------------
+#define ICM426XX_RA_FIFO_CONFIG                     0x16  // User Bank 0
+#define ICM426XX_FIFO_MODE_BYPASS                   (0 << 6)
+#define ICM426XX_FIFO_MODE_STREAM                   (1 << 6)
+#define ICM426XX_RA_FIFO_COUNTH                     0x2E  // User Bank 0
+#define ICM426XX_RA_FIFO_DATA                       0x30  // User Bank 0
+#define ICM426XX_RA_SIGNAL_PATH_RESET               0x4B  // User Bank 0
+#define ICM426XX_FIFO_FLUSH                         (1 << 1)
+#define ICM426XX_RA_INTF_CONFIG0                    0x4C  // User Bank 0
+#define ICM426XX_FIFO_COUNT_REC                     (1 << 6)  // FIFO count and watermark in records instead of bytes
+#define ICM426XX_RA_FIFO_CONFIG1                    0x5F  // User Bank 0
+#define ICM426XX_FIFO_GYRO_EN                       (1 << 1)
+#define ICM426XX_RA_FIFO_CONFIG2                    0x60  // User Bank 0, watermark [7:0]
+#define ICM426XX_RA_FIFO_CONFIG3                    0x61  // User Bank 0, watermark [11:8]
+#define ICM426XX_FIFO_HEADER_MSG                    (1 << 7)  // set when the FIFO is empty
+#define ICM426XX_FIFO_HEADER_GYRO                   (1 << 5)
+#define ICM426XX_FIFO_PACKET_SIZE                   8     // gyro only packet: header, gyro x/y/z, temperature
 
 typedef enum {
     ODR_CONFIG_8K = 0,
@@ -232,6 +252,9 @@ bool icm426xxSpiAccDetect(accDev_t *acc) {
 }
 
 static aafConfig_t getGyroAafConfig(const mpuSensor_e, const aafConfig_e);
+#ifdef USE_GYRO_FIFO_BATCH
+static bool icm426xxGyroReadFifo(gyroDev_t *gyro);
+#endif
 
 static void turnGyroAccOff(const gyroDev_t *gyro)
 {
@@ -287,7 +310,18 @@ void icm426xxGyroInit(gyroDev_t *gyro)
     spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INT_CONFIG, ICM426XX_INT1_MODE_PULSED | ICM426XX_INT1_DRIVE_CIRCUIT_PP | ICM426XX_INT1_POLARITY_ACTIVE_HIGH);
     spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INT_CONFIG0, ICM426XX_UI_DRDY_INT_CLEAR_ON_SBR);
 
-    spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INT_SOURCE0, ICM426XX_UI_DRDY_INT1_EN_ENABLED);
+#ifdef USE_GYRO_FIFO_BATCH
+    const bool fifoMode = (gyro->fifoBatchSize > 1);
+#else
+    const bool fifoMode = false;
+#endif
+    if (fifoMode) {
+        // Interrupt driven by FIFO watermark level
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INT_SOURCE0, ICM426XX_FIFO_THS_INT1_EN_ENABLED);
+    } else {
+        // Interrupt driven by data ready
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INT_SOURCE0, ICM426XX_UI_DRDY_INT1_EN_ENABLED);
+    }
 
     uint8_t intConfig1Value = spiBusReadRegister(&gyro->bus, ICM426XX_RA_INT_CONFIG1);
     // Datasheet says: "User should change setting to 0 from default setting of 1, for proper INT1 and INT2 pin operation"
@@ -323,6 +357,22 @@ void icm426xxGyroInit(gyroDev_t *gyro)
     STATIC_ASSERT(INV_FSR_16G == 3, INV_FSR_16G_must_be_3_to_generate_correct_value);
     spiBusWriteRegister(&gyro->bus, ICM426XX_RA_ACCEL_CONFIG0, (3 - INV_FSR_16G) << 5 | (odrConfig & 0x0F));
     delay(15);
+
+#ifdef USE_GYRO_FIFO_BATCH
+    // Configure the FIFO, gyro only packets in stream mode with the watermark set to one batch
+    if (fifoMode) {
+        uint8_t intfConfig0Value = spiBusReadRegister(&gyro->bus, ICM426XX_RA_INTF_CONFIG0);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_INTF_CONFIG0, intfConfig0Value | ICM426XX_FIFO_COUNT_REC);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_FIFO_CONFIG1, ICM426XX_FIFO_GYRO_EN);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_FIFO_CONFIG2, gyro->fifoBatchSize);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_FIFO_CONFIG3, 0);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_FIFO_CONFIG, ICM426XX_FIFO_MODE_STREAM);
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_SIGNAL_PATH_RESET, ICM426XX_FIFO_FLUSH);
+        gyro->readFn = icm426xxGyroReadFifo;
+    } else {
+        spiBusWriteRegister(&gyro->bus, ICM426XX_RA_FIFO_CONFIG, ICM426XX_FIFO_MODE_BYPASS);
+    }
+#endif
 }
 
 // MIGHT NOT work on STM32F7
@@ -347,6 +397,73 @@ bool icm426xxGyroReadSPI(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_FIFO_BATCH
+// Drains up to GYRO_FIFO_BATCH_MAX packets in a single burst so samples queued
+// behind a late gyro task are filtered instead of dropped.
+static bool icm426xxGyroReadFifo(gyroDev_t *gyro)
+{
+    enum {
+        IDX_REG = 0,
+        IDX_COUNT_H,
+        IDX_COUNT_L,
+        COUNT_BUFFER_SIZE,
+    };
+
+    STATIC_DMA_DATA_AUTO uint8_t countToSend[COUNT_BUFFER_SIZE] = {ICM426XX_RA_FIFO_COUNTH | 0x80, 0xFF, 0xFF};
+    STATIC_DMA_DATA_AUTO uint8_t count[COUNT_BUFFER_SIZE];
+    STATIC_DMA_DATA_AUTO uint8_t dataToSend[1 + GYRO_FIFO_BATCH_MAX * ICM426XX_FIFO_PACKET_SIZE];
+    STATIC_DMA_DATA_AUTO uint8_t data[1 + GYRO_FIFO_BATCH_MAX * ICM426XX_FIFO_PACKET_SIZE];
+
+    gyro->fifoSampleCount = 0;
+
+    if (!spiBusTransfer(&gyro->bus, countToSend, count, COUNT_BUFFER_SIZE)) {
+        return false;
+    }
+
+    // FIFO_COUNT_REC is set, so the count is in packets
+    const int packets = MIN((count[IDX_COUNT_H] << 8) | count[IDX_COUNT_L], GYRO_FIFO_BATCH_MAX);
+    if (packets == 0) {
+        return false;
+    }
+
+    const int length = 1 + packets * ICM426XX_FIFO_PACKET_SIZE;
+    memset(dataToSend, 0xFF, length);
+    dataToSend[0] = ICM426XX_RA_FIFO_DATA | 0x80;
+    if (!spiBusTransfer(&gyro->bus, dataToSend, data, length)) {
+        return false;
+    }
+
+    for (int i = 0; i < packets; i++) {
+        const uint8_t *packet = &data[1 + i * ICM426XX_FIFO_PACKET_SIZE];
+        if ((packet[0] & ICM426XX_FIFO_HEADER_MSG) || !(packet[0] & ICM426XX_FIFO_HEADER_GYRO)) {
+            continue;
+        }
+        const int16_t gyroX = (int16_t)((packet[1] << 8) | packet[2]);
+        const int16_t gyroY = (int16_t)((packet[3] << 8) | packet[4]);
+        const int16_t gyroZ = (int16_t)((packet[5] << 8) | packet[6]);
+        // invalid samples read back as -32768 on all axes
+        if ((gyroX == INT16_MIN) && (gyroY == INT16_MIN) && (gyroZ == INT16_MIN)) {
+            continue;
+        }
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][X] = gyroX;
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][Y] = gyroY;
+        gyro->gyroADCRawFifo[gyro->fifoSampleCount][Z] = gyroZ;
+        gyro->fifoSampleCount++;
+    }
+
+    if (gyro->fifoSampleCount == 0) {
+        return false;
+    }
+
+    // keep the register view pointing at the newest sample
+    gyro->gyroADCRaw[X] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->gyroADCRawFifo[gyro->fifoSampleCount - 1][Z];
+
+    return true;
+}
+#endif
+
 bool icm426xxSpiGyroDetect(gyroDev_t *gyro) {
     switch (gyro->mpuDetectionResult.sensor) {
     case ICM_42605_SPI:
@@ -40,11 +40,8 @@
 
 adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
 
-#if defined(STM32F7)
-volatile FAST_RAM_ZERO_INIT uint16_t adcValues[ADC_CHANNEL_COUNT];
-#else
-volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
-#endif
+volatile DMA_RAM uint16_t adcValues[ADC_OVERSAMPLE_COUNT * ADC_CHANNEL_COUNT];
+uint8_t adcScanLength;      // channels per scan, the stride of the DMA ring
 
 #ifdef USE_ADC_INTERNAL
 uint16_t adcTSCAL1;
@@ -96,7 +93,12 @@ uint16_t adcGetChannel(uint8_t channel) {
         debug[3] = adcValues[adcOperatingConfig[3].dmaIndex];
     }
 #endif
-    return adcValues[adcOperatingConfig[channel].dmaIndex];
+    // decimate the ring on read, so the value is as fresh as the last scan and costs nothing until someone asks
+    uint32_t sum = 0;
+    for (int i = 0; i < ADC_OVERSAMPLE_COUNT; i++) {
+        sum += adcValues[i * adcScanLength + adcOperatingConfig[channel].dmaIndex];
+    }
+    return (sum + ADC_OVERSAMPLE_COUNT / 2) / ADC_OVERSAMPLE_COUNT;
 }
 
 // Verify a pin designated by tag has connection to an ADC instance designated by device
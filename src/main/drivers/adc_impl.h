@@ -32,6 +32,13 @@
 #define ADC_TAG_MAP_COUNT 10
 #endif
 
+#if defined(STM32F4) || defined(STM32F7)
+// scans the DMA keeps in its ring, averaged when a channel is read; these ADCs have no hardware oversampler
+#define ADC_OVERSAMPLE_COUNT 16
+#else
+#define ADC_OVERSAMPLE_COUNT 1
+#endif
+
 typedef struct adcTagMap_s {
     ioTag_t tag;
 #if !defined(STM32F1) // F1 pins have uniform connection to ADC instances
@@ -68,7 +75,8 @@ typedef struct adcDevice_s {
 extern const adcDevice_t adcHardware[];
 extern const adcTagMap_t adcTagMap[ADC_TAG_MAP_COUNT];
 extern adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
-extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
+extern volatile uint16_t adcValues[ADC_OVERSAMPLE_COUNT * ADC_CHANNEL_COUNT];
+extern uint8_t adcScanLength;
 
 uint8_t adcChannelByTag(ioTag_t ioTag);
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
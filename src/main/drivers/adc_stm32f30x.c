@@ -141,6 +141,7 @@ void adcInit(const adcConfig_t *config) {
         RCC_ADCCLKConfig(RCC_ADC34PLLCLK_Div256);  // 72 MHz divided by 256 = 281.25 kHz
     }
     RCC_ClockCmd(adc.rccADC, ENABLE);
+    adcScanLength = adcChannelCount;
     dmaInit(dmaGetIdentifier(adc.DMAy_Channelx), OWNER_ADC, 0);
     DMA_DeInit(adc.DMAy_Channelx);
     DMA_StructInit(&DMA_InitStructure);
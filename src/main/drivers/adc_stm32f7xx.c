@@ -263,11 +263,12 @@ void adcInit(const adcConfig_t *config) {
             /* Channel Configuration Error */
         }
     }
+    adcScanLength = configuredAdcChannels;
     dmaInit(dmaGetIdentifier(adc.DMAy_Streamx), OWNER_ADC, 0);
     adc.DmaHandle.Init.Channel = adc.channel;
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
-    adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    adc.DmaHandle.Init.MemInc = DMA_MINC_ENABLE;
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -282,7 +283,7 @@ void adcInit(const adcConfig_t *config) {
     }
     __HAL_LINKDMA(&adc.ADCHandle, DMA_Handle, adc.DmaHandle);
     //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK) {
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels * ADC_OVERSAMPLE_COUNT) != HAL_OK) {
         /* Start Conversation Error */
     }
 }
@@ -25,6 +25,7 @@
 struct baroDev_s;
 
 typedef void (*baroOpFuncPtr)(struct baroDev_s *baro);                       // baro start operation
+typedef bool (*baroReadFuncPtr)(struct baroDev_s *baro);                     // baro non blocking result read, false if it could not be started
 typedef void (*baroCalculateFuncPtr)(int32_t *pressure, int32_t *temperature); // baro calculation (filled params are pressure and temperature)
 
 typedef struct baroDev_s {
@@ -35,6 +36,8 @@ typedef struct baroDev_s {
     baroOpFuncPtr get_ut;
     baroOpFuncPtr start_up;
     baroOpFuncPtr get_up;
+    baroReadFuncPtr read_ut;    // optional, get_ut then only decodes the data read
+    baroReadFuncPtr read_up;    // optional, get_up then only decodes the data read
     baroCalculateFuncPtr calculate;
 } baroDev_t;
 
@@ -179,7 +179,7 @@ bool bmp085Detect(const bmp085Config_t *config, baroDev_t *baro) {
 #else
     UNUSED(config);
 #endif
-    delay(20); // datasheet says 10ms, we'll be careful and do 20.
+    delaySincePowerOn(20); // datasheet says 10ms, we'll be careful and do 20.
     busDevice_t *busdev = &baro->busdev;
     if ((busdev->bustype == BUSTYPE_I2C) && (busdev->busdev_u.i2c.address == 0)) {
         // Default address for BMP085
@@ -65,6 +65,7 @@ static void bmp280_start_ut(baroDev_t *baro);
 static void bmp280_get_ut(baroDev_t *baro);
 static void bmp280_start_up(baroDev_t *baro);
 static void bmp280_get_up(baroDev_t *baro);
+static bool bmp280_read_up(baroDev_t *baro);
 
 STATIC_UNIT_TESTED void bmp280_calculate(int32_t *pressure, int32_t *temperature);
 
@@ -92,7 +93,7 @@ void bmp280BusDeinit(busDevice_t *busdev) {
 }
 
 bool bmp280Detect(baroDev_t *baro) {
-    delay(20);
+    delaySincePowerOn(20);
     busDevice_t *busdev = &baro->busdev;
     bool defaultAddressApplied = false;
     bmp280BusInit(busdev);
@@ -120,6 +121,7 @@ bool bmp280Detect(baroDev_t *baro) {
     // only _up part is executed, and gets both temperature and pressure
     baro->start_up = bmp280_start_up;
     baro->get_up = bmp280_get_up;
+    baro->read_up = bmp280_read_up;
     baro->up_delay = ((T_INIT_MAX + T_MEASURE_PER_OSRS_MAX * (((1 << BMP280_TEMPERATURE_OSR) >> 1) + ((1 << BMP280_PRESSURE_OSR) >> 1)) + (BMP280_PRESSURE_OSR ? T_SETUP_PRESSURE_MAX : 0) + 15) / 16) * 1000;
     baro->calculate = bmp280_calculate;
     return true;
@@ -138,13 +140,19 @@ static void bmp280_get_ut(baroDev_t *baro) {
 static void bmp280_start_up(baroDev_t *baro) {
     // start measurement
     // set oversampling + power mode (forced), and start sampling
-    busWriteRegister(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE);
+    busWriteRegisterStart(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE);
 }
 
-static void bmp280_get_up(baroDev_t *baro) {
-    uint8_t data[BMP280_DATA_FRAME_SIZE];
+static uint8_t bmp280_data[BMP280_DATA_FRAME_SIZE];
+
+static bool bmp280_read_up(baroDev_t *baro) {
     // read data from sensor
-    busReadRegisterBuffer(&baro->busdev, BMP280_PRESSURE_MSB_REG, data, BMP280_DATA_FRAME_SIZE);
+    return busReadRegisterBufferStart(&baro->busdev, BMP280_PRESSURE_MSB_REG, bmp280_data, BMP280_DATA_FRAME_SIZE);
+}
+
+static void bmp280_get_up(baroDev_t *baro) {
+    UNUSED(baro);
+    const uint8_t *data = bmp280_data;
     bmp280_up = (int32_t)((((uint32_t)(data[0])) << 12) | (((uint32_t)(data[1])) << 4) | ((uint32_t)data[2] >> 4));
     bmp280_ut = (int32_t)((((uint32_t)(data[3])) << 12) | (((uint32_t)(data[4])) << 4) | ((uint32_t)data[5] >> 4));
 }
@@ -163,12 +171,14 @@ static int32_t bmp280_compensate_T(int32_t adc_T) {
 // Returns pressure in Pa as unsigned 32 bit integer in Q24.8 format (24 integer bits and 8 fractional bits).
 // Output value of "24674867" represents 24674867/256 = 96386.2 Pa = 963.862 hPa
 static uint32_t bmp280_compensate_P(int32_t adc_P) {
+    // t_fine - 128000 fits 32 bits, square it once with a 32x32->64 multiply
+    const int32_t dt = bmp280_cal.t_fine - 128000;
+    const int64_t dt2 = (int64_t)dt * dt;
     int64_t var1, var2, p;
-    var1 = ((int64_t)bmp280_cal.t_fine) - 128000;
-    var2 = var1 * var1 * (int64_t)bmp280_cal.dig_P6;
-    var2 = var2 + ((var1 * (int64_t)bmp280_cal.dig_P5) << 17);
+    var2 = dt2 * bmp280_cal.dig_P6;
+    var2 = var2 + (((int64_t)dt * bmp280_cal.dig_P5) << 17);
     var2 = var2 + (((int64_t)bmp280_cal.dig_P4) << 35);
-    var1 = ((var1 * var1 * (int64_t)bmp280_cal.dig_P3) >> 8) + ((var1 * (int64_t)bmp280_cal.dig_P2) << 12);
+    var1 = ((dt2 * bmp280_cal.dig_P3) >> 8) + (((int64_t)dt * bmp280_cal.dig_P2) << 12);
     var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)bmp280_cal.dig_P1) >> 33;
     if (var1 == 0)
         return 0;
@@ -27,6 +27,8 @@
 
 #include "build/build_config.h"
 
+#include "common/utils.h"
+
 #include "barometer.h"
 #include "barometer_ms5611.h"
 
@@ -52,7 +54,8 @@
 static void ms5611_reset(busDevice_t *busdev);
 static uint16_t ms5611_prom(busDevice_t *busdev, int8_t coef_num);
 STATIC_UNIT_TESTED int8_t ms5611_crc(uint16_t *prom);
-static uint32_t ms5611_read_adc(busDevice_t *busdev);
+static bool ms5611_read_adc(baroDev_t *baro);
+static uint32_t ms5611_adc_value(void);
 static void ms5611_start_ut(baroDev_t *baro);
 static void ms5611_get_ut(baroDev_t *baro);
 static void ms5611_start_up(baroDev_t *baro);
@@ -91,7 +94,7 @@ bool ms5611Detect(baroDev_t *baro) {
     uint8_t sig;
     int i;
     bool defaultAddressApplied = false;
-    delay(10); // No idea how long the chip takes to power-up, but let's make it 10ms
+    delaySincePowerOn(10); // No idea how long the chip takes to power-up, but let's make it 10ms
     busDevice_t *busdev = &baro->busdev;
     ms5611BusInit(busdev);
     if ((busdev->bustype == BUSTYPE_I2C) && (busdev->busdev_u.i2c.address == 0)) {
@@ -117,6 +120,8 @@ bool ms5611Detect(baroDev_t *baro) {
     baro->get_ut = ms5611_get_ut;
     baro->start_up = ms5611_start_up;
     baro->get_up = ms5611_get_up;
+    baro->read_ut = ms5611_read_adc;
+    baro->read_up = ms5611_read_adc;
     baro->calculate = ms5611_calculate;
     return true;
 fail:
@@ -165,38 +170,42 @@ STATIC_UNIT_TESTED int8_t ms5611_crc(uint16_t *prom) {
     return -1;
 }
 
-static uint32_t ms5611_read_adc(busDevice_t *busdev) {
-    uint8_t rxbuf[3];
-    busReadRegisterBuffer(busdev, CMD_ADC_READ, rxbuf, 3); // read ADC
-    return (rxbuf[0] << 16) | (rxbuf[1] << 8) | rxbuf[2];
+static uint8_t ms5611_adc_buf[3];
+
+static bool ms5611_read_adc(baroDev_t *baro) {
+    return busReadRegisterBufferStart(&baro->busdev, CMD_ADC_READ, ms5611_adc_buf, 3); // read ADC
+}
+
+static uint32_t ms5611_adc_value(void) {
+    return (ms5611_adc_buf[0] << 16) | (ms5611_adc_buf[1] << 8) | ms5611_adc_buf[2];
 }
 
 static void ms5611_start_ut(baroDev_t *baro) {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
+    busWriteRegisterStart(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
 }
 
 static void ms5611_get_ut(baroDev_t *baro) {
-    ms5611_ut = ms5611_read_adc(&baro->busdev);
+    UNUSED(baro);
+    ms5611_ut = ms5611_adc_value();
 }
 
 static void ms5611_start_up(baroDev_t *baro) {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
+    busWriteRegisterStart(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
 }
 
 static void ms5611_get_up(baroDev_t *baro) {
-    ms5611_up = ms5611_read_adc(&baro->busdev);
+    UNUSED(baro);
+    ms5611_up = ms5611_adc_value();
 }
 
+// dT and the temperature fit 32 bits, so most products are 32x32->64 multiplies instead of full 64 bit ones
 STATIC_UNIT_TESTED void ms5611_calculate(int32_t *pressure, int32_t *temperature) {
-    uint32_t press;
-    int64_t temp;
-    int64_t delt;
-    int64_t dT = (int64_t)ms5611_ut - ((uint64_t)ms5611_c[5] * 256);
+    const int32_t dT = (int32_t)ms5611_ut - ((int32_t)ms5611_c[5] << 8);
     int64_t off = ((int64_t)ms5611_c[2] << 16) + (((int64_t)ms5611_c[4] * dT) >> 7);
     int64_t sens = ((int64_t)ms5611_c[1] << 15) + (((int64_t)ms5611_c[3] * dT) >> 8);
-    temp = 2000 + ((dT * (int64_t)ms5611_c[6]) >> 23);
+    int32_t temp = 2000 + (int32_t)(((int64_t)dT * ms5611_c[6]) >> 23);
     if (temp < 2000) { // temperature lower than 20degC
-        delt = temp - 2000;
+        int64_t delt = temp - 2000;
         delt = 5 * delt * delt;
         off -= delt >> 1;
         sens -= delt >> 2;
@@ -206,9 +215,9 @@ STATIC_UNIT_TESTED void ms5611_calculate(int32_t *pressure, int32_t *temperature
             off -= 7 * delt;
             sens -= (11 * delt) >> 1;
         }
-        temp -= ((dT * dT) >> 31);
+        temp -= (int32_t)(((int64_t)dT * dT) >> 31);
     }
-    press = ((((int64_t)ms5611_up * sens) >> 21) - off) >> 15;
+    const uint32_t press = ((((int64_t)ms5611_up * sens) >> 21) - off) >> 15;
     if (pressure)
         *pressure = press;
     if (temperature)
@@ -138,7 +138,7 @@ bool qmp6988Detect(baroDev_t *baro) {
     int Coe_bp3_;
     uint16_t lb = 0, hb = 0;
     uint32_t lw = 0, hw = 0, temp1, temp2;
-    delay(20);
+    delaySincePowerOn(20);
     busDevice_t *busdev = &baro->busdev;
     bool defaultAddressApplied = false;
     qmp6988BusInit(busdev);
@@ -91,3 +91,35 @@ uint8_t busReadRegister(const busDevice_t *busdev, uint8_t reg) {
 #endif
 #endif
 }
+
+bool busWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data) {
+#ifdef USE_I2C
+    if (busdev->bustype == BUSTYPE_I2C) {
+        return i2cBusWriteRegisterStart(busdev, reg, data);
+    }
+#endif
+    return busWriteRegister(busdev, reg, data);
+}
+
+bool busReadRegisterBufferStart(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length) {
+#ifdef USE_I2C
+    if (busdev->bustype == BUSTYPE_I2C) {
+        return i2cBusReadRegisterBufferStart(busdev, reg, data, length);
+    }
+#endif
+    return busReadRegisterBuffer(busdev, reg, data, length);
+}
+
+bool busBusy(const busDevice_t *busdev, bool *error) {
+#ifdef USE_I2C
+    if (busdev->bustype == BUSTYPE_I2C) {
+        return i2cBusBusy(busdev, error);
+    }
+#else
+    UNUSED(busdev);
+#endif
+    if (error) {
+        *error = false;
+    }
+    return false;
+}
@@ -64,3 +64,9 @@ void targetBusInit(void);
 bool busWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data);
 bool busReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
 uint8_t busReadRegister(const busDevice_t *bus, uint8_t reg);
+
+// Non blocking on I2C, other buses complete the transfer before returning. The read
+// buffer has to stay valid until busBusy() returns false.
+bool busWriteRegisterStart(const busDevice_t *bus, uint8_t reg, uint8_t data);
+bool busReadRegisterBufferStart(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
+bool busBusy(const busDevice_t *bus, bool *error);
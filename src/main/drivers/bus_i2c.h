@@ -62,4 +62,11 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
 bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data);
 bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
 
+// Non blocking, false when a transfer is already running on the device. The buffer has
+// to stay valid until i2cBusy() returns false, which also ends transfers that time out.
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *buf);
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data);
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *data);
+bool i2cBusy(I2CDevice device, bool *error);
+
 uint16_t i2cGetErrorCounter(void);
@@ -26,6 +26,8 @@
 
 #if defined(USE_I2C) && !defined(SOFT_I2C)
 
+#include "common/time.h"
+
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
 #include "drivers/nvic.h"
@@ -162,6 +164,8 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
     if (!pHandle->Instance) {
         return false;
     }
+    // a transfer from i2cReadStart() / i2cWriteStart() may still own the peripheral
+    while (i2cBusy(device, NULL)) {; }
     HAL_StatusTypeDef status;
     if (reg_ == 0xFF)
         status = HAL_I2C_Master_Transmit(pHandle, addr_ << 1, data, len_, I2C_DEFAULT_TIMEOUT);
@@ -184,6 +188,7 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
     if (!pHandle->Instance) {
         return false;
     }
+    while (i2cBusy(device, NULL)) {; }
     HAL_StatusTypeDef status;
     if (reg_ == 0xFF)
         status = HAL_I2C_Master_Receive(pHandle, addr_ << 1, buf, len, I2C_DEFAULT_TIMEOUT);
@@ -194,6 +199,83 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
     return true;
 }
 
+static bool i2cStartAsync(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf, bool reading) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return false;
+    }
+    i2cDevice_t *pDev = &i2cDevice[device];
+    I2C_HandleTypeDef *pHandle = &pDev->handle;
+    if (!pHandle->Instance || HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY) {
+        return false;
+    }
+    // the HAL interrupt handlers run the transfer, HAL_I2C_GetState() tells when it's done
+    HAL_StatusTypeDef status;
+    if (reading) {
+        if (reg_ == 0xFF)
+            status = HAL_I2C_Master_Receive_IT(pHandle, addr_ << 1, buf, len);
+        else
+            status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, buf, len);
+    } else {
+        if (reg_ == 0xFF)
+            status = HAL_I2C_Master_Transmit_IT(pHandle, addr_ << 1, buf, len);
+        else
+            status = HAL_I2C_Mem_Write_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, buf, len);
+    }
+    if (status != HAL_OK) {
+        pDev->asyncError = true;
+        return i2cHandleHardwareFailure(device);
+    }
+    pDev->asyncError = false;
+    pDev->asyncStartedAtUs = micros();
+    pDev->asyncPending = true;
+    return true;
+}
+
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf) {
+    return i2cStartAsync(device, addr_, reg_, len, buf, true);
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT || i2cDevice[device].asyncPending) {
+        return false;
+    }
+    i2cDevice[device].asyncWriteData = data;
+    return i2cStartAsync(device, addr_, reg_, 1, &i2cDevice[device].asyncWriteData, false);
+}
+
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *data) {
+    return i2cStartAsync(device, addr_, reg_, len, data, false);
+}
+
+bool i2cBusy(I2CDevice device, bool *error) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        if (error) {
+            *error = true;
+        }
+        return false;
+    }
+    i2cDevice_t *pDev = &i2cDevice[device];
+    if (pDev->asyncPending) {
+        I2C_HandleTypeDef *pHandle = &pDev->handle;
+        if (HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY) {
+            if (cmpTimeUs(micros(), pDev->asyncStartedAtUs) < I2C_ASYNC_TIMEOUT_US) {
+                return true;
+            }
+            // stuck, start over with a reset peripheral rather than let the caller wait forever
+            i2cHandleHardwareFailure(device);
+            i2cInit(device);
+            pDev->asyncError = true;
+        } else {
+            pDev->asyncError = pHandle->ErrorCode != HAL_I2C_ERROR_NONE;
+        }
+        pDev->asyncPending = false;
+    }
+    if (error) {
+        *error = pDev->asyncError;
+    }
+    return false;
+}
+
 void i2cInit(I2CDevice device) {
     if (device == I2CINVALID) {
         return;
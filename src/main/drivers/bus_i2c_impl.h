@@ -28,6 +28,7 @@
 #define I2C_SHORT_TIMEOUT            ((uint32_t)0x1000)
 #define I2C_LONG_TIMEOUT             ((uint32_t)(10 * I2C_SHORT_TIMEOUT))
 #define I2C_DEFAULT_TIMEOUT          I2C_SHORT_TIMEOUT
+#define I2C_ASYNC_TIMEOUT_US         5000       // longest 255 byte read at 400kHz plus clock stretching
 
 #define I2C_PIN_SEL_MAX 4
 
@@ -85,6 +86,10 @@ typedef struct i2cDevice_s {
 #endif
     bool overClock;
     bool pullUp;
+    uint32_t asyncStartedAtUs;              // a transfer from i2cReadStart() / i2cWriteStart() is running
+    bool asyncPending;
+    bool asyncError;
+    uint8_t asyncWriteData;
 
     // MCU/Driver dependent member follows
 #if defined(STM32F1) || defined(STM32F4)
@@ -27,6 +27,8 @@
 
 #if defined(USE_I2C) && !defined(SOFT_I2C)
 
+#include "common/time.h"
+
 #include "drivers/io.h"
 #include "drivers/time.h"
 #include "drivers/nvic.h"
@@ -160,20 +162,17 @@ static bool i2cHandleHardwareFailure(I2CDevice device) {
     return false;
 }
 
-bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
-        return false;
-    }
+// Loads the job and kicks off the interrupt driven state machine, which clears state->busy when done
+static bool i2cBeginTransfer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data, bool reading) {
     I2C_TypeDef *I2Cx = i2cDevice[device].reg;
-    if (!I2Cx) {
-        return false;
-    }
     i2cState_t *state = &i2cDevice[device].state;
     uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+    // a transfer from i2cReadStart() / i2cWriteStart() may still own the peripheral
+    while (i2cBusy(device, NULL)) {; }
     state->addr = addr_ << 1;
     state->reg = reg_;
-    state->writing = 1;
-    state->reading = 0;
+    state->writing = !reading;
+    state->reading = reading;
     state->write_p = data;
     state->read_p = data;
     state->bytes = len_;
@@ -188,50 +187,95 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
         }
         I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
     }
-    timeout = I2C_DEFAULT_TIMEOUT;
+    return true;
+}
+
+static bool i2cWaitForTransfer(I2CDevice device) {
+    i2cState_t *state = &i2cDevice[device].state;
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
     while (state->busy && --timeout > 0) {; }
     if (timeout == 0)
         return i2cHandleHardwareFailure(device);
     return !(state->error);
 }
 
+static bool i2cDeviceReady(I2CDevice device) {
+    return device != I2CINVALID && device < I2CDEV_COUNT && i2cDevice[device].reg;
+}
+
+bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
+    if (!i2cDeviceReady(device)) {
+        return false;
+    }
+    return i2cBeginTransfer(device, addr_, reg_, len_, data, false) && i2cWaitForTransfer(device);
+}
+
 bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
     return i2cWriteBuffer(device, addr_, reg_, 1, &data);
 }
 
 bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t* buf) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+    if (!i2cDeviceReady(device)) {
         return false;
     }
-    I2C_TypeDef *I2Cx = i2cDevice[device].reg;
-    if (!I2Cx) {
+    return i2cBeginTransfer(device, addr_, reg_, len, buf, true) && i2cWaitForTransfer(device);
+}
+
+static bool i2cStartAsync(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf, bool reading) {
+    if (!i2cDeviceReady(device) || i2cDevice[device].state.busy) {
         return false;
     }
-    i2cState_t *state = &i2cDevice[device].state;
-    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
-    state->addr = addr_ << 1;
-    state->reg = reg_;
-    state->writing = 0;
-    state->reading = 1;
-    state->read_p = buf;
-    state->write_p = buf;
-    state->bytes = len;
-    state->busy = 1;
-    state->error = false;
-    if (!(I2Cx->CR2 & I2C_IT_EVT)) {                                    // if we are restarting the driver
-        if (!(I2Cx->CR1 & I2C_CR1_START)) {                             // ensure sending a start
-            while (I2Cx->CR1 & I2C_CR1_STOP && --timeout > 0) {; }     // wait for any stop to finish sending
-            if (timeout == 0)
-                return i2cHandleHardwareFailure(device);
-            I2C_GenerateSTART(I2Cx, ENABLE);                            // send the start for the new job
+    i2cDevice_t *pDev = &i2cDevice[device];
+    pDev->asyncError = false;
+    if (!i2cBeginTransfer(device, addr_, reg_, len, buf, reading)) {
+        pDev->asyncError = true;
+        return false;
+    }
+    pDev->asyncStartedAtUs = micros();
+    pDev->asyncPending = true;
+    return true;
+}
+
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf) {
+    return i2cStartAsync(device, addr_, reg_, len, buf, true);
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
+    if (!i2cDeviceReady(device) || i2cDevice[device].state.busy) {
+        return false;
+    }
+    i2cDevice[device].asyncWriteData = data;
+    return i2cStartAsync(device, addr_, reg_, 1, &i2cDevice[device].asyncWriteData, false);
+}
+
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *data) {
+    return i2cStartAsync(device, addr_, reg_, len, data, false);
+}
+
+bool i2cBusy(I2CDevice device, bool *error) {
+    if (!i2cDeviceReady(device)) {
+        if (error) {
+            *error = true;
         }
-        I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
+        return false;
     }
-    timeout = I2C_DEFAULT_TIMEOUT;
-    while (state->busy && --timeout > 0) {; }
-    if (timeout == 0)
-        return i2cHandleHardwareFailure(device);
-    return !(state->error);
+    i2cDevice_t *pDev = &i2cDevice[device];
+    if (pDev->asyncPending) {
+        if (pDev->state.busy) {
+            if (cmpTimeUs(micros(), pDev->asyncStartedAtUs) < I2C_ASYNC_TIMEOUT_US) {
+                return true;
+            }
+            // stuck, reset the peripheral rather than let the caller wait forever
+            i2cHandleHardwareFailure(device);
+            pDev->state.error = true;
+        }
+        pDev->asyncPending = false;
+        pDev->asyncError = pDev->state.error;
+    }
+    if (error) {
+        *error = pDev->asyncError;
+    }
+    return false;
 }
 
 static void i2c_er_handler(I2CDevice device) {
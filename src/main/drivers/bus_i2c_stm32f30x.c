@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "common/utils.h"
+
 #include "drivers/system.h"
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
@@ -238,4 +240,30 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t*
     return true;
 }
 
+// No interrupt driven engine here, the transfer is done by the time these return
+static bool i2cLastTransferFailed;
+
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf) {
+    i2cLastTransferFailed = !i2cRead(device, addr_, reg_, len, buf);
+    return true;
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
+    i2cLastTransferFailed = !i2cWrite(device, addr_, reg_, data);
+    return true;
+}
+
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *data) {
+    i2cLastTransferFailed = !i2cWriteBuffer(device, addr_, reg_, len, data);
+    return true;
+}
+
+bool i2cBusy(I2CDevice device, bool *error) {
+    UNUSED(device);
+    if (error) {
+        *error = i2cLastTransferFailed;
+    }
+    return false;
+}
+
 #endif
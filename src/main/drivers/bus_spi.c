@@ -32,6 +32,11 @@
 #include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/rcc.h"
+#ifdef USE_GYRO_SPI_DMA
+#include "build/atomic.h"
+#include "drivers/dma.h"
+#include "drivers/nvic.h"
+#endif
 #ifdef USE_DMA_SPI_DEVICE
 #ifndef GYRO_READ_TIMEOUT
 #define GYRO_READ_TIMEOUT 20
@@ -114,6 +119,138 @@ uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance) {
     return spiDevice[device].errorCount;
 }
 
+#ifdef USE_GYRO_SPI_DMA
+static FAST_CODE void spiStartDma(SPIDevice device, spiDmaJob_t *job) {
+    spiDevice_t *spi = &spiDevice[device];
+    spi->dmaBusy = true;
+    spi->dmaJob = job;
+    IOLo(job->bus->busdev_u.spi.csnPin);
+    spiStartDeviceDma(device, job->txData, job->rxData, job->length);
+}
+
+// Caller makes sure the bus is idle and the queue can't change underneath
+static FAST_CODE void spiStartNextDma(SPIDevice device) {
+    spiDevice_t *spi = &spiDevice[device];
+    spiDmaJob_t *job = spi->dmaQueue;
+    if (job) {
+        spi->dmaQueue = job->next;
+        spiStartDma(device, job);
+    }
+}
+
+// Blocking transfers on a bus with DMA enabled first wait for a running DMA
+// transfer and then hold back queued ones, so a gyro read started from the EXTI
+// can never interleave with a register access made from a task. The gyro job
+// then starts the moment the bus is released, ahead of any other queued job.
+static FAST_CODE spiDevice_t *spiBusBlockingBegin(const busDevice_t *bus) {
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    if (device == SPIINVALID || !spiDevice[device].dmaEnabled) {
+        return NULL;
+    }
+    spiDevice_t *spi = &spiDevice[device];
+    ATOMIC_BLOCK(NVIC_PRIO_SPI_DMA) {
+        spi->blockingDepth++;
+    }
+    uint16_t spiTimeout = 10000;
+    while (spi->dmaBusy) {
+        if ((spiTimeout--) == 0) {
+            spiTimeoutUserCallback(bus->busdev_u.spi.instance);
+            break;
+        }
+    }
+    return spi;
+}
+
+static FAST_CODE void spiBusBlockingEnd(spiDevice_t *spi) {
+    if (spi) {
+        ATOMIC_BLOCK(NVIC_PRIO_SPI_DMA) {
+            if (--spi->blockingDepth == 0 && !spi->dmaBusy) {
+                spiStartNextDma(spi - spiDevice);
+            }
+        }
+    }
+}
+
+void spiBusAcquire(const busDevice_t *bus) {
+    spiBusBlockingBegin(bus);
+}
+
+void spiBusRelease(const busDevice_t *bus) {
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    if (device != SPIINVALID && spiDevice[device].dmaEnabled) {
+        spiBusBlockingEnd(&spiDevice[device]);
+    }
+}
+
+static bool spiDmaStreamIsFree(dmaIdentifier_e identifier) {
+    // motors, LED strip and the OSD may already drive the default streams
+    return dmaGetOwner(identifier) == OWNER_FREE && !dmaGetDescriptorByIdentifier(identifier)->irqHandlerCallback;
+}
+
+bool spiBusDmaInit(const busDevice_t *bus) {
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    if (device == SPIINVALID) {
+        return false;
+    }
+    spiDevice_t *spi = &spiDevice[device];
+    if (spi->dmaEnabled) {
+        return true;
+    }
+    if (spi->txDmaIdentifier == DMA_NONE || spi->rxDmaIdentifier == DMA_NONE
+        || !spiDmaStreamIsFree(spi->txDmaIdentifier) || !spiDmaStreamIsFree(spi->rxDmaIdentifier)) {
+        return false;
+    }
+    spiInitDeviceDma(device);
+    spi->dmaEnabled = true;
+    return true;
+}
+
+// Safe to call from interrupt context. Starts the job right away on an idle bus,
+// otherwise queues it by priority. Returns false when the bus has no DMA or the
+// job is still pending from an earlier call.
+FAST_CODE bool spiBusQueueDma(spiDmaJob_t *job) {
+    const SPIDevice device = spiDeviceByInstance(job->bus->busdev_u.spi.instance);
+    if (device == SPIINVALID || !spiDevice[device].dmaEnabled) {
+        return false;
+    }
+    spiDevice_t *spi = &spiDevice[device];
+    bool queued = false;
+    ATOMIC_BLOCK(NVIC_PRIO_SPI_DMA) {
+        if (!job->pending) {
+            job->pending = true;
+            queued = true;
+            if (!spi->dmaBusy && !spi->blockingDepth) {
+                spiStartDma(device, job);
+            } else {
+                spiDmaJob_t **link = &spi->dmaQueue;
+                while (*link && (*link)->priority >= job->priority) {
+                    link = &(*link)->next;
+                }
+                job->next = *link;
+                *link = job;
+            }
+        }
+    }
+    return queued;
+}
+
+// Called by the platform RX DMA interrupt handler, which runs at NVIC_PRIO_SPI_DMA
+FAST_CODE void spiDeviceDmaComplete(SPIDevice device) {
+    spiDevice_t *spi = &spiDevice[device];
+    spiDmaJob_t *job = spi->dmaJob;
+    IOHi(job->bus->busdev_u.spi.csnPin);
+    spi->dmaJob = NULL;
+    spi->dmaBusy = false;
+    // the callback may queue the job again
+    job->pending = false;
+    if (job->callback) {
+        job->callback(job->callbackArg);
+    }
+    if (!spi->dmaBusy && !spi->blockingDepth) {
+        spiStartNextDma(device);
+    }
+}
+#endif
 
 FAST_CODE bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length) {
 #ifdef USE_DMA_SPI_DEVICE
@@ -135,9 +272,15 @@ FAST_CODE bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uin
         IOHi(bus->busdev_u.spi.csnPin);
     }
 #else
+#ifdef USE_GYRO_SPI_DMA
+    spiDevice_t *spi = spiBusBlockingBegin(bus);
+#endif
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransfer(bus->busdev_u.spi.instance, txData, rxData, length);
     IOHi(bus->busdev_u.spi.csnPin);
+#ifdef USE_GYRO_SPI_DMA
+    spiBusBlockingEnd(spi);
+#endif
 #endif
     return true;
 }
@@ -178,10 +321,16 @@ FAST_CODE bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t
         IOHi(bus->busdev_u.spi.csnPin);
     }
 #else
+#ifdef USE_GYRO_SPI_DMA
+    spiDevice_t *spi = spiBusBlockingBegin(bus);
+#endif
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransferByte(bus->busdev_u.spi.instance, data);
     IOHi(bus->busdev_u.spi.csnPin);
+#ifdef USE_GYRO_SPI_DMA
+    spiBusBlockingEnd(spi);
+#endif
 #endif
     return true;
 }
@@ -207,10 +356,16 @@ FAST_CODE bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uin
         IOHi(bus->busdev_u.spi.csnPin);
     }
 #else
+#ifdef USE_GYRO_SPI_DMA
+    spiDevice_t *spi = spiBusBlockingBegin(bus);
+#endif
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg | 0x80); // read transaction
     spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
     IOHi(bus->busdev_u.spi.csnPin);
+#ifdef USE_GYRO_SPI_DMA
+    spiBusBlockingEnd(spi);
+#endif
 #endif
     return true;
 }
@@ -239,10 +394,16 @@ FAST_CODE uint8_t spiBusReadRegister(const busDevice_t *bus, uint8_t reg) {
     }
 #else
     uint8_t data;
+#ifdef USE_GYRO_SPI_DMA
+    spiDevice_t *spi = spiBusBlockingBegin(bus);
+#endif
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg | 0x80); // read transaction
     spiTransfer(bus->busdev_u.spi.instance, NULL, &data, 1);
     IOHi(bus->busdev_u.spi.csnPin);
+#ifdef USE_GYRO_SPI_DMA
+    spiBusBlockingEnd(spi);
+#endif
     return data;
 #endif
 }
@@ -119,6 +119,39 @@ bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data
 uint8_t spiBusReadRegister(const busDevice_t *bus, uint8_t reg);
 void spiBusSetInstance(busDevice_t *bus, SPI_TypeDef *instance);
 
+#ifdef USE_GYRO_SPI_DMA
+// Non blocking transfers, the callback runs from the RX DMA interrupt once CS has been released
+typedef void (*spiDmaCallbackFuncPtr)(uint32_t arg);
+
+// Jobs waiting for a busy bus start in priority order, then in order of arrival
+typedef enum {
+    SPI_DMA_PRIORITY_LOW = 0,
+    SPI_DMA_PRIORITY_GYRO,
+} spiDmaPriority_e;
+
+typedef struct spiDmaJob_s {
+    const busDevice_t *bus;
+    const uint8_t *txData;
+    uint8_t *rxData;
+    int length;
+    spiDmaCallbackFuncPtr callback;
+    uint32_t callbackArg;
+    spiDmaPriority_e priority;
+    volatile bool pending;                  // queued or on the bus, owned by the bus until cleared
+    struct spiDmaJob_s *next;
+} spiDmaJob_t;
+
+bool spiBusDmaInit(const busDevice_t *bus);
+bool spiBusQueueDma(spiDmaJob_t *job);
+
+// For drivers that clock the bus themselves with spiTransfer(), DMA jobs wait until the release
+void spiBusAcquire(const busDevice_t *bus);
+void spiBusRelease(const busDevice_t *bus);
+#else
+#define spiBusAcquire(bus) ((void)(bus))
+#define spiBusRelease(bus) ((void)(bus))
+#endif
+
 struct spiPinConfig_s;
 void spiPinConfigure(const struct spiPinConfig_s *pConfig);
 
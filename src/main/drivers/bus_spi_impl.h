@@ -46,6 +46,11 @@ typedef struct spiHardware_s {
 #if defined(USE_HAL_DRIVER)
     uint8_t dmaIrqHandler;
 #endif
+#ifdef USE_GYRO_SPI_DMA
+    uint8_t txDmaIdentifier;
+    uint8_t rxDmaIdentifier;
+    uint8_t dmaChannel;
+#endif
 } spiHardware_t;
 
 extern const spiHardware_t spiHardware[];
@@ -70,9 +75,24 @@ typedef struct SPIDevice_s {
     DMA_HandleTypeDef hdma;
     uint8_t dmaIrqHandler;
 #endif
+#ifdef USE_GYRO_SPI_DMA
+    uint8_t txDmaIdentifier;
+    uint8_t rxDmaIdentifier;
+    uint8_t dmaChannel;
+    bool dmaEnabled;
+    volatile bool dmaBusy;                  // a non blocking transfer owns the bus
+    volatile uint8_t blockingDepth;         // blocking transfers own the bus, DMA jobs are queued
+    spiDmaJob_t *dmaJob;                    // on the bus while dmaBusy
+    spiDmaJob_t *dmaQueue;
+#endif
 } spiDevice_t;
 
 extern spiDevice_t spiDevice[SPIDEV_COUNT];
 
 void spiInitDevice(SPIDevice device);
+#ifdef USE_GYRO_SPI_DMA
+void spiInitDeviceDma(SPIDevice device);
+void spiStartDeviceDma(SPIDevice device, const uint8_t *txData, uint8_t *rxData, int length);
+void spiDeviceDmaComplete(SPIDevice device);
+#endif
 uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance);
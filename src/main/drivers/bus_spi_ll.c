@@ -206,4 +206,71 @@ void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor) {
     LL_SPI_SetBaudRatePrescaler(instance, divisor ? (ffs(divisor | 0x100) - 2) << SPI_CR1_BR_Pos : 0);
     LL_SPI_Enable(instance);
 }
+
+#ifdef USE_GYRO_SPI_DMA
+#define SPI_DMA_FLAGS (DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF)
+
+static void spiRxDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        const SPIDevice device = descriptor->userParam;
+        spiDevice_t *spi = &spiDevice[device];
+        dmaChannelDescriptor_t *txDescriptor = dmaGetDescriptorByIdentifier(spi->txDmaIdentifier);
+        // both streams stop by themselves in normal mode, rx completes last
+        DMA_CLEAR_FLAG(descriptor, SPI_DMA_FLAGS);
+        DMA_CLEAR_FLAG(txDescriptor, SPI_DMA_FLAGS);
+        LL_SPI_DisableDMAReq_TX(spi->dev);
+        LL_SPI_DisableDMAReq_RX(spi->dev);
+        spiDeviceDmaComplete(device);
+    }
+}
+
+void spiInitDeviceDma(SPIDevice device) {
+    spiDevice_t *spi = &spiDevice[device];
+    DMA_Stream_TypeDef *txStream = dmaGetRefByIdentifier(spi->txDmaIdentifier);
+    DMA_Stream_TypeDef *rxStream = dmaGetRefByIdentifier(spi->rxDmaIdentifier);
+    dmaInit(spi->txDmaIdentifier, OWNER_SPI_MOSI, RESOURCE_INDEX(device));
+    dmaInit(spi->rxDmaIdentifier, OWNER_SPI_MISO, RESOURCE_INDEX(device));
+    LL_DMA_InitTypeDef dmaInitStruct;
+    LL_DMA_StructInit(&dmaInitStruct);
+    dmaInitStruct.Channel = dmaGetChannel(spi->dmaChannel);
+    dmaInitStruct.PeriphOrM2MSrcAddress = LL_SPI_DMA_GetRegAddr(spi->dev);
+    dmaInitStruct.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dmaInitStruct.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dmaInitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dmaInitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dmaInitStruct.Mode = LL_DMA_MODE_NORMAL;
+    dmaInitStruct.FIFOMode = LL_DMA_FIFOMODE_DISABLE;
+    // memory address and length are set for every transfer
+    dmaInitStruct.NbData = 1;
+    LL_EX_DMA_DeInit(txStream);
+    dmaInitStruct.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dmaInitStruct.Priority = LL_DMA_PRIORITY_MEDIUM;
+    LL_EX_DMA_Init(txStream, &dmaInitStruct);
+    LL_EX_DMA_DeInit(rxStream);
+    dmaInitStruct.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dmaInitStruct.Priority = LL_DMA_PRIORITY_HIGH;
+    LL_EX_DMA_Init(rxStream, &dmaInitStruct);
+    dmaSetHandler(spi->rxDmaIdentifier, spiRxDmaIrqHandler, NVIC_PRIO_SPI_DMA, device);
+    LL_EX_DMA_EnableIT_TC(rxStream);
+}
+
+void spiStartDeviceDma(SPIDevice device, const uint8_t *txData, uint8_t *rxData, int length) {
+    spiDevice_t *spi = &spiDevice[device];
+    DMA_Stream_TypeDef *txStream = dmaGetRefByIdentifier(spi->txDmaIdentifier);
+    DMA_Stream_TypeDef *rxStream = dmaGetRefByIdentifier(spi->rxDmaIdentifier);
+    // byte wide rx events, and drop anything a blocking transfer left in the fifo
+    SET_BIT(spi->dev->CR2, SPI_RXFIFO_THRESHOLD);
+    while (LL_SPI_IsActiveFlag_RXNE(spi->dev)) {
+        (void)LL_SPI_ReceiveData8(spi->dev);
+    }
+    txStream->M0AR = (uint32_t)txData;
+    rxStream->M0AR = (uint32_t)rxData;
+    LL_EX_DMA_SetDataLength(txStream, length);
+    LL_EX_DMA_SetDataLength(rxStream, length);
+    LL_EX_DMA_EnableStream(rxStream);
+    LL_EX_DMA_EnableStream(txStream);
+    LL_SPI_EnableDMAReq_RX(spi->dev);
+    LL_SPI_EnableDMAReq_TX(spi->dev);
+}
+#endif
 #endif
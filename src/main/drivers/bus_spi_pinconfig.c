@@ -162,6 +162,11 @@ const spiHardware_t spiHardware[] = {
         },
         .af = GPIO_AF_SPI1,
         .rcc = RCC_APB2(SPI1),
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA2_ST3_HANDLER,
+        .rxDmaIdentifier = DMA2_ST0_HANDLER,
+        .dmaChannel = 3,
+#endif
     },
     {
         .device = SPIDEV_2,
@@ -180,6 +185,11 @@ const spiHardware_t spiHardware[] = {
         },
         .af = GPIO_AF_SPI2,
         .rcc = RCC_APB1(SPI2),
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA1_ST4_HANDLER,
+        .rxDmaIdentifier = DMA1_ST3_HANDLER,
+        .dmaChannel = 0,
+#endif
     },
     {
         .device = SPIDEV_3,
@@ -198,6 +208,11 @@ const spiHardware_t spiHardware[] = {
         },
         .af = GPIO_AF_SPI3,
         .rcc = RCC_APB1(SPI3),
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA1_ST5_HANDLER,
+        .rxDmaIdentifier = DMA1_ST0_HANDLER,
+        .dmaChannel = 0,
+#endif
     },
 #endif
 #ifdef STM32F7
@@ -218,6 +233,11 @@ const spiHardware_t spiHardware[] = {
         },
         .rcc = RCC_APB2(SPI1),
         .dmaIrqHandler = DMA2_ST3_HANDLER,
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA2_ST3_HANDLER,
+        .rxDmaIdentifier = DMA2_ST0_HANDLER,
+        .dmaChannel = 3,
+#endif
     },
     {
         .device = SPIDEV_2,
@@ -239,6 +259,11 @@ const spiHardware_t spiHardware[] = {
         },
         .rcc = RCC_APB1(SPI2),
         .dmaIrqHandler = DMA1_ST4_HANDLER,
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA1_ST4_HANDLER,
+        .rxDmaIdentifier = DMA1_ST3_HANDLER,
+        .dmaChannel = 0,
+#endif
     },
     {
         .device = SPIDEV_3,
@@ -259,6 +284,11 @@ const spiHardware_t spiHardware[] = {
         },
         .rcc = RCC_APB1(SPI3),
         .dmaIrqHandler = DMA1_ST7_HANDLER,
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA1_ST7_HANDLER,
+        .rxDmaIdentifier = DMA1_ST0_HANDLER,
+        .dmaChannel = 0,
+#endif
     },
     {
         .device = SPIDEV_4,
@@ -277,6 +307,11 @@ const spiHardware_t spiHardware[] = {
         },
         .rcc = RCC_APB2(SPI4),
         .dmaIrqHandler = DMA2_ST1_HANDLER,
+#ifdef USE_GYRO_SPI_DMA
+        .txDmaIdentifier = DMA2_ST1_HANDLER,
+        .rxDmaIdentifier = DMA2_ST0_HANDLER,
+        .dmaChannel = 4,
+#endif
     },
 #endif
 };
@@ -318,6 +353,11 @@ void spiPinConfigure(const spiPinConfig_t *pConfig) {
             pDev->leadingEdge = false; // XXX Should be part of transfer context
 #ifdef USE_HAL_DRIVER
             pDev->dmaIrqHandler = hw->dmaIrqHandler;
+#endif
+#ifdef USE_GYRO_SPI_DMA
+            pDev->txDmaIdentifier = hw->txDmaIdentifier;
+            pDev->rxDmaIdentifier = hw->rxDmaIdentifier;
+            pDev->dmaChannel = hw->dmaChannel;
 #endif
         }
     }
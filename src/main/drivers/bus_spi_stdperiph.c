@@ -29,8 +29,10 @@
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
+#include "drivers/dma.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
 
 spiDevice_t spiDevice[SPIDEV_COUNT];
@@ -167,4 +169,66 @@ void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor) {
     SPI_Cmd(instance, ENABLE);
 #undef BR_BITS
 }
+
+#ifdef USE_GYRO_SPI_DMA
+#define SPI_DMA_FLAGS (DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF)
+
+static void spiRxDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        const SPIDevice device = descriptor->userParam;
+        spiDevice_t *spi = &spiDevice[device];
+        dmaChannelDescriptor_t *txDescriptor = dmaGetDescriptorByIdentifier(spi->txDmaIdentifier);
+        // both streams stop by themselves in normal mode, rx completes last
+        DMA_CLEAR_FLAG(descriptor, SPI_DMA_FLAGS);
+        DMA_CLEAR_FLAG(txDescriptor, SPI_DMA_FLAGS);
+        SPI_I2S_DMACmd(spi->dev, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, DISABLE);
+        spiDeviceDmaComplete(device);
+    }
+}
+
+void spiInitDeviceDma(SPIDevice device) {
+    spiDevice_t *spi = &spiDevice[device];
+    DMA_Stream_TypeDef *txStream = dmaGetRefByIdentifier(spi->txDmaIdentifier);
+    DMA_Stream_TypeDef *rxStream = dmaGetRefByIdentifier(spi->rxDmaIdentifier);
+    dmaInit(spi->txDmaIdentifier, OWNER_SPI_MOSI, RESOURCE_INDEX(device));
+    dmaInit(spi->rxDmaIdentifier, OWNER_SPI_MISO, RESOURCE_INDEX(device));
+    DMA_InitTypeDef dmaInitStruct;
+    DMA_StructInit(&dmaInitStruct);
+    dmaInitStruct.DMA_Channel = dmaGetChannel(spi->dmaChannel);
+    dmaInitStruct.DMA_PeripheralBaseAddr = (uint32_t)&spi->dev->DR;
+    dmaInitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    dmaInitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    dmaInitStruct.DMA_Mode = DMA_Mode_Normal;
+    dmaInitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    // memory address and length are set for every transfer
+    dmaInitStruct.DMA_BufferSize = 1;
+    DMA_DeInit(txStream);
+    dmaInitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    dmaInitStruct.DMA_Priority = DMA_Priority_Medium;
+    DMA_Init(txStream, &dmaInitStruct);
+    DMA_DeInit(rxStream);
+    dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dmaInitStruct.DMA_Priority = DMA_Priority_High;
+    DMA_Init(rxStream, &dmaInitStruct);
+    dmaSetHandler(spi->rxDmaIdentifier, spiRxDmaIrqHandler, NVIC_PRIO_SPI_DMA, device);
+    DMA_ITConfig(rxStream, DMA_IT_TC, ENABLE);
+}
+
+void spiStartDeviceDma(SPIDevice device, const uint8_t *txData, uint8_t *rxData, int length) {
+    spiDevice_t *spi = &spiDevice[device];
+    DMA_Stream_TypeDef *txStream = dmaGetRefByIdentifier(spi->txDmaIdentifier);
+    DMA_Stream_TypeDef *rxStream = dmaGetRefByIdentifier(spi->rxDmaIdentifier);
+    // drop any byte left behind by a blocking transfer so rx stays in step with tx
+    (void)SPI_I2S_ReceiveData(spi->dev);
+    txStream->M0AR = (uint32_t)txData;
+    rxStream->M0AR = (uint32_t)rxData;
+    DMA_SetCurrDataCounter(txStream, length);
+    DMA_SetCurrDataCounter(rxStream, length);
+    DMA_Cmd(rxStream, ENABLE);
+    DMA_Cmd(txStream, ENABLE);
+    SPI_I2S_DMACmd(spi->dev, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, ENABLE);
+}
+#endif
 #endif
@@ -28,6 +28,8 @@
 #include "nvic.h"
 #include "pwm_output.h"
 #include "time.h"
+#include "common/utils.h"
+#include "fc/fc_dispatch.h"
 #include "pg/pg_ids.h"
 
 #if defined(STM32F40_41xxx)
@@ -82,7 +84,12 @@ static struct {
     uint8_t inverted;
 } cameraControlRuntime;
 
-static uint32_t endTimeMillis;
+static void cameraControlKeyRelease(dispatchEntry_t *self);
+
+// releases the key after keyDelayMs plus the hold time, without blocking the main loop
+static dispatchEntry_t cameraControlKeyReleaseEntry = {
+    .dispatch = cameraControlKeyRelease,
+};
 
 #ifdef CAMERA_CONTROL_SOFTWARE_PWM_AVAILABLE
 static void cameraControlHi(void) {
@@ -133,6 +140,7 @@ void cameraControlInit(void) {
         cameraControlRuntime.period = CAMERA_CONTROL_PWM_RESOLUTION;
         *cameraControlRuntime.channel.ccr = cameraControlRuntime.period;
         cameraControlRuntime.enabled = true;
+        dispatchEnable();
 #endif
     } else if (CAMERA_CONTROL_MODE_SOFTWARE_PWM == cameraControlConfig()->mode) {
 #ifdef CAMERA_CONTROL_SOFTWARE_PWM_AVAILABLE
@@ -140,6 +148,7 @@ void cameraControlInit(void) {
         cameraControlHi();
         cameraControlRuntime.period = CAMERA_CONTROL_SOFT_PWM_RESOLUTION;
         cameraControlRuntime.enabled = true;
+        dispatchEnable();
         NVIC_InitTypeDef nvicTIM6 = {
             TIM6_DAC_IRQn, NVIC_PRIORITY_BASE(NVIC_PRIO_TIMER), NVIC_PRIORITY_SUB(NVIC_PRIO_TIMER), ENABLE
         };
@@ -157,13 +166,22 @@ void cameraControlInit(void) {
     }
 }
 
-void cameraControlProcess(uint32_t currentTimeUs) {
-    if (endTimeMillis && currentTimeUs >= 1000 * endTimeMillis) {
-        if (CAMERA_CONTROL_MODE_HARDWARE_PWM == cameraControlConfig()->mode) {
-            *cameraControlRuntime.channel.ccr = cameraControlRuntime.period;
-        } else if (CAMERA_CONTROL_MODE_SOFTWARE_PWM == cameraControlConfig()->mode) {
-        }
-        endTimeMillis = 0;
+static void cameraControlKeyRelease(dispatchEntry_t *self) {
+    UNUSED(self);
+    if (CAMERA_CONTROL_MODE_HARDWARE_PWM == cameraControlConfig()->mode) {
+#ifdef CAMERA_CONTROL_HARDWARE_PWM_AVAILABLE
+        *cameraControlRuntime.channel.ccr = cameraControlRuntime.period;
+#endif
+    } else if (CAMERA_CONTROL_MODE_SOFTWARE_PWM == cameraControlConfig()->mode) {
+#ifdef CAMERA_CONTROL_SOFTWARE_PWM_AVAILABLE
+        // Disable timers and interrupt generation
+        TIM6->CR1 &= ~TIM_CR1_CEN;
+        TIM7->CR1 &= ~TIM_CR1_CEN;
+        TIM6->DIER = 0;
+        TIM7->DIER = 0;
+        // Reset to idle state
+        cameraControlHi();
+#endif
     }
 }
 
@@ -195,18 +213,19 @@ void cameraControlKeyPress(cameraControlKey_e key, uint32_t holdDurationMs) {
     // Force OSD timeout so we are alone on the display.
     resumeRefreshAt = 0;
 #endif
+    // a new key press replaces the one still held
+    dispatchCancel(&cameraControlKeyReleaseEntry);
+    const int releaseDelayUs = 1000 * (cameraControlConfig()->keyDelayMs + holdDurationMs);
     if (CAMERA_CONTROL_MODE_HARDWARE_PWM == cameraControlConfig()->mode) {
 #ifdef CAMERA_CONTROL_HARDWARE_PWM_AVAILABLE
         *cameraControlRuntime.channel.ccr = lrintf(dutyCycle * cameraControlRuntime.period);
-        endTimeMillis = millis() + cameraControlConfig()->keyDelayMs + holdDurationMs;
+        dispatchAdd(&cameraControlKeyReleaseEntry, releaseDelayUs);
 #endif
     } else if (CAMERA_CONTROL_MODE_SOFTWARE_PWM == cameraControlConfig()->mode) {
 #ifdef CAMERA_CONTROL_SOFTWARE_PWM_AVAILABLE
         const uint32_t hiTime = lrintf(dutyCycle * cameraControlRuntime.period);
         if (0 == hiTime) {
             cameraControlLo();
-            delay(cameraControlConfig()->keyDelayMs + holdDurationMs);
-            cameraControlHi();
         } else {
             TIM6->CNT = hiTime;
             TIM6->ARR = cameraControlRuntime.period;
@@ -220,17 +239,9 @@ void cameraControlKeyPress(cameraControlKey_e key, uint32_t holdDurationMs) {
             // Enable interrupt generation
             TIM6->DIER = TIM_IT_Update;
             TIM7->DIER = TIM_IT_Update;
-            const uint32_t endTime = millis() + cameraControlConfig()->keyDelayMs + holdDurationMs;
-            // Wait to give the camera a chance at registering the key press
-            while (millis() < endTime);
-            // Disable timers and interrupt generation
-            TIM6->CR1 &= ~TIM_CR1_CEN;
-            TIM7->CR1 &= ~TIM_CR1_CEN;
-            TIM6->DIER = 0;
-            TIM7->DIER = 0;
-            // Reset to idle state
-            IOHi(cameraControlRuntime.io);
         }
+        // Give the camera a chance at registering the key press
+        dispatchAdd(&cameraControlKeyReleaseEntry, releaseDelayUs);
 #endif
     } else if (CAMERA_CONTROL_MODE_DAC == cameraControlConfig()->mode) {
         // @todo not yet implemented
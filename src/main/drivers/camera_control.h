@@ -55,5 +55,4 @@ PG_DECLARE(cameraControlConfig_t, cameraControlConfig);
 
 void cameraControlInit(void);
 
-void cameraControlProcess(uint32_t currentTimeUs);
 void cameraControlKeyPress(cameraControlKey_e key, uint32_t holdDurationMs);
@@ -0,0 +1,62 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_CRC_HW
+
+#include "stm32f7xx_ll_crc.h"
+
+#include "drivers/crc_hw.h"
+
+// cleared while a block is being fed, an interrupt that finds the unit taken falls back to the tables
+static volatile bool crcHwFree = false;
+
+void crcHwInit(void) {
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CRC);
+    crcHwFree = true;
+}
+
+bool crcHwUpdate(uint8_t polySize, uint16_t poly, uint16_t *crc, const void *data, uint32_t length) {
+    if (!crcHwFree) {
+        return false;
+    }
+    crcHwFree = false;
+
+    LL_CRC_SetPolynomialCoef(CRC, poly);
+    LL_CRC_SetPolynomialSize(CRC, polySize == 8 ? LL_CRC_POLYLENGTH_8B : LL_CRC_POLYLENGTH_16B);
+    LL_CRC_SetInitialData(CRC, *crc);
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t * const pend = p + length;
+    for (; p != pend; p++) {
+        LL_CRC_FeedData8(CRC, *p);
+    }
+    *crc = (polySize == 8) ? LL_CRC_ReadData8(CRC) : LL_CRC_ReadData16(CRC);
+
+    crcHwFree = true;
+    return true;
+}
+
+#endif
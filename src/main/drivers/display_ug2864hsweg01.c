@@ -20,9 +20,11 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/bus_i2c.h"
@@ -173,34 +175,130 @@ static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Da
     { 0x7A, 0x7E, 0x7E, 0x7E, 0x7A }, //   (131)    - 0x00C8 Vertical Bargraph - 6 (full)
 };
 
+/*
+ * The screen is drawn into RAM laid out like the display's own memory, a page of 8 pixel rows with a byte per column.
+ * Drawing only marks the changed columns of each page, i2c_OLED_update() sends them in the background.
+ */
+#define SCREEN_PAGE_COUNT (SCREEN_HEIGHT / 8)
+
+static uint8_t frameBuffer[SCREEN_PAGE_COUNT][SCREEN_WIDTH];
+// Changed columns of each page, dirtyFrom == dirtyTo when the page is in sync
+static uint8_t dirtyFrom[SCREEN_PAGE_COUNT];
+static uint8_t dirtyTo[SCREEN_PAGE_COUNT];
+static uint8_t cursorPage;
+static uint8_t cursorColumn;
+
+typedef enum {
+    OLED_UPDATE_IDLE,
+    OLED_UPDATE_WINDOW,     // column and page address commands sent, the data goes next
+    OLED_UPDATE_DATA,
+} oledUpdateState_e;
+
+static oledUpdateState_e updateState = OLED_UPDATE_IDLE;
+static uint8_t updatePage;
+static uint8_t updateFrom;
+static uint8_t updateTo;
+static uint8_t updateCommands[6];
+
+static void i2c_OLED_wait_for_update(busDevice_t *bus) {
+    // bounded by the I2C driver's timeout for stuck transfers
+    while (i2cBusy(bus->busdev_u.i2c.device, NULL));
+    updateState = OLED_UPDATE_IDLE;
+}
+
 static bool i2c_OLED_send_cmd(busDevice_t *bus, uint8_t command) {
     return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x80, command);
 }
 
 static bool i2c_OLED_send_cmdarray(busDevice_t *bus, const uint8_t *commands, size_t len) {
-    for (size_t i = 0 ; i < len ; i++) {
-        if (!i2c_OLED_send_cmd(bus, commands[i])) {
-            return false;
-        }
+    // With the continuation bit clear all the following bytes are commands
+    return i2cWriteBuffer(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x00, len, (uint8_t *)commands);
+}
+
+static void i2c_OLED_mark_dirty(uint8_t page, uint8_t from, uint8_t to) {
+    if (dirtyFrom[page] == dirtyTo[page]) {
+        dirtyFrom[page] = from;
+        dirtyTo[page] = to;
+    } else {
+        dirtyFrom[page] = MIN(dirtyFrom[page], from);
+        dirtyTo[page] = MAX(dirtyTo[page], to);
+    }
+}
+
+static void i2c_OLED_draw_column(uint8_t val) {
+    if (frameBuffer[cursorPage][cursorColumn] != val) {
+        frameBuffer[cursorPage][cursorColumn] = val;
+        i2c_OLED_mark_dirty(cursorPage, cursorColumn, cursorColumn + 1);
+    }
+    // wraps like the display's horizontal addressing mode
+    if (++cursorColumn == SCREEN_WIDTH) {
+        cursorColumn = 0;
+        cursorPage = (cursorPage + 1) % SCREEN_PAGE_COUNT;
     }
-    return true;
 }
 
-static bool i2c_OLED_send_byte(busDevice_t *bus, uint8_t val) {
-    return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x40, val);
+/*
+ * Sends the next changed part of the screen, a page at a time, without waiting for the bus.
+ * Call it until it returns true, which means the display shows the frame buffer.
+ */
+bool i2c_OLED_update(busDevice_t *bus) {
+    const I2CDevice device = bus->busdev_u.i2c.device;
+    if (i2cBusy(device, NULL)) {
+        return false;
+    }
+    switch (updateState) {
+    case OLED_UPDATE_WINDOW:
+        // the columns are read from the frame buffer during the transfer, later changes mark them dirty again
+        if (i2cWriteBufferStart(device, bus->busdev_u.i2c.address, 0x40, updateTo - updateFrom, &frameBuffer[updatePage][updateFrom])) {
+            updateState = OLED_UPDATE_DATA;
+        } else {
+            i2c_OLED_mark_dirty(updatePage, updateFrom, updateTo);
+            updateState = OLED_UPDATE_IDLE;
+        }
+        return false;
+    case OLED_UPDATE_DATA:
+    case OLED_UPDATE_IDLE:
+    default:
+        updateState = OLED_UPDATE_IDLE;
+        break;
+    }
+    for (int i = 1; i <= SCREEN_PAGE_COUNT; i++) {
+        const uint8_t page = (updatePage + i) % SCREEN_PAGE_COUNT;
+        if (dirtyFrom[page] == dirtyTo[page]) {
+            continue;
+        }
+        updatePage = page;
+        updateFrom = dirtyFrom[page];
+        updateTo = dirtyTo[page];
+        dirtyFrom[page] = dirtyTo[page] = 0;
+        updateCommands[0] = 0x21; // Set column address
+        updateCommands[1] = updateFrom;
+        updateCommands[2] = updateTo - 1;
+        updateCommands[3] = 0x22; // Set page address
+        updateCommands[4] = page;
+        updateCommands[5] = page;
+        if (i2cWriteBufferStart(device, bus->busdev_u.i2c.address, 0x00, sizeof(updateCommands), updateCommands)) {
+            updateState = OLED_UPDATE_WINDOW;
+        } else {
+            i2c_OLED_mark_dirty(page, updateFrom, updateTo);
+        }
+        return false;
+    }
+    return true;
 }
 
 void i2c_OLED_clear_display_quick(busDevice_t *bus) {
-    static const uint8_t i2c_OLED_cmd_clear_display_quick[] = {
-        0xb0, // set page address to 0
-        0x40, // Display start line register to 0
-        0,    // Set low col address to 0
-        0x10, // Set high col address to 0
-    };
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_quick, ARRAYLEN(i2c_OLED_cmd_clear_display_quick));
-    for (uint16_t i = 0; i < 1024; i++) {      // fill the display's RAM with graphic... 128*64 pixel picture
-        i2c_OLED_send_byte(bus, 0x00);  // clear
+    UNUSED(bus);
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        for (int column = 0; column < SCREEN_WIDTH; column++) {
+            if (frameBuffer[page][column]) {
+                frameBuffer[page][column] = 0;
+                i2c_OLED_mark_dirty(page, column, column + 1);
+            }
+        }
     }
+    cursorPage = 0;
+    cursorColumn = 0;
 }
 
 void i2c_OLED_clear_display(busDevice_t *bus) {
@@ -210,8 +308,16 @@ void i2c_OLED_clear_display(busDevice_t *bus) {
         0x20, // Set Memory Addressing Mode
         0x00, // Set Memory Addressing Mode to Horizontal addressing mode
     };
+    i2c_OLED_wait_for_update(bus);
     i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_pre, ARRAYLEN(i2c_OLED_cmd_clear_display_pre));
-    i2c_OLED_clear_display_quick(bus);
+    // What the display shows is unknown now, send it all
+    memset(frameBuffer, 0, sizeof(frameBuffer));
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        dirtyFrom[page] = 0;
+        dirtyTo[page] = SCREEN_WIDTH;
+    }
+    cursorPage = 0;
+    cursorColumn = 0;
     static const uint8_t i2c_OLED_cmd_clear_display_post[] = {
         0x81, // Setup CONTRAST CONTROL, following byte is the contrast Value... always a 2 byte instruction
         200,  // Here you can set the brightness 1 = dull, 255 is very bright
@@ -221,12 +327,9 @@ void i2c_OLED_clear_display(busDevice_t *bus) {
 }
 
 void i2c_OLED_set_xy(busDevice_t *bus, uint8_t col, uint8_t row) {
-    uint8_t i2c_OLED_cmd_set_xy[] = {
-        0xb0 + row,                                            //set page address
-        0x00 + ((CHARACTER_WIDTH_TOTAL * col) & 0x0f),         //set low col address
-        0x10 + (((CHARACTER_WIDTH_TOTAL * col) >> 4) & 0x0f)   //set high col address
-    };
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_set_xy, ARRAYLEN(i2c_OLED_cmd_set_xy));
+    UNUSED(bus);
+    cursorPage = row % SCREEN_PAGE_COUNT;
+    cursorColumn = (CHARACTER_WIDTH_TOTAL * col) % SCREEN_WIDTH;
 }
 
 void i2c_OLED_set_line(busDevice_t *bus, uint8_t row) {
@@ -234,14 +337,15 @@ void i2c_OLED_set_line(busDevice_t *bus, uint8_t row) {
 }
 
 void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii) {
+    UNUSED(bus);
     unsigned char i;
     uint8_t buffer;
     for (i = 0; i < 5; i++) {
         buffer = multiWiiFont[ascii - 32][i];
         buffer ^= CHAR_FORMAT;  // apply
-        i2c_OLED_send_byte(bus, buffer);
+        i2c_OLED_draw_column(buffer);
     }
-    i2c_OLED_send_byte(bus, CHAR_FORMAT);    // the gap
+    i2c_OLED_draw_column(CHAR_FORMAT);    // the gap
 }
 
 void i2c_OLED_send_string(busDevice_t *bus, const char *string) {
@@ -257,6 +361,7 @@ void i2c_OLED_send_string(busDevice_t *bus, const char *string) {
 */
 
 bool ug2864hsweg01InitI2C(busDevice_t *bus) {
+    i2c_OLED_wait_for_update(bus);
     // Set display OFF
     if (!i2c_OLED_send_cmd(bus, 0xAE)) {
         return false;
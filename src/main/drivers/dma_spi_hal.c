@@ -18,8 +18,8 @@ FAST_RAM_ZERO_INIT DMA_HandleTypeDef SpiRxDmaHandle;
 FAST_RAM_ZERO_INIT DMA_HandleTypeDef SpiTxDmaHandle;
 FAST_RAM_ZERO_INIT volatile dma_spi_read_status_t dmaSpiReadStatus;
 FAST_RAM_ZERO_INIT volatile bool dmaSpiDeviceDataReady = false;
-FAST_RAM_ZERO_INIT uint8_t dmaTxBuffer[58];
-FAST_RAM_ZERO_INIT uint8_t dmaRxBuffer[58];
+DMA_RAM uint8_t dmaTxBuffer[58];
+DMA_RAM uint8_t dmaRxBuffer[58];
 
 
 FAST_CODE static inline void dmaSpiCsLo(void) {
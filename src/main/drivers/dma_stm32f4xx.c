@@ -24,7 +24,10 @@
 
 #include "platform.h"
 
+#include "build/cycle_profile.h"
+
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "dma.h"
 #include "resource.h"
 
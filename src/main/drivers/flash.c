@@ -35,6 +35,10 @@
 #include "drivers/io.h"
 #include "drivers/time.h"
 
+#include "pg/max7456.h"
+#include "pg/rx_spi.h"
+#include "pg/sdcard.h"
+
 static busDevice_t busInstance;
 static busDevice_t *busdev;
 
@@ -92,6 +96,57 @@ bool flashInit(const flashConfig_t *flashConfig) {
     return false;
 }
 
+#ifdef USE_FLASH_SPI_DMA
+// Drivers that bypass the bus locking would collide with a page program
+// running in the background, and a gyro read must never wait for one.
+static bool flashSpiBusIsExclusive(SPIDevice device) {
+#ifdef GYRO_1_SPI_INSTANCE
+    if (spiDeviceByInstance(GYRO_1_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+#ifdef GYRO_2_SPI_INSTANCE
+    if (spiDeviceByInstance(GYRO_2_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_MAX7456
+    if (SPI_CFG_TO_DEV(max7456Config()->spiDevice) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_RX_SPI
+    if (SPI_CFG_TO_DEV(rxSpiConfig()->spibus) == device) {
+        return false;
+    }
+#endif
+#if defined(USE_SDCARD) && defined(SDCARD_SPI_INSTANCE)
+    if (sdcardConfig()->enabled && sdcardConfig()->device == device) {
+        return false;
+    }
+#endif
+#ifdef RTC6705_SPI_INSTANCE
+    if (spiDeviceByInstance(RTC6705_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+// Called once all other DMA users are set up so the SPI streams are only
+// claimed when they are still free.
+void flashInitDma(void) {
+    if (!flashDevice.vTable || !flashDevice.busdev) {
+        return;
+    }
+    const SPIDevice device = spiDeviceByInstance(flashDevice.busdev->busdev_u.spi.instance);
+    if (device == SPIINVALID || !flashSpiBusIsExclusive(device)) {
+        return;
+    }
+    m25p16_initDma(flashDevice.busdev);
+}
+#endif
+
 bool flashIsReady(void) {
     return flashDevice.vTable->isReady(&flashDevice);
 }
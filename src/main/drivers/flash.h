@@ -46,6 +46,9 @@ typedef struct flashGeometry_s {
 } flashGeometry_t;
 
 bool flashInit(const flashConfig_t *flashConfig);
+#ifdef USE_FLASH_SPI_DMA
+void flashInitDma(void);
+#endif
 
 bool flashIsReady(void);
 bool flashWaitForReady(uint32_t timeoutMillis);
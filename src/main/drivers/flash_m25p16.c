@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -79,12 +80,37 @@ STATIC_ASSERT(M25P16_PAGESIZE < FLASH_MAX_PAGE_SIZE, M25P16_PAGESIZE_too_small);
 
 const flashVTable_t m25p16_vTable;
 
+#ifdef USE_FLASH_SPI_DMA
+// A page program is gathered here behind its command header and clocked out by
+// DMA from pageProgramFinish(). Kept out of FAST_RAM, the DMA can't reach CCM on
+// the F405, and in the non-cacheable DMA_RAM on the F7.
+#define M25P16_DMA_BUFFER_SIZE (5 + M25P16_PAGESIZE)
+
+static DMA_RAM uint8_t m25p16DmaTxBuf[M25P16_DMA_BUFFER_SIZE];
+static DMA_RAM uint8_t m25p16DmaRxBuf[M25P16_DMA_BUFFER_SIZE];
+static bool m25p16DmaEnabled = false;
+static volatile bool m25p16DmaBusy = false;
+static int m25p16DmaLength;
+static spiDmaJob_t m25p16DmaJob;
+
+static void m25p16_dmaComplete(uint32_t arg) {
+    UNUSED(arg);
+    m25p16DmaBusy = false;
+}
+#endif
+
 static void m25p16_disable(busDevice_t *bus) {
     IOHi(bus->busdev_u.spi.csnPin);
     __NOP();
+    spiBusRelease(bus);
 }
 
 static void m25p16_enable(busDevice_t *bus) {
+#ifdef USE_FLASH_SPI_DMA
+    // The SPI bus belongs to the DMA until the last page program has been clocked out
+    while (m25p16DmaBusy);
+#endif
+    spiBusAcquire(bus);
     __NOP();
     IOLo(bus->busdev_u.spi.csnPin);
 }
@@ -122,6 +148,11 @@ static uint8_t m25p16_readStatus(busDevice_t *bus) {
 }
 
 static bool m25p16_isReady(flashDevice_t *fdevice) {
+#ifdef USE_FLASH_SPI_DMA
+    if (m25p16DmaBusy) {
+        return false;
+    }
+#endif
     // If couldBeBusy is false, don't bother to poll the flash chip for its status
     fdevice->couldBeBusy = fdevice->couldBeBusy && ((m25p16_readStatus(fdevice->busdev) & M25P16_STATUS_FLAG_WRITE_IN_PROGRESS) != 0);
     return !fdevice->couldBeBusy;
@@ -222,9 +253,25 @@ static void m25p16_eraseCompletely(flashDevice_t *fdevice) {
 static void m25p16_pageProgramBegin(flashDevice_t *fdevice, uint32_t address) {
     UNUSED(fdevice);
     fdevice->currentWriteAddress = address;
+#ifdef USE_FLASH_SPI_DMA
+    if (m25p16DmaEnabled) {
+        m25p16DmaTxBuf[0] = M25P16_INSTRUCTION_PAGE_PROGRAM;
+        m25p16_setCommandAddress(&m25p16DmaTxBuf[1], address, fdevice->isLargeFlash);
+        m25p16DmaLength = fdevice->isLargeFlash ? 5 : 4;
+    }
+#endif
 }
 
 static void m25p16_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length) {
+#ifdef USE_FLASH_SPI_DMA
+    // Buffers that still fit the page are collected, the caller's buffer is free again on return
+    if (m25p16DmaEnabled && m25p16DmaLength + length <= M25P16_DMA_BUFFER_SIZE) {
+        memcpy(&m25p16DmaTxBuf[m25p16DmaLength], data, length);
+        m25p16DmaLength += length;
+        fdevice->currentWriteAddress += length;
+        return;
+    }
+#endif
     uint8_t command[5] = { M25P16_INSTRUCTION_PAGE_PROGRAM };
     m25p16_setCommandAddress(&command[1], fdevice->currentWriteAddress, fdevice->isLargeFlash);
     m25p16_waitForReady(fdevice, DEFAULT_TIMEOUT_MILLIS);
@@ -237,7 +284,29 @@ static void m25p16_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *da
 }
 
 static void m25p16_pageProgramFinish(flashDevice_t *fdevice) {
+#ifdef USE_FLASH_SPI_DMA
+    const int headerLength = fdevice->isLargeFlash ? 5 : 4;
+    if (!m25p16DmaEnabled || m25p16DmaLength <= headerLength) {
+        return;
+    }
+    m25p16_waitForReady(fdevice, DEFAULT_TIMEOUT_MILLIS);
+    m25p16_writeEnable(fdevice);
+    m25p16DmaBusy = true;
+    m25p16DmaJob.bus = fdevice->busdev;
+    m25p16DmaJob.txData = m25p16DmaTxBuf;
+    m25p16DmaJob.rxData = m25p16DmaRxBuf;
+    m25p16DmaJob.length = m25p16DmaLength;
+    m25p16DmaJob.callback = m25p16_dmaComplete;
+    m25p16DmaJob.priority = SPI_DMA_PRIORITY_LOW;
+    // a gyro read waiting for the bus goes first
+    if (!spiBusQueueDma(&m25p16DmaJob)) {
+        m25p16DmaBusy = false;
+        m25p16_transfer(fdevice->busdev, m25p16DmaTxBuf, NULL, m25p16DmaLength);
+    }
+    m25p16DmaLength = 0;
+#else
     UNUSED(fdevice);
+#endif
 }
 
 /**
@@ -291,6 +360,24 @@ static const flashGeometry_t* m25p16_getGeometry(flashDevice_t *fdevice) {
     return &fdevice->geometry;
 }
 
+#ifdef USE_FLASH_SPI_DMA
+// Called once all other DMA users are set up, page programs stay blocking
+// when the SPI streams are already taken.
+bool m25p16_initDma(const busDevice_t *bus) {
+    m25p16DmaEnabled = spiBusDmaInit(bus);
+    return m25p16DmaEnabled;
+}
+#endif
+
+// False while a page program is still being clocked out over the SPI bus
+bool m25p16_isBusIdle(void) {
+#ifdef USE_FLASH_SPI_DMA
+    return !m25p16DmaBusy;
+#else
+    return true;
+#endif
+}
+
 const flashVTable_t m25p16_vTable = {
     .isReady = m25p16_isReady,
     .waitForReady = m25p16_waitForReady,
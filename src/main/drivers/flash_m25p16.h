@@ -25,3 +25,7 @@
 #define JEDEC_ID_WINBOND_W25Q256       0xEF4019
 
 bool m25p16_detect(flashDevice_t *fdevice, uint32_t chipID);
+bool m25p16_isBusIdle(void);
+#ifdef USE_FLASH_SPI_DMA
+bool m25p16_initDma(const busDevice_t *bus);
+#endif
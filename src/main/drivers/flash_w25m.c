@@ -58,35 +58,60 @@ static flashDevice_t dieDevice[MAX_DIE_COUNT];
 
 static int dieCount;
 static uint32_t dieSize;
+static uint16_t pageSize;
+
+// Logical pages are striped across the dies, page p is page p / dieCount of die
+// p % dieCount. While one die programs a page the next one already goes to the
+// other die, and a logical sector is the same sector of every die.
+static int w25m_dieOf(uint32_t address) {
+    return (address / pageSize) % dieCount;
+}
+
+static uint32_t w25m_dieAddress(uint32_t address) {
+    return (address / pageSize / dieCount) * pageSize + address % pageSize;
+}
+
+// Logical address past the last page program, where a sequential writer goes next
+static uint32_t nextWriteAddress;
 
 static void w25m_dieSelect(busDevice_t *busdev, int die) {
     static int activeDie = -1;
     if (activeDie == die) {
         return;
     }
+    // The page program of the other die may still be clocked out by the DMA
+    while (!m25p16_isBusIdle());
     uint8_t command[2] = { W25M_INSTRUCTION_SOFTWARE_DIE_SELECT, die };
     spiBusTransfer(busdev, command, NULL, 2);
     activeDie = die;
 }
 
+static bool w25m_isDieReady(flashDevice_t *fdevice, int die) {
+    if (!dieDevice[die].couldBeBusy) {
+        return true;
+    }
+    w25m_dieSelect(fdevice->busdev, die);
+    return dieDevice[die].vTable->isReady(&dieDevice[die]);
+}
+
+/*
+ * Ready for the next page program of a sequential writer, which only needs the die the page goes to.
+ * Erases and reads wait for their own die.
+ */
 static bool w25m_isReady(flashDevice_t *fdevice) {
-    UNUSED(fdevice);
-    for (int die = 0 ; die < dieCount ; die++) {
-        if (dieDevice[die].couldBeBusy) {
-            w25m_dieSelect(fdevice->busdev, die);
-            if (!dieDevice[die].vTable->isReady(&dieDevice[die])) {
-                return false;
-            }
-        }
+    if (!m25p16_isBusIdle()) {
+        return false;
     }
-    return true;
+    return w25m_isDieReady(fdevice, w25m_dieOf(nextWriteAddress));
 }
 
 static bool w25m_waitForReady(flashDevice_t *fdevice, uint32_t timeoutMillis) {
     uint32_t time = millis();
-    while (!w25m_isReady(fdevice)) {
-        if (millis() - time > timeoutMillis) {
-            return false;
+    for (int die = 0 ; die < dieCount ; die++) {
+        while (!w25m_isDieReady(fdevice, die)) {
+            if (millis() - time > timeoutMillis) {
+                return false;
+            }
         }
     }
     return true;
@@ -113,9 +138,10 @@ bool w25m_detect(flashDevice_t *fdevice, uint32_t chipID) {
         return false;
     }
     fdevice->geometry.sectors = dieDevice[0].geometry.sectors;
-    fdevice->geometry.sectorSize = dieDevice[0].geometry.sectorSize;
-    fdevice->geometry.pagesPerSector = dieDevice[0].geometry.pagesPerSector;
+    fdevice->geometry.sectorSize = dieDevice[0].geometry.sectorSize * dieCount;
+    fdevice->geometry.pagesPerSector = dieDevice[0].geometry.pagesPerSector * dieCount;
     fdevice->geometry.pageSize = dieDevice[0].geometry.pageSize;
+    pageSize = dieDevice[0].geometry.pageSize;
     dieSize = dieDevice[0].geometry.totalSize;
     fdevice->geometry.totalSize = dieSize * dieCount;
     fdevice->vTable = &w25m_vTable;
@@ -123,9 +149,11 @@ bool w25m_detect(flashDevice_t *fdevice, uint32_t chipID) {
 }
 
 void w25m_eraseSector(flashDevice_t *fdevice, uint32_t address) {
-    int dieNumber = address / dieSize;
-    w25m_dieSelect(fdevice->busdev, dieNumber);
-    dieDevice[dieNumber].vTable->eraseSector(&dieDevice[dieNumber], address % dieSize);
+    const uint32_t dieAddress = address / fdevice->geometry.sectorSize * dieDevice[0].geometry.sectorSize;
+    for (int dieNumber = 0 ; dieNumber < dieCount ; dieNumber++) {
+        w25m_dieSelect(fdevice->busdev, dieNumber);
+        dieDevice[dieNumber].vTable->eraseSector(&dieDevice[dieNumber], dieAddress);
+    }
 }
 
 void w25m_eraseCompletely(flashDevice_t *fdevice) {
@@ -135,20 +163,19 @@ void w25m_eraseCompletely(flashDevice_t *fdevice) {
     }
 }
 
-static uint32_t currentWriteAddress;
 static int currentWriteDie;
 
 void w25m_pageProgramBegin(flashDevice_t *fdevice, uint32_t address) {
-    UNUSED(fdevice);
-    currentWriteDie = address / dieSize;
+    currentWriteDie = w25m_dieOf(address);
     w25m_dieSelect(fdevice->busdev, currentWriteDie);
-    currentWriteAddress = address % dieSize;
-    dieDevice[currentWriteDie].vTable->pageProgramBegin(&dieDevice[currentWriteDie], currentWriteAddress);
+    nextWriteAddress = address;
+    dieDevice[currentWriteDie].vTable->pageProgramBegin(&dieDevice[currentWriteDie], w25m_dieAddress(address));
 }
 
 void w25m_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length) {
     UNUSED(fdevice);
     dieDevice[currentWriteDie].vTable->pageProgramContinue(&dieDevice[currentWriteDie], data, length);
+    nextWriteAddress += length;
 }
 
 void w25m_pageProgramFinish(flashDevice_t *fdevice) {
@@ -166,14 +193,12 @@ int w25m_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, in
     int rlen; // remaining length
     int tlen; // transfer length for a round
     int rbytes;
-    // Divide a read that spans multiple dies into two.
-    // The loop is executed twice at the most for decent 'length'.
+    // Consecutive pages are on different dies, split the read at every page boundary
     for (rlen = length; rlen; rlen -= tlen) {
-        int dieNumber = address / dieSize;
-        uint32_t dieAddress = address % dieSize;
-        tlen = MIN(dieAddress + rlen, dieSize) - dieAddress;
+        int dieNumber = w25m_dieOf(address);
+        tlen = MIN(pageSize - address % pageSize, (uint32_t)rlen);
         w25m_dieSelect(fdevice->busdev, dieNumber);
-        rbytes = dieDevice[dieNumber].vTable->readBytes(&dieDevice[dieNumber], dieAddress, buffer, tlen);
+        rbytes = dieDevice[dieNumber].vTable->readBytes(&dieDevice[dieNumber], w25m_dieAddress(address), buffer, tlen);
         if (!rbytes) {
             return 0;
         }
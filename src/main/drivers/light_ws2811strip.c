@@ -38,16 +38,15 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 #include "dma.h"
 #include "drivers/io.h"
 #include "light_ws2811strip.h"
 
 #if defined(STM32F1) || defined(STM32F3)
 uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#elif defined(STM32F7)
-FAST_RAM_ZERO_INIT uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #else
-uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+DMA_RAM uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #endif
 
 volatile uint8_t ws2811LedDataTransferInProgress = 0;
@@ -56,9 +55,16 @@ uint16_t BIT_COMPARE_1 = 0;
 uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_LED_STRIP_LENGTH];
+// colours the strip was last sent, the DMA interrupt encodes from here
+static rgbColor24bpp_t ledRgbBuffer[WS2811_LED_STRIP_LENGTH];
+// bit per LED written since its colour was last converted
+static uint32_t ledDirty;
+
+STATIC_ASSERT(WS2811_LED_STRIP_LENGTH <= 32, ws2811_dirty_mask_too_small);
 
 void setLedHsv(uint16_t index, const hsvColor_t *color) {
     ledColorBuffer[index] = *color;
+    ledDirty |= 1U << index;
 }
 
 void getLedHsv(uint16_t index, hsvColor_t *color) {
@@ -67,10 +73,12 @@ void getLedHsv(uint16_t index, hsvColor_t *color) {
 
 void setLedValue(uint16_t index, const uint8_t value) {
     ledColorBuffer[index].v = value;
+    ledDirty |= 1U << index;
 }
 
 void scaleLedValue(uint16_t index, const uint8_t scalePercent) {
     ledColorBuffer[index].v = ((uint16_t)ledColorBuffer[index].v * scalePercent / 100);
+    ledDirty |= 1U << index;
 }
 
 void setStripColor(const hsvColor_t *color) {
@@ -102,6 +110,11 @@ bool isWS2811LedStripReady(void) {
 
 STATIC_UNIT_TESTED uint16_t dmaBufferOffset;
 static int16_t ledIndex;
+static ledStripFormatRGB_e ledStripFormat;
+static bool ledStripSent;               // the strip shows ledRgbBuffer in ledStripFormat
+static uint8_t latchHalves;             // bit per ring half that holds the latch delay instead of led data
+
+STATIC_ASSERT(WS2811_DMA_HALF_SIZE >= WS2811_DELAY_BUFFER_LENGTH, ws2811_half_shorter_than_latch);
 
 #define USE_FAST_DMA_BUFFER_IMPL
 #ifdef USE_FAST_DMA_BUFFER_IMPL
@@ -135,40 +148,87 @@ STATIC_UNIT_TESTED void updateLEDDMABuffer(uint8_t componentValue) {
 }
 #endif
 
+static void encodeLed(rgbColor24bpp_t *rgb24) {
+#ifdef USE_FAST_DMA_BUFFER_IMPL
+    fastUpdateLEDDMABuffer(ledStripFormat, rgb24);
+#else
+    switch (ledStripFormat) {
+    case LED_RGB: // WS2811 drivers use RGB format
+        updateLEDDMABuffer(rgb24->rgb.r);
+        updateLEDDMABuffer(rgb24->rgb.g);
+        break;
+    case LED_GRB: // WS2812 drivers use GRB format
+    default:
+        updateLEDDMABuffer(rgb24->rgb.g);
+        updateLEDDMABuffer(rgb24->rgb.r);
+        break;
+    }
+    updateLEDDMABuffer(rgb24->rgb.b);
+#endif
+}
+
+static void fillDmaBufferHalf(uint8_t half) {
+    dmaBufferOffset = half * WS2811_DMA_HALF_SIZE;
+    if (ledIndex >= WS2811_LED_STRIP_LENGTH) {
+        // compare value 0 keeps the line low for the latch delay
+        memset(&ledStripDMABuffer[dmaBufferOffset], 0, WS2811_DMA_HALF_SIZE * sizeof(ledStripDMABuffer[0]));
+        latchHalves |= 1 << half;
+        return;
+    }
+    for (int i = 0; i < WS2811_DMA_LEDS_PER_HALF; i++) {
+        if (ledIndex < WS2811_LED_STRIP_LENGTH) {
+            encodeLed(&ledRgbBuffer[ledIndex++]);
+        } else {
+            memset(&ledStripDMABuffer[dmaBufferOffset], 0, WS2811_BITS_PER_LED * sizeof(ledStripDMABuffer[0]));
+            dmaBufferOffset += WS2811_BITS_PER_LED;
+        }
+    }
+    latchHalves &= ~(1 << half);
+}
+
+/*
+ * Called from the DMA interrupt once a half of the ring went out, refills it with the next LEDs.
+ * Returns false when that half was the latch delay, the strip is then done and the DMA can stop.
+ */
+bool ws2811UpdateDmaBufferHalf(uint8_t half) {
+    if (latchHalves & (1 << half)) {
+        return false;
+    }
+    fillDmaBufferHalf(half);
+    return true;
+}
+
 /*
  * This method is non-blocking unless an existing LED update is in progress.
  * it does not wait until all the LEDs have been updated, that happens in the background.
+ * Only LEDs written since the last call are converted, the strip keeps its colours so nothing is sent when none changed.
  */
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat) {
-    static rgbColor24bpp_t *rgb24;
     // don't wait - risk of infinite block, just get an update next time round
     if (ws2811LedDataTransferInProgress) {
         return;
     }
-    dmaBufferOffset = 0;                // reset buffer memory index
-    ledIndex = 0;                       // reset led index
-    // fill transmit buffer with correct compare values to achieve
-    // correct pulse widths according to color values
-    while (ledIndex < WS2811_LED_STRIP_LENGTH) {
-        rgb24 = hsvToRgb24(&ledColorBuffer[ledIndex]);
-#ifdef USE_FAST_DMA_BUFFER_IMPL
-        fastUpdateLEDDMABuffer(ledFormat, rgb24);
-#else
-        switch (ledFormat) {
-        case LED_RGB: // WS2811 drivers use RGB format
-            updateLEDDMABuffer(rgb24->rgb.r);
-            updateLEDDMABuffer(rgb24->rgb.g);
-            break;
-        case LED_GRB: // WS2812 drivers use GRB format
-        default:
-            updateLEDDMABuffer(rgb24->rgb.g);
-            updateLEDDMABuffer(rgb24->rgb.r);
-            break;
+    bool changed = !ledStripSent || ledFormat != ledStripFormat;
+    while (ledDirty) {
+        const int index = __builtin_ctz(ledDirty);
+        ledDirty &= ledDirty - 1;
+        const rgbColor24bpp_t *rgb24 = hsvToRgb24(&ledColorBuffer[index]);
+        if (memcmp(&ledRgbBuffer[index], rgb24, sizeof(*rgb24))) {
+            ledRgbBuffer[index] = *rgb24;
+            changed = true;
         }
-        updateLEDDMABuffer(rgb24->rgb.b);
-#endif
-        ledIndex++;
     }
+    if (!changed) {
+        return;
+    }
+    ledStripFormat = ledFormat;
+    ledStripSent = true;
+    ledIndex = 0;                       // reset led index
+    latchHalves = 0;
+    // fill both halves with compare values to achieve correct pulse widths according to color values,
+    // the rest is expanded from the DMA interrupt while the strip is being sent
+    fillDmaBufferHalf(0);
+    fillDmaBufferHalf(1);
     ws2811LedDataTransferInProgress = 1;
     ws2811LedStripDMAEnable();
 }
@@ -28,9 +28,11 @@
 // for 50us delay
 #define WS2811_DELAY_BUFFER_LENGTH 42
 
-#define WS2811_DATA_BUFFER_SIZE    (WS2811_BITS_PER_LED * WS2811_LED_STRIP_LENGTH)
-// number of bytes needed is #LEDs * 24 bytes + 42 trailing bytes)
-#define WS2811_DMA_BUFFER_SIZE     (WS2811_DATA_BUFFER_SIZE + WS2811_DELAY_BUFFER_LENGTH)
+// The DMA runs circular over two halves of a small ring, the interrupt of each finished half expands the
+// next LEDs into it while the other half goes out. A half must also cover the latch delay on its own.
+#define WS2811_DMA_LEDS_PER_HALF   2
+#define WS2811_DMA_HALF_SIZE       (WS2811_BITS_PER_LED * WS2811_DMA_LEDS_PER_HALF)
+#define WS2811_DMA_BUFFER_SIZE     (2 * WS2811_DMA_HALF_SIZE)
 
 #define WS2811_TIMER_MHZ           48
 #define WS2811_CARRIER_HZ          800000
@@ -52,6 +54,7 @@ void setStripColor(const hsvColor_t *color);
 void setStripColors(const hsvColor_t *colors);
 
 bool isWS2811LedStripReady(void);
+bool ws2811UpdateDmaBufferHalf(uint8_t half);
 
 #if defined(STM32F1) || defined(STM32F3)
 extern uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
@@ -26,6 +26,7 @@
 #ifdef USE_LED_STRIP
 
 #include "common/color.h"
+#include "common/utils.h"
 #include "light_ws2811strip.h"
 #include "drivers/nvic.h"
 #include "dma.h"
@@ -40,10 +41,30 @@ bool ws2811Initialised = false;
 static TIM_HandleTypeDef TimHandle;
 static uint16_t timerChannel = 0;
 
+// only set so HAL_DMA_Start_IT enables the half transfer interrupt, the halves are refilled from the irq handler
+static void ws2811HalfTransferCallback(DMA_HandleTypeDef *hdma) {
+    UNUSED(hdma);
+}
+
 void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor) {
-    HAL_DMA_IRQHandler(TimHandle.hdma[descriptor->userParam]);
-    TIM_DMACmd(&TimHandle, timerChannel, DISABLE);
-    ws2811LedDataTransferInProgress = 0;
+    DMA_HandleTypeDef *hdma = TimHandle.hdma[descriptor->userParam];
+    // look before the HAL clears the flags
+    const bool firstHalfDone = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF);
+    const bool secondHalfDone = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF);
+    HAL_DMA_IRQHandler(hdma);
+    bool more = true;
+    if (firstHalfDone) {
+        more = ws2811UpdateDmaBufferHalf(0);
+    }
+    if (more && secondHalfDone) {
+        more = ws2811UpdateDmaBufferHalf(1);
+    }
+    if (!more) {
+        TIM_DMACmd(&TimHandle, timerChannel, DISABLE);
+        HAL_DMA_Abort(hdma);
+        TimHandle.State = HAL_TIM_STATE_READY;
+        ws2811LedDataTransferInProgress = 0;
+    }
 }
 
 void ws2811LedStripHardwareInit(ioTag_t ioTag) {
@@ -82,7 +103,7 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag) {
     hdma_tim.Init.MemInc = DMA_MINC_ENABLE;
     hdma_tim.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
     hdma_tim.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
-    hdma_tim.Init.Mode = DMA_NORMAL;
+    hdma_tim.Init.Mode = DMA_CIRCULAR;
     hdma_tim.Init.Priority = DMA_PRIORITY_HIGH;
     hdma_tim.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
     hdma_tim.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
@@ -91,6 +112,7 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag) {
     /* Set hdma_tim instance */
     hdma_tim.Instance = timerHardware->dmaRef;
     uint16_t dmaIndex = timerDmaIndex(timerChannel);
+    hdma_tim.XferHalfCpltCallback = ws2811HalfTransferCallback;
     /* Link hdma_tim to hdma[x] (channelx) */
     __HAL_LINKDMA(&TimHandle, hdma[dmaIndex], hdma_tim);
     dmaInit(timerHardware->dmaIrqHandler, OWNER_LED_STRIP, 0);
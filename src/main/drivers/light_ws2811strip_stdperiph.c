@@ -48,10 +48,19 @@ static DMA_Channel_TypeDef *dmaRef = NULL;
 static TIM_TypeDef *timer = NULL;
 
 static void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor) {
-    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
-        ws2811LedDataTransferInProgress = 0;
-        DMA_Cmd(descriptor->ref, DISABLE);
+    bool more = true;
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        more = ws2811UpdateDmaBufferHalf(0);
+    }
+    if (more && DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        more = ws2811UpdateDmaBufferHalf(1);
+    }
+    if (!more) {
+        DMA_Cmd(descriptor->ref, DISABLE);
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF | DMA_IT_TCIF);
+        ws2811LedDataTransferInProgress = 0;
     }
 }
 
@@ -139,10 +148,10 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag) {
     DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
 #endif
-    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
     DMA_Init(dmaRef, &DMA_InitStructure);
     TIM_DMACmd(timer, timerDmaSource(timerHardware->channel), ENABLE);
-    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    DMA_ITConfig(dmaRef, DMA_IT_HT | DMA_IT_TC, ENABLE);
     ws2811Initialised = true;
 }
 
@@ -175,15 +175,15 @@
 // On shared SPI buss we want to change clock for OSD chip and restore for other devices.
 
 #ifdef MAX7456_SPI_CLK
-#define __spiBusTransactionBegin(busdev)        {spiSetDivisor((busdev)->busdev_u.spi.instance, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
+#define __spiBusTransactionBegin(busdev)        {spiBusAcquire(busdev);spiSetDivisor((busdev)->busdev_u.spi.instance, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
 #else
-#define __spiBusTransactionBegin(busdev)        IOLo((busdev)->busdev_u.spi.csnPin)
+#define __spiBusTransactionBegin(busdev)        {spiBusAcquire(busdev);IOLo((busdev)->busdev_u.spi.csnPin);}
 #endif
 
 #ifdef MAX7456_RESTORE_CLK
-#define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);}
+#define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);spiBusRelease(busdev);}
 #else
-#define __spiBusTransactionEnd(busdev)       IOHi((busdev)->busdev_u.spi.csnPin)
+#define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiBusRelease(busdev);}
 #endif
 
 #ifndef MAX7456_SPI_CLK
@@ -204,6 +204,11 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 static uint8_t screenBuffer[VIDEO_BUFFER_CHARS_PAL + 40]; // For faster writes we use memcpy so we need some space to don't overwrite buffer
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Rows of screenBuffer that changed since they were last compared with shadowBuffer
+static uint32_t dirtyRows;
+#define ROW_BIT(pos)        (1U << ((pos) / CHARS_PER_LINE))
+#define ALL_ROWS            ((1U << VIDEO_LINES_PAL) - 1)
+
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
@@ -211,7 +216,11 @@ static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 volatile bool dmaTransactionInProgress = false;
 #endif
 
-static uint8_t spiBuff[MAX_CHARS2UPDATE * 6];
+static DMA_RAM uint8_t spiBuff[MAX_CHARS2UPDATE * 6];
+
+// Changed characters next to each other are sent in auto-increment mode, which costs 10 bytes of setup and
+// 2 bytes per character instead of 6 bytes per character. Shorter runs are cheaper addressed one by one.
+#define MAX7456_RUN_MIN_LENGTH  3
 
 static uint8_t  videoSignalCfg;
 static uint8_t  videoSignalReg  = OSD_ENABLE; // OSD_ENABLE required to trigger first ReInit
@@ -356,6 +365,7 @@ void max7456ReInit(void) {
         }
         break;
     }
+    __spiBusTransactionEnd(busdev);
     if (videoSignalReg & VIDEO_MODE_PAL) { //PAL
         maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
     } else {              // NTSC
@@ -373,6 +383,7 @@ void max7456ReInit(void) {
     __spiBusTransactionEnd(busdev);
     // Clear shadow to force redraw all screen in non-dma mode.
     memset(shadowBuffer, 0, maxScreenSize);
+    dirtyRows = ALL_ROWS;
     if (firstInit) {
         max7456DrawScreenSlow();
         firstInit = false;
@@ -473,20 +484,32 @@ void max7456Brightness(uint8_t black, uint8_t white) {
 //just fill with spaces with some tricks
 void max7456ClearScreen(void) {
     memset(screenBuffer, 0x20, VIDEO_BUFFER_CHARS_PAL);
+    dirtyRows = ALL_ROWS;
 }
 
 uint8_t* max7456GetScreenBuffer(void) {
+    // The caller may write anywhere
+    dirtyRows = ALL_ROWS;
     return screenBuffer;
 }
 
+static void max7456SetChar(int pos, uint8_t c) {
+    if (screenBuffer[pos] != c) {
+        screenBuffer[pos] = c;
+        if (pos < VIDEO_BUFFER_CHARS_PAL) {
+            dirtyRows |= ROW_BIT(pos);
+        }
+    }
+}
+
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c) {
-    screenBuffer[y * CHARS_PER_LINE + x] = c;
+    max7456SetChar(y * CHARS_PER_LINE + x, c);
 }
 
 void max7456Write(uint8_t x, uint8_t y, const char *buff) {
     for (int i = 0; * (buff + i); i++) {
         if (x + i < CHARS_PER_LINE) { // Do not write over screen
-            screenBuffer[y * CHARS_PER_LINE + x + i] = *(buff + i);
+            max7456SetChar(y * CHARS_PER_LINE + x + i, *(buff + i));
         }
     }
 }
@@ -500,8 +523,8 @@ bool max7456DmaInProgress(void) {
 }
 
 bool max7456BuffersSynced(void) {
-    for (int i = 0; i < maxScreenSize; i++) {
-        if (screenBuffer[i] != shadowBuffer[i]) {
+    for (int i = 0; i < maxScreenSize; i += CHARS_PER_LINE) {
+        if ((dirtyRows & ROW_BIT(i)) && memcmp(&screenBuffer[i], &shadowBuffer[i], CHARS_PER_LINE)) {
             return false;
         }
     }
@@ -548,6 +571,40 @@ void max7456ReInitIfRequired(void) {
     //------------   end of (re)init-------------------------------------
 }
 
+// Encode screenBuffer[start, start + length) into buf and return the number of bytes used
+static int max7456EncodeRun(uint8_t *buf, uint16_t start, int length) {
+    int len = 0;
+    if (length < MAX7456_RUN_MIN_LENGTH) {
+        for (uint16_t pos = start; pos < start + length; pos++) {
+            buf[len++] = MAX7456ADD_DMAH;
+            buf[len++] = pos >> 8;
+            buf[len++] = MAX7456ADD_DMAL;
+            buf[len++] = pos & 0xff;
+            buf[len++] = MAX7456ADD_DMDI;
+            buf[len++] = screenBuffer[pos];
+            shadowBuffer[pos] = screenBuffer[pos];
+        }
+        return len;
+    }
+    buf[len++] = MAX7456ADD_DMAH;
+    buf[len++] = start >> 8;
+    buf[len++] = MAX7456ADD_DMAL;
+    buf[len++] = start & 0xff;
+    // The run never contains END_STRING, which would end auto-increment mode early
+    buf[len++] = MAX7456ADD_DMM;
+    buf[len++] = displayMemoryModeReg | 1;
+    for (int i = 0; i < length; i++) {
+        buf[len++] = MAX7456ADD_DMDI;
+        buf[len++] = screenBuffer[start + i];
+        shadowBuffer[start + i] = screenBuffer[start + i];
+    }
+    buf[len++] = MAX7456ADD_DMDI;
+    buf[len++] = END_STRING;
+    buf[len++] = MAX7456ADD_DMM;
+    buf[len++] = displayMemoryModeReg;
+    return len;
+}
+
 void max7456DrawScreen(void) {
     static uint16_t pos = 0;
     if (!max7456Lock && !fontIsLoading) {
@@ -557,21 +614,42 @@ void max7456DrawScreen(void) {
         max7456ReInitIfRequired();
 #endif
         int buff_len = 0;
+        uint16_t runStart = 0;
+        int runLength = 0;
         for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
+            if (pos % CHARS_PER_LINE == 0) {
+                // Only rows that changed since they were last compared need comparing again
+                while (pos < maxScreenSize && !(dirtyRows & ROW_BIT(pos))) {
+                    pos += CHARS_PER_LINE;
+                }
+                if (pos >= maxScreenSize) {
+                    pos = 0;
+                    break;
+                }
+                dirtyRows &= ~ROW_BIT(pos);
+            }
             if (screenBuffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = screenBuffer[pos];
-                shadowBuffer[pos] = screenBuffer[pos];
+                if (runLength && (pos != runStart + runLength || screenBuffer[pos] == END_STRING)) {
+                    buff_len += max7456EncodeRun(spiBuff + buff_len, runStart, runLength);
+                    runLength = 0;
+                }
+                if (!runLength) {
+                    runStart = pos;
+                }
+                runLength++;
+                if (screenBuffer[pos] == END_STRING) {
+                    buff_len += max7456EncodeRun(spiBuff + buff_len, runStart, runLength);
+                    runLength = 0;
+                }
             }
             if (++pos >= maxScreenSize) {
                 pos = 0;
                 break;
             }
         }
+        if (runLength) {
+            buff_len += max7456EncodeRun(spiBuff + buff_len, runStart, runLength);
+        }
         if (buff_len) {
 #ifdef MAX7456_DMA_CHANNEL_TX
             max7456SendDma(spiBuff, NULL, buff_len);
@@ -611,6 +689,7 @@ static void max7456DrawScreenSlow(void) {
     }
     max7456Send(MAX7456ADD_DMDI, END_STRING);
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg);
+    dirtyRows = 0;
     // If we found any of the "escape" character 0xFF, then make a second pass
     // to update them with direct addressing
     if (escapeCharFound) {
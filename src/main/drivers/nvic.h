@@ -33,9 +33,14 @@
 #else
 #define NVIC_PRIO_MPU_INT_EXTI             NVIC_BUILD_PRIORITY(0x00, 0x02)
 #endif
+#elif defined(USE_GYRO_PID_INTERRUPT)
+// the gyro stage has to be able to preempt the pid software interrupt
+#define NVIC_PRIO_MPU_INT_EXTI             NVIC_BUILD_PRIORITY(0x02, 0x00)
 #else
 #define NVIC_PRIO_MPU_INT_EXTI             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #endif //USE_DMA_SPI_DEVICE
+#define NVIC_PRIO_SPI_DMA                  NVIC_PRIO_MPU_INT_EXTI
+#define NVIC_PRIO_PID_SWI                  NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_MAG_INT_EXTI             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_WS2811_DMA               NVIC_BUILD_PRIORITY(1, 2)  // TODO - is there some reason to use high priority? (or to use DMA IRQ at all?)
 #define NVIC_PRIO_SERIALUART_TXDMA         NVIC_BUILD_PRIORITY(1, 1)  // Highest of all SERIALUARTx_TXDMA
@@ -24,6 +24,13 @@
 #include <math.h>
 
 #include "platform.h"
+
+#include "build/atomic.h"
+#include "build/debug.h"
+
+#include "common/utils.h"
+
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "pg/pinio.h"
@@ -43,20 +50,35 @@ static FAST_RAM_ZERO_INIT pwmCompleteWriteFn *pwmCompleteWrite = NULL;
 
 #ifdef USE_DSHOT
 FAST_RAM_ZERO_INIT loadDmaBufferFn *loadDmaBuffer;
+#ifdef USE_DSHOT_DMAR
+FAST_RAM_ZERO_INIT loadDmaBurstBufferFn *loadDmaBurstBuffer;
+#endif
 #define DSHOT_INITIAL_DELAY_US 10000
 #define DSHOT_COMMAND_DELAY_US 1000
 #define DSHOT_ESCINFO_DELAY_US 12000
 #define DSHOT_BEEP_DELAY_US 100000
 
+#define DSHOT_COMMAND_QUEUE_SIZE 4 // one slot is kept free to tell a full queue from an empty one
+
 typedef struct dshotCommandControl_s {
-    timeUs_t nextCommandAtUs;
     timeUs_t delayAfterCommandUs;
-    bool waitingForIdle;
     uint8_t repeats;
     uint8_t command[MAX_SUPPORTED_MOTORS];
 } dshotCommandControl_t;
 
-static dshotCommandControl_t dshotCommandControl;
+// Filled by pwmWriteDshotCommand() and drained by the motor update, which may run from the gyro / pid
+// interrupt. Only the writer moves tail and only the motor update moves head, so neither has to lock.
+typedef struct dshotCommandQueue_s {
+    dshotCommandControl_t commands[DSHOT_COMMAND_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    // state of the command at head
+    bool started;
+    bool waitingForIdle;
+    timeUs_t nextCommandAtUs;
+} dshotCommandQueue_t;
+
+static dshotCommandQueue_t dshotCommandQueue;
 #endif
 
 #ifdef USE_SERVOS
@@ -73,6 +95,10 @@ static bool isDshot = false;
 #ifdef USE_DSHOT_DMAR
 FAST_RAM_ZERO_INIT bool useBurstDshot = false;
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT bool useDshotTelemetry = false;
+FAST_RAM_ZERO_INIT bool useDshotEdt = false;
+#endif
 
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output) {
 #if defined(USE_HAL_DRIVER)
@@ -156,10 +182,25 @@ static FAST_CODE void pwmWriteDshot(uint8_t index, float value) {
     pwmWriteDshotInt(index, lrintf(value));
 }
 
+#define DSHOT_BIT(nibble, bit) (((nibble) & (8 >> (bit))) ? MOTOR_BIT_1 : MOTOR_BIT_0)
+#define DSHOT_NIBBLE(nibble) { DSHOT_BIT(nibble, 0), DSHOT_BIT(nibble, 1), DSHOT_BIT(nibble, 2), DSHOT_BIT(nibble, 3) }
+
+// compare values for the four bits of a nibble, MSB first
+static const uint32_t dshotNibbleSymbols[16][4] = {
+    DSHOT_NIBBLE(0),  DSHOT_NIBBLE(1),  DSHOT_NIBBLE(2),  DSHOT_NIBBLE(3),
+    DSHOT_NIBBLE(4),  DSHOT_NIBBLE(5),  DSHOT_NIBBLE(6),  DSHOT_NIBBLE(7),
+    DSHOT_NIBBLE(8),  DSHOT_NIBBLE(9),  DSHOT_NIBBLE(10), DSHOT_NIBBLE(11),
+    DSHOT_NIBBLE(12), DSHOT_NIBBLE(13), DSHOT_NIBBLE(14), DSHOT_NIBBLE(15),
+};
+
 static FAST_CODE uint8_t loadDmaBufferDshot(uint32_t *dmaBuffer, int stride, uint16_t packet) {
-    for (int i = 0; i < 16; i++) {
-        dmaBuffer[i * stride] = (packet & 0x8000) ? MOTOR_BIT_1 : MOTOR_BIT_0;  // MSB first
-        packet <<= 1;
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        const uint32_t *symbols = dshotNibbleSymbols[(packet >> shift) & 0xf];  // MSB first
+        dmaBuffer[0] = symbols[0];
+        dmaBuffer[stride] = symbols[1];
+        dmaBuffer[2 * stride] = symbols[2];
+        dmaBuffer[3 * stride] = symbols[3];
+        dmaBuffer += 4 * stride;
     }
     return DSHOT_DMA_BUFFER_SIZE;
 }
@@ -171,6 +212,128 @@ FAST_CODE static uint8_t loadDmaBufferProshot(uint32_t *dmaBuffer, int stride, u
     }
     return PROSHOT_DMA_BUFFER_SIZE;
 }
+
+#ifdef USE_DSHOT_DMAR
+// Fills the CCR1..CCR4 rows in the order the burst reads them, channels without a motor stay at 0
+static FAST_CODE uint8_t loadDmaBurstBufferDshot(uint32_t *dmaBurstBuffer, const uint16_t *packets, uint8_t channels) {
+    static const uint32_t noSymbols[4] = { 0 };
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        const uint32_t *symbols[4];
+        for (int channel = 0; channel < 4; channel++) {
+            symbols[channel] = (channels & (1 << channel)) ? dshotNibbleSymbols[(packets[channel] >> shift) & 0xf] : noSymbols;
+        }
+        for (int bit = 0; bit < 4; bit++) {
+            dmaBurstBuffer[0] = symbols[0][bit];
+            dmaBurstBuffer[1] = symbols[1][bit];
+            dmaBurstBuffer[2] = symbols[2][bit];
+            dmaBurstBuffer[3] = symbols[3][bit];
+            dmaBurstBuffer += 4;
+        }
+    }
+    return DSHOT_DMA_BUFFER_SIZE;
+}
+
+FAST_CODE static uint8_t loadDmaBurstBufferProshot(uint32_t *dmaBurstBuffer, const uint16_t *packets, uint8_t channels) {
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        for (int channel = 0; channel < 4; channel++) {
+            *dmaBurstBuffer++ = (channels & (1 << channel)) ? PROSHOT_BASE_SYMBOL + ((packets[channel] >> shift) & 0xf) * PROSHOT_BIT_WIDTH : 0;
+        }
+    }
+    return PROSHOT_DMA_BUFFER_SIZE;
+}
+#endif
+
+#ifdef USE_DSHOT_BURST_SYNC
+FAST_RAM_ZERO_INIT bool useBurstDshotSync = false;
+static FAST_RAM_ZERO_INIT TIM_TypeDef *dshotSyncMaster;
+
+#ifdef TIM8
+#define TIM8_TRIGGER TIM8
+#else
+#define TIM8_TRIGGER NULL
+#endif
+
+// internal trigger inputs ITR0..ITR3 of the slave mode controller, RM0090 / RM0410 TIMx internal trigger connection tables
+typedef struct timerTriggerMap_s {
+    TIM_TypeDef *slave;
+    TIM_TypeDef *itr[4];
+} timerTriggerMap_t;
+
+static const timerTriggerMap_t timerTriggerMap[] = {
+    { TIM1, { TIM5, TIM2, TIM3, TIM4 } },
+    { TIM2, { TIM1, TIM8_TRIGGER, TIM3, TIM4 } },
+    { TIM3, { TIM1, TIM2, TIM5, TIM4 } },
+    { TIM4, { TIM1, TIM2, TIM3, TIM8_TRIGGER } },
+    { TIM5, { TIM2, TIM3, TIM4, TIM8_TRIGGER } },
+#ifdef TIM8
+    { TIM8, { TIM1, TIM2, TIM4, TIM5 } },
+#endif
+};
+
+static int timerTriggerInput(const TIM_TypeDef *slave, const TIM_TypeDef *master) {
+    for (unsigned i = 0; i < ARRAYLEN(timerTriggerMap); i++) {
+        if (timerTriggerMap[i].slave != slave) {
+            continue;
+        }
+        for (int itr = 0; itr < 4; itr++) {
+            if (timerTriggerMap[i].itr[itr] == master) {
+                return itr;
+            }
+        }
+    }
+    return -1;
+}
+
+bool pwmDshotBurstSyncInit(motorDmaTimer_t *timers, uint8_t timerCount) {
+    if (timerCount < 2) {
+        return false;
+    }
+    // the master is the motor timer whose trigger output reaches the most of the others
+    int masterIndex = 0;
+    int masterReach = -1;
+    for (int i = 0; i < timerCount; i++) {
+        int reach = 0;
+        for (int j = 0; j < timerCount; j++) {
+            if (j != i && timerTriggerInput(timers[j].timer, timers[i].timer) >= 0) {
+                reach++;
+            }
+        }
+        if (reach > masterReach) {
+            masterIndex = i;
+            masterReach = reach;
+        }
+    }
+    dshotSyncMaster = timers[masterIndex].timer;
+    // TRGO follows the counter enable of the master
+    dshotSyncMaster->CR2 = (dshotSyncMaster->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_0;
+    for (int i = 0; i < timerCount; i++) {
+        const int itr = (i == masterIndex) ? -1 : timerTriggerInput(timers[i].timer, dshotSyncMaster);
+        timers[i].dmaBurstSyncSlave = (itr >= 0);
+        if (itr >= 0) {
+            // trigger mode, the counter is enabled on the rising edge of the selected ITR
+            timers[i].timer->SMCR = (timers[i].timer->SMCR & ~(TIM_SMCR_TS | TIM_SMCR_SMS)) | (itr * TIM_SMCR_TS_0) | TIM_SMCR_SMS_2 | TIM_SMCR_SMS_1;
+        }
+    }
+    return true;
+}
+
+FAST_CODE void pwmDshotBurstSyncStop(TIM_TypeDef *timer) {
+    timer->CR1 &= ~TIM_CR1_CEN;
+    timer->CNT = 0;
+}
+
+FAST_CODE void pwmDshotBurstSyncStart(const motorDmaTimer_t *timers, uint8_t timerCount) {
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        // timers without an internal trigger from the master are started in software just ahead of it
+        for (int i = 0; i < timerCount; i++) {
+            if (!timers[i].dmaBurstSyncSlave && timers[i].timer != dshotSyncMaster) {
+                timers[i].timer->CR1 |= TIM_CR1_CEN;
+            }
+        }
+        dshotSyncMaster->CR1 |= TIM_CR1_CEN;
+    }
+}
+#endif
 #endif
 
 FAST_CODE void pwmWriteMotor(uint8_t index, float value) {
@@ -253,6 +416,9 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
     case PWM_TYPE_PROSHOT1000:
         pwmWrite = &pwmWriteDshot;
         loadDmaBuffer = &loadDmaBufferProshot;
+#ifdef USE_DSHOT_DMAR
+        loadDmaBurstBuffer = &loadDmaBurstBufferProshot;
+#endif
         pwmCompleteWrite = &pwmCompleteDshotMotorUpdate;
         isDshot = true;
         break;
@@ -264,10 +430,22 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
     case PWM_TYPE_DSHOT150:
         pwmWrite = &pwmWriteDshot;
         loadDmaBuffer = &loadDmaBufferDshot;
+#ifdef USE_DSHOT_DMAR
+        loadDmaBurstBuffer = &loadDmaBurstBufferDshot;
+#endif
         pwmCompleteWrite = &pwmCompleteDshotMotorUpdate;
         isDshot = true;
+#ifdef USE_DSHOT_TELEMETRY
+        useDshotTelemetry = motorConfig->useDshotTelemetry;
+        useDshotEdt = useDshotTelemetry && motorConfig->useDshotEdt;
+#endif
 #ifdef USE_DSHOT_DMAR
-        if (motorConfig->useBurstDshot) {
+        // the timer update DMA request can not be shared with input capture, so burst is unavailable in bidirectional mode
+        if (motorConfig->useBurstDshot
+#ifdef USE_DSHOT_TELEMETRY
+                && !useDshotTelemetry
+#endif
+           ) {
             useBurstDshot = true;
         }
 #endif
@@ -331,6 +509,11 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
         motors[motorIndex].forceOverflow = !timerAlreadyUsed;
         motors[motorIndex].enabled = true;
     }
+#ifdef USE_DSHOT_BURST_SYNC
+    if (useBurstDshot && motorConfig->useBurstDshotSync) {
+        pwmDshotBurstSyncConfig();
+    }
+#endif
     pwmMotorsEnabled = true;
 }
 
@@ -374,17 +557,31 @@ bool allMotorsAreIdle(uint8_t motorCount) {
     return allMotorsIdle;
 }
 
+static uint8_t dshotCommandQueueNext(uint8_t index) {
+    return (index + 1) % DSHOT_COMMAND_QUEUE_SIZE;
+}
+
 FAST_CODE bool pwmDshotCommandIsQueued(void) {
-    return dshotCommandControl.nextCommandAtUs;
+    return dshotCommandQueue.head != dshotCommandQueue.tail;
 }
 
 FAST_CODE bool pwmDshotCommandIsProcessing(void) {
-    return dshotCommandControl.nextCommandAtUs && !dshotCommandControl.waitingForIdle && dshotCommandControl.repeats > 0;
+    return pwmDshotCommandIsQueued() && dshotCommandQueue.started && !dshotCommandQueue.waitingForIdle
+           && dshotCommandQueue.commands[dshotCommandQueue.head].repeats > 0;
+}
+
+static bool dshotCommandIsPending(const dshotCommandControl_t *command) {
+    for (uint8_t i = dshotCommandQueue.head; i != dshotCommandQueue.tail; i = dshotCommandQueueNext(i)) {
+        const dshotCommandControl_t *pending = &dshotCommandQueue.commands[i];
+        if (!memcmp(pending->command, command->command, sizeof(command->command))) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking) {
-    timeUs_t timeNowUs = micros();
-    if (!isMotorProtocolDshot() || (command > DSHOT_MAX_COMMAND) || pwmDshotCommandIsQueued()) {
+    if (!isMotorProtocolDshot() || (command > DSHOT_MAX_COMMAND)) {
         return;
     }
     uint8_t repeats = 1;
@@ -395,6 +592,8 @@ void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bo
     case DSHOT_CMD_3D_MODE_OFF:
     case DSHOT_CMD_3D_MODE_ON:
     case DSHOT_CMD_SAVE_SETTINGS:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE:
     case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
     case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
         repeats = 10;
@@ -410,9 +609,19 @@ void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bo
         break;
     }
     if (blocking) {
+        // only used from the cli with the motors stopped, it would fight the motor update over a queued command
+        if (pwmDshotCommandIsQueued()) {
+            return;
+        }
         delayMicroseconds(DSHOT_INITIAL_DELAY_US - DSHOT_COMMAND_DELAY_US);
         for (; repeats; repeats--) {
             delayMicroseconds(DSHOT_COMMAND_DELAY_US);
+#ifdef USE_DSHOT_TELEMETRY
+            // wait for any pending telemetry frame so the motor pins are back in output mode
+            const timeUs_t startTimeUs = micros();
+            while (!pwmStartDshotMotorUpdate(motorCount) && cmpTimeUs(micros(), startTimeUs) < DSHOT_COMMAND_DELAY_US) {
+            }
+#endif
             for (uint8_t i = 0; i < motorCount; i++) {
                 if ((i == index) || (index == ALL_MOTORS)) {
                     motorDmaOutput_t *const motor = getMotorDmaOutput(i);
@@ -424,48 +633,66 @@ void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bo
         }
         delayMicroseconds(delayAfterCommandUs);
     } else {
-        dshotCommandControl.repeats = repeats;
-        dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
-        dshotCommandControl.delayAfterCommandUs = delayAfterCommandUs;
-        for (unsigned i = 0; i < motorCount; i++) {
-            if (index == i || index == ALL_MOTORS) {
-                dshotCommandControl.command[i] = command;
+        const uint8_t tail = dshotCommandQueue.tail;
+        const uint8_t nextTail = dshotCommandQueueNext(tail);
+        if (nextTail == dshotCommandQueue.head) {
+            return; // queue full, drop the command
+        }
+        dshotCommandControl_t *const queued = &dshotCommandQueue.commands[tail];
+        queued->repeats = repeats;
+        queued->delayAfterCommandUs = delayAfterCommandUs;
+        for (unsigned i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+            if (i < motorCount && (index == i || index == ALL_MOTORS)) {
+                queued->command[i] = command;
             } else {
-                dshotCommandControl.command[i] = DSHOT_CMD_MOTOR_STOP;
+                queued->command[i] = DSHOT_CMD_MOTOR_STOP;
             }
         }
-        dshotCommandControl.waitingForIdle = !allMotorsAreIdle(motorCount);
+        if (dshotCommandIsPending(queued)) {
+            return; // e.g. a beacon asked for again before the last one went out
+        }
+        asm volatile ("": : :"memory"); // compiler memory barrier, publish the entry before the tail
+        dshotCommandQueue.tail = nextTail;
     }
 }
 
 uint8_t pwmGetDshotCommand(uint8_t index) {
-    return dshotCommandControl.command[index];
+    return dshotCommandQueue.commands[dshotCommandQueue.head].command[index];
 }
 
 FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount) {
     timeUs_t timeNowUs = micros();
-    if (dshotCommandControl.waitingForIdle) {
+    dshotCommandControl_t *const command = &dshotCommandQueue.commands[dshotCommandQueue.head];
+    if (!dshotCommandQueue.started) {
+        // every command gets the same lead in it had when only one could be pending
+        dshotCommandQueue.started = true;
+        dshotCommandQueue.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
+        dshotCommandQueue.waitingForIdle = !allMotorsAreIdle(motorCount);
+    }
+    if (dshotCommandQueue.waitingForIdle) {
         if (allMotorsAreIdle(motorCount)) {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
-            dshotCommandControl.waitingForIdle = false;
+            dshotCommandQueue.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
+            dshotCommandQueue.waitingForIdle = false;
         }
         // Send normal motor output while waiting for motors to go idle
         return true;
     }
-    if (cmpTimeUs(timeNowUs, dshotCommandControl.nextCommandAtUs) < 0) {
+    if (cmpTimeUs(timeNowUs, dshotCommandQueue.nextCommandAtUs) < 0) {
         //Skip motor update because it isn't time yet for a new command
         return false;
     }
     //Timed motor update happening with dshot command
-    if (dshotCommandControl.repeats > 0) {
-        dshotCommandControl.repeats--;
-        if (dshotCommandControl.repeats > 0) {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_COMMAND_DELAY_US;
+    if (command->repeats > 0) {
+        command->repeats--;
+        if (command->repeats > 0) {
+            dshotCommandQueue.nextCommandAtUs = timeNowUs + DSHOT_COMMAND_DELAY_US;
         } else {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + dshotCommandControl.delayAfterCommandUs;
+            dshotCommandQueue.nextCommandAtUs = timeNowUs + command->delayAfterCommandUs;
         }
     } else {
-        dshotCommandControl.nextCommandAtUs = 0;
+        // done, the next queued command starts on the following motor update
+        dshotCommandQueue.started = false;
+        dshotCommandQueue.head = dshotCommandQueueNext(dshotCommandQueue.head);
     }
     return true;
 }
@@ -480,11 +707,107 @@ FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor) {
         csum ^=  csum_data;   // xor data by nibbles
         csum_data >>= 4;
     }
+#ifdef USE_DSHOT_TELEMETRY
+    // an inverted checksum tells the ESC to answer with a GCR telemetry frame on the same wire
+    if (useDshotTelemetry) {
+        csum = ~csum;
+    }
+#endif
     csum &= 0xf;
     // append checksum
     packet = (packet << 4) | csum;
     return packet;
 }
+
+#ifdef USE_DSHOT_TELEMETRY
+// Decodes the captured edge timestamps of a GCR telemetry frame into its 12 bit value, returns DSHOT_TELEMETRY_INVALID on error
+FAST_CODE uint16_t decodeDshotTelemetryPacket(const uint32_t buffer[], uint32_t count) {
+    static const uint8_t gcrDecode[32] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11, 0, 13, 14, 15,
+        0, 0, 2, 3, 0, 5, 6, 7, 0, 0, 8, 1, 0, 4, 12, 0
+    };
+    uint32_t value = 0;
+    uint32_t oldValue = buffer[0];
+    int bits = 0;
+    int len;
+    for (uint32_t i = 1; i <= count; i++) {
+        if (i < count) {
+            const int diff = buffer[i] - oldValue;
+            if (bits >= 21) {
+                break;
+            }
+            len = (diff + DSHOT_TELEMETRY_BIT_TICKS / 2) / DSHOT_TELEMETRY_BIT_TICKS;
+        } else {
+            // the frame ends high, so the trailing run has no closing edge
+            len = 21 - bits;
+        }
+        if (len <= 0) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        value <<= len;
+        value |= 1 << (len - 1);
+        oldValue = buffer[i];
+        bits += len;
+    }
+    if (bits != 21) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    // every run between two edges starts with a transition, which is a 1 in GCR, so map each quintet back to a nibble
+    uint32_t decodedValue = gcrDecode[value & 0x1f];
+    decodedValue |= gcrDecode[(value >> 5) & 0x1f] << 4;
+    decodedValue |= gcrDecode[(value >> 10) & 0x1f] << 8;
+    decodedValue |= gcrDecode[(value >> 15) & 0x1f] << 12;
+    uint32_t csum = decodedValue;
+    csum = csum ^ (csum >> 8); // xor bytes
+    csum = csum ^ (csum >> 4); // xor nibbles
+    if ((csum & 0xf) != 0xf) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    return decodedValue >> 4;
+}
+
+// Publishes a decoded frame of a motor, eRPM / 100 for the rpm filter or an extended telemetry value for the esc sensor
+FAST_CODE void pwmDshotTelemetryReceived(uint8_t index, uint16_t frame) {
+    motorDmaOutput_t *const motor = getMotorDmaOutput(index);
+    if (useDshotEdt && (frame & 0x0100) == 0 && (frame & 0x0e00) != 0) {
+        // an eRPM frame with a non zero exponent always has the top mantissa bit set, so this one is extended telemetry
+        const uint8_t type = frame >> 9;
+        motor->dshotEdtValue[type] = frame & 0xff;
+        motor->dshotEdtUpdated |= 1 << type;
+        return;
+    }
+    uint16_t value = 0;
+    if (frame != 0x0fff) { // 0x0fff is a stopped motor
+        // 3 bit exponent, 9 bit mantissa of the electrical period in us
+        const uint32_t periodUs = (frame & 0x000001ff) << ((frame & 0xfffffe00) >> 9);
+        if (!periodUs) {
+            return;
+        }
+        value = (1000000 * 60 / 100 + periodUs / 2) / periodUs;
+    }
+    motor->dshotTelemetryValue = value;
+    motor->dshotTelemetryActive = true;
+    if (index < 4) {
+        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, index, value);
+    }
+}
+
+uint16_t getDshotTelemetry(uint8_t index) {
+    return getMotorDmaOutput(index)->dshotTelemetryValue;
+}
+
+bool isDshotTelemetryActive(uint8_t motorCount) {
+    if (!useDshotTelemetry) {
+        return false;
+    }
+    for (unsigned i = 0; i < motorCount; i++) {
+        if (!getMotorDmaOutput(i)->dshotTelemetryActive) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
 #endif
 
 #ifdef USE_SERVOS
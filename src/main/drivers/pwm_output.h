@@ -22,6 +22,8 @@
 
 #include "platform.h"
 
+#include "common/time.h"
+
 #include "drivers/io_types.h"
 #include "drivers/pwm_output_counts.h"
 #include "drivers/timer.h"
@@ -61,6 +63,8 @@ typedef enum {
     DSHOT_CMD_3D_MODE_ON,
     DSHOT_CMD_SETTINGS_REQUEST, // Currently not implemented
     DSHOT_CMD_SAVE_SETTINGS,
+    DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE,
+    DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE,
     DSHOT_CMD_SPIN_DIRECTION_NORMAL = 20,
     DSHOT_CMD_SPIN_DIRECTION_REVERSED = 21,
     DSHOT_CMD_LED0_ON, // BLHeli32 only
@@ -121,6 +125,26 @@ typedef enum {
 #define DSHOT_DMA_BUFFER_SIZE   18 /* resolution + frame reset (2us) */
 #define PROSHOT_DMA_BUFFER_SIZE 6  /* resolution + frame reset (2us) */
 
+#ifdef USE_DSHOT_TELEMETRY
+#define DSHOT_TELEMETRY_INPUT_LEN   22 // 21 GCR bits, each transition is captured as one edge
+#define DSHOT_TELEMETRY_MIN_EDGES   7
+#define DSHOT_TELEMETRY_DEADTIME_US (2 * 30 + 10) // 2 * 30uS to switch lines plus 10us grace period
+#define DSHOT_TELEMETRY_INVALID     0xffff
+#define DSHOT_TELEMETRY_BIT_TICKS   16 // GCR runs at 5/4 of the dshot bitrate, MOTOR_BITLENGTH + 1 = 20 ticks per dshot bit
+
+// Extended telemetry frames carry an 8 bit value, the type sits where an eRPM frame has an even exponent and no leading mantissa bit
+typedef enum {
+    DSHOT_EDT_TEMPERATURE = 1,  // C degrees
+    DSHOT_EDT_VOLTAGE,          // 0.25V
+    DSHOT_EDT_CURRENT,          // A
+    DSHOT_EDT_DEBUG1,
+    DSHOT_EDT_DEBUG2,
+    DSHOT_EDT_STRESS,
+    DSHOT_EDT_STATUS,
+    DSHOT_EDT_COUNT
+} dshotEdtType_e;
+#endif
+
 typedef struct {
     TIM_TypeDef *timer;
 #if defined(USE_DSHOT) && defined(USE_DSHOT_DMAR)
@@ -131,8 +155,16 @@ typedef struct {
 #endif
     uint16_t dmaBurstLength;
     uint32_t dmaBurstBuffer[DSHOT_DMA_BUFFER_SIZE * 4];
+    uint16_t dmaBurstPackets[4];        // latest packet per channel, encoded together before the burst starts
+    uint8_t dmaBurstChannels;           // bitmask of the channels driving motors
+#endif
+#ifdef USE_DSHOT_BURST_SYNC
+    bool dmaBurstSyncSlave;             // counter enabled by the trigger output of the master timer
 #endif
     uint16_t timerDmaSources;
+#ifdef USE_DSHOT_TELEMETRY
+    uint16_t outputPeriod;
+#endif
 } motorDmaTimer_t;
 
 typedef struct {
@@ -145,11 +177,33 @@ typedef struct {
 #endif
     motorDmaTimer_t *timer;
     volatile bool requestTelemetry;
+#ifdef USE_DSHOT_TELEMETRY
+    volatile bool isInput;
+    bool dshotTelemetryActive;
+    uint16_t dshotTelemetryValue;
+    uint8_t dshotEdtValue[DSHOT_EDT_COUNT];
+    volatile uint8_t dshotEdtUpdated;   // bit per dshotEdtType_e, cleared by the reader
+    uint8_t dmaBufferSize;
+    timeDelta_t dshotTelemetryDeadtimeUs;
+#if defined(USE_HAL_DRIVER)
+    uint32_t llChannel;
+    LL_TIM_OC_InitTypeDef ocInitStruct;
+    LL_TIM_IC_InitTypeDef icInitStruct;
+    LL_DMA_InitTypeDef dmaInitStruct;
+#else
+    TIM_OCInitTypeDef ocInitStruct;
+    TIM_ICInitTypeDef icInitStruct;
+    DMA_InitTypeDef dmaInitStruct;
+#endif
+#endif
 #if defined(STM32F3) || defined(STM32F4) || defined(STM32F7)
     uint32_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #else
     uint8_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+    uint32_t dmaInputBuffer[DSHOT_TELEMETRY_INPUT_LEN];
+#endif
 } motorDmaOutput_t;
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index);
@@ -179,10 +233,20 @@ typedef struct motorDevConfig_s {
     uint8_t  motorPwmInversion;             // Active-High vs Active-Low. Useful for brushed FCs converted for brushless operation
     uint8_t  useUnsyncedPwm;
     uint8_t  useBurstDshot;
+    uint8_t  useBurstDshotSync;             // start the bursts of all motor timers from one master timer
+    uint8_t  useDshotTelemetry;
+    uint8_t  useDshotEdt;                   // ask the ESCs for temperature / voltage / current frames in the telemetry stream
     ioTag_t  ioTags[MAX_SUPPORTED_MOTORS];
 } motorDevConfig_t;
 
 extern bool useBurstDshot;
+#ifdef USE_DSHOT_BURST_SYNC
+extern bool useBurstDshotSync;
+#endif
+#ifdef USE_DSHOT_TELEMETRY
+extern bool useDshotTelemetry;
+extern bool useDshotEdt;
+#endif
 
 void motorDevInit(const motorDevConfig_t *motorDevConfig, uint16_t idlePulse, uint8_t motorCount);
 
@@ -204,7 +268,14 @@ typedef uint8_t loadDmaBufferFn(uint32_t *dmaBuffer, int stride, uint16_t packet
 
 uint16_t prepareDshotPacket(motorDmaOutput_t *const motor);
 
+#ifdef USE_DSHOT_DMAR
+typedef uint8_t loadDmaBurstBufferFn(uint32_t *dmaBurstBuffer, const uint16_t *packets, uint8_t channels);  // encodes all channels of a timer, row by row
+#endif
+
 extern loadDmaBufferFn *loadDmaBuffer;
+#ifdef USE_DSHOT_DMAR
+extern loadDmaBurstBufferFn *loadDmaBurstBuffer;
+#endif
 
 uint32_t getDshotHz(motorPwmProtocolTypes_e pwmProtocolType);
 void pwmWriteDshotCommandControl(uint8_t index);
@@ -213,11 +284,26 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value);
 void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t motorIndex, motorPwmProtocolTypes_e pwmProtocolType, uint8_t output);
 void pwmCompleteDshotMotorUpdate(uint8_t motorCount);
 
+#ifdef USE_DSHOT_BURST_SYNC
+void pwmDshotBurstSyncConfig(void);
+bool pwmDshotBurstSyncInit(motorDmaTimer_t *timers, uint8_t timerCount);
+void pwmDshotBurstSyncStop(TIM_TypeDef *timer);
+void pwmDshotBurstSyncStart(const motorDmaTimer_t *timers, uint8_t timerCount);
+#endif
+
 bool pwmDshotCommandIsQueued(void);
 bool pwmDshotCommandIsProcessing(void);
 uint8_t pwmGetDshotCommand(uint8_t index);
 bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount);
 
+#ifdef USE_DSHOT_TELEMETRY
+bool pwmStartDshotMotorUpdate(uint8_t motorCount);
+uint16_t decodeDshotTelemetryPacket(const uint32_t buffer[], uint32_t count);
+void pwmDshotTelemetryReceived(uint8_t index, uint16_t frame);
+uint16_t getDshotTelemetry(uint8_t index);
+bool isDshotTelemetryActive(uint8_t motorCount);
+#endif
+
 #endif
 
 #ifdef USE_BEEPER
@@ -26,8 +26,6 @@
 
 #ifdef USE_DSHOT
 
-#include "build/debug.h"
-
 #include "drivers/io.h"
 #include "timer.h"
 #if defined(STM32F4)
@@ -42,8 +40,11 @@
 #include "rcc.h"
 
 static uint8_t dmaMotorTimerCount = 0;
-static motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
-static motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static DMA_RAM motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
+static DMA_RAM motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+#ifdef USE_DSHOT_TELEMETRY
+static timeUs_t dshotFrameStartUs;
+#endif
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index) {
     return &dmaMotors[index];
@@ -73,20 +74,85 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value) {
     }
     motor->value = value;
     uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
-    } else
+        // encoded together with the other channels of this timer in pwmCompleteDshotMotorUpdate()
+        motor->timer->dmaBurstPackets[timerLookupChannelIndex(motor->timerHardware->channel)] = packet;
+        return;
+    }
 #endif
-    {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
-        motor->timer->timerDmaSources |= motor->timerDmaSource;
-        DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
-        DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+    const uint8_t bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+    motor->timer->timerDmaSources |= motor->timerDmaSource;
+    DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
+    DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+}
+
+#ifdef USE_DSHOT_TELEMETRY
+static void pwmDshotSetDirectionOutput(motorDmaOutput_t * const motor, bool output) {
+    const timerHardware_t * const timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+    DMA_Cmd(dmaRef, DISABLE);
+    DMA_DeInit(dmaRef);
+    motor->isInput = !output;
+    if (output) {
+        TIM_ARRPreloadConfig(timer, ENABLE);
+        timer->ARR = motor->timer->outputPeriod;
+        timerOCInit(timer, timerHardware->channel, &motor->ocInitStruct);
+        timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = motor->dmaBufferSize;
+    } else {
+        // free running counter, the edge timestamps are differenced so only the wrap matters
+        TIM_ARRPreloadConfig(timer, DISABLE);
+        timer->ARR = 0xffffffff;
+        timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Disable);
+        TIM_ICInit(timer, &motor->icInitStruct);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaInputBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = DSHOT_TELEMETRY_INPUT_LEN;
+    }
+    DMA_Init(dmaRef, &motor->dmaInitStruct);
+    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+}
+
+FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(uint8_t motorCount) {
+    if (!useDshotTelemetry) {
+        return true;
+    }
+    const timeDelta_t usSinceFrameStart = cmpTimeUs(micros(), dshotFrameStartUs);
+    for (int i = 0; i < motorCount; i++) {
+        if (dmaMotors[i].configured && usSinceFrameStart >= 0 && usSinceFrameStart < dmaMotors[i].dshotTelemetryDeadtimeUs) {
+            // the ESC may still be answering, switching the pin back now would collide with its frame
+            return false;
+        }
     }
+    for (int i = 0; i < motorCount; i++) {
+        motorDmaOutput_t * const motor = &dmaMotors[i];
+        if (!motor->configured || !motor->isInput) {
+            continue;
+        }
+        const uint32_t edges = DSHOT_TELEMETRY_INPUT_LEN - DMA_GetCurrDataCounter(motor->timerHardware->dmaRef);
+        TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
+        uint16_t value = DSHOT_TELEMETRY_INVALID;
+        if (edges >= DSHOT_TELEMETRY_MIN_EDGES) {
+            value = decodeDshotTelemetryPacket(motor->dmaInputBuffer, edges);
+        }
+        if (value != DSHOT_TELEMETRY_INVALID) {
+            pwmDshotTelemetryReceived(i, value);
+        }
+        pwmDshotSetDirectionOutput(motor, true);
+    }
+    return true;
+}
+#endif
+
+#ifdef USE_DSHOT_BURST_SYNC
+void pwmDshotBurstSyncConfig(void) {
+    useBurstDshotSync = pwmDshotBurstSyncInit(dmaMotorTimers, dmaMotorTimerCount);
 }
+#endif
 
 void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
     UNUSED(motorCount);
@@ -96,9 +162,20 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
             return;
         }
     }
+#ifdef USE_DSHOT_TELEMETRY
+    dshotFrameStartUs = micros();
+#endif
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
+            motorDmaTimer_t *burstTimer = &dmaMotorTimers[i];
+            burstTimer->dmaBurstLength = loadDmaBurstBuffer(burstTimer->dmaBurstBuffer, burstTimer->dmaBurstPackets, burstTimer->dmaBurstChannels) * 4;
+#ifdef USE_DSHOT_BURST_SYNC
+            if (useBurstDshotSync) {
+                // held until every burst is armed, pwmDshotBurstSyncStart releases the timers together
+                pwmDshotBurstSyncStop(burstTimer->timer);
+            }
+#endif
             DMA_SetCurrDataCounter(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
             DMA_Cmd(dmaMotorTimers[i].dmaBurstRef, ENABLE);
             TIM_DMAConfig(dmaMotorTimers[i].timer, TIM_DMABase_CCR1, TIM_DMABurstLength_4Transfers);
@@ -111,6 +188,11 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
             dmaMotorTimers[i].timerDmaSources = 0;
         }
     }
+#ifdef USE_DSHOT_BURST_SYNC
+    if (useBurstDshotSync) {
+        pwmDshotBurstSyncStart(dmaMotorTimers, dmaMotorTimerCount);
+    }
+#endif
 }
 
 static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor) {
@@ -126,6 +208,15 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor) {
             DMA_Cmd(motor->timerHardware->dmaRef, DISABLE);
             TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
         }
+#ifdef USE_DSHOT_TELEMETRY
+        // output frame sent, capture the answer on the same pin until the next motor update
+        if (useDshotTelemetry && !motor->isInput) {
+            pwmDshotSetDirectionOutput(motor, false);
+            DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+            DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+            TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, ENABLE);
+        }
+#endif
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
 }
@@ -160,6 +251,12 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     // However, since the initialization is idempotent, it is left as is in a favor of flash space (for now).
     const uint8_t timerIndex = getTimerIndex(timer);
     const bool configureTimer = (timerIndex == dmaMotorTimerCount - 1);
+#ifdef USE_DSHOT_TELEMETRY
+    // bidirectional dshot idles high so the ESC can pull the line low for its answer
+    if (useDshotTelemetry) {
+        output ^= TIMER_OUTPUT_INVERTED;
+    }
+#endif
     IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_Mode_AF, GPIO_Speed_50MHz, GPIO_OType_PP, GPIO_PuPd_UP), timerHardware->alternateFunction);
     if (configureTimer) {
         TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
@@ -172,6 +269,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
         TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
         TIM_TimeBaseInit(timer, &TIM_TimeBaseStructure);
+#ifdef USE_DSHOT_TELEMETRY
+        dmaMotorTimers[timerIndex].outputPeriod = TIM_TimeBaseStructure.TIM_Period;
+#endif
     }
     TIM_OCStructInit(&TIM_OCInitStructure);
     TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
@@ -185,6 +285,17 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         TIM_OCInitStructure.TIM_OCPolarity =  (output & TIMER_OUTPUT_INVERTED) ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
     }
     TIM_OCInitStructure.TIM_Pulse = 0;
+#ifdef USE_DSHOT_TELEMETRY
+    motor->ocInitStruct = TIM_OCInitStructure;
+    TIM_ICStructInit(&motor->icInitStruct);
+    motor->icInitStruct.TIM_Channel = timerHardware->channel;
+    motor->icInitStruct.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    motor->icInitStruct.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    motor->icInitStruct.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    motor->icInitStruct.TIM_ICFilter = 2;
+    // frame on the wire plus line turnaround and the GCR answer
+    motor->dshotTelemetryDeadtimeUs = DSHOT_TELEMETRY_DEADTIME_US + 1000000 * (16 * (MOTOR_BITLENGTH + 1)) / getDshotHz(pwmProtocolType);
+#endif
     timerOCInit(timer, timerHardware->channel, &TIM_OCInitStructure);
     timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
     if (output & TIMER_OUTPUT_N_CHANNEL) {
@@ -201,6 +312,7 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
         motor->timer->dmaBurstRef = dmaRef;
+        motor->timer->dmaBurstChannels |= 1 << timerLookupChannelIndex(timerHardware->channel);
     } else
 #endif
     {
@@ -262,6 +374,11 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     }
     // XXX Consolidate common settings in the next refactor
+#ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInitStruct = DMA_InitStructure;
+    motor->dmaBufferSize = DMA_InitStructure.DMA_BufferSize;
+    motor->isInput = false;
+#endif
     DMA_Init(dmaRef, &DMA_InitStructure);
     DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
     motor->configured = true;
@@ -35,8 +35,11 @@
 #include "rcc.h"
 
 static FAST_RAM_ZERO_INIT uint8_t dmaMotorTimerCount = 0;
-static FAST_RAM_ZERO_INIT motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
-static FAST_RAM_ZERO_INIT motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static DMA_RAM motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
+static DMA_RAM motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+#ifdef USE_DSHOT_TELEMETRY
+static FAST_RAM_ZERO_INIT timeUs_t dshotFrameStartUs;
+#endif
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index) {
     return &dmaMotors[index];
@@ -66,20 +69,85 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value) {
     }
     motor->value = value;
     uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
-    } else
+        // encoded together with the other channels of this timer in pwmCompleteDshotMotorUpdate()
+        motor->timer->dmaBurstPackets[timerLookupChannelIndex(motor->timerHardware->channel)] = packet;
+        return;
+    }
 #endif
-    {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
-        motor->timer->timerDmaSources |= motor->timerDmaSource;
-        LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
-        LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
+    const uint8_t bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+    motor->timer->timerDmaSources |= motor->timerDmaSource;
+    LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
+    LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
+}
+
+#ifdef USE_DSHOT_TELEMETRY
+FAST_CODE static void pwmDshotSetDirectionOutput(motorDmaOutput_t * const motor, bool output) {
+    const timerHardware_t * const timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+    LL_EX_DMA_DisableStream(dmaRef);
+    LL_EX_DMA_DeInit(dmaRef);
+    motor->isInput = !output;
+    if (output) {
+        LL_TIM_EnableARRPreload(timer);
+        LL_TIM_SetAutoReload(timer, motor->timer->outputPeriod);
+        LL_TIM_OC_Init(timer, motor->llChannel, &motor->ocInitStruct);
+        LL_TIM_OC_EnablePreload(timer, motor->llChannel);
+        motor->dmaInitStruct.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+        motor->dmaInitStruct.MemoryOrM2MDstAddress = (uint32_t)motor->dmaBuffer;
+        motor->dmaInitStruct.NbData = motor->dmaBufferSize;
+    } else {
+        // free running counter, the edge timestamps are differenced so only the wrap matters
+        LL_TIM_DisableARRPreload(timer);
+        LL_TIM_SetAutoReload(timer, 0xffffffff);
+        LL_TIM_OC_DisablePreload(timer, motor->llChannel);
+        LL_TIM_IC_Init(timer, motor->llChannel, &motor->icInitStruct);
+        motor->dmaInitStruct.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+        motor->dmaInitStruct.MemoryOrM2MDstAddress = (uint32_t)motor->dmaInputBuffer;
+        motor->dmaInitStruct.NbData = DSHOT_TELEMETRY_INPUT_LEN;
+    }
+    LL_EX_DMA_Init(dmaRef, &motor->dmaInitStruct);
+    LL_EX_DMA_EnableIT_TC(dmaRef);
+}
+
+FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(uint8_t motorCount) {
+    if (!useDshotTelemetry) {
+        return true;
+    }
+    const timeDelta_t usSinceFrameStart = cmpTimeUs(micros(), dshotFrameStartUs);
+    for (int i = 0; i < motorCount; i++) {
+        if (dmaMotors[i].configured && usSinceFrameStart >= 0 && usSinceFrameStart < dmaMotors[i].dshotTelemetryDeadtimeUs) {
+            // the ESC may still be answering, switching the pin back now would collide with its frame
+            return false;
+        }
+    }
+    for (int i = 0; i < motorCount; i++) {
+        motorDmaOutput_t * const motor = &dmaMotors[i];
+        if (!motor->configured || !motor->isInput) {
+            continue;
+        }
+        const uint32_t edges = DSHOT_TELEMETRY_INPUT_LEN - LL_EX_DMA_GetDataLength(motor->timerHardware->dmaRef);
+        LL_EX_TIM_DisableIT(motor->timerHardware->tim, motor->timerDmaSource);
+        uint16_t value = DSHOT_TELEMETRY_INVALID;
+        if (edges >= DSHOT_TELEMETRY_MIN_EDGES) {
+            value = decodeDshotTelemetryPacket(motor->dmaInputBuffer, edges);
+        }
+        if (value != DSHOT_TELEMETRY_INVALID) {
+            pwmDshotTelemetryReceived(i, value);
+        }
+        pwmDshotSetDirectionOutput(motor, true);
     }
+    return true;
 }
+#endif
+
+#ifdef USE_DSHOT_BURST_SYNC
+void pwmDshotBurstSyncConfig(void) {
+    useBurstDshotSync = pwmDshotBurstSyncInit(dmaMotorTimers, dmaMotorTimerCount);
+}
+#endif
 
 FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
     UNUSED(motorCount);
@@ -89,9 +157,20 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
             return;
         }
     }
+#ifdef USE_DSHOT_TELEMETRY
+    dshotFrameStartUs = micros();
+#endif
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
+            motorDmaTimer_t *burstTimer = &dmaMotorTimers[i];
+            burstTimer->dmaBurstLength = loadDmaBurstBuffer(burstTimer->dmaBurstBuffer, burstTimer->dmaBurstPackets, burstTimer->dmaBurstChannels) * 4;
+#ifdef USE_DSHOT_BURST_SYNC
+            if (useBurstDshotSync) {
+                // held until every burst is armed, pwmDshotBurstSyncStart releases the timers together
+                pwmDshotBurstSyncStop(burstTimer->timer);
+            }
+#endif
             LL_EX_DMA_SetDataLength(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
             LL_EX_DMA_EnableStream(dmaMotorTimers[i].dmaBurstRef);
             /* configure the DMA Burst Mode */
@@ -108,6 +187,11 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
             dmaMotorTimers[i].timerDmaSources = 0;
         }
     }
+#ifdef USE_DSHOT_BURST_SYNC
+    if (useBurstDshotSync) {
+        pwmDshotBurstSyncStart(dmaMotorTimers, dmaMotorTimerCount);
+    }
+#endif
 }
 
 FAST_CODE static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor) {
@@ -123,6 +207,15 @@ FAST_CODE static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor) {
             LL_EX_DMA_DisableStream(motor->timerHardware->dmaRef);
             LL_EX_TIM_DisableIT(motor->timerHardware->tim, motor->timerDmaSource);
         }
+#ifdef USE_DSHOT_TELEMETRY
+        // output frame sent, capture the answer on the same pin until the next motor update
+        if (useDshotTelemetry && !motor->isInput) {
+            pwmDshotSetDirectionOutput(motor, false);
+            LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+            LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
+            LL_EX_TIM_EnableIT(motor->timerHardware->tim, motor->timerDmaSource);
+        }
+#endif
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
 }
@@ -148,7 +241,15 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     const IO_t motorIO = IOGetByTag(timerHardware->tag);
     const uint8_t timerIndex = getTimerIndex(timer);
     const bool configureTimer = (timerIndex == dmaMotorTimerCount - 1);
-    IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLDOWN), timerHardware->alternateFunction);
+    uint32_t pull = GPIO_PULLDOWN;
+#ifdef USE_DSHOT_TELEMETRY
+    // bidirectional dshot idles high so the ESC can pull the line low for its answer
+    if (useDshotTelemetry) {
+        output ^= TIMER_OUTPUT_INVERTED;
+        pull = GPIO_PULLUP;
+    }
+#endif
+    IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, pull), timerHardware->alternateFunction);
     if (configureTimer) {
         LL_TIM_InitTypeDef init;
         LL_TIM_StructInit(&init);
@@ -160,6 +261,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         init.RepetitionCounter = 0;
         init.CounterMode = LL_TIM_COUNTERMODE_UP;
         LL_TIM_Init(timer, &init);
+#ifdef USE_DSHOT_TELEMETRY
+        dmaMotorTimers[timerIndex].outputPeriod = init.Autoreload;
+#endif
     }
     LL_TIM_OC_StructInit(&oc_init);
     oc_init.OCMode = LL_TIM_OCMODE_PWM1;
@@ -188,6 +292,17 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         channel = LL_TIM_CHANNEL_CH4;
         break;
     }
+#ifdef USE_DSHOT_TELEMETRY
+    motor->llChannel = channel;
+    motor->ocInitStruct = oc_init;
+    LL_TIM_IC_StructInit(&motor->icInitStruct);
+    motor->icInitStruct.ICPolarity = LL_TIM_IC_POLARITY_BOTHEDGE;
+    motor->icInitStruct.ICActiveInput = LL_TIM_ACTIVEINPUT_DIRECTTI;
+    motor->icInitStruct.ICPrescaler = LL_TIM_ICPSC_DIV1;
+    motor->icInitStruct.ICFilter = LL_TIM_IC_FILTER_FDIV1_N2;
+    // frame on the wire plus line turnaround and the GCR answer
+    motor->dshotTelemetryDeadtimeUs = DSHOT_TELEMETRY_DEADTIME_US + 1000000 * (16 * (MOTOR_BITLENGTH + 1)) / getDshotHz(pwmProtocolType);
+#endif
     LL_TIM_OC_Init(timer, channel, &oc_init);
     LL_TIM_OC_EnablePreload(timer, channel);
     LL_TIM_OC_DisableFast(timer, channel);
@@ -205,6 +320,7 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
         motor->timer->dmaBurstRef = dmaRef;
+        motor->timer->dmaBurstChannels |= 1 << timerLookupChannelIndex(timerHardware->channel);
         if (!configureTimer) {
             motor->configured = true;
             return;
@@ -246,6 +362,11 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     dma_init.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_WORD;
     dma_init.Mode = LL_DMA_MODE_NORMAL;
     dma_init.Priority = LL_DMA_PRIORITY_HIGH;
+#ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInitStruct = dma_init;
+    motor->dmaBufferSize = dma_init.NbData;
+    motor->isInput = false;
+#endif
     LL_EX_DMA_Init(dmaRef, &dma_init);
     LL_EX_DMA_EnableIT_TC(dmaRef);
     motor->configured = true;
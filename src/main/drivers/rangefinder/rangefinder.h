@@ -36,6 +36,7 @@ struct rangefinderDev_s;
 typedef void (*rangefinderOpInitFuncPtr)(struct rangefinderDev_s * dev);
 typedef void (*rangefinderOpStartFuncPtr)(struct rangefinderDev_s * dev);
 typedef int32_t (*rangefinderOpReadFuncPtr)(struct rangefinderDev_s * dev);
+typedef bool (*rangefinderOpIsDataReadyFuncPtr)(struct rangefinderDev_s * dev);
 
 typedef struct rangefinderDev_s {
     timeMs_t delayMs;
@@ -49,6 +50,7 @@ typedef struct rangefinderDev_s {
     rangefinderOpInitFuncPtr init;
     rangefinderOpStartFuncPtr update;
     rangefinderOpReadFuncPtr read;
+    rangefinderOpIsDataReadyFuncPtr isDataReady; // optional, polled every delayMs when NULL
 } rangefinderDev_t;
 
 extern int16_t rangefinderMaxRangeCm;
@@ -115,6 +115,9 @@ static uint8_t tfCmdTF02[] = { 0x42, 0x57, 0x02, 0x00, 0x00, 0x00, 0x01, 0x06 };
 
 static int32_t lidarTFValue;
 static uint16_t lidarTFerrors = 0;
+static volatile bool lidarTFFrameReady = false;
+static timeMs_t lastFrameReceivedMs = 0;
+static timeMs_t lastCommandMs = 0;
 
 static void lidarTFSendCommand(void) {
     switch (tfDevtype) {
@@ -133,81 +136,105 @@ void lidarTFInit(rangefinderDev_t *dev) {
     tfReceivePosition = 0;
 }
 
-void lidarTFUpdate(rangefinderDev_t *dev) {
-    UNUSED(dev);
-    static timeMs_t lastFrameReceivedMs = 0;
-    const timeMs_t timeNowMs = millis();
-    if (tfSerialPort == NULL) {
+// Frames are assembled in the serial rx callback, so with USE_UART_RX_DMA_IDLE
+// the bytes arrive a frame at a time and the task only runs for a checked frame.
+static void lidarTFDataReceive(uint16_t c, void *data) {
+    UNUSED(data);
+    if (lidarTFFrameReady) {
+        // hold the last frame until the task has decoded it
         return;
     }
-    while (serialRxBytesWaiting(tfSerialPort)) {
-        uint8_t c = serialRead(tfSerialPort);
-        switch (tfFrameState) {
-        case TF_FRAME_STATE_WAIT_START1:
-            if (c == TF_FRAME_SYNC_BYTE) {
-                tfFrameState = TF_FRAME_STATE_WAIT_START2;
-            }
-            break;
-        case TF_FRAME_STATE_WAIT_START2:
-            if (c == TF_FRAME_SYNC_BYTE) {
-                tfFrameState = TF_FRAME_STATE_READING_PAYLOAD;
-            } else {
-                tfFrameState = TF_FRAME_STATE_WAIT_START1;
-            }
-            break;
-        case TF_FRAME_STATE_READING_PAYLOAD:
-            tfFrame[tfReceivePosition++] = c;
-            if (tfReceivePosition == TF_FRAME_LENGTH) {
-                tfFrameState = TF_FRAME_STATE_WAIT_CKSUM;
-            }
-            break;
-        case TF_FRAME_STATE_WAIT_CKSUM: {
-            uint8_t cksum = TF_FRAME_SYNC_BYTE + TF_FRAME_SYNC_BYTE;
-            for (int i = 0 ; i < TF_FRAME_LENGTH ; i++) {
-                cksum += tfFrame[i];
-            }
-            if (c == cksum) {
-                uint16_t distance = tfFrame[0] | (tfFrame[1] << 8);
-                uint16_t strength = tfFrame[2] | (tfFrame[3] << 8);
-                DEBUG_SET(DEBUG_LIDAR_TF, 0, distance);
-                DEBUG_SET(DEBUG_LIDAR_TF, 1, strength);
-                DEBUG_SET(DEBUG_LIDAR_TF, 2, tfFrame[4]);
-                DEBUG_SET(DEBUG_LIDAR_TF, 3, tfFrame[5]);
-                switch (tfDevtype) {
-                case TF_DEVTYPE_MINI:
-                    if (distance >= TF_MINI_RANGE_MIN && distance < TF_MINI_RANGE_MAX) {
-                        lidarTFValue = distance;
-                        if (tfFrame[TF_MINI_FRAME_INTEGRAL_TIME] == 7) {
-                            // When integral time is long (7), measured distance tends to be longer by 12~13.
-                            lidarTFValue -= 13;
-                        }
-                    } else {
-                        lidarTFValue = -1;
-                    }
-                    break;
-                case TF_DEVTYPE_02:
-                    if (distance >= TF_02_RANGE_MIN && distance < TF_02_RANGE_MAX && tfFrame[TF_02_FRAME_SIG] >= 7) {
-                        lidarTFValue = distance;
-                    } else {
-                        lidarTFValue = -1;
-                    }
-                    break;
-                }
-                lastFrameReceivedMs = timeNowMs;
-            } else {
-                // Checksum error. Simply discard the current frame.
-                ++lidarTFerrors;
-                //DEBUG_SET(DEBUG_LIDAR_TF, 3, lidarTFerrors);
-            }
+    switch (tfFrameState) {
+    case TF_FRAME_STATE_WAIT_START1:
+        if (c == TF_FRAME_SYNC_BYTE) {
+            tfFrameState = TF_FRAME_STATE_WAIT_START2;
+        }
+        break;
+    case TF_FRAME_STATE_WAIT_START2:
+        if (c == TF_FRAME_SYNC_BYTE) {
+            tfFrameState = TF_FRAME_STATE_READING_PAYLOAD;
+        } else {
+            tfFrameState = TF_FRAME_STATE_WAIT_START1;
+        }
+        break;
+    case TF_FRAME_STATE_READING_PAYLOAD:
+        tfFrame[tfReceivePosition++] = c;
+        if (tfReceivePosition == TF_FRAME_LENGTH) {
+            tfFrameState = TF_FRAME_STATE_WAIT_CKSUM;
+        }
+        break;
+    case TF_FRAME_STATE_WAIT_CKSUM: {
+        uint8_t cksum = TF_FRAME_SYNC_BYTE + TF_FRAME_SYNC_BYTE;
+        for (int i = 0 ; i < TF_FRAME_LENGTH ; i++) {
+            cksum += tfFrame[i];
+        }
+        if (c == cksum) {
+            lidarTFFrameReady = true;
+        } else {
+            // Checksum error. Simply discard the current frame.
+            ++lidarTFerrors;
+            //DEBUG_SET(DEBUG_LIDAR_TF, 3, lidarTFerrors);
         }
         tfFrameState = TF_FRAME_STATE_WAIT_START1;
         tfReceivePosition = 0;
         break;
+    }
+    }
+}
+
+static void lidarTFDecodeFrame(void) {
+    uint16_t distance = tfFrame[0] | (tfFrame[1] << 8);
+    uint16_t strength = tfFrame[2] | (tfFrame[3] << 8);
+    DEBUG_SET(DEBUG_LIDAR_TF, 0, distance);
+    DEBUG_SET(DEBUG_LIDAR_TF, 1, strength);
+    DEBUG_SET(DEBUG_LIDAR_TF, 2, tfFrame[4]);
+    DEBUG_SET(DEBUG_LIDAR_TF, 3, tfFrame[5]);
+    switch (tfDevtype) {
+    case TF_DEVTYPE_MINI:
+        if (distance >= TF_MINI_RANGE_MIN && distance < TF_MINI_RANGE_MAX) {
+            lidarTFValue = distance;
+            if (tfFrame[TF_MINI_FRAME_INTEGRAL_TIME] == 7) {
+                // When integral time is long (7), measured distance tends to be longer by 12~13.
+                lidarTFValue -= 13;
+            }
+        } else {
+            lidarTFValue = -1;
+        }
+        break;
+    case TF_DEVTYPE_02:
+        if (distance >= TF_02_RANGE_MIN && distance < TF_02_RANGE_MAX && tfFrame[TF_02_FRAME_SIG] >= 7) {
+            lidarTFValue = distance;
+        } else {
+            lidarTFValue = -1;
         }
+        break;
+    }
+}
+
+static bool lidarTFCommandDue(timeMs_t timeNowMs) {
+    return timeNowMs - lastFrameReceivedMs > TF_TIMEOUT_MS && timeNowMs - lastCommandMs > TF_TIMEOUT_MS;
+}
+
+bool lidarTFIsDataReady(rangefinderDev_t *dev) {
+    UNUSED(dev);
+    return lidarTFFrameReady || lidarTFCommandDue(millis());
+}
+
+void lidarTFUpdate(rangefinderDev_t *dev) {
+    UNUSED(dev);
+    const timeMs_t timeNowMs = millis();
+    if (tfSerialPort == NULL) {
+        return;
+    }
+    if (lidarTFFrameReady) {
+        lidarTFDecodeFrame();
+        lastFrameReceivedMs = timeNowMs;
+        lidarTFFrameReady = false;
     }
     // If valid frame hasn't been received for more than a timeout, resend command.
-    if (timeNowMs - lastFrameReceivedMs > TF_TIMEOUT_MS) {
+    if (lidarTFCommandDue(timeNowMs)) {
         lidarTFSendCommand();
+        lastCommandMs = timeNowMs;
     }
 }
 
@@ -223,7 +250,7 @@ static bool lidarTFDetect(rangefinderDev_t *dev, uint8_t devtype) {
     if (!portConfig) {
         return false;
     }
-    tfSerialPort = openSerialPort(portConfig->identifier, FUNCTION_LIDAR_TF, NULL, NULL, 115200, MODE_RXTX, 0);
+    tfSerialPort = openSerialPort(portConfig->identifier, FUNCTION_LIDAR_TF, lidarTFDataReceive, NULL, 115200, MODE_RXTX, 0);
     if (tfSerialPort == NULL) {
         return false;
     }
@@ -234,6 +261,7 @@ static bool lidarTFDetect(rangefinderDev_t *dev, uint8_t devtype) {
     dev->detectionConeExtendedDeciDegrees = TF_DETECTION_CONE_DECIDEGREES;
     dev->init = &lidarTFInit;
     dev->update = &lidarTFUpdate;
+    dev->isDataReady = &lidarTFIsDataReady;
     dev->read = &lidarTFGetDistance;
     return true;
 }
@@ -21,11 +21,15 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
 #ifdef USE_RX_FLYSKY
 
+#include "common/maths.h"
+#include "common/utils.h"
+
 #include "drivers/bus_spi.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
@@ -44,9 +48,87 @@ static extiCallbackRec_t a7105extiCallbackRec;
 static volatile uint32_t timeEvent = 0;
 static volatile bool occurEvent = false;
 
+#ifdef USE_RX_SPI_DMA
+#define A7105_FIFO_SIZE 64
+
+// The chip drops to standby after a packet and waits for the next RX strobe, so one packet is outstanding at most.
+// On the RX interrupt MODE and the FIFO are read in the background, the loop gets both without touching the bus.
+static DMA_RAM uint8_t dmaModeTx[2];
+static DMA_RAM uint8_t dmaModeRx[2];
+static DMA_RAM uint8_t dmaRstTx[1];
+static DMA_RAM uint8_t dmaRstRx[1];
+static DMA_RAM uint8_t dmaFifoTx[1 + A7105_FIFO_SIZE];
+static DMA_RAM uint8_t dmaFifoRx[1 + A7105_FIFO_SIZE];
+static spiDmaJob_t dmaModeJob;
+static spiDmaJob_t dmaRstJob;
+static spiDmaJob_t dmaFifoJob;
+static uint8_t dmaFifoLength = 0;
+static bool dmaReady = false;
+static volatile bool rxArmed = false;
+static volatile bool dmaPacketReady = false;
+static volatile uint32_t dmaTimeEvent = 0;
+
+static void a7105DmaFifoRead(uint32_t arg) {
+    UNUSED(arg);
+    dmaPacketReady = true;
+}
+
+// rxSpiInitDma() runs after the receiver init, so the jobs are set up on the first RX strobe that finds DMA
+static void a7105DmaInit(void) {
+    dmaModeTx[0] = (uint8_t)A7105_00_MODE | 0x40;
+    dmaModeTx[1] = 0xFF;
+    dmaRstTx[0] = (uint8_t)A7105_RST_RDPTR;
+    memset(dmaFifoTx, 0xFF, sizeof(dmaFifoTx));
+    dmaFifoTx[0] = (uint8_t)A7105_05_FIFO_DATA | 0x40;
+    dmaFifoJob.callback = a7105DmaFifoRead;
+    dmaReady = rxSpiDmaJobInit(&dmaModeJob, dmaModeTx, dmaModeRx, sizeof(dmaModeTx))
+        && rxSpiDmaJobInit(&dmaRstJob, dmaRstTx, dmaRstRx, sizeof(dmaRstTx))
+        && rxSpiDmaJobInit(&dmaFifoJob, dmaFifoTx, dmaFifoRx, 1 + dmaFifoLength);
+}
+
+static bool a7105DmaStart(void) {
+    if (!dmaReady || !rxArmed || dmaPacketReady || dmaModeJob.pending || dmaRstJob.pending || dmaFifoJob.pending) {
+        return false;
+    }
+    rxArmed = false;
+    dmaTimeEvent = micros();
+    // jobs of equal priority run in order
+    return spiBusQueueDma(&dmaModeJob) && spiBusQueueDma(&dmaRstJob) && spiBusQueueDma(&dmaFifoJob);
+}
+
+/*
+ * Read the given number of FIFO bytes in the background after every RX interrupt, A7105RxDmaPacket() hands them out.
+ * Packets fall back to A7105RxTxFinished() while the bus has no DMA.
+ */
+void A7105EnableRxDma(uint8_t fifoLength) {
+    dmaFifoLength = MIN(fifoLength, A7105_FIFO_SIZE);
+}
+
+/*
+ * MODE and the FIFO of the last received packet, the data stays valid until the next RX strobe.
+ */
+bool A7105RxDmaPacket(uint8_t *modeReg, const uint8_t **fifo, uint32_t *timeStamp) {
+    if (!dmaPacketReady) {
+        return false;
+    }
+    *modeReg = dmaModeRx[1];
+    *fifo = &dmaFifoRx[1];
+    if (timeStamp) {
+        *timeStamp = dmaTimeEvent;
+    }
+    dmaPacketReady = false;
+    return true;
+}
+#endif
+
 void a7105extiHandler(extiCallbackRec_t* cb) {
     UNUSED(cb);
     if (IORead (rxIntIO) != 0) {
+#ifdef USE_RX_SPI_DMA
+        if (a7105DmaStart()) {
+            return;
+        }
+#endif
         timeEvent = micros();
         occurEvent = true;
     }
@@ -117,6 +199,12 @@ void A7105WriteReg (A7105Reg_t reg, uint8_t data) {
 }
 
 void A7105Strobe (A7105State_t state) {
+#ifdef USE_RX_SPI_DMA
+    if (A7105_RX == state && dmaFifoLength && !dmaReady) {
+        a7105DmaInit();
+    }
+    rxArmed = (A7105_RX == state);
+#endif
     if (A7105_TX == state || A7105_RX == state) {
         EXTIEnable(rxIntIO, true);
     } else {
@@ -112,3 +112,7 @@ void A7105ReadFIFO(uint8_t *data, uint8_t num);
 void A7105WriteFIFO(uint8_t *data, uint8_t num);
 
 bool A7105RxTxFinished(uint32_t *timeStamp);
+#ifdef USE_RX_SPI_DMA
+void A7105EnableRxDma(uint8_t fifoLength);
+bool A7105RxDmaPacket(uint8_t *modeReg, const uint8_t **fifo, uint32_t *timeStamp);
+#endif
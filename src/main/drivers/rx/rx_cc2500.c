@@ -47,6 +47,12 @@ uint8_t cc2500ReadFifo(uint8_t *dpbuffer, uint8_t len) {
     return rxSpiReadCommandMulti(CC2500_3F_RXFIFO | CC2500_READ_BURST, NOP, dpbuffer, len);
 }
 
+#ifdef USE_RX_SPI_DMA
+bool cc2500ReadFifoDma(uint8_t len) {
+    return rxSpiReadCommandMultiDma(CC2500_3F_RXFIFO | CC2500_READ_BURST, NOP, len);
+}
+#endif
+
 uint8_t cc2500WriteFifo(uint8_t *dpbuffer, uint8_t len) {
     uint8_t ret;
     cc2500Strobe(CC2500_SFTX); // 0x3B SFTX
@@ -158,6 +158,9 @@ enum {
 #define CC2500_LQI_EST_BM 0x7F
 
 uint8_t cc2500ReadFifo(uint8_t *dpbuffer, uint8_t len);
+#ifdef USE_RX_SPI_DMA
+bool cc2500ReadFifoDma(uint8_t len);
+#endif
 uint8_t cc2500WriteFifo(uint8_t *dpbuffer, uint8_t len);
 
 uint8_t cc2500ReadRegisterMulti(uint8_t address, uint8_t *data,
@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -197,11 +198,20 @@ void NRF24L01_SetChannel(uint8_t channel) {
     NRF24L01_WriteReg(NRF24L01_05_RF_CH, channel);
 }
 
+/*
+ * STATUS is clocked out with the command byte, so a single payload read also tells whether the RX FIFO held a packet.
+ * Reading an empty FIFO has no effect, its bytes are dropped.
+ */
 bool NRF24L01_ReadPayloadIfAvailable(uint8_t *data, uint8_t length) {
-    if (NRF24L01_ReadReg(NRF24L01_17_FIFO_STATUS) & BV(NRF24L01_17_FIFO_STATUS_RX_EMPTY)) {
+    uint8_t packet[RX_SPI_MAX_PAYLOAD_SIZE];
+    if (length > sizeof(packet)) {
+        length = sizeof(packet);
+    }
+    const uint8_t status = NRF24L01_ReadPayload(packet, length);
+    if ((status & NRF24L01_07_STATUS_RX_P_NO_MASK) == NRF24L01_07_STATUS_RX_P_NO_EMPTY) {
         return false;
     }
-    NRF24L01_ReadPayload(data, length);
+    memcpy(data, packet, length);
     return true;
 }
 
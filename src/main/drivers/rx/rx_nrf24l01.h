@@ -165,6 +165,9 @@ enum {
     NRF24L01_06_RF_SETUP_RF_PWR_n6dbm   = 0x04,
     NRF24L01_06_RF_SETUP_RF_PWR_0dbm    = 0x06,
 
+    NRF24L01_07_STATUS_RX_P_NO_MASK     = 0x0E,
+    NRF24L01_07_STATUS_RX_P_NO_EMPTY    = 0x0E,
+
     NRF24L01_1C_DYNPD_ALL_PIPES         = 0x3F
 };
 
@@ -25,14 +25,17 @@
 
 #if defined(USE_PWM) || defined(USE_PPM)
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 #include "build/debug.h"
 
 #include "common/utils.h"
 
+#include "drivers/dma.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
 #include "drivers/pwm_output.h"
+#include "drivers/time.h"
 #include "drivers/timer.h"
 
 #include "pg/rx_pwm.h"
@@ -106,6 +109,28 @@ typedef struct ppmDevice_s {
 
 static ppmDevice_t ppmDev;
 
+#ifdef USE_PPM_DMA
+// rising edge timestamps the capture DMA can hold, decoded by the RX task and at half and full buffer
+#define PPM_DMA_EDGE_COUNT 32
+// the 16 bit capture can't time an edge after a gap this long, it only gives the next one a start
+#define PPM_DMA_EDGE_TIMEOUT_US 50000
+
+typedef struct ppmDma_s {
+    bool active;
+    bool restart;
+    DMA_Stream_TypeDef *stream;
+    dmaChannelDescriptor_t *descriptor;
+    uint16_t tail;
+    uint16_t lastCapture;
+    timeUs_t lastEdgeAtUs;
+} ppmDma_t;
+
+static ppmDma_t ppmDma;
+static DMA_RAM volatile uint16_t ppmDmaBuffer[PPM_DMA_EDGE_COUNT];
+
+static void ppmDmaDecode(void);
+#endif
+
 #define PPM_IN_MIN_SYNC_PULSE_US    2700    // microseconds
 #define PPM_IN_MIN_CHANNEL_PULSE_US 750     // microseconds
 #define PPM_IN_MAX_CHANNEL_PULSE_US 2250    // microseconds
@@ -114,6 +139,13 @@ static ppmDevice_t ppmDev;
 #define PPM_IN_MAX_NUM_CHANNELS     PWM_PORTS_OR_PPM_CAPTURE_COUNT
 
 bool isPPMDataBeingReceived(void) {
+#ifdef USE_PPM_DMA
+    if (ppmDma.active) {
+        ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+            ppmDmaDecode();
+        }
+    }
+#endif
     return (ppmFrameCount != lastPPMFrameCount);
 }
 
@@ -168,33 +200,9 @@ static void ppmOverflowCallback(timerOvrHandlerRec_t* cbRec, captureCompare_t ca
     }
 }
 
-static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture) {
-    UNUSED(cbRec);
-    ppmISREvent(SOURCE_EDGE, capture);
+// takes the time since the previous rising edge from ppmDev.deltaTime
+static void ppmProcessPulse(void) {
     int32_t i;
-    uint32_t previousTime = ppmDev.currentTime;
-    uint32_t previousCapture = ppmDev.currentCapture;
-    /* Grab the new count */
-    uint32_t currentTime = capture;
-    /* Convert to 32-bit timer result */
-    currentTime += ppmDev.largeCounter;
-    if (capture < previousCapture) {
-        if (ppmDev.overflowed) {
-            currentTime += PPM_TIMER_PERIOD;
-        }
-    }
-    // Divide value if Oneshot, Multishot or brushed motors are active and the timer is shared
-    currentTime = currentTime / ppmCountDivisor;
-    /* Capture computation */
-    if (currentTime > previousTime) {
-        ppmDev.deltaTime    = currentTime - (previousTime + (ppmDev.overflowed ? (PPM_TIMER_PERIOD / ppmCountDivisor) : 0));
-    } else {
-        ppmDev.deltaTime    = (PPM_TIMER_PERIOD / ppmCountDivisor) + currentTime - previousTime;
-    }
-    ppmDev.overflowed = false;
-    /* Store the current measurement */
-    ppmDev.currentTime = currentTime;
-    ppmDev.currentCapture = capture;
     /* Sync pulse detection */
     if (ppmDev.deltaTime > PPM_IN_MIN_SYNC_PULSE_US) {
         if (ppmDev.pulseIndex == ppmDev.numChannelsPrevFrame
@@ -243,6 +251,101 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
     }
 }
 
+static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture) {
+    UNUSED(cbRec);
+    ppmISREvent(SOURCE_EDGE, capture);
+    uint32_t previousTime = ppmDev.currentTime;
+    uint32_t previousCapture = ppmDev.currentCapture;
+    /* Grab the new count */
+    uint32_t currentTime = capture;
+    /* Convert to 32-bit timer result */
+    currentTime += ppmDev.largeCounter;
+    if (capture < previousCapture) {
+        if (ppmDev.overflowed) {
+            currentTime += PPM_TIMER_PERIOD;
+        }
+    }
+    // Divide value if Oneshot, Multishot or brushed motors are active and the timer is shared
+    currentTime = currentTime / ppmCountDivisor;
+    /* Capture computation */
+    if (currentTime > previousTime) {
+        ppmDev.deltaTime    = currentTime - (previousTime + (ppmDev.overflowed ? (PPM_TIMER_PERIOD / ppmCountDivisor) : 0));
+    } else {
+        ppmDev.deltaTime    = (PPM_TIMER_PERIOD / ppmCountDivisor) + currentTime - previousTime;
+    }
+    ppmDev.overflowed = false;
+    /* Store the current measurement */
+    ppmDev.currentTime = currentTime;
+    ppmDev.currentCapture = capture;
+    ppmProcessPulse();
+}
+
+#ifdef USE_PPM_DMA
+// Times the captured rising edges like ppmEdgeCallback() does, the timer runs at 1MHz with a 16 bit period
+// so the difference of two captures is the pulse length. Runs at interrupt priority NVIC_PRIO_TIMER.
+static void ppmDmaDecode(void) {
+    const uint16_t head = (PPM_DMA_EDGE_COUNT - ppmDma.stream->NDTR) % PPM_DMA_EDGE_COUNT;
+    if (ppmDma.tail == head) {
+        return;
+    }
+    const timeUs_t now = micros();
+    if (cmpTimeUs(now, ppmDma.lastEdgeAtUs) > PPM_DMA_EDGE_TIMEOUT_US) {
+        ppmDma.restart = true;
+    }
+    ppmDma.lastEdgeAtUs = now;
+    while (ppmDma.tail != head) {
+        const uint16_t capture = ppmDmaBuffer[ppmDma.tail];
+        ppmDma.tail = (ppmDma.tail + 1) % PPM_DMA_EDGE_COUNT;
+        ppmISREvent(SOURCE_EDGE, capture);
+        if (!ppmDma.restart) {
+            ppmDev.deltaTime = (uint16_t)(capture - ppmDma.lastCapture);
+            ppmProcessPulse();
+        }
+        ppmDma.restart = false;
+        ppmDma.lastCapture = capture;
+    }
+}
+
+static void ppmDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    DMA_CLEAR_FLAG(descriptor, (DMA_IT_HTIF | DMA_IT_TCIF));
+    // decode before the capture buffer wraps, when the RX task hasn't looked for a while
+    ppmDmaDecode();
+}
+
+// A timer shared with motor outputs doesn't run at 1MHz, a PPM pin on one keeps the edge interrupt
+static bool ppmDmaInit(const timerHardware_t *timerHardware) {
+    if (!timerHardware->dmaRef || ppmCountDivisor != 1) {
+        return false;
+    }
+    const dmaIdentifier_e identifier = dmaGetIdentifier(timerHardware->dmaRef);
+    if (dmaGetOwner(identifier) != OWNER_FREE) {
+        return false;
+    }
+    dmaInit(identifier, OWNER_PPMINPUT, 0);
+    dmaSetHandler(identifier, ppmDmaIrqHandler, NVIC_PRIO_TIMER, 0);
+    ppmDma.stream = timerHardware->dmaRef;
+    ppmDma.descriptor = dmaGetDescriptorByIdentifier(identifier);
+    TIM_TypeDef *tim = timerHardware->tim;
+    DMA_Stream_TypeDef *stream = ppmDma.stream;
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN);
+    DMA_CLEAR_FLAG(ppmDma.descriptor, (DMA_IT_HTIF | DMA_IT_TCIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF));
+    stream->PAR = (uint32_t)timerCCR(tim, timerHardware->channel);
+    stream->M0AR = (uint32_t)ppmDmaBuffer;
+    stream->NDTR = PPM_DMA_EDGE_COUNT;
+    stream->FCR = 0;
+    stream->CR = timerHardware->dmaChannel | DMA_SxCR_PL_0 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC
+        | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+    ppmDma.tail = 0;
+    ppmDma.restart = true;
+    ppmDma.lastEdgeAtUs = micros();
+    stream->CR |= DMA_SxCR_EN;
+    // edges go to the buffer instead of raising the capture interrupt
+    tim->DIER = (tim->DIER & ~(TIM_DIER_CC1IE << (timerHardware->channel / 4))) | timerDmaSource(timerHardware->channel);
+    return true;
+}
+#endif
+
 #define MAX_MISSED_PWM_EVENTS 10
 
 bool isPWMDataBeingReceived(void) {
@@ -398,6 +501,9 @@ void ppmRxInit(const ppmConfig_t *ppmConfig) {
 #else
     pwmICConfig(timer->tim, timer->channel, TIM_ICPolarity_Rising);
 #endif
+#ifdef USE_PPM_DMA
+    ppmDma.active = ppmDmaInit(timer);
+#endif
 }
 
 uint16_t ppmRead(uint8_t channel) {
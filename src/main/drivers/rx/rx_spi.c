@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -38,14 +39,28 @@
 #include "drivers/system.h"
 
 #include "pg/rx_spi.h"
+#ifdef USE_RX_SPI_DMA
+#include "pg/sdcard.h"
+#endif
 
 #include "rx_spi.h"
 
 static busDevice_t rxSpiDevice;
 static busDevice_t *busdev = &rxSpiDevice;
 
-#define DISABLE_RX()    {IOHi(busdev->busdev_u.spi.csnPin);}
-#define ENABLE_RX()     {IOLo(busdev->busdev_u.spi.csnPin);}
+// a background DMA read holds the bus, register accesses wait for it
+#define DISABLE_RX()    {IOHi(busdev->busdev_u.spi.csnPin);spiBusRelease(busdev);}
+#define ENABLE_RX()     {spiBusAcquire(busdev);IOLo(busdev->busdev_u.spi.csnPin);}
+
+#ifdef USE_RX_SPI_DMA
+// command byte and the whole CC2500 or NRF24 FIFO
+#define RX_SPI_DMA_BUFFER_SIZE (1 + 64)
+
+static DMA_RAM uint8_t rxSpiDmaTxBuf[RX_SPI_DMA_BUFFER_SIZE];
+static DMA_RAM uint8_t rxSpiDmaRxBuf[RX_SPI_DMA_BUFFER_SIZE];
+static spiDmaJob_t rxSpiDmaJob;
+static bool rxSpiDmaEnabled = false;
+#endif
 
 bool rxSpiDeviceInit(const rxSpiConfig_t *rxSpiConfig) {
     if (!rxSpiConfig->spibus) {
@@ -83,9 +98,7 @@ uint8_t rxSpiWriteCommand(uint8_t command, uint8_t data) {
 uint8_t rxSpiWriteCommandMulti(uint8_t command, const uint8_t *data, uint8_t length) {
     ENABLE_RX();
     const uint8_t ret = rxSpiTransferByte(command);
-    for (uint8_t i = 0; i < length; i++) {
-        rxSpiTransferByte(data[i]);
-    }
+    spiTransfer(busdev->busdev_u.spi.instance, data, NULL, length);
     DISABLE_RX();
     return ret;
 }
@@ -101,10 +114,85 @@ uint8_t rxSpiReadCommand(uint8_t command, uint8_t data) {
 uint8_t rxSpiReadCommandMulti(uint8_t command, uint8_t commandData, uint8_t *retData, uint8_t length) {
     ENABLE_RX();
     const uint8_t ret = rxSpiTransferByte(command);
-    for (uint8_t i = 0; i < length; i++) {
-        retData[i] = rxSpiTransferByte(commandData);
+    if (commandData == 0xFF) {
+        // spiTransfer() clocks out 0xFF without transmit data
+        spiTransfer(busdev->busdev_u.spi.instance, NULL, retData, length);
+    } else {
+        for (uint8_t i = 0; i < length; i++) {
+            retData[i] = rxSpiTransferByte(commandData);
+        }
     }
     DISABLE_RX();
     return ret;
 }
+
+#ifdef USE_RX_SPI_DMA
+// Blocking transfers on a gyro bus would hold back the gyro reads, a raw SD card
+// transfer doesn't take the bus lock and could interleave with a DMA read
+static bool rxSpiBusIsExclusive(SPIDevice device) {
+#ifdef GYRO_1_SPI_INSTANCE
+    if (spiDeviceByInstance(GYRO_1_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+#ifdef GYRO_2_SPI_INSTANCE
+    if (spiDeviceByInstance(GYRO_2_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+#if defined(USE_SDCARD) && defined(SDCARD_SPI_INSTANCE)
+    if (sdcardConfig()->enabled && sdcardConfig()->device == device) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+void rxSpiInitDma(void) {
+    const SPIDevice device = spiDeviceByInstance(busdev->busdev_u.spi.instance);
+    if (device == SPIINVALID || !rxSpiBusIsExclusive(device)) {
+        return;
+    }
+    rxSpiDmaJob.bus = busdev;
+    rxSpiDmaJob.txData = rxSpiDmaTxBuf;
+    rxSpiDmaJob.rxData = rxSpiDmaRxBuf;
+    rxSpiDmaJob.priority = SPI_DMA_PRIORITY_LOW;
+    rxSpiDmaEnabled = spiBusDmaInit(busdev);
+}
+
+/*
+ * Start a read like rxSpiReadCommandMulti() in the background. Returns false if the bus has no DMA or a read is still
+ * running, the caller then reads blocking. Once rxSpiDmaReadBusy() is false the data is in rxSpiDmaReadData().
+ */
+bool rxSpiReadCommandMultiDma(uint8_t command, uint8_t commandData, uint8_t length) {
+    if (!rxSpiDmaEnabled || rxSpiDmaJob.pending || length >= RX_SPI_DMA_BUFFER_SIZE) {
+        return false;
+    }
+    rxSpiDmaTxBuf[0] = command;
+    memset(&rxSpiDmaTxBuf[1], commandData, length);
+    rxSpiDmaJob.length = length + 1;
+    return spiBusQueueDma(&rxSpiDmaJob);
+}
+
+bool rxSpiDmaReadBusy(void) {
+    return rxSpiDmaJob.pending;
+}
+
+const uint8_t *rxSpiDmaReadData(void) {
+    return &rxSpiDmaRxBuf[1];
+}
+
+/*
+ * Set up a job of the caller's own on the receiver bus, for drivers that chain several transfers. The buffers must be
+ * DMA_RAM. Returns false until rxSpiInitDma() has found DMA on the bus, the job must not be queued then.
+ */
+bool rxSpiDmaJobInit(spiDmaJob_t *job, const uint8_t *txData, uint8_t *rxData, int length) {
+    job->bus = busdev;
+    job->txData = txData;
+    job->rxData = rxData;
+    job->length = length;
+    job->priority = SPI_DMA_PRIORITY_LOW;
+    return rxSpiDmaEnabled;
+}
+#endif
 #endif
@@ -25,6 +25,7 @@
 #define RX_SPI_MAX_PAYLOAD_SIZE 32
 
 struct rxSpiConfig_s;
+struct spiDmaJob_s;
 
 bool rxSpiDeviceInit(const struct rxSpiConfig_s *rxSpiConfig);
 uint8_t rxSpiTransferByte(uint8_t data);
@@ -33,3 +34,10 @@ uint8_t rxSpiWriteCommand(uint8_t command, uint8_t data);
 uint8_t rxSpiWriteCommandMulti(uint8_t command, const uint8_t *data, uint8_t length);
 uint8_t rxSpiReadCommand(uint8_t command, uint8_t commandData);
 uint8_t rxSpiReadCommandMulti(uint8_t command, uint8_t commandData, uint8_t *retData, uint8_t length);
+#ifdef USE_RX_SPI_DMA
+void rxSpiInitDma(void);
+bool rxSpiReadCommandMultiDma(uint8_t command, uint8_t commandData, uint8_t length);
+bool rxSpiDmaReadBusy(void);
+const uint8_t *rxSpiDmaReadData(void);
+bool rxSpiDmaJobInit(struct spiDmaJob_s *job, const uint8_t *txData, uint8_t *rxData, int length);
+#endif
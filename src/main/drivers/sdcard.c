@@ -876,6 +876,18 @@ doMore:
     return SDCARD_OPERATION_IN_PROGRESS;
 }
 
+/**
+ * Returns true while a multi-block write is waiting for its next block, which is stored to nextBlockIndex. Writing any
+ * other block ends the multi-block write.
+ */
+bool sdcard_isWritingBlocks(uint32_t *nextBlockIndex) {
+    if (sdcard.state != SDCARD_STATE_WRITING_MULTIPLE_BLOCKS) {
+        return false;
+    }
+    *nextBlockIndex = sdcard.multiWriteNextBlock;
+    return true;
+}
+
 /**
  * Begin writing a series of consecutive blocks beginning at the given block index. This will allow (but not require)
  * the SD card to pre-erase the number of blocks you specifiy, which can allow the writes to complete faster.
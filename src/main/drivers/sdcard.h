@@ -63,6 +63,7 @@ bool sdcard_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationComp
 
 sdcardOperationStatus_e sdcard_beginWriteBlocks(uint32_t blockIndex, uint32_t blockCount);
 sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
+bool sdcard_isWritingBlocks(uint32_t *nextBlockIndex);
 
 void sdcardInsertionDetectDeinit(void);
 void sdcardInsertionDetectInit(void);
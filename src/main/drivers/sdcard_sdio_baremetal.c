@@ -50,9 +50,11 @@
 #define SDCARD_TIMEOUT_INIT_MILLIS      200
 #define SDCARD_MAX_CONSECUTIVE_FAILURES 8
 
-// Use this to speed up writing to SDCARD... asyncfatfs has limited support for multiblock write
+// Use this to speed up writing to SDCARD... consecutive blocks of a multi-block write are queued here and sent in one DMA transfer
+#ifndef FATFS_BLOCK_CACHE_SIZE
 #define FATFS_BLOCK_CACHE_SIZE 16
-uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (4)));
+#endif
+DMA_RAM uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE];
 uint32_t cacheCount = 0;
 
 void cache_write(uint8_t *buffer) {
@@ -171,6 +173,8 @@ bool sdcard_isFunctional(void) {
  * the next call to sdcard_init().
  */
 static void sdcard_reset(void) {
+    // Anything still queued for a multi-block write is lost along with the chain
+    cache_reset();
     if (SD_Init() != 0) {
         sdcard.failureCount++;
         if (sdcard.failureCount >= SDCARD_MAX_CONSECUTIVE_FAILURES || sdcard_isInserted() == SD_NOT_PRESENT) {
@@ -317,10 +321,24 @@ static bool sdcard_isReady() {
  *
  */
 static sdcardOperationStatus_e sdcard_endWriteBlocks() {
-    sdcard.multiWriteBlocksRemain = 0;
-    if (sdcard.useCache) {
-        cache_reset();
+    if (sdcard.useCache && cache_getCount() > 0) {
+        /*
+         * The chain is being cut short, but the blocks waiting in the write cache were already reported as written, so
+         * send them first. The multi-block write ends once they're on the card.
+         */
+        const uint16_t blockCount = cache_getCount();
+        sdcard.multiWriteBlocksRemain = 1;
+        sdcard.pendingOperation.blockIndex = sdcard.multiWriteNextBlock - blockCount;
+        sdcard.pendingOperation.callback = NULL;
+        sdcard.state = SDCARD_STATE_SENDING_WRITE;
+        if (SD_WriteBlocks_DMA(sdcard.pendingOperation.blockIndex, (uint32_t*) writeCache, 512, blockCount) != SD_OK) {
+            cache_reset();
+            sdcard.multiWriteBlocksRemain = 0;
+            sdcard_reset();
+        }
+        return SDCARD_OPERATION_IN_PROGRESS;
     }
+    sdcard.multiWriteBlocksRemain = 0;
     // 8 dummy clocks to guarantee N_WR clocks between the last card response and this token
     // Card may choose to raise a busy (non-0xFF) signal after at most N_BR (1 byte) delay
     if (SD_GetState()) {
@@ -396,13 +414,14 @@ doMore:
             profilingComplete = true;
 #endif
             sdcard.failureCount = 0; // Assume the card is good if it can complete a write
+            // Whatever was queued in the write cache went out with that transfer
+            if (sdcard.useCache) {
+                cache_reset();
+            }
             // Still more blocks left to write in a multi-block chain?
             if (sdcard.multiWriteBlocksRemain > 1) {
                 sdcard.multiWriteBlocksRemain--;
                 sdcard.multiWriteNextBlock++;
-                if (sdcard.useCache) {
-                    cache_reset();
-                }
                 sdcard.state = SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
             } else if (sdcard.multiWriteBlocksRemain == 1) {
                 // This function changes the sd card state for us whether immediately succesful or delayed:
@@ -531,7 +550,8 @@ doMore:
         } else {
             sdcard.multiWriteBlocksRemain--;
             sdcard.multiWriteNextBlock++;
-            sdcard.state = SDCARD_STATE_READY;
+            // Stay in the chain so that a write elsewhere or a read flushes the queued blocks first
+            sdcard.state = SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
             return SDCARD_OPERATION_SUCCESS;
         }
     }
@@ -553,6 +573,18 @@ doMore:
     return SDCARD_OPERATION_IN_PROGRESS;
 }
 
+/**
+ * Returns true while a multi-block write is waiting for its next block, which is stored to nextBlockIndex. Writing any
+ * other block ends the multi-block write.
+ */
+bool sdcard_isWritingBlocks(uint32_t *nextBlockIndex) {
+    if (sdcard.state != SDCARD_STATE_WRITING_MULTIPLE_BLOCKS) {
+        return false;
+    }
+    *nextBlockIndex = sdcard.multiWriteNextBlock;
+    return true;
+}
+
 /**
  * Begin writing a series of consecutive blocks beginning at the given block index. This will allow (but not require)
  * the SD card to pre-erase the number of blocks you specifiy, which can allow the writes to complete faster.
@@ -106,3 +106,19 @@ void serialEndWrite(serialPort_t *instance) {
     if (instance->vTable->endWrite)
         instance->vTable->endWrite(instance);
 }
+
+/*
+ * Lend out the transmit buffer of an idle port, so a frame can be built where it will be sent from. Returns NULL if
+ * the port is busy or can't do this. Nothing else may write to the port until serialCommitTxBuf() is called.
+ */
+uint8_t *serialGetTxBuf(serialPort_t *instance, uint32_t *available) {
+    if (instance->vTable->getTxBuf)
+        return instance->vTable->getTxBuf(instance, available);
+    return NULL;
+}
+
+// Send the first count bytes of the buffer handed out by serialGetTxBuf()
+void serialCommitTxBuf(serialPort_t *instance, uint32_t count) {
+    if (instance->vTable->commitTxBuf)
+        instance->vTable->commitTxBuf(instance, count);
+}
@@ -123,6 +123,9 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+    // Optional functions to build data in place in an idle transmit buffer, then send it.
+    uint8_t *(*getTxBuf)(serialPort_t *instance, uint32_t *available);
+    void (*commitTxBuf)(serialPort_t *instance, uint32_t count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -142,3 +145,5 @@ uint32_t serialGetBaudRate(serialPort_t *instance);
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+uint8_t *serialGetTxBuf(serialPort_t *instance, uint32_t *available);
+void serialCommitTxBuf(serialPort_t *instance, uint32_t count);
@@ -711,7 +711,9 @@ const struct serialPortVTable escSerialVTable[] = {
         .setBaudRateCb = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
-        .endWrite = NULL
+        .endWrite = NULL,
+        .getTxBuf = NULL,
+        .commitTxBuf = NULL
     }
 };
 
@@ -35,10 +35,13 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/dma.h"
 #include "drivers/nvic.h"
 #include "drivers/io.h"
+#include "drivers/time.h"
 #include "timer.h"
 
 #include "serial.h"
@@ -55,6 +58,13 @@
 #define MAX_SOFTSERIAL_PORTS 1
 #endif
 
+#ifdef USE_SOFTSERIAL_DMA
+// edge timestamps the capture DMA can hold, a byte has at most RX_TOTAL_BITS edges
+#define SOFTSERIAL_DMA_EDGE_COUNT 128
+// resolution of the free running capture timebase
+#define SOFTSERIAL_DMA_TICKS_PER_BIT 16
+#endif
+
 typedef enum {
     TIMER_MODE_SINGLE,
     TIMER_MODE_DUAL,
@@ -98,11 +108,35 @@ typedef struct softSerial_s {
 
     timerOvrHandlerRec_t overCb;
     timerCCHandlerRec_t edgeCb;
+
+#ifdef USE_SOFTSERIAL_DMA
+    // receiving from input capture DMA, decoded when the port is read
+    bool             rxDma;
+    DMA_Stream_TypeDef *rxDmaStream;
+    dmaChannelDescriptor_t *rxDmaDescriptor;
+    volatile uint16_t rxDmaBuffer[SOFTSERIAL_DMA_EDGE_COUNT];
+    uint16_t         rxDmaTail;
+
+    uint16_t         bitPrescaler;      // bit clock timebase, restored for transmitting on a half duplex port
+    uint16_t         bitAutoreload;
+    uint16_t         capturePrescaler;
+    uint32_t         captureBitTicks;   // bit length in capture ticks, 24.8 fixed point
+    timeUs_t         captureFrameUs;
+
+    bool             rxInFrame;
+    uint8_t          rxFrameBit;
+    uint8_t          rxFrameLevel;
+    uint16_t         rxFrameStart;
+    uint16_t         rxFrameBits;
+    timeUs_t         rxFrameSeenAtUs;
+
+    timerOvrHandlerRec_t captureOverCb;
+#endif
 } softSerial_t;
 
 static const struct serialPortVTable softSerialVTable; // Forward
 
-static softSerial_t softSerialPorts[MAX_SOFTSERIAL_PORTS];
+static DMA_RAM softSerial_t softSerialPorts[MAX_SOFTSERIAL_PORTS];
 
 void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture);
 void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture);
@@ -126,6 +160,158 @@ static void serialEnableCC(softSerial_t *softSerial) {
 #endif
 }
 
+#ifdef USE_SOFTSERIAL_DMA
+// Written directly rather than through timerConfigure(), the HAL version of which only configures a timer once.
+static void serialTimerSetTimebase(TIM_TypeDef *tim, uint16_t prescaler, uint16_t autoreload) {
+    // loading the new prescaler must not look like an overflow to the bit clock handler
+    tim->CR1 |= TIM_CR1_URS;
+    tim->PSC = prescaler;
+    tim->ARR = autoreload;
+    tim->EGR = TIM_EGR_UG;
+    tim->CR1 &= ~TIM_CR1_URS;
+}
+
+static void serialRxDmaConfigureTimebase(softSerial_t *softSerial, uint32_t baud) {
+    TIM_TypeDef *tim = softSerial->timerHardware->tim;
+    softSerial->bitPrescaler = tim->PSC;
+    softSerial->bitAutoreload = tim->ARR;
+    const uint32_t clock = timerClock(tim);
+    const uint32_t divider = constrain(clock / (baud * SOFTSERIAL_DMA_TICKS_PER_BIT), 1, 0x10000);
+    softSerial->capturePrescaler = divider - 1;
+    softSerial->captureBitTicks = (uint32_t)(((uint64_t)(clock / divider) << 8) / baud);
+    softSerial->captureFrameUs = RX_TOTAL_BITS * 1000000 / baud + 1;
+}
+
+static uint32_t serialRxDmaBitAt(const softSerial_t *softSerial, uint16_t ticks) {
+    const uint16_t sinceStart = ticks - softSerial->rxFrameStart;
+    return (((uint32_t)sinceStart << 8) + softSerial->captureBitTicks / 2) / softSerial->captureBitTicks;
+}
+
+static void serialRxDmaFillBits(softSerial_t *softSerial, uint8_t untilBit) {
+    if (softSerial->rxFrameLevel) {
+        for (uint8_t bitToSet = softSerial->rxFrameBit; bitToSet < untilBit; bitToSet++) {
+            softSerial->rxFrameBits |= 1 << bitToSet;
+        }
+    }
+    softSerial->rxFrameBit = MAX(softSerial->rxFrameBit, untilBit);
+}
+
+static void serialRxDmaEndFrame(softSerial_t *softSerial) {
+    serialRxDmaFillBits(softSerial, RX_TOTAL_BITS);
+    softSerial->rxInFrame = false;
+    const bool haveStartBit = (softSerial->rxFrameBits & (1 << 0)) == 0;
+    const bool haveStopBit = (softSerial->rxFrameBits & (1 << (RX_TOTAL_BITS - 1))) != 0;
+    if (!haveStartBit || !haveStopBit) {
+        softSerial->receiveErrors++;
+        return;
+    }
+    softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = (softSerial->rxFrameBits >> 1) & 0xFF;
+    softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+}
+
+// Turns the captured edge timestamps into bytes. The line level is tracked from the idle state, every edge toggles it,
+// so the capture does not need to know the polarity. Runs at interrupt priority NVIC_PRIO_TIMER.
+static void serialRxDmaDecode(softSerial_t *softSerial) {
+    // sampled before the buffer, so every edge older than now is in it
+    const uint16_t now = softSerial->timerHardware->tim->CNT;
+    const uint16_t head = (SOFTSERIAL_DMA_EDGE_COUNT - softSerial->rxDmaStream->NDTR) % SOFTSERIAL_DMA_EDGE_COUNT;
+    while (softSerial->rxDmaTail != head) {
+        const uint16_t edge = softSerial->rxDmaBuffer[softSerial->rxDmaTail];
+        softSerial->rxDmaTail = (softSerial->rxDmaTail + 1) % SOFTSERIAL_DMA_EDGE_COUNT;
+        if (softSerial->rxInFrame) {
+            const uint32_t bit = serialRxDmaBitAt(softSerial, edge);
+            if (bit < RX_TOTAL_BITS) {
+                serialRxDmaFillBits(softSerial, bit);
+                softSerial->rxFrameLevel ^= 1;
+                continue;
+            }
+            serialRxDmaEndFrame(softSerial);
+        }
+        // an edge on the idle line is a start bit
+        softSerial->rxInFrame = true;
+        softSerial->rxFrameStart = edge;
+        softSerial->rxFrameBit = 0;
+        softSerial->rxFrameLevel = 0;
+        softSerial->rxFrameBits = 0;
+        softSerial->rxFrameSeenAtUs = micros();
+    }
+    // the last byte of a burst has no edge after it; the micros check covers a counter that wrapped since its start bit
+    if (softSerial->rxInFrame && (serialRxDmaBitAt(softSerial, now) >= RX_TOTAL_BITS
+        || cmpTimeUs(micros(), softSerial->rxFrameSeenAtUs) > (timeDelta_t)softSerial->captureFrameUs)) {
+        serialRxDmaEndFrame(softSerial);
+    }
+}
+
+static void serialRxDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    softSerial_t *softSerial = (softSerial_t *)descriptor->userParam;
+    DMA_CLEAR_FLAG(descriptor, (DMA_IT_HTIF | DMA_IT_TCIF));
+    // decode before the capture buffer wraps, when no task has read the port for a while
+    serialRxDmaDecode(softSerial);
+}
+
+static void serialRxDmaStart(softSerial_t *softSerial) {
+    const timerHardware_t *timerHardware = softSerial->timerHardware;
+    TIM_TypeDef *tim = timerHardware->tim;
+    DMA_Stream_TypeDef *stream = softSerial->rxDmaStream;
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN);
+    DMA_CLEAR_FLAG(softSerial->rxDmaDescriptor, (DMA_IT_HTIF | DMA_IT_TCIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF));
+    serialTimerSetTimebase(tim, softSerial->capturePrescaler, 0xFFFF);
+    timerChConfigIC(timerHardware, ICPOLARITY_FALLING, 0);
+    // capture both edges
+    tim->CCER |= (TIM_CCER_CC1P | TIM_CCER_CC1NP) << timerHardware->channel;
+    stream->PAR = (uint32_t)timerCCR(tim, timerHardware->channel);
+    stream->M0AR = (uint32_t)softSerial->rxDmaBuffer;
+    stream->NDTR = SOFTSERIAL_DMA_EDGE_COUNT;
+    stream->FCR = 0;
+    stream->CR = timerHardware->dmaChannel | DMA_SxCR_PL_0 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC
+        | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+    softSerial->rxDmaTail = 0;
+    softSerial->rxInFrame = false;
+    stream->CR |= DMA_SxCR_EN;
+    tim->DIER |= timerDmaSource(timerHardware->channel);
+}
+
+static void serialRxDmaStop(softSerial_t *softSerial) {
+    const timerHardware_t *timerHardware = softSerial->timerHardware;
+    timerHardware->tim->DIER &= ~timerDmaSource(timerHardware->channel);
+    serialRxDmaDecode(softSerial);
+    softSerial->rxInFrame = false;
+    softSerial->rxDmaStream->CR &= ~DMA_SxCR_EN;
+    while (softSerial->rxDmaStream->CR & DMA_SxCR_EN);
+    serialTimerSetTimebase(timerHardware->tim, softSerial->bitPrescaler, softSerial->bitAutoreload);
+}
+
+static void onSerialCaptureOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture) {
+    UNUSED(capture);
+    softSerial_t *self = container_of(cbRec, softSerial_t, captureOverCb);
+    serialRxDmaDecode(self);
+}
+
+// Bytes are only decoded when the port is read, so ports delivering to a receive callback keep the edge interrupt,
+// as do full duplex ports on a single timer, which need its bit clock for transmitting while receiving.
+static bool serialRxDmaInit(softSerial_t *softSerial, softSerialPortIndex_e portIndex) {
+    const timerHardware_t *timerHardware = softSerial->timerHardware;
+    const portMode_e mode = softSerial->port.mode;
+    if (!(mode & MODE_RX) || softSerial->port.rxCallback || !timerHardware->dmaRef) {
+        return false;
+    }
+    if ((mode & MODE_TX) && !(softSerial->port.options & SERIAL_BIDIR) && softSerial->timerMode != TIMER_MODE_DUAL) {
+        return false;
+    }
+    const dmaIdentifier_e identifier = dmaGetIdentifier(timerHardware->dmaRef);
+    if (softSerial->rxDmaStream != timerHardware->dmaRef && dmaGetOwner(identifier) != OWNER_FREE) {
+        return false;
+    }
+    dmaInit(identifier, OWNER_SERIAL_RX, RESOURCE_INDEX(portIndex + RESOURCE_SOFT_OFFSET));
+    dmaSetHandler(identifier, serialRxDmaIrqHandler, NVIC_PRIO_TIMER, (uint32_t)softSerial);
+    softSerial->rxDmaStream = timerHardware->dmaRef;
+    softSerial->rxDmaDescriptor = dmaGetDescriptorByIdentifier(identifier);
+    serialRxDmaConfigureTimebase(softSerial, softSerial->port.baudRate);
+    return true;
+}
+#endif
+
 static void serialInputPortActivate(softSerial_t *softSerial) {
     if (softSerial->port.options & SERIAL_INVERTED) {
 #ifdef STM32F1
@@ -145,6 +331,11 @@ static void serialInputPortActivate(softSerial_t *softSerial) {
     softSerial->rxActive = true;
     softSerial->isSearchingForStartBit = true;
     softSerial->rxBitIndex = 0;
+#ifdef USE_SOFTSERIAL_DMA
+    if (softSerial->rxDma) {
+        serialRxDmaStart(softSerial);
+    }
+#endif
     // Enable input capture
     serialEnableCC(softSerial);
 }
@@ -155,6 +346,11 @@ static void serialInputPortDeActivate(softSerial_t *softSerial) {
     TIM_CCxChannelCmd(softSerial->timerHardware->tim, softSerial->timerHardware->channel, TIM_CCx_DISABLE);
 #else
     TIM_CCxCmd(softSerial->timerHardware->tim, softSerial->timerHardware->channel, TIM_CCx_Disable);
+#endif
+#ifdef USE_SOFTSERIAL_DMA
+    if (softSerial->rxDma) {
+        serialRxDmaStop(softSerial);
+    }
 #endif
     IOConfigGPIO(softSerial->rxIO, IOCFG_IN_FLOATING);
     softSerial->rxActive = false;
@@ -279,18 +475,29 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
     // Initialize callbacks
     timerChCCHandlerInit(&softSerial->edgeCb, onSerialRxPinChange);
     timerChOvrHandlerInit(&softSerial->overCb, onSerialTimerOverflow);
+    softSerial->timerMode = ((mode & MODE_TX) && softSerial->exTimerHardware && softSerial->exTimerHardware->tim != softSerial->timerHardware->tim) ? TIMER_MODE_DUAL : TIMER_MODE_SINGLE;
+    timerCCHandlerRec_t *edgeCb = &softSerial->edgeCb;
+    timerOvrHandlerRec_t *rxOverCb = NULL;
+#ifdef USE_SOFTSERIAL_DMA
+    // With DMA the edges are not interrupts any more; the capture timer overflow still decodes,
+    // so the 16 bit timestamps cannot wrap unread.
+    softSerial->rxDma = serialRxDmaInit(softSerial, portIndex);
+    if (softSerial->rxDma) {
+        timerChOvrHandlerInit(&softSerial->captureOverCb, onSerialCaptureOverflow);
+        edgeCb = NULL;
+        rxOverCb = &softSerial->captureOverCb;
+    }
+#endif
     // Configure bit clock interrupt & handler.
     // If we have an extra timer (on TX), it is initialized and configured
     // for overflow interrupt.
     // Receiver input capture is configured when input is activated.
-    if ((mode & MODE_TX) && softSerial->exTimerHardware && softSerial->exTimerHardware->tim != softSerial->timerHardware->tim) {
-        softSerial->timerMode = TIMER_MODE_DUAL;
+    if (softSerial->timerMode == TIMER_MODE_DUAL) {
         serialTimerConfigureTimebase(softSerial->exTimerHardware, baud);
         timerChConfigCallbacks(softSerial->exTimerHardware, NULL, &softSerial->overCb);
-        timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, NULL);
+        timerChConfigCallbacks(softSerial->timerHardware, edgeCb, rxOverCb);
     } else {
-        softSerial->timerMode = TIMER_MODE_SINGLE;
-        timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, &softSerial->overCb);
+        timerChConfigCallbacks(softSerial->timerHardware, edgeCb, &softSerial->overCb);
     }
 #ifdef USE_HAL_DRIVER
     softSerial->timerHandle = timerFindTimerHandle(softSerial->timerHardware->tim);
@@ -421,6 +628,14 @@ void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture
     softSerial_t *self = container_of(cbRec, softSerial_t, overCb);
     if (self->port.mode & MODE_TX)
         processTxState(self);
+#ifdef USE_SOFTSERIAL_DMA
+    if (self->rxDma) {
+        if (self->rxActive) {
+            serialRxDmaDecode(self);
+        }
+        return;
+    }
+#endif
     if (self->port.mode & MODE_RX)
         processRxState(self);
 }
@@ -484,6 +699,13 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance) {
         return 0;
     }
     softSerial_t *s = (softSerial_t *)instance;
+#ifdef USE_SOFTSERIAL_DMA
+    if (s->rxDma && s->rxActive) {
+        ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+            serialRxDmaDecode(s);
+        }
+    }
+#endif
     return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
 }
 
@@ -515,12 +737,33 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch) {
     }
     s->txBuffer[s->txBufferHead] = ch;
     s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+#ifdef USE_SOFTSERIAL_DMA
+    softSerial_t *softSerial = (softSerial_t *)s;
+    if (softSerial->rxDma && softSerial->rxActive && (s->options & SERIAL_BIDIR)) {
+        // the capture timebase overflows rarely, so turn the line around now rather than at the next overflow
+        softSerial->timerHardware->tim->EGR = TIM_EGR_UG;
+    }
+#endif
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate) {
     softSerial_t *softSerial = (softSerial_t *)s;
     softSerial->port.baudRate = baudRate;
+#ifdef USE_SOFTSERIAL_DMA
+    const bool restartRxDma = softSerial->rxDma && softSerial->rxActive;
+    if (restartRxDma) {
+        serialRxDmaStop(softSerial);
+    }
+#endif
     serialTimerConfigureTimebase(softSerial->timerHardware, baudRate);
+#ifdef USE_SOFTSERIAL_DMA
+    if (softSerial->rxDma) {
+        serialRxDmaConfigureTimebase(softSerial, baudRate);
+    }
+    if (restartRxDma) {
+        serialRxDmaStart(softSerial);
+    }
+#endif
 }
 
 void softSerialSetMode(serialPort_t *instance, portMode_e mode) {
@@ -543,7 +786,9 @@ static const struct serialPortVTable softSerialVTable = {
     .setBaudRateCb = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .getTxBuf = NULL,
+    .commitTxBuf = NULL
 };
 
 #endif
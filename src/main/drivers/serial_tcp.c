@@ -27,12 +27,20 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -40,42 +48,208 @@
 
 #define BASE_PORT 5760
 
+STATIC_ASSERT(SERIAL_PORT_COUNT < SIMULATOR_PORT_STRIDE, too_many_tcp_ports_for_instance_stride);
+
 static const struct serialPortVTable tcpVTable; // Forward
 static tcpPort_t tcpSerialPorts[SERIAL_PORT_COUNT];
 static bool tcpPortInitialized[SERIAL_PORT_COUNT];
 static bool tcpStart = false;
+static bool tcpNoDelay = true;
+// Writers poke the event loop through this pipe when they leave bytes to send
+static int wakeupPipe[2] = { -1, -1 };
+static bool wakeupPending;
+
 bool tcpIsStart(void) {
     return tcpStart;
 }
-static void onData(dyad_Event *e) {
-    tcpPort_t* s = (tcpPort_t*)(e->udata);
-    tcpDataIn(s, (uint8_t*)e->data, e->size);
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void tcpWakeup(void) {
+    if (!__atomic_exchange_n(&wakeupPending, true, __ATOMIC_ACQ_REL)) {
+        const char c = 0;
+        if (write(wakeupPipe[1], &c, 1) < 0) {
+            __atomic_store_n(&wakeupPending, false, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+static uint32_t txBytesPending(const tcpPort_t *s) {
+    if (s->port.txBufferHead >= s->port.txBufferTail) {
+        return s->port.txBufferHead - s->port.txBufferTail;
+    }
+    return s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
+}
+
+static uint32_t rxBytesFree(const tcpPort_t *s) {
+    uint32_t bytesUsed;
+    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
+        bytesUsed = s->port.rxBufferHead - s->port.rxBufferTail;
+    } else {
+        bytesUsed = s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
+    }
+    return (s->port.rxBufferSize - 1) - bytesUsed;
 }
-static void onClose(dyad_Event *e) {
-    tcpPort_t* s = (tcpPort_t*)(e->udata);
+
+static void tcpClose(tcpPort_t *s) {
+    close(s->clientFd);
+    pthread_mutex_lock(&s->txLock);
+    s->clientFd = -1;
     s->clientCount--;
-    s->conn = NULL;
+    s->connected = false;
+    // nobody to send the rest to
+    s->port.txBufferTail = s->port.txBufferHead;
+    pthread_cond_broadcast(&s->txDrained);
+    pthread_mutex_unlock(&s->txLock);
     fprintf(stderr, "[CLS]UART%u: %d,%d\n", s->id + 1, s->connected, s->clientCount);
-    if (s->clientCount == 0) {
-        s->connected = false;
-    }
 }
-static void onAccept(dyad_Event *e) {
-    tcpPort_t* s = (tcpPort_t*)(e->udata);
+
+static void tcpAccept(tcpPort_t *s) {
+    const int fd = accept(s->serverFd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
     fprintf(stderr, "New connection on UART%u, %d\n", s->id + 1, s->clientCount);
-    s->connected = true;
     if (s->clientCount > 0) {
-        dyad_close(e->remote);
+        close(fd);
         return;
     }
+    setNonBlocking(fd);
+    const int noDelay = tcpNoDelay;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    pthread_mutex_lock(&s->txLock);
+    s->clientFd = fd;
     s->clientCount++;
+    s->connected = true;
+    pthread_mutex_unlock(&s->txLock);
     fprintf(stderr, "[NEW]UART%u: %d,%d\n", s->id + 1, s->connected, s->clientCount);
-    s->conn = e->remote;
-    dyad_setNoDelay(e->remote, 1);
-    dyad_setTimeout(e->remote, 120);
-    dyad_addListener(e->remote, DYAD_EVENT_DATA, onData, e->udata);
-    dyad_addListener(e->remote, DYAD_EVENT_CLOSE, onClose, e->udata);
 }
+
+static void tcpReceive(tcpPort_t *s) {
+    uint8_t buf[RX_BUFFER_SIZE];
+    pthread_mutex_lock(&s->rxLock);
+    const uint32_t room = rxBytesFree(s);
+    pthread_mutex_unlock(&s->rxLock);
+    const ssize_t n = recv(s->clientFd, buf, MIN(room, sizeof(buf)), 0);
+    if (n > 0) {
+        tcpDataIn(s, buf, n);
+    } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+        tcpClose(s);
+    }
+}
+
+// Sends as much of the tx buffer as the socket takes, at most two send() calls however many writes filled it
+static void tcpSend(tcpPort_t *s) {
+    pthread_mutex_lock(&s->txLock);
+    bool failed = false;
+    while (s->port.txBufferTail != s->port.txBufferHead) {
+        const uint32_t chunk = s->port.txBufferHead > s->port.txBufferTail
+            ? s->port.txBufferHead - s->port.txBufferTail
+            : s->port.txBufferSize - s->port.txBufferTail;
+        const ssize_t n = send(s->clientFd, (const void *)&s->port.txBuffer[s->port.txBufferTail], chunk, MSG_NOSIGNAL);
+        if (n < 0) {
+            failed = errno != EAGAIN && errno != EINTR;
+            break;
+        }
+        s->port.txBufferTail = (s->port.txBufferTail + n) % s->port.txBufferSize;
+        if ((uint32_t)n < chunk) {
+            break;
+        }
+    }
+    pthread_cond_broadcast(&s->txDrained);
+    pthread_mutex_unlock(&s->txLock);
+    if (failed) {
+        tcpClose(s);
+    }
+}
+
+/*
+ * One pass of the event loop of all tcp uarts, run by the tcp thread. Waits up to timeoutMs for a connection, data or
+ * a writer to leave bytes behind, then accepts, receives into and sends from the ports that are ready.
+ */
+void tcpUpdate(int timeoutMs) {
+    struct pollfd fds[1 + 2 * SERIAL_PORT_COUNT];
+    tcpPort_t *fdPort[ARRAYLEN(fds)];
+    int count = 0;
+    if (wakeupPipe[0] >= 0) {
+        fds[count].fd = wakeupPipe[0];
+        fds[count].events = POLLIN;
+        fdPort[count++] = NULL;
+    }
+    for (int id = 0; id < SERIAL_PORT_COUNT; id++) {
+        tcpPort_t *s = &tcpSerialPorts[id];
+        if (!tcpPortInitialized[id] || s->serverFd < 0) {
+            continue;
+        }
+        fds[count].fd = s->serverFd;
+        fds[count].events = POLLIN;
+        fdPort[count++] = s;
+        if (s->clientFd >= 0) {
+            pthread_mutex_lock(&s->txLock);
+            const bool txPending = txBytesPending(s) > 0;
+            pthread_mutex_unlock(&s->txLock);
+            pthread_mutex_lock(&s->rxLock);
+            const bool rxRoom = rxBytesFree(s) > 0;
+            pthread_mutex_unlock(&s->rxLock);
+            // a full rx buffer leaves the bytes in the socket, so tcp holds the sender back
+            fds[count].fd = s->clientFd;
+            fds[count].events = (rxRoom ? POLLIN : 0) | (txPending ? POLLOUT : 0);
+            fdPort[count++] = s;
+        }
+    }
+    if (count == 0) {
+        usleep(timeoutMs * 1000);
+        return;
+    }
+    if (poll(fds, count, timeoutMs) <= 0) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        tcpPort_t *s = fdPort[i];
+        if (!fds[i].revents) {
+            continue;
+        }
+        if (!s) {
+            char drain[64];
+            __atomic_store_n(&wakeupPending, false, __ATOMIC_RELEASE);
+            while (read(wakeupPipe[0], drain, sizeof(drain)) > 0) {
+            }
+        } else if (fds[i].fd == s->serverFd) {
+            tcpAccept(s);
+        } else if (fds[i].fd == s->clientFd) {
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                tcpReceive(s);
+            }
+            if (s->clientFd >= 0 && (fds[i].revents & POLLOUT)) {
+                tcpSend(s);
+            }
+        }
+    }
+}
+
+static bool tcpListen(tcpPort_t *s, unsigned port) {
+    s->serverFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (s->serverFd < 0) {
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(s->serverFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(s->serverFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s->serverFd, 10) != 0) {
+        close(s->serverFd);
+        s->serverFd = -1;
+        return false;
+    }
+    setNonBlocking(s->serverFd);
+    return true;
+}
+
 static tcpPort_t* tcpReconfigure(tcpPort_t *s, int id) {
     if (tcpPortInitialized[id]) {
         fprintf(stderr, "port is already initialized!\n");
@@ -91,20 +265,33 @@ static tcpPort_t* tcpReconfigure(tcpPort_t *s, int id) {
         // TODO: clean up & re-init
         return NULL;
     }
-    tcpStart = true;
-    tcpPortInitialized[id] = true;
+    if (pthread_cond_init(&s->txDrained, NULL) != 0) {
+        fprintf(stderr, "TX cond init failed - %d\n", errno);
+        return NULL;
+    }
+    if (wakeupPipe[0] < 0) {
+        if (pipe(wakeupPipe) != 0) {
+            fprintf(stderr, "wakeup pipe failed - %d\n", errno);
+            return NULL;
+        }
+        setNonBlocking(wakeupPipe[0]);
+        setNonBlocking(wakeupPipe[1]);
+        const char *noDelay = getenv(SIMULATOR_TCP_NODELAY_ENV);
+        tcpNoDelay = !noDelay || atoi(noDelay) != 0;
+    }
     s->connected = false;
     s->clientCount = 0;
     s->id = id;
-    s->conn = NULL;
-    s->serv = dyad_newStream();
-    dyad_setNoDelay(s->serv, 1);
-    dyad_addListener(s->serv, DYAD_EVENT_ACCEPT, onAccept, s);
-    if (dyad_listenEx(s->serv, NULL, BASE_PORT + id + 1, 10) == 0) {
-        fprintf(stderr, "bind port %u for UART%u\n", (unsigned)BASE_PORT + id + 1, (unsigned)id + 1);
+    s->clientFd = -1;
+    s->batching = false;
+    const unsigned port = BASE_PORT + simulatorInstance() * SIMULATOR_PORT_STRIDE + id + 1;
+    if (tcpListen(s, port)) {
+        fprintf(stderr, "bind port %u for UART%u\n", port, (unsigned)id + 1);
     } else {
-        fprintf(stderr, "bind port %u for UART%u failed!!\n", (unsigned)BASE_PORT + id + 1, (unsigned)id + 1);
+        fprintf(stderr, "bind port %u for UART%u failed!!\n", port, (unsigned)id + 1);
     }
+    tcpPortInitialized[id] = true;
+    tcpStart = true;
     return s;
 }
 
@@ -149,14 +336,8 @@ uint32_t tcpTotalRxBytesWaiting(const serialPort_t *instance) {
 
 uint32_t tcpTotalTxBytesFree(const serialPort_t *instance) {
     tcpPort_t *s = (tcpPort_t*)instance;
-    uint32_t bytesUsed;
     pthread_mutex_lock(&s->txLock);
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
-    uint32_t bytesFree = (s->port.txBufferSize - 1) - bytesUsed;
+    uint32_t bytesFree = (s->port.txBufferSize - 1) - txBytesPending(s);
     pthread_mutex_unlock(&s->txLock);
     return bytesFree;
 }
@@ -183,34 +364,73 @@ uint8_t tcpRead(serialPort_t *instance) {
     return ch;
 }
 
-void tcpWrite(serialPort_t *instance, uint8_t ch) {
-    tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->txLock);
+static void tcpPutByte(tcpPort_t *s, uint8_t ch) {
     s->port.txBuffer[s->port.txBufferHead] = ch;
     if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
         s->port.txBufferHead = 0;
     } else {
         s->port.txBufferHead++;
     }
+}
+
+// Only queues the bytes, the tcp thread sends them; within beginWrite() / endWrite() it is woken once at the end
+void tcpWrite(serialPort_t *instance, uint8_t ch) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->txLock);
+    const bool wasEmpty = txBytesPending(s) == 0;
+    if (s->clientFd >= 0) {
+        tcpPutByte(s, ch);
+    }
+    const bool wake = wasEmpty && !s->batching && s->clientFd >= 0;
     pthread_mutex_unlock(&s->txLock);
-    tcpDataOut(s);
+    if (wake) {
+        tcpWakeup();
+    }
 }
 
-void tcpDataOut(tcpPort_t *instance) {
+// Copies as much as fits, then waits for the tcp thread to make room, bytes for a port with no client are dropped
+static void tcpWriteBuf(serialPort_t *instance, const void *data, int count) {
     tcpPort_t *s = (tcpPort_t *)instance;
-    if (s->conn == NULL) return;
+    const uint8_t *p = data;
     pthread_mutex_lock(&s->txLock);
-    if (s->port.txBufferHead < s->port.txBufferTail) {
-        // send data till end of buffer
-        int chunk = s->port.txBufferSize - s->port.txBufferTail;
-        dyad_write(s->conn, (const void *)&s->port.txBuffer[s->port.txBufferTail], chunk);
-        s->port.txBufferTail = 0;
-    }
-    int chunk = s->port.txBufferHead - s->port.txBufferTail;
-    if (chunk)
-        dyad_write(s->conn, (const void*)&s->port.txBuffer[s->port.txBufferTail], chunk);
-    s->port.txBufferTail = s->port.txBufferHead;
+    while (count > 0 && s->clientFd >= 0) {
+        uint32_t room = (s->port.txBufferSize - 1) - txBytesPending(s);
+        if (room == 0) {
+            pthread_mutex_unlock(&s->txLock);
+            tcpWakeup();
+            pthread_mutex_lock(&s->txLock);
+            while (s->clientFd >= 0 && (s->port.txBufferSize - 1) - txBytesPending(s) == 0) {
+                pthread_cond_wait(&s->txDrained, &s->txLock);
+            }
+            continue;
+        }
+        for (; room > 0 && count > 0; room--, count--) {
+            tcpPutByte(s, *p++);
+        }
+    }
+    const bool wake = !s->batching && txBytesPending(s) > 0;
     pthread_mutex_unlock(&s->txLock);
+    if (wake) {
+        tcpWakeup();
+    }
+}
+
+static void tcpBeginWrite(serialPort_t *instance) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->txLock);
+    s->batching = true;
+    pthread_mutex_unlock(&s->txLock);
+}
+
+static void tcpEndWrite(serialPort_t *instance) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->txLock);
+    s->batching = false;
+    const bool wake = txBytesPending(s) > 0;
+    pthread_mutex_unlock(&s->txLock);
+    if (wake) {
+        tcpWakeup();
+    }
 }
 
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size) {
@@ -239,7 +459,9 @@ static const struct serialPortVTable tcpVTable = {
     .setMode = NULL,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
-    .writeBuf = NULL,
-    .beginWrite = NULL,
-    .endWrite = NULL,
+    .writeBuf = tcpWriteBuf,
+    .beginWrite = tcpBeginWrite,
+    .endWrite = tcpEndWrite,
+    .getTxBuf = NULL,
+    .commitTxBuf = NULL,
 };
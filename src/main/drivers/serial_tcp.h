@@ -22,7 +22,6 @@
 
 #include <netinet/in.h>
 #include <pthread.h>
-#include "dyad.h"
 
 #define RX_BUFFER_SIZE    1400
 #define TX_BUFFER_SIZE    1400
@@ -32,10 +31,12 @@ typedef struct {
     uint8_t rxBuffer[RX_BUFFER_SIZE];
     uint8_t txBuffer[TX_BUFFER_SIZE];
 
-    dyad_Stream *serv;
-    dyad_Stream *conn;
+    int serverFd;
+    int clientFd;               // -1 while nobody is connected
     pthread_mutex_t txLock;
     pthread_mutex_t rxLock;
+    pthread_cond_t txDrained;   // the tcp thread sent some of the tx buffer
+    bool batching;              // between beginWrite() and endWrite()
     bool connected;
     uint16_t clientCount;
     uint8_t id;
@@ -45,7 +46,7 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
 
 // tcpPort API
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size);
-void tcpDataOut(tcpPort_t *instance);
+void tcpUpdate(int timeoutMs);
 
 bool tcpIsStart(void);
 bool* tcpGetUsed(void);
@@ -27,12 +27,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 #include "build/atomic.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/dma.h"
@@ -217,14 +219,7 @@ static uint8_t uartRead(serialPort_t *instance) {
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch) {
-    uartPort_t *s = (uartPort_t *)instance;
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
+static void uartStartTx(uartPort_t *s) {
 #ifdef STM32F4
     if (s->txDMAStream)
 #else
@@ -237,6 +232,70 @@ static void uartWrite(serialPort_t *instance, uint8_t ch) {
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch) {
+    uartPort_t *s = (uartPort_t *)instance;
+    s->port.txBuffer[s->port.txBufferHead] = ch;
+    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
+        s->port.txBufferHead = 0;
+    } else {
+        s->port.txBufferHead++;
+    }
+    if (!s->txBuffering || !uartTotalTxBytesFree(instance)) {
+        uartStartTx(s);
+    }
+}
+
+// Copies as much as fits with at most two memcpy per pass and starts the transmit once
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count) {
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+    while (count > 0) {
+        uint32_t room;
+        while (!(room = uartTotalTxBytesFree(instance))) {
+            uartStartTx(s); // a held back frame may be what fills the buffer
+        }
+        const uint32_t head = s->port.txBufferHead;
+        const uint32_t chunk = MIN((uint32_t)count, MIN(room, s->port.txBufferSize - head));
+        memcpy((uint8_t *)&s->port.txBuffer[head], p, chunk);
+        s->port.txBufferHead = (head + chunk >= s->port.txBufferSize) ? 0 : head + chunk;
+        p += chunk;
+        count -= chunk;
+    }
+    if (!s->txBuffering) {
+        uartStartTx(s);
+    }
+}
+
+static void uartBeginWrite(serialPort_t *instance) {
+    uartPort_t *s = (uartPort_t *)instance;
+    s->txBuffering = true;
+}
+
+static void uartEndWrite(serialPort_t *instance) {
+    uartPort_t *s = (uartPort_t *)instance;
+    s->txBuffering = false;
+    uartStartTx(s);
+}
+
+static uint8_t *uartGetTxBuf(serialPort_t *instance, uint32_t *available) {
+    uartPort_t *s = (uartPort_t *)instance;
+    if (!isUartTransmitBufferEmpty(instance) || s->port.txBufferHead != s->port.txBufferTail) {
+        return NULL;
+    }
+    // Nothing is reading the buffer any more, so the whole of it can be handed out from the start
+    s->port.txBufferHead = s->port.txBufferTail = 0;
+    *available = s->port.txBufferSize - 1;
+    return (uint8_t *)s->port.txBuffer;
+}
+
+static void uartCommitTxBuf(serialPort_t *instance, uint32_t count) {
+    uartPort_t *s = (uartPort_t *)instance;
+    if (count) {
+        s->port.txBufferHead = count;
+        uartStartTx(s);
+    }
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -248,9 +307,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
-        .beginWrite = NULL,
-        .endWrite = NULL,
+        .writeBuf = uartWriteBuf,
+        .beginWrite = uartBeginWrite,
+        .endWrite = uartEndWrite,
+        .getTxBuf = uartGetTxBuf,
+        .commitTxBuf = uartCommitTxBuf,
     }
 };
 
@@ -72,6 +72,7 @@ typedef struct uartPort_s {
 #endif
     USART_TypeDef *USARTx;
     bool txDMAEmpty;
+    bool txBuffering;   // between beginWrite and endWrite, hold the transmit back so a frame goes out in one go
 } uartPort_t;
 
 void uartPinConfigure(const serialPinConfig_t *pSerialPinConfig);
@@ -27,11 +27,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
@@ -118,6 +120,13 @@ void uartReconfigure(uartPort_t *uartPort) {
             __HAL_LINKDMA(&uartPort->Handle, hdmarx, uartPort->rxDMAHandle);
             HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
+#ifdef USE_UART_RX_DMA_IDLE
+            if (uartPort->port.rxCallback) {
+                // the callback is fed from the DMA buffer on idle line and half/full transfer
+                __HAL_DMA_ENABLE_IT(&uartPort->rxDMAHandle, DMA_IT_HT | DMA_IT_TC);
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+            }
+#endif
         } else {
             /* Enable the UART Parity Error Interrupt */
             SET_BIT(uartPort->USARTx->CR1, USART_CR1_PEIE);
@@ -167,6 +176,7 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr callback, v
         return (serialPort_t *)s;
     }
     s->txDMAEmpty = true;
+    s->txBuffering = false;
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
@@ -284,6 +294,15 @@ uint8_t uartRead(serialPort_t *instance) {
     return ch;
 }
 
+static void uartStartTx(uartPort_t *s) {
+    if (s->txDMAStream) {
+        if (!(s->txDMAStream->CR & 1))
+            uartStartTxDMA(s);
+    } else {
+        __HAL_UART_ENABLE_IT(&s->Handle, UART_IT_TXE);
+    }
+}
+
 void uartWrite(serialPort_t *instance, uint8_t ch) {
     uartPort_t *s = (uartPort_t *)instance;
     s->port.txBuffer[s->port.txBufferHead] = ch;
@@ -292,11 +311,59 @@ void uartWrite(serialPort_t *instance, uint8_t ch) {
     } else {
         s->port.txBufferHead++;
     }
-    if (s->txDMAStream) {
-        if (!(s->txDMAStream->CR & 1))
-            uartStartTxDMA(s);
-    } else {
-        __HAL_UART_ENABLE_IT(&s->Handle, UART_IT_TXE);
+    if (!s->txBuffering || !uartTotalTxBytesFree(instance)) {
+        uartStartTx(s);
+    }
+}
+
+// Copies as much as fits with at most two memcpy per pass and starts the transmit once
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count) {
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+    while (count > 0) {
+        uint32_t room;
+        while (!(room = uartTotalTxBytesFree(instance))) {
+            uartStartTx(s); // a held back frame may be what fills the buffer
+        }
+        const uint32_t head = s->port.txBufferHead;
+        const uint32_t chunk = MIN((uint32_t)count, MIN(room, s->port.txBufferSize - head));
+        memcpy((uint8_t *)&s->port.txBuffer[head], p, chunk);
+        s->port.txBufferHead = (head + chunk >= s->port.txBufferSize) ? 0 : head + chunk;
+        p += chunk;
+        count -= chunk;
+    }
+    if (!s->txBuffering) {
+        uartStartTx(s);
+    }
+}
+
+static void uartBeginWrite(serialPort_t *instance) {
+    uartPort_t *s = (uartPort_t *)instance;
+    s->txBuffering = true;
+}
+
+static void uartEndWrite(serialPort_t *instance) {
+    uartPort_t *s = (uartPort_t *)instance;
+    s->txBuffering = false;
+    uartStartTx(s);
+}
+
+static uint8_t *uartGetTxBuf(serialPort_t *instance, uint32_t *available) {
+    uartPort_t *s = (uartPort_t *)instance;
+    if (!isUartTransmitBufferEmpty(instance) || s->port.txBufferHead != s->port.txBufferTail) {
+        return NULL;
+    }
+    // Nothing is reading the buffer any more, so the whole of it can be handed out from the start
+    s->port.txBufferHead = s->port.txBufferTail = 0;
+    *available = s->port.txBufferSize - 1;
+    return (uint8_t *)s->port.txBuffer;
+}
+
+static void uartCommitTxBuf(serialPort_t *instance, uint32_t count) {
+    uartPort_t *s = (uartPort_t *)instance;
+    if (count) {
+        s->port.txBufferHead = count;
+        uartStartTx(s);
     }
 }
 
@@ -311,9 +378,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
-        .beginWrite = NULL,
-        .endWrite = NULL,
+        .writeBuf = uartWriteBuf,
+        .beginWrite = uartBeginWrite,
+        .endWrite = uartEndWrite,
+        .getTxBuf = uartGetTxBuf,
+        .commitTxBuf = uartCommitTxBuf,
     }
 };
 
@@ -106,10 +106,11 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     if (!s)
         return (serialPort_t *)s;
     s->txDMAEmpty = true;
+    s->txBuffering = false;
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // callback works for IRQ-based RX, or RX DMA with USE_UART_RX_DMA_IDLE
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
@@ -154,6 +155,13 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
             DMA_Cmd(s->rxDMAStream, ENABLE);
             USART_DMACmd(s->USARTx, USART_DMAReq_Rx, ENABLE);
             s->rxDMAPos = DMA_GetCurrDataCounter(s->rxDMAStream);
+#ifdef USE_UART_RX_DMA_IDLE
+            if (s->port.rxCallback) {
+                // the callback is fed from the DMA buffer on idle line and half/full transfer
+                DMA_ITConfig(s->rxDMAStream, DMA_IT_HT | DMA_IT_TC, ENABLE);
+                USART_ITConfig(s->USARTx, USART_IT_IDLE, ENABLE);
+            }
+#endif
 #else
             DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
             DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
@@ -34,6 +34,7 @@
 #include "drivers/system.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "drivers/dma.h"
 #include "drivers/rcc.h"
 
@@ -115,6 +116,12 @@ void uart_tx_dma_IRQHandler(dmaChannelDescriptor_t* descriptor) {
     uartTryStartTxDMA(s);
 }
 
+static bool uartTxDmaIsFree(dmaIdentifier_e identifier)
+{
+    const resourceOwner_e owner = dmaGetOwner(identifier);
+    return owner == OWNER_FREE || owner == OWNER_SERIAL_TX;
+}
+
 // XXX Should serialUART be consolidated?
 
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options) {
@@ -137,7 +144,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         s->rxDMAChannel = hardware->rxDMAChannel;
         s->rxDMAPeripheralBaseAddr = (uint32_t)&s->USARTx->DR;
     }
-    if (hardware->txDMAChannel) {
+    // a channel some other driver already claimed is left alone and the port falls back to the TXE interrupt
+    if (hardware->txDMAChannel && uartTxDmaIsFree(dmaGetIdentifier(hardware->txDMAChannel))) {
         const dmaIdentifier_e identifier = dmaGetIdentifier(hardware->txDMAChannel);
         dmaInit(identifier, OWNER_SERIAL_TX, RESOURCE_INDEX(device));
         dmaSetHandler(identifier, uart_tx_dma_IRQHandler, hardware->txPriority, (uint32_t)s);
@@ -160,7 +168,7 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
     // RX/TX Interrupt
-    if (!hardware->rxDMAChannel || !hardware->txDMAChannel) {
+    if (!s->rxDMAChannel || !s->txDMAChannel) {
         NVIC_InitTypeDef NVIC_InitStructure;
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
         NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
@@ -172,6 +180,7 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 }
 
 void uartIrqHandler(uartPort_t *s) {
+    STACK_CHECK_IRQ_ENTRY();
     uint16_t SR = s->USARTx->SR;
     if (SR & USART_FLAG_RXNE && !s->rxDMAChannel) {
         // If we registered a callback, pass crap there
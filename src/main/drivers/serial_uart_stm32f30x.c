@@ -35,6 +35,7 @@
 #include "drivers/system.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "drivers/dma.h"
 #include "drivers/rcc.h"
 
@@ -200,6 +201,12 @@ void serialUARTInitIO(IO_t txIO, IO_t rxIO, portMode_e mode, portOptions_e optio
 
 // XXX Should serialUART be consolidated?
 
+static bool uartTxDmaIsFree(dmaIdentifier_e identifier)
+{
+    const resourceOwner_e owner = dmaGetOwner(identifier);
+    return owner == OWNER_FREE || owner == OWNER_SERIAL_TX;
+}
+
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options) {
     uartDevice_t *uartDev = uartDevmap[device];
     if (!uartDev) {
@@ -220,7 +227,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         s->rxDMAChannel = hardware->rxDMAChannel;
         s->rxDMAPeripheralBaseAddr = (uint32_t)&s->USARTx->RDR;
     }
-    if (hardware->txDMAChannel) {
+    // a channel some other driver already claimed is left alone and the port falls back to the TXE interrupt
+    if (hardware->txDMAChannel && uartTxDmaIsFree(dmaGetIdentifier(hardware->txDMAChannel))) {
         const dmaIdentifier_e identifier = dmaGetIdentifier(hardware->txDMAChannel);
         dmaInit(identifier, OWNER_SERIAL_TX, RESOURCE_INDEX(device));
         dmaSetHandler(identifier, handleUsartTxDma, hardware->txPriority, (uint32_t)s);
@@ -240,6 +248,7 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 }
 
 void uartIrqHandler(uartPort_t *s) {
+    STACK_CHECK_IRQ_ENTRY();
     uint32_t ISR = s->USARTx->ISR;
     if (!s->rxDMAChannel && (ISR & USART_FLAG_RXNE)) {
         if (s->port.rxCallback) {
@@ -27,10 +27,13 @@
 
 #include "platform.h"
 
+#include "build/cycle_profile.h"
+
 #include "drivers/system.h"
 #include "drivers/io.h"
 #include "drivers/dma.h"
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "drivers/rcc.h"
 
 #include "drivers/serial.h"
@@ -189,8 +192,36 @@ void dmaIRQHandler(dmaChannelDescriptor_t* descriptor) {
     }
 }
 
+#ifdef USE_UART_RX_DMA_IDLE
+// Hand everything the circular RX DMA has written since the last call to the rx callback.
+// Called on idle line and on half/full buffer, so a frame is delivered in one go.
+static void uartRxDmaDrain(uartPort_t *s) {
+    const uint32_t rxDMAHead = s->rxDMAStream->NDTR;
+    while (s->rxDMAPos != rxDMAHead) {
+        s->port.rxCallback(s->port.rxBuffer[s->port.rxBufferSize - s->rxDMAPos], s->port.rxCallbackData);
+        if (--s->rxDMAPos == 0) {
+            s->rxDMAPos = s->port.rxBufferSize;
+        }
+    }
+}
+
+static void rxDmaIRQHandler(dmaChannelDescriptor_t* descriptor) {
+    uartPort_t *s = &(((uartDevice_t*)(descriptor->userParam))->port);
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF | DMA_IT_TCIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+    if (s->port.rxCallback) {
+        uartRxDmaDrain(s);
+    }
+}
+#endif
+
 // XXX Should serialUART be consolidated?
 
+static bool uartTxDmaIsFree(dmaIdentifier_e identifier)
+{
+    const resourceOwner_e owner = dmaGetOwner(identifier);
+    return owner == OWNER_FREE || owner == OWNER_SERIAL_TX;
+}
+
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options) {
     uartDevice_t *uart = uartDevmap[device];
     if (!uart) return NULL;
@@ -205,12 +236,17 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
     s->port.txBufferSize = sizeof(uart->txBuffer);
     s->USARTx = hardware->reg;
     if (hardware->rxDMAStream) {
-        dmaInit(dmaGetIdentifier(hardware->rxDMAStream), OWNER_SERIAL_RX, RESOURCE_INDEX(device));
+        const dmaIdentifier_e identifier = dmaGetIdentifier(hardware->rxDMAStream);
+        dmaInit(identifier, OWNER_SERIAL_RX, RESOURCE_INDEX(device));
+#ifdef USE_UART_RX_DMA_IDLE
+        dmaSetHandler(identifier, rxDmaIRQHandler, hardware->rxPriority, (uint32_t)uart);
+#endif
         s->rxDMAChannel = hardware->DMAChannel;
         s->rxDMAStream = hardware->rxDMAStream;
         s->rxDMAPeripheralBaseAddr = (uint32_t)&s->USARTx->DR;
     }
-    if (hardware->txDMAStream) {
+    // a stream some other driver already claimed is left alone and the port falls back to the TXE interrupt
+    if (hardware->txDMAStream && uartTxDmaIsFree(dmaGetIdentifier(hardware->txDMAStream))) {
         const dmaIdentifier_e identifier = dmaGetIdentifier(hardware->txDMAStream);
         dmaInit(identifier, OWNER_SERIAL_TX, RESOURCE_INDEX(device));
         dmaSetHandler(identifier, dmaIRQHandler, hardware->txPriority, (uint32_t)uart);
@@ -236,7 +272,12 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
             IOConfigGPIOAF(rxIO, IOCFG_AF_PP_UP, hardware->af);
         }
     }
-    if (!(s->rxDMAChannel)) {
+#ifdef USE_UART_RX_DMA_IDLE
+    // the USART interrupt is still needed with RX DMA for idle line detection
+    {
+#else
+    if (!s->rxDMAChannel || !s->txDMAStream) {
+#endif
         NVIC_InitTypeDef NVIC_InitStructure;
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
         NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
@@ -248,6 +289,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 }
 
 void uartIrqHandler(uartPort_t *s) {
+    STACK_CHECK_IRQ_ENTRY();
+    CYCLE_ISR_BEGIN();
     if (!s->rxDMAStream && (USART_GetITStatus(s->USARTx, USART_IT_RXNE) == SET)) {
         if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
@@ -270,6 +313,11 @@ void uartIrqHandler(uartPort_t *s) {
     }
 
     if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+#ifdef USE_UART_RX_DMA_IDLE
+        if (s->rxDMAStream && s->port.rxCallback) {
+            uartRxDmaDrain(s);
+        }
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -278,5 +326,6 @@ void uartIrqHandler(uartPort_t *s) {
         (void) s->USARTx->SR;
         (void) s->USARTx->DR;
     }
+    CYCLE_ISR_END(UART);
 }
 #endif
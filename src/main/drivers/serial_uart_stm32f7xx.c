@@ -27,10 +27,13 @@
 
 #include "platform.h"
 
+#include "build/cycle_profile.h"
+
 #include "drivers/system.h"
 #include "drivers/dma.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "drivers/rcc.h"
 
 #include "drivers/serial.h"
@@ -40,6 +43,9 @@
 #ifdef USE_UART
 
 static void handleUsartTxDma(uartPort_t *s);
+#ifdef USE_UART_RX_DMA_IDLE
+static void uartRxDmaDrain(uartPort_t *s);
+#endif
 
 const uartHardware_t uartHardware[UARTDEV_COUNT] = {
 #ifdef USE_UART1
@@ -244,9 +250,11 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
 };
 
 void uartIrqHandler(uartPort_t *s) {
+    STACK_CHECK_IRQ_ENTRY();
+    CYCLE_ISR_BEGIN();
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
-    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
+    if (!s->rxDMAStream && (__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
         if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
@@ -302,12 +310,18 @@ void uartIrqHandler(uartPort_t *s) {
     }
 
         if (__HAL_UART_GET_IT(huart, UART_IT_IDLE)) {
+#ifdef USE_UART_RX_DMA_IDLE
+            if (s->rxDMAStream && s->port.rxCallback) {
+                uartRxDmaDrain(s);
+            }
+#endif
             if (s->port.idleCallback) {
                 s->port.idleCallback();
             }
 
             __HAL_UART_CLEAR_IDLEFLAG(huart);
         }    
+    CYCLE_ISR_END(UART);
 }
 
 static void handleUsartTxDma(uartPort_t *s) {
@@ -323,8 +337,36 @@ void dmaIRQHandler(dmaChannelDescriptor_t* descriptor) {
     HAL_DMA_IRQHandler(&s->txDMAHandle);
 }
 
+#ifdef USE_UART_RX_DMA_IDLE
+// Hand everything the circular RX DMA has written since the last call to the rx callback.
+// Called on idle line and on half/full buffer, so a frame is delivered in one go.
+static void uartRxDmaDrain(uartPort_t *s) {
+    const uint32_t rxDMAHead = __HAL_DMA_GET_COUNTER(&s->rxDMAHandle);
+    while (s->rxDMAPos != rxDMAHead) {
+        s->port.rxCallback(s->port.rxBuffer[s->port.rxBufferSize - s->rxDMAPos], s->port.rxCallbackData);
+        if (--s->rxDMAPos == 0) {
+            s->rxDMAPos = s->port.rxBufferSize;
+        }
+    }
+}
+
+static void rxDmaIRQHandler(dmaChannelDescriptor_t* descriptor) {
+    uartPort_t *s = &(((uartDevice_t*)(descriptor->userParam))->port);
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF | DMA_IT_TCIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+    if (s->port.rxCallback) {
+        uartRxDmaDrain(s);
+    }
+}
+#endif
+
 // XXX Should serialUART be consolidated?
 
+static bool uartTxDmaIsFree(dmaIdentifier_e identifier)
+{
+    const resourceOwner_e owner = dmaGetOwner(identifier);
+    return owner == OWNER_FREE || owner == OWNER_SERIAL_TX;
+}
+
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options) {
     uartDevice_t *uartdev = uartDevmap[device];
     if (!uartdev) {
@@ -342,8 +384,14 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
     if (hardware->rxDMAStream) {
         s->rxDMAChannel = hardware->DMAChannel;
         s->rxDMAStream = hardware->rxDMAStream;
+#ifdef USE_UART_RX_DMA_IDLE
+        const dmaIdentifier_e identifier = dmaGetIdentifier(hardware->rxDMAStream);
+        dmaInit(identifier, OWNER_SERIAL_RX, RESOURCE_INDEX(device));
+        dmaSetHandler(identifier, rxDmaIRQHandler, hardware->rxPriority, (uint32_t)uartdev);
+#endif
     }
-    if (hardware->txDMAStream) {
+    // a stream some other driver already claimed is left alone and the port falls back to the TXE interrupt
+    if (hardware->txDMAStream && uartTxDmaIsFree(hardware->txIrq)) {
         s->txDMAChannel = hardware->DMAChannel;
         s->txDMAStream = hardware->txDMAStream;
         // DMA TX Interrupt
@@ -373,7 +421,12 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
             IOConfigGPIOAF(rxIO, IOCFG_AF_PP, hardware->af);
         }
     }
-    if (!s->rxDMAChannel) {
+#ifdef USE_UART_RX_DMA_IDLE
+    // the USART interrupt is still needed with RX DMA for idle line detection
+    {
+#else
+    if (!s->rxDMAChannel || !s->txDMAStream) {
+#endif
         HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
         HAL_NVIC_EnableIRQ(hardware->rxIrq);
     }
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -108,13 +109,11 @@ static uint8_t usbVcpRead(serialPort_t *instance) {
     }
 }
 
-static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count) {
-    UNUSED(instance);
+static bool usbVcpTransmit(const uint8_t *p, uint32_t count) {
     if (!(usbIsConnected() && usbIsConfigured())) {
-        return;
+        return false;
     }
     uint32_t start = millis();
-    const uint8_t *p = data;
     while (count > 0) {
         uint32_t txed = CDC_Send_DATA(p, count);
         count -= txed;
@@ -123,6 +122,7 @@ static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
             break;
         }
     }
+    return count == 0;
 }
 
 static bool usbVcpFlush(vcpPort_t *port) {
@@ -131,20 +131,20 @@ static bool usbVcpFlush(vcpPort_t *port) {
     if (count == 0) {
         return true;
     }
-    if (!usbIsConnected() || !usbIsConfigured()) {
-        return false;
-    }
-    uint32_t start = millis();
-    uint8_t *p = port->txBuf;
-    while (count > 0) {
-        uint32_t txed = CDC_Send_DATA(p, count);
-        count -= txed;
-        p += txed;
-        if (millis() - start > USB_TIMEOUT) {
-            break;
-        }
+    return usbVcpTransmit(port->txBuf, count);
+}
+
+// Small writes inside beginWrite/endWrite join the buffered bytes, anything larger goes
+// straight from the caller's buffer into the CDC ring in one copy.
+static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count) {
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+    if (port->buffering && port->txAt + count <= (int)ARRAYLEN(port->txBuf)) {
+        memcpy(&port->txBuf[port->txAt], data, count);
+        port->txAt += count;
+        return;
     }
-    return count == 0;
+    usbVcpFlush(port);
+    usbVcpTransmit(data, count);
 }
 
 static void usbVcpWrite(serialPort_t *instance, uint8_t c) {
@@ -184,7 +184,9 @@ static const struct serialPortVTable usbVTable[] = {
         .setBaudRateCb = usbVcpSetBaudRateCb,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
-        .endWrite = usbVcpEndWrite
+        .endWrite = usbVcpEndWrite,
+        .getTxBuf = NULL,
+        .commitTxBuf = NULL
     }
 };
 
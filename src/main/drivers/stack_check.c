@@ -85,6 +85,14 @@ uint32_t stackUsedSize(void) {
 }
 #endif
 
+#ifdef USE_STACK_CHECK_IRQ
+uint32_t stackIrqEntryDepth[STACK_IRQ_LEVEL_COUNT];
+
+uint32_t stackIrqUsedSize(int level) {
+    return stackIrqEntryDepth[level];
+}
+#endif
+
 uint32_t stackTotalSize(void) {
     return (uint32_t)(intptr_t)&_Min_Stack_Size;
 }
@@ -26,3 +26,32 @@ void taskStackCheck(timeUs_t currentTimeUs);
 uint32_t stackUsedSize(void);
 uint32_t stackTotalSize(void);
 uint32_t stackHighMem(void);
+
+#ifdef USE_STACK_CHECK_IRQ
+#include "drivers/nvic.h"
+
+// one entry per NVIC preemption priority, interrupts of the same level never nest
+#define STACK_IRQ_LEVEL_COUNT (NVIC_PRIORITY_BASE(0xf0) + 1)
+
+extern uint32_t stackIrqEntryDepth[STACK_IRQ_LEVEL_COUNT];
+
+// Called first thing in an interrupt handler: the depth of the stack at that point is what the thread and the
+// lower priority interrupts it preempted had in use, plus the exception frame.
+static inline void stackCheckIrqEntry(void) {
+    const uint32_t exception = __get_IPSR();
+    if (exception < 16) {
+        return; // system exceptions have their priorities in the SCB
+    }
+    const uint32_t level = NVIC_PRIORITY_BASE(NVIC->IP[exception - 16]);
+    extern char _estack;
+    const uint32_t depth = (uint32_t)(intptr_t)&_estack - __get_MSP();
+    if (depth > stackIrqEntryDepth[level]) {
+        stackIrqEntryDepth[level] = depth;
+    }
+}
+
+uint32_t stackIrqUsedSize(int level);
+#define STACK_CHECK_IRQ_ENTRY() stackCheckIrqEntry()
+#else
+#define STACK_CHECK_IRQ_ENTRY() do {} while (0)
+#endif
@@ -76,6 +76,10 @@ __STATIC_INLINE void LL_EX_DMA_SetDataLength(DMA_Stream_TypeDef* DMAx_Streamy, u
     MODIFY_REG(DMAx_Streamy->NDTR, DMA_SxNDT, NbData);
 }
 
+__STATIC_INLINE uint32_t LL_EX_DMA_GetDataLength(DMA_Stream_TypeDef* DMAx_Streamy) {
+    return READ_BIT(DMAx_Streamy->NDTR, DMA_SxNDT);
+}
+
 __STATIC_INLINE void LL_EX_TIM_EnableIT(TIM_TypeDef *TIMx, uint32_t Sources) {
     SET_BIT(TIMx->DIER, Sources);
 }
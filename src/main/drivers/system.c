@@ -24,6 +24,7 @@
 #include "platform.h"
 
 #include "build/atomic.h"
+#include "build/cycle_profile.h"
 
 #include "drivers/light_led.h"
 #include "drivers/nvic.h"
@@ -54,6 +55,7 @@ void cycleCounterInit(void) {
 static volatile int sysTickPending = 0;
 
 void SysTick_Handler(void) {
+    CYCLE_ISR_BEGIN();
     ATOMIC_BLOCK(NVIC_PRIO_MAX) {
         sysTickUptime++;
         sysTickValStamp = SysTick->VAL;
@@ -64,8 +66,30 @@ void SysTick_Handler(void) {
     // used by the HAL for some timekeeping and timeouts, should always be 1ms
     HAL_IncTick();
 #endif
+    CYCLE_ISR_END(SYSTICK);
 }
 
+#ifdef USE_GYRO_PID_INTERRUPT
+static softwareInterruptHandlerFunc *softwareInterruptHandler;
+
+void softwareInterruptInit(softwareInterruptHandlerFunc *fn) {
+    softwareInterruptHandler = fn;
+    NVIC_SetPriority(PendSV_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), NVIC_PRIORITY_BASE(NVIC_PRIO_PID_SWI), NVIC_PRIORITY_SUB(NVIC_PRIO_PID_SWI)));
+}
+
+FAST_CODE void softwareInterruptTrigger(void) {
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+FAST_CODE void PendSV_Handler(void) {
+    CYCLE_ISR_BEGIN();
+    if (softwareInterruptHandler) {
+        softwareInterruptHandler();
+    }
+    CYCLE_ISR_END(PID);
+}
+#endif
+
 // Return system uptime in microseconds (rollover in 70minutes)
 
 uint32_t microsISR(void) {
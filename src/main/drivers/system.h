@@ -50,6 +50,7 @@ void systemReset(void);
 void systemResetToBootloader(void);
 void checkForBootLoaderRequest(void);
 bool isMPUSoftReset(void);
+bool isMPUBrownoutReset(void);
 void cycleCounterInit(void);
 
 void enableGPIOPowerUsageAndNoiseReductions(void);
@@ -63,3 +64,11 @@ typedef void extiCallbackHandlerFunc(void);
 void registerExtiCallbackHandler(IRQn_Type irqn, extiCallbackHandlerFunc *fn);
 void unregisterExtiCallbackHandler(IRQn_Type irqn, extiCallbackHandlerFunc *fn);
 
+#ifdef USE_GYRO_PID_INTERRUPT
+typedef void softwareInterruptHandlerFunc(void);
+
+// PendSV is otherwise unused, it runs at NVIC_PRIO_PID_SWI below all peripheral interrupts
+void softwareInterruptInit(softwareInterruptHandlerFunc *fn);
+void softwareInterruptTrigger(void);
+#endif
+
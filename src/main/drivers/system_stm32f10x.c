@@ -61,6 +61,11 @@ bool isMPUSoftReset(void) {
         return false;
 }
 
+bool isMPUBrownoutReset(void) {
+    // no brownout flag on this MCU, a supply dip shows up as a plain power-on reset
+    return false;
+}
+
 void systemInit(void) {
     checkForBootLoaderRequest();
     SetSysClock(false);
@@ -74,6 +74,11 @@ bool isMPUSoftReset(void) {
         return false;
 }
 
+bool isMPUBrownoutReset(void) {
+    // no brownout flag on this MCU, a supply dip shows up as a plain power-on reset
+    return false;
+}
+
 void systemInit(void) {
     checkForBootLoaderRequest();
     // Enable FPU
@@ -165,6 +165,11 @@ bool isMPUSoftReset(void) {
         return false;
 }
 
+bool isMPUBrownoutReset(void) {
+    // a power-on reset sets BORRSTF as well, only a dip that stayed above the POR threshold leaves PORRSTF clear
+    return (cachedRccCsrValue & RCC_CSR_BORRSTF) && !(cachedRccCsrValue & RCC_CSR_PORRSTF);
+}
+
 void systemInit(void) {
     SetSysClock();
     // Configure NVIC preempt/priority groups
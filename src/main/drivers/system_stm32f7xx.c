@@ -150,10 +150,37 @@ bool isMPUSoftReset(void) {
         return false;
 }
 
+bool isMPUBrownoutReset(void) {
+    // a power-on reset sets BORRSTF as well, only a dip that stayed above the POR threshold leaves PORRSTF clear
+    return (cachedRccCsrValue & RCC_CSR_BORRSTF) && !(cachedRccCsrValue & RCC_CSR_PORRSTF);
+}
+
+#ifdef USE_DMA_RAM
+// DMA_RAM as normal, shareable, non-cacheable memory (TEX 1, C 0, B 0), DMA buffers in it need no cache maintenance
+static void configureDmaRamRegion(void) {
+    extern uint8_t _sdmaram_bss;
+    extern uint8_t _edmaram_region;
+    const uint32_t base = (uint32_t)&_sdmaram_bss;
+    const uint32_t size = (uint32_t)(&_edmaram_region - &_sdmaram_bss);
+    if (size == 0) {
+        return;
+    }
+    // write the zeroed lines back before the attributes change, a later eviction would overwrite DMA data
+    SCB_CleanInvalidateDCache_by_Addr((uint32_t *)base, (int32_t)size);
+    // the linker script keeps the region a power of two of at least 32 bytes, RASR encodes log2(size) - 1
+    const uint32_t sizeField = (uint32_t)(31 - __builtin_clz(size) - 1) << MPU_RASR_SIZE_Pos;
+    LL_MPU_ConfigRegion(LL_MPU_REGION_NUMBER1, 0, base, sizeField | LL_MPU_REGION_FULL_ACCESS | LL_MPU_TEX_LEVEL1 |
+                        LL_MPU_INSTRUCTION_ACCESS_DISABLE | LL_MPU_ACCESS_SHAREABLE | LL_MPU_ACCESS_NOT_CACHEABLE | LL_MPU_ACCESS_NOT_BUFFERABLE);
+}
+#endif
+
 void systemInit(void) {
     checkForBootLoaderRequest();
     //  Mark ITCM-RAM as read-only
     LL_MPU_ConfigRegion(LL_MPU_REGION_NUMBER0, 0, RAMITCM_BASE, LL_MPU_REGION_SIZE_16KB | LL_MPU_REGION_PRIV_RO_URO);
+#ifdef USE_DMA_RAM
+    configureDmaRamRegion();
+#endif
     LL_MPU_Enable(LL_MPU_CTRL_PRIVILEGED_DEFAULT);
     //SystemClock_Config();
     // Configure NVIC preempt/priority groups
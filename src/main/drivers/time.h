@@ -31,5 +31,14 @@ timeUs_t micros(void);
 timeUs_t microsISR(void);
 timeMs_t millis(void);
 
+// Sensors power up together with the MCU, so their start-up times run in parallel
+// and only need waiting for when boot has not already taken that long.
+static inline void delaySincePowerOn(timeMs_t ms) {
+    const timeMs_t now = millis();
+    if (now < ms) {
+        delay(ms - now);
+    }
+}
+
 uint32_t ticks(void);
 timeDelta_t ticks_diff_us(uint32_t begin, uint32_t end);
@@ -26,10 +26,12 @@
 #include "platform.h"
 
 #include "build/atomic.h"
+#include "build/cycle_profile.h"
 
 #include "common/utils.h"
 
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 
 #include "drivers/io.h"
 #include "rcc.h"
@@ -568,6 +570,8 @@ void timerChConfigOC(const timerHardware_t* timHw, bool outEnable, bool stateHig
 }
 
 static void timCCxHandler(TIM_TypeDef *tim, timerConfig_t *timerConfig) {
+    STACK_CHECK_IRQ_ENTRY();
+    CYCLE_ISR_BEGIN();
     uint16_t capture;
     unsigned tim_status;
     tim_status = tim->SR & tim->DIER;
@@ -635,6 +639,7 @@ static void timCCxHandler(TIM_TypeDef *tim, timerConfig_t *timerConfig) {
         timerConfig->edgeCallback[3]->fn(timerConfig->edgeCallback[3], tim->CCR4);
     }
 #endif
+    CYCLE_ISR_END(TIMER);
 }
 
 // handler for shared interrupts when both timers need to check status bits
@@ -0,0 +1,57 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "platform.h"
+
+#ifdef USE_TRANSPONDER
+
+#include "drivers/transponder_ir.h"
+
+#if defined(STM32F3) || defined(STM32F4) || defined(STM32F7) || defined(UNIT_TEST)
+
+static void expandToggles(transponder_t *transponder, transponderIrDMAValue_t *dst, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        const unsigned toggle = transponder->dmaToggleIndex++;
+        const bool carrier = toggle < transponder->toggle_count && transponderIrToggleHasCarrier(transponder, toggle);
+        dst[i] = carrier ? transponder->bitToggleOne : 0;
+    }
+}
+
+void transponderIrStartDMARing(transponder_t *transponder) {
+    transponder->dmaToggleIndex = 0;
+    expandToggles(transponder, transponder->dmaRing, TRANSPONDER_DMA_RING_SIZE);
+}
+
+// Called when the DMA has sent a half of the ring, refills it with the next slice of the pulse train.
+// Returns true once the train and a quiet period after it have been sent, the DMA can be stopped then.
+bool transponderIrRefillDMARing(transponder_t *transponder, bool secondHalf) {
+    const unsigned sent = transponder->dmaToggleIndex - TRANSPONDER_DMA_RING_SIZE / 2;
+    if (sent > transponder->toggle_count) {
+        return true;
+    }
+    transponderIrDMAValue_t *half = transponder->dmaRing + (secondHalf ? TRANSPONDER_DMA_RING_SIZE / 2 : 0);
+    expandToggles(transponder, half, TRANSPONDER_DMA_RING_SIZE / 2);
+    return false;
+}
+
+#endif
+#endif
@@ -20,6 +20,9 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "drivers/io_types.h"
 
 /*** ARCITIMER ***/
@@ -53,7 +56,6 @@
 /*** ERLT ***/
 #define TRANSPONDER_DATA_LENGTH_ERLT        1
 
-#define ERLTBitQuiet                        0
 #define ERLTCyclesForOneBit                 25
 #define ERLTCyclesForZeroBit                10
 #define TRANSPONDER_DMA_BUFFER_SIZE_ERLT    200 // actually ERLT is variable length 91-196 depending on the ERLT id
@@ -64,29 +66,22 @@
 /*** ******** ***/
 
 
+// the longest pulse train, in carrier periods
+#define TRANSPONDER_TOGGLES_MAX TRANSPONDER_DMA_BUFFER_SIZE_ILAP
+
 /*
  * Implementation note:
- * Using around over 700 bytes for a transponder DMA buffer is a little excessive, likely an alternative implementation that uses a fast
- * ISR to generate the output signal dynamically based on state would be more memory efficient and would likely be more appropriate for
- * other targets.  However this approach requires very little CPU time and is just fire-and-forget.
- *
- * On an STM32F303CC 720 bytes is currently fine and that is the target for which this code was designed for.
+ * The providers encode the pulse train as one bit per carrier period, set where the carrier is on. The timer DMA runs circular
+ * over a short ring of compare values and the half and full transfer interrupts expand the next slice of the train into the
+ * half that was just sent, so the ring is all the memory the DMA needs while each period still comes straight from the DMA.
+ * A slice lasts 32 carrier periods, around 70us with the ILAP carrier.
  */
-#if defined(STM32F3) || defined(UNIT_TEST)
-
-typedef union transponderIrDMABuffer_s {
-    uint8_t arcitimer[TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER]; // 620
-    uint8_t ilap[TRANSPONDER_DMA_BUFFER_SIZE_ILAP]; // 720
-    uint8_t erlt[TRANSPONDER_DMA_BUFFER_SIZE_ERLT]; // 91-200
-} transponderIrDMABuffer_t;
+#define TRANSPONDER_DMA_RING_SIZE 64
 
+#if defined(STM32F3) || defined(UNIT_TEST)
+typedef uint8_t transponderIrDMAValue_t;
 #elif defined(STM32F4) || defined(STM32F7)
-
-typedef union transponderIrDMABuffer_s {
-    uint32_t arcitimer[TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER]; // 620
-    uint32_t ilap[TRANSPONDER_DMA_BUFFER_SIZE_ILAP]; // 720
-    uint32_t erlt[TRANSPONDER_DMA_BUFFER_SIZE_ERLT]; // 91-200
-} transponderIrDMABuffer_t;
+typedef uint32_t transponderIrDMAValue_t;
 #endif
 
 typedef struct transponder_s {
@@ -94,10 +89,12 @@ typedef struct transponder_s {
     uint32_t timer_hz;
     uint32_t timer_carrier_hz;
     uint16_t bitToggleOne;
-    uint32_t dma_buffer_size;
+    uint32_t toggle_count;
 
 #if defined(STM32F3) || defined(STM32F4)|| defined(STM32F7) || defined(UNIT_TEST)
-    transponderIrDMABuffer_t transponderIrDMABuffer;
+    uint8_t toggles[(TRANSPONDER_TOGGLES_MAX + 7) / 8];
+    uint16_t dmaToggleIndex; // next toggle to expand into the ring
+    transponderIrDMAValue_t dmaRing[TRANSPONDER_DMA_RING_SIZE];
 #endif
 
     const struct transponderVTable *vTable;
@@ -119,6 +116,23 @@ struct transponderVTable {
 bool transponderIrInit(const ioTag_t ioTag, const transponderProvider_e provider);
 void transponderIrDisable(void);
 
+#if defined(STM32F3) || defined(STM32F4)|| defined(STM32F7) || defined(UNIT_TEST)
+static inline void transponderIrSetToggle(transponder_t *transponder, unsigned index, bool carrier) {
+    if (carrier) {
+        transponder->toggles[index / 8] |= 1 << (index % 8);
+    } else {
+        transponder->toggles[index / 8] &= ~(1 << (index % 8));
+    }
+}
+
+static inline bool transponderIrToggleHasCarrier(const transponder_t *transponder, unsigned index) {
+    return transponder->toggles[index / 8] & (1 << (index % 8));
+}
+
+void transponderIrStartDMARing(transponder_t *transponder);
+bool transponderIrRefillDMARing(transponder_t *transponder, bool secondHalf);
+#endif
+
 void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder);
 void transponderIrDMAEnable(transponder_t *transponder);
 
@@ -36,11 +36,11 @@ static uint16_t dmaBufferOffset;
 void transponderIrInitArcitimer(transponder_t *transponder) {
     // from drivers/transponder_ir.h
     transponder->gap_toggles        = TRANSPONDER_GAP_TOGGLES_ARCITIMER;
-    transponder->dma_buffer_size    = TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER;
+    transponder->toggle_count       = TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER;
     transponder->vTable             = &arcitimerTansponderVTable;
     transponder->timer_hz           = TRANSPONDER_TIMER_MHZ_ARCITIMER;
     transponder->timer_carrier_hz   = TRANSPONDER_CARRIER_HZ_ARCITIMER;
-    memset(&(transponder->transponderIrDMABuffer.arcitimer), 0, sizeof(transponder->transponderIrDMABuffer.arcitimer));
+    memset(transponder->toggles, 0, sizeof(transponder->toggles));
 }
 
 void updateTransponderDMABufferArcitimer(transponder_t *transponder, const uint8_t* transponderData) {
@@ -53,7 +53,7 @@ void updateTransponderDMABufferArcitimer(transponder_t *transponder, const uint8
         for (bitIndex = 0; bitIndex < TRANSPONDER_BITS_PER_BYTE_ARCITIMER; bitIndex++) {
             bool isHightState = byteToSend & (1 << (bitIndex));
             for (hightStateIndex = 0; hightStateIndex < TRANSPONDER_TOGGLES_PER_BIT_ARCITIMER; hightStateIndex++) {
-                transponder->transponderIrDMABuffer.arcitimer[dmaBufferOffset] = isHightState ? transponder->bitToggleOne : 0;
+                transponderIrSetToggle(transponder, dmaBufferOffset, isHightState);
                 dmaBufferOffset++;
             }
         }
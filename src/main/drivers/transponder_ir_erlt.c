@@ -34,16 +34,16 @@ static uint16_t dmaBufferOffset;
 extern const struct transponderVTable erltTansponderVTable;
 
 void transponderIrInitERLT(transponder_t *transponder) {
-    transponder->dma_buffer_size    = TRANSPONDER_DMA_BUFFER_SIZE_ERLT;
+    transponder->toggle_count       = TRANSPONDER_DMA_BUFFER_SIZE_ERLT;
     transponder->vTable             = &erltTansponderVTable;
     transponder->timer_hz           = TRANSPONDER_TIMER_MHZ_ERLT;
     transponder->timer_carrier_hz   = TRANSPONDER_CARRIER_HZ_ERLT;
-    memset(&(transponder->transponderIrDMABuffer.erlt), 0, sizeof(transponder->transponderIrDMABuffer.erlt));
+    memset(transponder->toggles, 0, sizeof(transponder->toggles));
 }
 
-void addBitToBuffer(transponder_t *transponder, uint8_t cycles, uint8_t pulsewidth) {
+void addBitToBuffer(transponder_t *transponder, uint8_t cycles, bool pulsed) {
     for (int i = 0; i < cycles; i++) {
-        transponder->transponderIrDMABuffer.erlt[dmaBufferOffset++] = pulsewidth;
+        transponderIrSetToggle(transponder, dmaBufferOffset++, pulsed);
     }
 }
 
@@ -52,21 +52,21 @@ void updateTransponderDMABufferERLT(transponder_t *transponder, const uint8_t* t
     uint8_t paritysum = 0; //sum of one bits
     dmaBufferOffset = 0; //reset buffer count
     //start bit 1, always pulsed, bit value = 0
-    addBitToBuffer(transponder, ERLTCyclesForZeroBit, transponder->bitToggleOne);
+    addBitToBuffer(transponder, ERLTCyclesForZeroBit, true);
     //start bit 2, always not pulsed, bit value = 0
-    addBitToBuffer(transponder, ERLTCyclesForZeroBit, ERLTBitQuiet);
+    addBitToBuffer(transponder, ERLTCyclesForZeroBit, false);
     //add data bits, only the 6 LSB
     for (int i = 5; i >= 0; i--) {
         uint8_t bv = (byteToSend >> i) & 0x01;
         paritysum += bv;
-        addBitToBuffer(transponder, (bv ? ERLTCyclesForOneBit : ERLTCyclesForZeroBit), ((i % 2) ? transponder->bitToggleOne : ERLTBitQuiet));
+        addBitToBuffer(transponder, (bv ? ERLTCyclesForOneBit : ERLTCyclesForZeroBit), (i % 2));
     }
     //parity bit, always pulsed, bit value is zero if sum is even, one if odd
-    addBitToBuffer(transponder, ((paritysum % 2) ?  ERLTCyclesForOneBit : ERLTCyclesForZeroBit), transponder->bitToggleOne);
+    addBitToBuffer(transponder, ((paritysum % 2) ?  ERLTCyclesForOneBit : ERLTCyclesForZeroBit), true);
     //add final zero after the pulsed parity bit to stop pulses until the next update
-    transponder->transponderIrDMABuffer.erlt[dmaBufferOffset++] = ERLTBitQuiet;
+    transponderIrSetToggle(transponder, dmaBufferOffset++, false);
     //reset buffer size to that required by this ERLT id
-    transponder->dma_buffer_size = dmaBufferOffset;
+    transponder->toggle_count = dmaBufferOffset;
 }
 
 const struct transponderVTable erltTansponderVTable = {
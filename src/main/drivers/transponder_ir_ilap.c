@@ -36,11 +36,11 @@ extern const struct transponderVTable ilapTansponderVTable;
 void transponderIrInitIlap(transponder_t *transponder) {
     // from drivers/transponder_ir.h
     transponder->gap_toggles        = TRANSPONDER_GAP_TOGGLES_ILAP;
-    transponder->dma_buffer_size    = TRANSPONDER_DMA_BUFFER_SIZE_ILAP;
+    transponder->toggle_count       = TRANSPONDER_DMA_BUFFER_SIZE_ILAP;
     transponder->vTable             = &ilapTansponderVTable;
     transponder->timer_hz           = TRANSPONDER_TIMER_MHZ_ILAP;
     transponder->timer_carrier_hz   = TRANSPONDER_CARRIER_HZ_ILAP;
-    memset(&(transponder->transponderIrDMABuffer.ilap), 0, sizeof(transponder->transponderIrDMABuffer.ilap));
+    memset(transponder->toggles, 0, sizeof(transponder->toggles));
 }
 
 void updateTransponderDMABufferIlap(transponder_t *transponder, const uint8_t* transponderData) {
@@ -60,14 +60,10 @@ void updateTransponderDMABufferIlap(transponder_t *transponder, const uint8_t* t
                 doToggles = byteToSend & (1 << (bitIndex - 1));
             }
             for (toggleIndex = 0; toggleIndex < TRANSPONDER_TOGGLES_PER_BIT_ILAP; toggleIndex++) {
-                if (doToggles) {
-                    transponder->transponderIrDMABuffer.ilap[dmaBufferOffset] = transponder->bitToggleOne;
-                } else {
-                    transponder->transponderIrDMABuffer.ilap[dmaBufferOffset] = 0;
-                }
+                transponderIrSetToggle(transponder, dmaBufferOffset, doToggles);
                 dmaBufferOffset++;
             }
-            transponder->transponderIrDMABuffer.ilap[dmaBufferOffset] = 0;
+            transponderIrSetToggle(transponder, dmaBufferOffset, false);
             dmaBufferOffset++;
         }
     }
@@ -48,13 +48,32 @@ static uint16_t timerChannel = 0;
 #error "Transponder (via HAL) not supported on this MCU."
 #endif
 
-transponder_t transponder;
+DMA_RAM transponder_t transponder;
 bool transponderInitialised = false;
 
+// HAL_DMA_Start_IT() only enables the half transfer interrupt with a callback set, the ring is refilled below
+static void transponderIrHalfTransferCallback(DMA_HandleTypeDef *hdma) {
+    UNUSED(hdma);
+}
+
 static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor) {
-    HAL_DMA_IRQHandler(TimHandle.hdma[descriptor->userParam]);
-    TIM_DMACmd(&TimHandle, timerChannel, DISABLE);
-    transponderIrDataTransferInProgress = 0;
+    DMA_HandleTypeDef *hdma = TimHandle.hdma[descriptor->userParam];
+    const bool halfTransfer = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF);
+    const bool transferComplete = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF);
+    HAL_DMA_IRQHandler(hdma);
+    bool complete = false;
+    if (halfTransfer) {
+        complete = transponderIrRefillDMARing(&transponder, false);
+    }
+    if (transferComplete) {
+        complete = transponderIrRefillDMARing(&transponder, true);
+    }
+    if (complete) {
+        HAL_DMA_Abort(hdma);
+        TIM_DMACmd(&TimHandle, timerChannel, DISABLE);
+        TimHandle.State = HAL_TIM_STATE_READY;
+        transponderIrDataTransferInProgress = 0;
+    }
 }
 
 void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder) {
@@ -93,7 +112,7 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder) {
     hdma_tim.Init.MemInc = DMA_MINC_ENABLE;
     hdma_tim.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
     hdma_tim.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
-    hdma_tim.Init.Mode = DMA_NORMAL;
+    hdma_tim.Init.Mode = DMA_CIRCULAR;
     hdma_tim.Init.Priority = DMA_PRIORITY_HIGH;
     hdma_tim.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
     hdma_tim.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
@@ -111,6 +130,7 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder) {
         /* Initialization Error */
         return;
     }
+    hdma_tim.XferHalfCpltCallback = transponderIrHalfTransferCallback;
     RCC_ClockCmd(timerRCC(timer), ENABLE);
     /* PWM1 Mode configuration: Channel1 */
     TIM_OC_InitTypeDef  TIM_OCInitStructure;
@@ -182,7 +202,8 @@ void transponderIrDMAEnable(transponder_t *transponder) {
     if (!transponderInitialised) {
         return;
     }
-    if (DMA_SetCurrDataCounter(&TimHandle, timerChannel, transponder->transponderIrDMABuffer.ilap, transponder->dma_buffer_size) != HAL_OK) {
+    transponderIrStartDMARing(transponder);
+    if (DMA_SetCurrDataCounter(&TimHandle, timerChannel, transponder->dmaRing, TRANSPONDER_DMA_RING_SIZE) != HAL_OK) {
         /* DMA set error */
         transponderIrDataTransferInProgress = 0;
         return;
@@ -53,10 +53,18 @@ static DMA_Stream_TypeDef *dmaRef = NULL;
 transponder_t transponder;
 
 static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor) {
+    bool complete = false;
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        complete = transponderIrRefillDMARing(&transponder, false);
+    }
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        complete = transponderIrRefillDMARing(&transponder, true);
+    }
+    if (complete) {
         transponderIrDataTransferInProgress = 0;
         DMA_Cmd(descriptor->ref, DISABLE);
-        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
 }
 
@@ -110,15 +118,15 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder) {
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)timerCCR(timer, timerHardware->channel);
 #if defined(STM32F3)
-    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t) & (transponder->transponderIrDMABuffer);
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)transponder->dmaRing;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
     DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
 #elif defined(STM32F4)
     DMA_InitStructure.DMA_Channel = timerHardware->dmaChannel;
-    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) & (transponder->transponderIrDMABuffer);
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)transponder->dmaRing;
     DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
 #endif
-    DMA_InitStructure.DMA_BufferSize = transponder->dma_buffer_size;
+    DMA_InitStructure.DMA_BufferSize = TRANSPONDER_DMA_RING_SIZE;
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
     DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
 #if defined(STM32F3)
@@ -128,11 +136,11 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder) {
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
 #endif
-    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
     DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     DMA_Init(dmaRef, &DMA_InitStructure);
     TIM_DMACmd(timer, timerDmaSource(timerHardware->channel), ENABLE);
-    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    DMA_ITConfig(dmaRef, DMA_IT_HT | DMA_IT_TC, ENABLE);
 }
 
 bool transponderIrInit(const ioTag_t ioTag, const transponderProvider_e provider) {
@@ -175,7 +183,8 @@ void transponderIrUpdateData(const uint8_t* transponderData) {
 }
 
 void transponderIrDMAEnable(transponder_t *transponder) {
-    DMA_SetCurrDataCounter(dmaRef, transponder->dma_buffer_size);  // load number of bytes to be transferred
+    transponderIrStartDMARing(transponder);
+    DMA_SetCurrDataCounter(dmaRef, TRANSPONDER_DMA_RING_SIZE);
     TIM_SetCounter(timer, 0);
     TIM_Cmd(timer, ENABLE);
     DMA_Cmd(dmaRef, ENABLE);
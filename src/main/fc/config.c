@@ -61,6 +61,7 @@
 
 #include "sensors/acceleration.h"
 #include "sensors/battery.h"
+#include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
 
 #ifdef USE_GYRO_IMUF9001
@@ -83,14 +84,17 @@ PG_RESET_TEMPLATE(pilotConfig_t, pilotConfig,
                   .name = { 0 }
                  );
 
-PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 5);
 
 PG_RESET_TEMPLATE(systemConfig_t, systemConfig,
                   .pidProfileIndex = 0,
                   .activeRateProfile = 0,
                   .debug_mode = DEBUG_MODE,
+                  .debug_mode_2 = DEBUG_NONE,
                   .task_statistics = true,
+                  .cycle_profile = false,
                   .cpu_overclock = 0,
+                  .cpu_idle_sleep = false,
                   .powerOnArmingGraceTime = 5,
                   .boardIdentifier = TARGET_BOARD_IDENTIFIER
                  );
@@ -263,7 +267,7 @@ static void validateAndFixConfig(void) {
     }
 #endif // USE_OSD_SLAVE
 #if defined(USE_ESC_SENSOR)
-    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)) {
+    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR) && !escSensorUseDshotEdt()) {
         featureClear(FEATURE_ESC_SENSOR);
     }
 #endif
@@ -37,9 +37,12 @@ typedef struct systemConfig_s {
     uint8_t pidProfileIndex;
     uint8_t activeRateProfile;
     uint8_t debug_mode;
+    uint8_t debug_mode_2;                   // mode of debug[4..7]
     uint8_t task_statistics;
+    uint8_t cycle_profile;                  // record DWT cycle counts per task and hot section
     uint8_t rateProfile6PosSwitch;
     uint8_t cpu_overclock;
+    uint8_t cpu_idle_sleep;                 // WFI between the gyro interrupts while nothing is due
     uint8_t powerOnArmingGraceTime; // in seconds
     char boardIdentifier[sizeof(TARGET_BOARD_IDENTIFIER) + 1];
 } systemConfig_t;
@@ -25,7 +25,10 @@
 
 #include "platform.h"
 
+#include "build/cycle_profile.h"
 #include "build/debug.h"
+#include "build/loop_jitter.h"
+#include "build/loop_rate.h"
 
 #include "blackbox/blackbox.h"
 
@@ -42,6 +45,7 @@
 #include "pg/pg_ids.h"
 #include "pg/rx.h"
 
+#include "drivers/accgyro/accgyro.h"
 #include "drivers/dma_spi.h"
 #include "drivers/light_led.h"
 #include "drivers/sound_beeper.h"
@@ -63,6 +67,7 @@
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
+#include "fc/warm_boot.h"
 
 #include "msp/msp_serial.h"
 
@@ -86,10 +91,12 @@
 #include "telemetry/telemetry.h"
 
 #include "flight/position.h"
+#include "flight/dyn_lpf.h"
 #include "flight/failsafe.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/rpm_filter.h"
 #include "flight/servos.h"
 #include "flight/gps_rescue.h"
 
@@ -177,6 +184,32 @@ void resetArmingDisabled(void) {
     lastArmingDisabledReason = 0;
 }
 
+#ifdef USE_CYCLE_BENCH
+void getConfiguredLoopRate(loopRate_t *rate, uint8_t *maxGyroSyncDenom) {
+    // gyro_sync_denom only divides the sensor rate with the 256Hz or no hardware lpf, see gyroSetSampleRate()
+    const bool gyroSyncDenomUsed = gyroConfig()->gyro_hardware_lpf == GYRO_LPF_256HZ || gyroConfig()->gyro_hardware_lpf == GYRO_LPF_NONE;
+    rate->gyroSyncDenom = gyroSyncDenomUsed ? gyroConfig()->gyro_sync_denom : 1;
+    rate->pidProcessDenom = pidConfig()->pid_process_denom;
+    rate->samplePeriodUs = gyro.targetLooptime / rate->gyroSyncDenom;
+    *maxGyroSyncDenom = gyroSyncDenomUsed ? LOOP_RATE_MAX_GYRO_SYNC_DENOM : 1;
+}
+
+// True when the configured loop rate doesn't leave the margin with the times the looprate command measured
+bool isLoopRateOverBudget(void) {
+    const loopWcet_t wcet = {
+        .gyro = pidConfig()->loop_wcet_gyro,
+        .pid = pidConfig()->loop_wcet_pid,
+    };
+    if (!wcet.gyro && !wcet.pid) {
+        return false;
+    }
+    loopRate_t rate;
+    uint8_t maxGyroSyncDenom;
+    getConfiguredLoopRate(&rate, &maxGyroSyncDenom);
+    return !loopRateFits(&rate, &wcet);
+}
+#endif
+
 void updateArmingStatus(void) {
     if (ARMING_FLAG(ARMED)) {
         LED0_ON;
@@ -246,6 +279,12 @@ void updateArmingStatus(void) {
         if (IS_RC_MODE_ACTIVE(BOXPARALYZE)) {
             setArmingDisabled(ARMING_DISABLED_PARALYZE);
         }
+#ifdef USE_WARM_BOOT
+        if (warmBootRearmPending()) {
+            // armed when the board reset, the switch and sticks are still where the flight left them
+            unsetArmingDisabled(WARM_BOOT_REARM_FLAGS);
+        }
+#endif
         if (!isUsingSticksForArming()) {
             /* Ignore ARMING_DISABLED_CALIBRATING if we are going to calibrate gyro on first arm */
             bool ignoreGyro = armingConfig()->gyro_cal_on_first_arm
@@ -270,7 +309,12 @@ void updateArmingStatus(void) {
                 unsetArmingDisabled(ARMING_DISABLED_ARM_SWITCH);
             }
         }
-        if (isArmingDisabled()) {
+        bool warning = isArmingDisabled();
+#ifdef USE_CYCLE_BENCH
+        // only a warning, the loop runs late but it runs
+        warning = warning || isLoopRateOverBudget();
+#endif
+        if (warning) {
             warningLedFlash();
         } else {
             warningLedDisable();
@@ -339,6 +383,9 @@ void tryArm(void) {
                 }
             }
         }
+#endif
+#ifdef USE_LOOP_JITTER
+        loopJitterReset(gyro.targetLooptime);
 #endif
         ENABLE_ARMING_FLAG(ARMED);
         ENABLE_ARMING_FLAG(WAS_EVER_ARMED);
@@ -773,11 +820,13 @@ bool processRx(timeUs_t currentTimeUs) {
 
 static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs) {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {
+    if (debugModeIsActive(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
     // PID - note this is function pointer set by setPIDController()
+    CYCLE_SECTION_BEGIN(PID);
     pidController(currentPidProfile, &accelerometerConfig()->accelerometerTrims, currentTimeUs);
+    CYCLE_SECTION_END(PID);
     DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
 #ifdef USE_RUNAWAY_TAKEOFF
     // Check to see if runaway takeoff detection is active (anti-taz), the pidSum is over the threshold,
@@ -822,7 +871,7 @@ static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs) {
 
 static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs) {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {
+    if (debugModeIsActive(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 #ifdef USE_MAG
@@ -851,24 +900,29 @@ void subTaskTelemetryPollSensors(timeUs_t currentTimeUs) {
 
 static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs) {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_CYCLETIME) {
+    if (debugModeIsActive(DEBUG_CYCLETIME)) {
         startTime = micros();
         static uint32_t previousMotorUpdateTime;
         const uint32_t currentDeltaTime = startTime - previousMotorUpdateTime;
-        debug[2] = currentDeltaTime;
-        debug[3] = currentDeltaTime - targetPidLooptime;
+        DEBUG_SET(DEBUG_CYCLETIME, 2, currentDeltaTime);
+        DEBUG_SET(DEBUG_CYCLETIME, 3, currentDeltaTime - targetPidLooptime);
         previousMotorUpdateTime = startTime;
-    } else if (debugMode == DEBUG_PIDLOOP) {
+    } else if (debugModeIsActive(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
+    CYCLE_SECTION_BEGIN(MIXER);
     mixTable(currentTimeUs);
+    CYCLE_SECTION_END(MIXER);
 #ifdef USE_SERVOS
     // motor outputs are used as sources for servo mixing, so motors must be calculated using mixTable() before servos.
     if (isMixerUsingServos()) {
         writeServos();
     }
 #endif
+    CYCLE_SECTION_BEGIN(MOTOR_WRITE);
     writeMotors();
+    CYCLE_SECTION_END(MOTOR_WRITE);
+    rcLatencyMotorsWritten();
     DEBUG_SET(DEBUG_PIDLOOP, 2, micros() - startTime);
 }
 
@@ -892,15 +946,131 @@ static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs) {
     processRcCommand();
 }
 
+static FAST_RAM_ZERO_INIT uint32_t pidUpdateCountdown;
+
+// The loop rates taskMainPidLoop() works with, worked out of the gyro and pid config by pidLoopInit() so the
+// loop doesn't read them on every sample. Zeroed it runs the pid and rc updates on every sample
+typedef struct pidLoopRuntime_s {
+    uint8_t pidUpdateSkip;      // gyro samples without a pid update after each one with
+    uint8_t rcUpdateSkip;       // pid updates without an rc command update after each one with, at 32kHz sampling
+} pidLoopRuntime_t;
+
+static FAST_RAM_ZERO_INIT pidLoopRuntime_t pidLoopRuntime;
+
+void pidLoopInit(void) {
+    pidLoopRuntime.pidUpdateSkip = pidConfig()->pid_process_denom - 1;
+    pidLoopRuntime.rcUpdateSkip = 0;
+    if (gyroConfig()->gyro_use_32khz && gyroConfig()->gyro_sync_denom == 1) {
+        if (pidConfig()->pid_process_denom == 1) {
+            pidLoopRuntime.rcUpdateSkip = 3;
+        } else if (pidConfig()->pid_process_denom == 2) {
+            pidLoopRuntime.rcUpdateSkip = 1;
+        }
+    }
+    pidUpdateCountdown = 0;
+}
+
+static FAST_CODE void subTaskPidUpdate(timeUs_t currentTimeUs) {
+    static uint32_t rcupdateCountdown = 0;
+    if (rcupdateCountdown) {
+        rcupdateCountdown--;
+    } else {
+        rcupdateCountdown = pidLoopRuntime.rcUpdateSkip;
+        subTaskRcCommand(currentTimeUs);
+    }
+    subTaskPidController(currentTimeUs);
+    subTaskMotorUpdate(currentTimeUs);
+#ifdef USE_RPM_FILTER
+    rpmFilterUpdate();
+#endif
+#ifdef USE_DYN_LPF
+    dynLpfUpdate();
+#endif
+}
+
+#ifdef USE_GYRO_PID_INTERRUPT
+typedef enum {
+    PID_INTERRUPT_IDLE = 0,
+    PID_INTERRUPT_RUN_IN_TASK,      // disarmed, the task runs the pid update itself
+    PID_INTERRUPT_DONE              // the software interrupt ran the pid update
+} pidInterruptState_e;
+
+static FAST_RAM_ZERO_INIT bool pidInterruptEnabled;
+static FAST_RAM_ZERO_INIT volatile uint8_t pidInterruptState;
+static FAST_RAM_ZERO_INIT volatile bool pidUpdateInTask;
+static FAST_RAM_ZERO_INIT volatile timeUs_t pidInterruptGyroTimeUs;
+
+// Gyro stage, runs in the gyro SPI DMA completion interrupt at the full gyro rate
+static FAST_CODE void pidInterruptGyroSample(void) {
+    const timeUs_t currentTimeUs = micros();
+#ifdef USE_LOOP_JITTER
+    static timeUs_t previousTimeUs;
+    if (ARMING_FLAG(ARMED)) {
+        loopJitterRecord(cmpTimeUs(currentTimeUs, previousTimeUs));
+    }
+    previousTimeUs = currentTimeUs;
+#endif
+    gyroUpdate(currentTimeUs);
+    DEBUG_SET(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
+    if (pidUpdateCountdown) {
+        pidUpdateCountdown--;
+        return;
+    }
+    pidUpdateCountdown = pidLoopRuntime.pidUpdateSkip;
+    pidInterruptGyroTimeUs = currentTimeUs;
+    // Motor commands and beeper dshot commands are sent from the main loop while disarmed,
+    // and a pid update already running in the task must not be entered a second time
+    if (ARMING_FLAG(ARMED) && !pidUpdateInTask) {
+        softwareInterruptTrigger();
+    } else {
+        pidInterruptState = PID_INTERRUPT_RUN_IN_TASK;
+    }
+}
+
+// PID stage, runs in the software interrupt below the gyro interrupt
+static FAST_CODE void pidInterruptPidUpdate(void) {
+    subTaskPidUpdate(pidInterruptGyroTimeUs);
+    pidInterruptState = PID_INTERRUPT_DONE;
+}
+
+bool pidInterruptInit(void) {
+    if (!pidConfig()->pid_in_interrupt) {
+        return false;
+    }
+    softwareInterruptInit(pidInterruptPidUpdate);
+    pidInterruptEnabled = gyroSetSpiDmaSampleHandler(pidInterruptGyroSample);
+    return pidInterruptEnabled;
+}
+
+// checkFunc of the pid task once the gyro and pid stages run in interrupts
+FAST_CODE bool pidInterruptTaskReady(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs) {
+    UNUSED(currentTimeUs);
+    UNUSED(currentDeltaTimeUs);
+    return pidInterruptState != PID_INTERRUPT_IDLE;
+}
+#endif
+
 // Function for loop trigger
 FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs) {
-    static uint32_t pidUpdateCountdown = 0;
-    static uint32_t rcupdateCountdown = 0;
 #ifdef USE_DMA_SPI_DEVICE
     dmaSpiDeviceDataReady = false;
 #endif
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_GYROPID_SYNC)
     if (lockMainPID() != 0) return;
+#endif
+#ifdef USE_GYRO_PID_INTERRUPT
+    if (pidInterruptEnabled) {
+        // the interrupts already sampled the gyro, only the pid update while disarmed and the subprocesses are left
+        const uint8_t state = pidInterruptState;
+        pidInterruptState = PID_INTERRUPT_IDLE;
+        if (state == PID_INTERRUPT_RUN_IN_TASK) {
+            pidUpdateInTask = true;
+            subTaskPidUpdate(pidInterruptGyroTimeUs);
+            pidUpdateInTask = false;
+        }
+        subTaskPidSubprocesses(currentTimeUs);
+        return;
+    }
 #endif
     // DEBUG_PIDLOOP, timings for:
     // 0 - gyroUpdate()
@@ -914,30 +1084,21 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs) {
     if (pidUpdateCountdown) {
         pidUpdateCountdown--;
     } else {
-        pidUpdateCountdown = pidConfig()->pid_process_denom - 1;
-        if (rcupdateCountdown) {
-            rcupdateCountdown--;
-        } else {
-            if (gyroConfig()->gyro_use_32khz && gyroConfig()->gyro_sync_denom == 1) {
-                if (pidConfig()->pid_process_denom == 1) {
-                    rcupdateCountdown = 3;
-                } else if (pidConfig()->pid_process_denom == 2) {
-                    rcupdateCountdown = 1;
-                }
-            }
-            subTaskRcCommand(currentTimeUs);
-        }
-        subTaskPidController(currentTimeUs);
-        subTaskMotorUpdate(currentTimeUs);
+        pidUpdateCountdown = pidLoopRuntime.pidUpdateSkip;
+        subTaskPidUpdate(currentTimeUs);
         subTaskPidSubprocesses(currentTimeUs);
     }
-    if (debugMode == DEBUG_CYCLETIME) {
-        debug[0] = getTaskDeltaTime(TASK_SELF);
-        debug[1] = averageSystemLoadPercent;
+#ifdef USE_LOOP_JITTER
+    if (ARMING_FLAG(ARMED)) {
+        loopJitterRecord(getTaskDeltaTime(TASK_SELF));
+    }
+#endif
+    if (debugModeIsActive(DEBUG_CYCLETIME)) {
+        DEBUG_SET(DEBUG_CYCLETIME, 0, getTaskDeltaTime(TASK_SELF));
+        DEBUG_SET(DEBUG_CYCLETIME, 1, averageSystemLoadPercent);
     }
 }
 
-
 bool isFlipOverAfterCrashMode(void) {
     return flipOverAfterCrashMode;
 }
@@ -23,6 +23,8 @@
 #include "common/time.h"
 #include "pg/pg.h"
 
+#include "build/loop_rate.h"
+
 #if defined(USE_GPS) || defined(USE_MAG)
 extern int16_t magHold;
 #endif
@@ -46,7 +48,12 @@ void tryArm(void);
 bool processRx(timeUs_t currentTimeUs);
 void updateArmingStatus(void);
 
+void pidLoopInit(void);
 void taskMainPidLoop(timeUs_t currentTimeUs);
+#ifdef USE_GYRO_PID_INTERRUPT
+bool pidInterruptInit(void);
+bool pidInterruptTaskReady(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
+#endif
 bool isFlipOverAfterCrashMode(void);
 int8_t calculateThrottlePercent(void);
 uint8_t calculateThrottlePercentAbs(void);
@@ -58,3 +65,10 @@ bool isTryingToArm();
 void resetTryingToArm();
 
 void subTaskTelemetryPollSensors(timeUs_t currentTimeUs);
+
+#ifdef USE_CYCLE_BENCH
+#define LOOP_RATE_MAX_GYRO_SYNC_DENOM 32
+
+void getConfiguredLoopRate(loopRate_t *rate, uint8_t *maxGyroSyncDenom);
+bool isLoopRateOverBudget(void);
+#endif
@@ -24,13 +24,22 @@
 
 #include "platform.h"
 
+#include "build/atomic.h"
+
+#include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "fc/fc_dispatch.h"
 
-static dispatchEntry_t *head = NULL;
+#include "scheduler/scheduler.h"
+
+// Binary min-heap on delayedUntil. Entries keep their heap index, so cancelling is O(log n) as well.
+// The heap is only touched with interrupts masked, entries may be added from interrupt handlers.
+static dispatchEntry_t *heap[DISPATCH_QUEUE_SIZE];
+static uint8_t heapCount = 0;
 static bool dispatchEnabled = false;
 
 bool dispatchIsEnabled(void) {
@@ -41,28 +50,109 @@ void dispatchEnable(void) {
     dispatchEnabled = true;
 }
 
+static bool isEarlier(const dispatchEntry_t *a, const dispatchEntry_t *b) {
+    return cmp32(a->delayedUntil, b->delayedUntil) < 0;
+}
+
+static void heapPlace(dispatchEntry_t *entry, int index) {
+    heap[index] = entry;
+    entry->heapIndex = index;
+}
+
+static void heapSiftUp(int index) {
+    dispatchEntry_t *entry = heap[index];
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!isEarlier(entry, heap[parent])) {
+            break;
+        }
+        heapPlace(heap[parent], index);
+        index = parent;
+    }
+    heapPlace(entry, index);
+}
+
+static void heapSiftDown(int index) {
+    dispatchEntry_t *entry = heap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= heapCount) {
+            break;
+        }
+        if (child + 1 < heapCount && isEarlier(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!isEarlier(heap[child], entry)) {
+            break;
+        }
+        heapPlace(heap[child], index);
+        index = child;
+    }
+    heapPlace(entry, index);
+}
+
+static void heapRemove(dispatchEntry_t *entry) {
+    const int index = entry->heapIndex;
+    entry->inQue = false;
+    heapCount--;
+    if (index == heapCount) {
+        return;
+    }
+    // move the last entry into the hole, it may have to go either way
+    heapPlace(heap[heapCount], index);
+    heapSiftDown(index);
+    heapSiftUp(heap[index]->heapIndex);
+}
+
 void dispatchProcess(uint32_t currentTime) {
-    for (dispatchEntry_t **p = &head; *p; ) {
-        if (cmp32(currentTime, (*p)->delayedUntil) < 0)
+    for (;;) {
+        dispatchEntry_t *current = NULL;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            if (heapCount && cmp32(currentTime, heap[0]->delayedUntil) >= 0) {
+                current = heap[0];
+                // unlink entry first, so handler can replan self
+                heapRemove(current);
+            }
+        }
+        if (!current) {
             break;
-        // unlink entry first, so handler can replan self
-        dispatchEntry_t *current = *p;
-        *p = (*p)->next;
-        current->inQue = false;
+        }
         (*current->dispatch)(current);
     }
+    // wake up for the next entry instead of polling for it
+    int32_t nextUs = DISPATCH_POLL_PERIOD_US;
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (heapCount) {
+            nextUs = constrain(cmp32(heap[0]->delayedUntil, currentTime), 0, DISPATCH_POLL_PERIOD_US);
+        }
+    }
+    rescheduleTask(TASK_SELF, nextUs);
+}
+
+bool dispatchAdd(dispatchEntry_t *entry, int delayUs) {
+    const uint32_t delayedUntil = micros() + delayUs;
+    bool added = false;
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        // already in queue or no room left, abort
+        if (!entry->inQue && heapCount < DISPATCH_QUEUE_SIZE) {
+            entry->delayedUntil = delayedUntil;
+            entry->inQue = true;
+            heapPlace(entry, heapCount++);
+            heapSiftUp(entry->heapIndex);
+            added = true;
+        }
+    }
+    return added;
 }
 
-void dispatchAdd(dispatchEntry_t *entry, int delayUs) {
-    uint32_t delayedUntil = micros() + delayUs;
-    dispatchEntry_t **p = &head;
-    if (entry->inQue) {
-        return;    // Allready in Queue, abort
+void dispatchCancel(dispatchEntry_t *entry) {
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (entry->inQue) {
+            heapRemove(entry);
+        }
     }
-    while (*p && cmp32((*p)->delayedUntil, delayedUntil) < 0)
-        p = &(*p)->next;
-    entry->next = *p;
-    entry->delayedUntil = delayedUntil;
-    entry->inQue = true;
-    *p = entry;
+}
+
+bool dispatchIsQueued(const dispatchEntry_t *entry) {
+    return entry->inQue;
 }
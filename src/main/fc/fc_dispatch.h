@@ -20,17 +20,29 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+// deferred calls queued at the same time, a driver normally owns one or two entries
+#ifndef DISPATCH_QUEUE_SIZE
+#define DISPATCH_QUEUE_SIZE 16
+#endif
+// longest sleep of the dispatch task, an entry added from an interrupt waits at most this long
+#define DISPATCH_POLL_PERIOD_US 1000
+
 struct dispatchEntry_s;
 typedef void dispatchFunc(struct dispatchEntry_s* self);
 
 typedef struct dispatchEntry_s {
     dispatchFunc *dispatch;
     uint32_t delayedUntil;
-    struct dispatchEntry_s *next;
+    uint8_t heapIndex;      // position in the queue while inQue
     bool inQue;
 } dispatchEntry_t;
 
 bool dispatchIsEnabled(void);
 void dispatchEnable(void);
 void dispatchProcess(uint32_t currentTime);
-void dispatchAdd(dispatchEntry_t *entry, int delayUs);
+bool dispatchAdd(dispatchEntry_t *entry, int delayUs);
+void dispatchCancel(dispatchEntry_t *entry);
+bool dispatchIsQueued(const dispatchEntry_t *entry);
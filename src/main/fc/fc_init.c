@@ -47,6 +47,7 @@
 #include "drivers/buttons.h"
 #include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
+#include "drivers/crc_hw.h"
 #include "drivers/dma.h"
 #include "drivers/exti.h"
 #include "drivers/flash.h"
@@ -71,6 +72,7 @@
 #include "drivers/usb_io.h"
 #include "drivers/vtx_rtc6705.h"
 #include "drivers/vtx_common.h"
+#include "drivers/rx/rx_spi.h"
 #ifdef USE_USB_MSC
 #include "drivers/usb_msc.h"
 #endif
@@ -89,6 +91,7 @@
 #include "fc/fc_tasks.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
+#include "fc/warm_boot.h"
 
 #include "interface/cli.h"
 #include "interface/msp.h"
@@ -157,6 +160,7 @@
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/rpm_filter.h"
 #include "flight/servos.h"
 
 #include "io/rcdevice_cam.h"
@@ -166,6 +170,7 @@
 #endif
 
 #include "build/build_config.h"
+#include "build/cycle_profile.h"
 #include "build/debug.h"
 
 #ifdef TARGET_PREINIT
@@ -177,6 +182,9 @@ serialPort_t *loopbackPort;
 #endif
 
 uint8_t systemState = SYSTEM_STATE_INITIALISING;
+timeUs_t initStepTimeUs[INIT_STEP_COUNT];
+// set after a soft or brownout reset, i.e. when the board may still be in the air
+bool initWarmBoot = false;
 
 void processLoopback(void) {
 #ifdef SOFTSERIAL_LOOPBACK
@@ -216,11 +224,20 @@ void init(void) {
     extern uint8_t _sfastram_idata;
     memcpy(&_sfastram_data, &_sfastram_idata, (size_t) (&_efastram_data - &_sfastram_data));
 #endif
+#ifdef USE_DMA_RAM
+    /* Clear DMA_RAM, systemInit() makes it non-cacheable */
+    extern uint8_t _sdmaram_bss;
+    extern uint8_t _edmaram_region;
+    memset(&_sdmaram_bss, 0, (size_t) (&_edmaram_region - &_sdmaram_bss));
+#endif
 #ifdef USE_HAL_DRIVER
     HAL_Init();
 #endif
     printfSupportInit();
     systemInit();
+#ifdef USE_CRC_HW
+    crcHwInit();
+#endif
     initEEPROM();
     ensureEEPROMStructureIsValid();
     readEEPROM();
@@ -243,8 +260,11 @@ void init(void) {
         resetEEPROM();
     }
     systemState |= SYSTEM_STATE_CONFIG_LOADED;
+    initStepTimeUs[INIT_STEP_CONFIG] = micros();
+    initWarmBoot = isMPUSoftReset() || isMPUBrownoutReset();
     //i2cSetOverclock(masterConfig.i2c_overclock);
-    debugMode = systemConfig()->debug_mode;
+    const uint8_t debugModeConfig[DEBUG_MODE_SLOT_COUNT] = { systemConfig()->debug_mode, systemConfig()->debug_mode_2 };
+    debugInit(debugModeConfig);
     // Latch active features to be used for feature() in the remainder of init().
     latchActiveFeatures();
 #ifdef TARGET_PREINIT
@@ -297,8 +317,9 @@ void init(void) {
 #ifdef USE_OVERCLOCK
     OverclockRebootIfNecessary(systemConfig()->cpu_overclock);
 #endif
-    delay(100);
+    delaySincePowerOn(100);
     timerInit();  // timer must be initialized before any channel is allocated
+    initStepTimeUs[INIT_STEP_TIMERS] = micros();
 #ifdef BUS_SWITCH_PIN
     busSwitchInit();
 #endif
@@ -331,6 +352,7 @@ void init(void) {
      * receiver may share timer with motors so motors MUST be initialized here. */
     motorDevInit(&motorConfig()->dev, idlePulse, getMotorCount());
     systemState |= SYSTEM_STATE_MOTORS_READY;
+    initStepTimeUs[INIT_STEP_MOTORS] = micros();
     if (0) {}
 #if defined(USE_PPM)
     else if (feature(FEATURE_RX_PPM)) {
@@ -440,10 +462,14 @@ void init(void) {
         setArmingDisabled(ARMING_DISABLED_NO_GYRO);
     }
     systemState |= SYSTEM_STATE_SENSORS_READY;
+    initStepTimeUs[INIT_STEP_SENSORS] = micros();
     // gyro.targetLooptime set in sensorsAutodetect(),
     // so we are ready to call validateAndFixGyroConfig(), pidInit(), and setAccelerationFilter()
     validateAndFixGyroConfig();
     pidInit(currentPidProfile);
+#ifdef USE_RPM_FILTER
+    rpmFilterInit(rpmFilterConfig());
+#endif
     if (sensors(SENSOR_ACC)) {
         accInitFilters();
     }
@@ -468,7 +494,8 @@ void init(void) {
     LED1_ON;
     LED0_OFF;
     LED2_OFF;
-    for (int i = 0; i < 10; i++) {
+    // skip the half second startup flash when rebooting mid-flight
+    for (int i = 0; i < (initWarmBoot ? 0 : 10); i++) {
         LED1_TOGGLE;
         LED0_TOGGLE;
 #if defined(USE_BEEPER)
@@ -485,6 +512,7 @@ void init(void) {
     LED0_OFF;
     LED1_OFF;
     imuInit();
+    initStepTimeUs[INIT_STEP_IMU] = micros();
     mspInit();
     mspSerialInit();
 #ifdef USE_CLI
@@ -610,10 +638,15 @@ void init(void) {
     if (mixerConfig()->mixerMode == MIXER_GIMBAL) {
         accSetCalibrationCycles(CALIBRATING_ACC_CYCLES);
     }
-    gyroStartCalibration(false);
+#ifdef USE_WARM_BOOT
+    if (!warmBootRestore())
+#endif
+    {
+        gyroStartCalibration(false);
 #ifdef USE_BARO
-    baroSetCalibrationCycles(CALIBRATING_BARO_CYCLES);
+        baroSetCalibrationCycles(CALIBRATING_BARO_CYCLES);
 #endif
+    }
 #ifdef USE_VTX_CONTROL
     vtxControlInit();
 #if defined(USE_VTX_COMMON)
@@ -668,6 +701,21 @@ void init(void) {
     latchActiveFeatures();
     pwmEnableMotors();
     setArmingDisabled(ARMING_DISABLED_BOOT_GRACE_TIME);
+#ifdef USE_GYRO_SPI_DMA
+    gyroInitSpiDma();
+#endif
+#ifdef USE_FLASH_SPI_DMA
+    flashInitDma();
+#endif
+#ifdef USE_RX_SPI_DMA
+    if (feature(FEATURE_RX_SPI)) {
+        rxSpiInitDma();
+    }
+#endif
+#ifdef USE_CYCLE_PROFILE
+    cycleProfileInit(systemConfig()->cycle_profile);
+#endif
     fcTasksInit();
     systemState |= SYSTEM_STATE_READY;
+    initStepTimeUs[INIT_STEP_READY] = micros();
 }
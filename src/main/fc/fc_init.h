@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     SYSTEM_STATE_INITIALISING   = 0,
     SYSTEM_STATE_CONFIG_LOADED  = (1 << 0),
@@ -31,5 +33,22 @@ typedef enum {
 
 extern uint8_t systemState;
 
+typedef enum {
+    INIT_STEP_CONFIG,
+    INIT_STEP_TIMERS,
+    INIT_STEP_MOTORS,
+    INIT_STEP_GYRO,
+    INIT_STEP_MAG,
+    INIT_STEP_BARO,
+    INIT_STEP_SENSORS,
+    INIT_STEP_IMU,
+    INIT_STEP_READY,
+    INIT_STEP_COUNT
+} initStep_e;
+
+// micros() at the end of each init() step, for spotting slow boots
+extern timeUs_t initStepTimeUs[INIT_STEP_COUNT];
+extern bool initWarmBoot;
+
 void init(void);
 void processLoopback(void);
@@ -76,6 +76,12 @@ static float throttleDAttenuation;
 static bool reverseMotors = false;
 static applyRatesFn *applyRates;
 
+// The active rate curve sampled over stick deflection [0;1], all rate types are odd so the sign is
+// put back afterwards. Rebuilt by initRcProcessing() whenever the rate profile or its values change,
+// an in-flight adjustment of one axis only rebuilds that axis' row with initRcRatesAxis().
+#define RC_RATES_LUT_SEGMENTS 128
+static FAST_RAM_ZERO_INIT float ratesLut[XYZ_AXIS_COUNT][RC_RATES_LUT_SEGMENTS + 1];
+
 // static float rcCommandInterp[4] = { 0, 0, 0, 0 };
 // static float rcStepSize[4] = { 0, 0, 0, 0 };
 // static float inverseRcInt;
@@ -99,8 +105,22 @@ volatile uint16_t currentRxRefreshRate;
 #define RC_SMOOTHING_RX_RATE_MAX_US             50000 // 50ms or 20hz
 
 static FAST_RAM_ZERO_INIT rcSmoothingFilter_t rcSmoothingData;
+
+static timeUs_t rcFrameTimeUs;                                  // rx frame behind the newest rcData
+static FAST_RAM_ZERO_INIT timeUs_t setpointFrameTimeUs;         // rx frame behind setpointRate, until its motor write
+static rcLatencyStats_t rcLatency;
 #endif // USE_RC_SMOOTHING_FILTER
 
+// Setpoint derivative for the D term, taken once per rx frame from the unsmoothed commands and the frame interval
+// instead of differentiating the smoothed setpoint every PID loop. Each frame's derivative is ramped in over the
+// frame interval and drops to zero when no frame follows.
+static FAST_RAM_ZERO_INIT float frameSetpoint[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float setpointDerivativeFrom[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float setpointDerivativeTo[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float setpointDerivative[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT timeUs_t setpointDerivativeFrameUs;
+static FAST_RAM_ZERO_INIT bool setpointDerivativeValid;
+
 float getSetpointRate(int axis) {
     return setpointRate[axis];
 }
@@ -113,6 +133,15 @@ float getRcDeflection(int axis) {
     return rcDeflection[axis];
 }
 
+float getSetpointDerivative(int axis) {
+    return setpointDerivative[axis];
+}
+
+// false while the setpoint isn't the stick rate of the frames, e.g. mixed into earth frame
+bool setpointDerivativeIsValid(void) {
+    return setpointDerivativeValid;
+}
+
 float getRcDeflectionAbs(int axis) {
     return rcDeflectionAbs[axis];
 }
@@ -190,6 +219,31 @@ float applyActualRates(const int axis, float rcCommandf, const float rcCommandfA
     return angleRate;
 }
 
+void initRcRatesAxis(int axis) {
+    for (int i = 0; i <= RC_RATES_LUT_SEGMENTS; i++) {
+        const float rcCommandf = (float)i / RC_RATES_LUT_SEGMENTS;
+        ratesLut[axis][i] = applyRates(axis, rcCommandf, rcCommandf);
+    }
+#ifdef USE_YAW_SPIN_RECOVERY
+    if (axis == FD_YAW) {
+        const int maxYawRate = (int)applyRates(FD_YAW, 1.0f, 1.0f);
+        initYawSpinRecovery(maxYawRate);
+    }
+#endif
+}
+
+static FAST_CODE float lookupRates(int axis, float rcCommandf, float rcCommandfAbs) {
+    if (rcCommandfAbs >= 1.0f) {
+        // rate dynamics can push the command past full deflection
+        return applyRates(axis, rcCommandf, rcCommandfAbs);
+    }
+    const float position = rcCommandfAbs * RC_RATES_LUT_SEGMENTS;
+    const int index = (int)position;
+    const float *segment = &ratesLut[axis][index];
+    const float angleRate = segment[0] + (segment[1] - segment[0]) * (position - index);
+    return rcCommandf < 0 ? -angleRate : angleRate;
+}
+
 static void calculateSetpointRate(int axis) {
     static volatile float angleRate;
 #ifdef USE_GPS_RESCUE
@@ -212,7 +266,7 @@ static void calculateSetpointRate(int axis) {
         rcDeflection[axis] = rcCommandf;
         const float rcCommandfAbs = ABS(rcCommandf);
         rcDeflectionAbs[axis] = rcCommandfAbs;
-        angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+        angleRate = lookupRates(axis, rcCommandf, rcCommandfAbs);
     }
     setpointRate[axis] = constrainf(angleRate, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT); // Rate limit protection (deg/sec)
     memcpy((uint32_t*)&setpointRateInt[axis], (uint32_t*)&setpointRate[axis], sizeof(float));
@@ -245,12 +299,55 @@ static void scaleRcCommandToFpvCamAngle(void) {
 #define THROTTLE_BUFFER_MAX 20
 #define THROTTLE_DELTA_MS 100
 
+// Ramps each new command in over one measured frame interval, timed from when the frame's last
+// byte arrived instead of counted in PID loops. The ramp is set up once per frame and lands
+// on the new value just as the next frame is due, whatever the link or loop rate.
+static FAST_CODE uint8_t processRcFrameInterpolation(void) {
+    static FAST_RAM_ZERO_INIT float rcCommandFrom[4];
+    static FAST_RAM_ZERO_INIT float rcCommandDelta[4];
+    static FAST_RAM_ZERO_INIT float rcCommandInterp[4];
+    static FAST_RAM_ZERO_INIT float rampRatePerUs;
+    static FAST_RAM_ZERO_INIT timeUs_t rampStartUs;
+    static FAST_RAM_ZERO_INIT bool ramping;
+    if (isRXDataNew) {
+        for (int channel = 0; channel < PRIMARY_CHANNEL_COUNT; channel++) {
+            rcCommandFrom[channel] = rcCommandInterp[channel];
+            rcCommandDelta[channel] = rcCommand[channel] - rcCommandInterp[channel];
+        }
+        rampStartUs = rcFrameTimeUs;
+        rampRatePerUs = 1.0f / currentRxRefreshRate;
+        ramping = true;
+        DEBUG_SET(DEBUG_RC_INTERPOLATION, 0, lrintf(rcCommand[0]));
+        DEBUG_SET(DEBUG_RC_INTERPOLATION, 1, lrintf(currentRxRefreshRate / 1000));
+    }
+    if (!ramping) {
+        return 0;
+    }
+    const float progress = constrainf(cmpTimeUs(micros(), rampStartUs) * rampRatePerUs, 0.0f, 1.0f);
+    if (progress >= 1.0f) {
+        ramping = false;
+    }
+    for (int channel = 0; channel < PRIMARY_CHANNEL_COUNT; channel++) {
+        if ((1 << channel) & interpolationChannels) {
+            rcCommandInterp[channel] = rcCommandFrom[channel] + rcCommandDelta[channel] * progress;
+            rcCommand[channel] = rcCommandInterp[channel];
+        } else {
+            rcCommandInterp[channel] = rcCommand[channel];
+        }
+    }
+    DEBUG_SET(DEBUG_RC_INTERPOLATION, 2, lrintf(progress * 100));
+    return PRIMARY_CHANNEL_COUNT;
+}
+
 FAST_CODE uint8_t processRcInterpolation(void) {
     static FAST_RAM_ZERO_INIT float rcCommandInterp[4];
     static FAST_RAM_ZERO_INIT float rcStepSize[4];
     static FAST_RAM_ZERO_INIT int16_t rcInterpolationStepCount;
     uint16_t rxRefreshRate;
     uint8_t updatedChannel = 0;
+    if (rxConfig()->rcInterpolation == RC_SMOOTHING_FRAME) {
+        return processRcFrameInterpolation();
+    }
     if (rxConfig()->rcInterpolation) {
         // Set RC refresh rate for sampling and channels to filter
         switch (rxConfig()->rcInterpolation) {
@@ -295,6 +392,17 @@ FAST_CODE uint8_t processRcInterpolation(void) {
 
 void updateRcRefreshRate(timeUs_t currentTimeUs) {
     static timeUs_t lastRxTimeUs;
+    const timeUs_t frameTimeUs = rxFrameTimeUs();
+    if (frameTimeUs) {
+        // protocols stamping frames in the rx interrupt give the real frame interval, not the task's
+        if (frameTimeUs == rcFrameTimeUs) {
+            return;
+        }
+        rcFrameTimeUs = frameTimeUs;
+        currentTimeUs = frameTimeUs;
+    } else {
+        rcFrameTimeUs = currentTimeUs;
+    }
     timeDelta_t refreshRateUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the protocol
     lastRxTimeUs = currentTimeUs;
     currentRxRefreshRate = constrain(refreshRateUs, 1000, 30000);
@@ -484,7 +592,7 @@ FAST_CODE uint8_t processRcSmoothingFilter(void) {
                 }
             }
             // rx frame rate training blackbox debugging
-            if (debugMode == DEBUG_RC_SMOOTHING_RATE) {
+            if (debugModeIsActive(DEBUG_RC_SMOOTHING_RATE)) {
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 0, currentRxRefreshRate);              // log each rx frame interval
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 1, rcSmoothingData.training.count);    // log the training step count
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 2, rcSmoothingData.averageFrameTimeUs);// the current calculated average
@@ -492,7 +600,7 @@ FAST_CODE uint8_t processRcSmoothingFilter(void) {
             }
         }
     }
-    if (rcSmoothingData.filterInitialized && (debugMode == DEBUG_RC_SMOOTHING)) {
+    if (rcSmoothingData.filterInitialized && (debugModeIsActive(DEBUG_RC_SMOOTHING))) {
         // after training has completed then log the raw rc channel and the calculated
         // average rx frame rate that was used to calculate the automatic filter cutoffs
         DEBUG_SET(DEBUG_RC_SMOOTHING, 0, lrintf(lastRxData[rxConfig()->rc_smoothing_debug_axis]));
@@ -511,9 +619,13 @@ FAST_CODE uint8_t processRcSmoothingFilter(void) {
                     rcCommand[updatedChannel] = biquadFilterApplyDF1((biquadFilter_t*) &rcSmoothingData.filter[updatedChannel], lastRxData[updatedChannel]);
                     break;
                 case RC_SMOOTHING_INPUT_PT2:
+                    rcCommand[updatedChannel] = pt2FilterApply((ptnFilter_t*) &rcSmoothingData.filter[updatedChannel], lastRxData[updatedChannel]);
+                    break;
                 case RC_SMOOTHING_INPUT_PT3:
+                    rcCommand[updatedChannel] = pt3FilterApply((ptnFilter_t*) &rcSmoothingData.filter[updatedChannel], lastRxData[updatedChannel]);
+                    break;
                 case RC_SMOOTHING_INPUT_PT4:
-                    rcCommand[updatedChannel] = ptnFilterApply((ptnFilter_t*) &rcSmoothingData.filter[updatedChannel], lastRxData[updatedChannel]);
+                    rcCommand[updatedChannel] = pt4FilterApply((ptnFilter_t*) &rcSmoothingData.filter[updatedChannel], lastRxData[updatedChannel]);
                     break;
                   }
             } else {
@@ -526,8 +638,40 @@ FAST_CODE uint8_t processRcSmoothingFilter(void) {
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
+// rcCommand still holds the frame's own values here, before any smoothing
+static FAST_CODE void updateSetpointDerivativeFrame(void) {
+    const float frameRate = 1e6f / currentRxRefreshRate;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        const float rcCommandf = rcCommand[axis] / 500.0f;
+        const float setpoint = constrainf(lookupRates(axis, rcCommandf, ABS(rcCommandf)), -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+        setpointDerivativeFrom[axis] = setpointDerivative[axis];
+        setpointDerivativeTo[axis] = (setpoint - frameSetpoint[axis]) * frameRate;
+        frameSetpoint[axis] = setpoint;
+    }
+    setpointDerivativeFrameUs = rcFrameTimeUs;
+}
+
+static FAST_CODE void updateSetpointDerivative(void) {
+    const timeDelta_t sinceFrameUs = cmpTimeUs(micros(), setpointDerivativeFrameUs);
+    if (sinceFrameUs > 2 * currentRxRefreshRate) {
+        // the stick rate hasn't changed for two frames' time
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            setpointDerivative[axis] = 0.0f;
+        }
+        return;
+    }
+    const float progress = constrainf(sinceFrameUs / (float)currentRxRefreshRate, 0.0f, 1.0f);
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        setpointDerivative[axis] = setpointDerivativeFrom[axis] + (setpointDerivativeTo[axis] - setpointDerivativeFrom[axis]) * progress;
+    }
+}
+
 FAST_CODE void processRcCommand(void) {
     uint8_t updatedChannel;
+    if (isRXDataNew) {
+        updateSetpointDerivativeFrame();
+    }
+    updateSetpointDerivative();
     switch (rxConfig()->rc_smoothing_type) {
 #ifdef USE_RC_SMOOTHING_FILTER
     case RC_SMOOTHING_TYPE_FILTER:
@@ -553,17 +697,21 @@ FAST_CODE void processRcCommand(void) {
         }
         DEBUG_SET(DEBUG_RC_INTERPOLATION, 3, setpointRate[0]);
         isSetpointNew = 1;
-        if (debugMode == DEBUG_RC_INTERPOLATION) {
-            debug[2] = rcInterpolationStepCount;
-            debug[3] = setpointRate[0];
-        }
+        DEBUG_SET(DEBUG_RC_INTERPOLATION, 2, rcInterpolationStepCount);
+#ifdef USE_GPS_RESCUE
+        setpointDerivativeValid = !FLIGHT_MODE(GPS_RESCUE_MODE);
+#else
+        setpointDerivativeValid = true;
+#endif
         // Scaling of AngleRate to camera angle (Mixing Roll and Yaw)
         if ((rxConfig()->fpvCamAngleDegrees || (rxConfig()->cinematicYaw && !(accelerometerConfig()->acc_hardware == ACC_NONE))) && IS_RC_MODE_ACTIVE(BOXFPVANGLEMIX) && !FLIGHT_MODE(HEADFREE_MODE)) {
             scaleRcCommandToFpvCamAngle();
+            setpointDerivativeValid = false;
         }
         // HEADFREE_MODE in ACRO_MODE
         // yaw rotation is earthframe bound
         if (FLIGHT_MODE(HEADFREE_MODE) && (!FLIGHT_MODE(ANGLE_MODE)) && (!FLIGHT_MODE(HORIZON_MODE))) {
+            setpointDerivativeValid = false;
             quaternion  vSetpointRate = VECTOR_INITIALIZE;
             vSetpointRate.x = setpointRate[ROLL];
             vSetpointRate.y = setpointRate[PITCH];
@@ -578,10 +726,41 @@ FAST_CODE void processRcCommand(void) {
         DEBUG_SET(DEBUG_ANGLERATE, YAW, setpointRate[YAW]);
     }
     if (isRXDataNew) {
+        setpointFrameTimeUs = rcFrameTimeUs;
         isRXDataNew = false;
     }
 }
 
+// Called after the motor outputs are written, closes the measurement of the rx frame that produced them
+FAST_CODE void rcLatencyMotorsWritten(void) {
+    if (!setpointFrameTimeUs) {
+        return;
+    }
+    const timeDelta_t latencyUs = cmpTimeUs(micros(), setpointFrameTimeUs);
+    setpointFrameTimeUs = 0;
+    if (latencyUs < 0 || latencyUs > RC_LATENCY_MAX_US) {
+        return;
+    }
+    if (rcLatency.count == 0) {
+        rcLatency.minUs = latencyUs;
+        rcLatency.maxUs = latencyUs;
+        rcLatency.avgUs = latencyUs;
+    } else {
+        rcLatency.minUs = MIN(rcLatency.minUs, latencyUs);
+        rcLatency.maxUs = MAX(rcLatency.maxUs, latencyUs);
+        rcLatency.avgUs += (latencyUs - rcLatency.avgUs) / 16;
+    }
+    rcLatency.count++;
+    DEBUG_SET(DEBUG_RX_LATENCY, 0, latencyUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 1, rcLatency.avgUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 2, rcLatency.minUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 3, rcLatency.maxUs);
+}
+
+const rcLatencyStats_t *getRcLatencyStats(void) {
+    return &rcLatency;
+}
+
 static void applyRollYawMix(void) {
     float rollAddition, yawAddition, unchangedRoll;
 
@@ -785,7 +964,7 @@ bool isMotorsReversed(void) {
     return reverseMotors;
 }
 
-void initRcProcessing(void) {
+void initRcThrottleLookup(void) {
     for (int i = 0; i < THROTTLE_LOOKUP_LENGTH; i++) {
         const int16_t tmp = 10 * i - currentControlRateProfile->thrMid8;
         uint8_t y = 1;
@@ -796,6 +975,10 @@ void initRcProcessing(void) {
         lookupThrottleRC[i] = 10 * currentControlRateProfile->thrMid8 + tmp * (100 - currentControlRateProfile->thrExpo8 + (int32_t) currentControlRateProfile->thrExpo8 * (tmp * tmp) / (y * y)) / 10;
         lookupThrottleRC[i] = PWM_RANGE_MIN + (PWM_RANGE_MAX - PWM_RANGE_MIN) * lookupThrottleRC[i] / 1000; // [MINTHROTTLE;MAXTHROTTLE]
     }
+}
+
+void initRcProcessing(void) {
+    initRcThrottleLookup();
     switch (currentControlRateProfile->rates_type) {
     case RATES_TYPE_BETAFLIGHT:
     default:
@@ -811,6 +994,9 @@ void initRcProcessing(void) {
         applyRates = applyActualRates;
         break;
     }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        initRcRatesAxis(axis);
+    }
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
     case INTERPOLATION_CHANNELS_RPYT:
@@ -829,10 +1015,6 @@ void initRcProcessing(void) {
         interpolationChannels |= THROTTLE_FLAG;
         break;
     }
-#ifdef USE_YAW_SPIN_RECOVERY
-    const int maxYawRate = (int)applyRates(FD_YAW, 1.0f, 1.0f);
-    initYawSpinRecovery(maxYawRate);
-#endif
 }
 
 bool rcSmoothingIsEnabled(void) {
@@ -30,6 +30,16 @@ typedef enum {
     INTERPOLATION_CHANNELS_RPT,
 } interpolationChannels_e;
 
+// rx frames older than this when their motor write happens are not counted
+#define RC_LATENCY_MAX_US 100000
+
+typedef struct rcLatencyStats_s {
+    uint32_t count;
+    timeDelta_t minUs;
+    timeDelta_t avgUs;      // running average over the last ~16 frames
+    timeDelta_t maxUs;
+} rcLatencyStats_t;
+
 extern volatile bool        isSetpointNew;
 extern volatile uint16_t    currentRxRefreshRate;
 
@@ -37,6 +47,8 @@ void processRcCommand(void);
 float getSetpointRate(int axis);
 uint32_t getSetpointRateInt(int axis);
 float getRcDeflection(int axis);
+float getSetpointDerivative(int axis);
+bool setpointDerivativeIsValid(void);
 float getRcDeflectionAbs(int axis);
 float getThrottlePAttenuation(void);
 float getThrottleIAttenuation(void);
@@ -44,6 +56,8 @@ float getThrottleDAttenuation(void);
 void updateRcCommands(void);
 void resetYawAxis(void);
 void initRcProcessing(void);
+void initRcThrottleLookup(void);
+void initRcRatesAxis(int axis);
 bool isMotorsReversed(void);
 bool rcSmoothingIsEnabled(void);
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -52,3 +66,5 @@ bool rcSmoothingAutoCalculate(void);
 bool rcSmoothingInitializationComplete(void);
 #endif
 void updateRcRefreshRate(timeUs_t currentTimeUs);
+void rcLatencyMotorsWritten(void);
+const rcLatencyStats_t *getRcLatencyStats(void);
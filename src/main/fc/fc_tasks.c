@@ -24,17 +24,19 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "build/debug.h"
 
 #include "cms/cms.h"
 
 #include "common/color.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/feature.h"
 
 #include "drivers/accgyro/accgyro.h"
-#include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
 #include "drivers/dma_spi.h"
 #include "drivers/sensor.h"
@@ -59,6 +61,7 @@
 #include "fc/fc_dispatch.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
+#include "fc/warm_boot.h"
 
 #include "flight/position.h"
 #include "flight/imu.h"
@@ -96,6 +99,9 @@
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#ifdef USE_GYRO_DATA_ANALYSE
+#include "sensors/gyroanalyse.h"
+#endif
 #include "sensors/sensors.h"
 #include "sensors/rangefinder.h"
 
@@ -141,6 +147,13 @@ static bool taskSerialCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime
 }
 #endif
 
+#ifdef USE_WARM_BOOT
+static void taskUpdateAttitude(timeUs_t currentTimeUs) {
+    imuUpdateAttitude(currentTimeUs);
+    warmBootUpdate();
+}
+#endif
+
 static void taskHandleSerial(timeUs_t currentTimeUs) {
     UNUSED(currentTimeUs);
 #if defined(USE_VCP)
@@ -181,7 +194,24 @@ static void taskUpdateAccelerometer(timeUs_t currentTimeUs) {
     accUpdate(currentTimeUs, &accelerometerConfigMutable()->accelerometerTrims);
 }
 
+#define RX_TASK_PERIOD_MIN_US TASK_PERIOD_HZ(1000)
+#define RX_TASK_PERIOD_MAX_US TASK_PERIOD_HZ(160)
+
+// The scheduler ages a signalled event task in units of its period, so with a 500Hz-1kHz link
+// and the 160Hz fallback period a waiting frame would lose to far less urgent tasks.
+// Follow the frame interval measured from the rx interrupt timestamps instead.
+static void rxTaskFollowFrameRate(void) {
+    if (!rxFrameTimeUs()) {
+        return;
+    }
+    const timeDelta_t periodUs = constrain(currentRxRefreshRate, RX_TASK_PERIOD_MIN_US, RX_TASK_PERIOD_MAX_US);
+    if (ABS(periodUs - cfTasks[TASK_RX].desiredPeriod) > periodUs / 8) {
+        rescheduleTask(TASK_SELF, periodUs);
+    }
+}
+
 static void taskUpdateRxMain(timeUs_t currentTimeUs) {
+    rxTaskFollowFrameRate();
     if (!processRx(currentTimeUs)) {
         return;
     }
@@ -232,15 +262,6 @@ static void taskTelemetry(timeUs_t currentTimeUs) {
 }
 #endif
 
-#ifdef USE_CAMERA_CONTROL
-static void taskCameraControl(uint32_t currentTime) {
-    if (ARMING_FLAG(ARMED)) {
-        return;
-    }
-    cameraControlProcess(currentTime);
-}
-#endif
-
 void fcTasksInit(void) {
     schedulerInit();
     setTaskEnabled(TASK_MAIN, true);
@@ -266,13 +287,25 @@ void fcTasksInit(void) {
     setTaskEnabled(TASK_OSD_SLAVE, osdSlaveInitialized());
 #else
     if (sensors(SENSOR_GYRO)) {
-        rescheduleTask(TASK_GYROPID, gyro.targetLooptime);
+        pidLoopInit();
+        rescheduleTask(TASK_GYROPID, gyroTaskLooptime());
+#ifdef USE_GYRO_PID_INTERRUPT
+        if (pidInterruptInit()) {
+            // gyro and pid run in interrupts, the task only picks up what they hand over
+            cfTasks[TASK_GYROPID].checkFunc = pidInterruptTaskReady;
+            rescheduleTask(TASK_GYROPID, gyroTaskLooptime() * pidConfig()->pid_process_denom);
+        }
+#endif
         setTaskEnabled(TASK_GYROPID, true);
+#ifdef USE_SCHEDULER_IDLE_SLEEP
+        schedulerSetIdleSleep(systemConfig()->cpu_idle_sleep && gyroHasDataReadyInterrupt());
+#endif
     }
     if (sensors(SENSOR_ACC)) {
         setTaskEnabled(TASK_ACCEL, true);
         rescheduleTask(TASK_ACCEL, DEFAULT_ACC_SAMPLE_INTERVAL);
         setTaskEnabled(TASK_ATTITUDE, true);
+        rescheduleTask(TASK_ATTITUDE, TASK_PERIOD_HZ(imuConfig()->attitude_rate_hz));
     }
     setTaskEnabled(TASK_RX, true);
     setTaskEnabled(TASK_DISPATCH, dispatchIsEnabled());
@@ -288,6 +321,9 @@ void fcTasksInit(void) {
 #ifdef USE_BARO
     setTaskEnabled(TASK_BARO, sensors(SENSOR_BARO));
 #endif
+#ifdef USE_RANGEFINDER
+    setTaskEnabled(TASK_RANGEFINDER, sensors(SENSOR_RANGEFINDER));
+#endif
 #if defined(USE_BARO) || defined(USE_GPS)
     setTaskEnabled(TASK_ALTITUDE, sensors(SENSOR_BARO) || feature(FEATURE_GPS));
 #endif
@@ -321,6 +357,9 @@ void fcTasksInit(void) {
 #endif
 #ifdef USE_ESC_SENSOR
     setTaskEnabled(TASK_ESC_SENSOR, feature(FEATURE_ESC_SENSOR));
+    if (escSensorUseDshotEdt()) {
+        rescheduleTask(TASK_ESC_SENSOR, TASK_PERIOD_HZ(ESC_SENSOR_EDT_TASK_RATE_HZ));
+    }
 #endif
 #ifdef USE_ADC_INTERNAL
     setTaskEnabled(TASK_ADC_INTERNAL, true);
@@ -331,6 +370,16 @@ void fcTasksInit(void) {
 #ifdef USE_BEESIGN
     setTaskEnabled(TASK_BEESIGN, true);
 #endif
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    setTaskEnabled(TASK_BLACKBOX, blackboxConfig()->device != BLACKBOX_DEVICE_NONE);
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    if (sensors(SENSOR_GYRO) && isDynamicFilterActive() && isDynNotchInTask()) {
+        // one axis per run, as often as the gyro loop would have stepped through it
+        rescheduleTask(TASK_DYN_NOTCH, gyro.targetLooptime * DYN_NOTCH_STEP_COUNT);
+        setTaskEnabled(TASK_DYN_NOTCH, true);
+    }
+#endif
 #ifdef USE_CMS
 #ifdef USE_MSP_DISPLAYPORT
     setTaskEnabled(TASK_CMS, true);
@@ -343,9 +392,6 @@ void fcTasksInit(void) {
     setTaskEnabled(TASK_VTXCTRL, true);
 #endif
 #endif
-#ifdef USE_CAMERA_CONTROL
-    setTaskEnabled(TASK_CAMCTRL, true);
-#endif
 #ifdef USE_RCDEVICE
     setTaskEnabled(TASK_RCDEVICE, rcdeviceIsEnabled());
 #endif
@@ -453,7 +499,11 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
 
     [TASK_ATTITUDE] = {
         .taskName = "ATTITUDE",
+#ifdef USE_WARM_BOOT
+        .taskFunc = taskUpdateAttitude,
+#else
         .taskFunc = imuUpdateAttitude,
+#endif
         .desiredPeriod = TASK_PERIOD_HZ(DEFAULT_ATTITUDE_UPDATE_INTERVAL),
         .staticPriority = TASK_PRIORITY_HIGH,
     },
@@ -509,6 +559,16 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     },
 #endif
 
+#ifdef USE_RANGEFINDER
+    [TASK_RANGEFINDER] = {
+        .taskName = "RANGEFINDER",
+        .taskFunc = rangefinderUpdate,
+        .checkFunc = rangefinderUpdateCheck,
+        .desiredPeriod = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+#endif
+
 #if defined(USE_BARO) || defined(USE_GPS)
     [TASK_ALTITUDE] = {
         .taskName = "ALTITUDE",
@@ -522,7 +582,7 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_DASHBOARD] = {
         .taskName = "DASHBOARD",
         .taskFunc = dashboardUpdate,
-        .desiredPeriod = TASK_PERIOD_HZ(10),
+        .desiredPeriod = TASK_PERIOD_HZ(100),
         .staticPriority = TASK_PRIORITY_LOW,
     },
 #endif
@@ -567,7 +627,7 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_ESC_SENSOR] = {
         .taskName = "ESC_SENSOR",
         .taskFunc = escSensorProcess,
-        .desiredPeriod = TASK_PERIOD_HZ(100),       // 100 Hz, 10ms
+        .desiredPeriod = TASK_PERIOD_HZ(500),       // 500 Hz, 2ms, a reply takes about 1ms on the wire
         .staticPriority = TASK_PRIORITY_LOW,
     },
 #endif
@@ -599,15 +659,6 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     },
 #endif
 
-#ifdef USE_CAMERA_CONTROL
-    [TASK_CAMCTRL] = {
-        .taskName = "CAMCTRL",
-        .taskFunc = taskCameraControl,
-        .desiredPeriod = TASK_PERIOD_HZ(5),
-        .staticPriority = TASK_PRIORITY_IDLE
-    },
-#endif
-
 #ifdef USE_ADC_INTERNAL
     [TASK_ADC_INTERNAL] = {
         .taskName = "ADCINTERNAL",
@@ -635,5 +686,23 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     },
 #endif
 
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    [TASK_BLACKBOX] = {
+        .taskName = "BLACKBOX",
+        .taskFunc = blackboxEncodeUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(1000),      // drains all frames captured since the last run
+        .staticPriority = TASK_PRIORITY_LOW
+    },
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    [TASK_DYN_NOTCH] = {
+        .taskName = "DYNNOTCH",
+        .taskFunc = gyroDynNotchUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(2000),      // rescheduled from the gyro looptime in tasksInit()
+        .staticPriority = TASK_PRIORITY_LOW
+    },
+#endif
+
 #endif
 };
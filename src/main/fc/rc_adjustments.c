@@ -250,6 +250,73 @@ static int adjustmentRangeValue = -1;
 
 STATIC_UNIT_TESTED adjustmentState_t adjustmentStates[MAX_SIMULTANEOUS_ADJUSTMENT_COUNT];
 
+// Derived state an applied adjustment makes stale. It is collected over one processRcAdjustments()
+// call and only what changed is rebuilt, instead of the whole pid and rc processing init per step.
+#define ADJUSTMENT_STALE_PID_AXIS(axis)     (1 << (axis))       // pid gains of the axis
+#define ADJUSTMENT_STALE_RATES_AXIS(axis)   (1 << (3 + (axis))) // rates LUT row of the axis
+#define ADJUSTMENT_STALE_PID_LEVEL          (1 << 6)            // angle and horizon constants
+#define ADJUSTMENT_STALE_THROTTLE_LOOKUP    (1 << 7)
+
+static uint8_t adjustmentStaleState(adjustmentFunction_e adjustmentFunction) {
+    switch (adjustmentFunction) {
+    case ADJUSTMENT_RC_RATE:
+    case ADJUSTMENT_RC_EXPO:
+    case ADJUSTMENT_PITCH_ROLL_RATE:
+        return ADJUSTMENT_STALE_RATES_AXIS(FD_ROLL) | ADJUSTMENT_STALE_RATES_AXIS(FD_PITCH);
+    case ADJUSTMENT_ROLL_RC_RATE:
+    case ADJUSTMENT_ROLL_RC_EXPO:
+    case ADJUSTMENT_ROLL_RATE:
+        return ADJUSTMENT_STALE_RATES_AXIS(FD_ROLL);
+    case ADJUSTMENT_PITCH_RC_RATE:
+    case ADJUSTMENT_PITCH_RC_EXPO:
+    case ADJUSTMENT_PITCH_RATE:
+        return ADJUSTMENT_STALE_RATES_AXIS(FD_PITCH);
+    case ADJUSTMENT_RC_RATE_YAW:
+    case ADJUSTMENT_YAW_RATE:
+        return ADJUSTMENT_STALE_RATES_AXIS(FD_YAW);
+    case ADJUSTMENT_THROTTLE_EXPO:
+        return ADJUSTMENT_STALE_THROTTLE_LOOKUP;
+    case ADJUSTMENT_PITCH_ROLL_P:
+    case ADJUSTMENT_PITCH_ROLL_I:
+    case ADJUSTMENT_PITCH_ROLL_D:
+        return ADJUSTMENT_STALE_PID_AXIS(FD_ROLL) | ADJUSTMENT_STALE_PID_AXIS(FD_PITCH);
+    case ADJUSTMENT_ROLL_P:
+    case ADJUSTMENT_ROLL_I:
+    case ADJUSTMENT_ROLL_D:
+        return ADJUSTMENT_STALE_PID_AXIS(FD_ROLL);
+    case ADJUSTMENT_PITCH_P:
+    case ADJUSTMENT_PITCH_I:
+    case ADJUSTMENT_PITCH_D:
+        return ADJUSTMENT_STALE_PID_AXIS(FD_PITCH);
+    case ADJUSTMENT_YAW_P:
+    case ADJUSTMENT_YAW_I:
+    case ADJUSTMENT_YAW_D:
+        return ADJUSTMENT_STALE_PID_AXIS(FD_YAW);
+    case ADJUSTMENT_HORIZON_STRENGTH:
+        return ADJUSTMENT_STALE_PID_LEVEL;
+    default:
+        // a rate profile change runs the full init itself
+        return 0;
+    }
+}
+
+static void rebuildStaleState(uint8_t staleState) {
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (staleState & ADJUSTMENT_STALE_PID_AXIS(axis)) {
+            pidInitAxisGains(currentPidProfile, axis);
+        }
+        if (staleState & ADJUSTMENT_STALE_RATES_AXIS(axis)) {
+            initRcRatesAxis(axis);
+        }
+    }
+    if (staleState & ADJUSTMENT_STALE_PID_LEVEL) {
+        pidInitLevelConfig(currentPidProfile);
+    }
+    if (staleState & ADJUSTMENT_STALE_THROTTLE_LOOKUP) {
+        initRcThrottleLookup();
+    }
+}
+
 STATIC_UNIT_TESTED void configureAdjustment(uint8_t index, uint8_t auxSwitchChannelIndex, const adjustmentConfig_t *adjustmentConfig) {
     adjustmentState_t *adjustmentState = &adjustmentStates[index];
     if (adjustmentState->config == adjustmentConfig) {
@@ -299,7 +366,6 @@ static int applyStepAdjustment(controlRateConfig_t *controlRateConfig, uint8_t a
     case ADJUSTMENT_THROTTLE_EXPO:
         newValue = constrain((int)controlRateConfig->thrExpo8 + delta, 0, 100); // FIXME magic numbers repeated in cli.c
         controlRateConfig->thrExpo8 = newValue;
-        initRcProcessing();
         blackboxLogInflightAdjustmentEvent(ADJUSTMENT_THROTTLE_EXPO, newValue);
         break;
     case ADJUSTMENT_PITCH_ROLL_RATE:
@@ -433,7 +499,6 @@ static int applyAbsoluteAdjustment(controlRateConfig_t *controlRateConfig, adjus
     case ADJUSTMENT_THROTTLE_EXPO:
         newValue = constrain(value, 0, 100); // FIXME magic numbers repeated in cli.c
         controlRateConfig->thrExpo8 = newValue;
-        initRcProcessing();
         blackboxLogInflightAdjustmentEvent(ADJUSTMENT_THROTTLE_EXPO, newValue);
         break;
     case ADJUSTMENT_PITCH_ROLL_RATE:
@@ -571,6 +636,7 @@ static uint8_t applySelectAdjustment(adjustmentFunction_e adjustmentFunction, ui
 void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
     const uint32_t now = millis();
     int newValue = -1;
+    uint8_t staleState = 0;
     const bool canUseRxData = rxIsReceivingSignal();
     // Process Increment/Decrement adjustments
     for (int adjustmentIndex = 0; adjustmentIndex < MAX_SIMULTANEOUS_ADJUSTMENT_COUNT; adjustmentIndex++) {
@@ -609,7 +675,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
                 continue;
             }
             newValue = applyStepAdjustment(controlRateConfig, adjustmentFunction, delta);
-            pidInitConfig(currentPidProfile);
+            staleState |= adjustmentStaleState(adjustmentFunction);
         } else if (adjustmentState->config->mode == ADJUSTMENT_MODE_SELECT) {
             int switchPositions = adjustmentState->config->data.switchPositions;
             if (adjustmentFunction == ADJUSTMENT_RATE_PROFILE && systemConfig()->rateProfile6PosSwitch) {
@@ -618,6 +684,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
             const uint16_t rangeWidth = (2100 - 900) / switchPositions;
             const uint8_t position = (constrain(rcData[channelIndex], 900, 2100 - 1) - 900) / rangeWidth;
             newValue = applySelectAdjustment(adjustmentFunction, position);
+            staleState |= adjustmentStaleState(adjustmentFunction);
         }
 #if defined(USE_OSD) && defined(USE_OSD_ADJUSTMENTS)
         if (newValue != -1 && adjustmentState->config->adjustmentFunction != ADJUSTMENT_RATE_PROFILE) { // Rate profile already has an OSD element
@@ -632,6 +699,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
     // Process Absolute adjustments
     for (int index = 0; index < MAX_ADJUSTMENT_RANGE_COUNT; index++) {
         static int16_t lastRcData[MAX_ADJUSTMENT_RANGE_COUNT] = { 0 };
+        static int lastValue[MAX_ADJUSTMENT_RANGE_COUNT] = { 0 };
         const adjustmentRange_t * const adjustmentRange = adjustmentRanges(index);
         const uint8_t channelIndex = NON_AUX_CHANNEL_COUNT + adjustmentRange->auxSwitchChannelIndex;
         const adjustmentConfig_t *adjustmentConfig = &defaultAdjustmentConfigs[adjustmentRange->adjustmentFunction - ADJUSTMENT_FUNCTION_CONFIG_INDEX_OFFSET];
@@ -641,11 +709,19 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
                 (adjustmentConfig->mode == ADJUSTMENT_MODE_STEP) &&
                 isRangeActive(adjustmentRange->auxChannelIndex, &adjustmentRange->range)) {
             int value = (((rcData[channelIndex] - PWM_RANGE_MIDDLE) * adjustmentRange->adjustmentScale) / (PWM_RANGE_MIDDLE - PWM_RANGE_MIN)) + adjustmentRange->adjustmentCenter;
+            // rc noise moves the channel without changing the scaled value, only rebuild the derived state on a new value
+            const bool firstValue = lastRcData[index] == 0;
             lastRcData[index] = rcData[channelIndex];
-            applyAbsoluteAdjustment(controlRateConfig, adjustmentRange->adjustmentFunction, value);
-            pidInitConfig(currentPidProfile);
+            if (firstValue || value != lastValue[index]) {
+                lastValue[index] = value;
+                applyAbsoluteAdjustment(controlRateConfig, adjustmentRange->adjustmentFunction, value);
+                staleState |= adjustmentStaleState(adjustmentRange->adjustmentFunction);
+            }
         }
     }
+    if (staleState) {
+        rebuildStaleState(staleState);
+    }
 }
 
 void resetAdjustmentStates(void) {
@@ -82,12 +82,13 @@ PG_RESET_TEMPLATE(rcControlsConfig_t, rcControlsConfig,
                   .yaw_control_reversed = false
                  );
 
-PG_REGISTER_WITH_RESET_TEMPLATE(armingConfig_t, armingConfig, PG_ARMING_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(armingConfig_t, armingConfig, PG_ARMING_CONFIG, 2);
 
 PG_RESET_TEMPLATE(armingConfig_t, armingConfig,
                   .gyro_cal_on_first_arm = 0,  // TODO - Cleanup retarded arm support
                   .auto_disarm_delay = 5,
-                  .isUsingSticksForArming = false
+                  .isUsingSticksForArming = false,
+                  .warm_boot_rearm = 0,
                  );
 
 PG_REGISTER_WITH_RESET_TEMPLATE(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
@@ -364,5 +365,6 @@ int32_t getRcStickDeflection(int32_t axis, uint16_t midrc) {
 }
 
 void rcControlsInit(void) {
+    analyzeModeActivationConditions();
     isUsingSticksToArm = !isModeActivationConditionPresent(BOXARM);
 }
@@ -58,7 +58,8 @@ typedef enum {
     RC_SMOOTHING_OFF = 0,
     RC_SMOOTHING_DEFAULT,
     RC_SMOOTHING_AUTO,
-    RC_SMOOTHING_MANUAL
+    RC_SMOOTHING_MANUAL,
+    RC_SMOOTHING_FRAME
 } rcSmoothing_t;
 
 typedef enum {
@@ -150,6 +151,7 @@ typedef struct armingConfig_s {
     uint8_t gyro_cal_on_first_arm;          // allow disarm/arm on throttle down + roll left/right
     uint8_t auto_disarm_delay;              // allow automatically disarming multicopters after auto_disarm_delay seconds of zero throttle. Disabled when 0
     bool isUsingSticksForArming;            // allow using sticks position to arm
+    uint8_t warm_boot_rearm;                // allow arming with the switch already on and the throttle up right after a reset in flight
 } armingConfig_t;
 
 PG_DECLARE(armingConfig_t, armingConfig);
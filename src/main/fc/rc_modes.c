@@ -49,13 +49,25 @@
 boxBitmask_t rcModeActivationMask; // one bit per mode defined in boxId_e
 static boxBitmask_t stickyModesEverDisabled;
 
+// The range boundaries of the conditions on each AUX channel, sorted. Modes can only change
+// when a channel crosses one of them, so between crossings the conditions aren't evaluated.
+typedef struct modeAuxChannel_s {
+    uint8_t auxChannelIndex;
+    uint8_t firstBoundary;  // index into modeBoundaries
+    uint8_t boundaryCount;
+    uint8_t position;       // boundaries at or below the channel value at the last evaluation
+} modeAuxChannel_t;
+
+static uint16_t modeBoundaries[MAX_MODE_ACTIVATION_CONDITION_COUNT * 2];
+static modeAuxChannel_t modeAuxChannels[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t modeAuxChannelCount;
+static bool modeStickyConditionPresent;
+static bool modeEvaluationValid;
+static boxBitmask_t modeEvaluatedMask;
+
 PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions,
                   PG_MODE_ACTIVATION_PROFILE, 1);
 
-bool IS_RC_MODE_ACTIVE(boxId_e boxId) {
-    return bitArrayGet(&rcModeActivationMask, boxId);
-}
-
 void rcModeUpdate(boxBitmask_t *newState) {
     rcModeActivationMask = *newState;
 #ifdef USE_PINIOBOX
@@ -66,11 +78,15 @@ bool isAirmodeActive(void) {
     return (IS_RC_MODE_ACTIVE(BOXAIRMODE) || feature(FEATURE_AIRMODE));
 }
 
+static uint16_t auxChannelValue(uint8_t auxChannelIndex) {
+    return constrain(rcData[auxChannelIndex + NON_AUX_CHANNEL_COUNT], CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+}
+
 bool isRangeActive(uint8_t auxChannelIndex, const channelRange_t *range) {
     if (!IS_RANGE_USABLE(range)) {
         return false;
     }
-    const uint16_t channelValue = constrain(rcData[auxChannelIndex + NON_AUX_CHANNEL_COUNT], CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+    const uint16_t channelValue = auxChannelValue(auxChannelIndex);
     return (channelValue >= 900 + (range->startStep * 25) &&
             channelValue < 900 + (range->endStep * 25));
 }
@@ -99,7 +115,91 @@ void updateMasksForStickyModes(const modeActivationCondition_t *mac, boxBitmask_
     }
 }
 
+static bool isStickyMode(boxId_e modeId) {
+    return modeId == BOXPARALYZE;
+}
+
+static void addModeBoundary(modeAuxChannel_t *channel, uint16_t value) {
+    uint16_t *boundaries = &modeBoundaries[channel->firstBoundary];
+    int i = channel->boundaryCount;
+    while (i > 0 && boundaries[i - 1] >= value) {
+        if (boundaries[i - 1] == value) {
+            return;
+        }
+        i--;
+    }
+    memmove(&boundaries[i + 1], &boundaries[i], (channel->boundaryCount - i) * sizeof(boundaries[0]));
+    boundaries[i] = value;
+    channel->boundaryCount++;
+}
+
+static bool isConditionCompiled(const modeActivationCondition_t *mac) {
+    return !mac->linkedTo && IS_RANGE_USABLE(&mac->range);
+}
+
+// Builds the per channel boundary table, to be called whenever the conditions change
+void analyzeModeActivationConditions(void) {
+    modeAuxChannelCount = 0;
+    modeStickyConditionPresent = false;
+    uint8_t boundaryCount = 0;
+    for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+        const modeActivationCondition_t *mac = modeActivationConditions(i);
+        if (!isConditionCompiled(mac)) {
+            continue;
+        }
+        modeStickyConditionPresent |= isStickyMode(mac->modeId);
+        bool channelPresent = false;
+        for (int j = 0; j < modeAuxChannelCount; j++) {
+            channelPresent |= modeAuxChannels[j].auxChannelIndex == mac->auxChannelIndex;
+        }
+        if (channelPresent) {
+            continue;
+        }
+        // first condition on this channel, collect the boundaries of all of them
+        modeAuxChannel_t *channel = &modeAuxChannels[modeAuxChannelCount++];
+        channel->auxChannelIndex = mac->auxChannelIndex;
+        channel->firstBoundary = boundaryCount;
+        channel->boundaryCount = 0;
+        channel->position = 0;
+        for (int j = i; j < MAX_MODE_ACTIVATION_CONDITION_COUNT; j++) {
+            const modeActivationCondition_t *other = modeActivationConditions(j);
+            if (isConditionCompiled(other) && other->auxChannelIndex == mac->auxChannelIndex) {
+                addModeBoundary(channel, MODE_STEP_TO_CHANNEL_VALUE(other->range.startStep));
+                addModeBoundary(channel, MODE_STEP_TO_CHANNEL_VALUE(other->range.endStep));
+            }
+        }
+        boundaryCount += channel->boundaryCount;
+    }
+    modeEvaluationValid = false;
+}
+
+// True when an AUX channel crossed a boundary since the last evaluation, or the result can't be reused
+static bool modeActivationInputsChanged(void) {
+    bool changed = !modeEvaluationValid || memcmp(&modeEvaluatedMask, &rcModeActivationMask, sizeof(modeEvaluatedMask));
+    // a sticky mode waits for its switch to be seen off after the boot delay, that depends on time
+    if (modeStickyConditionPresent && !IS_RC_MODE_ACTIVE(BOXPARALYZE) && !bitArrayGet(&stickyModesEverDisabled, BOXPARALYZE)) {
+        changed = true;
+    }
+    for (int i = 0; i < modeAuxChannelCount; i++) {
+        modeAuxChannel_t *channel = &modeAuxChannels[i];
+        const uint16_t *boundaries = &modeBoundaries[channel->firstBoundary];
+        const uint16_t channelValue = auxChannelValue(channel->auxChannelIndex);
+        uint8_t position = 0;
+        while (position < channel->boundaryCount && channelValue >= boundaries[position]) {
+            position++;
+        }
+        if (position != channel->position) {
+            channel->position = position;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 void updateActivatedModes(void) {
+    if (!modeActivationInputsChanged()) {
+        return;
+    }
     boxBitmask_t newMask, andMask, stickyModes;
     memset(&andMask, 0, sizeof(andMask));
     memset(&newMask, 0, sizeof(newMask));
@@ -128,6 +228,8 @@ void updateActivatedModes(void) {
         bitArrayCopy(&newMask, mac->linkedTo, mac->modeId);
     }
     rcModeUpdate(&newMask);
+    modeEvaluatedMask = newMask;
+    modeEvaluationValid = true;
 }
 
 bool isModeActivationConditionPresent(boxId_e modeId) {
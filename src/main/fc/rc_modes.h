@@ -22,6 +22,8 @@
 
 #include <stdbool.h>
 
+#include "common/bitarray.h"
+
 #include "pg/pg.h"
 
 #define BOXID_NONE 255
@@ -123,12 +125,17 @@ typedef struct modeActivationProfile_s {
 
 #define IS_RANGE_USABLE(range) ((range)->startStep < (range)->endStep)
 
-bool IS_RC_MODE_ACTIVE(boxId_e boxId);
+extern boxBitmask_t rcModeActivationMask; // one bit per mode defined in boxId_e
+
+static inline bool IS_RC_MODE_ACTIVE(boxId_e boxId) {
+    return bitArrayGet(&rcModeActivationMask, boxId);
+}
 void rcModeUpdate(boxBitmask_t *newState);
 
 bool isAirmodeActive(void);
 
 bool isRangeActive(uint8_t auxChannelIndex, const channelRange_t *range);
+void analyzeModeActivationConditions(void);
 void updateActivatedModes(void);
 bool isModeActivationConditionPresent(boxId_e modeId);
 void removeModeActivationCondition(boxId_e modeId);
@@ -0,0 +1,131 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_WARM_BOOT
+
+#include "common/axis.h"
+#include "common/crc.h"
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "fc/fc_init.h"
+#include "fc/rc_controls.h"
+#include "fc/rc_modes.h"
+#include "fc/runtime_config.h"
+#include "fc/warm_boot.h"
+
+#include "flight/imu.h"
+
+#include "rx/rx.h"
+
+#include "sensors/barometer.h"
+#include "sensors/gyro.h"
+#include "sensors/sensors.h"
+
+/*
+ * What a board that resets in flight would otherwise spend seconds rebuilding: the gyro zero, the attitude and the
+ * baro ground reference. It is kept while armed in RAM the startup code does not clear, which holds its content
+ * through a soft or brownout reset, and is only taken back when its CRC shows it survived. The config is not kept,
+ * loading it from flash is already CRC checked and takes well under a millisecond.
+ */
+typedef struct warmBootState_s {
+    uint32_t magic;
+    float gyroZero[GYRO_ZERO_COUNT][XYZ_AXIS_COUNT];
+    quaternion attitude;
+    int32_t baroGroundPressure;
+    int32_t baroGroundAltitude;
+    bool baroCalibrated;
+    uint16_t crc;
+} warmBootState_t;
+
+// the size is in it so a layout change raises no false match
+#define WARM_BOOT_MAGIC     (0x57420000 | sizeof(warmBootState_t))
+
+static PERSISTENT warmBootState_t warmBootState;
+static bool rearmPending = false;
+
+static uint16_t warmBootCrc(const warmBootState_t *state) {
+    return crc16_ccitt_update(0, state, offsetof(warmBootState_t, crc));
+}
+
+// Called in place of starting the gyro and baro calibration. Returns false when there is nothing to restore.
+bool warmBootRestore(void) {
+    const warmBootState_t *state = &warmBootState;
+    if (!initWarmBoot || state->magic != WARM_BOOT_MAGIC || state->crc != warmBootCrc(state)) {
+        warmBootState.magic = 0;
+        return false;
+    }
+    gyroSetCalibratedZero(state->gyroZero);
+    imuRestoreAttitude(&state->attitude);
+#ifdef USE_BARO
+    if (state->baroCalibrated) {
+        baroSetGroundReference(state->baroGroundPressure, state->baroGroundAltitude);
+    } else {
+        baroSetCalibrationCycles(CALIBRATING_BARO_CYCLES);
+    }
+#endif
+    rearmPending = armingConfig()->warm_boot_rearm;
+    if (!rearmPending) {
+        warmBootState.magic = 0;
+    }
+    return true;
+}
+
+// True while a board restored by warmBootRestore() may arm with the switch and sticks where the flight left them
+bool warmBootRearmPending(void) {
+    if (rearmPending && (ARMING_FLAG(ARMED) || millis() > WARM_BOOT_REARM_WINDOW_MS
+            || (rxIsReceivingSignal() && !IS_RC_MODE_ACTIVE(BOXARM)))) {
+        rearmPending = false;
+    }
+    return rearmPending;
+}
+
+// Called at the attitude rate, keeps the state while armed and drops it otherwise
+void warmBootUpdate(void) {
+    warmBootState_t *state = &warmBootState;
+    if (!ARMING_FLAG(ARMED) || !isGyroCalibrationComplete()) {
+        if (!warmBootRearmPending()) {
+            state->magic = 0;
+        }
+        return;
+    }
+    state->magic = WARM_BOOT_MAGIC;
+    gyroGetCalibratedZero(state->gyroZero);
+    state->attitude = qAttitude;
+#ifdef USE_BARO
+    state->baroCalibrated = sensors(SENSOR_BARO) && isBaroCalibrationComplete();
+    baroGetGroundReference(&state->baroGroundPressure, &state->baroGroundAltitude);
+#else
+    state->baroCalibrated = false;
+    state->baroGroundPressure = 0;
+    state->baroGroundAltitude = 0;
+#endif
+    state->crc = warmBootCrc(state);
+}
+
+#endif // USE_WARM_BOOT
@@ -0,0 +1,34 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "fc/runtime_config.h"
+
+// a board that reset while armed may arm again before the pilot can lower the throttle or flip the switch
+#define WARM_BOOT_REARM_WINDOW_MS   5000
+#define WARM_BOOT_REARM_FLAGS       (ARMING_DISABLED_BOOT_GRACE_TIME | ARMING_DISABLED_BAD_RX_RECOVERY \
+                                    | ARMING_DISABLED_THROTTLE | ARMING_DISABLED_ANGLE | ARMING_DISABLED_ARM_SWITCH)
+
+bool warmBootRestore(void);
+void warmBootUpdate(void);
+bool warmBootRearmPending(void);
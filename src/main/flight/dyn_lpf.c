@@ -0,0 +1,92 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_DYN_LPF
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "fc/config.h"
+
+#include "flight/dyn_lpf.h"
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/rpm_filter.h"
+
+#include "sensors/gyro.h"
+
+static FAST_RAM_ZERO_INIT uint16_t dynLpfUpdateCountdown;
+
+// Linear in throttle (0..1) from minHz to maxHz
+uint16_t dynLpfCutoffHz(uint16_t minHz, uint16_t maxHz, float throttle) {
+    return minHz + lrintf((maxHz - minHz) * constrainf(throttle, 0.0f, 1.0f));
+}
+
+// Moves the gyro and dterm lowpass cutoffs with the throttle, or with the slowest motor when the rpm
+// filter runs: its noise is the lowest frequency the lowpass must still reach. Runs in the pid loop
+void dynLpfUpdate(void) {
+    if (dynLpfUpdateCountdown) {
+        dynLpfUpdateCountdown--;
+        return;
+    }
+    dynLpfUpdateCountdown = MAX(DYN_LPF_UPDATE_PERIOD_US / targetPidLooptime, 1) - 1;
+    const bool gyroActive = gyroDynLpfEnabled();
+    const bool dtermActive = pidDynLpfEnabled();
+    if (!gyroActive && !dtermActive) {
+        return;
+    }
+
+    const float throttle = mixerGetLoggingThrottle();
+    float motorHz = 0.0f;
+#ifdef USE_RPM_FILTER
+    const bool followRpm = gyroConfig()->dyn_lpf_source == DYN_LPF_SOURCE_RPM && isRpmFilterEnabled();
+    if (followRpm) {
+        motorHz = rpmMinMotorFrequency();
+    }
+#else
+    const bool followRpm = false;
+#endif
+    uint16_t gyroHz = 0;
+    if (gyroActive) {
+        const uint16_t minHz = gyroConfig()->dyn_lpf_gyro_min_hz;
+        const uint16_t maxHz = gyroConfig()->dyn_lpf_gyro_max_hz;
+        gyroHz = followRpm ? constrain(lrintf(motorHz), minHz, maxHz) : dynLpfCutoffHz(minHz, maxHz, throttle);
+        gyroDynLpfUpdate(gyroHz);
+    }
+    uint16_t dtermHz = 0;
+    if (dtermActive) {
+        const uint16_t minHz = currentPidProfile->dyn_lpf_dterm_min_hz;
+        const uint16_t maxHz = currentPidProfile->dyn_lpf_dterm_max_hz;
+        dtermHz = followRpm ? constrain(lrintf(motorHz), minHz, maxHz) : dynLpfCutoffHz(minHz, maxHz, throttle);
+        pidDynLpfUpdate(dtermHz);
+    }
+    DEBUG_SET(DEBUG_DYN_LPF, 0, gyroHz);
+    DEBUG_SET(DEBUG_DYN_LPF, 1, dtermHz);
+    DEBUG_SET(DEBUG_DYN_LPF, 2, lrintf(throttle * 1000.0f));
+    DEBUG_SET(DEBUG_DYN_LPF, 3, lrintf(motorHz));
+}
+#endif
@@ -53,6 +53,8 @@
 
 #define GPS_RESCUE_MAX_YAW_RATE       360  // deg/sec max yaw rate
 #define GPS_RESCUE_RATE_SCALE_DEGREES 45   // Scale the commanded yaw rate when the error is less then this angle
+#define GPS_RESCUE_CM_PER_LAT_UNIT    1.113195f // 1e-7 degree of latitude in cm
+#define GPS_RESCUE_MAX_EXTRAPOLATION_US 1000000 // Don't dead reckon further than this past the last fix
 
 PG_REGISTER_WITH_RESET_TEMPLATE(gpsRescueConfig_t, gpsRescueConfig, PG_GPS_RESCUE, 0);
 
@@ -86,6 +88,9 @@ uint32_t      throttleSamples = 0;
 
 static bool newGPSData = false;
 
+static void updateFixPosition(timeUs_t currentTimeUs);
+static void updateGuidancePosition(timeUs_t currentTimeUs);
+
 rescueState_s rescueState;
 
 /*
@@ -209,8 +214,7 @@ void sensorUpdate() {
     const uint32_t currentTimeUs = micros();
     const float dTime = currentTimeUs - previousTimeUs;
     if (newGPSData) { // Calculate velocity at lowest common denominator
-        rescueState.sensor.distanceToHome = GPS_distanceToHome;
-        rescueState.sensor.directionToHome = GPS_directionToHome;
+        updateFixPosition(currentTimeUs);
         rescueState.sensor.numSat = gpsSol.numSat;
         rescueState.sensor.groundSpeed = gpsSol.groundSpeed;
         rescueState.sensor.zVelocity = (rescueState.sensor.currentAltitude - previousAltitude) * 1000000.0f / dTime;
@@ -220,6 +224,45 @@ void sensorUpdate() {
         previousAltitude = rescueState.sensor.currentAltitude;
         previousTimeUs = currentTimeUs;
     }
+    updateGuidancePosition(currentTimeUs);
+}
+
+// Once per fix: local tangent plane offset from home and the velocity vector, the only trig done per fix
+static void updateFixPosition(timeUs_t currentTimeUs) {
+    if (STATE(GPS_FIX_HOME)) {
+        rescueState.sensor.fixPositionNE[0] = (gpsSol.llh.lat - GPS_home[LAT]) * GPS_RESCUE_CM_PER_LAT_UNIT;
+        rescueState.sensor.fixPositionNE[1] = (gpsSol.llh.lon - GPS_home[LON]) * GPS_scaleLonDown * GPS_RESCUE_CM_PER_LAT_UNIT;
+    } else {
+        rescueState.sensor.fixPositionNE[0] = 0;
+        rescueState.sensor.fixPositionNE[1] = 0;
+    }
+    const float course = DECIDEGREES_TO_RADIANS(gpsSol.groundCourse);
+    rescueState.sensor.velocityNE[0] = gpsSol.groundSpeed * cos_approx(course);
+    rescueState.sensor.velocityNE[1] = gpsSol.groundSpeed * sin_approx(course);
+    rescueState.sensor.lastFixUs = currentTimeUs;
+}
+
+// Every guidance step: dead reckon from the last fix so distance and bearing move smoothly between slow fixes
+static void updateGuidancePosition(timeUs_t currentTimeUs) {
+    if (!STATE(GPS_FIX_HOME)) {
+        rescueState.sensor.positionNE[0] = 0;
+        rescueState.sensor.positionNE[1] = 0;
+        rescueState.sensor.distanceToHome = 0;
+        rescueState.sensor.directionToHome = 0;
+        return;
+    }
+    const float dT = MIN(cmpTimeUs(currentTimeUs, rescueState.sensor.lastFixUs), GPS_RESCUE_MAX_EXTRAPOLATION_US) * 1e-6f;
+    for (int i = 0; i < 2; i++) {
+        rescueState.sensor.positionNE[i] = rescueState.sensor.fixPositionNE[i] + rescueState.sensor.velocityNE[i] * dT;
+    }
+    const float north = rescueState.sensor.positionNE[0];
+    const float east = rescueState.sensor.positionNE[1];
+    rescueState.sensor.distanceToHome = sqrtf(sq(north) + sq(east)) / 100;
+    int16_t direction = lrintf(RADIANS_TO_DEGREES(atan2_approx(-east, -north)));
+    if (direction < 0) {
+        direction += 360;
+    }
+    rescueState.sensor.directionToHome = direction;
 }
 
 void performSanityChecks() {
@@ -16,6 +16,7 @@
  */
 
 #include "common/axis.h"
+#include "common/time.h"
 
 #include "pg/pg.h"
 
@@ -80,6 +81,10 @@ typedef struct {
     float zVelocityAvg; // Up/down average in cm/s
     float accMagnitude;
     float accMagnitudeAvg;
+    float fixPositionNE[2]; // Flat earth offset from home at the last fix in cm
+    float velocityNE[2]; // Ground velocity at the last fix in cm/s
+    float positionNE[2]; // Offset from home extrapolated to the current guidance step in cm
+    timeUs_t lastFixUs;
 } rescueSensorData_s;
 
 typedef struct {
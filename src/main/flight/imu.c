@@ -72,6 +72,9 @@ static bool imuUpdated = false;
 
 #endif
 
+// below this half angle per update the gyro rotation uses the truncated sin/cos series
+#define IMU_SMALL_HALF_ANGLE 0.1f
+
 int32_t accSum[XYZ_AXIS_COUNT];
 float accAverage[XYZ_AXIS_COUNT];
 
@@ -97,14 +100,15 @@ quaternionProducts buffer = QUATERNION_PRODUCTS_INITIALIZE;
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 1);
 
 PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
                   .dcm_kp = 8500,
                   .dcm_ki = 0,
                   .small_angle = 180,
                   .accDeadband = {.xy = 40, .z = 40},
-                  .acc_unarmedcal = 1
+                  .acc_unarmedcal = 1,
+                  .attitude_rate_hz = DEFAULT_ATTITUDE_UPDATE_INTERVAL,
                  );
 
 
@@ -277,10 +281,22 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
     const float vGyroModulus = quaternionModulus(vGyro);
     // reduce gyro noise integration integrate only above vGyroStdDevModulus
     if (vGyroModulus > vGyroStdDevModulus) {
-        qDiff.w = cosf(vGyroModulus * 0.5f * dt);
-        qDiff.x = sinf(vGyroModulus * 0.5f * dt) * (vGyro->x / vGyroModulus);
-        qDiff.y = sinf(vGyroModulus * 0.5f * dt) * (vGyro->y / vGyroModulus);
-        qDiff.z = sinf(vGyroModulus * 0.5f * dt) * (vGyro->z / vGyroModulus);
+        const float halfAngle = vGyroModulus * 0.5f * dt;
+        float cosHalfAngle, sinHalfAngle;
+        if (halfAngle < IMU_SMALL_HALF_ANGLE) {
+            // the rotation per update is small at the attitude rate, the series terms left out are below float resolution
+            const float halfAngleSq = halfAngle * halfAngle;
+            cosHalfAngle = 1.0f - halfAngleSq * (0.5f - halfAngleSq * (1.0f / 24.0f));
+            sinHalfAngle = halfAngle * (1.0f - halfAngleSq * ((1.0f / 6.0f) - halfAngleSq * (1.0f / 120.0f)));
+        } else {
+            cosHalfAngle = cos_approx(halfAngle);
+            sinHalfAngle = sin_approx(halfAngle);
+        }
+        const float sinByModulus = sinHalfAngle / vGyroModulus;
+        qDiff.w = cosHalfAngle;
+        qDiff.x = sinByModulus * vGyro->x;
+        qDiff.y = sinByModulus * vGyro->y;
+        qDiff.z = sinByModulus * vGyro->z;
         quaternionMultiply(&qAttitude, &qDiff, &qAttitude);
     }
     // vKpKi integration
@@ -392,6 +408,17 @@ int16_t calculateThrottleAngleCorrection(uint8_t throttle_correction_value) {
     return lrintf(throttle_correction_value * sin_approx(angle / (900.0f * M_PIf / 2.0f)));
 }
 
+#ifdef USE_WARM_BOOT
+// takes an attitude kept from before a reset in place of levelling from the accelerometer again
+void imuRestoreAttitude(const quaternion *q) {
+    IMU_LOCK;
+    qAttitude = *q;
+    quaternionComputeProducts(&qAttitude, &qpAttitude);
+    imuUpdateEulerAngles();
+    IMU_UNLOCK;
+}
+#endif
+
 #ifdef SIMULATOR_BUILD
 void imuSetAttitudeRPY(float roll, float pitch, float yaw) {
     IMU_LOCK;
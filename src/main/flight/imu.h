@@ -62,6 +62,7 @@ typedef struct imuConfig_s {
     uint8_t small_angle;
     uint8_t acc_unarmedcal;                 // turn automatic acc compensation on/off
     accDeadband_t accDeadband;
+    uint16_t attitude_rate_hz;              // rate of the attitude task
 } imuConfig_t;
 
 PG_DECLARE(imuConfig_t, imuConfig);
@@ -89,6 +90,9 @@ int16_t calculateThrottleAngleCorrection(uint8_t throttle_correction_value);
 
 void imuResetAccelerationSum(void);
 void imuInit(void);
+#ifdef USE_WARM_BOOT
+void imuRestoreAttitude(const quaternion *q);
+#endif
 
 #ifdef SIMULATOR_BUILD
 void imuSetAttitudeRPY(float roll, float pitch, float yaw);  // in deg
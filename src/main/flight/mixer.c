@@ -68,7 +68,7 @@
 #include "sensors/battery.h"
 #include "sensors/gyro.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 1);
 
 #ifndef TARGET_DEFAULT_MIXER
 #define TARGET_DEFAULT_MIXER    MIXER_QUADX
@@ -78,9 +78,10 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
                   .yaw_motors_reversed = false,
                   .crashflip_motor_percent = 0,
                   .crashflip_power_percent = 70,
+                  .thrust_curve_points = 65,
                  );
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 5);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig) {
 #ifdef BRUSHED_MOTORS
@@ -120,6 +121,10 @@ PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, customMotorMixer, PG_MOTOR
 #define PWM_RANGE_MID 1500
 
 static FAST_RAM_ZERO_INIT uint8_t motorCount;
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+static FAST_RAM_ZERO_INIT uint16_t dshotOutputOffsetUs;
+static FAST_RAM_ZERO_INIT uint16_t dshotOutputLateCount;
+#endif
 static FAST_RAM_ZERO_INIT float controllerMixRange;
 
 float FAST_RAM_ZERO_INIT motor[MAX_SUPPORTED_MOTORS];
@@ -127,7 +132,16 @@ float FAST_RAM_ZERO_INIT motor[MAX_SUPPORTED_MOTORS];
 float motor_disarmed[MAX_SUPPORTED_MOTORS];
 
 mixerMode_e currentMixerMode;
-static motorMixer_t currentMixer[MAX_SUPPORTED_MOTORS];
+
+// the active mixer kept as one row per axis, so each mixer pass streams over contiguous floats
+typedef struct mixerRows_s {
+    float throttle[MAX_SUPPORTED_MOTORS];
+    float roll[MAX_SUPPORTED_MOTORS];
+    float pitch[MAX_SUPPORTED_MOTORS];
+    float yaw[MAX_SUPPORTED_MOTORS];
+} mixerRows_t;
+
+static FAST_RAM_ZERO_INIT mixerRows_t currentMixer;
 
 static FAST_RAM_ZERO_INIT int throttleAngleCorrection;
 
@@ -137,6 +151,27 @@ static FAST_RAM_ZERO_INIT float linearThrustHighOutput;
 static FAST_RAM_ZERO_INIT float linearThrustPIDScaler; // used to avoid/limit PID tuning when enabling thrust linearization
 static FAST_RAM_ZERO_INIT float linearThrustYawPIDScaler; // 2PASS mixer doesn't apply TL to yaw so it don't needs to compensate for that
 
+// thrustToMotor / motorToThrust from the idle level offset, sampled evenly over 0..1
+static FAST_RAM_ZERO_INIT uint8_t thrustCurvePoints;
+static FAST_RAM_ZERO_INIT float thrustCurveScale;
+static FAST_RAM_ZERO_INIT float thrustToMotorCurve[THRUST_CURVE_POINTS_MAX];
+static FAST_RAM_ZERO_INIT float motorToThrustCurve[THRUST_CURVE_POINTS_MAX];
+
+// controller (roll / pitch / yaw) part of the mix for every motor, ahead of the throttle mix
+typedef struct controllerMix_s {
+    float yawMix[MAX_SUPPORTED_MOTORS];
+    float rollPitchMix[MAX_SUPPORTED_MOTORS];
+    float controllerMix[MAX_SUPPORTED_MOTORS];
+    float yawMixMin, yawMixMax;
+    float rollPitchMixMin, rollPitchMixMax;
+    float controllerMixMin, controllerMixMax;
+} controllerMix_t;
+
+typedef void (*mixerControllerFn)(float scaledAxisPidRoll, float scaledAxisPidPitch, float scaledAxisPidYaw, controllerMix_t *mix);
+
+// unrolled copy for the stock quad / hex / octo mixers, the generic loop otherwise
+static FAST_RAM_ZERO_INIT mixerControllerFn mixerController;
+
 static FAST_RAM_ZERO_INIT mixerImplType_e mixerImpl;
 static FAST_RAM_ZERO_INIT bool mixerLaziness;
 
@@ -336,8 +371,18 @@ static FAST_RAM_ZERO_INIT float rcCommandThrottleRange;
 static void twoPassMix(float *motorMix, const float *yawMix, const float *rollPitchMix, float yawMixMin, float yawMixMax,
                        float rollPitchMixMin, float rollPitchMixMax);
 static void mixThingsUp(float scaledAxisPidRoll, float scaledAxisPidPitch, float scaledAxisPidYaw, float *motorMix);
+static void mixerSelectController(void);
 static float thrustToMotor(float thrust, bool fromIdleLevelOffset);
 static float motorToThrust(float motor, bool fromIdleLevelOffset);
+static float thrustToMotorCompute(float thrust, bool fromIdleLevelOffset);
+static float motorToThrustCompute(float motor, bool fromIdleLevelOffset);
+
+static void mixerSetMotorMix(int index, const motorMixer_t *motorMix) {
+    currentMixer.throttle[index] = motorMix->throttle;
+    currentMixer.roll[index] = motorMix->roll;
+    currentMixer.pitch[index] = motorMix->pitch;
+    currentMixer.yaw[index] = motorMix->yaw;
+}
 
 uint8_t getMotorCount(void) {
     return motorCount;
@@ -429,6 +474,9 @@ void initEscEndpoints(void) {
 void mixerInit(mixerMode_e mixerMode) {
     currentMixerMode = mixerMode;
     initEscEndpoints();
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    dshotOutputOffsetUs = motorConfig()->dshotOutputOffsetUs;
+#endif
     if (mixerIsTricopter()) {
         mixerTricopterInit();
     }
@@ -446,7 +494,7 @@ void mixerConfigureOutput(void) {
             if (customMotorMixer(i)->throttle == 0.0f) {
                 break;
             }
-            currentMixer[i] = *customMotorMixer(i);
+            mixerSetMotorMix(i, customMotorMixer(i));
             motorCount++;
         }
     } else {
@@ -457,9 +505,10 @@ void mixerConfigureOutput(void) {
         // copy motor-based mixers
         if (mixers[currentMixerMode].motor) {
             for (int i = 0; i < motorCount; i++)
-                currentMixer[i] = mixers[currentMixerMode].motor[i];
+                mixerSetMotorMix(i, &mixers[currentMixerMode].motor[i]);
         }
     }
+    mixerSelectController();
     mixerResetDisarmedMotors();
 }
 
@@ -481,8 +530,9 @@ void mixerLoadMix(int index, motorMixer_t *customMixers) {
 void mixerConfigureOutput(void) {
     motorCount = QUAD_MOTOR_COUNT;
     for (int i = 0; i < motorCount; i++) {
-        currentMixer[i] = mixerQuadX[i];
+        mixerSetMotorMix(i, &mixerQuadX[i]);
     }
+    mixerSelectController();
     mixerResetDisarmedMotors();
 }
 #endif // USE_QUAD_MIXER_ONLY
@@ -494,11 +544,47 @@ void mixerResetDisarmedMotors(void) {
     }
 }
 
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+/*
+ * Hold the DShot frames back until dshot_output_offset after the data ready interrupt of the gyro sample the
+ * loop used, so the sample to motor latency no longer moves with the pid and mixer run time. There is no spare
+ * timer to trigger the DMA from, the wait spins on the microsecond clock and is never longer than the offset.
+ * Frames that are already late go out at once and are counted.
+ */
+static FAST_CODE_NOINLINE void dshotAlignOutput(void) {
+    const timeUs_t sampleTimeUs = gyroSampleTimeUs();
+    if (!sampleTimeUs || !isMotorProtocolDshot()) {
+        return;
+    }
+    const timeUs_t outputAtUs = sampleTimeUs + dshotOutputOffsetUs;
+    const timeDelta_t waitUs = cmpTimeUs(outputAtUs, micros());
+    if (waitUs <= 0) {
+        dshotOutputLateCount++;
+    } else if (waitUs <= dshotOutputOffsetUs) {
+        while (cmpTimeUs(outputAtUs, micros()) > 0) {
+        }
+    }
+    DEBUG_SET(DEBUG_DSHOT_OUTPUT_ALIGN, 0, cmpTimeUs(micros(), sampleTimeUs));
+    DEBUG_SET(DEBUG_DSHOT_OUTPUT_ALIGN, 1, MAX(waitUs, 0));
+    DEBUG_SET(DEBUG_DSHOT_OUTPUT_ALIGN, 2, dshotOutputLateCount);
+}
+#endif
+
 void writeMotors(void) {
     if (pwmAreMotorsEnabled()) {
+#ifdef USE_DSHOT_TELEMETRY
+        if (!pwmStartDshotMotorUpdate(motorCount)) {
+            return;
+        }
+#endif
         for (int i = 0; i < motorCount; i++) {
             pwmWriteMotor(i, motor[i]);
         }
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+        if (dshotOutputOffsetUs) {
+            dshotAlignOutput();
+        }
+#endif
         pwmCompleteMotorUpdate(motorCount);
     }
 }
@@ -647,6 +733,18 @@ void mixerInitProfile(void) {
     linearThrustYawPIDScaler = mixerImpl == MIXER_IMPL_2PASS ? 1.0f : linearThrustPIDScaler;
     motorOutputIdleLevel = ABS((motorOutputLow - disarmMotorOutput) / (motorOutputHigh - disarmMotorOutput));
     motorThrustIdleLevel = motorToThrust(motorOutputIdleLevel, false);
+    // the curves only change with the profile and the esc endpoints, sample them here instead of per motor and loop
+    thrustCurvePoints = 0;
+    if (linearThrustEnabled && mixerConfig()->thrust_curve_points >= 2) {
+        const int points = MIN(mixerConfig()->thrust_curve_points, THRUST_CURVE_POINTS_MAX);
+        for (int i = 0; i < points; i++) {
+            const float x = (float)i / (points - 1);
+            thrustToMotorCurve[i] = thrustToMotorCompute(x, true);
+            motorToThrustCurve[i] = motorToThrustCompute(x, true);
+        }
+        thrustCurveScale = points - 1;
+        thrustCurvePoints = points;
+    }
 }
 
 #define CRASH_FLIP_DEADBAND 20
@@ -688,9 +786,9 @@ static void applyFlipOverAfterCrashModeToMotors(void) {
         float flipPower = MAX(0.0f, stickDeflectionMax - CRASH_FLIP_STICK_MINF) / flipStickRange;
         for (int i = 0; i < motorCount; ++i) {
             float motorOutput =
-                signPitch * currentMixer[i].pitch +
-                signRoll * currentMixer[i].roll +
-                signYaw * currentMixer[i].yaw;
+                signPitch * currentMixer.pitch[i] +
+                signRoll * currentMixer.roll[i] +
+                signYaw * currentMixer.yaw[i];
             if (motorOutput < 0) {
                 if (mixerConfig()->crashflip_motor_percent > 0) {
                     motorOutput = -motorOutput * (float)mixerConfig()->crashflip_motor_percent / 100.0f;
@@ -713,34 +811,38 @@ static void applyFlipOverAfterCrashModeToMotors(void) {
 }
 
 static void applyMixToMotors(const float motorMix[MAX_SUPPORTED_MOTORS]) {
-    float vbatCompFactor = calculateBatteryCompensationFactor();
-    for (int i = 0; i < motorCount; i++) {
-        float motorOutput = motorOutputMin + constrainf(motorMix[i] * vbatCompFactor, 0.0f, 1.0f) * motorOutputRange;
-        if (mixerIsTricopter()) {
-            motorOutput += mixerTricopterMotorCorrection(i);
-        }
-        if (failsafeIsActive()) {
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < motorRangeMin) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-            motorOutput = constrainf(motorOutput, disarmMotorOutput, motorRangeMax);
-        } else {
-            motorOutput = constrainf(motorOutput, motorRangeMin, motorRangeMax);
-        }
-        // Motor stop handling
-        if (feature(FEATURE_MOTOR_STOP) && ARMING_FLAG(ARMED) && !feature(FEATURE_3D) && !isAirmodeActive()
-                && !FLIGHT_MODE(GPS_RESCUE_MODE)) {   // disable motor_stop while GPS Rescue is active
-            if (((rcData[THROTTLE]) < rxConfig()->mincheck)) {
-                motorOutput = disarmMotorOutput;
-            }
-        }
-        motor[i] = motorOutput;
-    }
     // Disarmed mode
     if (!ARMING_FLAG(ARMED)) {
         for (int i = 0; i < motorCount; i++) {
             motor[i] = motor_disarmed[i];
         }
+        return;
+    }
+    // Motor stop handling
+    if (feature(FEATURE_MOTOR_STOP) && !feature(FEATURE_3D) && !isAirmodeActive()
+            && !FLIGHT_MODE(GPS_RESCUE_MODE)   // disable motor_stop while GPS Rescue is active
+            && rcData[THROTTLE] < rxConfig()->mincheck) {
+        for (int i = 0; i < motorCount; i++) {
+            motor[i] = disarmMotorOutput;
+        }
+        return;
+    }
+    // everything that does not depend on the motor is resolved once, the loop below is pure arithmetic
+    batteryUpdateSagCompensation();
+    const float vbatCompFactor = getBatteryCompensationFactor();
+    const bool tricopter = mixerIsTricopter();
+    const bool failsafeActive = failsafeIsActive();
+    const bool failsafeDshot = failsafeActive && isMotorProtocolDshot();  // Prevent getting into special reserved range
+    const float outputLimitLow = failsafeActive ? disarmMotorOutput : motorRangeMin;
+    for (int i = 0; i < motorCount; i++) {
+        float motorOutput = motorOutputMin + constrainf(motorMix[i] * vbatCompFactor, 0.0f, 1.0f) * motorOutputRange;
+        if (tricopter) {
+            motorOutput += mixerTricopterMotorCorrection(i);
+        }
+        if (failsafeDshot && motorOutput < motorRangeMin) {
+            motorOutput = disarmMotorOutput;
+        }
+        motor[i] = constrainf(motorOutput, outputLimitLow, motorRangeMax);
     }
 }
 
@@ -794,7 +896,7 @@ void mixWithThrottleLegacy(float *motorMix, float *controllerMix, float controll
                                          : SCALE_UNITARY_RANGE(throttleThrust, -controllerMixMin, -controllerMixMax);
             controllerMix[i] = (controllerMix[i] + offset) * normFactor;
         }
-        float thrustMix = controllerMix[i] + throttleThrust * currentMixer[i].throttle;
+        float thrustMix = controllerMix[i] + throttleThrust * currentMixer.throttle[i];
         motorMix[i] = thrustToMotor(thrustMix, true);
     }
 }
@@ -856,46 +958,95 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs) {
     applyMixToMotors(motorMix);
 }
 
-void mixThingsUp(const float scaledAxisPidRoll, const float scaledAxisPidPitch, const float scaledAxisPidYaw, float *motorMix) {
-    float yawMix[MAX_SUPPORTED_MOTORS];
-    float rollPitchMix[MAX_SUPPORTED_MOTORS];
-    float controllerMix[MAX_SUPPORTED_MOTORS];
-    float yawMixMin = 0, yawMixMax = 0;
-    float rollPitchMixMin = 0, rollPitchMixMax = 0;
-    float controllerMixMin = 0, controllerMixMax = 0;
-
+// one motor of the controller mix, min / max are kept branch free
+#define MIXER_CONTROLLER_STEP(mix, i, yawCoeff, rollCoeff, pitchCoeff, sign) do { \
+    const float yawMixVal = scaledAxisPidYaw * (yawCoeff); \
+    const float rollPitchMixVal = scaledAxisPidRoll * (rollCoeff) + scaledAxisPidPitch * (pitchCoeff); \
+    const float controllerMixVal = rollPitchMixVal + yawMixVal; \
+    (mix)->yawMixMin = MIN((mix)->yawMixMin, yawMixVal); \
+    (mix)->yawMixMax = MAX((mix)->yawMixMax, yawMixVal); \
+    (mix)->rollPitchMixMin = MIN((mix)->rollPitchMixMin, rollPitchMixVal); \
+    (mix)->rollPitchMixMax = MAX((mix)->rollPitchMixMax, rollPitchMixVal); \
+    (mix)->controllerMixMin = MIN((mix)->controllerMixMin, controllerMixVal); \
+    (mix)->controllerMixMax = MAX((mix)->controllerMixMax, controllerMixVal); \
+    (mix)->yawMix[i] = yawMixVal * (sign); \
+    (mix)->rollPitchMix[i] = rollPitchMixVal * (sign); \
+    (mix)->controllerMix[i] = controllerMixVal * (sign); \
+} while (0)
+
+static void mixControllerGeneric(const float scaledAxisPidRoll, const float scaledAxisPidPitch, const float scaledAxisPidYaw, controllerMix_t *mix) {
+    const float mix3DModeSign = controllerMix3DModeSign;
     for (int i = 0; i < motorCount; i++) {
-        float yawMixVal = scaledAxisPidYaw * currentMixer[i].yaw;
-        if (yawMixVal > yawMixMax) {
-            yawMixMax = yawMixVal;
-        } else if (yawMixVal < yawMixMin) {
-            yawMixMin = yawMixVal;
-        }
-        yawMix[i] = yawMixVal * controllerMix3DModeSign;
+        MIXER_CONTROLLER_STEP(mix, i, currentMixer.yaw[i], currentMixer.roll[i], currentMixer.pitch[i], mix3DModeSign);
+    }
+}
 
-        float rollPitchMixVal = scaledAxisPidRoll * currentMixer[i].roll + scaledAxisPidPitch * currentMixer[i].pitch;
-        if (rollPitchMixVal > rollPitchMixMax) {
-            rollPitchMixMax = rollPitchMixVal;
-        } else if (rollPitchMixVal < rollPitchMixMin) {
-            rollPitchMixMin = rollPitchMixVal;
-        }
-        rollPitchMix[i] = rollPitchMixVal * controllerMix3DModeSign;
+// Stock mixers get their own unrolled copy of the controller mix, with the coefficients
+// folded in from the const tables so the common case runs without a loop or table loads.
+#define MIXER_TABLE_STEP(table, i) \
+    MIXER_CONTROLLER_STEP(mix, i, table[i].yaw, table[i].roll, table[i].pitch, mix3DModeSign)
+#define MIXER_UNROLL_4(table) \
+    MIXER_TABLE_STEP(table, 0); MIXER_TABLE_STEP(table, 1); MIXER_TABLE_STEP(table, 2); MIXER_TABLE_STEP(table, 3)
+#define MIXER_UNROLL_6(table) \
+    MIXER_UNROLL_4(table); MIXER_TABLE_STEP(table, 4); MIXER_TABLE_STEP(table, 5)
+#define MIXER_UNROLL_8(table) \
+    MIXER_UNROLL_6(table); MIXER_TABLE_STEP(table, 6); MIXER_TABLE_STEP(table, 7)
+
+#define MIXER_SPECIALISED_CONTROLLER(table, count) \
+static void mixController_ ## table(const float scaledAxisPidRoll, const float scaledAxisPidPitch, const float scaledAxisPidYaw, controllerMix_t *mix) { \
+    STATIC_ASSERT(ARRAYLEN(table) == count, table ## _motor_count); \
+    const float mix3DModeSign = controllerMix3DModeSign; \
+    MIXER_UNROLL_ ## count(table); \
+}
 
-        float controllerMixVal = (rollPitchMixVal + yawMixVal);
-        if (controllerMixVal > controllerMixMax) {
-            controllerMixMax = controllerMixVal;
-        } else if (controllerMixVal < controllerMixMin) {
-            controllerMixMin = controllerMixVal;
-        }
-        controllerMix[i] = controllerMixVal * controllerMix3DModeSign;
+MIXER_SPECIALISED_CONTROLLER(mixerQuadX, 4)
+#ifndef USE_QUAD_MIXER_ONLY
+MIXER_SPECIALISED_CONTROLLER(mixerQuadX1234, 4)
+#if (MAX_SUPPORTED_MOTORS >= 6)
+MIXER_SPECIALISED_CONTROLLER(mixerHex6X, 6)
+#endif
+#if defined(USE_UNCOMMON_MIXERS) && (MAX_SUPPORTED_MOTORS >= 8)
+MIXER_SPECIALISED_CONTROLLER(mixerOctoX8, 8)
+#endif
+#endif // USE_QUAD_MIXER_ONLY
+
+static void mixerSelectController(void) {
+    mixerController = mixControllerGeneric;
+    switch (currentMixerMode) {
+    case MIXER_QUADX:
+        mixerController = mixController_mixerQuadX;
+        break;
+#ifndef USE_QUAD_MIXER_ONLY
+    case MIXER_QUADX_1234:
+        mixerController = mixController_mixerQuadX1234;
+        break;
+#if (MAX_SUPPORTED_MOTORS >= 6)
+    case MIXER_HEX6X:
+        mixerController = mixController_mixerHex6X;
+        break;
+#endif
+#if defined(USE_UNCOMMON_MIXERS) && (MAX_SUPPORTED_MOTORS >= 8)
+    case MIXER_OCTOX8:
+        mixerController = mixController_mixerOctoX8;
+        break;
+#endif
+#endif // USE_QUAD_MIXER_ONLY
+    default:
+        break;
     }
+}
+
+void mixThingsUp(const float scaledAxisPidRoll, const float scaledAxisPidPitch, const float scaledAxisPidYaw, float *motorMix) {
+    controllerMix_t mix = { .yawMixMin = 0 };
 
-    controllerMixRange = controllerMixMax - controllerMixMin; // measures how much the controller is trying to compensate
+    mixerController(scaledAxisPidRoll, scaledAxisPidPitch, scaledAxisPidYaw, &mix);
+
+    controllerMixRange = mix.controllerMixMax - mix.controllerMixMin; // measures how much the controller is trying to compensate
 
     if (mixerImpl == MIXER_IMPL_2PASS) {
-        twoPassMix(motorMix, yawMix, rollPitchMix, yawMixMin, yawMixMax, rollPitchMixMin, rollPitchMixMax);
+        twoPassMix(motorMix, mix.yawMix, mix.rollPitchMix, mix.yawMixMin, mix.yawMixMax, mix.rollPitchMixMin, mix.rollPitchMixMax);
     } else {
-        mixWithThrottleLegacy(motorMix, controllerMix, controllerMixMin, controllerMixMax);
+        mixWithThrottleLegacy(motorMix, mix.controllerMix, mix.controllerMixMin, mix.controllerMixMax);
     }
 }
 
@@ -960,7 +1111,7 @@ float mixerGetLoggingThrottle(void) {
     return loggingThrottle;
 }
 
-float thrustToMotor(float thrust, bool fromIdleLevelOffset) {
+static float thrustToMotorCompute(float thrust, bool fromIdleLevelOffset) {
     if (!linearThrustEnabled) {
         return thrust;
     }
@@ -969,7 +1120,7 @@ float thrustToMotor(float thrust, bool fromIdleLevelOffset) {
 
     if (fromIdleLevelOffset) {
         // simply applying some shifts to the graph, for more info see https://www.desmos.com/calculator/lgtopxo5mt
-        float x = thrustToMotor(thrust * (1.0f - motorThrustIdleLevel) + motorThrustIdleLevel , false);
+        float x = thrustToMotorCompute(thrust * (1.0f - motorThrustIdleLevel) + motorThrustIdleLevel , false);
         return (x - motorOutputIdleLevel) / (1.0f - motorOutputIdleLevel);
     }
 
@@ -977,7 +1128,7 @@ float thrustToMotor(float thrust, bool fromIdleLevelOffset) {
     return (compLevel - 1 + fast_fsqrtf(sq(1.0f - compLevel) + 4.0f * compLevel * thrust)) / (2.0f * compLevel);
 }
 
-float motorToThrust(float motor, bool fromIdleLevelOffset) {
+static float motorToThrustCompute(float motor, bool fromIdleLevelOffset) {
     if (!linearThrustEnabled) {
         return motor;
     }
@@ -986,7 +1137,7 @@ float motorToThrust(float motor, bool fromIdleLevelOffset) {
 
     if (fromIdleLevelOffset) {
         // simply applying some shifts to the graph, for more info see https://www.desmos.com/calculator/lgtopxo5mt
-        float x = motorToThrust(motor * (1.0f - motorOutputIdleLevel) + motorOutputIdleLevel , false);
+        float x = motorToThrustCompute(motor * (1.0f - motorOutputIdleLevel) + motorOutputIdleLevel , false);
         return (x - motorThrustIdleLevel) / (1.0f - motorThrustIdleLevel);
     }
 
@@ -994,6 +1145,26 @@ float motorToThrust(float motor, bool fromIdleLevelOffset) {
     return (1.0f - compLevel) * motor + compLevel * sq(motor);
 }
 
+static float thrustCurveLookup(const float *curve, float x) {
+    const float position = constrainf(x, 0.0f, 1.0f) * thrustCurveScale;
+    const int index = MIN((int)position, thrustCurvePoints - 2);
+    return curve[index] + (curve[index + 1] - curve[index]) * (position - index);
+}
+
+float thrustToMotor(float thrust, bool fromIdleLevelOffset) {
+    if (fromIdleLevelOffset && thrustCurvePoints) {
+        return thrustCurveLookup(thrustToMotorCurve, thrust);
+    }
+    return thrustToMotorCompute(thrust, fromIdleLevelOffset);
+}
+
+float motorToThrust(float motor, bool fromIdleLevelOffset) {
+    if (fromIdleLevelOffset && thrustCurvePoints) {
+        return thrustCurveLookup(motorToThrustCurve, motor);
+    }
+    return motorToThrustCompute(motor, fromIdleLevelOffset);
+}
+
 static void twoPassMix(float *motorMix, const float *yawMix, const float *rollPitchMix, float yawMixMin, float yawMixMax,
                 float rollPitchMixMin, float rollPitchMixMax) {
 
@@ -1033,14 +1204,12 @@ static void twoPassMix(float *motorMix, const float *yawMix, const float *rollPi
     float maxMotor = -1000.0;
     float minMotor = 1000.0;
 
+    // prefer calculating all of the above and maybe not use it, than multiple if/then statements to save from calculating.
+    const float motorYawCorrection = currentPidProfile->mixer_yaw_throttle_comp ? yawThrottleCorrection : 0.0f;
+
     // correct for the extra thrust yaw adds, then fill up motorMix with pitch and roll
     for (int i = 0; i < motorCount; i++) {
-        if (currentPidProfile->mixer_yaw_throttle_comp) {  //!==0
-            // prefer calculating all of the above and maybe not use it, than multiple if/then statements to save from calculating.
-            motorMix[i] = motorMix[i] - yawThrottleCorrection;
-        };
-
-        motorMix[i] = motorToThrust(motorMix[i], true); // convert into thrust value
+        motorMix[i] = motorToThrust(motorMix[i] - motorYawCorrection, true); // convert into thrust value
         // clipping handling
         float rollPitchOffset = mixerLaziness ? (ABS(rollPitchMix[i]) * SCALE_UNITARY_RANGE(thrustPostYaw , 1, -1))
                                               : SCALE_UNITARY_RANGE(thrustPostYaw , -rollPitchMixMin, -rollPitchMixMax);
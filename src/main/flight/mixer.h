@@ -86,11 +86,14 @@ typedef struct mixer_s {
     const motorMixer_t *motor;
 } mixer_t;
 
+#define THRUST_CURVE_POINTS_MAX 129
+
 typedef struct mixerConfig_s {
     uint8_t mixerMode;
     bool yaw_motors_reversed;
     uint8_t crashflip_motor_percent;
     uint8_t crashflip_power_percent;
+    uint8_t thrust_curve_points;            // points of the thrust linearization lookup tables, below 2 the curve is computed for every motor
 } mixerConfig_t;
 
 PG_DECLARE(mixerConfig_t, mixerConfig);
@@ -102,6 +105,7 @@ typedef struct motorConfig_s {
     uint16_t maxthrottle;                   // This is the maximum value for the ESCs at full power this value can be increased up to 2000
     uint16_t mincommand;                    // This is the value for the ESCs when they are not armed. In some cases, this value must be lowered down to 900 for some specific ESCs
     uint8_t motorPoleCount;                // Magnetic poles in the motors for calculating actual RPM from eRPM provided by ESC telemetry
+    uint16_t dshotOutputOffsetUs;           // Start the DShot frames this long after the gyro sample they were computed from, 0 sends them as soon as the mixer is done
 } motorConfig_t;
 
 PG_DECLARE(motorConfig_t, motorConfig);
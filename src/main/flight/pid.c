@@ -25,6 +25,7 @@
 
 #include "platform.h"
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 #include "build/debug.h"
 
@@ -39,6 +40,7 @@
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
+#include "drivers/nvic.h"
 #include "drivers/sound_beeper.h"
 #include "drivers/time.h"
 
@@ -54,6 +56,7 @@
 #include "flight/imu.h"
 #include "flight/gps_rescue.h"
 #include "flight/mixer.h"
+#include "flight/rpm_filter.h"
 
 #include "io/gps.h"
 
@@ -82,10 +85,18 @@ static FAST_RAM_ZERO_INIT bool inCrashRecoveryMode = false;
 
 static FAST_RAM_ZERO_INIT float dT;
 static FAST_RAM_ZERO_INIT float pidFrequency;
+// an axis with a process denom above 1 is processed every n pid loops and holds its pidData in between
+static FAST_RAM_ZERO_INIT uint8_t axisProcessDenom[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT uint8_t axisSkipCount[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float axisDT[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float axisFrequency[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT uint8_t levelProcessDenom;
+static FAST_RAM_ZERO_INIT uint8_t levelSkipCount[2];
+static FAST_RAM_ZERO_INIT float levelDT;
 extern struct pidProfile_s *currentPidProfile;
 extern bool linearThrustEnabled;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 5);
 
 #if defined(STM32F3) || defined(STM32F411xE)
 #define PID_PROCESS_DENOM_DEFAULT 2
@@ -108,16 +119,20 @@ PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
 #ifdef USE_RUNAWAY_TAKEOFF
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
                   .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+                  .pid_yaw_process_denom = 1,
+                  .pid_level_process_denom = 1,
                   .runaway_takeoff_prevention = true,
                   .runaway_takeoff_deactivate_throttle = 20, // throttle level % needed to accumulate deactivation time
                   .runaway_takeoff_deactivate_delay = 500    // Accumulated time (in milliseconds) before deactivation in successful takeoff
                  );
 #else
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
-                  .pid_process_denom = PID_PROCESS_DENOM_DEFAULT);
+                  .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+                  .pid_yaw_process_denom = 1,
+                  .pid_level_process_denom = 1);
 #endif
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 8);
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 10);
 
 void resetPidProfile(pidProfile_t *pidProfile) {
     RESET_CONFIG(pidProfile_t, pidProfile,
@@ -171,6 +186,7 @@ void resetPidProfile(pidProfile_t *pidProfile) {
     .crash_setpoint_threshold = 350,          // degrees/second
     .crash_recovery = PID_CRASH_RECOVERY_OFF, // off by default
     .crash_limit_yaw = 200,
+    .crash_rpm_loss = 0,
     .itermLimit = 400,
     .throttle_boost = 5,
     .throttle_boost_cutoff = 15,
@@ -216,6 +232,15 @@ static void pidSetTargetLooptime(uint32_t pidLooptime) {
     targetPidLooptime = pidLooptime;
     dT = targetPidLooptime * 1e-6f;
     pidFrequency = 1.0f / dT;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        axisProcessDenom[axis] = (axis == FD_YAW) ? constrain(pidConfig()->pid_yaw_process_denom, 1, MAX_PID_YAW_PROCESS_DENOM) : 1;
+        axisSkipCount[axis] = 0;
+        axisDT[axis] = dT * axisProcessDenom[axis];
+        axisFrequency[axis] = 1.0f / axisDT[axis];
+    }
+    levelProcessDenom = constrain(pidConfig()->pid_level_process_denom, 1, MAX_PID_LEVEL_PROCESS_DENOM);
+    levelSkipCount[FD_ROLL] = levelSkipCount[FD_PITCH] = 0;
+    levelDT = dT * levelProcessDenom;
 }
 
 void pidStabilisationState(pidStabilisationState_e pidControllerState) {
@@ -234,14 +259,30 @@ typedef union dtermLowpass_u {
 static FAST_RAM_ZERO_INIT float previousPidSetpoint[XYZ_AXIS_COUNT];
 static FAST_RAM filterApplyFnPtr dtermLowpassApplyFn = nullFilterApply;
 static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
+#ifdef USE_DYN_LPF
+static FAST_RAM_ZERO_INIT uint8_t dtermDynLpfType;  // type of the first lowpass when it follows the schedule, 0 (pt1) otherwise
+static FAST_RAM_ZERO_INIT bool dtermDynLpfActive;
+#endif
 static FAST_RAM filterApplyFnPtr dtermLowpass2ApplyFn = nullFilterApply;
 static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass2[XYZ_AXIS_COUNT];
+#ifdef USE_FILTER_RETUNE
+// second set of lowpass coefficients made by pidRetuneFilters(), only the b/a or k members are used
+typedef struct pidFilterCoeffs_s {
+    dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
+    dtermLowpass_t dtermLowpass2[XYZ_AXIS_COUNT];
+} pidFilterCoeffs_t;
+
+static FAST_RAM_ZERO_INIT pidFilterCoeffs_t pidRetuneCoeffs;
+static volatile FAST_RAM_ZERO_INIT bool pidFilterCoeffsPending;
+static pidProfile_t pidFiltersProfile;  // the profile the lowpass filters were set up or last retuned with
+#endif
 static FAST_RAM filterApplyFnPtr angleSetpointFilterApplyFn = nullFilterApply;
 static FAST_RAM_ZERO_INIT pt1Filter_t angleSetpointFilter[2];
 static FAST_RAM filterApplyFnPtr dtermABGapplyFn = nullFilterApply;
 static FAST_RAM_ZERO_INIT alphaBetaGammaFilter_t dtermABG[XYZ_AXIS_COUNT];
 #ifdef USE_GYRO_DATA_ANALYSE
-static FAST_RAM_ZERO_INIT biquadFilter_t dtermNotch[XYZ_AXIS_COUNT][5];
+static FAST_RAM_ZERO_INIT biquadFilter_t dtermNotch[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
+static FAST_RAM_ZERO_INIT uint8_t dtermNotchUpdateCount[XYZ_AXIS_COUNT];
 #endif
 
 #if defined(USE_ITERM_RELAX)
@@ -255,91 +296,115 @@ static FAST_RAM_ZERO_INIT pt1Filter_t axisLockLpf[XYZ_AXIS_COUNT];
 
 static FAST_RAM_ZERO_INIT float iDecay;
 
-void pidInitFilters(const pidProfile_t *pidProfile) {
-    BUILD_BUG_ON(FD_YAW != 2);                             // ensure yaw axis is 2
-    const uint32_t pidFrequencyNyquist = pidFrequency / 2; // No rounding needed
-    dtermLowpassApplyFn = nullFilterApply;
-    dtermLowpass2ApplyFn = nullFilterApply;
-    angleSetpointFilterApplyFn = nullFilterApply;
+#ifdef USE_DYN_LPF
+// like the gyro, the pt1 and ptn take a new cutoff without a step, the biquad and lulu keep the static one
+static bool pidDynLpfConfigured(const pidProfile_t *pidProfile) {
+    return pidProfile->dyn_lpf_dterm_min_hz && pidProfile->dyn_lpf_dterm_max_hz > pidProfile->dyn_lpf_dterm_min_hz
+           && pidProfile->dyn_lpf_dterm_min_hz <= pidFrequency / 2
+           && pidProfile->dterm_filter_type != FILTER_BIQUAD
+#ifdef USE_LULU
+           && pidProfile->dterm_filter_type != FILTER_LULU
+#endif
+           ;
+}
+#endif
 
+// Cutoffs of the first or second lowpass, while the dynamic lowpass is on the first one starts at its minimum
+static void pidDtermLowpassCutoffs(const pidProfile_t *pidProfile, int slot, uint16_t *cutoffHz) {
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        if (pidProfile->dFilter[axis].dLpf && pidProfile->dFilter[axis].dLpf <= pidFrequencyNyquist) {
-            switch (pidProfile->dterm_filter_type) {
-            case FILTER_BIQUAD:
-                dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
-                biquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, pidProfile->dFilter[axis].dLpf, targetPidLooptime);
-                break;
-            case FILTER_PT4:
-                dtermLowpassApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass[axis].ptnFilter, FILTER_PT4, pidProfile->dFilter[axis].dLpf, dT);
-                break;
-            case FILTER_PT3:
-                dtermLowpassApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass[axis].ptnFilter, FILTER_PT3, pidProfile->dFilter[axis].dLpf, dT);
-                break;
-            case FILTER_PT2:
-                dtermLowpassApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass[axis].ptnFilter, FILTER_PT2, pidProfile->dFilter[axis].dLpf, dT);
-                break;
-            case FILTER_LULU:
-                dtermLowpassApplyFn = (filterApplyFnPtr)luluFilterApply;
-                luluFilterInit(&dtermLowpass[axis].luluFilter, pidProfile->lulu_n_val);
-                break;
-            default: // case FILTER_PT1:
-                dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-                pt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf, dT));
-                break;
-            }
+        cutoffHz[axis] = slot == FILTER_LOWPASS ? pidProfile->dFilter[axis].dLpf : pidProfile->dFilter[axis].dLpf2;
+#ifdef USE_DYN_LPF
+        if (slot == FILTER_LOWPASS && pidDynLpfConfigured(pidProfile)) {
+            cutoffHz[axis] = pidProfile->dyn_lpf_dterm_min_hz;
         }
+#endif
+    }
+}
 
-        if (pidProfile->dFilter[axis].dLpf2 && pidProfile->dFilter[axis].dLpf2 <= pidFrequencyNyquist) {
-            switch (pidProfile->dterm_filter2_type) {
+// Sets up the lowpass of the axes with a cutoff below nyquist and returns how to apply it
+static filterApplyFnPtr pidInitDtermLowpass(dtermLowpass_t *lowpass, uint8_t type, const uint16_t *cutoffHz, uint8_t luluN) {
+    filterApplyFnPtr applyFn = nullFilterApply;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        const uint32_t axisFrequencyNyquist = axisFrequency[axis] / 2; // No rounding needed
+        if (cutoffHz[axis] && cutoffHz[axis] <= axisFrequencyNyquist) {
+            switch (type) {
             case FILTER_BIQUAD:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
-                biquadFilterInitLPF(&dtermLowpass2[axis].biquadFilter, pidProfile->dFilter[axis].dLpf2, targetPidLooptime);
+                applyFn = (filterApplyFnPtr)biquadFilterApply;
+                biquadFilterInitLPF(&lowpass[axis].biquadFilter, cutoffHz[axis], targetPidLooptime * axisProcessDenom[axis]);
                 break;
             case FILTER_PT4:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass2[axis].ptnFilter, FILTER_PT4, pidProfile->dFilter[axis].dLpf2, dT);
+                applyFn = (filterApplyFnPtr)pt4FilterApply;
+                ptnFilterInit(&lowpass[axis].ptnFilter, FILTER_PT4, cutoffHz[axis], axisDT[axis]);
                 break;
             case FILTER_PT3:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass2[axis].ptnFilter, FILTER_PT3, pidProfile->dFilter[axis].dLpf2, dT);
+                applyFn = (filterApplyFnPtr)pt3FilterApply;
+                ptnFilterInit(&lowpass[axis].ptnFilter, FILTER_PT3, cutoffHz[axis], axisDT[axis]);
                 break;
             case FILTER_PT2:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)ptnFilterApply;
-                ptnFilterInit(&dtermLowpass2[axis].ptnFilter, FILTER_PT2, pidProfile->dFilter[axis].dLpf2, dT);
+                applyFn = (filterApplyFnPtr)pt2FilterApply;
+                ptnFilterInit(&lowpass[axis].ptnFilter, FILTER_PT2, cutoffHz[axis], axisDT[axis]);
                 break;
             case FILTER_LULU:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)luluFilterApply;
-                luluFilterInit(&dtermLowpass2[axis].luluFilter, pidProfile->lulu_n_val);
+                applyFn = (filterApplyFnPtr)luluFilterApply;
+                luluFilterInit(&lowpass[axis].luluFilter, luluN);
                 break;
             default: // case FILTER_PT1:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
-                pt1FilterInit(&dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf2, dT));
+                applyFn = (filterApplyFnPtr)pt1FilterApply;
+                pt1FilterInit(&lowpass[axis].pt1Filter, pt1FilterGain(cutoffHz[axis], axisDT[axis]));
                 break;
             }
         }
+    }
+    return applyFn;
+}
+
+void pidInitFilters(const pidProfile_t *pidProfile) {
+    BUILD_BUG_ON(FD_YAW != 2);                             // ensure yaw axis is 2
+    angleSetpointFilterApplyFn = nullFilterApply;
+#ifdef USE_DYN_LPF
+    dtermDynLpfActive = pidDynLpfConfigured(pidProfile);
+    dtermDynLpfType = dtermDynLpfActive ? pidProfile->dterm_filter_type : FILTER_PT1;
+#endif
+    uint16_t cutoffHz[XYZ_AXIS_COUNT];
+    pidDtermLowpassCutoffs(pidProfile, FILTER_LOWPASS, cutoffHz);
+    dtermLowpassApplyFn = pidInitDtermLowpass(dtermLowpass, pidProfile->dterm_filter_type, cutoffHz, pidProfile->lulu_n_val);
+    pidDtermLowpassCutoffs(pidProfile, FILTER_LOWPASS2, cutoffHz);
+    dtermLowpass2ApplyFn = pidInitDtermLowpass(dtermLowpass2, pidProfile->dterm_filter2_type, cutoffHz, pidProfile->lulu_n_val);
+#ifdef USE_FILTER_RETUNE
+    pidFiltersProfile = *pidProfile;
+    pidFilterCoeffsPending = false;
+#endif
 
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         if (pidProfile->angle_filter) {
             angleSetpointFilterApplyFn = (filterApplyFnPtr)pt1FilterApply;
-            pt1FilterInit(&angleSetpointFilter[axis], pt1FilterGain(pidProfile->angle_filter, dT));
+            pt1FilterInit(&angleSetpointFilter[axis], pt1FilterGain(pidProfile->angle_filter, levelDT));
         }
 
         if (pidProfile->dterm_ABG_alpha) {
             dtermABGapplyFn = (filterApplyFnPtr)alphaBetaGammaApply;
-            ABGInit(&dtermABG[axis], pidProfile->dterm_ABG_alpha, pidProfile->dterm_ABG_boost, pidProfile->dterm_ABG_half_life, dT);
+            ABGInit(&dtermABG[axis], pidProfile->dterm_ABG_alpha, pidProfile->dterm_ABG_boost, pidProfile->dterm_ABG_half_life, axisDT[axis]);
         }
 #ifdef USE_GYRO_DATA_ANALYSE
         if (isDynamicFilterActive()) {
             for (int axis2 = 0; axis2 < gyroConfig()->dyn_notch_count; axis2++) {
-                biquadFilterInit(&dtermNotch[axis][axis2], 400, targetPidLooptime, gyroConfig()->dyn_notch_q / 100.0f, FILTER_NOTCH);
+                biquadFilterInit(&dtermNotch[axis][axis2], 400, targetPidLooptime, pidProfile->dterm_dyn_notch_q / 100.0f, FILTER_NOTCH);
             }
+            dtermNotchUpdateCount[axis] = getDtermNotchUpdateCount(axis) - 1; // pick up the shared coefficients on the first loop
         }
 #endif
 
     }
 
+#ifdef USE_GYRO_DATA_ANALYSE
+    // the analyser publishes D-term notch coefficients alongside its own, so the PID loop only applies them
+    if (isDynamicFilterActive() && pidProfile->dtermDynNotch) {
+        gyroDataAnalyseSetDtermNotch(pidProfile->dterm_dyn_notch_q / 100.0f, targetPidLooptime);
+    } else {
+        gyroDataAnalyseSetDtermNotch(0, 0);
+    }
+#endif
+
 #if defined(USE_THROTTLE_BOOST)
     pt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
 #endif
@@ -350,19 +415,140 @@ void pidInitFilters(const pidProfile_t *pidProfile) {
         pt1FilterInit(&axisLockLpf[i], pt1FilterGain(pidProfile->axis_lock_hz, dT));
 #if defined(USE_ITERM_RELAX)
         if (i != FD_YAW) {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, dT));
+            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, axisDT[i]));
         } else {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoffYaw, dT));
+            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoffYaw, axisDT[i]));
+        }
+#endif
+    }
+}
+
+#ifdef USE_DYN_LPF
+bool pidDynLpfEnabled(void) {
+    return dtermDynLpfActive;
+}
+
+// New cutoff for the first dterm lowpass, clamped to nyquist
+void pidDynLpfUpdate(uint16_t cutoffHz) {
+    if (!dtermDynLpfActive) {
+        return;
+    }
+    cutoffHz = MIN(cutoffHz, (uint16_t)(pidFrequency / 2));
+    if (dtermDynLpfType == FILTER_PT1) {
+        const float k = pt1FilterGain(cutoffHz, dT);
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            pt1FilterUpdateCutoff(&dtermLowpass[axis].pt1Filter, axisProcessDenom[axis] == 1 ? k : pt1FilterGain(MIN(cutoffHz, (uint16_t)(axisFrequency[axis] / 2)), axisDT[axis]));
         }
+    } else {
+        ptnFilterUpdateCutoff(&dtermLowpass[FD_ROLL].ptnFilter, cutoffHz, dT);
+        for (int axis = FD_PITCH; axis <= FD_YAW; axis++) {
+            if (axisProcessDenom[axis] == 1) {
+                dtermLowpass[axis].ptnFilter.k = dtermLowpass[FD_ROLL].ptnFilter.k;
+            } else {
+                ptnFilterUpdateCutoff(&dtermLowpass[axis].ptnFilter, MIN(cutoffHz, (uint16_t)(axisFrequency[axis] / 2)), axisDT[axis]);
+            }
+        }
+    }
+}
 #endif
+
+#ifdef USE_FILTER_RETUNE
+static FAST_CODE void pidDtermLowpassCopyCoeffs(filterApplyFnPtr applyFn, dtermLowpass_t *lowpass, const dtermLowpass_t *coeffs) {
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (applyFn == (filterApplyFnPtr)pt1FilterApply) {
+            lowpass[axis].pt1Filter.k = coeffs[axis].pt1Filter.k;
+        } else if (applyFn == (filterApplyFnPtr)pt2FilterApply || applyFn == (filterApplyFnPtr)pt3FilterApply
+                   || applyFn == (filterApplyFnPtr)pt4FilterApply) {
+            lowpass[axis].ptnFilter.k = coeffs[axis].ptnFilter.k;
+        } else if (applyFn == (filterApplyFnPtr)biquadFilterApply) {
+            biquadFilterCopyCoeffs(&lowpass[axis].biquadFilter, &coeffs[axis].biquadFilter);
+        }
     }
 }
 
+// Called at the start of a pid loop, the filter state carries on so the D-term doesn't step
+static FAST_CODE_NOINLINE void pidSwapFilterCoeffs(void) {
+    pidDtermLowpassCopyCoeffs(dtermLowpassApplyFn, dtermLowpass, pidRetuneCoeffs.dtermLowpass);
+    pidDtermLowpassCopyCoeffs(dtermLowpass2ApplyFn, dtermLowpass2, pidRetuneCoeffs.dtermLowpass2);
+    pidFilterCoeffsPending = false;
+}
+
+static uint8_t pidDtermLowpassAxes(const uint16_t *cutoffHz) {
+    uint8_t axes = 0;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        const uint32_t axisFrequencyNyquist = axisFrequency[axis] / 2;
+        if (cutoffHz[axis] && cutoffHz[axis] <= axisFrequencyNyquist) {
+            axes |= 1 << axis;
+        }
+    }
+    return axes;
+}
+
+// Whether the lowpass stages stay the same, only their cutoffs may change
+static bool pidFilterLayoutUnchanged(const pidProfile_t *pidProfile) {
+    pidProfile_t retuned = *pidProfile;
+    memcpy(retuned.dFilter, pidFiltersProfile.dFilter, sizeof(retuned.dFilter));
+    retuned.dyn_lpf_dterm_min_hz = pidFiltersProfile.dyn_lpf_dterm_min_hz;
+    retuned.dyn_lpf_dterm_max_hz = pidFiltersProfile.dyn_lpf_dterm_max_hz;
+    if (memcmp(&retuned, &pidFiltersProfile, sizeof(retuned)) != 0) {
+        return false;
+    }
+#ifdef USE_DYN_LPF
+    if (pidDynLpfConfigured(pidProfile) != dtermDynLpfActive) {
+        return false;
+    }
+#endif
+    for (int slot = FILTER_LOWPASS; slot <= FILTER_LOWPASS2; slot++) {
+        uint16_t cutoffHz[XYZ_AXIS_COUNT];
+        uint16_t activeCutoffHz[XYZ_AXIS_COUNT];
+        pidDtermLowpassCutoffs(pidProfile, slot, cutoffHz);
+        pidDtermLowpassCutoffs(&pidFiltersProfile, slot, activeCutoffHz);
+        if (pidDtermLowpassAxes(cutoffHz) != pidDtermLowpassAxes(activeCutoffHz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hands new D-term lowpass cutoffs to the running filters without resetting them, the pid loop swaps
+// the coefficients in before its next run. False when more than the cutoffs changed, the filters
+// then have to be set up again with pidInitFilters()
+bool pidRetuneFilters(const pidProfile_t *pidProfile) {
+    if (!pidFilterLayoutUnchanged(pidProfile)) {
+        return false;
+    }
+    // the pid loop may interrupt us, it must not take a half written set
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        pidFilterCoeffsPending = false;
+    }
+    uint16_t cutoffHz[XYZ_AXIS_COUNT];
+    // axes without a lowpass keep the coefficients they have
+    memcpy(pidRetuneCoeffs.dtermLowpass, dtermLowpass, sizeof(pidRetuneCoeffs.dtermLowpass));
+    pidDtermLowpassCutoffs(pidProfile, FILTER_LOWPASS, cutoffHz);
+    pidInitDtermLowpass(pidRetuneCoeffs.dtermLowpass, pidProfile->dterm_filter_type, cutoffHz, pidProfile->lulu_n_val);
+    memcpy(pidRetuneCoeffs.dtermLowpass2, dtermLowpass2, sizeof(pidRetuneCoeffs.dtermLowpass2));
+    pidDtermLowpassCutoffs(pidProfile, FILTER_LOWPASS2, cutoffHz);
+    pidInitDtermLowpass(pidRetuneCoeffs.dtermLowpass2, pidProfile->dterm_filter2_type, cutoffHz, pidProfile->lulu_n_val);
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        pidFilterCoeffsPending = true;
+    }
+    pidFiltersProfile = *pidProfile;
+    return true;
+}
+#endif // USE_FILTER_RETUNE
+
 typedef struct pidCoefficient_s {
     float Kp;
     float Ki;
     float Kd;
     float Kf;
+    // derived from the profile in pidInitConfig so the controller loop only does arithmetic
+    float errorAcceleratorGain;     // emuGravity, zero on yaw
+    float errorBoostMultiplier;
+    float errorBoostLimit;
+#if defined(USE_ITERM_RELAX)
+    float itermRelaxThresholdInv;
+#endif
 } pidCoefficient_t;
 
 static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
@@ -379,6 +565,10 @@ static FAST_RAM_ZERO_INIT timeDelta_t crashTimeLimitUs;
 static FAST_RAM_ZERO_INIT timeDelta_t crashTimeDelayUs;
 static FAST_RAM_ZERO_INIT int32_t crashRecoveryAngleDeciDegrees;
 static FAST_RAM_ZERO_INIT float crashRecoveryRate;
+static FAST_RAM_ZERO_INIT float crashRpmLoss;
+#ifdef USE_RPM_FILTER
+static FAST_RAM_ZERO_INIT uint8_t crashStalledMotors;
+#endif
 static FAST_RAM_ZERO_INIT float crashDtermThreshold;
 static FAST_RAM_ZERO_INIT float crashGyroThreshold;
 static FAST_RAM_ZERO_INIT float crashSetpointThreshold;
@@ -403,21 +593,17 @@ void pidUpdateEmuGravityThrottleFilter(float throttle) {
       emuGravityThrottleHpf = throttle - pt1FilterApply(&emuGravityThrottleLpf, throttle);
 }
 
-void pidInitConfig(const pidProfile_t *pidProfile) {
-    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
-        setPointPTransition[axis] = pidProfile->setPointPTransition[axis] / 100.0f;
-        setPointITransition[axis] = pidProfile->setPointITransition[axis] / 100.0f;
-        setPointDTransition[axis] = pidProfile->setPointDTransition[axis] / 100.0f;
-    }
-    directFF[0] = DIRECT_FF_SCALE * pidProfile->directFF_yaw;
+// The P, I and D gains of one axis, all an in-flight pid adjustment changes
+void pidInitAxisGains(const pidProfile_t *pidProfile, int axis) {
+    pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
+    pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
+    pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
+}
+
+// The angle and horizon mode constants
+void pidInitLevelConfig(const pidProfile_t *pidProfile) {
     DF_angle_low = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_LOW].I;
     DF_angle_high = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_HIGH].I;
-    feathered_pids = pidProfile->feathered_pids / 100.0f;
-    dtermBoostMultiplier = (pidProfile->dtermBoost * pidProfile->dtermBoost / 1000000) * 0.003;
-    dtermBoostLimitPercent = pidProfile->dtermBoostLimit / 100.0f;
     P_angle_low = pidProfile->pid[PID_LEVEL_LOW].P * 0.1f;
     D_angle_low = pidProfile->pid[PID_LEVEL_LOW].D * 0.00002428571f;
     P_angle_high = pidProfile->pid[PID_LEVEL_HIGH].P * 0.1f;
@@ -426,8 +612,31 @@ void pidInitConfig(const pidProfile_t *pidProfile) {
     horizonTransition = (float)pidProfile->horizonTransition;
     horizonCutoffDegrees = pidProfile->horizon_tilt_effect;
     horizonStrength = pidProfile->horizonStrength / 50.0f;
-    maxVelocity[FD_ROLL] = maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
-    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
+}
+
+void pidInitConfig(const pidProfile_t *pidProfile) {
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidInitAxisGains(pidProfile, axis);
+        setPointPTransition[axis] = pidProfile->setPointPTransition[axis] / 100.0f;
+        setPointITransition[axis] = pidProfile->setPointITransition[axis] / 100.0f;
+        setPointDTransition[axis] = pidProfile->setPointDTransition[axis] / 100.0f;
+        const float errorBoost = (axis == FD_YAW) ? pidProfile->errorBoostYaw : pidProfile->errorBoost;
+        const float errorBoostLimit = (axis == FD_YAW) ? pidProfile->errorBoostLimitYaw : pidProfile->errorBoostLimit;
+        pidCoefficient[axis].errorAcceleratorGain = (axis == FD_YAW) ? 0.0f : 0.1f * pidProfile->emuGravityGain;
+        pidCoefficient[axis].errorBoostMultiplier = (errorBoost * errorBoost / 1000000) * 0.003f;
+        pidCoefficient[axis].errorBoostLimit = errorBoostLimit / 100;
+#if defined(USE_ITERM_RELAX)
+        pidCoefficient[axis].itermRelaxThresholdInv = 1.0f / ((axis == FD_YAW) ? pidProfile->iterm_relax_threshold_yaw : pidProfile->iterm_relax_threshold);
+#endif
+    }
+    directFF[0] = DIRECT_FF_SCALE * pidProfile->directFF_yaw;
+    feathered_pids = pidProfile->feathered_pids / 100.0f;
+    dtermBoostMultiplier = (pidProfile->dtermBoost * pidProfile->dtermBoost / 1000000) * 0.003;
+    dtermBoostLimitPercent = pidProfile->dtermBoostLimit / 100.0f;
+    pidInitLevelConfig(pidProfile);
+    maxVelocity[FD_ROLL] = pidProfile->rateAccelLimit * 100 * axisDT[FD_ROLL];
+    maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * axisDT[FD_PITCH];
+    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * axisDT[FD_YAW];
     ITermWindupPointInv = 0.0f;
     if (pidProfile->itermWindupPointPercent != 0) {
         const float itermWindupPoint = pidProfile->itermWindupPointPercent / 100.0f;
@@ -441,6 +650,7 @@ void pidInitConfig(const pidProfile_t *pidProfile) {
     crashDtermThreshold = pidProfile->crash_dthreshold;
     crashSetpointThreshold = pidProfile->crash_setpoint_threshold;
     crashLimitYaw = pidProfile->crash_limit_yaw;
+    crashRpmLoss = pidProfile->crash_rpm_loss / 100.0f;
     itermLimit = pidProfile->itermLimit;
 #if defined(USE_THROTTLE_BOOST)
     throttleBoost = pidProfile->throttle_boost * 0.1f;
@@ -456,7 +666,7 @@ void pidInitConfig(const pidProfile_t *pidProfile) {
 }
 
 void pidInit(const pidProfile_t *pidProfile) {
-    pidSetTargetLooptime(gyro.targetLooptime * pidConfig()->pid_process_denom); // Initialize pid looptime
+    pidSetTargetLooptime(gyroTaskLooptime() * pidConfig()->pid_process_denom); // Initialize pid looptime
     pidInitFilters(pidProfile);
     pidInitConfig(pidProfile);
 }
@@ -523,7 +733,7 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
 #ifdef USE_GPS_RESCUE
     angle += gpsRescueAngle[axis] / 100; // ANGLE IS IN CENTIDEGREES
 #endif
-    f_term_low = (angle - previousAngle[axis]) * F_angle / dT;
+    f_term_low = (angle - previousAngle[axis]) * F_angle / levelDT;
 
     previousAngle[axis] = angle;
     angle = constrainf(angle, -90.0f, 90.0f);
@@ -549,8 +759,10 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
     p_term_low = (1 - errorAnglePercent) * errorAngle * P_angle_low;
     p_term_high = errorAnglePercent * errorAngle * P_angle_high;
 
-    d_term_low = (1 - errorAnglePercent) * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  D_angle_low;
-    d_term_high = errorAnglePercent * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  D_angle_high;
+    // the D gains are per pid loop, a decimated outer loop sees the change of several
+    const float attitudeChange = (attitudePrevious[axis] - getAngleModeAngles(axis)) / levelProcessDenom;
+    d_term_low = (1 - errorAnglePercent) * attitudeChange * D_angle_low;
+    d_term_high = errorAnglePercent * attitudeChange * D_angle_high;
     attitudePrevious[axis] = getAngleModeAngles(axis);
 
     currentPidSetpoint = p_term_low + p_term_high;
@@ -636,11 +848,20 @@ static void detectAndSetCrashRecovery(
     // no point in trying to recover if the crash is so severe that the gyro overflows
     if ((crash_recovery || FLIGHT_MODE(GPS_RESCUE_MODE)) && !gyroOverflowDetected()) {
         if (ARMING_FLAG(ARMED)) {
-            if (getControllerMixRange() >= 1.0f && !inCrashRecoveryMode && ABS(delta) > crashDtermThreshold && ABS(errorRate) > crashGyroThreshold && ABS(getSetpointRate(axis)) < crashSetpointThreshold) {
+            bool crashDetected = ABS(delta) > crashDtermThreshold && ABS(errorRate) > crashGyroThreshold;
+            bool crashOver = ABS(errorRate) < crashGyroThreshold;
+#ifdef USE_RPM_FILTER
+            if (crashRpmLoss > 0.0f && isRpmFilterEnabled()) {
+                // a stalled prop confirms the gyro, two of them are a crash before the gyro thresholds are reached
+                crashDetected = (crashDetected && crashStalledMotors > 0) || crashStalledMotors >= 2;
+                crashOver = crashOver && crashStalledMotors < 2;
+            }
+#endif
+            if (getControllerMixRange() >= 1.0f && !inCrashRecoveryMode && crashDetected && ABS(getSetpointRate(axis)) < crashSetpointThreshold) {
                 inCrashRecoveryMode = true;
                 crashDetectedAtUs = currentTimeUs;
             }
-            if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) < crashTimeDelayUs && (ABS(errorRate) < crashGyroThreshold || ABS(getSetpointRate(axis)) > crashSetpointThreshold)) {
+            if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) < crashTimeDelayUs && (crashOver || ABS(getSetpointRate(axis)) > crashSetpointThreshold)) {
                 inCrashRecoveryMode = false;
                 BEEP_OFF;
             }
@@ -651,47 +872,67 @@ static void detectAndSetCrashRecovery(
     }
 }
 
-static void rotateVector(float v[XYZ_AXIS_COUNT], float rotation[XYZ_AXIS_COUNT]) {
-    // rotate v around rotation vector rotation
-    // rotation in radians, all elements must be small
-    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-        int i_1 = (i + 1) % 3;
-        int i_2 = (i + 2) % 3;
-        float newV = v[i_1] + v[i_2] * rotation[i];
-        v[i_2] -= v[i_1] * rotation[i];
-        v[i_1] = newV;
+// below this rate on every axis the I-term isn't rotated, it turns less than a degree a second
+#define ITERM_ROTATION_MIN_RATE_DPS 1.0f
+
+static FAST_RAM_ZERO_INIT float itermRotationRads[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT bool itermRotationActive;
+
+// The rotation over one pid loop, taken once per loop from the gyro rates
+static FAST_CODE void updateITermRotation(void) {
+    itermRotationActive = false;
+    if (!itermRotation) {
+        return;
+    }
+    const float gyroToAngle = dT * RAD;
+    for (int i = FD_ROLL; i <= FD_YAW; i++) {
+        itermRotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
+        if (fabsf(gyro.gyroADCf[i]) > ITERM_ROTATION_MIN_RATE_DPS) {
+            itermRotationActive = true;
+        }
     }
 }
 
-static void rotateITermAndAxisError() {
-    if (itermRotation) {
-        const float gyroToAngle = dT * RAD;
-        float rotationRads[XYZ_AXIS_COUNT];
-        for (int i = FD_ROLL; i <= FD_YAW; i++) {
-            rotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
-        }
-        float v[XYZ_AXIS_COUNT];
-        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            v[i] = temporaryIterm[i];
-        }
-        rotateVector(v, rotationRads);
-        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            temporaryIterm[i] = v[i];
-        }
+static FAST_CODE void rotateITermAndAxisError(void) {
+    if (itermRotationActive) {
+        // the angles are small, so the rotation is the cross product of the I-term with them
+        const float *rotation = itermRotationRads;
+        const float iRoll = temporaryIterm[FD_ROLL];
+        const float iPitch = temporaryIterm[FD_PITCH];
+        const float iYaw = temporaryIterm[FD_YAW];
+        temporaryIterm[FD_ROLL] = iRoll + iPitch * rotation[FD_YAW] - iYaw * rotation[FD_PITCH];
+        temporaryIterm[FD_PITCH] = iPitch + iYaw * rotation[FD_ROLL] - iRoll * rotation[FD_YAW];
+        temporaryIterm[FD_YAW] = iYaw + iRoll * rotation[FD_PITCH] - iPitch * rotation[FD_ROLL];
     }
 }
 
 static FAST_RAM_ZERO_INIT float scaledAxisPid[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float stickMovement[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float lastRcDeflectionAbs[XYZ_AXIS_COUNT];
+// The outer loop runs every pid_level_process_denom loops, the rate loop holds its setpoint in between
+static float pidLevelDecimated(int axis, const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, float currentPidSetpoint) {
+    static float levelSetpoint[2], levelDirectFF[2];
+    if (levelSkipCount[axis]) {
+        levelSkipCount[axis]--;
+        directFF[axis] = levelDirectFF[axis];
+        return levelSetpoint[axis];
+    }
+    levelSkipCount[axis] = levelProcessDenom - 1;
+    levelSetpoint[axis] = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+    levelDirectFF[axis] = directFF[axis];
+    return levelSetpoint[axis];
+}
+
 static FAST_RAM_ZERO_INIT float previousError[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float previousMeasurement[XYZ_AXIS_COUNT];
-#ifdef USE_GYRO_DATA_ANALYSE
-static FAST_RAM_ZERO_INIT float previousNotchCenterFreq[XYZ_AXIS_COUNT][5];
-#endif
 static FAST_RAM_ZERO_INIT timeUs_t crashDetectedAtUs;
 
 void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs) {
+#ifdef USE_FILTER_RETUNE
+    if (pidFilterCoeffsPending) {
+        pidSwapFilterCoeffs();
+    }
+#endif
     float axisLock[XYZ_AXIS_COUNT];
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         axisLock[axis] = pt1FilterApply(&axisLockLpf[axis], stickMovement[axis]) * axisLockMultiplier;
@@ -707,17 +948,28 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         dynCi *= constrainf((1.0f - getControllerMixRange()) * ITermWindupPointInv, 0.0f, 1.0f);
     }
     float errorRate;
+#ifdef USE_RPM_FILTER
+    crashStalledMotors = crashRpmLoss > 0.0f ? rpmStalledMotorCount(crashRpmLoss) : 0;
+#endif
+    updateITermRotation();
     // ----------PID controller----------
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (axisSkipCount[axis]) {
+            axisSkipCount[axis]--;
+            // the rotation used to run once per axis, keep its rate
+            rotateITermAndAxisError();
+            continue;
+        }
+        axisSkipCount[axis] = axisProcessDenom[axis] - 1;
 
         // emugravity, the different hopefully better version of antiGravity no effect on yaw
-        float errorAccelerator = 1.0f;
-        if (pidProfile->emuGravityGain != 0 && axis != FD_YAW) {
-            errorAccelerator = 1.0f + fabsf(emuGravityThrottleHpf) * 0.1f * (pidProfile->emuGravityGain);
-        }
+        const float errorAccelerator = 1.0f + fabsf(emuGravityThrottleHpf) * pidCoefficient[axis].errorAcceleratorGain;
         float currentPidSetpoint = getSetpointRate(axis);
+        // while the setpoint is the stick rate its derivative comes from the rx frames
+        bool stickSetpoint = setpointDerivativeIsValid();
         if (maxVelocity[axis]) {
             currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
+            stickSetpoint = false;
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
         // NFE racermode applies angle only to the roll axis
@@ -728,11 +980,17 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
 
         if (axis == FD_YAW) {
         } else if (FLIGHT_MODE(GPS_RESCUE_MODE)) {
-            currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+            currentPidSetpoint = pidLevelDecimated(axis, pidProfile, angleTrim, currentPidSetpoint);
+            stickSetpoint = false;
         } else if ((FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE)) && !FLIGHT_MODE(NFE_RACE_MODE)) {
-            currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+            currentPidSetpoint = pidLevelDecimated(axis, pidProfile, angleTrim, currentPidSetpoint);
+            stickSetpoint = false;
         } else if ((FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE)) && FLIGHT_MODE(NFE_RACE_MODE) && (axis != FD_PITCH)) {
-            currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+            currentPidSetpoint = pidLevelDecimated(axis, pidProfile, angleTrim, currentPidSetpoint);
+            stickSetpoint = false;
+        } else {
+            // run the outer loop straight away when a level mode comes on
+            levelSkipCount[axis] = 0;
         }
 
         // Handle yaw spin recovery - zero the setpoint on yaw to aid in recovery
@@ -740,12 +998,13 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
 #ifdef USE_YAW_SPIN_RECOVERY
         if ((axis == FD_YAW) && gyroYawSpinDetected()) {
             currentPidSetpoint = 0.0f;
+            stickSetpoint = false;
         }
 #endif // USE_YAW_SPIN_RECOVERY
 
         previousPidSetpoint[axis] = currentPidSetpoint;
 
-        stickMovement[axis] = (getRcDeflectionAbs(axis) - lastRcDeflectionAbs[axis]) * pidFrequency;
+        stickMovement[axis] = (getRcDeflectionAbs(axis) - lastRcDeflectionAbs[axis]) * axisFrequency[axis];
         lastRcDeflectionAbs[axis] = getRcDeflectionAbs(axis);
 
         const float gyroRate = gyro.gyroADCf[axis];
@@ -755,19 +1014,9 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
 
         // EmuFlight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
         // Based on 2DOF reference design (matlab)
-        float errorBoostAxis;
-        float errorLimitAxis;
-        if (axis <= FD_PITCH) {
-            errorBoostAxis = pidProfile->errorBoost;
-            errorLimitAxis = pidProfile->errorBoostLimit;
-        } else {
-            errorBoostAxis = pidProfile->errorBoostYaw;
-            errorLimitAxis = pidProfile->errorBoostLimitYaw;
-        }
-        errorLimitAxis = errorLimitAxis / 100;
-        float errorMultiplier = (errorBoostAxis * errorBoostAxis / 1000000) * 0.003;
+        const float errorLimitAxis = pidCoefficient[axis].errorBoostLimit;
         float boostedErrorRate;
-        boostedErrorRate = (errorRate * fabsf(errorRate)) * errorMultiplier;
+        boostedErrorRate = (errorRate * fabsf(errorRate)) * pidCoefficient[axis].errorBoostMultiplier;
         if (fabsf(errorRate * errorLimitAxis) < fabsf(boostedErrorRate)) {
             boostedErrorRate = errorRate * errorLimitAxis;
         }
@@ -782,11 +1031,7 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         if ((itermRelaxCutoff && axis != FD_YAW) || (itermRelaxCutoffYaw && axis == FD_YAW)) {
             const float setpointLpf = pt1FilterApply(&windupLpf[axis], currentPidSetpoint);
             const float setpointHpf = fabsf(currentPidSetpoint - setpointLpf);
-            if (axis != FD_YAW) {
-                itermRelaxFactor = MAX(1 - setpointHpf / pidProfile->iterm_relax_threshold, 0.0f);
-            } else {
-                itermRelaxFactor = MAX(1 - setpointHpf / pidProfile->iterm_relax_threshold_yaw, 0.0f);
-            }
+            itermRelaxFactor = MAX(1 - setpointHpf * pidCoefficient[axis].itermRelaxThresholdInv, 0.0f);
             if (SIGN(iterm) == SIGN(itermErrorRate)) {
                 itermErrorRate *= itermRelaxFactor;
             }
@@ -802,7 +1047,7 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         // -----calculate I component
         //float iterm = constrainf(pidData[axis].I + (pidCoefficient[axis].Ki * errorRate) * dynCi, -itermLimit, itermLimit);
         float iDecayMultiplier = iDecay;
-        float ITermNew = pidCoefficient[axis].Ki * itermErrorRate * dynCi;
+        float ITermNew = pidCoefficient[axis].Ki * itermErrorRate * dynCi * axisProcessDenom[axis];
         if (ITermNew != 0.0f) {
             if (SIGN(iterm) != SIGN(ITermNew)) {
                 // at low iterm iDecayMultiplier will be 1 and at high iterm it will be equivilant to iDecay
@@ -821,21 +1066,27 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         // -----calculate D component
         if (pidCoefficient[axis].Kd > 0) {
             //filter Kd properly, no setpoint filtering
-            const float pureError = errorRate - previousError[axis];
             const float pureMeasurement = -(gyroRate - previousMeasurement[axis]);
+            float pureError;
+            if (stickSetpoint) {
+                // the setpoint step of this loop taken from the rx frames, not from the setpoint's own smoothing steps
+                pureError = (getSetpointDerivative(axis) * axisDT[axis] + pureMeasurement) * errorAccelerator;
+            } else {
+                pureError = errorRate - previousError[axis];
+            }
             previousMeasurement[axis] = gyroRate;
             previousError[axis] = errorRate;
-            float dDelta = ((feathered_pids * pureMeasurement) + ((1 - feathered_pids) * pureError)) * pidFrequency; //calculating the dterm determine how much is calculated using measurement vs error
+            float dDelta = ((feathered_pids * pureMeasurement) + ((1 - feathered_pids) * pureError)) * axisFrequency[axis]; //calculating the dterm determine how much is calculated using measurement vs error
             //filter the dterm
 #ifdef USE_GYRO_DATA_ANALYSE
-            if (isDynamicFilterActive() && pidProfile->dtermDynNotch && axis <= gyroConfig()->dyn_notch_axis+1) {
-                for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
-                    if (getCenterFreq(axis, p) != previousNotchCenterFreq[axis][p]) {
-                        previousNotchCenterFreq[axis][p] = getCenterFreq(axis, p);
-                        biquadFilterUpdate(&dtermNotch[axis][p], previousNotchCenterFreq[axis][p], targetPidLooptime, pidProfile->dterm_dyn_notch_q / 100.0f, FILTER_NOTCH);
-                    }
-                    dDelta = biquadFilterApplyDF1(&dtermNotch[axis][p], dDelta);
+            // the shared notch coefficients are for the full pid rate
+            if (isDynamicFilterActive() && pidProfile->dtermDynNotch && axis <= gyroConfig()->dyn_notch_axis+1 && axisProcessDenom[axis] == 1) {
+                const uint8_t updateCount = getDtermNotchUpdateCount(axis);
+                if (updateCount != dtermNotchUpdateCount[axis]) {
+                    dtermNotchUpdateCount[axis] = updateCount;
+                    getDtermNotchCoeffs(axis, dtermNotch[axis], gyroConfig()->dyn_notch_count);
                 }
+                dDelta = biquadFilterCascadeApplyDF1(dtermNotch[axis], gyroConfig()->dyn_notch_count, dDelta);
             }
 #endif
             if(axis < 2) 
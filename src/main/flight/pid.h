@@ -26,6 +26,8 @@
 #include "pg/pg.h"
 
 #define MAX_PID_PROCESS_DENOM       16
+#define MAX_PID_YAW_PROCESS_DENOM   4
+#define MAX_PID_LEVEL_PROCESS_DENOM 8
 #define PID_CONTROLLER_BETAFLIGHT   1
 #define PID_MIXER_SCALING           1000.0f
 #define PID_SERVO_MIXER_SCALING     0.7f
@@ -134,6 +136,7 @@ typedef struct pidProfile_s {
     uint16_t crash_limit_yaw;               // limits yaw errorRate, so crashes don't cause huge throttle increase
     uint16_t itermLimit;                    // Maximum value that the iterm can accumulate to
     uint8_t crash_recovery;                 // off, on, on and beeps when it is in crash recovery mode
+    uint8_t crash_rpm_loss;                 // percent of its commanded rpm a motor must miss to count as stalled, 0 ignores the motor rpm
     uint8_t throttle_boost;                 // how much should throttle be boosted during transient changes 0-100, 100 adds 10x hpf filtered throttle
     uint8_t throttle_boost_cutoff;          // Which cutoff frequency to use for throttle boost. higher cutoffs keep the boost on for shorter. Specified in hz.
     uint8_t iterm_rotation;                 // rotates iterm to translate world errors to local coordinate system
@@ -160,6 +163,8 @@ typedef struct pidProfile_s {
 #ifdef USE_LULU
     uint8_t lulu_n_val;
 #endif
+    uint16_t dyn_lpf_dterm_min_hz;          // first dterm lowpass cutoff at low throttle or slow motors, 0 keeps dterm_lowpass_hz
+    uint16_t dyn_lpf_dterm_max_hz;          // cutoff at full throttle or fast motors
 } pidProfile_t;
 
 #ifndef USE_OSD_SLAVE
@@ -171,12 +176,21 @@ typedef struct pidConfig_s {
     uint8_t runaway_takeoff_prevention;          // off, on - enables pidsum runaway disarm logic
     uint16_t runaway_takeoff_deactivate_delay;   // delay in ms for "in-flight" conditions before deactivation (successful flight)
     uint8_t runaway_takeoff_deactivate_throttle; // minimum throttle percent required during deactivation phase
+    uint8_t pid_in_interrupt;                    // off, on - gyro runs in the gyro dma interrupt, pid and mixer in a software interrupt
+    uint16_t loop_wcet_gyro;                     // worst case gyro path time in 0.1us, measured by the cli looprate command, 0 when not measured
+    uint16_t loop_wcet_pid;                      // worst case pid, mixer and motor path time in 0.1us
+    uint8_t pid_yaw_process_denom;               // yaw rate loop runs every n pid loops, roll and pitch every loop
+    uint8_t pid_level_process_denom;             // angle/horizon outer loop runs every n pid loops
 } pidConfig_t;
 
 PG_DECLARE(pidConfig_t, pidConfig);
 
 union rollAndPitchTrims_u;
 void pidController(const pidProfile_t *pidProfile, const union rollAndPitchTrims_u *angleTrim, timeUs_t currentTimeUs);
+#ifdef USE_DYN_LPF
+bool pidDynLpfEnabled(void);
+void pidDynLpfUpdate(uint16_t cutoffHz);
+#endif
 
 typedef struct pidAxisData_s {
     float P;
@@ -198,7 +212,12 @@ extern pt1Filter_t throttleLpf;
 void pidResetITerm(void);
 void pidStabilisationState(pidStabilisationState_e pidControllerState);
 void pidInitFilters(const pidProfile_t *pidProfile);
+#ifdef USE_FILTER_RETUNE
+bool pidRetuneFilters(const pidProfile_t *pidProfile);
+#endif
 void pidInitConfig(const pidProfile_t *pidProfile);
+void pidInitAxisGains(const pidProfile_t *pidProfile, int axis);
+void pidInitLevelConfig(const pidProfile_t *pidProfile);
 void pidInit(const pidProfile_t *pidProfile);
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex);
 bool crashRecoveryModeActive(void);
@@ -0,0 +1,245 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_RPM_FILTER
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "config/feature.h"
+
+#include "drivers/pwm_output.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/rpm_filter.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/gyro.h"
+
+#define SECONDS_PER_MINUTE  60.0f
+#define ERPM_PER_LSB        100.0f
+#define MIN_UPDATE_T        0.001f  // every notch is recalculated at least once per millisecond
+
+#define MOTOR_HEALTH_MIN_COMMAND    0.2f    // motors below this share of the output range are not judged
+#define MOTOR_HEALTH_RESPONSE_HZ    10.0f   // roughly how fast a loaded motor follows its command
+#define MOTOR_HEALTH_LEARN_HZ       1.0f    // how fast the expected rpm per command follows the motors
+#define MOTOR_HEALTH_LEARN_MAX_LOSS 0.3f    // the ratio is only learnt while every motor is close to it
+
+PG_REGISTER_WITH_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 0);
+
+PG_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig,
+                  .gyro_rpm_notch_harmonics = 3,
+                  .gyro_rpm_notch_min = 100,
+                  .gyro_rpm_notch_q = 500,
+                  .rpm_lpf = 150,
+                 );
+
+typedef struct rpmNotchFilter_s {
+    uint8_t harmonics;
+    float   minHz;
+    float   maxHz;
+    float   q;
+    uint32_t loopTime;
+    biquadFilter_t notch[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS][RPM_FILTER_MAXHARMONICS];
+} rpmNotchFilter_t;
+
+static FAST_RAM_ZERO_INIT rpmNotchFilter_t gyroFilter;
+static FAST_RAM_ZERO_INIT pt1Filter_t rpmFilters[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float motorFrequency[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float erpmToHz;
+static FAST_RAM_ZERO_INIT uint8_t numberMotors;
+static FAST_RAM_ZERO_INIT uint8_t filterUpdatesPerIteration;
+static FAST_RAM_ZERO_INIT uint8_t currentMotor;
+static FAST_RAM_ZERO_INIT uint8_t currentHarmonic;
+static FAST_RAM_ZERO_INIT bool rpmFilterEnabled;
+
+// Motor health: the eRPM a motor should reach follows its command through a lag and a learnt rpm per command
+// ratio, the share of it that is missing flags a stalled, desynced or blocked motor
+static FAST_RAM_ZERO_INIT pt1Filter_t motorCommandLpf[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT pt1Filter_t hzPerCommandLpf;
+static FAST_RAM_ZERO_INIT float motorRpmLoss[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT bool motorHealthEnabled;
+
+void rpmFilterInit(const rpmFilterConfig_t *config) {
+    rpmFilterEnabled = false;
+    currentMotor = currentHarmonic = 0;
+    numberMotors = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+    if (!useDshotTelemetry || config->gyro_rpm_notch_harmonics == 0 || numberMotors == 0) {
+        return;
+    }
+    gyroFilter.harmonics = MIN(config->gyro_rpm_notch_harmonics, RPM_FILTER_MAXHARMONICS);
+    gyroFilter.minHz = config->gyro_rpm_notch_min;
+    gyroFilter.q = config->gyro_rpm_notch_q / 100.0f;
+    gyroFilter.loopTime = gyro.targetLooptime;
+    // keep the notches clear of nyquist, the biquad degenerates there
+    gyroFilter.maxHz = 0.48f * 1e6f / gyro.targetLooptime;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int motor = 0; motor < numberMotors; motor++) {
+            for (int harmonic = 0; harmonic < gyroFilter.harmonics; harmonic++) {
+                biquadFilterInit(&gyroFilter.notch[axis][motor][harmonic], gyroFilter.minHz * (harmonic + 1), gyroFilter.loopTime, gyroFilter.q, FILTER_NOTCH);
+            }
+        }
+    }
+    const float pidLooptime = gyroTaskLooptime() * pidConfig()->pid_process_denom * 1e-6f;
+    for (int motor = 0; motor < numberMotors; motor++) {
+        pt1FilterInit(&rpmFilters[motor], pt1FilterGain(config->rpm_lpf, pidLooptime));
+        motorFrequency[motor] = 0.0f;
+        pt1FilterInit(&motorCommandLpf[motor], pt1FilterGain(MOTOR_HEALTH_RESPONSE_HZ, pidLooptime));
+        motorRpmLoss[motor] = 0.0f;
+    }
+    pt1FilterInit(&hzPerCommandLpf, pt1FilterGain(MOTOR_HEALTH_LEARN_HZ, pidLooptime));
+    // the command to rpm relation does not hold through the 3d deadband
+    motorHealthEnabled = !feature(FEATURE_3D);
+    erpmToHz = ERPM_PER_LSB / SECONDS_PER_MINUTE / (motorConfig()->motorPoleCount / 2.0f);
+    // spread the sin/cos work over the pid loops of one update period instead of redoing every notch each loop
+    const float loopsPerUpdate = MAX(MIN_UPDATE_T / pidLooptime, 1.0f);
+    filterUpdatesPerIteration = constrain(lrintf(ceilf(numberMotors * gyroFilter.harmonics / loopsPerUpdate)), 1, numberMotors * gyroFilter.harmonics);
+    rpmFilterEnabled = true;
+}
+
+bool isRpmFilterEnabled(void) {
+    return rpmFilterEnabled;
+}
+
+FAST_CODE float rpmFilterGyro(int axis, float value) {
+    if (!rpmFilterEnabled) {
+        return value;
+    }
+    for (int motor = 0; motor < numberMotors; motor++) {
+        for (int harmonic = 0; harmonic < gyroFilter.harmonics; harmonic++) {
+            value = biquadFilterApplyDF1(&gyroFilter.notch[axis][motor][harmonic], value);
+        }
+    }
+    return value;
+}
+
+static FAST_CODE void motorHealthUpdate(void) {
+    if (!ARMING_FLAG(ARMED)) {
+        for (int i = 0; i < numberMotors; i++) {
+            motorCommandLpf[i].state = 0.0f;
+            motorRpmLoss[i] = 0.0f;
+        }
+        return;
+    }
+    const float outputRangeInv = 1.0f / (motorOutputHigh - motorOutputLow);
+    const float hzPerCommand = hzPerCommandLpf.state;
+    float commandSum = 0.0f;
+    float frequencySum = 0.0f;
+    bool allTracking = true;
+    for (int i = 0; i < numberMotors; i++) {
+        const float command = pt1FilterApply(&motorCommandLpf[i], constrainf((motor[i] - motorOutputLow) * outputRangeInv, 0.0f, 1.0f));
+        float loss = 0.0f;
+        if (command > MOTOR_HEALTH_MIN_COMMAND && hzPerCommand > 0.0f) {
+            loss = constrainf(1.0f - motorFrequency[i] / (hzPerCommand * command), 0.0f, 1.0f);
+        }
+        motorRpmLoss[i] = loss;
+        allTracking = allTracking && loss < MOTOR_HEALTH_LEARN_MAX_LOSS;
+        commandSum += command;
+        frequencySum += motorFrequency[i];
+        if (i < 4) {
+            DEBUG_SET(DEBUG_RPM_MOTOR_HEALTH, i, lrintf(loss * 1000.0f));
+        }
+    }
+    if (allTracking && commandSum > MOTOR_HEALTH_MIN_COMMAND * numberMotors) {
+        const float ratio = frequencySum / commandSum;
+        if (hzPerCommand > 0.0f) {
+            pt1FilterApply(&hzPerCommandLpf, ratio);
+        } else {
+            hzPerCommandLpf.state = ratio;
+        }
+    }
+}
+
+// Number of motors missing at least minLoss (0..1) of the rpm their command asks for
+uint8_t rpmStalledMotorCount(float minLoss) {
+    uint8_t count = 0;
+    if (rpmFilterEnabled && motorHealthEnabled) {
+        for (int i = 0; i < numberMotors; i++) {
+            if (motorRpmLoss[i] >= minLoss) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+// Smoothed frequency of the slowest motor in Hz, 0 without the filter
+float rpmMinMotorFrequency(void) {
+    if (!rpmFilterEnabled) {
+        return 0.0f;
+    }
+    float minFrequency = motorFrequency[0];
+    for (int i = 1; i < numberMotors; i++) {
+        minFrequency = MIN(minFrequency, motorFrequency[i]);
+    }
+    return minFrequency;
+}
+
+FAST_CODE_NOINLINE void rpmFilterUpdate(void) {
+    if (!rpmFilterEnabled) {
+        return;
+    }
+    for (int motor = 0; motor < numberMotors; motor++) {
+        const float erpm = pt1FilterApply(&rpmFilters[motor], getDshotTelemetry(motor));
+        motorFrequency[motor] = erpm * erpmToHz;
+        if (motor < 4) {
+            DEBUG_SET(DEBUG_RPM_FILTER, motor, lrintf(motorFrequency[motor]));
+        }
+    }
+    if (motorHealthEnabled) {
+        motorHealthUpdate();
+    }
+    for (int i = 0; i < filterUpdatesPerIteration; i++) {
+        const float frequency = constrainf((currentHarmonic + 1) * motorFrequency[currentMotor], gyroFilter.minHz, gyroFilter.maxHz);
+        biquadFilter_t *roll = &gyroFilter.notch[FD_ROLL][currentMotor][currentHarmonic];
+        biquadFilterUpdate(roll, frequency, gyroFilter.loopTime, gyroFilter.q, FILTER_NOTCH);
+        // the coefficients only depend on the motor, share them with the other axes
+        for (int axis = FD_PITCH; axis < XYZ_AXIS_COUNT; axis++) {
+            biquadFilter_t *dest = &gyroFilter.notch[axis][currentMotor][currentHarmonic];
+            dest->b0 = roll->b0;
+            dest->b1 = roll->b1;
+            dest->b2 = roll->b2;
+            dest->a1 = roll->a1;
+            dest->a2 = roll->a2;
+        }
+        if (++currentHarmonic == gyroFilter.harmonics) {
+            currentHarmonic = 0;
+            if (++currentMotor == numberMotors) {
+                currentMotor = 0;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "platform.h"
+
+#include "pg/pg.h"
+
+#define RPM_FILTER_MAXHARMONICS 3
+
+typedef struct rpmFilterConfig_s {
+    uint8_t  gyro_rpm_notch_harmonics;   // number of harmonics, 0 disables the filter bank
+    uint8_t  gyro_rpm_notch_min;         // minimum notch frequency in Hz
+    uint16_t gyro_rpm_notch_q;           // notch Q * 100
+    uint16_t rpm_lpf;                    // cutoff of the PT1 smoothing the motor eRPM
+} rpmFilterConfig_t;
+
+PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
+
+void rpmFilterInit(const rpmFilterConfig_t *config);
+float rpmFilterGyro(int axis, float value);
+void rpmFilterUpdate(void);
+bool isRpmFilterEnabled(void);
+uint8_t rpmStalledMotorCount(float minLoss);
+float rpmMinMotorFrequency(void);
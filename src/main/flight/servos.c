@@ -95,6 +95,23 @@ static uint8_t servoRuleCount = 0;
 static servoMixer_t currentServoMixer[MAX_SERVO_RULES];
 static int useServo;
 
+// currentServoMixer with everything that only changes with the config worked out
+typedef struct servoMixerOp_s {
+    const int16_t *input;
+    int16_t min;
+    int16_t max;
+    int16_t output;                         // rate limited input for rules with a speed
+    int8_t rate;
+    int8_t direction;
+    uint8_t speed;
+    uint8_t target;
+    uint8_t boxMask;                        // bit 0 for rules without a box, bit n for BOXSERVOn
+} servoMixerOp_t;
+
+static int16_t servoMixerInput[INPUT_SOURCE_COUNT]; // Range [-500:+500]
+static servoMixerOp_t servoMixerOps[MAX_SERVO_RULES];
+static uint8_t servoMixerOpCount;
+
 
 #define COUNT_SERVO_RULES(rules) (sizeof(rules) / sizeof(servoMixer_t))
 // mixer rule format servo, input, rate, speed, min, max, box
@@ -212,6 +229,28 @@ int servoDirection(int servoIndex, int inputSource) {
     }
 }
 
+// Call after changing currentServoMixer or servoParams
+void servoMixerCompile(void) {
+    servoMixerOpCount = 0;
+    for (int i = 0; i < servoRuleCount; i++) {
+        const servoMixer_t *rule = &currentServoMixer[i];
+        if (rule->targetChannel >= MAX_SUPPORTED_SERVOS || rule->inputSource >= INPUT_SOURCE_COUNT) {
+            continue;
+        }
+        servoMixerOp_t *op = &servoMixerOps[servoMixerOpCount++];
+        const uint16_t servo_width = servoParams(rule->targetChannel)->max - servoParams(rule->targetChannel)->min;
+        op->input = &servoMixerInput[rule->inputSource];
+        op->min = rule->min * servo_width / 100 - servo_width / 2;
+        op->max = rule->max * servo_width / 100 - servo_width / 2;
+        op->output = 0;
+        op->rate = rule->rate;
+        op->direction = servoDirection(rule->targetChannel, rule->inputSource);
+        op->speed = rule->speed;
+        op->target = rule->targetChannel;
+        op->boxMask = 1 << MIN(rule->box, MAX_SERVO_BOXES);
+    }
+}
+
 void servosInit(void) {
     // enable servos for mixes that require them. note, this shifts motor counts.
     useServo = mixers[currentMixerMode].useServo;
@@ -241,6 +280,7 @@ void loadCustomServoMixer(void) {
         currentServoMixer[i] = *customServoMixers(i);
         servoRuleCount++;
     }
+    servoMixerCompile();
 }
 
 void servoConfigureOutput(void) {
@@ -266,6 +306,7 @@ void servoConfigureOutput(void) {
             loadCustomServoMixer();
         }
     }
+    servoMixerCompile();
 }
 
 
@@ -362,8 +403,7 @@ void writeServos(void) {
 }
 
 void servoMixer(void) {
-    int16_t input[INPUT_SOURCE_COUNT]; // Range [-500:+500]
-    static int16_t currentOutput[MAX_SERVO_RULES];
+    int16_t *input = servoMixerInput;
     if (FLIGHT_MODE(PASSTHRU_MODE)) {
         // Direct passthru from RX
         input[INPUT_STABILIZED_ROLL] = rcCommand[ROLL];
@@ -399,27 +439,28 @@ void servoMixer(void) {
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
         servo[i] = 0;
     }
-    // mix servos according to rules
-    for (int i = 0; i < servoRuleCount; i++) {
-        // consider rule if no box assigned or box is active
-        if (currentServoMixer[i].box == 0 || IS_RC_MODE_ACTIVE(BOXSERVO1 + currentServoMixer[i].box - 1)) {
-            uint8_t target = currentServoMixer[i].targetChannel;
-            uint8_t from = currentServoMixer[i].inputSource;
-            uint16_t servo_width = servoParams(target)->max - servoParams(target)->min;
-            int16_t min = currentServoMixer[i].min * servo_width / 100 - servo_width / 2;
-            int16_t max = currentServoMixer[i].max * servo_width / 100 - servo_width / 2;
-            if (currentServoMixer[i].speed == 0)
-                currentOutput[i] = input[from];
-            else {
-                if (currentOutput[i] < input[from])
-                    currentOutput[i] = constrain(currentOutput[i] + currentServoMixer[i].speed, currentOutput[i], input[from]);
-                else if (currentOutput[i] > input[from])
-                    currentOutput[i] = constrain(currentOutput[i] - currentServoMixer[i].speed, input[from], currentOutput[i]);
-            }
-            servo[target] += servoDirection(target, from) * constrain(((int32_t)currentOutput[i] * currentServoMixer[i].rate) / 100, min, max);
-        } else {
-            currentOutput[i] = 0;
+    // mix servos according to rules, with the box checks done once for all of them
+    uint8_t activeBoxes = 1 << 0;
+    for (int box = 1; box <= MAX_SERVO_BOXES; box++) {
+        if (IS_RC_MODE_ACTIVE(BOXSERVO1 + box - 1)) {
+            activeBoxes |= 1 << box;
+        }
+    }
+    for (int i = 0; i < servoMixerOpCount; i++) {
+        servoMixerOp_t *op = &servoMixerOps[i];
+        if (!(activeBoxes & op->boxMask)) {
+            op->output = 0;
+            continue;
+        }
+        const int16_t in = *op->input;
+        if (op->speed == 0) {
+            op->output = in;
+        } else if (op->output < in) {
+            op->output = constrain(op->output + op->speed, op->output, in);
+        } else if (op->output > in) {
+            op->output = constrain(op->output - op->speed, in, op->output);
         }
+        servo[op->target] += op->direction * constrain(((int32_t)op->output * op->rate) / 100, op->min, op->max);
     }
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
         servo[i] = ((int32_t)servoParams(i)->rate * servo[i]) / 100L;
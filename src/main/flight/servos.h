@@ -139,6 +139,7 @@ bool isMixerUsingServos(void);
 void writeServos(void);
 void servoMixerLoadMix(int index);
 void loadCustomServoMixer(void);
+void servoMixerCompile(void);
 int servoDirection(int servoIndex, int fromChannel);
 void servoConfigureOutput(void);
 void servosInit(void);
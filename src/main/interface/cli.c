@@ -41,6 +41,9 @@ extern uint8_t __config_end;
 #include "blackbox/blackbox.h"
 
 #include "build/build_config.h"
+#include "build/cycle_bench.h"
+#include "build/cycle_profile.h"
+#include "build/loop_jitter.h"
 #include "build/debug.h"
 #include "build/version.h"
 
@@ -49,6 +52,7 @@ extern uint8_t __config_end;
 #include "common/axis.h"
 #include "common/color.h"
 #include "common/maths.h"
+#include "common/memory.h"
 #include "common/printf.h"
 #include "common/strtol.h"
 #include "common/time.h"
@@ -95,6 +99,7 @@ extern uint8_t __config_end;
 #include "fc/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/fc_core.h"
+#include "fc/fc_init.h"
 #include "fc/fc_rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -190,6 +195,23 @@ static bool configIsInCopy = false;
 static int8_t pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
 static int8_t rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
 
+// dump and diff are written a section at a time by cliProcess(), as fast as the port takes them
+typedef struct cliDumpState_s {
+    bool active;
+    uint8_t dumpMask;
+    uint8_t section;                    // next entry of cliDumpSections[]
+    uint8_t profileIndex;               // next profile when all pid or rate profiles are dumped
+    bool headerDone;                    // the header of the settings being dumped is out
+    uint16_t valueIndex;                // next valueTable entry of the settings being dumped
+    const pgRegistry_t *pg;             // group of the last setting looked at
+    bool pgEqualsDefault;
+} cliDumpState_t;
+
+static cliDumpState_t cliDumpState;
+
+// tx buffer room needed for the next line of a dump, ports with small buffers need half of theirs
+#define CLI_DUMP_TX_FREE_MIN 64U
+
 #if defined(USE_BOARD_INFO)
 static bool boardInformationUpdated = false;
 #if defined(USE_SIGNATURE)
@@ -254,20 +276,28 @@ static const char * const *sensorHardwareNames[] = {
 };
 #endif // USE_SENSOR_NAMES
 
-static void backupPgConfig(const pgRegistry_t *pg) {
-    memcpy(pg->copy, pg->address, pg->size);
+static bool backupPgConfig(const pgRegistry_t *pg) {
+    uint8_t *copy = pgCopy(pg);
+    if (!copy) {
+        return false;
+    }
+    memcpy(copy, pg->address, pgSize(pg));
+    return true;
 }
 
 static void restorePgConfig(const pgRegistry_t *pg) {
-    memcpy(pg->address, pg->copy, pg->size);
+    memcpy(pg->address, pgCopy(pg), pgSize(pg));
 }
 
-static void backupConfigs(void) {
+static bool backupConfigs(void) {
     // make copies of configs to do differencing
     PG_FOREACH(pg) {
-        backupPgConfig(pg);
+        if (!backupPgConfig(pg)) {
+            return false;
+        }
     }
     configIsInCopy = true;
+    return true;
 }
 
 static void restoreConfigs(void) {
@@ -277,12 +307,6 @@ static void restoreConfigs(void) {
     configIsInCopy = false;
 }
 
-static void backupAndResetConfigs(void) {
-    backupConfigs();
-    // reset all configs to defaults to do differencing
-    resetConfigs();
-}
-
 void cliPrint(const char *str) {
     if (!cliMode) {
         return;
@@ -405,6 +429,17 @@ static void cliPrintErrorLinef(const char *format, ...) {
     cliPrintLinefeed();
 }
 
+static bool backupAndResetConfigs(void) {
+    // the copies take what the boot time arena has left, which flight code may have grown into
+    if (!backupConfigs()) {
+        cliPrintErrorLinef("NOT ENOUGH FREE RAM TO COPY THE CONFIGURATION");
+        return false;
+    }
+    // reset all configs to defaults to do differencing
+    resetConfigs();
+    return true;
+}
+
 
 static void printValuePointer(const clivalue_t *var, const void *valuePointer, bool full) {
     if ((var->type & VALUE_MODE_MASK) == MODE_ARRAY) {
@@ -540,7 +575,7 @@ static uint16_t getValueOffset(const clivalue_t *value) {
 void *cliGetValuePointer(const clivalue_t *value) {
     const pgRegistry_t* rec = pgFind(value->pgn);
     if (configIsInCopy) {
-        return CONST_CAST(void *, rec->copy + getValueOffset(value));
+        return CONST_CAST(void *, pgCopy(rec) + getValueOffset(value));
     } else {
         return CONST_CAST(void *, rec->address + getValueOffset(value));
     }
@@ -551,38 +586,61 @@ const void *cliGetDefaultPointer(const clivalue_t *value) {
     return rec->address + getValueOffset(value);
 }
 
-static void dumpPgValue(const clivalue_t *value, uint8_t dumpMask) {
-    const pgRegistry_t *pg = pgFind(value->pgn);
-#ifdef DEBUG
-    if (!pg) {
-        cliPrintLinef("VALUE %s ERROR", value->name);
-        return; // if it's not found, the pgn shouldn't be in the value table!
-    }
-#endif
+static void dumpPgValue(const clivalue_t *value, const pgRegistry_t *pg, uint8_t dumpMask) {
     const char *format = "set %s = ";
     const char *defaultFormat = "#set %s = ";
     const int valueOffset = getValueOffset(value);
-    const bool equalsDefault = valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
+    const bool equalsDefault = valuePtrEqualsDefault(value, pgCopy(pg) + valueOffset, pg->address + valueOffset);
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
+        char name[CLIVALUE_NAME_LENGTH];
+        clivalueName(value, name);
         if (dumpMask & SHOW_DEFAULTS && !equalsDefault) {
-            cliPrintf(defaultFormat, value->name);
+            cliPrintf(defaultFormat, name);
             printValuePointer(value, (uint8_t*)pg->address + valueOffset, false);
             cliPrintLinefeed();
         }
-        cliPrintf(format, value->name);
-        printValuePointer(value, pg->copy + valueOffset, false);
+        cliPrintf(format, name);
+        printValuePointer(value, pgCopy(pg) + valueOffset, false);
         cliPrintLinefeed();
     }
 }
 
-static void dumpAllValues(uint16_t valueSection, uint8_t dumpMask) {
-    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        const clivalue_t *value = &valueTable[i];
-        bufWriterFlush(cliWriter);
-        if ((value->type & VALUE_SECTION_MASK) == valueSection) {
-            dumpPgValue(value, dumpMask);
+static bool cliDumpHasRoom(void) {
+    return serialTxBytesFree(cliPort) >= MIN(CLI_DUMP_TX_FREE_MIN, cliPort->txBufferSize / 2);
+}
+
+// Print the settings of valueSection from cliDumpState.valueIndex on while the port has room, true once all are out
+static bool dumpAllValues(uint16_t valueSection, uint8_t dumpMask) {
+    // Settings of the same group sit next to each other in valueTable, so each group is looked up and compared
+    // against its defaults once, and a diff skips every setting of a group that is still all defaults
+    for (; cliDumpState.valueIndex < valueTableEntryCount; cliDumpState.valueIndex++) {
+        const clivalue_t *value = &valueTable[cliDumpState.valueIndex];
+        if ((value->type & VALUE_SECTION_MASK) != valueSection) {
+            continue;
+        }
+        if (!cliDumpState.pg || pgN(cliDumpState.pg) != value->pgn) {
+            cliDumpState.pg = pgFind(value->pgn);
+#ifdef DEBUG
+            if (!cliDumpState.pg) {
+                char name[CLIVALUE_NAME_LENGTH];
+                cliPrintLinef("VALUE %s ERROR", clivalueName(value, name));
+                continue; // if it's not found, the pgn shouldn't be in the value table!
+            }
+#endif
+            cliDumpState.pgEqualsDefault = memcmp(pgCopy(cliDumpState.pg), cliDumpState.pg->address, pgSize(cliDumpState.pg)) == 0;
+        }
+        if ((dumpMask & DO_DIFF) && cliDumpState.pgEqualsDefault) {
+            continue;
         }
+        if (!cliDumpHasRoom()) {
+            return false;
+        }
+        bufWriterFlush(cliWriter);
+        dumpPgValue(value, cliDumpState.pg, dumpMask);
     }
+    cliDumpState.valueIndex = 0;
+    cliDumpState.pg = NULL;
+    return true;
 }
 
 static void cliPrintVar(const clivalue_t *var, bool full) {
@@ -926,6 +984,7 @@ static void cliAux(char *cmdline) {
             } else if (validArgumentCount != 6) {
                 memset(mac, 0, sizeof(modeActivationCondition_t));
             }
+            rcControlsInit();
             cliPrintLinef( "aux %u %u %u %u %u %u %u",
                            i,
                            mac->modeId,
@@ -1694,6 +1753,7 @@ static void cliServo(char *cmdline) {
         servo->middle = arguments[MIDDLE];
         servo->rate = arguments[RATE];
         servo->forwardFromChannel = arguments[FORWARD];
+        servoMixerCompile();
         cliDumpPrintLinef(0, false, format,
                           i,
                           servo->min,
@@ -1754,6 +1814,7 @@ static void cliServoMix(char *cmdline) {
         for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
             servoParamsMutable(i)->reversedSources = 0;
         }
+        servoMixerCompile();
     } else if (strncasecmp(cmdline, "load", 4) == 0) {
         const char *ptr = nextArg(cmdline);
         if (ptr) {
@@ -1806,6 +1867,7 @@ static void cliServoMix(char *cmdline) {
             } else {
                 servoParamsMutable(args[SERVO])->reversedSources &= ~(1 << args[INPUT]);
             }
+            servoMixerCompile();
         } else {
             cliShowParseError();
             return;
@@ -1915,6 +1977,12 @@ static void cliFlashInfo(char *cmdline) {
     UNUSED(cmdline);
     cliPrintLinef("Flash sectors=%u, sectorSize=%u, pagesPerSector=%u, pageSize=%u, totalSize=%u, usedSize=%u",
                   layout->sectors, layout->sectorSize, layout->pagesPerSector, layout->pageSize, layout->totalSize, flashfsGetOffset());
+    for (int i = 0; i < flashfsTocCount(); i++) {
+        flashfsTocEntry_t entry;
+        if (flashfsTocRead(i, &entry)) {
+            cliPrintLinef("Log %d: start=%u, length=%u, time=%u", i + 1, entry.start, entry.length, entry.timestamp);
+        }
+    }
 }
 
 
@@ -2664,11 +2732,11 @@ static void cliPrintGyroRegisters(uint8_t whichSensor) {
 
 static void cliDumpGyroRegisters(char *cmdline) {
 #ifdef USE_DUAL_GYRO
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || GYRO_CONFIG_USES_BOTH(gyroConfig()->gyro_to_use)) {
         cliPrintLinef("\r\n# Gyro 1");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_1);
     }
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || GYRO_CONFIG_USES_BOTH(gyroConfig()->gyro_to_use)) {
         cliPrintLinef("\r\n# Gyro 2");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_2);
     }
@@ -3094,30 +3162,45 @@ static void cliRateProfile(char *cmdline) {
     }
 }
 
-static void cliDumpPidProfile(uint8_t pidProfileIndex, uint8_t dumpMask) {
+// The profile index stays selected while the settings of the profile are still being written
+static bool cliDumpPidProfile(uint8_t pidProfileIndex, uint8_t dumpMask) {
     if (pidProfileIndex >= PID_PROFILE_COUNT) {
         // Faulty values
-        return;
+        return true;
     }
     pidProfileIndexToUse = pidProfileIndex;
-    cliPrintHashLine("profile");
-    cliProfile("");
-    cliPrintLinefeed();
-    dumpAllValues(PROFILE_VALUE, dumpMask);
+    if (!cliDumpState.headerDone) {
+        cliPrintHashLine("profile");
+        cliProfile("");
+        cliPrintLinefeed();
+        cliDumpState.headerDone = true;
+    }
+    if (!dumpAllValues(PROFILE_VALUE, dumpMask)) {
+        return false;
+    }
+    cliDumpState.headerDone = false;
     pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+    return true;
 }
 
-static void cliDumpRateProfile(uint8_t rateProfileIndex, uint8_t dumpMask) {
+static bool cliDumpRateProfile(uint8_t rateProfileIndex, uint8_t dumpMask) {
     if (rateProfileIndex >= CONTROL_RATE_PROFILE_COUNT) {
         // Faulty values
-        return;
+        return true;
     }
     rateProfileIndexToUse = rateProfileIndex;
-    cliPrintHashLine("rateprofile");
-    cliRateProfile("");
-    cliPrintLinefeed();
-    dumpAllValues(PROFILE_RATE_VALUE, dumpMask);
+    if (!cliDumpState.headerDone) {
+        cliPrintHashLine("rateprofile");
+        cliRateProfile("");
+        cliPrintLinefeed();
+        cliDumpState.headerDone = true;
+    }
+    if (!dumpAllValues(PROFILE_RATE_VALUE, dumpMask)) {
+        return false;
+    }
+    cliDumpState.headerDone = false;
     rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+    return true;
 }
 
 static void cliSave(char *cmdline) {
@@ -3158,9 +3241,9 @@ void cliPrintVarDefault(const clivalue_t *value) {
     if (pg) {
         const char *defaultFormat = "Default value: ";
         const int valueOffset = getValueOffset(value);
-        const bool equalsDefault = valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
+        const bool equalsDefault = valuePtrEqualsDefault(value, pgCopy(pg) + valueOffset, pg->address + valueOffset);
         if (!equalsDefault) {
-            cliPrintf(defaultFormat, value->name);
+            cliPrint(defaultFormat);
             printValuePointer(value, (uint8_t*)pg->address + valueOffset, false);
             cliPrintLinefeed();
         }
@@ -3172,14 +3255,19 @@ STATIC_UNIT_TESTED void cliGet(char *cmdline) {
     int matchedCommands = 0;
     pidProfileIndexToUse = getCurrentPidProfileIndex();
     rateProfileIndexToUse = getCurrentControlRateProfileIndex();
-    backupAndResetConfigs();
+    if (!backupAndResetConfigs()) {
+        pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+        rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+        return;
+    }
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        if (strcasestr(valueTable[i].name, cmdline)) {
+        char name[CLIVALUE_NAME_LENGTH];
+        if (strcasestr(clivalueName(&valueTable[i], name), cmdline)) {
             val = &valueTable[i];
             if (matchedCommands > 0) {
                 cliPrintLinefeed();
             }
-            cliPrintf("%s = ", valueTable[i].name);
+            cliPrintf("%s = ", name);
             cliPrintVar(val, 0);
             cliPrintLinefeed();
             switch (val->type & VALUE_SECTION_MASK) {
@@ -3221,8 +3309,9 @@ static const char * valueModeMask[] = {
 
 void cliPrintValueJson(int32_t i) {
     const clivalue_t *var = &valueTable[i];
+    char name[CLIVALUE_NAME_LENGTH];
     cliPrintf("\"%s\":{\"scope\":\"%s\",\"type\":\"%s\",\"mode\":\"%s\",\"current\":\"",
-              var->name,
+              clivalueName(var, name),
               valueSectionMask[((var->type & VALUE_SECTION_MASK) >> VALUE_SECTION_OFFSET)],
               valueTypeMask[((var->type & VALUE_TYPE_MASK) >> VALUE_TYPE_OFFSET)],
               valueModeMask[((var->type & VALUE_MODE_MASK) >> VALUE_MODE_OFFSET)]);
@@ -3347,7 +3436,7 @@ static void dumpProfileValueJson(uint16_t valueSection) {
 
 static void cliPidProfilesJson() {
     cliPrintf(PROFILE_JSON_STRING, "pid", getCurrentPidProfileIndex());
-    const uint8_t saved = systemConfig_Copy.pidProfileIndex;
+    const uint8_t saved = systemConfig()->pidProfileIndex;
     for (uint32_t i = 0; i < PID_PROFILE_COUNT; i++) {
         changePidProfile(i);
         if (i > 0) {
@@ -3361,7 +3450,7 @@ static void cliPidProfilesJson() {
 
 static void cliRateProfilesJson() {
     cliPrintf(PROFILE_JSON_STRING, "rate", getCurrentControlRateProfileIndex());
-    const uint8_t saved = systemConfig_Copy.activeRateProfile;
+    const uint8_t saved = systemConfig()->activeRateProfile;
     for (uint32_t i = 0; i < CONTROL_RATE_PROFILE_COUNT; i++) {
         changeControlRateProfile(i);
         if (i > 0) {
@@ -3384,7 +3473,7 @@ void cliConfig(char *cmdline) {
     }
     cliPidProfilesJson();
     cliRateProfilesJson();
-    printFeatureJson(&featureConfig_Copy);
+    printFeatureJson(featureConfig());
     printSerialJson(serialConfig());
     printAuxJson(modeActivationConditions(0));
     printResourceJson();
@@ -3409,6 +3498,55 @@ static uint8_t getWordLength(char *bufBegin, char *bufEnd) {
     return bufEnd - bufBegin;
 }
 
+// Sort valueTableIndex by name (shell sort, it only runs once)
+static void cliSortValueTableIndex(void) {
+    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
+        valueTableIndex[i] = i;
+    }
+    for (uint32_t gap = valueTableEntryCount / 2; gap > 0; gap /= 2) {
+        for (uint32_t i = gap; i < valueTableEntryCount; i++) {
+            const uint16_t index = valueTableIndex[i];
+            char name[CLIVALUE_NAME_LENGTH];
+            char otherName[CLIVALUE_NAME_LENGTH];
+            clivalueName(&valueTable[index], name);
+            uint32_t j = i;
+            while (j >= gap && strcasecmp(clivalueName(&valueTable[valueTableIndex[j - gap]], otherName), name) > 0) {
+                valueTableIndex[j] = valueTableIndex[j - gap];
+                j -= gap;
+            }
+            valueTableIndex[j] = index;
+        }
+    }
+}
+
+// Binary search valueTableIndex for the setting named by the first nameLength characters of name
+static const clivalue_t *cliFindValue(const char *name, uint8_t nameLength) {
+    static bool indexSorted = false;
+    if (!indexSorted) {
+        cliSortValueTableIndex();
+        indexSorted = true;
+    }
+    uint32_t low = 0;
+    uint32_t high = valueTableEntryCount;
+    while (low < high) {
+        const uint32_t mid = (low + high) / 2;
+        char valueName[CLIVALUE_NAME_LENGTH];
+        const clivalue_t *value = &valueTable[valueTableIndex[mid]];
+        int cmp = strncasecmp(name, clivalueName(value, valueName), nameLength);
+        if (cmp == 0 && valueName[nameLength]) {
+            cmp = -1; // name is a prefix of this setting, so it sorts before it
+        }
+        if (cmp == 0) {
+            return value;
+        } else if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return NULL;
+}
+
 STATIC_UNIT_TESTED void cliSet(char *cmdline) {
     const uint32_t len = strlen(cmdline);
     char *eqptr;
@@ -3416,7 +3554,8 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline) {
         cliPrintLine("Current settings: ");
         for (uint32_t i = 0; i < valueTableEntryCount; i++) {
             const clivalue_t *val = &valueTable[i];
-            cliPrintf("%s = ", valueTable[i].name);
+            char name[CLIVALUE_NAME_LENGTH];
+            cliPrintf("%s = ", clivalueName(val, name));
             cliPrintVar(val, len); // when len is 1 (when * is passed as argument), it will print min/max values as well, for gui
             cliPrintLinefeed();
         }
@@ -3426,100 +3565,98 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline) {
         // skip the '=' and any ' ' characters
         eqptr++;
         eqptr = skipSpace(eqptr);
-        for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-            const clivalue_t *val = &valueTable[i];
-            // ensure exact match when setting to prevent setting variables with shorter names
-            if (strncasecmp(cmdline, val->name, strlen(val->name)) == 0 && variableNameLength == strlen(val->name)) {
-                bool valueChanged = false;
-                int16_t value  = 0;
-                switch (val->type & VALUE_MODE_MASK) {
-                case MODE_DIRECT: {
-                    int16_t value = atoi(eqptr);
-                    if (value >= val->config.minmax.min && value <= val->config.minmax.max) {
+        const clivalue_t *val = cliFindValue(cmdline, variableNameLength);
+        if (val) {
+            bool valueChanged = false;
+            int16_t value  = 0;
+            switch (val->type & VALUE_MODE_MASK) {
+            case MODE_DIRECT: {
+                int16_t value = atoi(eqptr);
+                if (value >= val->config.minmax.min && value <= val->config.minmax.max) {
+                    cliSetVar(val, value);
+                    valueChanged = true;
+                }
+            }
+            break;
+            case MODE_LOOKUP:
+            case MODE_BITSET: {
+                int tableIndex;
+                if ((val->type & VALUE_MODE_MASK) == MODE_BITSET) {
+                    tableIndex = TABLE_OFF_ON;
+                } else {
+                    tableIndex = val->config.lookup.tableIndex;
+                }
+                const lookupTableEntry_t *tableEntry = &lookupTables[tableIndex];
+                bool matched = false;
+                for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
+                    matched = tableEntry->values[tableValueIndex] && strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
+                    if (matched) {
+                        value = tableValueIndex;
                         cliSetVar(val, value);
                         valueChanged = true;
                     }
                 }
-                break;
-                case MODE_LOOKUP:
-                case MODE_BITSET: {
-                    int tableIndex;
-                    if ((val->type & VALUE_MODE_MASK) == MODE_BITSET) {
-                        tableIndex = TABLE_OFF_ON;
-                    } else {
-                        tableIndex = val->config.lookup.tableIndex;
+            }
+            break;
+            case MODE_ARRAY: {
+                const uint8_t arrayLength = val->config.array.length;
+                char *valPtr = eqptr;
+                int i = 0;
+                while (i < arrayLength && valPtr != NULL) {
+                    // skip spaces
+                    valPtr = skipSpace(valPtr);
+                    // process substring starting at valPtr
+                    // note: no need to copy substrings for atoi()
+                    //       it stops at the first character that cannot be converted...
+                    switch (val->type & VALUE_TYPE_MASK) {
+                    default:
+                    case VAR_UINT8: {
+                        // fetch data pointer
+                        uint8_t *data = (uint8_t *)cliGetValuePointer(val) + i;
+                        // store value
+                        *data = (uint8_t)atoi((const char*) valPtr);
                     }
-                    const lookupTableEntry_t *tableEntry = &lookupTables[tableIndex];
-                    bool matched = false;
-                    for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
-                        matched = tableEntry->values[tableValueIndex] && strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
-                        if (matched) {
-                            value = tableValueIndex;
-                            cliSetVar(val, value);
-                            valueChanged = true;
-                        }
+                    break;
+                    case VAR_INT8: {
+                        // fetch data pointer
+                        int8_t *data = (int8_t *)cliGetValuePointer(val) + i;
+                        // store value
+                        *data = (int8_t)atoi((const char*) valPtr);
                     }
-                }
-                break;
-                case MODE_ARRAY: {
-                    const uint8_t arrayLength = val->config.array.length;
-                    char *valPtr = eqptr;
-                    int i = 0;
-                    while (i < arrayLength && valPtr != NULL) {
-                        // skip spaces
-                        valPtr = skipSpace(valPtr);
-                        // process substring starting at valPtr
-                        // note: no need to copy substrings for atoi()
-                        //       it stops at the first character that cannot be converted...
-                        switch (val->type & VALUE_TYPE_MASK) {
-                        default:
-                        case VAR_UINT8: {
-                            // fetch data pointer
-                            uint8_t *data = (uint8_t *)cliGetValuePointer(val) + i;
-                            // store value
-                            *data = (uint8_t)atoi((const char*) valPtr);
-                        }
-                        break;
-                        case VAR_INT8: {
-                            // fetch data pointer
-                            int8_t *data = (int8_t *)cliGetValuePointer(val) + i;
-                            // store value
-                            *data = (int8_t)atoi((const char*) valPtr);
-                        }
-                        break;
-                        case VAR_UINT16: {
-                            // fetch data pointer
-                            uint16_t *data = (uint16_t *)cliGetValuePointer(val) + i;
-                            // store value
-                            *data = (uint16_t)atoi((const char*) valPtr);
-                        }
-                        break;
-                        case VAR_INT16: {
-                            // fetch data pointer
-                            int16_t *data = (int16_t *)cliGetValuePointer(val) + i;
-                            // store value
-                            *data = (int16_t)atoi((const char*) valPtr);
-                        }
-                        break;
-                        }
-                        // find next comma (or end of string)
-                        valPtr = strchr(valPtr, ',') + 1;
-                        i++;
+                    break;
+                    case VAR_UINT16: {
+                        // fetch data pointer
+                        uint16_t *data = (uint16_t *)cliGetValuePointer(val) + i;
+                        // store value
+                        *data = (uint16_t)atoi((const char*) valPtr);
                     }
+                    break;
+                    case VAR_INT16: {
+                        // fetch data pointer
+                        int16_t *data = (int16_t *)cliGetValuePointer(val) + i;
+                        // store value
+                        *data = (int16_t)atoi((const char*) valPtr);
+                    }
+                    break;
+                    }
+                    // find next comma (or end of string)
+                    valPtr = strchr(valPtr, ',') + 1;
+                    i++;
                 }
-                    // mark as changed
-                valueChanged = true;
-                break;
-                }
-                if (valueChanged) {
-                    cliPrintf("%s set to ", val->name);
-                    cliPrintVar(val, 0);
-                } else {
-                    cliPrintErrorLinef("Invalid value");
-                    cliPrintVarRange(val);
-                }
-                return;
             }
+                // mark as changed
+            valueChanged = true;
+            break;
+            }
+            if (valueChanged) {
+                char name[CLIVALUE_NAME_LENGTH];
+                cliPrintf("%s set to ", clivalueName(val, name));
+                cliPrintVar(val, 0);
+            } else {
+                cliPrintErrorLinef("Invalid value");
+                cliPrintVarRange(val);
+            }
+            return;
         }
         cliPrintErrorLinef("Invalid name");
     } else {
@@ -3528,9 +3665,18 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline) {
     }
 }
 
+static const char * const initStepNames[INIT_STEP_COUNT] = {
+    "config", "timers", "motors", "gyro", "mag", "baro", "sensors", "imu", "ready"
+};
+
 static void cliStatus(char *cmdline) {
     UNUSED(cmdline);
     cliPrintLinef("System Uptime: %d seconds", millis() / 1000);
+    cliPrint("Boot (ms):");
+    for (int i = 0; i < INIT_STEP_COUNT; i++) {
+        cliPrintf(" %s=%d", initStepNames[i], initStepTimeUs[i] / 1000);
+    }
+    cliPrintLine(initWarmBoot ? " (warm)" : "");
 #ifdef USE_RTC_TIME
     char buf[FORMATTED_DATE_TIME_BUFSIZE];
     dateTime_t dt;
@@ -3582,6 +3728,15 @@ static void cliStatus(char *cmdline) {
     cliPrintf("Stack used: %d, ", stackUsedSize());
 #endif
     cliPrintLinef("Stack size: %d, Stack address: 0x%x", stackTotalSize(), stackHighMem());
+#ifdef USE_STACK_CHECK_IRQ
+    // deepest stack seen on entry to an interrupt of each preemption priority
+    cliPrint("Stack at IRQ entry:");
+    for (int level = 0; level < STACK_IRQ_LEVEL_COUNT; level++) {
+        cliPrintf(" %d:%d", level, stackIrqUsedSize(level));
+    }
+    cliPrintLinefeed();
+#endif
+    cliPrintLinef("Arena used: %d, free: %d", (int)memGetUsedBytes(), (int)memGetAvailableBytes());
 #ifdef EEPROM_IN_RAM
 #define CONFIG_SIZE EEPROM_SIZE
 #else
@@ -3591,8 +3746,28 @@ static void cliStatus(char *cmdline) {
     const int gyroRate = getTaskDeltaTime(TASK_GYROPID) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_GYROPID)));
     const int rxRate = currentRxRefreshRate == 0 ? 0 : (int)(1000000.0f / ((float)currentRxRefreshRate));
     const int systemRate = getTaskDeltaTime(TASK_SYSTEM) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_SYSTEM)));
-    cliPrintLinef("CPU:%d%%, cycle time: %d, GYRO rate: %d, RX rate: %d, System rate: %d",
-                  constrain(averageSystemLoadPercent, 0, 100), getTaskDeltaTime(TASK_GYROPID), gyroRate, rxRate, systemRate);
+    cliPrintLinef("CPU:%d%%, busy: %d%%, cycle time: %d, GYRO rate: %d, RX rate: %d, System rate: %d",
+                  constrain(averageSystemLoadPercent, 0, 100), averageCpuLoadPercent, getTaskDeltaTime(TASK_GYROPID), gyroRate, rxRate, systemRate);
+    const rcLatencyStats_t *rcLatency = getRcLatencyStats();
+    if (rcLatency->count) {
+        cliPrintLinef("RX to motor latency: min %dus, avg %dus, max %dus over %d frames",
+                      rcLatency->minUs, rcLatency->avgUs, rcLatency->maxUs, rcLatency->count);
+    }
+#ifdef USE_ESC_SENSOR
+    if (feature(FEATURE_ESC_SENSOR) && isEscSensorActive()) {
+        const timeUs_t currentTimeUs = micros();
+        cliPrint("ESC sensor data age (ms):");
+        for (int i = 0; i < getMotorCount(); i++) {
+            const uint32_t ageUs = getEscSensorDataAgeUs(i, currentTimeUs);
+            if (ageUs == UINT32_MAX) {
+                cliPrint(" -");
+            } else {
+                cliPrintf(" %d", (int)(ageUs / 1000));
+            }
+        }
+        cliPrintLinefeed();
+    }
+#endif
     cliPrint("Arming disable flags:");
     armingDisableFlags_e flags = getArmingDisableFlags();
     while (flags) {
@@ -3601,11 +3776,100 @@ static void cliStatus(char *cmdline) {
         cliPrintf(" %s", armingDisableFlagNames[bitpos]);
     }
     cliPrintLinefeed();
+#ifdef USE_CYCLE_BENCH
+    if (isLoopRateOverBudget()) {
+        cliPrintLine("Loop rate is over the budget looprate measured");
+    }
+#endif
 }
 
 #ifndef SKIP_TASK_STATISTICS
+#ifdef USE_CYCLE_PROFILE
+static void cliPrintCycleProfileInfo(const cycleProfileInfo_t *info) {
+    cliPrintLinef("%9d %7d %7d %7d %7d", info->count, info->minCycles, info->averageCycles, info->maxCycles, info->p99Cycles);
+}
+
+static void cliTasksCycles(char *cmdline) {
+    if (strncasecmp(cmdline, "reset", 5) == 0) {
+        cycleProfileReset();
+        mspCommandStatsReset();
+        cliPrintLine("Cycle profile reset");
+        return;
+    }
+    if (!systemConfig()->cycle_profile) {
+        cliPrintLine("Cycle profiling is off, set cycle_profile = ON, save and reboot");
+        return;
+    }
+    cliPrintLinef("Cycles at %dMHz           count     min     avg     max     p99", SystemCoreClock / 1000000);
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            cycleProfileInfo_t info;
+            getTaskCycleInfo(taskId, &info);
+            cliPrintf("%02d - (%15s) ", taskId, taskInfo.taskName);
+            cliPrintCycleProfileInfo(&info);
+        }
+    }
+    for (cycleSection_e section = 0; section < CYCLE_SECTION_COUNT; section++) {
+        cycleProfileInfo_t info;
+        getSectionCycleInfo(section, &info);
+        cliPrintf("   - (%15s) ", getCycleSectionName(section));
+        cliPrintCycleProfileInfo(&info);
+    }
+    const cycleLoad_t *load = getCycleLoad();
+    cliPrintLinef("CPU busy %d.%d%%, interrupts %d.%d%%", load->busyPermille / 10, load->busyPermille % 10, load->isrPermille / 10, load->isrPermille % 10);
+    for (cycleIsr_e isr = 0; isr < CYCLE_ISR_COUNT; isr++) {
+        cliPrintLinef("   - (%11s ISR) %5d.%1d%%", getCycleIsrName(isr), load->isrSharePermille[isr] / 10, load->isrSharePermille[isr] % 10);
+    }
+    const mspCommandStats_t *stats;
+    for (int i = 0; (stats = getMspCommandStats(i)); i++) {
+        cliPrintLinef("   - (MSP cmd %7d) %9d %7d %7d %7d       -", stats->cmd, stats->count, stats->minCycles,
+                      (uint32_t)(stats->totalCycles / stats->count), stats->maxCycles);
+    }
+}
+#endif
+
+#ifdef USE_LOOP_JITTER
+static void cliTasksJitter(char *cmdline) {
+    if (strncasecmp(cmdline, "reset", 5) == 0) {
+        loopJitterReset(gyro.targetLooptime);
+        cliPrintLine("Loop jitter reset");
+        return;
+    }
+    const loopJitter_t *jitter = getLoopJitter();
+    if (jitter->count == 0) {
+        cliPrintLine("No loop jitter recorded, it is collected while armed");
+        return;
+    }
+    cliPrintLinef("Looptime %dus, %d loops, deviation min %dus max %dus",
+                  jitter->targetLooptimeUs, jitter->count, jitter->minDeviationUs, jitter->maxDeviationUs);
+    for (int i = 0; i < LOOP_JITTER_BUCKET_COUNT; i++) {
+        if (jitter->buckets[i]) {
+            const int permille = (uint64_t)jitter->buckets[i] * 1000 / jitter->count;
+            const char *edge = i == 0 ? "<=" : i == LOOP_JITTER_BUCKET_COUNT - 1 ? ">=" : "  ";
+            cliPrintLinef("%s%3dus %9d %3d.%1d%%", edge, loopJitterBucketDeviationUs(i), jitter->buckets[i], permille / 10, permille % 10);
+        }
+    }
+}
+#endif
+
 static void cliTasks(char *cmdline) {
+#ifdef USE_CYCLE_PROFILE
+    if (strncasecmp(cmdline, "cycles", 6) == 0) {
+        cliTasksCycles(skipSpace(cmdline + 6));
+        return;
+    }
+#endif
+#ifdef USE_LOOP_JITTER
+    if (strncasecmp(cmdline, "jitter", 6) == 0) {
+        cliTasksJitter(skipSpace(cmdline + 6));
+        return;
+    }
+#endif
+#if !defined(USE_CYCLE_PROFILE) && !defined(USE_LOOP_JITTER)
     UNUSED(cmdline);
+#endif
     int maxLoadSum = 0;
     int averageLoadSum = 0;
 #ifndef MINIMAL_CLI
@@ -3662,6 +3926,82 @@ static void cliTasks(char *cmdline) {
 }
 #endif
 
+#ifdef USE_CYCLE_BENCH
+static void cliBench(char *cmdline) {
+    if (ARMING_FLAG(ARMED)) {
+        cliPrintErrorLinef("Can't bench while armed");
+        return;
+    }
+    uint32_t iterations = CYCLE_BENCH_DEFAULT_ITERATIONS;
+    if (!isEmpty(cmdline)) {
+        const int thousands = atoi(cmdline);
+        if (thousands < 1 || thousands > CYCLE_BENCH_MAX_ITERATIONS / 1000) {
+            cliShowArgumentRangeError("iterations", 1, CYCLE_BENCH_MAX_ITERATIONS / 1000);
+            return;
+        }
+        iterations = thousands * 1000;
+    }
+    cliPrintLinef("Cycles/call at %dMHz, %d calls", SystemCoreClock / 1000000, iterations);
+    for (int i = 0; i < cycleBenchCount(); i++) {
+        cliPrintLinef("%15s %7d", cycleBenchName(i), cycleBenchRun(i, iterations));
+    }
+}
+
+static uint16_t cliLoopRateTenthsUs(uint32_t cycles) {
+    const uint32_t clockMHz = SystemCoreClock / 1000000;
+    return MIN((cycles * 10 + clockMHz - 1) / clockMHz, UINT16_MAX);
+}
+
+static void cliPrintLoopRate(const char *name, const loopRate_t *rate, const loopWcet_t *wcet) {
+    const uint32_t load = loopRateLoadPermille(rate, wcet);
+    cliPrintLinef("%-11s gyro_sync_denom %2d, pid_process_denom %2d, pid loop %4dus, load %3d.%1d%%", name,
+                  rate->gyroSyncDenom, rate->pidProcessDenom, loopRatePidLooptimeUs(rate), load / 10, load % 10);
+}
+
+// Worst case of the configured gyro and pid path, kept in loop_wcet_gyro and loop_wcet_pid for the arming warning
+static void cliLoopRate(char *cmdline) {
+    if (ARMING_FLAG(ARMED)) {
+        cliPrintErrorLinef("Can't measure while armed");
+        return;
+    }
+    const bool apply = strcasecmp(cmdline, "set") == 0;
+    if (!isEmpty(cmdline) && !apply) {
+        cliShowParseError();
+        return;
+    }
+    cycleBenchWcet_t wcetCycles;
+    cycleBenchLoopWcet(CYCLE_BENCH_DEFAULT_ITERATIONS, &wcetCycles);
+    const loopWcet_t wcet = {
+        .gyro = cliLoopRateTenthsUs(wcetCycles.gyroCycles),
+        .pid = cliLoopRateTenthsUs(wcetCycles.pidCycles),
+    };
+    pidConfigMutable()->loop_wcet_gyro = wcet.gyro;
+    pidConfigMutable()->loop_wcet_pid = wcet.pid;
+    cliPrintLinef("Worst case gyro %d.%dus, pid %d.%dus, with %d%% left to the other tasks",
+                  wcet.gyro / 10, wcet.gyro % 10, wcet.pid / 10, wcet.pid % 10, LOOP_RATE_MARGIN_PERCENT);
+    if (!cycleProfileEnabled) {
+        cliPrintHashLine("without cycle_profile = ON the gyro read and motor write aren't included");
+    }
+
+    loopRate_t rate;
+    uint8_t maxGyroSyncDenom;
+    getConfiguredLoopRate(&rate, &maxGyroSyncDenom);
+    cliPrintLoopRate("Configured", &rate, &wcet);
+    if (!loopRateRecommend(&rate, maxGyroSyncDenom, MAX_PID_PROCESS_DENOM, &wcet)) {
+        cliPrintErrorLinef("No loop rate leaves the margin");
+        return;
+    }
+    cliPrintLoopRate("Recommended", &rate, &wcet);
+    if (apply) {
+        if (maxGyroSyncDenom > 1) {
+            gyroConfigMutable()->gyro_sync_denom = rate.gyroSyncDenom;
+        }
+        pidConfigMutable()->pid_process_denom = rate.pidProcessDenom;
+        cliPrintHashLine("set, save to reboot with the new loop rate");
+    }
+}
+#endif
+
 static void cliVersion(char *cmdline) {
     UNUSED(cmdline);
     cliPrintLinef("# %s / %s (%s) %s %s / %s (%s) MSP API: %s",
@@ -3839,7 +4179,7 @@ static void printResource(uint8_t dumpMask) {
         const void *currentConfig;
         const void *defaultConfig;
         if (configIsInCopy) {
-            currentConfig = pg->copy;
+            currentConfig = pgCopy(pg);
             defaultConfig = pg->address;
         } else {
             currentConfig = pg->address;
@@ -4122,135 +4462,225 @@ error:
 }
 #endif
 
-static void printConfig(char *cmdline, bool doDiff) {
-    uint8_t dumpMask = DUMP_MASTER;
-    char *options;
-    if ((options = checkCommand(cmdline, "master"))) {
-        dumpMask = DUMP_MASTER; // only
-    } else if ((options = checkCommand(cmdline, "profile"))) {
-        dumpMask = DUMP_PROFILE; // only
-    } else if ((options = checkCommand(cmdline, "rates"))) {
-        dumpMask = DUMP_RATES; // only
-    } else if ((options = checkCommand(cmdline, "all"))) {
-        dumpMask = DUMP_ALL;   // all profiles and rates
-    } else {
-        options = cmdline;
-    }
-    if (doDiff) {
-        dumpMask = dumpMask | DO_DIFF;
-    }
-    backupAndResetConfigs();
-    if (checkCommand(options, "defaults")) {
-        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
-    }
-    if ((dumpMask & DUMP_MASTER) || (dumpMask & DUMP_ALL)) {
-        cliPrintHashLine("version");
-        cliVersion(NULL);
-        cliPrintLinefeed();
+static bool dumpHeader(uint8_t dumpMask) {
+    cliPrintHashLine("version");
+    cliVersion(NULL);
+    cliPrintLinefeed();
 #if defined(USE_BOARD_INFO)
-        cliBoardName("");
-        cliManufacturerId("");
+    cliBoardName("");
+    cliManufacturerId("");
 #endif
-        if (dumpMask & DUMP_ALL) {
-            cliMcuId(NULL);
+    if (dumpMask & DUMP_ALL) {
+        cliMcuId(NULL);
 #if defined(USE_BOARD_INFO) && defined(USE_SIGNATURE)
-            cliSignature("");
+        cliSignature("");
 #endif
-        }
-        if ((dumpMask & (DUMP_ALL | DO_DIFF)) == (DUMP_ALL | DO_DIFF)) {
-            cliPrintHashLine("reset configuration to default settings");
-            cliPrint("defaults nosave");
-            cliPrintLinefeed();
-        }
-        cliPrintHashLine("name");
-        printName(dumpMask, &pilotConfig_Copy);
+    }
+    if ((dumpMask & (DUMP_ALL | DO_DIFF)) == (DUMP_ALL | DO_DIFF)) {
+        cliPrintHashLine("reset configuration to default settings");
+        cliPrint("defaults nosave");
+        cliPrintLinefeed();
+    }
+    cliPrintHashLine("name");
+    printName(dumpMask, pilotConfigCopy());
 #ifdef USE_RESOURCE_MGMT
-        cliPrintHashLine("resources");
-        printResource(dumpMask);
+    cliPrintHashLine("resources");
+    printResource(dumpMask);
 #endif
+    return true;
+}
+
+static bool dumpMixer(uint8_t dumpMask) {
 #ifndef USE_QUAD_MIXER_ONLY
-        cliPrintHashLine("mixer");
-        const bool equalsDefault = mixerConfig_Copy.mixerMode == mixerConfig()->mixerMode;
-        const char *formatMixer = "mixer %s";
-        cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
-        cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig_Copy.mixerMode - 1]);
-        cliDumpPrintLinef(dumpMask, customMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
-        printMotorMix(dumpMask, customMotorMixer_CopyArray, customMotorMixer(0));
+    cliPrintHashLine("mixer");
+    const bool equalsDefault = mixerConfigCopy()->mixerMode == mixerConfig()->mixerMode;
+    const char *formatMixer = "mixer %s";
+    cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
+    cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfigCopy()->mixerMode - 1]);
+    cliDumpPrintLinef(dumpMask, customMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
+    printMotorMix(dumpMask, customMotorMixerCopy(0), customMotorMixer(0));
 #ifdef USE_SERVOS
-        cliPrintHashLine("servo");
-        printServo(dumpMask, servoParams_CopyArray, servoParams(0));
-        cliPrintHashLine("servo mix");
-        // print custom servo mixer if exists
-        cliDumpPrintLinef(dumpMask, customServoMixers(0)->rate == 0, "smix reset\r\n");
-        printServoMix(dumpMask, customServoMixers_CopyArray, customServoMixers(0));
+    cliPrintHashLine("servo");
+    printServo(dumpMask, servoParamsCopy(0), servoParams(0));
+    cliPrintHashLine("servo mix");
+    // print custom servo mixer if exists
+    cliDumpPrintLinef(dumpMask, customServoMixers(0)->rate == 0, "smix reset\r\n");
+    printServoMix(dumpMask, customServoMixersCopy(0), customServoMixers(0));
 #endif
+#else
+    UNUSED(dumpMask);
 #endif
-        cliPrintHashLine("feature");
-        printFeature(dumpMask, &featureConfig_Copy, featureConfig());
+    return true;
+}
+
+static bool dumpFeatures(uint8_t dumpMask) {
+    cliPrintHashLine("feature");
+    printFeature(dumpMask, featureConfigCopy(), featureConfig());
 #if defined(USE_BEEPER)
-        cliPrintHashLine("beeper");
-        printBeeper(dumpMask, beeperConfig_Copy.beeper_off_flags, beeperConfig()->beeper_off_flags, "beeper", BEEPER_ALLOWED_MODES);
+    cliPrintHashLine("beeper");
+    printBeeper(dumpMask, beeperConfigCopy()->beeper_off_flags, beeperConfig()->beeper_off_flags, "beeper", BEEPER_ALLOWED_MODES);
 #if defined(USE_DSHOT)
-        cliPrintHashLine("beacon");
-        printBeeper(dumpMask, beeperConfig_Copy.dshotBeaconOffFlags, beeperConfig()->dshotBeaconOffFlags, "beacon", DSHOT_BEACON_ALLOWED_MODES);
+    cliPrintHashLine("beacon");
+    printBeeper(dumpMask, beeperConfigCopy()->dshotBeaconOffFlags, beeperConfig()->dshotBeaconOffFlags, "beacon", DSHOT_BEACON_ALLOWED_MODES);
 #endif
 #endif // USE_BEEPER
-        cliPrintHashLine("map");
-        printMap(dumpMask, &rxConfig_Copy, rxConfig());
-        cliPrintHashLine("serial");
-        printSerial(dumpMask, &serialConfig_Copy, serialConfig());
+    cliPrintHashLine("map");
+    printMap(dumpMask, rxConfigCopy(), rxConfig());
+    cliPrintHashLine("serial");
+    printSerial(dumpMask, serialConfigCopy(), serialConfig());
+    return true;
+}
+
 #ifdef USE_LED_STRIP
-        cliPrintHashLine("led");
-        printLed(dumpMask, ledStripConfig_Copy.ledConfigs, ledStripConfig()->ledConfigs);
-        cliPrintHashLine("color");
-        printColor(dumpMask, ledStripConfig_Copy.colors, ledStripConfig()->colors);
-        cliPrintHashLine("mode_color");
-        printModeColor(dumpMask, &ledStripConfig_Copy, ledStripConfig());
-#endif
-        cliPrintHashLine("aux");
-        printAux(dumpMask, modeActivationConditions_CopyArray, modeActivationConditions(0));
-        cliPrintHashLine("adjrange");
-        printAdjustmentRange(dumpMask, adjustmentRanges_CopyArray, adjustmentRanges(0));
-        cliPrintHashLine("rxrange");
-        printRxRange(dumpMask, rxChannelRangeConfigs_CopyArray, rxChannelRangeConfigs(0));
+static bool dumpLedStrip(uint8_t dumpMask) {
+    cliPrintHashLine("led");
+    printLed(dumpMask, ledStripConfigCopy()->ledConfigs, ledStripConfig()->ledConfigs);
+    cliPrintHashLine("color");
+    printColor(dumpMask, ledStripConfigCopy()->colors, ledStripConfig()->colors);
+    cliPrintHashLine("mode_color");
+    printModeColor(dumpMask, ledStripConfigCopy(), ledStripConfig());
+    return true;
+}
+#endif
+
+static bool dumpModes(uint8_t dumpMask) {
+    cliPrintHashLine("aux");
+    printAux(dumpMask, modeActivationConditionsCopy(0), modeActivationConditions(0));
+    cliPrintHashLine("adjrange");
+    printAdjustmentRange(dumpMask, adjustmentRangesCopy(0), adjustmentRanges(0));
+    return true;
+}
+
+static bool dumpRx(uint8_t dumpMask) {
+    cliPrintHashLine("rxrange");
+    printRxRange(dumpMask, rxChannelRangeConfigsCopy(0), rxChannelRangeConfigs(0));
 #ifdef USE_VTX_CONTROL
-        cliPrintHashLine("vtx");
-        printVtx(dumpMask, &vtxConfig_Copy, vtxConfig());
+    cliPrintHashLine("vtx");
+    printVtx(dumpMask, vtxConfigCopy(), vtxConfig());
 #endif
-        cliPrintHashLine("rxfail");
-        printRxFailsafe(dumpMask, rxFailsafeChannelConfigs_CopyArray, rxFailsafeChannelConfigs(0));
+    cliPrintHashLine("rxfail");
+    printRxFailsafe(dumpMask, rxFailsafeChannelConfigsCopy(0), rxFailsafeChannelConfigs(0));
+    return true;
+}
+
+static bool dumpMasterValues(uint8_t dumpMask) {
+    if (!cliDumpState.headerDone) {
         cliPrintHashLine("master");
-        dumpAllValues(MASTER_VALUE, dumpMask);
-        if (dumpMask & DUMP_ALL) {
-            for (uint32_t pidProfileIndex = 0; pidProfileIndex < PID_PROFILE_COUNT; pidProfileIndex++) {
-                cliDumpPidProfile(pidProfileIndex, dumpMask);
-            }
-            cliPrintHashLine("restore original profile selection");
-            pidProfileIndexToUse = systemConfig_Copy.pidProfileIndex;
-            cliProfile("");
-            pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
-            for (uint32_t rateIndex = 0; rateIndex < CONTROL_RATE_PROFILE_COUNT; rateIndex++) {
-                cliDumpRateProfile(rateIndex, dumpMask);
-            }
-            cliPrintHashLine("restore original rateprofile selection");
-            rateProfileIndexToUse = systemConfig_Copy.activeRateProfile;
-            cliRateProfile("");
-            rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
-            cliPrintHashLine("save configuration");
-            cliPrint("save");
-        } else {
-            cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
-            cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
+        cliDumpState.headerDone = true;
+    }
+    if (!dumpAllValues(MASTER_VALUE, dumpMask)) {
+        return false;
+    }
+    cliDumpState.headerDone = false;
+    return true;
+}
+
+static bool dumpPidProfiles(uint8_t dumpMask) {
+    if (!(dumpMask & DUMP_ALL)) {
+        return cliDumpPidProfile(systemConfigCopy()->pidProfileIndex, dumpMask);
+    }
+    for (; cliDumpState.profileIndex < PID_PROFILE_COUNT; cliDumpState.profileIndex++) {
+        if (!cliDumpPidProfile(cliDumpState.profileIndex, dumpMask)) {
+            return false;
         }
     }
-    if (dumpMask & DUMP_PROFILE) {
-        cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
+    cliDumpState.profileIndex = 0;
+    cliPrintHashLine("restore original profile selection");
+    pidProfileIndexToUse = systemConfigCopy()->pidProfileIndex;
+    cliProfile("");
+    pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+    return true;
+}
+
+static bool dumpRateProfiles(uint8_t dumpMask) {
+    if (!(dumpMask & DUMP_ALL)) {
+        return cliDumpRateProfile(systemConfigCopy()->activeRateProfile, dumpMask);
+    }
+    for (; cliDumpState.profileIndex < CONTROL_RATE_PROFILE_COUNT; cliDumpState.profileIndex++) {
+        if (!cliDumpRateProfile(cliDumpState.profileIndex, dumpMask)) {
+            return false;
+        }
     }
-    if (dumpMask & DUMP_RATES) {
-        cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
+    cliDumpState.profileIndex = 0;
+    cliPrintHashLine("restore original rateprofile selection");
+    rateProfileIndexToUse = systemConfigCopy()->activeRateProfile;
+    cliRateProfile("");
+    rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+    return true;
+}
+
+static bool dumpSave(uint8_t dumpMask) {
+    UNUSED(dumpMask);
+    cliPrintHashLine("save configuration");
+    cliPrint("save");
+    return true;
+}
+
+typedef struct cliDumpSection_s {
+    bool (*print)(uint8_t dumpMask);    // false while the section has more to write
+    uint8_t dumpMask;                   // dumps the section is part of
+} cliDumpSection_t;
+
+static const cliDumpSection_t cliDumpSections[] = {
+    { dumpHeader,           DUMP_MASTER | DUMP_ALL },
+    { dumpMixer,            DUMP_MASTER | DUMP_ALL },
+    { dumpFeatures,         DUMP_MASTER | DUMP_ALL },
+#ifdef USE_LED_STRIP
+    { dumpLedStrip,         DUMP_MASTER | DUMP_ALL },
+#endif
+    { dumpModes,            DUMP_MASTER | DUMP_ALL },
+    { dumpRx,               DUMP_MASTER | DUMP_ALL },
+    { dumpMasterValues,     DUMP_MASTER | DUMP_ALL },
+    { dumpPidProfiles,      DUMP_MASTER | DUMP_ALL | DUMP_PROFILE },
+    { dumpRateProfiles,     DUMP_MASTER | DUMP_ALL | DUMP_RATES },
+    { dumpSave,             DUMP_ALL },
+};
+
+/*
+ * Write the sections of the running dump while the port has room for them, and restore the configs after the
+ * last one. Called again from cliProcess() until cliDumpState.active drops, the input waits until then.
+ */
+static void cliDumpProcess(void) {
+    while (cliDumpState.section < ARRAYLEN(cliDumpSections)) {
+        const cliDumpSection_t *section = &cliDumpSections[cliDumpState.section];
+        if (section->dumpMask & cliDumpState.dumpMask) {
+            if (!cliDumpHasRoom() || !section->print(cliDumpState.dumpMask)) {
+                return;
+            }
+        }
+        cliDumpState.section++;
     }
-    // restore configs from copies
     restoreConfigs();
+    cliDumpState.active = false;
+}
+
+static void printConfig(char *cmdline, bool doDiff) {
+    uint8_t dumpMask = DUMP_MASTER;
+    char *options;
+    if ((options = checkCommand(cmdline, "master"))) {
+        dumpMask = DUMP_MASTER; // only
+    } else if ((options = checkCommand(cmdline, "profile"))) {
+        dumpMask = DUMP_PROFILE; // only
+    } else if ((options = checkCommand(cmdline, "rates"))) {
+        dumpMask = DUMP_RATES; // only
+    } else if ((options = checkCommand(cmdline, "all"))) {
+        dumpMask = DUMP_ALL;   // all profiles and rates
+    } else {
+        options = cmdline;
+    }
+    if (doDiff) {
+        dumpMask = dumpMask | DO_DIFF;
+    }
+    if (!backupAndResetConfigs()) {
+        return;
+    }
+    if (checkCommand(options, "defaults")) {
+        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
+    }
+    memset(&cliDumpState, 0, sizeof(cliDumpState));
+    cliDumpState.active = true;
+    cliDumpState.dumpMask = dumpMask;
+    cliDumpProcess();
 }
 
 static void cliDump(char *cmdline) {
@@ -4320,6 +4750,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("beeper", "enable/disable beeper for a condition", "list\r\n"
                     "\t<->[name]", cliBeeper),
 #endif // USE_BEEPER
+#ifdef USE_CYCLE_BENCH
+    CLI_COMMAND_DEF("bench", "cycle count the filter, pid and mixer kernels", "[iterations in thousands]", cliBench),
+#endif
     CLI_COMMAND_DEF("bl", "reboot into bootloader", NULL, cliBootloader),
 #if defined(USE_BOARD_INFO)
     CLI_COMMAND_DEF("board_name", "get / set the name of the board model", "[board name]", cliBoardName),
@@ -4382,6 +4815,9 @@ const clicmd_t cmdTable[] = {
 #ifdef USE_LED_STRIP
     CLI_COMMAND_DEF("led", "configure leds", NULL, cliLed),
 #endif
+#ifdef USE_CYCLE_BENCH
+    CLI_COMMAND_DEF("looprate", "measure the gyro and pid path, recommend a loop rate", "[set]", cliLoopRate),
+#endif
 #if defined(USE_BOARD_INFO)
     CLI_COMMAND_DEF("manufacturer_id", "get / set the id of the board manufacturer", "[manufacturer id]", cliManufacturerId),
 #endif
@@ -4435,8 +4871,16 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
 #ifndef SKIP_TASK_STATISTICS
+#if defined(USE_CYCLE_PROFILE) && defined(USE_LOOP_JITTER)
+    CLI_COMMAND_DEF("tasks", "show task stats", "[cycles [reset]|jitter [reset]]", cliTasks),
+#elif defined(USE_CYCLE_PROFILE)
+    CLI_COMMAND_DEF("tasks", "show task stats", "[cycles [reset]]", cliTasks),
+#elif defined(USE_LOOP_JITTER)
+    CLI_COMMAND_DEF("tasks", "show task stats", "[jitter [reset]]", cliTasks),
+#else
     CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
 #endif
+#endif
 #ifdef USE_TIMER_MGMT
     CLI_COMMAND_DEF("timer", "show timer configuration", NULL, cliTimer),
 #endif
@@ -4476,6 +4920,13 @@ void cliProcess(void) {
     }
     // Be a little bit tricky.  Flush the last inputs buffer, if any.
     bufWriterFlush(cliWriter);
+    if (cliDumpState.active) {
+        cliDumpProcess();
+        if (cliDumpState.active) {
+            return;
+        }
+        cliPrompt();
+    }
     while (serialRxBytesWaiting(cliPort)) {
         uint8_t c = serialRead(cliPort);
         if (c == '\t' || c == '?') {
@@ -4554,6 +5005,10 @@ void cliProcess(void) {
             // 'exit' will reset this flag, so we don't need to print prompt again
             if (!cliMode)
                 return;
+            if (cliDumpState.active) {
+                // the prompt follows the dump, and the next input is read after it
+                return;
+            }
             cliPrompt();
         } else if (c == 127) {
             // backspace
@@ -66,6 +66,16 @@ enum {
 enum {
     CRSF_DISPLAYPORT_OPEN_ROWS_OFFSET = 1,
     CRSF_DISPLAYPORT_OPEN_COLS_OFFSET = 2,
+    CRSF_DISPLAYPORT_OPEN_FLAGS_OFFSET = 3, // optional, older clients send rows and cols only
+};
+
+enum {
+    CRSF_DISPLAYPORT_OPEN_FLAG_MULTI_ROW = 0x01, // client takes consecutive rows in one update, row count is data length / cols
+};
+
+enum {
+    CRSF_DISPLAYPORT_UPDATE_HEADER_SIZE = 2, // subcommand and row
+    CRSF_DISPLAYPORT_UPDATE_DATA_MAX = CRSF_PAYLOAD_SIZE_MAX - CRSF_DISPLAYPORT_UPDATE_HEADER_SIZE,
 };
 
 enum {
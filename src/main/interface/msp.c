@@ -29,6 +29,7 @@
 #include "blackbox/blackbox.h"
 
 #include "build/build_config.h"
+#include "build/cycle_profile.h"
 #include "build/debug.h"
 #include "build/version.h"
 
@@ -53,6 +54,7 @@
 #include "drivers/sdcard.h"
 #include "drivers/serial.h"
 #include "drivers/serial_escserial.h"
+#include "drivers/stack_check.h"
 #include "drivers/system.h"
 #include "drivers/transponder_ir.h"
 #include "drivers/usb_msc.h"
@@ -121,6 +123,7 @@
 #include "sensors/esc_sensor.h"
 #include "sensors/compass.h"
 #include "sensors/gyro.h"
+#include "sensors/gyroanalyse.h"
 #include "sensors/rangefinder.h"
 #include "sensors/sensors.h"
 
@@ -169,6 +172,11 @@ typedef enum {
 
 #define RTC_NOT_SUPPORTED 0xff
 
+#define MSP_TASK_CYCLES_PAGE_SIZE   10   // 20 bytes per entry, keeps a page inside the smallest reply buffer
+#define MSP_PG_CONFIG_CHUNK_SIZE    128  // parameter group bytes per MSP_PG_CONFIG reply
+#define MSP_PG_LIST_PAGE_SIZE       32   // 5 bytes per entry
+#define MSP_DATAFLASH_TOC_PAGE_SIZE 16   // 12 bytes per entry
+
 #ifdef USE_SERIAL_4WAY_BLHELI_INTERFACE
 #define ESC_4WAY 0xff
 
@@ -321,7 +329,8 @@ enum compressionType_e {
     HUFFMAN
 };
 
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression) {
+// Returns the number of flash bytes the reply covers
+static uint32_t serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression) {
     BUILD_BUG_ON(MSP_PORT_DATAFLASH_INFO_SIZE < 16);
     uint16_t readLen = size;
     const int bytesRemainingInBuf = sbufBytesRemaining(dst) - MSP_PORT_DATAFLASH_INFO_SIZE;
@@ -342,6 +351,7 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
     const uint8_t compressionMethod = NO_COMPRESSION;
     UNUSED(allowCompression);
 #endif
+    uint32_t bytesCovered = 0;
     if (compressionMethod == NO_COMPRESSION) {
         if (!useLegacyFormat) {
             // new format supports variable read lengths
@@ -350,6 +360,7 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         }
         const int bytesRead = flashfsReadAbs(address, sbufPtr(dst), readLen);
         sbufAdvance(dst, bytesRead);
+        bytesCovered = bytesRead;
         if (useLegacyFormat) {
             // pad the buffer with zeros
             for (int i = bytesRead; i < size; i++) {
@@ -389,8 +400,10 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         // payload
         sbufWriteU16(dst, bytesReadTotal);
         sbufAdvance(dst, state.bytesWritten);
+        bytesCovered = bytesReadTotal;
 #endif
     }
+    return bytesCovered;
 }
 #endif // USE_FLASHFS
 #endif // USE_OSD_SLAVE
@@ -481,7 +494,7 @@ bool mspCommonProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr
         sbufWriteU16(dst, getBatteryVoltage() * 10);
         break;
     case MSP_DEBUG:
-        for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
+        for (int i = 0; i < DEBUG_MODE_VALUE_COUNT; i++) {
             sbufWriteU16(dst, debug[i]);      // 4 variables are here for general monitoring purpose
         }
         break;
@@ -745,6 +758,23 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst) {
         sbufWriteU32(dst, armingDisableFlags);
     }
     break;
+#ifdef USE_GYRO_DATA_ANALYSE
+    case MSP_GYRO_SPECTRUM: {
+        const gyroSpectrum_t *spectrum = getGyroSpectrum();
+        sbufWriteU16(dst, lrintf(spectrum->firstBinHz * 10));
+        sbufWriteU16(dst, lrintf(spectrum->binWidthHz * 10));
+        sbufWriteU8(dst, spectrum->binCount);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sbufWriteData(dst, spectrum->power[axis], spectrum->binCount);
+        }
+    }
+    break;
+#endif
+    case MSP_FRAME_LIMITS:
+        // the reply is built with all of its room still free, so that is the biggest reply the port sends
+        sbufWriteU16(dst, mspSerialCommandSizeLimit());
+        sbufWriteU16(dst, MIN(sbufBytesRemaining(dst), UINT16_MAX));
+        break;
     case MSP_RAW_IMU: {
         // Hack scale due to choice of units for sensor data in multiwii
         uint8_t scale = 1;
@@ -1426,6 +1456,118 @@ static mspResult_e mspFcProcessOutCommandWithArg(uint8_t cmdMSP, sbuf_t *src, sb
     }
     break;
 #endif
+#ifdef USE_FLASHFS
+    case MSP_DATAFLASH_TOC: {
+        // count, first index, then start, length and timestamp of each log; download one with MSP_DATAFLASH_STREAM
+        const int entryCount = flashfsTocCount();
+        const int firstEntry = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+        const int lastEntry = MIN(firstEntry + MSP_DATAFLASH_TOC_PAGE_SIZE, entryCount);
+        sbufWriteU16(dst, entryCount);
+        sbufWriteU16(dst, firstEntry);
+        for (int i = firstEntry; i < lastEntry; i++) {
+            flashfsTocEntry_t entry;
+            if (!flashfsTocRead(i, &entry)) {
+                break;
+            }
+            sbufWriteU32(dst, entry.start);
+            sbufWriteU32(dst, entry.length);
+            sbufWriteU32(dst, entry.timestamp);
+        }
+    }
+    break;
+#endif
+    case MSP_CPU_LOAD: {
+        // in 0.1%, the interrupts are only timed with cycle_profile = ON
+        uint16_t busyPermille = averageCpuLoadPercent * 10;
+        uint16_t isrPermille = 0;
+        int isrCount = 0;
+        const uint16_t *isrSharePermille = NULL;
+#ifdef USE_CYCLE_PROFILE
+        if (cycleProfileEnabled) {
+            const cycleLoad_t *load = getCycleLoad();
+            busyPermille = load->busyPermille;
+            isrPermille = load->isrPermille;
+            isrCount = CYCLE_ISR_COUNT;
+            isrSharePermille = load->isrSharePermille;
+        }
+#endif
+        sbufWriteU16(dst, busyPermille);
+        sbufWriteU16(dst, isrPermille);
+        sbufWriteU8(dst, isrCount);
+        for (int i = 0; i < isrCount; i++) {
+            sbufWriteU16(dst, isrSharePermille[i]);
+        }
+    }
+    break;
+#ifdef USE_CYCLE_PROFILE
+    case MSP_TASK_CYCLES: {
+        // entries are the tasks by task id followed by the hot sections
+        const int entryCount = TASK_COUNT + CYCLE_SECTION_COUNT;
+        const int firstEntry = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+        const int lastEntry = MIN(firstEntry + MSP_TASK_CYCLES_PAGE_SIZE, entryCount);
+        sbufWriteU32(dst, SystemCoreClock);
+        sbufWriteU8(dst, TASK_COUNT);
+        sbufWriteU8(dst, entryCount);
+        sbufWriteU8(dst, firstEntry);
+        for (int entry = firstEntry; entry < lastEntry; entry++) {
+            cycleProfileInfo_t info;
+            if (entry < TASK_COUNT) {
+                getTaskCycleInfo(entry, &info);
+            } else {
+                getSectionCycleInfo(entry - TASK_COUNT, &info);
+            }
+            sbufWriteU32(dst, info.count);
+            sbufWriteU32(dst, info.minCycles);
+            sbufWriteU32(dst, info.averageCycles);
+            sbufWriteU32(dst, info.maxCycles);
+            sbufWriteU32(dst, info.p99Cycles);
+        }
+    }
+    break;
+#endif
+#ifdef USE_STACK_CHECK_IRQ
+    case MSP_STACK_USAGE:
+        sbufWriteU32(dst, stackTotalSize());
+#ifdef STACK_CHECK
+        sbufWriteU32(dst, stackUsedSize());
+#else
+        sbufWriteU32(dst, 0);
+#endif
+        sbufWriteU8(dst, STACK_IRQ_LEVEL_COUNT);
+        for (int level = 0; level < STACK_IRQ_LEVEL_COUNT; level++) {
+            sbufWriteU32(dst, stackIrqUsedSize(level));
+        }
+        break;
+#endif
+    case MSP_PG_CONFIG: {
+        const pgn_t pgn = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+        const uint16_t offset = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+        if (pgn == 0) {
+            // List the registered groups, offset is the first entry of the page
+            const uint16_t lastEntry = MIN(offset + MSP_PG_LIST_PAGE_SIZE, PG_REGISTRY_SIZE);
+            sbufWriteU16(dst, 0);
+            sbufWriteU16(dst, PG_REGISTRY_SIZE);
+            sbufWriteU16(dst, offset);
+            for (uint16_t entry = offset; entry < lastEntry; entry++) {
+                const pgRegistry_t *reg = &__pg_registry_start[entry];
+                sbufWriteU16(dst, pgN(reg));
+                sbufWriteU8(dst, pgVersion(reg));
+                sbufWriteU16(dst, pgSize(reg));
+            }
+            break;
+        }
+        const pgRegistry_t *reg = pgFind(pgn);
+        if (!reg || offset > pgSize(reg)) {
+            return MSP_RESULT_ERROR;
+        }
+        const uint16_t length = MIN(pgSize(reg) - offset, MSP_PG_CONFIG_CHUNK_SIZE);
+        sbufWriteU16(dst, pgn);
+        sbufWriteU8(dst, pgVersion(reg));
+        sbufWriteU16(dst, pgSize(reg));
+        sbufWriteU16(dst, offset);
+        sbufWriteData(dst, reg->address + offset, length);
+    }
+    break;
     case MSP_REBOOT:
         if (sbufBytesRemaining(src)) {
             rebootMode = sbufReadU8(src);
@@ -1479,8 +1621,153 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src) {
     }
     serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
 }
+
+/*
+ * A dataflash stream pushes MSP_DATAFLASH_READ replies back to back instead of waiting for a request per chunk.
+ * At most a window of flash bytes is sent ahead of the address the client acknowledged last, and when the
+ * acknowledgements stop the stream goes back to that address and sends the rest again.
+ */
+#define DATAFLASH_STREAM_RESEND_MS  500
+#define DATAFLASH_STREAM_TIMEOUT_MS 5000
+
+typedef enum {
+    DATAFLASH_STREAM_START = 0,
+    DATAFLASH_STREAM_ACK,
+    DATAFLASH_STREAM_STOP,
+} dataflashStreamOp_e;
+
+static struct {
+    bool active;
+    bool allowCompression;
+    uint16_t chunkSize;
+    uint32_t windowSize;
+    uint32_t nextAddress;
+    uint32_t ackedAddress;
+    uint32_t endAddress;
+    timeMs_t lastAckMs;
+    timeMs_t lastResendMs;
+} dataflashStream;
+
+static mspStreamResult_e mspFcDataflashStreamNext(mspPacket_t *reply) {
+    const timeMs_t nowMs = millis();
+    if (!dataflashStream.active || nowMs - dataflashStream.lastAckMs > DATAFLASH_STREAM_TIMEOUT_MS) {
+        dataflashStream.active = false;
+        return MSP_STREAM_STOP;
+    }
+    if (dataflashStream.nextAddress >= dataflashStream.endAddress
+        || dataflashStream.nextAddress - dataflashStream.ackedAddress >= dataflashStream.windowSize) {
+        if (nowMs - MAX(dataflashStream.lastAckMs, dataflashStream.lastResendMs) > DATAFLASH_STREAM_RESEND_MS) {
+            dataflashStream.nextAddress = dataflashStream.ackedAddress;
+            dataflashStream.lastResendMs = nowMs;
+        }
+        return MSP_STREAM_WAIT;
+    }
+    reply->cmd = MSP_DATAFLASH_READ;
+    const uint16_t size = MIN(dataflashStream.chunkSize, dataflashStream.endAddress - dataflashStream.nextAddress);
+    dataflashStream.nextAddress += serializeDataflashReadReply(&reply->buf, dataflashStream.nextAddress, size, false, dataflashStream.allowCompression);
+    return MSP_STREAM_SEND;
+}
+
+static void mspFcDataflashStreamAttach(serialPort_t *port) {
+    if (!mspSerialStreamStart(port, mspFcDataflashStreamNext)) {
+        // Not on a serial MSP port, e.g. MSP over telemetry
+        dataflashStream.active = false;
+    }
+}
+
+static mspResult_e mspFcDataflashStreamCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn) {
+    const uint8_t op = sbufBytesRemaining(src) ? sbufReadU8(src) : DATAFLASH_STREAM_STOP;
+    switch (op) {
+    case DATAFLASH_STREAM_START: {
+        if (sbufBytesRemaining(src) < 12 || !flashfsIsSupported()) {
+            return MSP_RESULT_ERROR;
+        }
+        const uint32_t address = MIN(sbufReadU32(src), flashfsGetSize());
+        const uint32_t length = sbufReadU32(src);
+        const uint16_t chunkSize = sbufReadU16(src);
+        const uint8_t windowChunks = sbufReadU8(src);
+        dataflashStream.allowCompression = sbufReadU8(src);
+        // A length of 0 streams everything up to the end of the logs
+        const uint32_t endAddress = length ? address + MIN(length, flashfsGetSize() - address) : MAX(address, flashfsGetOffset());
+        dataflashStream.chunkSize = (chunkSize == 0 || chunkSize > MSP_PORT_DATAFLASH_BUFFER_SIZE) ? MSP_PORT_DATAFLASH_BUFFER_SIZE : chunkSize;
+        dataflashStream.windowSize = MAX(windowChunks, 1) * dataflashStream.chunkSize;
+        dataflashStream.nextAddress = address;
+        dataflashStream.ackedAddress = address;
+        dataflashStream.endAddress = endAddress;
+        dataflashStream.lastAckMs = millis();
+        dataflashStream.lastResendMs = 0;
+        dataflashStream.active = true;
+        if (mspPostProcessFn) {
+            *mspPostProcessFn = mspFcDataflashStreamAttach;
+        }
+        sbufWriteU32(dst, address);
+        sbufWriteU32(dst, endAddress);
+        sbufWriteU16(dst, dataflashStream.chunkSize);
+        return MSP_RESULT_ACK;
+    }
+    case DATAFLASH_STREAM_ACK: {
+        if (sbufBytesRemaining(src) < 4) {
+            return MSP_RESULT_ERROR;
+        }
+        // The client acknowledges everything it has received in order up to this address
+        const uint32_t address = sbufReadU32(src);
+        if (dataflashStream.active && address >= dataflashStream.ackedAddress && address <= dataflashStream.nextAddress) {
+            dataflashStream.ackedAddress = address;
+            dataflashStream.lastAckMs = millis();
+            if (address >= dataflashStream.endAddress) {
+                dataflashStream.active = false;
+            }
+        }
+        // Keep the link free for the stream
+        return MSP_RESULT_NO_REPLY;
+    }
+    case DATAFLASH_STREAM_STOP:
+        dataflashStream.active = false;
+        return MSP_RESULT_ACK;
+    default:
+        return MSP_RESULT_ERROR;
+    }
+}
 #endif
 
+/*
+ * Parameter group contents are collected in the group's copy, the same buffer the CLI diffs against, and loaded
+ * through pgLoad() once the last byte has arrived. Chunks must come in order starting at offset 0.
+ */
+static mspResult_e mspSetPgConfig(sbuf_t *src) {
+    static pgn_t stagedPgn = 0;
+    static uint16_t stagedOffset = 0;
+    if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < 7) {
+        return MSP_RESULT_ERROR;
+    }
+    const pgn_t pgn = sbufReadU16(src);
+    const uint8_t version = sbufReadU8(src);
+    const uint16_t size = sbufReadU16(src);
+    const uint16_t offset = sbufReadU16(src);
+    const uint16_t length = sbufBytesRemaining(src);
+    const pgRegistry_t *reg = pgFind(pgn);
+    // A group whose layout changed would only be reset to defaults, leave it to the CLI instead
+    if (!reg || version != pgVersion(reg) || size != pgSize(reg) || offset + length > size) {
+        return MSP_RESULT_ERROR;
+    }
+    if (offset != 0 && (pgn != stagedPgn || offset != stagedOffset)) {
+        return MSP_RESULT_ERROR;
+    }
+    // staged in the group's copy, so the chunks only apply together
+    uint8_t *staging = pgCopy(reg);
+    if (!staging) {
+        return MSP_RESULT_ERROR;
+    }
+    sbufReadData(src, staging + offset, length);
+    stagedPgn = pgn;
+    stagedOffset = offset + length;
+    if (stagedOffset == size) {
+        pgLoad(reg, staging, size, version);
+        stagedPgn = 0;
+    }
+    return MSP_RESULT_ACK;
+}
+
 #ifdef USE_OSD_SLAVE
 static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
     UNUSED(cmdMSP);
@@ -1494,6 +1781,8 @@ static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
         writeEEPROM();
         readEEPROM();
         break;
+    case MSP_SET_PG_CONFIG:
+        return mspSetPgConfig(src);
     default:
         // we do not know how to handle the (valid) message, indicate error MSP $M!
         return MSP_RESULT_ERROR;
@@ -1746,6 +2035,7 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
             servoParamsMutable(i)->rate = sbufReadU8(src);
             servoParamsMutable(i)->forwardFromChannel = sbufReadU8(src);
             servoParamsMutable(i)->reversedSources = sbufReadU32(src);
+            servoMixerCompile();
         }
 #endif
         break;
@@ -1876,8 +2166,14 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
             currentPidProfile->dterm_dyn_notch_q = sbufReadU16(src);    //dterm_dyn_notch_q
             //end MSP 1.51 dynamic dTerm notch
         }
-        // reinitialize the gyro filters with the new values
         validateAndFixGyroConfig();
+#ifdef USE_FILTER_RETUNE
+        // tuning tools sweep the cutoffs live, a cutoff change only swaps the coefficients at the next loop
+        if (gyroRetuneFilters() && pidRetuneFilters(currentPidProfile)) {
+            break;
+        }
+#endif
+        // reinitialize the gyro filters with the new values
 #ifndef USE_GYRO_IMUF9001
         gyroInitFilters();
 #endif
@@ -2011,6 +2307,8 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
         writeEEPROM();
         readEEPROM();
         break;
+        case MSP_SET_PG_CONFIG:
+        return mspSetPgConfig(src);
 #ifdef USE_BLACKBOX
         case MSP_SET_BLACKBOX_CONFIG:
         // Don't allow config to be updated while Blackbox is logging
@@ -2513,39 +2811,222 @@ mspResult_e mspCommonProcessInCommand(uint8_t cmdMSP, sbuf_t *src, mspPostProces
 }
 
 /*
- * Returns MSP_RESULT_ACK, MSP_RESULT_ERROR or MSP_RESULT_NO_REPLY
+ * Subscribed out messages are pushed on the port that subscribed, each at its own rate, so clients like HD OSDs
+ * do not have to poll them. Only commands that need no arguments and change nothing can be subscribed.
  */
-mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn) {
-    int ret = MSP_RESULT_ACK;
-    sbuf_t *dst = &reply->buf;
-    sbuf_t *src = &cmd->buf;
-    const uint8_t cmdMSP = cmd->cmd;
-    // initialize reply by default
-    reply->cmd = cmd->cmd;
-    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
-        ret = MSP_RESULT_ACK;
-    } else if (mspProcessOutCommand(cmdMSP, dst)) {
-        ret = MSP_RESULT_ACK;
-    } else if ((ret = mspFcProcessOutCommandWithArg(cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
-        /* ret */;
+#define MSP_SUBSCRIPTION_COUNT          8
+#define MSP_SUBSCRIPTION_MAX_RATE       50
+#define MSP_SUBSCRIPTION_MAX_PAYLOAD    128     // well inside the frame a stream gets from an empty uart transmit buffer
+
+typedef struct mspSubscription_s {
+    uint8_t cmd;
+    uint16_t periodMs;
+    timeMs_t dueMs;
+} mspSubscription_t;
+
+static struct {
+    uint8_t count;
+    uint8_t next;
+    mspSubscription_t entries[MSP_SUBSCRIPTION_COUNT];
+} mspSubscriptions;
+
+static mspStreamResult_e mspFcSubscriptionStreamNext(mspPacket_t *reply) {
+    if (mspSubscriptions.count == 0) {
+        return MSP_STREAM_STOP;
+    }
+    if (sbufBytesRemaining(&reply->buf) < MSP_SUBSCRIPTION_MAX_PAYLOAD) {
+        return MSP_STREAM_WAIT;
+    }
+    const timeMs_t nowMs = millis();
+    // round robin, so a fast subscription cannot starve the others
+    for (int i = 0; i < mspSubscriptions.count; i++) {
+        const int index = (mspSubscriptions.next + i) % mspSubscriptions.count;
+        mspSubscription_t *entry = &mspSubscriptions.entries[index];
+        if (cmp32(nowMs, entry->dueMs) < 0) {
+            continue;
+        }
+        entry->dueMs += entry->periodMs;
+        if (cmp32(nowMs, entry->dueMs) >= 0) {
+            // fell a period behind, drop the missed frames instead of sending them back to back
+            entry->dueMs = nowMs + entry->periodMs;
+        }
+        mspSubscriptions.next = index + 1;
+        reply->cmd = entry->cmd;
+        if (mspCommonProcessOutCommand(entry->cmd, &reply->buf, NULL) || mspProcessOutCommand(entry->cmd, &reply->buf)) {
+            return MSP_STREAM_SEND;
+        }
+        return MSP_STREAM_WAIT;
+    }
+    return MSP_STREAM_WAIT;
+}
+
+static void mspFcSubscriptionStreamAttach(serialPort_t *port) {
+    if (!mspSerialStreamStart(port, mspFcSubscriptionStreamNext)) {
+        // Not on a serial MSP port, e.g. MSP over telemetry
+        mspSubscriptions.count = 0;
+    }
+}
+
+static mspResult_e mspFcSubscribeCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn) {
+    const int count = sbufBytesRemaining(src) / 2;
+    if (count > MSP_SUBSCRIPTION_COUNT) {
+        return MSP_RESULT_ERROR;
+    }
+    const timeMs_t nowMs = millis();
+    mspSubscriptions.count = 0;
+    mspSubscriptions.next = 0;
+    for (int i = 0; i < count; i++) {
+        const uint8_t cmd = sbufReadU8(src);
+        const uint8_t rateHz = sbufReadU8(src);
+        // probed through the out handlers in the reply buffer, which refuses commands that need arguments or write settings
+        uint8_t * const probe = sbufPtr(dst);
+        const bool isOutCommand = mspCommonProcessOutCommand(cmd, dst, NULL) || mspProcessOutCommand(cmd, dst);
+        const int payloadSize = sbufPtr(dst) - probe;
+        dst->ptr = probe;
+        if (rateHz == 0 || !isOutCommand || payloadSize > MSP_SUBSCRIPTION_MAX_PAYLOAD) {
+            continue;
+        }
+        mspSubscription_t *entry = &mspSubscriptions.entries[mspSubscriptions.count++];
+        entry->cmd = cmd;
+        entry->periodMs = 1000 / MIN(rateHz, MSP_SUBSCRIPTION_MAX_RATE);
+        entry->dueMs = nowMs;
+    }
+    if (!mspPostProcessFn) {
+        // nothing to attach the stream to
+        mspSubscriptions.count = 0;
+    } else if (mspSubscriptions.count) {
+        *mspPostProcessFn = mspFcSubscriptionStreamAttach;
+    }
+    sbufWriteU8(dst, mspSubscriptions.count);
+    return MSP_RESULT_ACK;
+}
+
+// The handler that answered each command the first time it was seen, later requests go straight to it
+typedef enum {
+    MSP_HANDLER_UNKNOWN = 0,        // not seen yet, the handlers are tried in turn
+    MSP_HANDLER_COMMON_OUT,
+    MSP_HANDLER_OUT,
+    MSP_HANDLER_OUT_WITH_ARG,
+    MSP_HANDLER_4WAY,
+    MSP_HANDLER_WP,
+    MSP_HANDLER_DATAFLASH_READ,
+    MSP_HANDLER_DATAFLASH_STREAM,
+    MSP_HANDLER_SUBSCRIBE,
+    MSP_HANDLER_IN,                 // last, answers every command it is given
+} mspHandler_e;
+
+static uint8_t mspCommandHandler[256];
+
+#ifdef USE_CYCLE_PROFILE
+static mspCommandStats_t mspCommandStats[MSP_COMMAND_STATS_COUNT];
+static uint8_t mspCommandStatsUsed;
+static uint8_t mspCommandStatsSlot[256];   // slot + 1, 0 until the command is recorded
+
+static void mspRecordCommandCycles(uint8_t cmdMSP, uint32_t cycles) {
+    if (!mspCommandStatsSlot[cmdMSP]) {
+        if (mspCommandStatsUsed == MSP_COMMAND_STATS_COUNT) {
+            return;
+        }
+        mspCommandStats[mspCommandStatsUsed].cmd = cmdMSP;
+        mspCommandStats[mspCommandStatsUsed].minCycles = UINT32_MAX;
+        mspCommandStatsSlot[cmdMSP] = ++mspCommandStatsUsed;
+    }
+    mspCommandStats_t *stats = &mspCommandStats[mspCommandStatsSlot[cmdMSP] - 1];
+    stats->count++;
+    stats->totalCycles += cycles;
+    stats->minCycles = MIN(stats->minCycles, cycles);
+    stats->maxCycles = MAX(stats->maxCycles, cycles);
+}
+
+const mspCommandStats_t *getMspCommandStats(int index) {
+    return index < mspCommandStatsUsed ? &mspCommandStats[index] : NULL;
+}
+
+void mspCommandStatsReset(void) {
+    memset(mspCommandStats, 0, sizeof(mspCommandStats));
+    memset(mspCommandStatsSlot, 0, sizeof(mspCommandStatsSlot));
+    mspCommandStatsUsed = 0;
+}
+#endif
+
+static mspResult_e mspRunHandler(mspHandler_e handler, uint8_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn) {
+    switch (handler) {
+    case MSP_HANDLER_COMMON_OUT:
+        return mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn) ? MSP_RESULT_ACK : MSP_RESULT_CMD_UNKNOWN;
+    case MSP_HANDLER_OUT:
+        return mspProcessOutCommand(cmdMSP, dst) ? MSP_RESULT_ACK : MSP_RESULT_CMD_UNKNOWN;
+    case MSP_HANDLER_OUT_WITH_ARG:
+        return mspFcProcessOutCommandWithArg(cmdMSP, src, dst, mspPostProcessFn);
 #ifdef USE_SERIAL_4WAY_BLHELI_INTERFACE
-    } else if (cmdMSP == MSP_SET_4WAY_IF) {
+    case MSP_HANDLER_4WAY:
+        if (cmdMSP != MSP_SET_4WAY_IF) {
+            return MSP_RESULT_CMD_UNKNOWN;
+        }
         mspFc4waySerialCommand(dst, src, mspPostProcessFn);
-        ret = MSP_RESULT_ACK;
+        return MSP_RESULT_ACK;
 #endif
 #ifdef USE_NAV
-    } else if (cmdMSP == MSP_WP) {
+    case MSP_HANDLER_WP:
+        if (cmdMSP != MSP_WP) {
+            return MSP_RESULT_CMD_UNKNOWN;
+        }
         mspFcWpCommand(dst, src);
-        ret = MSP_RESULT_ACK;
+        return MSP_RESULT_ACK;
 #endif
 #ifdef USE_FLASHFS
-    } else if (cmdMSP == MSP_DATAFLASH_READ) {
+    case MSP_HANDLER_DATAFLASH_READ:
+        if (cmdMSP != MSP_DATAFLASH_READ) {
+            return MSP_RESULT_CMD_UNKNOWN;
+        }
         mspFcDataFlashReadCommand(dst, src);
-        ret = MSP_RESULT_ACK;
+        return MSP_RESULT_ACK;
+    case MSP_HANDLER_DATAFLASH_STREAM:
+        if (cmdMSP != MSP_DATAFLASH_STREAM) {
+            return MSP_RESULT_CMD_UNKNOWN;
+        }
+        return mspFcDataflashStreamCommand(dst, src, mspPostProcessFn);
+#endif
+    case MSP_HANDLER_SUBSCRIBE:
+        if (cmdMSP != MSP_SUBSCRIBE) {
+            return MSP_RESULT_CMD_UNKNOWN;
+        }
+        return mspFcSubscribeCommand(dst, src, mspPostProcessFn);
+    case MSP_HANDLER_IN:
+        return mspCommonProcessInCommand(cmdMSP, src, mspPostProcessFn);
+    default:
+        return MSP_RESULT_CMD_UNKNOWN;
+    }
+}
+
+/*
+ * Returns MSP_RESULT_ACK, MSP_RESULT_ERROR or MSP_RESULT_NO_REPLY
+ */
+mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn) {
+    mspResult_e ret;
+    sbuf_t *dst = &reply->buf;
+    sbuf_t *src = &cmd->buf;
+    const uint8_t cmdMSP = cmd->cmd;
+#ifdef USE_CYCLE_PROFILE
+    const uint32_t startCycles = CYCLE_COUNTER_NOW();
 #endif
+    // initialize reply by default
+    reply->cmd = cmd->cmd;
+    mspHandler_e handler = mspCommandHandler[cmdMSP];
+    if (handler != MSP_HANDLER_UNKNOWN) {
+        ret = mspRunHandler(handler, cmdMSP, src, dst, mspPostProcessFn);
     } else {
-        ret = mspCommonProcessInCommand(cmdMSP, src, mspPostProcessFn);
+        // a handler that does not know the command leaves the buffers alone
+        handler = MSP_HANDLER_COMMON_OUT;
+        while ((ret = mspRunHandler(handler, cmdMSP, src, dst, mspPostProcessFn)) == MSP_RESULT_CMD_UNKNOWN && handler < MSP_HANDLER_IN) {
+            handler++;
+        }
+        mspCommandHandler[cmdMSP] = handler;
     }
+#ifdef USE_CYCLE_PROFILE
+    if (cycleProfileEnabled) {
+        mspRecordCommandCycles(cmdMSP, CYCLE_COUNTER_NOW() - startCycles);
+    }
+#endif
     reply->result = ret;
     return ret;
 }
@@ -59,6 +59,30 @@ typedef void (*mspPostProcessFnPtr)(struct serialPort_s *port); // msp post proc
 typedef mspResult_e (*mspProcessCommandFnPtr)(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 typedef void (*mspProcessReplyFnPtr)(mspPacket_t *cmd);
 
+// A stream pushes replies on a port without a request for each of them
+typedef enum {
+    MSP_STREAM_WAIT,        // nothing to send right now
+    MSP_STREAM_SEND,        // send the reply and keep streaming
+    MSP_STREAM_STOP,        // the stream has finished
+} mspStreamResult_e;
+// The reply buffer may be smaller than a command reply gets, so stream frames must fit what sbufBytesRemaining() allows
+typedef mspStreamResult_e (*mspStreamFnPtr)(mspPacket_t *reply);
+
+
+#ifdef USE_CYCLE_PROFILE
+#define MSP_COMMAND_STATS_COUNT 32  // commands recorded, in the order they are first received
+
+typedef struct mspCommandStats_s {
+    uint8_t cmd;
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+} mspCommandStats_t;
+
+const mspCommandStats_t *getMspCommandStats(int index);  // NULL past the last command recorded
+void mspCommandStatsReset(void);
+#endif
 
 void mspInit(void);
 mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
@@ -283,6 +283,8 @@
 #define MSP_ESC_SENSOR_DATA      134    //out message         Extra ESC data from 32-Bit ESCs (Temperature, RPM)
 #define MSP_GPS_RESCUE           135    //out message         GPS Rescues's angle, initialAltitude, descentDistance, rescueGroundSpeed, sanityChecks and minSats
 #define MSP_GPS_RESCUE_PIDS      136    //out message         GPS Rescues's throttleP and velocity PIDS + yaw P
+#define MSP_GYRO_SPECTRUM        137    //out message         binned gyro power spectrum of each axis from the dynamic notch analysis
+#define MSP_FRAME_LIMITS         138    //out message         biggest request and reply payload this port takes
 
 #define MSP_SET_RAW_RC           200    //in message          8 rc chan
 #define MSP_SET_RAW_GPS          201    //in message          fix, numsat, lat, lon, alt, speed
@@ -301,6 +303,7 @@
 #define MSP_SET_SERVO_CONFIGURATION 212    //in message          Servo settings
 #define MSP_SET_MOTOR            214    //in message          PropBalance function
 #define MSP_SET_NAV_CONFIG       215    //in message          Sets nav config parameters - write to the eeprom
+#define MSP_CPU_LOAD             216    //out message         busy and interrupt share of the cpu, and the share of each kind of interrupt
 #define MSP_SET_MOTOR_3D_CONFIG  217    //in message          Settings needed for reversible ESCs
 #define MSP_SET_RC_DEADBAND      218    //in message          deadbands for yaw alt pitch roll
 #define MSP_SET_RESET_CURR_PID   219    //in message          resetting the current pid profile to defaults
@@ -316,11 +319,17 @@
 #define MSP_IMUF_CONFIG          227    //out message
 #define MSP_SET_IMUF_CONFIG      228    //in message
 #define MSP_IMUF_INFO            229    //out message
+#define MSP_DATAFLASH_TOC        230    //out message         the logs listed in the dataflash table of contents, paged
 #define MSP_EMUF                 231    //out message
 #define MSP_SET_EMUF             232    //in message
 
 #define MSP_SET_GPS_RESCUE       233  // GPS Rescues's angle, initialAltitude, descentDistance, rescueGroundSpeed, sanityChecks and minSats
 #define MSP_SET_GPS_RESCUE_PIDS  234    //in message          GPS Rescues's throttleP and velocity PIDS + yaw P
+#define MSP_TASK_CYCLES          235    //out message         DWT cycle statistics per task and hot section, paged
+#define MSP_DATAFLASH_STREAM     236    //in/out message      start, acknowledge or stop a stream of MSP_DATAFLASH_READ replies
+#define MSP_PG_CONFIG            237    //out message         raw parameter group contents by pgn and offset, or the list of groups for pgn 0
+#define MSP_SET_PG_CONFIG        238    //in message          write raw parameter group contents in order, loaded once the last chunk arrives
+#define MSP_SUBSCRIBE            244    //in message          replace the set of out messages pushed on this port, pairs of command and rate in Hz
 // #define MSP_BIND                 240    //in message          no param
 // #define MSP_ALARMS               242
 
@@ -340,6 +349,7 @@
 #define MSP_SET_ACC_TRIM         239    //in message          set acc angle trim values
 #define MSP_SERVO_MIX_RULES      241    //out message         Returns servo mixer configuration
 #define MSP_SET_SERVO_MIX_RULE   242    //in message          Sets servo mixer configuration
+#define MSP_STACK_USAGE          243    //out message         stack size, painted high water mark and the deepest stack at entry to each interrupt priority
 #define MSP_SET_4WAY_IF          245    //in message          Sets 4way interface
 #define MSP_SET_RTC              246    //in message          Sets the RTC clock
 #define MSP_RTC                  247    //out message         Gets the RTC clock
@@ -113,6 +113,9 @@ typedef enum {
 #endif
     TABLE_MIXER_IMPL_TYPE,
     TABLE_DYN_NOTCH_AXIS_TYPE,
+#ifdef USE_DYN_LPF
+    TABLE_DYN_LPF_SOURCE,
+#endif
     LOOKUP_TABLE_COUNT
 } lookupTableIndex_e;
 
@@ -172,7 +175,11 @@ typedef union {
 } cliValueConfig_t;
 
 typedef struct clivalue_s {
+#ifdef USE_CLI_NAME_POOL
+    uint16_t nameCodes;                 // position of the token codes of the name in the generated cliNameCodes[]
+#else
     const char *name;
+#endif
     const uint8_t type; // see cliValueFlag_e
     const cliValueConfig_t config;
 
@@ -185,6 +192,19 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+extern uint16_t valueTableIndex[];
+
+// buffer length for clivalueName(), longer names fail the build of the generated name pool
+#define CLIVALUE_NAME_LENGTH 48
+
+#ifdef USE_CLI_NAME_POOL
+const char *clivalueName(const clivalue_t *value, char *buffer);
+#else
+static inline const char *clivalueName(const clivalue_t *value, char *buffer) {
+    (void)buffer;
+    return value->name;
+}
+#endif
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
@@ -58,7 +58,10 @@
 #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
+// Targets with RAM to spare can keep more sectors in flight while the card is busy
+#ifndef AFATFS_NUM_CACHE_SECTORS
 #define AFATFS_NUM_CACHE_SECTORS 8
+#endif
 
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
 #define AFATFS_SECTOR_SIZE  512
@@ -92,6 +95,8 @@
 #define AFATFS_FILE_MODE_CREATE           16
 // The file's directory entry should be locked in cache so we can read it with no latency:
 #define AFATFS_FILE_MODE_RETAIN_DIRECTORY 32
+// The caller knows no file by this name exists, so the directory isn't searched for one (only valid with create):
+#define AFATFS_FILE_MODE_NEW              64
 
 // Open the cache sector for read access (it will be read from disk)
 #define AFATFS_CACHE_READ         1
@@ -259,6 +264,7 @@ typedef enum {
 
 typedef struct afatfsAppendSupercluster_t {
     uint32_t previousCluster;
+    uint32_t superclusterCount;
     uint32_t fatRewriteStartCluster;
     uint32_t fatRewriteEndCluster;
     afatfsAppendSuperclusterPhase_e phase;
@@ -327,8 +333,23 @@ typedef struct afatfsDeleteFile_t {
     afatfsCallback_t callback;
 } afatfsUnlinkFile_t;
 
+#ifdef AFATFS_USE_FREEFILE
+typedef enum {
+    AFATFS_CLOSE_FILE_RELEASE_NONE = 0,
+    AFATFS_CLOSE_FILE_RELEASE_TERMINATE_FILE,
+    AFATFS_CLOSE_FILE_RELEASE_CHAIN_TO_FREEFILE,
+    AFATFS_CLOSE_FILE_RELEASE_PREPEND_TO_FREEFILE
+} afatfsCloseFileReleasePhase_e;
+#endif
+
 typedef struct afatfsCloseFile_t {
     afatfsCallback_t callback;
+#ifdef AFATFS_USE_FREEFILE
+    // Superclusters a contiguous file holds beyond its end are given back to the freefile before closing
+    uint32_t releaseStartCluster;
+    uint32_t fatRewriteCluster;
+    afatfsCloseFileReleasePhase_e releasePhase;
+#endif
 } afatfsCloseFile_t;
 
 typedef enum {
@@ -480,6 +501,8 @@ typedef struct afatfs_t {
 
     // The current working directory:
     afatfsFile_t currentDirectory;
+    // Byte offset in the current directory that new files search for a free entry from, no free entry is known before it
+    uint32_t freeEntryHint;
 
     uint32_t partitionStartSector; // The physical sector that the first partition on the device begins at
 
@@ -507,7 +530,8 @@ typedef struct afatfs_t {
     uint32_t rootDirectorySectors; // Zero on FAT32, for FAT16 the number of sectors that the root directory occupies
 } afatfs_t;
 
-static afatfs_t afatfs;
+// the sector cache is read and written by the SD card DMA
+static DMA_RAM afatfs_t afatfs;
 
 static void afatfs_fileOperationContinue(afatfsFile_t *file);
 static uint8_t* afatfs_fileLockCursorSectorForWrite(afatfsFilePtr_t file);
@@ -788,7 +812,18 @@ bool afatfs_flush(void) {
         // Flush the oldest flushable sector
         uint32_t earliestSectorTime = 0xFFFFFFFF;
         int earliestSectorIndex = -1;
-        for (int i = 0; i < AFATFS_NUM_CACHE_SECTORS; i++) {
+        /*
+         * In the middle of a multi-block write the sector that continues it goes first, writing any other sector would
+         * stop that write and the rest of the pre-erased run would need a new one.
+         */
+        uint32_t nextBlockIndex;
+        if (sdcard_isWritingBlocks(&nextBlockIndex)) {
+            afatfsCacheBlockDescriptor_t *nextDescriptor = afatfs_findCacheSector(nextBlockIndex);
+            if (nextDescriptor && nextDescriptor->state == AFATFS_CACHE_STATE_DIRTY && !nextDescriptor->locked) {
+                earliestSectorIndex = nextDescriptor - afatfs.cacheDescriptor;
+            }
+        }
+        for (int i = 0; i < AFATFS_NUM_CACHE_SECTORS && earliestSectorIndex == -1; i++) {
             if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked
                     && (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime)
                ) {
@@ -798,6 +833,18 @@ bool afatfs_flush(void) {
         }
         if (earliestSectorIndex > -1) {
             afatfs_cacheFlushSector(earliestSectorIndex);
+            /*
+             * While the card accepts sectors straight away (into the driver's write-behind queue), keep handing it
+             * the dirty sectors that follow on, so they can go out together in a single multi-block transfer.
+             */
+            for (int i = 1; i < AFATFS_NUM_CACHE_SECTORS && afatfs.cacheDescriptor[earliestSectorIndex].state == AFATFS_CACHE_STATE_IN_SYNC; i++) {
+                afatfsCacheBlockDescriptor_t *nextDescriptor = afatfs_findCacheSector(afatfs.cacheDescriptor[earliestSectorIndex].sectorIndex + 1);
+                if (!nextDescriptor || nextDescriptor->state != AFATFS_CACHE_STATE_DIRTY || nextDescriptor->locked) {
+                    break;
+                }
+                earliestSectorIndex = nextDescriptor - afatfs.cacheDescriptor;
+                afatfs_cacheFlushSector(earliestSectorIndex);
+            }
             // That flush will take time to complete so we may as well tell caller to come back later
             return false;
         }
@@ -1487,10 +1534,10 @@ static afatfsOperationStatus_e afatfs_appendSuperclusterContinue(afatfsFile_t *f
 doMore:
     switch (opState->phase) {
     case AFATFS_APPEND_SUPERCLUSTER_PHASE_INIT:
-        // Our file steals the first cluster of the freefile
+        // Our file steals the first superclusters of the freefile
         // We can go ahead and write to that space before the FAT and directory are updated
         file->cursorCluster = afatfs.freeFile.firstCluster;
-        file->physicalSize += afatfs_superClusterSize();
+        file->physicalSize += opState->superclusterCount * afatfs_superClusterSize();
         /* Remove the first supercluster from the freefile
          *
          * Even if the freefile becomes empty, we still don't set its first cluster to zero. This is so that
@@ -1499,12 +1546,12 @@ doMore:
          * Note that normally the freefile can't become empty because it is allocated as a non-integer number
          * of superclusters to avoid precisely this situation.
          */
-        afatfs.freeFile.firstCluster += afatfs_fatEntriesPerSector();
-        afatfs.freeFile.logicalSize -= afatfs_superClusterSize();
-        afatfs.freeFile.physicalSize -= afatfs_superClusterSize();
-        // The new supercluster needs to have its clusters chained contiguously and marked with a terminator at the end
+        afatfs.freeFile.firstCluster += opState->superclusterCount * afatfs_fatEntriesPerSector();
+        afatfs.freeFile.logicalSize -= opState->superclusterCount * afatfs_superClusterSize();
+        afatfs.freeFile.physicalSize -= opState->superclusterCount * afatfs_superClusterSize();
+        // The new superclusters need to have their clusters chained contiguously and marked with a terminator at the end
         opState->fatRewriteStartCluster = file->cursorCluster;
-        opState->fatRewriteEndCluster = opState->fatRewriteStartCluster + afatfs_fatEntriesPerSector();
+        opState->fatRewriteEndCluster = opState->fatRewriteStartCluster + opState->superclusterCount * afatfs_fatEntriesPerSector();
         if (opState->previousCluster == 0) {
             // This is the new first cluster in the file so we need to update the directory entry
             file->firstCluster = file->cursorCluster;
@@ -1545,10 +1592,10 @@ doMore:
 }
 
 /**
- * Attempt to queue up an operation to append the first supercluster of the freefile to the given `file` (file's cursor
- * must be at end-of-file).
+ * Attempt to queue up an operation to append the first `count` superclusters of the freefile to the given `file`
+ * (file's cursor must be at end-of-file).
  *
- * The new cluster number will be set into the file's cursorCluster.
+ * The first new cluster number will be set into the file's cursorCluster.
  *
  * Returns:
  *     AFATFS_OPERATION_SUCCESS     - The append completed successfully and the file's cursorCluster has been updated
@@ -1557,7 +1604,7 @@ doMore:
  *     AFATFS_OPERATION_FAILURE     - Operation could not be queued (file was busy) or append failed (filesystem is full).
  *                                    Check afatfs.fileSystemFull
  */
-static afatfsOperationStatus_e afatfs_appendSupercluster(afatfsFilePtr_t file) {
+static afatfsOperationStatus_e afatfs_appendSuperclusters(afatfsFilePtr_t file, uint32_t count) {
     uint32_t superClusterSize = afatfs_superClusterSize();
     if (file->operation.operation == AFATFS_FILE_OPERATION_APPEND_SUPERCLUSTER) {
         return AFATFS_OPERATION_IN_PROGRESS;
@@ -1565,6 +1612,8 @@ static afatfsOperationStatus_e afatfs_appendSupercluster(afatfsFilePtr_t file) {
     if (afatfs.freeFile.logicalSize < superClusterSize) {
         afatfs.filesystemFull = true;
     }
+    // Always leave the partial supercluster at the end of the freefile behind so it never becomes empty
+    count = MIN(count, afatfs.freeFile.logicalSize / superClusterSize);
     if (afatfs.filesystemFull || afatfs_fileIsBusy(file)) {
         return AFATFS_OPERATION_FAILURE;
     }
@@ -1572,6 +1621,7 @@ static afatfsOperationStatus_e afatfs_appendSupercluster(afatfsFilePtr_t file) {
     file->operation.operation = AFATFS_FILE_OPERATION_APPEND_SUPERCLUSTER;
     opState->phase = AFATFS_APPEND_SUPERCLUSTER_PHASE_INIT;
     opState->previousCluster = file->cursorPreviousCluster;
+    opState->superclusterCount = count;
     return afatfs_appendSuperclusterContinue(file);
 }
 
@@ -1586,7 +1636,7 @@ static afatfsOperationStatus_e afatfs_appendFreeCluster(afatfsFilePtr_t file) {
 #ifdef AFATFS_USE_FREEFILE
     if ((file->mode & AFATFS_FILE_MODE_CONTIGUOUS) != 0) {
         // Steal the first cluster from the beginning of the freefile if we can
-        status = afatfs_appendSupercluster(file);
+        status = afatfs_appendSuperclusters(file, 1);
     } else
 #endif
     {
@@ -2065,6 +2115,9 @@ static afatfsOperationStatus_e afatfs_allocateDirectoryEntry(afatfsFilePtr_t dir
             if (fat_isDirectoryEntryEmpty(*dirEntry) || fat_isDirectoryEntryTerminator(*dirEntry)) {
                 afatfs_cacheSectorMarkDirty(afatfs_getCacheDescriptorForBuffer((uint8_t*) *dirEntry));
                 afatfs_findLast(directory);
+                if (directory == &afatfs.currentDirectory) {
+                    afatfs.freeEntryHint = (directory->cursorOffset & ~(AFATFS_SECTOR_SIZE - 1)) + (finder->entryIndex + 1) * sizeof(fatDirectoryEntry_t);
+                }
                 return AFATFS_OPERATION_SUCCESS;
             }
         } else {
@@ -2216,6 +2269,41 @@ bool afatfs_ftruncate(afatfsFilePtr_t file, afatfsFileCallback_t callback) {
     return true;
 }
 
+/**
+ * Make sure a contiguous file that is open for append has at least `size` bytes allocated, taking all the
+ * superclusters it still needs from the freefile in one go. Writes up to that size then never have to wait for
+ * the FAT or the directory entry to be updated. Space the file doesn't use is given back when it is closed.
+ *
+ * Returns:
+ *     AFATFS_OPERATION_SUCCESS     - The file is that big already and idle, or the allocation completed right away
+ *     AFATFS_OPERATION_IN_PROGRESS - The allocation was queued on the file or the file is busy, call again later
+ *     AFATFS_OPERATION_FAILURE     - The file isn't contiguous, already has data beyond its first allocation or the
+ *                                    filesystem is full
+ */
+afatfsOperationStatus_e afatfs_fpreallocate(afatfsFilePtr_t file, uint32_t size) {
+#ifdef AFATFS_USE_FREEFILE
+    // Wait for a queued allocation to reach the FAT before reporting that the file can be written
+    if (afatfs_fileIsBusy(file)) {
+        return AFATFS_OPERATION_IN_PROGRESS;
+    }
+    if (file->physicalSize >= size) {
+        return AFATFS_OPERATION_SUCCESS;
+    }
+    // Superclusters can only be appended while the cursor sits beyond the last allocated cluster
+    if ((file->mode & AFATFS_FILE_MODE_CONTIGUOUS) == 0 || !afatfs_isEndOfAllocatedFile(file)) {
+        return AFATFS_OPERATION_FAILURE;
+    }
+    const uint32_t superClusterSize = afatfs_superClusterSize();
+    const afatfsOperationStatus_e status = afatfs_appendSuperclusters(file, (size - file->physicalSize + superClusterSize - 1) / superClusterSize);
+    // If the freefile ran short, whatever could be taken is kept but the caller learns the request wasn't met
+    return (status == AFATFS_OPERATION_SUCCESS && file->physicalSize < size) ? AFATFS_OPERATION_FAILURE : status;
+#else
+    UNUSED(file);
+    UNUSED(size);
+    return AFATFS_OPERATION_FAILURE;
+#endif
+}
+
 /**
  * Load details from the given FAT directory entry into the file.
  */
@@ -2233,6 +2321,13 @@ static void afatfs_createFileContinue(afatfsFile_t *file) {
 doMore:
     switch (opState->phase) {
     case AFATFS_CREATEFILE_PHASE_INITIAL:
+        if ((file->mode & (AFATFS_FILE_MODE_NEW | AFATFS_FILE_MODE_CREATE)) == (AFATFS_FILE_MODE_NEW | AFATFS_FILE_MODE_CREATE)) {
+            // Nothing to find, go straight to the free entries. The seek finishes before the directory is free again
+            afatfs_fseek(&afatfs.currentDirectory, afatfs.freeEntryHint & ~(AFATFS_SECTOR_SIZE - 1), AFATFS_SEEK_SET);
+            file->directoryEntryPos.entryIndex = (afatfs.freeEntryHint % AFATFS_SECTOR_SIZE) / sizeof(fatDirectoryEntry_t) - 1;
+            opState->phase = AFATFS_CREATEFILE_PHASE_CREATE_NEW_FILE;
+            goto doMore;
+        }
         afatfs_findFirst(&afatfs.currentDirectory, &file->directoryEntryPos);
         opState->phase = AFATFS_CREATEFILE_PHASE_FIND_FILE;
         goto doMore;
@@ -2465,9 +2560,91 @@ static afatfsFilePtr_t afatfs_createFile(afatfsFilePtr_t file, const char *name,
     return file;
 }
 
+#ifdef AFATFS_USE_FREEFILE
+/**
+ * Find out whether a contiguous file holds superclusters beyond its logical size (see afatfs_fpreallocate()) that
+ * can be given back to the freefile that follows it, and prepare the close operation to do so.
+ */
+static void afatfs_fcloseReleasePrepare(afatfsFilePtr_t file) {
+    afatfsCloseFile_t *opState = &file->operation.state.closeFile;
+    opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_NONE;
+    if ((file->mode & AFATFS_FILE_MODE_CONTIGUOUS) == 0 || file->firstCluster == 0) {
+        return;
+    }
+    const uint32_t usedSuperclusters = (file->logicalSize + afatfs_superClusterSize() - 1) / afatfs_superClusterSize();
+    const uint32_t releaseStartCluster = file->firstCluster + usedSuperclusters * afatfs_fatEntriesPerSector();
+    if (releaseStartCluster >= afatfs.freeFile.firstCluster) {
+        return;
+    }
+    opState->releaseStartCluster = releaseStartCluster;
+    file->physicalSize = usedSuperclusters * afatfs_superClusterSize();
+    if (usedSuperclusters == 0) {
+        file->firstCluster = 0;
+        opState->fatRewriteCluster = releaseStartCluster;
+        opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_CHAIN_TO_FREEFILE;
+    } else {
+        // The last supercluster we keep has to end the file's chain again
+        opState->fatRewriteCluster = releaseStartCluster - afatfs_fatEntriesPerSector();
+        opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_TERMINATE_FILE;
+    }
+}
+
+/**
+ * Continue giving the unused superclusters of a file that is being closed back to the freefile.
+ *
+ * Returns:
+ *     AFATFS_OPERATION_SUCCESS     - Nothing (more) to release
+ *     AFATFS_OPERATION_IN_PROGRESS - Call again later
+ *     AFATFS_OPERATION_FAILURE     - The FAT couldn't be updated
+ */
+static afatfsOperationStatus_e afatfs_fcloseReleaseContinue(afatfsFilePtr_t file) {
+    afatfsCloseFile_t *opState = &file->operation.state.closeFile;
+    afatfsOperationStatus_e status = AFATFS_OPERATION_SUCCESS;
+    uint32_t oldFreeFileStart, freeFileGrow;
+doMore:
+    switch (opState->releasePhase) {
+    case AFATFS_CLOSE_FILE_RELEASE_NONE:
+        break;
+    case AFATFS_CLOSE_FILE_RELEASE_TERMINATE_FILE:
+        status = afatfs_FATFillWithPattern(AFATFS_FAT_PATTERN_TERMINATED_CHAIN, &opState->fatRewriteCluster, opState->releaseStartCluster);
+        if (status == AFATFS_OPERATION_SUCCESS) {
+            opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_CHAIN_TO_FREEFILE;
+            goto doMore;
+        }
+        break;
+    case AFATFS_CLOSE_FILE_RELEASE_CHAIN_TO_FREEFILE:
+        // The released clusters lead straight on into the freefile's chain
+        status = afatfs_FATFillWithPattern(AFATFS_FAT_PATTERN_UNTERMINATED_CHAIN, &opState->fatRewriteCluster, afatfs.freeFile.firstCluster);
+        if (status == AFATFS_OPERATION_SUCCESS) {
+            opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_PREPEND_TO_FREEFILE;
+            goto doMore;
+        }
+        break;
+    case AFATFS_CLOSE_FILE_RELEASE_PREPEND_TO_FREEFILE:
+        // Note, it's okay to run this code several times:
+        oldFreeFileStart = afatfs.freeFile.firstCluster;
+        afatfs.freeFile.firstCluster = opState->releaseStartCluster;
+        freeFileGrow = (oldFreeFileStart - opState->releaseStartCluster) * afatfs_clusterSize();
+        afatfs.freeFile.logicalSize += freeFileGrow;
+        afatfs.freeFile.physicalSize += freeFileGrow;
+        status = afatfs_saveDirectoryEntry(&afatfs.freeFile, AFATFS_SAVE_DIRECTORY_NORMAL);
+        if (status == AFATFS_OPERATION_SUCCESS) {
+            opState->releasePhase = AFATFS_CLOSE_FILE_RELEASE_NONE;
+        }
+        break;
+    }
+    return status;
+}
+#endif
+
 static void afatfs_fcloseContinue(afatfsFilePtr_t file) {
     afatfsCacheBlockDescriptor_t *descriptor;
     afatfsCloseFile_t *opState = &file->operation.state.closeFile;
+#ifdef AFATFS_USE_FREEFILE
+    if (afatfs_fcloseReleaseContinue(file) == AFATFS_OPERATION_IN_PROGRESS) {
+        return;
+    }
+#endif
     /*
      * Directories don't update their parent directory entries over time, because their fileSize field in the directory
      * never changes (when we add the first cluster to the directory we save the directory entry at that point and it
@@ -2522,6 +2699,9 @@ bool afatfs_fclose(afatfsFilePtr_t file, afatfsCallback_t callback) {
         afatfs_fileUpdateFilesize(file);
         file->operation.operation = AFATFS_FILE_OPERATION_CLOSE;
         file->operation.state.closeFile.callback = callback;
+#ifdef AFATFS_USE_FREEFILE
+        afatfs_fcloseReleasePrepare(file);
+#endif
         afatfs_fcloseContinue(file);
         return true;
     }
@@ -2560,6 +2740,7 @@ bool afatfs_chdir(afatfsFilePtr_t directory) {
             return false;
         }
         memcpy(&afatfs.currentDirectory, directory, sizeof(*directory));
+        afatfs.freeEntryHint = 0;
         return true;
     } else {
         afatfs_initFileHandle(&afatfs.currentDirectory);
@@ -2573,10 +2754,19 @@ bool afatfs_chdir(afatfsFilePtr_t directory) {
         // Root directories don't have a directory entry to represent themselves:
         afatfs.currentDirectory.directoryEntryPos.sectorNumberPhysical = 0;
         afatfs_fseek(&afatfs.currentDirectory, 0, AFATFS_SEEK_SET);
+        afatfs.freeEntryHint = 0;
         return true;
     }
 }
 
+/**
+ * Tell the filesystem that the current directory has no free entries before entry number entryIndex, e.g. after the
+ * caller has listed it up to its terminator. Files opened with the "n" mode then don't rescan the used entries.
+ */
+void afatfs_hintFreeDirectoryEntry(uint32_t entryIndex) {
+    afatfs.freeEntryHint = entryIndex * sizeof(fatDirectoryEntry_t);
+}
+
 /**
  * Begin the process of opening a file with the given name in the current working directory (paths in the filename are
  * not supported) using the given mode.
@@ -2599,6 +2789,10 @@ bool afatfs_chdir(afatfsFilePtr_t directory) {
  * ws   If the file is already non-empty or freefile support is not compiled in then it will fall back to non-contiguous
  *      operation.
  *
+ * n  - Added to a w or a mode (e.g. "asn"), the caller guarantees that no file by this name exists yet. The directory
+ *      isn't searched for it, and the free entry search starts from the hint (see afatfs_hintFreeDirectoryEntry())
+ *      instead of the start of the directory.
+ *
  * All other mode strings are illegal. In particular, don't add "b" to the end of the mode string.
  *
  * Returns false if the the open failed really early (out of file handles).
@@ -2617,18 +2811,23 @@ bool afatfs_fopen(const char *filename, const char *mode, afatfsFileCallback_t c
         fileMode = AFATFS_FILE_MODE_APPEND | AFATFS_FILE_MODE_CREATE;
         break;
     }
-    switch (mode[1]) {
-    case '+':
-        fileMode |= AFATFS_FILE_MODE_READ;
-        if (fileMode == AFATFS_FILE_MODE_READ) {
-            fileMode |= AFATFS_FILE_MODE_WRITE;
-        }
-        break;
-    case 's':
+    for (const char *modifier = mode + 1; *modifier; modifier++) {
+        switch (*modifier) {
+        case '+':
+            fileMode |= AFATFS_FILE_MODE_READ;
+            if (fileMode == AFATFS_FILE_MODE_READ) {
+                fileMode |= AFATFS_FILE_MODE_WRITE;
+            }
+            break;
+        case 's':
 #ifdef AFATFS_USE_FREEFILE
-        fileMode |= AFATFS_FILE_MODE_CONTIGUOUS | AFATFS_FILE_MODE_RETAIN_DIRECTORY;
+            fileMode |= AFATFS_FILE_MODE_CONTIGUOUS | AFATFS_FILE_MODE_RETAIN_DIRECTORY;
 #endif
-        break;
+            break;
+        case 'n':
+            fileMode |= AFATFS_FILE_MODE_NEW;
+            break;
+        }
     }
     file = afatfs_allocateFileHandle();
     if (file) {
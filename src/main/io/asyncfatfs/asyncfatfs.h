@@ -65,6 +65,7 @@ typedef void (*afatfsCallback_t)(void);
 
 bool afatfs_fopen(const char *filename, const char *mode, afatfsFileCallback_t complete);
 bool afatfs_ftruncate(afatfsFilePtr_t file, afatfsFileCallback_t callback);
+afatfsOperationStatus_e afatfs_fpreallocate(afatfsFilePtr_t file, uint32_t size);
 bool afatfs_fclose(afatfsFilePtr_t file, afatfsCallback_t callback);
 bool afatfs_funlink(afatfsFilePtr_t file, afatfsCallback_t callback);
 
@@ -77,6 +78,7 @@ bool afatfs_ftell(afatfsFilePtr_t file, uint32_t *position);
 
 bool afatfs_mkdir(const char *filename, afatfsFileCallback_t complete);
 bool afatfs_chdir(afatfsFilePtr_t dirHandle);
+void afatfs_hintFreeDirectoryEntry(uint32_t entryIndex);
 
 void afatfs_findFirst(afatfsFilePtr_t directory, afatfsFinder_t *finder);
 afatfsOperationStatus_e afatfs_findNext(afatfsFilePtr_t directory, afatfsFinder_t *finder, fatDirectoryEntry_t **dirEntry);
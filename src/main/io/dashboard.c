@@ -548,6 +548,10 @@ void dashboardUpdate(timeUs_t currentTimeUs) {
         return;
     }
 #endif
+    if (dashboardPresent) {
+        // Sends what the last draw changed, a page at a time between the draws
+        i2c_OLED_update(bus);
+    }
     const bool updateNow = (int32_t)(currentTimeUs - nextDisplayUpdateAt) >= 0L;
     if (!updateNow) {
         return;
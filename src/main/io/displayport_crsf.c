@@ -48,7 +48,7 @@ static int crsfGrab(displayPort_t *displayPort) {
 static int crsfClearScreen(displayPort_t *displayPort) {
     UNUSED(displayPort);
     memset(crsfScreen.buffer, ' ', sizeof(crsfScreen.buffer));
-    memset(crsfScreen.pendingTransport, 0, sizeof(crsfScreen.pendingTransport));
+    crsfScreen.dirtyRows = 0;
     crsfScreen.reset = true;
     delayTransportUntilMs = millis() + CRSF_DISPLAY_PORT_CLEAR_DELAY_MS;
     return 0;
@@ -76,9 +76,9 @@ static int crsfWriteString(displayPort_t *displayPort, uint8_t col, uint8_t row,
     }
     const size_t truncLen = MIN((int)strlen(s), crsfScreen.cols - col); // truncate at colCount
     char *rowStart = &crsfScreen.buffer[row * crsfScreen.cols + col];
-    crsfScreen.pendingTransport[row] = memcmp(rowStart, s, truncLen);
-    if (crsfScreen.pendingTransport[row]) {
+    if (memcmp(rowStart, s, truncLen)) {
         memcpy(rowStart, s, truncLen);
+        crsfScreen.dirtyRows |= 1 << row;
     }
     return 0;
 }
@@ -151,9 +151,10 @@ void crsfDisplayPortMenuExit(void) {
     cmsMenuExit(&crsfDisplayPort, &exitMenu);
 }
 
-void crsfDisplayPortSetDimensions(uint8_t rows, uint8_t cols) {
+void crsfDisplayPortSetDimensions(uint8_t rows, uint8_t cols, bool multiRowUpdate) {
     crsfScreen.rows = MIN(rows, CRSF_DISPLAY_PORT_ROWS_MAX);
     crsfScreen.cols = MIN(cols, CRSF_DISPLAY_PORT_COLS_MAX);
+    crsfScreen.multiRowUpdate = multiRowUpdate;
     crsfResync(&crsfDisplayPort);
 }
 
@@ -162,26 +163,41 @@ void crsfDisplayPortRefresh(void) {
         crsfDisplayPortMenuOpen();
         return;
     }
-    memset(crsfScreen.pendingTransport, 1, crsfScreen.rows);
+    crsfScreen.dirtyRows = (1 << crsfScreen.rows) - 1;
     crsfScreen.reset = true;
     delayTransportUntilMs = millis() + CRSF_DISPLAY_PORT_CLEAR_DELAY_MS;
 }
 
-int crsfDisplayPortNextRow(void) {
+// First row to send and in rowCount how many rows from there go in the frame, at most maxRows.
+// Clean rows between dirty ones are sent along, that is cheaper than another frame.
+int crsfDisplayPortNextRow(uint8_t maxRows, uint8_t *rowCount) {
     const timeMs_t currentTimeMs = millis();
-    if (currentTimeMs < delayTransportUntilMs) {
+    if (currentTimeMs < delayTransportUntilMs || !crsfScreen.dirtyRows) {
         return -1;
     }
-    for(unsigned int i = 0; i < CRSF_DISPLAY_PORT_ROWS_MAX; i++) {
-        if (crsfScreen.pendingTransport[i]) {
-            return i;
+    int row = 0;
+    while (!(crsfScreen.dirtyRows & (1 << row))) {
+        row++;
+    }
+    if (!crsfScreen.multiRowUpdate) {
+        maxRows = 1;
+    }
+    uint8_t count = 1;
+    for (int i = 1; i < maxRows && row + i < crsfScreen.rows; i++) {
+        if (crsfScreen.dirtyRows & (1 << (row + i))) {
+            count = i + 1;
         }
     }
-    return -1;
+    *rowCount = count;
+    return row;
+}
+
+void crsfDisplayPortRowsSent(uint8_t row, uint8_t rowCount) {
+    crsfScreen.dirtyRows &= ~(((1 << rowCount) - 1) << row);
 }
 
 displayPort_t *displayPortCrsfInit() {
-    crsfDisplayPortSetDimensions(CRSF_DISPLAY_PORT_ROWS_MAX, CRSF_DISPLAY_PORT_COLS_MAX);
+    crsfDisplayPortSetDimensions(CRSF_DISPLAY_PORT_ROWS_MAX, CRSF_DISPLAY_PORT_COLS_MAX, false);
     displayInit(&crsfDisplayPort, &crsfDisplayPortVTable);
     return &crsfDisplayPort;
 }
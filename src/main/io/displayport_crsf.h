@@ -28,10 +28,11 @@
 
 typedef struct crsfDisplayPortScreen_s {
     char buffer[CRSF_DISPLAY_PORT_MAX_BUFFER_SIZE];
-    bool pendingTransport[CRSF_DISPLAY_PORT_ROWS_MAX];
+    uint16_t dirtyRows; // bit per row, set while the remote copy of the row is out of date
     uint8_t rows;
     uint8_t cols;
     bool reset;
+    bool multiRowUpdate; // the remote takes several consecutive rows in one update frame
 } crsfDisplayPortScreen_t;
 
 struct displayPort_s;
@@ -40,5 +41,6 @@ crsfDisplayPortScreen_t *crsfDisplayPortScreen(void);
 void crsfDisplayPortMenuOpen(void);
 void crsfDisplayPortMenuExit(void);
 void crsfDisplayPortRefresh(void);
-int crsfDisplayPortNextRow(void);
-void crsfDisplayPortSetDimensions(uint8_t rows, uint8_t cols);
+int crsfDisplayPortNextRow(uint8_t maxRows, uint8_t *rowCount);
+void crsfDisplayPortRowsSent(uint8_t row, uint8_t rowCount);
+void crsfDisplayPortSetDimensions(uint8_t rows, uint8_t cols, bool multiRowUpdate);
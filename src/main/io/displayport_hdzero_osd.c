@@ -60,6 +60,7 @@ FILE_COMPILE_FOR_SPEED
 #define DRAW_FREQ_DENOM 8 // 30Hz
 #define TX_BUFFER_SIZE 1024
 #define VTX_TIMEOUT 1000 // 1 second timer
+#define MSP_FRAME_OVERHEAD 6 // MSP v1 framing around a payload: '$', 'M', '>', size, command and checksum
 
 static mspProcessCommandFnPtr mspProcessCommand;
 static mspPort_t hdZeroMspPort;
@@ -208,6 +209,9 @@ static int drawScreen(displayPort_t *displayPort) // 250Hz
         uint8_t subcmd[COLS + 4];
         uint8_t updateCount = 0;
         subcmd[0] = MSP_WRITE_STRING;
+        // Leave room for the draw-screen frame, runs that don't fit go out on the next call
+        uint32_t room = hdZeroMspPort.port ? serialTxBytesFree(hdZeroMspPort.port) : 0;
+        room = room > MSP_FRAME_OVERHEAD + 1 ? room - (MSP_FRAME_OVERHEAD + 1) : 0;
 
         int next = BITARRAY_FIND_FIRST_SET(dirty, 0);
         while (next >= 0) {
@@ -228,6 +232,13 @@ static int drawScreen(displayPort_t *displayPort) // 250Hz
                 }
             } while (next == pos && next < endOfLine && bitArrayGet(fontPage, next) == page);
 
+            if ((uint32_t)len + MSP_FRAME_OVERHEAD > room) {
+                for (int i = row * COLS + col; i < pos; i++) {
+                    bitArraySet(dirty, i);
+                }
+                break;
+            }
+            room -= len + MSP_FRAME_OVERHEAD;
             subcmd[1] = row;
             subcmd[2] = col;
             subcmd[3] = page;
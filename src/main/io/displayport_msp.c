@@ -27,6 +27,7 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/bitarray.h"
 #include "common/utils.h"
 
 #include "pg/pg.h"
@@ -46,6 +47,27 @@ PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CON
 
 static displayPort_t mspDisplayPort;
 
+#define MSP_DISPLAYPORT_CLEAR_SCREEN    2
+#define MSP_DISPLAYPORT_WRITE_STRING    3
+#define MSP_DISPLAYPORT_DRAW_SCREEN     4
+
+#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
+
+/*
+ * While nothing has the display grabbed, the OSD draws onto a local canvas and drawScreen() sends only the characters
+ * that changed since the last one, as one write-string frame per run, followed by a single draw-screen. The CMS paces
+ * itself on the bytes each write returns, so writes while grabbed still go out as they come.
+ */
+#define CANVAS_ROWS 13
+#define CANVAS_COLS 30
+#define CANVAS_SIZE (CANVAS_ROWS * CANVAS_COLS)
+// MSP v1 framing around a write-string payload: '$', 'M', '>', size, command and checksum
+#define CANVAS_FRAME_OVERHEAD 6
+
+static uint8_t canvas[CANVAS_SIZE];
+static BITARRAY_DECLARE(canvasDirty, CANVAS_SIZE);
+static bool canvasCleared;
+
 #ifdef USE_CLI
 extern uint8_t cliMode;
 #endif
@@ -79,12 +101,56 @@ static int release(displayPort_t *displayPort) {
 }
 
 static int clearScreen(displayPort_t *displayPort) {
-    uint8_t subcmd[] = { 2 };
+    uint8_t subcmd[] = { MSP_DISPLAYPORT_CLEAR_SCREEN };
+    memset(canvas, ' ', sizeof(canvas));
+    BITARRAY_CLR_ALL(canvasDirty);
+    canvasCleared = true;
+    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+}
+
+static int drawCanvas(displayPort_t *displayPort) {
+    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
+    // Leave room for the draw-screen frame, runs that don't fit go out on the next call
+    uint32_t room = mspSerialTxBytesFree();
+    room = room > CANVAS_FRAME_OVERHEAD + 1 ? room - (CANVAS_FRAME_OVERHEAD + 1) : 0;
+    bool sent = canvasCleared;
+    int next = BITARRAY_FIND_FIRST_SET(canvasDirty, 0);
+    while (next >= 0) {
+        const uint8_t row = next / CANVAS_COLS;
+        const uint8_t col = next % CANVAS_COLS;
+        int len = 0;
+        while (col + len < CANVAS_COLS && bitArrayGet(canvasDirty, next + len)) {
+            buf[4 + len] = canvas[next + len];
+            len++;
+        }
+        if ((uint32_t)len + 4 + CANVAS_FRAME_OVERHEAD > room) {
+            break;
+        }
+        room -= len + 4 + CANVAS_FRAME_OVERHEAD;
+        buf[0] = MSP_DISPLAYPORT_WRITE_STRING;
+        buf[1] = row;
+        buf[2] = col;
+        buf[3] = 0;
+        output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+        for (int i = 0; i < len; i++) {
+            bitArrayClr(canvasDirty, next + i);
+        }
+        sent = true;
+        next = BITARRAY_FIND_FIRST_SET(canvasDirty, next + len);
+    }
+    if (!sent) {
+        return 0;
+    }
+    canvasCleared = false;
+    uint8_t subcmd[] = { MSP_DISPLAYPORT_DRAW_SCREEN };
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
 static int drawScreen(displayPort_t *displayPort) {
-    uint8_t subcmd[] = { 4 };
+    if (!displayIsGrabbed(displayPort)) {
+        return drawCanvas(displayPort);
+    }
+    uint8_t subcmd[] = { MSP_DISPLAYPORT_DRAW_SCREEN };
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
@@ -93,13 +159,23 @@ static int screenSize(const displayPort_t *displayPort) {
 }
 
 static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string) {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
+    if (!displayIsGrabbed(displayPort)) {
+        if (row < CANVAS_ROWS) {
+            for (uint16_t pos = row * CANVAS_COLS + col; col < CANVAS_COLS && *string; col++, pos++, string++) {
+                if (canvas[pos] != (uint8_t)*string) {
+                    canvas[pos] = *string;
+                    bitArraySet(canvasDirty, pos);
+                }
+            }
+        }
+        return 0;
+    }
     uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
     int len = strlen(string);
     if (len >= MSP_OSD_MAX_STRING_LENGTH) {
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
-    buf[0] = 3;
+    buf[0] = MSP_DISPLAYPORT_WRITE_STRING;
     buf[1] = row;
     buf[2] = col;
     buf[3] = 0;
@@ -28,6 +28,10 @@
  * Note that bits can only be set to 0 when writing, not back to 1 from 0. You must erase sectors in order
  * to bring bits back to 1 again.
  *
+ * With flash_ring_erase_ahead_kb set the device is used as a ring log instead: the file pointer wraps around at the
+ * end of the device and sectors are erased ahead of it while nothing is being written, so logging can start right
+ * away without erasing the whole chip first. The oldest data is overwritten once the device is full.
+ *
  * In future, we can add support for multiple different flash chips by adding a flash device driver vtable
  * and make calls through that, at the moment flashfs just calls m25p16_* routines explicitly.
  */
@@ -36,11 +40,22 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "platform.h"
+
+#include "common/crc.h"
+#include "common/memory.h"
+
 #include "drivers/flash.h"
 
 #include "io/flashfs.h"
 
-static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
+#include "pg/flash.h"
+
+// A sector erase of the chips we support takes a few seconds at most
+#define FLASHFS_SECTOR_ERASE_TIMEOUT_MILLIS 5000
+
+// Allocated by flashfsInit() when a flash chip is present
+static uint8_t *flashWriteBuffer;
 
 /* The position of our head and tail in the circular flash write buffer.
  *
@@ -49,11 +64,34 @@ static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
  *
  * When the circular buffer is empty, head == tail
  */
-static uint8_t bufferHead = 0, bufferTail = 0;
+static uint16_t bufferHead = 0, bufferTail = 0;
 
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+static bool ringLog = false;
+// How many bytes from the tail onwards are known to be erased, the erased region always ends on a sector boundary
+static uint32_t erasedAhead = 0;
+static uint32_t eraseAheadTarget = 0;
+
+/* A linear log on NOR flash keeps a table of contents in its last sector, one record per log. Records are
+ * programmed into the erased sector in order and only go away when the whole chip is erased.
+ */
+#define FLASHFS_TOC_MAGIC 0x4C42
+
+typedef struct flashfsTocRecord_s {
+    uint16_t magic;
+    uint16_t crc;               // crc16 ccitt of the entry
+    flashfsTocEntry_t entry;
+} flashfsTocRecord_t;
+
+STATIC_ASSERT(sizeof(flashfsTocRecord_t) == 16, flashfsTocRecord_t_size);
+
+static uint32_t tocAddress = 0;
+static uint32_t tocSize = 0;
+static int tocCount = 0;
+static bool tocWritable = false;
+
 static void flashfsClearBuffer(void) {
     bufferTail = bufferHead = 0;
 }
@@ -64,12 +102,48 @@ static bool flashfsBufferIsEmpty(void) {
 
 static void flashfsSetTailAddress(uint32_t address) {
     tailAddress = address;
+    // Like in the linear layout, only the rest of the sector the tail lands in is assumed to be free
+    const uint32_t sectorSize = flashGetGeometry()->sectorSize;
+    erasedAhead = sectorSize ? (sectorSize - address % sectorSize) % sectorSize : 0;
+}
+
+/**
+ * Called after bytes have been written to the flash to move the tail along, wrapping it around in a ring log.
+ */
+static void flashfsAdvanceTailAddress(uint32_t delta) {
+    erasedAhead = erasedAhead > delta ? erasedAhead - delta : 0;
+    tailAddress += delta;
+    if (ringLog && tailAddress >= flashfsGetSize()) {
+        tailAddress -= flashfsGetSize();
+    }
+}
+
+/**
+ * Start erasing the sector that follows the erased region ahead of the tail.
+ *
+ * Returns false if there is no such sector, i.e. everything but the sector holding the tail is already erased.
+ */
+static bool flashfsEraseNextSector(void) {
+    const flashGeometry_t *geometry = flashGetGeometry();
+    if (geometry->sectorSize == 0 || erasedAhead + geometry->sectorSize > geometry->totalSize) {
+        return false;
+    }
+    uint32_t address = tailAddress + erasedAhead;
+    if (address >= geometry->totalSize) {
+        address -= geometry->totalSize;
+    }
+    flashEraseSector(address);
+    erasedAhead += geometry->sectorSize;
+    return true;
 }
 
 void flashfsEraseCompletely(void) {
     flashEraseCompletely();
     flashfsClearBuffer();
     flashfsSetTailAddress(0);
+    erasedAhead = flashfsGetSize();
+    tocCount = 0;
+    tocWritable = tocSize > 0;
 }
 
 /**
@@ -106,7 +180,8 @@ bool flashfsIsSupported(void) {
 }
 
 uint32_t flashfsGetSize(void) {
-    return flashGetGeometry()->totalSize;
+    // Logs stop short of the table of contents
+    return flashGetGeometry()->totalSize - tocSize;
 }
 
 static uint32_t flashfsTransmitBufferUsed(void) {
@@ -175,8 +250,20 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
         } else {
             bytesTotalThisIteration = bytesTotalRemaining;
         }
-        // Are we at EOF already? Abort.
-        if (flashfsIsEOF()) {
+        if (ringLog) {
+            // The page has to go to erased flash, in asynchronous mode come back once the erase has finished
+            if (erasedAhead < bytesTotalThisIteration) {
+                if (!flashfsEraseNextSector()) {
+                    flashfsClearBuffer();
+                    break;
+                }
+                if (!sync) {
+                    break;
+                }
+                flashWaitForReady(FLASHFS_SECTOR_ERASE_TIMEOUT_MILLIS);
+            }
+        } else if (flashfsIsEOF()) {
+            // Are we at EOF already? Abort.
             // May as well throw away any buffered data
             flashfsClearBuffer();
             break;
@@ -204,12 +291,13 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
         flashPageProgramFinish();
         bytesTotalRemaining -= bytesTotalThisIteration;
         // Advance the cursor in the file system to match the bytes we wrote
-        flashfsSetTailAddress(tailAddress + bytesTotalThisIteration);
+        flashfsAdvanceTailAddress(bytesTotalThisIteration);
         /*
          * We'll have to wait for that write to complete before we can issue the next one, so if
-         * the user requested asynchronous writes, break now.
+         * the user requested asynchronous writes, break now. Stacked dies can take the next page
+         * right away while this one programs.
          */
-        if (!sync)
+        if (!sync && !flashIsReady())
             break;
     }
     return bytesTotal - bytesTotalRemaining;
@@ -295,6 +383,17 @@ void flashfsFlushSync(void) {
     flashfsClearBuffer();
 }
 
+/**
+ * Erase one more sector ahead of the tail of a ring log, if the flash has nothing else to do and less than
+ * flash_ring_erase_ahead_kb is erased yet. Call regularly while no log is being written.
+ */
+void flashfsEraseAhead(void) {
+    if (!ringLog || erasedAhead >= eraseAheadTarget || !flashfsBufferIsEmpty() || !flashIsReady()) {
+        return;
+    }
+    flashfsEraseNextSector();
+}
+
 void flashfsSeekAbs(uint32_t offset) {
     flashfsFlushSync();
     flashfsSetTailAddress(offset);
@@ -305,10 +404,26 @@ void flashfsSeekRel(int32_t offset) {
     flashfsSetTailAddress(tailAddress + offset);
 }
 
+/**
+ * Move the file pointer up to the start of the next free block, so that whatever is written next can be found by
+ * looking at block starts only, like the USB mass storage view does to list the individual logs.
+ */
+void flashfsSeekToNextBlock(void) {
+    flashfsFlushSync();
+    const uint32_t blockOffset = tailAddress % FLASHFS_FREE_BLOCK_SIZE;
+    if (blockOffset && !flashfsIsEOF()) {
+        // The erased region ends on a sector boundary, so the rest of the block is always part of it
+        flashfsAdvanceTailAddress(FLASHFS_FREE_BLOCK_SIZE - blockOffset);
+    }
+}
+
 /**
  * Write the given byte asynchronously to the flash. If the buffer overflows, data is silently discarded.
  */
 void flashfsWriteByte(uint8_t byte) {
+    if (!flashWriteBuffer) {
+        return;
+    }
     flashWriteBuffer[bufferHead++] = byte;
     if (bufferHead >= FLASHFS_WRITE_BUFFER_SIZE) {
         bufferHead = 0;
@@ -327,6 +442,9 @@ void flashfsWriteByte(uint8_t byte) {
 void flashfsWrite(const uint8_t *data, unsigned int len, bool sync) {
     uint8_t const * buffers[3];
     uint32_t bufferSizes[3];
+    if (!flashWriteBuffer) {
+        return;
+    }
     // There could be two dirty buffers to write out already:
     flashfsGetDirtyDataBuffers(buffers, bufferSizes);
     // Plus the buffer the user supplied:
@@ -402,53 +520,64 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len) {
     return bytesRead;
 }
 
-/**
- * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+/* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
+ * looking for ones that appear to be erased. We can achieve this with good accuracy because an erased block
+ * is all bits set to 1, which pretty much never appears in reasonable size substrings of blackbox logs.
+ *
+ * To do better we might write a volume header instead, which would mark how much free space remains. But keeping
+ * a header up to date while logging would incur more writes to the flash, which would consume precious write
+ * bandwidth and block more often.
  */
-int flashfsIdentifyStartOfFreeSpace(void) {
-    /* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
-     * looking for ones that appear to be erased. We can achieve this with good accuracy because an erased block
-     * is all bits set to 1, which pretty much never appears in reasonable size substrings of blackbox logs.
-     *
-     * To do better we might write a volume header instead, which would mark how much free space remains. But keeping
-     * a header up to date while logging would incur more writes to the flash, which would consume precious write
-     * bandwidth and block more often.
+enum {
+    /* We can choose whatever power of 2 size we like, which determines how much wastage of free space we'll have
+     * at the end of the last written data. But smaller blocksizes will require more searching.
      */
-    enum {
-        /* We can choose whatever power of 2 size we like, which determines how much wastage of free space we'll have
-         * at the end of the last written data. But smaller blocksizes will require more searching.
-         */
-        FREE_BLOCK_SIZE = 2048, // XXX This can't be smaller than page size for underlying flash device.
+    FREE_BLOCK_SIZE = FLASHFS_FREE_BLOCK_SIZE, // XXX This can't be smaller than page size for underlying flash device.
+
+    /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
+    FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
+    FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
+};
+STATIC_ASSERT(FREE_BLOCK_SIZE >= FLASH_MAX_PAGE_SIZE, FREE_BLOCK_SIZE_too_small);
 
-        /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
-        FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
-        FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
-    };
-    STATIC_ASSERT(FREE_BLOCK_SIZE >= FLASH_MAX_PAGE_SIZE, FREE_BLOCK_SIZE_too_small);
+/**
+ * Check whether the flash at the given address looks erased.
+ *
+ * Returns false on an unexpected timeout from flash, in which case blockErased is not set.
+ */
+static bool flashfsReadBlockErased(uint32_t address, bool *blockErased) {
     union {
         uint8_t bytes[FREE_BLOCK_TEST_SIZE_BYTES];
         uint32_t ints[FREE_BLOCK_TEST_SIZE_INTS];
     } testBuffer;
-    int left = 0; // Smallest block index in the search region
-    int right = flashfsGetSize() / FREE_BLOCK_SIZE; // One past the largest block index in the search region
+    if (flashReadBytes(address, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
+        return false;
+    }
+    // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
+    *blockErased = true;
+    for (int i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
+        if (testBuffer.ints[i] != 0xFFFFFFFF) {
+            *blockErased = false;
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Binary search the blocks [left...right) for the first one that appears to be erased, assuming all erased blocks
+ * follow the written ones. Returns right if none is found.
+ */
+static int flashfsFindFirstErasedBlock(int left, int right) {
     int mid;
     int result = right;
-    int i;
     bool blockErased;
     while (left < right) {
         mid = (left + right) / 2;
-        if (flashReadBytes(mid * FREE_BLOCK_SIZE, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
+        if (!flashfsReadBlockErased(mid * FREE_BLOCK_SIZE, &blockErased)) {
             // Unexpected timeout from flash, so bail early (reporting the device fuller than it really is)
             break;
         }
-        // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
-        blockErased = true;
-        for (i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
-            if (testBuffer.ints[i] != 0xFFFFFFFF) {
-                blockErased = false;
-                break;
-            }
-        }
         if (blockErased) {
             /* This erased block might be the leftmost erased block in the volume, but we'll need to continue the
              * search leftwards to find out:
@@ -459,14 +588,156 @@ int flashfsIdentifyStartOfFreeSpace(void) {
             left = mid + 1;
         }
     }
-    return result * FREE_BLOCK_SIZE;
+    return result;
+}
+
+/**
+ * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ */
+int flashfsIdentifyStartOfFreeSpace(void) {
+    return flashfsFindFirstErasedBlock(0, flashfsGetSize() / FREE_BLOCK_SIZE) * FREE_BLOCK_SIZE;
+}
+
+/**
+ * In a ring log the newest data ends where the erased gap in front of the oldest data begins. Find it by looking
+ * for the first erased sector that follows a written one, then seek to the free space in the written sector before
+ * it and count how much erased flash lies ahead.
+ */
+static void flashfsRingSeekToFreeSpace(void) {
+    const flashGeometry_t *geometry = flashGetGeometry();
+    const int sectors = geometry->sectors;
+    const uint32_t sectorSize = geometry->sectorSize;
+    bool erased;
+    bool previousErased;
+    int gapSector = -1;
+    if (!flashfsReadBlockErased((sectors - 1) * sectorSize, &previousErased)) {
+        previousErased = false;
+    }
+    for (int i = 0; i < sectors; i++) {
+        if (!flashfsReadBlockErased(i * sectorSize, &erased)) {
+            erased = false;
+        }
+        if (erased && !previousErased) {
+            gapSector = i;
+            break;
+        }
+        previousErased = erased;
+    }
+    if (gapSector < 0) {
+        // The device is either completely erased or completely full, start over at the beginning
+        flashfsSeekAbs(0);
+        if (previousErased) {
+            erasedAhead = geometry->totalSize;
+        }
+        return;
+    }
+    const int lastWrittenSector = (gapSector + sectors - 1) % sectors;
+    uint32_t freeSpace = gapSector * sectorSize;
+    if (sectorSize >= FREE_BLOCK_SIZE) {
+        const int firstBlock = lastWrittenSector * (sectorSize / FREE_BLOCK_SIZE);
+        const int endBlock = firstBlock + sectorSize / FREE_BLOCK_SIZE;
+        const int freeBlock = flashfsFindFirstErasedBlock(firstBlock, endBlock);
+        if (freeBlock < endBlock) {
+            freeSpace = freeBlock * FREE_BLOCK_SIZE;
+        }
+    }
+    flashfsSeekAbs(freeSpace);
+    // The written sector holding the tail is never counted, so at most all the others can be erased
+    for (int i = 0; i < sectors - 1; i++) {
+        if (!flashfsReadBlockErased(((gapSector + i) % sectors) * sectorSize, &erased) || !erased) {
+            break;
+        }
+        erasedAhead += sectorSize;
+    }
+}
+
+static bool flashfsTocReadRecord(int index, flashfsTocRecord_t *record) {
+    return flashReadBytes(tocAddress + index * sizeof(*record), (uint8_t *)record, sizeof(*record)) == (int)sizeof(*record);
+}
+
+static bool flashfsTocRecordValid(const flashfsTocRecord_t *record) {
+    return record->magic == FLASHFS_TOC_MAGIC && record->crc == crc16_ccitt_update(0, &record->entry, sizeof(record->entry));
+}
+
+static bool flashfsTocRecordErased(const flashfsTocRecord_t *record) {
+    const uint8_t *bytes = (const uint8_t *)record;
+    for (unsigned i = 0; i < sizeof(*record); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Count the records in the table of contents. Anything that is neither a record nor erased (e.g. log data written
+ * before the table existed) leaves the table read only until the chip is erased.
+ */
+static void flashfsTocInit(void) {
+    const flashGeometry_t *geometry = flashGetGeometry();
+    tocSize = 0;
+    tocCount = 0;
+    tocWritable = false;
+    if (ringLog || geometry->flashType != FLASH_TYPE_NOR || geometry->sectorSize == 0 || geometry->sectors < 2) {
+        return;
+    }
+    tocSize = geometry->sectorSize;
+    tocAddress = geometry->totalSize - tocSize;
+    const int maxRecords = tocSize / sizeof(flashfsTocRecord_t);
+    flashfsTocRecord_t record;
+    while (tocCount < maxRecords && flashfsTocReadRecord(tocCount, &record) && flashfsTocRecordValid(&record)) {
+        tocCount++;
+    }
+    tocWritable = tocCount < maxRecords && flashfsTocRecordErased(&record);
+}
+
+/**
+ * Number of logs listed in the table of contents, 0 if the device has none.
+ */
+int flashfsTocCount(void) {
+    return tocCount;
+}
+
+bool flashfsTocRead(int index, flashfsTocEntry_t *entry) {
+    flashfsTocRecord_t record;
+    if (index < 0 || index >= tocCount) {
+        return false;
+    }
+    // The records share the device with the log, so wait for any write in progress
+    flashfsFlushSync();
+    if (!flashfsTocReadRecord(index, &record) || !flashfsTocRecordValid(&record)) {
+        return false;
+    }
+    *entry = record.entry;
+    return true;
+}
+
+/**
+ * Add a log to the table of contents. Returns false if there is no table or no room left in it.
+ */
+bool flashfsTocAppend(const flashfsTocEntry_t *entry) {
+    if (!tocWritable) {
+        return false;
+    }
+    flashfsTocRecord_t record;
+    record.magic = FLASHFS_TOC_MAGIC;
+    record.entry = *entry;
+    record.crc = crc16_ccitt_update(0, &record.entry, sizeof(record.entry));
+
+    // Records never straddle a page, both sizes are powers of two
+    flashfsFlushSync();
+    flashPageProgram(tocAddress + tocCount * sizeof(record), (const uint8_t *)&record, sizeof(record));
+    tocCount++;
+    tocWritable = tocCount < (int)(tocSize / sizeof(record));
+    return true;
 }
 
 /**
  * Returns true if the file pointer is at the end of the device.
  */
 bool flashfsIsEOF(void) {
-    return tailAddress >= flashfsGetSize();
+    // A ring log just wraps around
+    return !ringLog && tailAddress >= flashfsGetSize();
 }
 
 void flashfsClose(void) {
@@ -488,7 +759,18 @@ void flashfsClose(void) {
 void flashfsInit(void) {
     // If we have a flash chip present at all
     if (flashfsGetSize() > 0) {
-        // Start the file pointer off at the beginning of free space so caller can start writing immediately
-        flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
+        if (!flashWriteBuffer) {
+            flashWriteBuffer = memAllocate(FLASHFS_WRITE_BUFFER_SIZE);
+        }
+        const flashGeometry_t *geometry = flashGetGeometry();
+        ringLog = flashConfig()->ringEraseAheadKb > 0 && geometry->flashType == FLASH_TYPE_NOR && geometry->sectorSize > 0;
+        eraseAheadTarget = flashConfig()->ringEraseAheadKb * 1024;
+        flashfsTocInit();
+        if (ringLog) {
+            flashfsRingSeekToFreeSpace();
+        } else {
+            // Start the file pointer off at the beginning of free space so caller can start writing immediately
+            flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
+        }
     }
 }
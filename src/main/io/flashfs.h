@@ -20,14 +20,30 @@
 
 #pragma once
 
+#ifdef USE_FLASH_SPI_DMA
+// Page programs run in the background, so buffer a few pages and hand them over a whole page at a time
+#define FLASHFS_WRITE_BUFFER_SIZE 1024
+#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 256
+#else
 #define FLASHFS_WRITE_BUFFER_SIZE 128
-#define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
-
 // Automatically trigger a flush when this much data is in the buffer
 #define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 64
+#endif
+#define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
+
+// Granularity of the free space search, each blackbox log starts on such a block
+#define FLASHFS_FREE_BLOCK_SIZE 2048
+
+// One log in the table of contents
+typedef struct flashfsTocEntry_s {
+    uint32_t start;
+    uint32_t length;
+    uint32_t timestamp;         // seconds since 1970 when the log ended, 0 if the time of day wasn't known
+} flashfsTocEntry_t;
 
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
+void flashfsEraseAhead(void);
 
 uint32_t flashfsGetSize(void);
 uint32_t flashfsGetOffset(void);
@@ -39,6 +55,7 @@ const struct flashGeometry_s* flashfsGetGeometry(void);
 
 void flashfsSeekAbs(uint32_t offset);
 void flashfsSeekRel(int32_t offset);
+void flashfsSeekToNextBlock(void);
 
 void flashfsWriteByte(uint8_t byte);
 void flashfsWrite(const uint8_t *data, unsigned int len, bool sync);
@@ -52,5 +69,9 @@ void flashfsClose(void);
 void flashfsInit(void);
 bool flashfsIsSupported(void);
 
+int flashfsTocCount(void);
+bool flashfsTocRead(int index, flashfsTocEntry_t *entry);
+bool flashfsTocAppend(const flashfsTocEntry_t *entry);
+
 bool flashfsIsReady(void);
 bool flashfsIsEOF(void);
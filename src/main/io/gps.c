@@ -32,6 +32,7 @@
 #include "build/debug.h"
 
 #include "common/axis.h"
+#include "common/crc.h"
 #include "common/gps_conversion.h"
 #include "common/maths.h"
 #include "common/utils.h"
@@ -66,6 +67,7 @@
 #define LOG_UBLOX_SVINFO 'I'
 #define LOG_UBLOX_POSLLH 'P'
 #define LOG_UBLOX_VELNED 'V'
+#define LOG_UBLOX_PVT    'T'
 
 #define GPS_SV_MAXSATS   16
 
@@ -166,6 +168,11 @@ static const uint8_t ubloxInit[] = {
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x00, 0x00, 0xFA, 0x0F,           // GGA: Global positioning system fix data
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x02, 0x00, 0xFC, 0x13,           // GSA: GNSS DOP and Active Satellites
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x04, 0x00, 0xFE, 0x17,           // RMC: Recommended Minimum data
+};
+
+// Legacy message set for receivers without NAV-PVT (u-blox 6 and older)
+static const uint8_t ubloxInitLegacy[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x00, 0x12, 0x50,           // disable PVT MSG
 
     // Enable UBLOX messages
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x01, 0x0E, 0x47,           // set POSLLH MSG rate
@@ -178,6 +185,18 @@ static const uint8_t ubloxInit[] = {
     0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8, 0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A,             // set rate to 5Hz (measurement period: 200ms, navigation rate: 1 cycle)
 };
 
+// NAV-PVT carries position, velocity, fix and time of one epoch in a single frame, so nothing else is requested
+static const uint8_t ubloxInitPvt[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x00, 0x0D, 0x46,           // disable POSLLH MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x03, 0x00, 0x0E, 0x48,           // disable STATUS MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x00, 0x11, 0x4E,           // disable SOL MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x30, 0x00, 0x3B, 0xA2,           // disable SVINFO MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x12, 0x00, 0x1D, 0x66,           // disable VELNED MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51,           // set PVT MSG rate
+
+    0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0x64, 0x00, 0x01, 0x00, 0x01, 0x00, 0x7A, 0x12,             // set rate to 10Hz (measurement period: 100ms, navigation rate: 1 cycle)
+};
+
 // UBlox 6 Protocol documentation - GPS.G6-SW-10018-F
 // SBAS Configuration Settings Desciption, Page 4/210
 // 31.21 CFG-SBAS (0x06 0x16), Page 142/210
@@ -219,10 +238,22 @@ static const uint8_t ubloxGalileoInit[] = {
     0x06, 0x08, 0x0E, 0x00, 0x01, 0x00, 0x01, 0x01,     // GLONASS
     0x55, 0x47
 };
+
+// Polls CFG-RATE. Its answer at the configured baud shows the receiver runs at that baud with UBX output, and the
+// measurement period tells a receiver that kept the configuration apart from one that came back with its defaults.
+static const uint8_t ubloxPollRate[] = { 0xB5, 0x62, 0x06, 0x08, 0x00, 0x00, 0x0E, 0x30 };
+
+#define GPS_PROBE_TIMEOUT               (300)
+#define GPS_CONFIG_CACHE_MAGIC          0x47500000
+
+// What the receiver was last configured with, it holds through a reset of the board that leaves the receiver powered
+static PERSISTENT uint32_t ubloxConfigCache;
+static uint16_t ubloxPolledRateMs;      // measurement period of the CFG-RATE answer, 0 until one arrives
 #endif // USE_GPS_UBLOX
 
 typedef enum {
     GPS_UNKNOWN,
+    GPS_PROBE,
     GPS_INITIALIZING,
     GPS_CHANGE_BAUD,
     GPS_CONFIGURE,
@@ -233,14 +264,15 @@ typedef enum {
 gpsData_t gpsData;
 
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 1);
 
 PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
                   .provider = GPS_NMEA,
                   .sbasMode = SBAS_AUTO,
                   .autoConfig = GPS_AUTOCONFIG_ON,
                   .autoBaud = GPS_AUTOBAUD_OFF,
-                  .gps_ublox_use_galileo = false
+                  .gps_ublox_use_galileo = false,
+                  .gps_ublox_use_nav_pvt = true
                  );
 
 static void shiftPacketLog(void) {
@@ -296,7 +328,7 @@ void gpsInit(void) {
         return;
     }
     // signal GPS "thread" to initialize when it gets to it
-    gpsSetState(GPS_INITIALIZING);
+    gpsSetState(gpsConfig()->provider == GPS_UBLOX ? GPS_PROBE : GPS_INITIALIZING);
 }
 
 #ifdef USE_GPS_NMEA
@@ -351,6 +383,13 @@ void gpsInitNmea(void) {
 #endif // USE_GPS_NMEA
 
 #ifdef USE_GPS_UBLOX
+static uint32_t ubloxConfigHash(void) {
+    uint16_t crc = crc16_ccitt_update(0, gpsConfig(), sizeof(gpsConfig_t));
+    crc = crc16_ccitt_update(crc, &gpsData.baudrateIndex, sizeof(gpsData.baudrateIndex));
+    crc = crc16_ccitt_update(crc, ubloxInit, sizeof(ubloxInit));
+    return GPS_CONFIG_CACHE_MAGIC | crc;
+}
+
 void gpsInitUblox(void) {
     uint32_t now;
     // UBX will run at the serial port's baudrate, it shouldn't be "autodetected". So here we force it to that rate
@@ -358,6 +397,27 @@ void gpsInitUblox(void) {
     if (!isSerialTransmitBufferEmpty(gpsPort))
         return;
     switch (gpsData.state) {
+    case GPS_PROBE:
+        // a receiver already at the configured baud skips the baud cycling, one that also kept its configuration
+        // skips the configuration as well and keeps the fix it has
+        now = millis();
+        if (gpsData.state_position == 0) {
+            serialSetBaudRate(gpsPort, baudRates[gpsInitData[gpsData.baudrateIndex].baudrateIndex]);
+            ubloxPolledRateMs = 0;
+            serialWriteBuf(gpsPort, ubloxPollRate, sizeof(ubloxPollRate));
+            gpsData.state_position++;
+        } else if (ubloxPolledRateMs) {
+            const uint16_t configuredRateMs = gpsConfig()->gps_ublox_use_nav_pvt ? 100 : 200;
+            if (gpsConfig()->autoConfig == GPS_AUTOCONFIG_OFF
+                    || (ubloxPolledRateMs == configuredRateMs && ubloxConfigCache == ubloxConfigHash())) {
+                gpsSetState(GPS_RECEIVING_DATA);
+            } else {
+                gpsSetState(GPS_CONFIGURE);
+            }
+        } else if (now - gpsData.state_ts > GPS_PROBE_TIMEOUT) {
+            gpsSetState(GPS_INITIALIZING);
+        }
+        break;
     case GPS_INITIALIZING:
         now = millis();
         if (now - gpsData.state_ts < GPS_BAUDRATE_CHANGE_DELAY)
@@ -401,6 +461,21 @@ void gpsInitUblox(void) {
                 gpsData.messageState++;
             }
         }
+        if (gpsData.messageState == GPS_MESSAGE_STATE_MESSAGES) {
+            const uint8_t *messages = ubloxInitLegacy;
+            size_t messagesLength = sizeof(ubloxInitLegacy);
+            if (gpsConfig()->gps_ublox_use_nav_pvt) {
+                messages = ubloxInitPvt;
+                messagesLength = sizeof(ubloxInitPvt);
+            }
+            if (gpsData.state_position < messagesLength) {
+                serialWrite(gpsPort, messages[gpsData.state_position]);
+                gpsData.state_position++;
+            } else {
+                gpsData.state_position = 0;
+                gpsData.messageState++;
+            }
+        }
         if (gpsData.messageState == GPS_MESSAGE_STATE_SBAS) {
             if (gpsData.state_position < UBLOX_SBAS_PREFIX_LENGTH) {
                 serialWrite(gpsPort, ubloxSbasPrefix[gpsData.state_position]);
@@ -424,6 +499,7 @@ void gpsInitUblox(void) {
         }
         if (gpsData.messageState >= GPS_MESSAGE_STATE_ENTRY_COUNT) {
             // ublox should be initialised, try receiving
+            ubloxConfigCache = ubloxConfigHash();
             gpsSetState(GPS_RECEIVING_DATA);
         }
         break;
@@ -463,6 +539,7 @@ void gpsUpdate(timeUs_t currentTimeUs) {
     switch (gpsData.state) {
     case GPS_UNKNOWN:
         break;
+    case GPS_PROBE:
     case GPS_INITIALIZING:
     case GPS_CHANGE_BAUD:
     case GPS_CONFIGURE:
@@ -478,7 +555,11 @@ void gpsUpdate(timeUs_t currentTimeUs) {
         gpsData.lastMessage = millis();
         gpsSol.numSat = 0;
         DISABLE_STATE(GPS_FIX);
-        gpsSetState(GPS_INITIALIZING);
+#ifdef USE_GPS_UBLOX
+        // the receiver may have lost power and with it the configuration
+        ubloxConfigCache = 0;
+#endif
+        gpsSetState(gpsConfig()->provider == GPS_UBLOX ? GPS_PROBE : GPS_INITIALIZING);
         break;
     case GPS_RECEIVING_DATA:
         // check for no data/gps timeout/cable disconnection etc
@@ -903,6 +984,38 @@ typedef struct {
     ubx_nav_svinfo_channel channel[16];         // 16 satellites * 12 byte
 } ubx_nav_svinfo;
 
+typedef struct {
+    uint32_t time;              // GPS msToW
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t time_accuracy;
+    int32_t time_nsec;
+    uint8_t fix_type;
+    uint8_t fix_status;
+    uint8_t flags2;
+    uint8_t satellites;
+    int32_t longitude;
+    int32_t latitude;
+    int32_t altitude_ellipsoid;
+    int32_t altitude_msl;
+    uint32_t horizontal_accuracy;
+    uint32_t vertical_accuracy;
+    int32_t ned_north;          // mm/s
+    int32_t ned_east;
+    int32_t ned_down;
+    int32_t speed_2d;           // mm/s
+    int32_t heading_2d;         // deg * 100000
+    uint32_t speed_accuracy;
+    uint32_t heading_accuracy;
+    uint16_t position_DOP;
+    uint8_t res[6];
+} ubx_nav_pvt;                  // fields common to protocol 14 (84 bytes) and 15+ (92 bytes)
+
 enum {
     PREAMBLE1 = 0xb5,
     PREAMBLE2 = 0x62,
@@ -914,6 +1027,7 @@ enum {
     MSG_POSLLH = 0x2,
     MSG_STATUS = 0x3,
     MSG_SOL = 0x6,
+    MSG_PVT = 0x7,
     MSG_VELNED = 0x12,
     MSG_SVINFO = 0x30,
     MSG_CFG_PRT = 0x00,
@@ -937,6 +1051,11 @@ enum {
     NAV_STATUS_TIME_SECOND_VALID = 8
 } ubx_nav_status_bits;
 
+enum {
+    NAV_PVT_VALID_DATE = 1,
+    NAV_PVT_VALID_TIME = 2
+} ubx_nav_pvt_valid_bits;
+
 // Packet checksum accumulators
 static uint8_t _ck_a;
 static uint8_t _ck_b;
@@ -981,6 +1100,7 @@ static union {
     ubx_nav_solution solution;
     ubx_nav_velned velned;
     ubx_nav_svinfo svinfo;
+    ubx_nav_pvt pvt;
     uint8_t bytes[UBLOX_PAYLOAD_SIZE];
 } _buffer;
 
@@ -996,6 +1116,12 @@ void _update_checksum(uint8_t *data, uint8_t len, uint8_t *ck_a, uint8_t *ck_b)
 static bool UBLOX_parse_gps(void) {
     uint32_t i;
     *gpsPacketLogChar = LOG_IGNORED;
+    if (_class == CLASS_CFG) {
+        if (_msg_id == MSG_CFG_RATE && _payload_length >= 2) {
+            ubloxPolledRateMs = _buffer.bytes[0] | (_buffer.bytes[1] << 8);
+        }
+        return false;
+    }
     switch (_msg_id) {
     case MSG_POSLLH:
         *gpsPacketLogChar = LOG_UBLOX_POSLLH;
@@ -1039,6 +1165,40 @@ static bool UBLOX_parse_gps(void) {
         gpsSol.groundCourse = (uint16_t) (_buffer.velned.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
         _new_speed = true;
         break;
+    case MSG_PVT:
+        // decoded straight out of the receive buffer, one frame is a complete solution
+        if (_payload_length < sizeof(ubx_nav_pvt)) {
+            return false;
+        }
+        *gpsPacketLogChar = LOG_UBLOX_PVT;
+        next_fix = (_buffer.pvt.fix_status & NAV_STATUS_FIX_VALID) && (_buffer.pvt.fix_type == FIX_3D);
+        if (next_fix) {
+            ENABLE_STATE(GPS_FIX);
+        } else {
+            DISABLE_STATE(GPS_FIX);
+        }
+        gpsSol.llh.lon = _buffer.pvt.longitude;
+        gpsSol.llh.lat = _buffer.pvt.latitude;
+        gpsSol.llh.alt = _buffer.pvt.altitude_msl / 10;  //alt in cm
+        gpsSol.numSat = _buffer.pvt.satellites;
+        gpsSol.hdop = _buffer.pvt.position_DOP;         // no HDOP in NAV-PVT, PDOP is the closest
+        gpsSol.groundSpeed = _buffer.pvt.speed_2d / 10;  // mm/s to cm/s
+        gpsSol.groundCourse = (uint16_t) (_buffer.pvt.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+#ifdef USE_RTC_TIME
+        if (!rtcHasTime() && (_buffer.pvt.valid & NAV_PVT_VALID_DATE) && (_buffer.pvt.valid & NAV_PVT_VALID_TIME)) {
+            dateTime_t dt;
+            dt.year = _buffer.pvt.year;
+            dt.month = _buffer.pvt.month;
+            dt.day = _buffer.pvt.day;
+            dt.hours = _buffer.pvt.hour;
+            dt.minutes = _buffer.pvt.min;
+            dt.seconds = _buffer.pvt.sec;
+            dt.millis = (_buffer.pvt.time_nsec > 0) ? _buffer.pvt.time_nsec / 1000000 : 0;
+            rtcSetDateTime(&dt);
+        }
+#endif
+        _new_position = _new_speed = false;
+        return true;
     case MSG_SVINFO:
         *gpsPacketLogChar = LOG_UBLOX_SVINFO;
         GPS_numCh = _buffer.svinfo.numCh;
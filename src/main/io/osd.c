@@ -48,6 +48,7 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
+#include "common/memory.h"
 #include "common/olc.h"
 #include "common/printf.h"
 #include "common/typeconversion.h"
@@ -171,6 +172,32 @@ static escSensorData_t *escDataCombined;
 
 static uint8_t leftScreen;
 
+/*
+ * Elements are drawn over what they drew last time instead of onto a cleared screen. Every character cell remembers
+ * which element drew it, and an element showing the same text as last time is skipped while it still owns all of its
+ * cells. Cells nothing drew during a pass are blanked at the end of it, so the result is the same as clearing first,
+ * but the display only sees the characters that changed.
+ */
+#define OSD_CELLS_MAX               VIDEO_BUFFER_CHARS_PAL
+#define OSD_CELL_FREE               0xFF
+#define OSD_FULL_REDRAW_INTERVAL_US REFRESH_1S
+
+#define OSD_CELL_DRAWN_WORDS        ((OSD_CELLS_MAX + 31) / 32)
+
+// Allocated by osdInit(), without them every pass clears the screen and draws it in full
+static uint8_t *osdCellOwner;
+static uint32_t *osdCellDrawn;
+static uint32_t osdElementTextHash[OSD_ITEM_COUNT];
+static uint8_t osdCellCols;
+static uint8_t osdCellRows;
+static bool osdElementsOnScreen = false;
+
+// Elements not drawn during a pass, because they weren't due or the pass ran out of time, keep what they showed
+static uint32_t osdElementKept[(OSD_ITEM_COUNT + 31) / 32];
+static timeUs_t osdElementDueAt[OSD_ITEM_COUNT];
+static uint8_t osdDrawList[OSD_ITEM_COUNT];
+static uint8_t osdDrawListCount;
+
 static const char compassBar[] = {
     SYM_HEADING_W,
     SYM_HEADING_LINE, SYM_HEADING_DIVIDED_LINE, SYM_HEADING_LINE,
@@ -225,7 +252,7 @@ static const uint8_t osdElementDisplayOrder[] = {
 #endif
 };
 
-PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 5);
+PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 6);
 
 /**
  * Gets the correct altitude symbol for the current unit system
@@ -289,6 +316,13 @@ static char osdGetTemperatureSymbolForSelectedUnit(void) {
 }
 #endif
 
+// terminates the string at end with one more character
+static char *osdAppendChar(char *end, char ch) {
+    *end++ = ch;
+    *end = '\0';
+    return end;
+}
+
 static void osdFormatAltitudeString(char * buff, int altitude) {
     const int alt = osdGetMetersToSelectedUnit(altitude) / 10;
     int pos = 0;
@@ -296,11 +330,16 @@ static void osdFormatAltitudeString(char * buff, int altitude) {
     if (alt < 0) {
         buff[pos++] = '-';
     }
-    tfp_sprintf(buff + pos, "%01d.%01d%c", abs(alt) / 10, abs(alt) % 10, osdGetMetersToSelectedUnitSymbol());
+    osdAppendChar(formatFixed(buff + pos, abs(alt), 1, 0), osdGetMetersToSelectedUnitSymbol());
 }
 
 static void osdFormatPID(char * buff, const char * label, const pidf_t * pid) {
-    tfp_sprintf(buff, "%s %3d %3d %3d", label, pid->P, pid->I, pid->D);
+    while (*label) {
+        *buff++ = *label++;
+    }
+    buff = formatInt(osdAppendChar(buff, ' '), pid->P, 3, ' ');
+    buff = formatInt(osdAppendChar(buff, ' '), pid->I, 3, ' ');
+    formatInt(osdAppendChar(buff, ' '), pid->D, 3, ' ');
 }
 
 static uint8_t osdGetHeadingIntoDiscreteDirections(int heading, unsigned directions) {
@@ -356,11 +395,11 @@ STATIC_UNIT_TESTED void osdFormatTime(char * buff, osd_timer_precision_e precisi
     switch (precision) {
     case OSD_TIMER_PREC_SECOND:
     default:
-        tfp_sprintf(buff, "%02d:%02d", minutes, seconds);
+        formatTime(buff, minutes * 60 + seconds);
         break;
     case OSD_TIMER_PREC_HUNDREDTHS: {
         const int hundredths = (time / 10000) % 100;
-        tfp_sprintf(buff, "%02d:%02d.%02d", minutes, seconds, hundredths);
+        formatInt(osdAppendChar(formatTime(buff, minutes * 60 + seconds), '.'), hundredths, 2, '0');
         break;
     }
     }
@@ -448,6 +487,87 @@ bool osdWarnGetState(uint8_t warningIndex) {
     return osdConfig()->enabledWarnings & (1 << warningIndex);
 }
 
+static int osdCellIndex(int x, int y) {
+    if (x >= osdCellCols || y >= osdCellRows) {
+        return -1;
+    }
+    return y * osdCellCols + x;
+}
+
+static void osdCellSetDrawn(int cell, uint8_t item) {
+    osdCellOwner[cell] = item;
+    osdCellDrawn[cell / 32] |= 1U << (cell % 32);
+}
+
+static uint32_t osdTextHash(uint8_t x, uint8_t y, const char *text) {
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    hash = (hash ^ x) * 16777619U;
+    hash = (hash ^ y) * 16777619U;
+    while (*text) {
+        hash = (hash ^ (uint8_t)*text++) * 16777619U;
+    }
+    return hash;
+}
+
+static void osdElementWriteChar(uint8_t item, uint8_t x, uint8_t y, uint8_t c) {
+    displayWriteChar(osdDisplayPort, x, y, c);
+    const int cell = osdCellIndex(x, y);
+    if (cell >= 0) {
+        osdCellSetDrawn(cell, item);
+    }
+}
+
+static void osdElementWrite(uint8_t item, uint8_t x, uint8_t y, const char *text) {
+    const uint32_t hash = osdTextHash(x, y, text);
+    bool unchanged = hash == osdElementTextHash[item];
+    for (int i = 0; text[i] && unchanged; i++) {
+        const int cell = osdCellIndex(x + i, y);
+        unchanged = cell < 0 || osdCellOwner[cell] == item;
+    }
+    if (!unchanged) {
+        displayWrite(osdDisplayPort, x, y, text);
+        osdElementTextHash[item] = hash;
+    }
+    for (int i = 0; text[i]; i++) {
+        const int cell = osdCellIndex(x + i, y);
+        if (cell >= 0) {
+            osdCellSetDrawn(cell, item);
+        }
+    }
+}
+
+// Blank the cells still showing something that wasn't drawn again during this pass
+static void osdBlankUndrawnCells(void) {
+    char blanks[OSD_ELEMENT_BUFFER_LENGTH];
+    for (int y = 0; y < osdCellRows; y++) {
+        int runStart = -1;
+        for (int x = 0; x <= osdCellCols; x++) {
+            const int cell = y * osdCellCols + x;
+            const uint8_t owner = x < osdCellCols ? osdCellOwner[cell] : OSD_CELL_FREE;
+            const bool blank = owner != OSD_CELL_FREE && !(osdCellDrawn[cell / 32] & (1U << (cell % 32)))
+                && !(osdElementKept[owner / 32] & (1U << (owner % 32)));
+            if (blank) {
+                osdCellOwner[cell] = OSD_CELL_FREE;
+                if (runStart < 0) {
+                    runStart = x;
+                }
+            }
+            if (runStart >= 0 && (!blank || x - runStart + 1 == (int)sizeof(blanks) - 1)) {
+                const int runLength = x - runStart + (blank ? 1 : 0);
+                memset(blanks, ' ', runLength);
+                blanks[runLength] = '\0';
+                displayWrite(osdDisplayPort, runStart, y, blanks);
+                runStart = -1;
+            }
+        }
+    }
+    if (osdCellDrawn) {
+        memset(osdCellDrawn, 0, OSD_CELL_DRAWN_WORDS * sizeof(uint32_t));
+    }
+    memset(osdElementKept, 0, sizeof(osdElementKept));
+}
+
 static bool osdDrawSingleElement(uint8_t item) {
     if (!VISIBLE(osdConfig()->item_pos[item]) || BLINK(item)) {
         return false;
@@ -473,7 +593,7 @@ static bool osdDrawSingleElement(uint8_t item) {
                 }
                 if (osdLQfinal > 300)
                     osdLQfinal = 300;
-                tfp_sprintf(buff, "%c%3d", LINK_QUALITY, osdLQfinal);
+                formatInt(osdAppendChar(buff, LINK_QUALITY), osdLQfinal, 3, ' ');
                 break;
             case MODE:
                 if (osdLQ > 100)
@@ -496,7 +616,7 @@ static bool osdDrawSingleElement(uint8_t item) {
                 break;
             case SIMPLE:
                 osdLQfinal=osdLQ;
-                tfp_sprintf(buff, "%c%3d", LINK_QUALITY, osdLQfinal);
+                formatInt(osdAppendChar(buff, LINK_QUALITY), osdLQfinal, 3, ' ');
                 break;
             case TBS:
             default:
@@ -510,14 +630,14 @@ static bool osdDrawSingleElement(uint8_t item) {
                 }
                 if (osdLQfinal > 300)
                     osdLQfinal = 300;
-                tfp_sprintf(buff, "%c%3d", LINK_QUALITY, osdLQfinal);
+                formatInt(osdAppendChar(buff, LINK_QUALITY), osdLQfinal, 3, ' ');
                 break;
             }
         } else {
             uint16_t osdRssi = getRssi() * 100 / 1024; // change range
             if (osdRssi >= 100)
                 osdRssi = 99;
-            tfp_sprintf(buff, "%c%2d", SYM_RSSI, osdRssi);
+            formatInt(osdAppendChar(buff, SYM_RSSI), osdRssi, 2, ' ');
         }
         break;
     }
@@ -574,28 +694,28 @@ static bool osdDrawSingleElement(uint8_t item) {
     }
     case OSD_MAIN_BATT_VOLTAGE:
         buff[0] = osdGetBatterySymbol(osdGetBatteryAverageCellVoltage());
-        tfp_sprintf(buff + 1, "%2d.%1d%c", getBatteryVoltage() / 10, getBatteryVoltage() % 10, SYM_VOLT);
+        osdAppendChar(formatFixed(buff + 1, getBatteryVoltage(), 1, 4), SYM_VOLT);
         break;
     case OSD_CURRENT_DRAW: {
         const int32_t amperage = getAmperage();
-        tfp_sprintf(buff, "%3d.%02d%c", abs(amperage) / 100, abs(amperage) % 100, SYM_AMP);
+        osdAppendChar(formatFixed(buff, abs(amperage), 2, 6), SYM_AMP);
         break;
     }
     case OSD_MAH_DRAWN:
-        tfp_sprintf(buff, "%4d%c", getMAhDrawn(), SYM_MAH);
+        osdAppendChar(formatInt(buff, getMAhDrawn(), 4, ' '), SYM_MAH);
         break;
 #ifdef USE_GPS
     case OSD_GPS_SATS:
-        tfp_sprintf(buff, "%c%c%2d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat);
+        formatInt(osdAppendChar(osdAppendChar(buff, SYM_SAT_L), SYM_SAT_R), gpsSol.numSat, 2, ' ');
         break;
     case OSD_GPS_SPEED:
         // FIXME ideally we want to use SYM_KMH symbol but it's not in the font any more, so we use K (M for MPH)
         switch (osdConfig()->units) {
         case OSD_UNIT_IMPERIAL:
-            tfp_sprintf(buff, "%c%3d%c", SYM_SPEED, CM_S_TO_MPH(gpsSol.groundSpeed), SYM_MPH);
+            osdAppendChar(formatInt(osdAppendChar(buff, SYM_SPEED), CM_S_TO_MPH(gpsSol.groundSpeed), 3, ' '), SYM_MPH);
             break;
         default:
-            tfp_sprintf(buff, "%c%3d%c", SYM_SPEED, CM_S_TO_KM_H(gpsSol.groundSpeed), SYM_KMH);
+            osdAppendChar(formatInt(osdAppendChar(buff, SYM_SPEED), CM_S_TO_KM_H(gpsSol.groundSpeed), 3, ' '), SYM_KMH);
             break;
         }
         break;
@@ -737,7 +857,7 @@ static bool osdDrawSingleElement(uint8_t item) {
     case OSD_THROTTLE_POS:
         buff[0] = SYM_THR;
         buff[1] = SYM_THR1;
-        tfp_sprintf(buff + 2, "%3d", (constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX) - PWM_RANGE_MIN) * 100 / (PWM_RANGE_MAX - PWM_RANGE_MIN));
+        formatInt(buff + 2, (constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX) - PWM_RANGE_MIN) * 100 / (PWM_RANGE_MAX - PWM_RANGE_MIN), 3, ' ');
         break;
 #if defined(USE_VTX_COMMON)
     case OSD_VTX_CHANNEL: {
@@ -773,7 +893,7 @@ static bool osdDrawSingleElement(uint8_t item) {
         for (int x = -4; x <= 4; x++) {
             const int y = ((-rollAngle * x) / 64) - pitchAngle;
             if (y >= 0 && y <= 81) {
-                displayWriteChar(osdDisplayPort, elemPosX + x, elemPosY + (y / AH_SYMBOL_COUNT), (SYM_AH_BAR9_0 + (y % AH_SYMBOL_COUNT)));
+                osdElementWriteChar(item, elemPosX + x, elemPosY + (y / AH_SYMBOL_COUNT), (SYM_AH_BAR9_0 + (y % AH_SYMBOL_COUNT)));
             }
         }
         return true;
@@ -783,12 +903,12 @@ static bool osdDrawSingleElement(uint8_t item) {
         const int8_t hudwidth = AH_SIDEBAR_WIDTH_POS;
         const int8_t hudheight = AH_SIDEBAR_HEIGHT_POS;
         for (int y = -hudheight; y <= hudheight; y++) {
-            displayWriteChar(osdDisplayPort, elemPosX - hudwidth, elemPosY + y, SYM_AH_DECORATION);
-            displayWriteChar(osdDisplayPort, elemPosX + hudwidth, elemPosY + y, SYM_AH_DECORATION);
+            osdElementWriteChar(item, elemPosX - hudwidth, elemPosY + y, SYM_AH_DECORATION);
+            osdElementWriteChar(item, elemPosX + hudwidth, elemPosY + y, SYM_AH_DECORATION);
         }
         // AH level indicators
-        displayWriteChar(osdDisplayPort, elemPosX - hudwidth + 1, elemPosY, SYM_AH_LEFT);
-        displayWriteChar(osdDisplayPort, elemPosX + hudwidth - 1, elemPosY, SYM_AH_RIGHT);
+        osdElementWriteChar(item, elemPosX - hudwidth + 1, elemPosY, SYM_AH_LEFT);
+        osdElementWriteChar(item, elemPosX + hudwidth - 1, elemPosY, SYM_AH_RIGHT);
         return true;
     }
     case OSD_G_FORCE: {
@@ -798,11 +918,11 @@ static bool osdDrawSingleElement(uint8_t item) {
             osdGForce += a * a;
         }
         osdGForce = fast_fsqrtf(osdGForce) / acc.dev.acc_1G;
-        tfp_sprintf(buff, "%01d.%01dG", (int)osdGForce, (int)(osdGForce * 10) % 10);
+        osdAppendChar(formatFixed(buff, (int)(osdGForce * 10), 1, 0), 'G');
         break;
     }
     case OSD_LULU_N:
-        tfp_sprintf(buff, "N=%2d", &currentPidProfile->lulu_n_val);
+        formatInt(osdAppendChar(osdAppendChar(buff, 'N'), '='), currentPidProfile->lulu_n_val, 2, ' ');
         break;
     case OSD_ROLL_PIDS:
         osdFormatPID(buff, "ROL", &currentPidProfile->pid[PID_ROLL]);
@@ -814,7 +934,7 @@ static bool osdDrawSingleElement(uint8_t item) {
         osdFormatPID(buff, "YAW", &currentPidProfile->pid[PID_YAW]);
         break;
     case OSD_POWER:
-        tfp_sprintf(buff, "%4dW", getAmperage() * getBatteryVoltage() / 1000);
+        osdAppendChar(formatInt(buff, getAmperage() * getBatteryVoltage() / 1000, 4, ' '), 'W');
         break;
     case OSD_PIDRATE_PROFILE:
         tfp_sprintf(buff, "%d-%d", getCurrentPidProfileIndex() + 1, getCurrentControlRateProfileIndex() + 1);
@@ -943,7 +1063,7 @@ static bool osdDrawSingleElement(uint8_t item) {
     case OSD_AVG_CELL_VOLTAGE: {
         const int cellV = osdGetBatteryAverageCellVoltage();
         buff[0] = osdGetBatterySymbol(cellV);
-        tfp_sprintf(buff + 1, "%d.%02d%c", cellV / 100, cellV % 100, SYM_VOLT);
+        osdAppendChar(formatFixed(buff + 1, cellV, 2, 0), SYM_VOLT);
         break;
     }
     case OSD_MAH_PERCENT: {
@@ -951,7 +1071,7 @@ static bool osdDrawSingleElement(uint8_t item) {
         const float value = constrain(getMAhDrawn(), 0, batteryConfig()->batteryCapacity);
         // Calculate percentage of total mAh used
         const uint16_t mAhUsedPercent = ceilf(value / (batteryConfig()->batteryCapacity / 100.0f));
-        tfp_sprintf(buff , "%c%3d%%", SYM_MAH, mAhUsedPercent);
+        osdAppendChar(formatInt(osdAppendChar(buff, SYM_MAH), mAhUsedPercent, 3, ' '), '%');
         break;
     }
     case OSD_DEBUG:
@@ -961,8 +1081,8 @@ static bool osdDrawSingleElement(uint8_t item) {
     case OSD_ROLL_ANGLE: {
         const char symbol = (item == OSD_PITCH_ANGLE) ? SYM_PITCH : SYM_ROLL ;
         const int angle = (item == OSD_PITCH_ANGLE) ? attitude.values.pitch : getAngleModeAngles(ROLL);
-        //tfp_sprintf(buff, "%c", symbol);
-        tfp_sprintf(buff, "%c%c%02d.%01d", symbol, angle < 0 ? '-' : ' ', abs(angle / 10), abs(angle % 10));
+        char *end = osdAppendChar(osdAppendChar(buff, symbol), angle < 0 ? '-' : ' ');
+        formatInt(osdAppendChar(formatInt(end, abs(angle / 10), 2, '0'), '.'), abs(angle % 10), 1, ' ');
         break;
     }
     case OSD_MAIN_BATT_USAGE: {
@@ -995,7 +1115,7 @@ static bool osdDrawSingleElement(uint8_t item) {
         break;
     case OSD_NUMERICAL_HEADING: {
         const int heading = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
-        tfp_sprintf(buff, "%c%03d", osdGetDirectionSymbolFromHeading(heading), heading);
+        formatInt(osdAppendChar(buff, osdGetDirectionSymbolFromHeading(heading)), heading, 3, '0');
         break;
     }
     case OSD_NUMERICAL_VARIO: {
@@ -1010,7 +1130,7 @@ static bool osdDrawSingleElement(uint8_t item) {
         if (haveBaro || haveGps) {
             const int verticalSpeed = osdGetMetersToSelectedUnit(getEstimatedVario());
             const char directionSymbol = verticalSpeed < 0 ? SYM_ARROW_SOUTH : SYM_ARROW_NORTH;
-            tfp_sprintf(buff, "%c%01d.%01d", directionSymbol, abs(verticalSpeed / 100), abs((verticalSpeed % 100) / 10));
+            formatFixed(osdAppendChar(buff, directionSymbol), abs(verticalSpeed / 10), 1, 0);
         } else {
             // We use this symbol when we don't have a valid measure
             buff[0] = SYM_QUES;
@@ -1023,12 +1143,12 @@ static bool osdDrawSingleElement(uint8_t item) {
 #ifdef USE_ESC_SENSOR
     case OSD_ESC_TMP:
         if (feature(FEATURE_ESC_SENSOR)) {
-            tfp_sprintf(buff, "%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(escDataCombined->temperature), osdGetTemperatureSymbolForSelectedUnit());
+            osdAppendChar(formatInt(osdAppendChar(buff, SYM_TEMPERATURE), osdConvertTemperatureToSelectedUnit(escDataCombined->temperature), 3, ' '), osdGetTemperatureSymbolForSelectedUnit());
         }
         break;
     case OSD_ESC_RPM:
         if (feature(FEATURE_ESC_SENSOR)) {
-            tfp_sprintf(buff, "%5d", escDataCombined == NULL ? 0 : calcEscRpm(escDataCombined->rpm));
+            formatInt(buff, escDataCombined == NULL ? 0 : calcEscRpm(escDataCombined->rpm), 5, ' ');
         }
         break;
 #endif
@@ -1046,55 +1166,122 @@ static bool osdDrawSingleElement(uint8_t item) {
 #endif
 #ifdef USE_ADC_INTERNAL
     case OSD_CORE_TEMPERATURE:
-        tfp_sprintf(buff, "%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), osdGetTemperatureSymbolForSelectedUnit());
+        osdAppendChar(formatInt(osdAppendChar(buff, SYM_TEMPERATURE), osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), 3, ' '), osdGetTemperatureSymbolForSelectedUnit());
         break;
 #endif
     default:
         return false;
     }
-    displayWrite(osdDisplayPort, elemPosX, elemPosY, buff);
+    osdElementWrite(item, elemPosX, elemPosY, buff);
     return true;
 }
 
-static void osdDrawElements(void) {
-    displayClearScreen(osdDisplayPort);
+// Elements that are expensive to format and change slowly are drawn at most this often
+static timeDelta_t osdElementRefreshIntervalUs(uint8_t item) {
+    switch (item) {
+    case OSD_GPS_LAT:
+    case OSD_GPS_LON:
+    case OSD_PLUS_CODE:
+    case OSD_ESC_TMP:
+    case OSD_RTC_DATETIME:
+    case OSD_CORE_TEMPERATURE:
+        return 200000;
+    default:
+        return 0;
+    }
+}
+
+static void osdAddElement(uint8_t item) {
+    if (VISIBLE(osdConfig()->item_pos[item])) {
+        osdDrawList[osdDrawListCount++] = item;
+    }
+}
+
+/*
+ * Draw the elements in osdDrawList until osd_element_budget microseconds have been spent. The next pass starts with
+ * the first element that didn't fit, so a slow element can't keep the ones after it from ever being drawn.
+ */
+static void osdDrawElementList(timeUs_t currentTimeUs, bool drawAll) {
+    static uint8_t nextIndex = 0;
+    const timeDelta_t budgetUs = osdConfig()->element_budget_us;
+    const timeUs_t startUs = micros();
+    bool outOfTime = false;
+    if (nextIndex >= osdDrawListCount) {
+        nextIndex = 0;
+    }
+    const uint8_t firstIndex = drawAll ? 0 : nextIndex;
+    for (int i = 0; i < osdDrawListCount; i++) {
+        const uint8_t index = (firstIndex + i) % osdDrawListCount;
+        const uint8_t item = osdDrawList[index];
+        if (!drawAll) {
+            if (!outOfTime && budgetUs && i > 0 && cmpTimeUs(micros(), startUs) >= budgetUs) {
+                outOfTime = true;
+                nextIndex = index;
+            }
+            if (outOfTime || cmpTimeUs(currentTimeUs, osdElementDueAt[item]) < 0) {
+                osdElementKept[item / 32] |= 1U << (item % 32);
+                continue;
+            }
+        }
+        osdDrawSingleElement(item);
+        osdElementDueAt[item] = currentTimeUs + osdElementRefreshIntervalUs(item);
+    }
+}
+
+static void osdDrawElements(timeUs_t currentTimeUs, bool fullRedraw) {
+    const bool incremental = osdCellOwner && osdCellDrawn && osdDisplayPort->rows * osdDisplayPort->cols <= OSD_CELLS_MAX;
+    const bool clearScreen = fullRedraw || !incremental || osdDisplayPort->rows != osdCellRows || osdDisplayPort->cols != osdCellCols;
+    if (clearScreen) {
+        displayClearScreen(osdDisplayPort);
+        if (osdCellOwner) {
+            memset(osdCellOwner, OSD_CELL_FREE, OSD_CELLS_MAX);
+        }
+        // Screens too big to keep track of are cleared and redrawn in full every time
+        osdCellRows = incremental ? osdDisplayPort->rows : 0;
+        osdCellCols = incremental ? osdDisplayPort->cols : 0;
+    }
     // Hide OSD when OSDSW mode is active
     if (IS_RC_MODE_ACTIVE(BOXOSD)) {
+        osdBlankUndrawnCells();
         return;
     }
+    osdDrawListCount = 0;
     if (sensors(SENSOR_ACC)) {
-        osdDrawSingleElement(OSD_ARTIFICIAL_HORIZON);
-        osdDrawSingleElement(OSD_G_FORCE);
+        osdAddElement(OSD_ARTIFICIAL_HORIZON);
+        osdAddElement(OSD_G_FORCE);
     }
     for (unsigned i = 0; i < sizeof(osdElementDisplayOrder); i++) {
-        osdDrawSingleElement(osdElementDisplayOrder[i]);
+        osdAddElement(osdElementDisplayOrder[i]);
     }
 #ifdef USE_GPS
     if (sensors(SENSOR_GPS)) {
-        osdDrawSingleElement(OSD_GPS_SATS);
-        osdDrawSingleElement(OSD_GPS_SPEED);
-        osdDrawSingleElement(OSD_GPS_LAT);
-        osdDrawSingleElement(OSD_GPS_LON);
-        osdDrawSingleElement(OSD_HOME_DIST);
-        osdDrawSingleElement(OSD_HOME_DIR);
-        osdDrawSingleElement(OSD_PLUS_CODE);
+        osdAddElement(OSD_GPS_SATS);
+        osdAddElement(OSD_GPS_SPEED);
+        osdAddElement(OSD_GPS_LAT);
+        osdAddElement(OSD_GPS_LON);
+        osdAddElement(OSD_HOME_DIST);
+        osdAddElement(OSD_HOME_DIR);
+        osdAddElement(OSD_PLUS_CODE);
     }
 #endif // GPS
 #ifdef USE_ESC_SENSOR
     if (feature(FEATURE_ESC_SENSOR)) {
-        osdDrawSingleElement(OSD_ESC_TMP);
-        osdDrawSingleElement(OSD_ESC_RPM);
+        osdAddElement(OSD_ESC_TMP);
+        osdAddElement(OSD_ESC_RPM);
     }
 #endif
 #ifdef USE_RTC_TIME
-    osdDrawSingleElement(OSD_RTC_DATETIME);
+    osdAddElement(OSD_RTC_DATETIME);
 #endif
 #ifdef USE_OSD_ADJUSTMENTS
-    osdDrawSingleElement(OSD_ADJUSTMENT_RANGE);
+    osdAddElement(OSD_ADJUSTMENT_RANGE);
 #endif
 #ifdef USE_ADC_INTERNAL
-    osdDrawSingleElement(OSD_CORE_TEMPERATURE);
+    osdAddElement(OSD_CORE_TEMPERATURE);
 #endif
+    // A cleared screen needs every element drawn again straight away
+    osdDrawElementList(currentTimeUs, clearScreen);
+    osdBlankUndrawnCells();
 }
 
 void pgResetFn_osdConfig(osdConfig_t *osdConfig) {
@@ -1142,6 +1329,7 @@ void pgResetFn_osdConfig(osdConfig_t *osdConfig) {
     osdConfig->ahMaxPitch = 20; // 20 degrees
     osdConfig->ahMaxRoll = 40; // 40 degrees
     osdConfig->task_frequency = 60; // at 125 or 150 the refresh rate is exactly 25 (PAL) or 30 (NTSC)
+    osdConfig->element_budget_us = 400;
     osdConfig->logo_on_arming = OSD_LOGO_ARMING_OFF;
     osdConfig->logo_on_arming_duration = 5;  // 0.5 seconds
     osdConfig->plus_code_digits = 11; // Number of digits to use in OSD_PLUS_CODE
@@ -1168,6 +1356,10 @@ void osdInit(displayPort_t *osdDisplayPortToUse) {
 #ifdef USE_CMS
     cmsDisplayPortRegister(osdDisplayPort);
 #endif
+    if (!osdCellOwner) {
+        osdCellOwner = memAllocate(OSD_CELLS_MAX);
+        osdCellDrawn = memAllocate(OSD_CELL_DRAWN_WORDS * sizeof(uint32_t));
+    }
     armState = ARMING_FLAG(ARMED);
     memset(blinkBits, 0, sizeof(blinkBits));
     displayClearScreen(osdDisplayPort);
@@ -1480,11 +1672,11 @@ static void osdShowStats(uint16_t endBatteryVoltage) {
         osdDisplayStatisticLabel(top++, "MAX ALTITUDE", buff);
     }
 #ifdef USE_BLACKBOX
-    if (osdStatGetState(OSD_STAT_BLACKBOX) && blackboxConfig()->device && blackboxConfig()->device != BLACKBOX_DEVICE_SERIAL) {
+    if (osdStatGetState(OSD_STAT_BLACKBOX) && blackboxConfig()->device && !isBlackboxDeviceStream()) {
         osdGetBlackboxStatusString(buff);
         osdDisplayStatisticLabel(top++, "BLACKBOX", buff);
     }
-    if (osdStatGetState(OSD_STAT_BLACKBOX_NUMBER) && blackboxConfig()->device && blackboxConfig()->device != BLACKBOX_DEVICE_SERIAL) {
+    if (osdStatGetState(OSD_STAT_BLACKBOX_NUMBER) && blackboxConfig()->device && !isBlackboxDeviceStream()) {
         itoa(blackboxGetLogNumber(), buff, 10);
         osdDisplayStatisticLabel(top++, "BB LOG NUM", buff);
     }
@@ -1509,10 +1701,14 @@ static timeDelta_t osdShowArmed(void)
 
 STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs) {
     static timeUs_t lastTimeUs = 0;
+    static timeUs_t osdFullRedrawAt = 0;
     static bool osdStatsEnabled = false;
     static bool osdStatsVisible = false;
     static timeUs_t osdStatsRefreshTimeUs;
     static uint16_t endBatteryVoltage;
+    // Anything else drawing on the screen in this call means the elements have to start again from a clear screen
+    const bool elementsWereOnScreen = osdElementsOnScreen;
+    osdElementsOnScreen = false;
     // detect arm/disarm
     if (armState != ARMING_FLAG(ARMED)) {
         if (ARMING_FLAG(ARMED)) {
@@ -1582,7 +1778,13 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs) {
 #endif
     {
         osdUpdateAlarms();
-        osdDrawElements();
+        // Also start again from scratch now and then, in case the display lost track of what it showed
+        const bool fullRedraw = !elementsWereOnScreen || cmp32(currentTimeUs, osdFullRedrawAt) >= 0;
+        if (fullRedraw) {
+            osdFullRedrawAt = currentTimeUs + OSD_FULL_REDRAW_INTERVAL_US;
+        }
+        osdDrawElements(currentTimeUs, fullRedraw);
+        osdElementsOnScreen = true;
         displayHeartbeat(osdDisplayPort);
     }
     lastArmState = ARMING_FLAG(ARMED);
@@ -224,6 +224,7 @@ typedef struct osdConfig_s {
     uint8_t ahMaxPitch;
     uint8_t ahMaxRoll;
     uint16_t task_frequency;
+    uint16_t element_budget_us;               // time drawing elements may take per refresh, 0 to draw them all every time
     uint8_t logo_on_arming;                   // show the logo on arming
     uint8_t logo_on_arming_duration;          // display duration in 0.1s units
     bool stat_show_cell_value;
@@ -77,10 +77,10 @@
 static uint8_t suart_getc_(uint8_t *bt) {
     uint32_t btime;
     uint32_t start_time;
-    uint32_t wait_time = millis() + START_BIT_TIMEOUT_MS;
+    const uint32_t wait_time = micros() + START_BIT_TIMEOUT_MS * 1000;
     while (ESC_IS_HI) {
         // check for startbit begin
-        if (millis() >= wait_time) {
+        if (cmpTimeUs(micros(), wait_time) >= 0) {
             return 0;
         }
     }
@@ -89,7 +89,7 @@ static uint8_t suart_getc_(uint8_t *bt) {
     btime = start_time + START_BIT_TIME;
     uint16_t bitmask = 0;
     uint8_t bit = 0;
-    while (micros() < btime);
+    while (cmpTimeUs(micros(), btime) < 0);
     while (1) {
         if (ESC_IS_HI) {
             bitmask |= (1 << bit);
@@ -97,7 +97,7 @@ static uint8_t suart_getc_(uint8_t *bt) {
         btime = btime + BIT_TIME;
         bit++;
         if (bit == 10) break;
-        while (micros() < btime);
+        while (cmpTimeUs(micros(), btime) < 0);
     }
     // check start bit and stop bit
     if ((bitmask & 1) || (!(bitmask & (1 << 9)))) {
@@ -107,21 +107,23 @@ static uint8_t suart_getc_(uint8_t *bt) {
     return 1;
 }
 
-static void suart_putc_(uint8_t *tx_b) {
+// Shifts out one byte on the bit clock in btime, which carries on from the previous byte of the block
+static void suart_putc_(uint8_t tx_b, uint32_t *btime) {
     // shift out stopbit first
-    uint16_t bitmask = (*tx_b << 2) | 1 | (1 << 10);
-    uint32_t btime = micros();
+    uint16_t bitmask = (tx_b << 2) | 1 | (1 << 10);
     while (1) {
         if (bitmask & 1) {
             ESC_SET_HI; // 1
         } else {
             ESC_SET_LO; // 0
         }
-        btime = btime + BIT_TIME;
+        *btime = *btime + BIT_TIME;
         bitmask = (bitmask >> 1);
         if (bitmask == 0) break; // stopbit shifted out - but don't wait
-        while (micros() < btime);
+        while (cmpTimeUs(micros(), *btime) < 0);
     }
+    // the leading stop bit of the next byte carries on this one, so its clock starts where this stop bit did
+    *btime = *btime - BIT_TIME;
 }
 
 static uint8_16_u CRC_16;
@@ -140,14 +142,26 @@ static void ByteCrc(uint8_t *bt) {
     }
 }
 
+// len 0 means 256
+static void BlockCrc(uint8_t *pstring, uint8_t len) {
+    CRC_16.word = 0;
+    do {
+        ByteCrc(pstring);
+        pstring++;
+        len--;
+    } while (len > 0);
+}
+
+// Blocks are received and sent without work between the bytes, so the sampling of
+// each byte starts right at its start bit and a block goes out on one bit clock.
 static uint8_t BL_ReadBuf(uint8_t *pstring, uint8_t len) {
     // len 0 means 256
-    CRC_16.word = 0;
+    uint8_t *buf = pstring;
+    const uint8_t blockLen = len;
     LastCRC_16.word = 0;
     uint8_t  LastACK = brNONE;
     do {
         if (!suart_getc_(pstring)) goto timeout;
-        ByteCrc(pstring);
         pstring++;
         len--;
     } while (len > 0);
@@ -156,6 +170,7 @@ static uint8_t BL_ReadBuf(uint8_t *pstring, uint8_t len) {
         if (!suart_getc_(&LastCRC_16.bytes[0])) goto timeout;
         if (!suart_getc_(&LastCRC_16.bytes[1])) goto timeout;
         if (!suart_getc_(&LastACK)) goto timeout;
+        BlockCrc(buf, blockLen);
         if (CRC_16.word != LastCRC_16.word) {
             LastACK = brERRORCRC;
         }
@@ -167,17 +182,17 @@ timeout:
 }
 
 static void BL_SendBuf(uint8_t *pstring, uint8_t len) {
+    BlockCrc(pstring, len);
     ESC_OUTPUT;
-    CRC_16.word = 0;
+    uint32_t btime = micros();
     do {
-        suart_putc_(pstring);
-        ByteCrc(pstring);
+        suart_putc_(*pstring, &btime);
         pstring++;
         len--;
     } while (len > 0);
     if (isMcuConnected()) {
-        suart_putc_(&CRC_16.bytes[0]);
-        suart_putc_(&CRC_16.bytes[1]);
+        suart_putc_(CRC_16.bytes[0], &btime);
+        suart_putc_(CRC_16.bytes[1], &btime);
     }
     ESC_INPUT;
 }
@@ -57,14 +57,6 @@ PG_RESET_TEMPLATE(vtxSettingsConfig_t, vtxSettingsConfig,
                   .lowPowerDisarm = VTX_SETTINGS_DEFAULT_LOW_POWER_DISARM,
                  );
 
-typedef enum {
-    VTX_PARAM_POWER = 0,
-    VTX_PARAM_BANDCHAN,
-    VTX_PARAM_PITMODE,
-    VTX_PARAM_CONFIRM,
-    VTX_PARAM_COUNT
-} vtxScheduleParams_e;
-
 void vtxInit(void) {
     bool settingsUpdated = false;
     // sync frequency in parameter group when band/channel are specified
@@ -198,8 +190,10 @@ static bool vtxProcessStateUpdate(vtxDevice_t *vtxDevice) {
     return (bool)memcmp(&vtxSettingsState, &vtxState, sizeof(vtxSettingsConfig_t));
 }
 
+// Hands every setting that differs to the device in the same pass, so a band, channel and power change goes out as one
+// transaction. The drivers merge a request with one still waiting for the device, asking again until the device reports
+// the new state doesn't queue it again.
 void vtxUpdate(timeUs_t currentTimeUs) {
-    static uint8_t currentSchedule = 0;
     if (cliMode) {
         return;
     }
@@ -207,33 +201,18 @@ void vtxUpdate(timeUs_t currentTimeUs) {
     if (vtxDevice) {
         // Check input sources for config updates
         vtxControlInputPoll();
-        const uint8_t startingSchedule = currentSchedule;
-        bool vtxUpdatePending = false;
-        do {
-            switch (currentSchedule) {
-            case VTX_PARAM_POWER:
-                vtxUpdatePending = vtxProcessPower(vtxDevice);
-                break;
-            case VTX_PARAM_BANDCHAN:
-                if (vtxGetSettings().band) {
-                    vtxUpdatePending = vtxProcessBandAndChannel(vtxDevice);
+        bool vtxUpdatePending = vtxProcessPower(vtxDevice);
+        if (vtxGetSettings().band) {
+            vtxUpdatePending |= vtxProcessBandAndChannel(vtxDevice);
 #if defined(VTX_SETTINGS_FREQCMD)
-                } else {
-                    vtxUpdatePending = vtxProcessFrequency(vtxDevice);
+        } else {
+            vtxUpdatePending |= vtxProcessFrequency(vtxDevice);
 #endif
-                }
-                break;
-            case VTX_PARAM_PITMODE:
-                vtxUpdatePending = vtxProcessPitMode(vtxDevice);
-                break;
-            case VTX_PARAM_CONFIRM:
-                vtxUpdatePending = vtxProcessStateUpdate(vtxDevice);
-                break;
-            default:
-                break;
-            }
-            currentSchedule = (currentSchedule + 1) % VTX_PARAM_COUNT;
-        } while (!vtxUpdatePending && currentSchedule != startingSchedule);
+        }
+        vtxUpdatePending |= vtxProcessPitMode(vtxDevice);
+        if (!vtxUpdatePending) {
+            vtxUpdatePending = vtxProcessStateUpdate(vtxDevice);
+        }
         if (!ARMING_FLAG(ARMED) || vtxUpdatePending) {
             vtxCommonProcess(vtxDevice, currentTimeUs);
         }
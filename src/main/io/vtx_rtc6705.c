@@ -59,8 +59,23 @@ static vtxDevice_t vtxRTC6705 = {
 };
 #endif
 
-static void vtxRTC6705SetBandAndChannel(vtxDevice_t *vtxDevice, uint8_t band, uint8_t channel);
-static void vtxRTC6705SetFrequency(vtxDevice_t *vtxDevice, uint16_t frequency);
+// The setters only record a request, vtxRTC6705Process() writes it to the VTX once the SPI bus is free of the OSD and
+// after power up once the VTX has booted. The device band, channel, frequency and power are what the VTX runs with,
+// so a request that hasn't gone out yet is asked for again, and merged with the one waiting.
+typedef struct rtc6705Request_s {
+    uint16_t frequency;
+    uint8_t band;
+    uint8_t channel;
+    uint8_t powerIndex;
+    bool frequencyPending;
+    bool powerPending;
+} rtc6705Request_t;
+
+static rtc6705Request_t rtc6705Request;
+#ifdef RTC6705_POWER_PIN
+static bool rtc6705Booting = false;
+static timeUs_t rtc6705BootDoneAtUs;
+#endif
 
 bool vtxRTC6705Init(void) {
     vtxCommonSetDevice(&vtxRTC6705);
@@ -76,23 +91,65 @@ bool vtxRTC6705CanUpdate(void) {
     return true;
 }
 
-#ifdef RTC6705_POWER_PIN
-static void vtxRTC6705Configure(vtxDevice_t *vtxDevice) {
-    rtc6705SetRFPower(vtxDevice->powerIndex);
-    vtxRTC6705SetBandAndChannel(vtxDevice, vtxDevice->band, vtxDevice->channel);
-}
-
-static void vtxRTC6705EnableAndConfigure(vtxDevice_t *vtxDevice) {
-    while (!vtxRTC6705CanUpdate());
-    rtc6705Enable();
-    delay(VTX_RTC6705_BOOT_DELAY);
-    vtxRTC6705Configure(vtxDevice);
-}
-#endif
-
 static void vtxRTC6705Process(vtxDevice_t *vtxDevice, timeUs_t now) {
-    UNUSED(vtxDevice);
+    if ((!rtc6705Request.frequencyPending && !rtc6705Request.powerPending) || !vtxRTC6705CanUpdate()) {
+        return;
+    }
+#ifdef RTC6705_POWER_PIN
+    if (rtc6705Request.powerPending && rtc6705Request.powerIndex == 0) {
+        // power device off
+        if (vtxDevice->powerIndex > 0) {
+            rtc6705Disable();
+            rtc6705SetRFPower(2);  // set 6705 rf power to high
+        }
+        vtxDevice->powerIndex = 0;
+        rtc6705Booting = false;
+        rtc6705Request.powerPending = false;
+        return;
+    }
+    if (vtxDevice->powerIndex == 0) {
+        // the channel goes out with the next power up
+        if (!rtc6705Request.powerPending) {
+            return;
+        }
+        if (!rtc6705Booting) {
+            rtc6705Enable();
+            rtc6705Booting = true;
+            rtc6705BootDoneAtUs = now + VTX_RTC6705_BOOT_DELAY * 1000;
+            return;
+        }
+        if (cmpTimeUs(now, rtc6705BootDoneAtUs) < 0) {
+            return;
+        }
+        // configure channel, band and power after power up
+        rtc6705Booting = false;
+        if (!rtc6705Request.frequencyPending && vtxDevice->frequency) {
+            rtc6705Request.frequency = vtxDevice->frequency;
+            rtc6705Request.band = vtxDevice->band;
+            rtc6705Request.channel = vtxDevice->channel;
+            rtc6705Request.frequencyPending = true;
+        }
+    }
+    if (rtc6705Request.powerPending) {
+        vtxDevice->powerIndex = rtc6705Request.powerIndex;
+        rtc6705SetRFPower(rtc6705Request.powerIndex);
+        rtc6705Request.powerPending = false;
+    }
+#else
     UNUSED(now);
+    if (rtc6705Request.powerPending) {
+        vtxDevice->powerIndex = rtc6705Request.powerIndex;
+        rtc6705SetRFPower(rtc6705Request.powerIndex);
+        rtc6705Request.powerPending = false;
+    }
+#endif
+    if (rtc6705Request.frequencyPending) {
+        vtxDevice->band = rtc6705Request.band;
+        vtxDevice->channel = rtc6705Request.channel;
+        vtxDevice->frequency = rtc6705Request.frequency;
+        rtc6705SetFrequency(rtc6705Request.frequency);
+        rtc6705Request.frequencyPending = false;
+    }
 }
 
 #ifdef USE_VTX_COMMON
@@ -108,47 +165,21 @@ static bool vtxRTC6705IsReady(const vtxDevice_t *vtxDevice) {
 }
 
 static void vtxRTC6705SetBandAndChannel(vtxDevice_t *vtxDevice, uint8_t band, uint8_t channel) {
-    while (!vtxRTC6705CanUpdate());
     if (band >= 1 && band <= VTX_SETTINGS_BAND_COUNT && channel >= 1 && channel <= VTX_SETTINGS_CHANNEL_COUNT) {
-        if (vtxDevice->powerIndex > 0) {
-            vtxDevice->band = band;
-            vtxDevice->channel = channel;
-            vtxRTC6705SetFrequency(vtxDevice, vtx58frequencyTable[band - 1][channel - 1]);
-        }
+        const uint16_t frequency = vtx58frequencyTable[band - 1][channel - 1];
+        rtc6705Request.band = band;
+        rtc6705Request.channel = channel;
+        rtc6705Request.frequency = frequency;
+        rtc6705Request.frequencyPending = band != vtxDevice->band || channel != vtxDevice->channel || frequency != vtxDevice->frequency;
     }
 }
 
 static void vtxRTC6705SetPowerByIndex(vtxDevice_t *vtxDevice, uint8_t index) {
-    while (!vtxRTC6705CanUpdate());
-#ifdef RTC6705_POWER_PIN
-    if (index == 0) {
-        // power device off
-        if (vtxDevice->powerIndex > 0) {
-            // on, power it off
-            vtxDevice->powerIndex = index;
-            rtc6705Disable();
-            rtc6705SetRFPower(2);  // set 6705 rf power to high
-            return;
-        } else {
-            // already off
-        }
-    } else {
-        // change rf power and maybe turn the device on first
-        if (vtxDevice->powerIndex == 0) {
-            // if it's powered down, power it up, wait and configure channel, band and power.
-            vtxDevice->powerIndex = index;
-            vtxRTC6705EnableAndConfigure(vtxDevice);
-            return;
-        } else {
-            // if it's powered up, just set the rf power
-            vtxDevice->powerIndex = index;
-            rtc6705SetRFPower(index);
-        }
-    }
-#else
-    vtxDevice->powerIndex = MAX(index, VTX_RTC6705_MIN_POWER);
-    rtc6705SetRFPower(index);
+#ifndef RTC6705_POWER_PIN
+    index = MAX(index, VTX_RTC6705_MIN_POWER);
 #endif
+    rtc6705Request.powerIndex = index;
+    rtc6705Request.powerPending = index != vtxDevice->powerIndex;
 }
 
 static void vtxRTC6705SetPitMode(vtxDevice_t *vtxDevice, uint8_t onoff) {
@@ -158,9 +189,10 @@ static void vtxRTC6705SetPitMode(vtxDevice_t *vtxDevice, uint8_t onoff) {
 
 static void vtxRTC6705SetFrequency(vtxDevice_t *vtxDevice, uint16_t frequency) {
     if (frequency >= VTX_RTC6705_FREQ_MIN &&  frequency <= VTX_RTC6705_FREQ_MAX) {
-        frequency = constrain(frequency, VTX_RTC6705_FREQ_MIN, VTX_RTC6705_FREQ_MAX);
-        vtxDevice->frequency = frequency;
-        rtc6705SetFrequency(frequency);
+        rtc6705Request.band = vtxDevice->band;
+        rtc6705Request.channel = vtxDevice->channel;
+        rtc6705Request.frequency = frequency;
+        rtc6705Request.frequencyPending = frequency != vtxDevice->frequency;
     }
 }
 
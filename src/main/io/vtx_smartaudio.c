@@ -285,9 +285,18 @@ static void saProcessResponse(uint8_t *buf, int len) {
         DEBUG_SET(DEBUG_SMARTAUDIO, 2, saDevice.freq);
         DEBUG_SET(DEBUG_SMARTAUDIO, 3, saDevice.power);
         break;
+    // the set responses echo the new value, taking it saves waiting for the next poll before the change shows
     case SA_CMD_SET_POWER: // Set Power
+        if (len < 3) {
+            break;
+        }
+        saDevice.power = buf[2];
         break;
     case SA_CMD_SET_CHAN: // Set Channel
+        if (len < 3) {
+            break;
+        }
+        saDevice.channel = buf[2];
         break;
     case SA_CMD_SET_FREQ: // Set Frequency
         if (len < 5) {
@@ -486,8 +495,22 @@ static void saQueueCmdInner(saCmdQueue_t *queue, uint8_t qSize, uint8_t *buf, in
     sa_qhead = (sa_qhead + 1) % qSize;
 }
 
+// The frames are static per command and rewritten by every request, a frame that is still queued already carries the
+// newest values, so queueing it once more would only send the same frame twice.
+static bool saQueueContains(const uint8_t *buf) {
+    const bool legacy = isLegacySmartAudioEnabled();
+    const saCmdQueue_t *queue = legacy ? sa_akk_mach2_queue : sa_queue;
+    const uint8_t qSize = legacy ? SA_AKK_MACH2_QSIZE : SA_QSIZE;
+    for (uint8_t i = sa_qtail; i != sa_qhead; i = (i + 1) % qSize) {
+        if (queue[i].buf == buf) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void saQueueCmd(uint8_t *buf, int len) {
-    if (saQueueFull()) {
+    if (saQueueFull() || saQueueContains(buf)) {
         return;
     }
     if (isLegacySmartAudioEnabled()) {
@@ -539,8 +562,9 @@ static void saDoDevSetFreq(uint16_t freq) {
     buf[6] = CRC8(buf, 6);
     // Need to work around apparent SmartAudio bug when going from 'channel'
     // to 'user-freq' mode, where the set-freq command will fail if the freq
-    // value is unchanged from the previous 'user-freq' mode
-    if ((saDevice.mode & SA_MODE_GET_FREQ_BY_FREQ) == 0 && freq == saDevice.freq) {
+    // value is unchanged from the previous 'user-freq' mode. The switch has to
+    // go out first, which it can't once the set-freq frame is queued.
+    if ((saDevice.mode & SA_MODE_GET_FREQ_BY_FREQ) == 0 && freq == saDevice.freq && !saQueueContains(buf)) {
         memcpy(&switchBuf, &buf, sizeof(buf));
         const uint16_t switchFreq = freq + ((freq == VTX_SMARTAUDIO_MAX_FREQUENCY_MHZ) ? -1 : 1);
         switchBuf[4] = (switchFreq >> 8);
@@ -289,7 +289,7 @@ static int emfat_find_log(emfat_entry_t *entry, int maxCount) {
     int fileNumber = 0;
     uint8_t buffer[18];
     int logCount = 0;
-    for ( ; currOffset < limit ; currOffset += 2048) { // XXX 2048 = FREE_BLOCK_SIZE in io/flashfs.c
+    for ( ; currOffset < limit ; currOffset += FLASHFS_FREE_BLOCK_SIZE) {
         flashfsReadAbs(currOffset, buffer, 18);
         if (strncmp((char *)buffer, "H Product:Blackbox", 18)) {
             continue;
@@ -29,6 +29,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -62,6 +63,15 @@
 #define STORAGE_BLK_NBR                  0x10000
 #define STORAGE_BLK_SIZ                  0x200
 
+// Once a read is done the blocks after it are fetched by DMA while USB sends the ones read, the host
+// pulls files in order so its next request usually finds them waiting. One MSC packet ahead
+#define STORAGE_READ_AHEAD_BLOCKS        (MSC_MEDIA_PACKET / STORAGE_BLK_SIZ)
+
+static DMA_RAM uint32_t readAheadBuffer[STORAGE_READ_AHEAD_BLOCKS * STORAGE_BLK_SIZ / sizeof(uint32_t)];
+static uint32_t readAheadAddr;
+static uint16_t readAheadBlocks;    // blocks held in readAheadBuffer, 0 for none
+static bool readAheadPending;       // the DMA may still be filling readAheadBuffer
+
 static int8_t STORAGE_Init (uint8_t lun);
 
 #ifdef USE_HAL_DRIVER
@@ -152,12 +162,35 @@ static int8_t STORAGE_Init (uint8_t lun) {
 #endif
     UNUSED(lun);
     LED0_OFF;
+    readAheadBlocks = 0;
+    readAheadPending = false;
     SD_Initialize_LL(SDIO_DMA);
     if (SD_Init() != 0) return 1;
     LED0_ON;
     return 0;
 }
 
+// the card takes no other command until a read ahead it is busy with is done
+static void readAheadFinish(void) {
+    if (readAheadPending) {
+        while (SD_CheckRead());
+        while (SD_GetState() == false);
+        readAheadPending = false;
+    }
+}
+
+static void readAheadStart(uint32_t blk_addr) {
+    readAheadBlocks = 0;
+    if (blk_addr + STORAGE_READ_AHEAD_BLOCKS > SD_CardInfo.CardCapacity) {
+        return;
+    }
+    if (SD_ReadBlocks_DMA(blk_addr, readAheadBuffer, STORAGE_BLK_SIZ, STORAGE_READ_AHEAD_BLOCKS) == 0) {
+        readAheadAddr = blk_addr;
+        readAheadBlocks = STORAGE_READ_AHEAD_BLOCKS;
+        readAheadPending = true;
+    }
+}
+
 /*******************************************************************************
 * Function Name  : Read_Memory
 * Description    : Handle the Read operation from the STORAGE card.
@@ -175,6 +208,7 @@ static int8_t STORAGE_GetCapacity (uint8_t lun, uint32_t *block_num, uint32_t *b
     if (SD_IsDetected() == 0) {
         return -1;
     }
+    readAheadFinish();
     SD_GetCardInfo();
     *block_num = SD_CardInfo.CardCapacity;
     *block_size = 512;
@@ -191,6 +225,7 @@ static int8_t STORAGE_GetCapacity (uint8_t lun, uint32_t *block_num, uint32_t *b
 static int8_t  STORAGE_IsReady (uint8_t lun) {
     UNUSED(lun);
     int8_t ret = -1;
+    readAheadFinish();
     if (SD_GetState() == true && SD_IsDetected() == SD_PRESENT) {
         ret = 0;
     }
@@ -222,18 +257,27 @@ static int8_t STORAGE_Read (uint8_t lun,
                             uint16_t blk_len) {
     UNUSED(lun);
     if (SD_IsDetected() == 0) {
+        readAheadPending = false;
+        readAheadBlocks = 0;
         return -1;
     }
     LED1_ON;
-    //buf should be 32bit aligned, but usually is so we don't do byte alignment
-    if (SD_ReadBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
+    readAheadFinish();
+    if (readAheadBlocks && blk_addr == readAheadAddr && blk_len <= readAheadBlocks) {
+        memcpy(buf, readAheadBuffer, blk_len * STORAGE_BLK_SIZ);
+    } else {
+        //buf should be 32bit aligned, but usually is so we don't do byte alignment
+        if (SD_ReadBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) != 0) {
+            readAheadBlocks = 0;
+            LED1_OFF;
+            return -1;
+        }
         while (SD_CheckRead());
         while(SD_GetState() == false);
-        LED1_OFF;
-        return 0;
     }
+    readAheadStart(blk_addr + blk_len);
     LED1_OFF;
-    return -1;
+    return 0;
 }
 /*******************************************************************************
 * Function Name  : Write_Memory
@@ -251,6 +295,9 @@ static int8_t STORAGE_Write (uint8_t lun,
         return -1;
     }
     LED1_ON;
+    // the write may change the blocks read ahead
+    readAheadFinish();
+    readAheadBlocks = 0;
     //buf should be 32bit aligned, but usually is so we don't do byte alignment
     if (SD_WriteBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
         while (SD_CheckWrite());
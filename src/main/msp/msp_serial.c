@@ -41,9 +41,25 @@
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+#ifdef USE_MSP_JUMBO_FRAMES
+// There is only the one USB VCP, so its MSP port is the only one lent the big buffer
+static uint8_t jumboInBuf[MSP_PORT_JUMBO_FRAME_SIZE];
+#endif
+
+// Request size limit of the port whose command is being processed, for mspSerialCommandSizeLimit()
+static uint16_t commandSizeLimit = MSP_PORT_INBUF_SIZE;
+
 void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort) {
     memset(mspPortToReset, 0, sizeof(mspPort_t));
     mspPortToReset->port = serialPort;
+    mspPortToReset->inBuf = mspPortToReset->defaultInBuf;
+    mspPortToReset->inBufSize = sizeof(mspPortToReset->defaultInBuf);
+#ifdef USE_MSP_JUMBO_FRAMES
+    if (serialPort && serialPort->identifier == SERIAL_PORT_USB_VCP) {
+        mspPortToReset->inBuf = jumboInBuf;
+        mspPortToReset->inBufSize = sizeof(jumboInBuf);
+    }
+#endif
 }
 
 void mspSerialAllocatePorts(void) {
@@ -137,7 +153,7 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c) {
         if (mspPort->offset == sizeof(mspHeaderV1_t)) {
             mspHeaderV1_t * hdr = (mspHeaderV1_t *)&mspPort->inBuf[0];
             // Check incoming buffer size limit
-            if (hdr->size > MSP_PORT_INBUF_SIZE) {
+            if (hdr->size > mspPort->inBufSize) {
                 mspPort->c_state = MSP_IDLE;
             } else if (hdr->cmd == MSP_V2_FRAME_ID) {
                 // MSPv1 payload must be big enough to hold V2 header + extra checksum
@@ -176,6 +192,10 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c) {
         mspPort->checksum2 = crc8_dvb_s2(mspPort->checksum2, c);
         if (mspPort->offset == (sizeof(mspHeaderV2_t) + sizeof(mspHeaderV1_t))) {
             mspHeaderV2_t * hdrv2 = (mspHeaderV2_t *)&mspPort->inBuf[sizeof(mspHeaderV1_t)];
+            if (hdrv2->size > mspPort->inBufSize) {
+                mspPort->c_state = MSP_IDLE;
+                break;
+            }
             mspPort->dataSize = hdrv2->size;
             mspPort->cmdMSP = hdrv2->cmd;
             mspPort->cmdFlags = hdrv2->flags;
@@ -204,6 +224,10 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c) {
         mspPort->checksum2 = crc8_dvb_s2(mspPort->checksum2, c);
         if (mspPort->offset == sizeof(mspHeaderV2_t)) {
             mspHeaderV2_t * hdrv2 = (mspHeaderV2_t *)&mspPort->inBuf[0];
+            if (hdrv2->size > mspPort->inBufSize) {
+                mspPort->c_state = MSP_IDLE;
+                break;
+            }
             mspPort->dataSize = hdrv2->size;
             mspPort->cmdMSP = hdrv2->cmd;
             mspPort->cmdFlags = hdrv2->flags;
@@ -254,14 +278,38 @@ static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, c
     return totalFrameLength;
 }
 
-static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion) {
+#define MSP_FRAME_PREAMBLE_SIZE 3
+#define MSP_MAX_FRAME_HEADER_SIZE (MSP_FRAME_PREAMBLE_SIZE + sizeof(mspHeaderV1_t) + sizeof(mspHeaderJUMBO_t) + sizeof(mspHeaderV2_t))
+#define MSP_MAX_CHECKSUM_SIZE 2
+
+// Size of the header a frame with dataLen bytes of payload needs
+static int mspSerialHeaderSize(mspVersion_e mspVersion, int dataLen) {
+    switch (mspVersion) {
+    case MSP_V1:
+        return MSP_FRAME_PREAMBLE_SIZE + sizeof(mspHeaderV1_t) + (dataLen >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0);
+    case MSP_V2_OVER_V1:
+        dataLen += sizeof(mspHeaderV2_t) + 1;  // MSPv2 header + data payload + MSPv2 checksum
+        return MSP_FRAME_PREAMBLE_SIZE + sizeof(mspHeaderV1_t) + sizeof(mspHeaderV2_t) + (dataLen >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0);
+    case MSP_V2_NATIVE:
+        return MSP_FRAME_PREAMBLE_SIZE + sizeof(mspHeaderV2_t);
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Fill in the header and checksum that go around the payload of the packet. Returns the header length, or 0 for an
+ * unknown MSP version.
+ */
+static int mspSerialEncodeFrame(mspPacket_t *packet, mspVersion_e mspVersion, uint8_t *hdrBuf, uint8_t *crcBuf, int *crcLenOut) {
     static const uint8_t mspMagic[MSP_VERSION_COUNT] = MSP_VERSION_MAGIC_INITIALIZER;
     const int dataLen = sbufBytesRemaining(&packet->buf);
-    uint8_t hdrBuf[16] = { '$', mspMagic[mspVersion], packet->result == MSP_RESULT_ERROR ? '!' : '>'};
-    uint8_t crcBuf[2];
     uint8_t checksum;
-    int hdrLen = 3;
+    int hdrLen = MSP_FRAME_PREAMBLE_SIZE;
     int crcLen = 0;
+    hdrBuf[0] = '$';
+    hdrBuf[1] = mspMagic[mspVersion];
+    hdrBuf[2] = packet->result == MSP_RESULT_ERROR ? '!' : '>';
 #define V1_CHECKSUM_STARTPOS 3
     if (mspVersion == MSP_V1) {
         mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[hdrLen];
@@ -322,20 +370,85 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         // Shouldn't get here
         return 0;
     }
+    *crcLenOut = crcLen;
+    return hdrLen;
+}
+
+static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion) {
+    uint8_t hdrBuf[MSP_MAX_FRAME_HEADER_SIZE];
+    uint8_t crcBuf[MSP_MAX_CHECKSUM_SIZE];
+    int crcLen;
+    const int hdrLen = mspSerialEncodeFrame(packet, mspVersion, hdrBuf, crcBuf, &crcLen);
+    if (hdrLen == 0) {
+        return 0;
+    }
     // Send the frame
-    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
+    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), sbufBytesRemaining(&packet->buf), crcBuf, crcLen);
+}
+
+// Replies and stream frames are encoded one at a time from the serial task
+static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
+
+typedef struct mspReplyBuffer_s {
+    uint8_t *frame;     // Start of the frame in the port's transmit buffer, NULL when building in outBuf
+    uint8_t *payload;
+} mspReplyBuffer_t;
+
+/*
+ * Build the reply straight in the transmit buffer if the port lends it out and it holds at least minPayloadSize bytes
+ * of payload, leaving room in front for the header, which is filled in once the payload length is known. Otherwise
+ * the reply is built in outBuf and copied to the port when it is sent.
+ */
+static void mspSerialBeginReply(mspPort_t *msp, mspPacket_t *reply, mspReplyBuffer_t *replyBuffer, uint32_t minPayloadSize) {
+    uint32_t available;
+    uint8_t *txBuf = serialGetTxBuf(msp->port, &available);
+    if (txBuf && available >= MSP_MAX_FRAME_HEADER_SIZE + minPayloadSize + MSP_MAX_CHECKSUM_SIZE) {
+        replyBuffer->frame = txBuf;
+        // Room for the header of the biggest frame that fits, the payload moves up if it turns out smaller
+        replyBuffer->payload = txBuf + mspSerialHeaderSize(msp->mspVersion, available);
+        reply->buf.end = txBuf + available - MSP_MAX_CHECKSUM_SIZE;
+    } else {
+        replyBuffer->frame = NULL;
+        replyBuffer->payload = outBuf;
+        reply->buf.end = ARRAYEND(outBuf);
+    }
+    reply->buf.ptr = replyBuffer->payload;
+}
+
+static void mspSerialEndReply(mspPort_t *msp, mspPacket_t *reply, const mspReplyBuffer_t *replyBuffer) {
+    sbufSwitchToReader(&reply->buf, replyBuffer->payload); // change streambuf direction
+    if (!replyBuffer->frame) {
+        mspSerialEncode(msp, reply, msp->mspVersion);
+        return;
+    }
+    uint8_t hdrBuf[MSP_MAX_FRAME_HEADER_SIZE];
+    uint8_t crcBuf[MSP_MAX_CHECKSUM_SIZE];
+    int crcLen;
+    const int dataLen = sbufBytesRemaining(&reply->buf);
+    const int hdrLen = mspSerialEncodeFrame(reply, msp->mspVersion, hdrBuf, crcBuf, &crcLen);
+    if (hdrLen == 0) {
+        return;
+    }
+    // Patch the header and checksum in around the payload and send the frame from where it is
+    uint8_t *data = replyBuffer->frame + hdrLen;
+    if (data != replyBuffer->payload) {
+        memmove(data, replyBuffer->payload, dataLen);
+    }
+    memcpy(replyBuffer->frame, hdrBuf, hdrLen);
+    memcpy(data + dataLen, crcBuf, crcLen);
+    serialCommitTxBuf(msp->port, hdrLen + dataLen + crcLen);
 }
 
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn) {
-    static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
     mspPacket_t reply = {
-        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
         .cmd = -1,
         .flags = 0,
         .result = 0,
         .direction = MSP_DIRECTION_REPLY,
     };
-    uint8_t *outBufHead = reply.buf.ptr;
+    mspReplyBuffer_t replyBuffer;
+    // Command handlers count on having all of outBuf to write to
+    mspSerialBeginReply(msp, &reply, &replyBuffer, MSP_PORT_OUTBUF_SIZE);
     mspPacket_t command = {
         .buf = { .ptr = msp->inBuf, .end = msp->inBuf + msp->dataSize, },
         .cmd = msp->cmdMSP,
@@ -344,10 +457,11 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
         .direction = MSP_DIRECTION_REQUEST,
     };
     mspPostProcessFnPtr mspPostProcessFn = NULL;
+    commandSizeLimit = msp->inBufSize;
     const mspResult_e status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+    commandSizeLimit = MSP_PORT_INBUF_SIZE;
     if (status != MSP_RESULT_NO_REPLY) {
-        sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
-        mspSerialEncode(msp, &reply, msp->mspVersion);
+        mspSerialEndReply(msp, &reply, &replyBuffer);
     }
     return mspPostProcessFn;
 }
@@ -403,44 +517,119 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
     msp->c_state = MSP_IDLE;
 }
 
+static void mspSerialProcessStream(mspPort_t *msp) {
+    // Only queue the next frame once the last one is out, so replies to requests are never held up for long
+    if (!isSerialTransmitBufferEmpty(msp->port)) {
+        return;
+    }
+    mspPacket_t reply = {
+        .cmd = -1,
+        .flags = 0,
+        .result = MSP_RESULT_ACK,
+        .direction = MSP_DIRECTION_REPLY,
+    };
+    mspReplyBuffer_t replyBuffer;
+    // Stream frames size themselves to the buffer they get, which keeps them within the transmit buffer
+    mspSerialBeginReply(msp, &reply, &replyBuffer, 0);
+    switch (msp->streamFn(&reply)) {
+    case MSP_STREAM_SEND:
+        mspSerialEndReply(msp, &reply, &replyBuffer);
+        break;
+    case MSP_STREAM_STOP:
+        msp->streamFn = NULL;
+        break;
+    default:
+        break;
+    }
+}
+
 /*
- * Process MSP commands from serial ports configured as MSP ports.
+ * Attach a stream to the MSP port using the given serial port, detaching it from any other port.
  *
- * Called periodically by the scheduler.
+ * Returns false if the serial port isn't an MSP port.
  */
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn) {
+bool mspSerialStreamStart(serialPort_t *serialPort, mspStreamFnPtr streamFn) {
+    bool attached = false;
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
-        if (!mspPort->port) {
-            continue;
+        if (mspPort->port && mspPort->port == serialPort) {
+            mspPort->streamFn = streamFn;
+            attached = true;
+        } else if (mspPort->streamFn == streamFn) {
+            mspPort->streamFn = NULL;
         }
-        mspPostProcessFnPtr mspPostProcessFn = NULL;
-        if (!mspPort->pendingRequest && serialRxBytesWaiting(mspPort->port)) {
-            // There are bytes incoming - abort pending request
-            mspPort->lastActivityMs = millis();
-            mspPort->pendingRequest = MSP_PENDING_NONE;
-            while (serialRxBytesWaiting(mspPort->port)) {
-                const uint8_t c = serialRead(mspPort->port);
-                const bool consumed = mspSerialProcessReceivedData(mspPort, c);
-                if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
-                    mspEvaluateNonMspData(mspPort, c);
-                }
-                if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
-                    if (mspPort->packetType == MSP_PACKET_COMMAND) {
-                        mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
-                    } else if (mspPort->packetType == MSP_PACKET_REPLY) {
-                        mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
-                    }
-                    mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
+    }
+    return attached;
+}
+
+// Receive time one port gets per pass, the rest of its bytes wait in the port's rx buffer for the next pass
+#define MSP_PORT_TIME_BUDGET_US     200
+// Once a pass has taken this long the ports not yet served are served first on the next pass
+#define MSP_SERIAL_TIME_BUDGET_US   500
+// micros() isn't free, so the port budget is looked at once per this many bytes
+#define MSP_PORT_BUDGET_CHECK_BYTES 32
+
+static uint8_t mspNextPortIndex;
+
+static void mspSerialProcessPort(mspPort_t *mspPort, mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn) {
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+    if (!mspPort->pendingRequest && serialRxBytesWaiting(mspPort->port)) {
+        // There are bytes incoming - abort pending request
+        mspPort->lastActivityMs = millis();
+        mspPort->pendingRequest = MSP_PENDING_NONE;
+        const timeUs_t startUs = micros();
+        for (int bytes = 1; serialRxBytesWaiting(mspPort->port); bytes++) {
+            const uint8_t c = serialRead(mspPort->port);
+            const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+            if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
+                mspEvaluateNonMspData(mspPort, c);
+            }
+            if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
+                if (mspPort->packetType == MSP_PACKET_COMMAND) {
+                    mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                } else if (mspPort->packetType == MSP_PACKET_REPLY) {
+                    mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
                 }
+                mspPort->c_state = MSP_IDLE;
+                break; // process one command at a time so as not to block.
             }
-            if (mspPostProcessFn) {
-                waitForSerialPortToFinishTransmitting(mspPort->port);
-                mspPostProcessFn(mspPort->port);
+            if (bytes % MSP_PORT_BUDGET_CHECK_BYTES == 0 && cmpTimeUs(micros(), startUs) >= MSP_PORT_TIME_BUDGET_US) {
+                break;
             }
-        } else {
-            mspProcessPendingRequest(mspPort);
+        }
+        if (mspPostProcessFn) {
+            waitForSerialPortToFinishTransmitting(mspPort->port);
+            mspPostProcessFn(mspPort->port);
+        }
+    } else {
+        mspProcessPendingRequest(mspPort);
+    }
+    if (mspPort->streamFn && mspPort->c_state == MSP_IDLE) {
+        mspSerialProcessStream(mspPort);
+    }
+}
+
+/*
+ * Process MSP commands from serial ports configured as MSP ports.
+ *
+ * Called periodically by the scheduler. Each port takes at most one command and MSP_PORT_TIME_BUDGET_US of receiving
+ * per pass. The port served first moves round each pass, and a pass that runs past MSP_SERIAL_TIME_BUDGET_US stops
+ * and leaves the remaining ports to start the next one, so a busy port can't starve the others or stretch the task.
+ */
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn) {
+    const timeUs_t startUs = micros();
+    uint8_t portIndex = mspNextPortIndex;
+    mspNextPortIndex = (mspNextPortIndex + 1) % MAX_MSP_PORT_COUNT;
+    for (int served = 0; served < MAX_MSP_PORT_COUNT; served++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+        portIndex = (portIndex + 1) % MAX_MSP_PORT_COUNT;
+        if (!mspPort->port) {
+            continue;
+        }
+        mspSerialProcessPort(mspPort, evaluateNonMspData, mspProcessCommandFn, mspProcessReplyFn);
+        if (served + 1 < MAX_MSP_PORT_COUNT && cmpTimeUs(micros(), startUs) >= MSP_SERIAL_TIME_BUDGET_US) {
+            mspNextPortIndex = portIndex;
+            break;
         }
     }
 }
@@ -522,6 +711,12 @@ int mspSerialPushPort(uint16_t cmd, const uint8_t *data, int datalen, mspPort_t
     return mspSerialEncode(mspPort, &push, version);
 }
 
+// Biggest request payload taken on the port being served, MSP over telemetry and other transports get the default
+uint16_t mspSerialCommandSizeLimit(void)
+{
+    return commandSizeLimit;
+}
+
 void mspSerialProcessOnePort(mspPort_t * const mspPort, mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn)
 {
     mspPostProcessFnPtr mspPostProcessFn = NULL;
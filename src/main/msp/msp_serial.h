@@ -24,8 +24,14 @@
 #include "interface/msp.h"
 #include "io/serial.h"
 
-// Each MSP port requires state and a receive buffer, revisit this default if someone needs more than 3 MSP ports.
+// Each MSP port requires state and a receive buffer, the F4 and F7 have the ram for the ports of their many UARTs
+#ifndef MAX_MSP_PORT_COUNT
+#if defined(STM32F4) || defined(STM32F7)
+#define MAX_MSP_PORT_COUNT 5
+#else
 #define MAX_MSP_PORT_COUNT 3
+#endif
+#endif
 
 typedef enum {
     MSP_IDLE,
@@ -65,6 +71,12 @@ typedef enum {
 } mspPendingSystemRequest_e;
 
 #define MSP_PORT_INBUF_SIZE 192
+#ifdef USE_MSP_JUMBO_FRAMES
+// Requests up to this size are taken on the USB VCP, which the configurator syncs over
+#ifndef MSP_PORT_JUMBO_FRAME_SIZE
+#define MSP_PORT_JUMBO_FRAME_SIZE 2048
+#endif
+#endif
 #ifdef USE_FLASHFS
 #ifdef STM32F1
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 1024
@@ -73,6 +85,8 @@ typedef enum {
 #endif
 #define MSP_PORT_DATAFLASH_INFO_SIZE 16
 #define MSP_PORT_OUTBUF_SIZE (MSP_PORT_DATAFLASH_BUFFER_SIZE + MSP_PORT_DATAFLASH_INFO_SIZE)
+#elif defined(USE_MSP_JUMBO_FRAMES)
+#define MSP_PORT_OUTBUF_SIZE MSP_PORT_JUMBO_FRAME_SIZE
 #else
 #define MSP_PORT_OUTBUF_SIZE 256
 #endif
@@ -104,7 +118,9 @@ typedef struct mspPort_s {
     mspPendingSystemRequest_e pendingRequest;
     mspState_e c_state;
     mspPacketType_e packetType;
-    uint8_t inBuf[MSP_PORT_INBUF_SIZE];
+    uint8_t *inBuf;             // defaultInBuf, or the jumbo frame buffer on the USB VCP
+    uint16_t inBufSize;
+    uint8_t defaultInBuf[MSP_PORT_INBUF_SIZE];
     uint16_t cmdMSP;
     uint8_t cmdFlags;
     mspVersion_e mspVersion;
@@ -113,6 +129,7 @@ typedef struct mspPort_s {
     uint8_t checksum1;
     uint8_t checksum2;
     bool sharedWithTelemetry;
+    mspStreamFnPtr streamFn;
 } mspPort_t;
 
 void mspSerialInit(void);
@@ -124,5 +141,7 @@ void mspSerialReleaseSharedTelemetryPorts(void);
 int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
 uint32_t mspSerialTxBytesFree(void);
 int mspSerialPushPort(uint16_t cmd, const uint8_t *data, int datalen, mspPort_t *mspPort, mspVersion_e version);
+bool mspSerialStreamStart(struct serialPort_s *serialPort, mspStreamFnPtr streamFn);
 void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort);
+uint16_t mspSerialCommandSizeLimit(void);
 void mspSerialProcessOnePort(mspPort_t * const mspPort, mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn);
\ No newline at end of file
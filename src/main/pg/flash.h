@@ -29,6 +29,7 @@
 typedef struct flashConfig_s {
     ioTag_t csTag;
     uint8_t spiDevice;
+    uint16_t ringEraseAheadKb;  // use the flash as a ring log and keep this much erased ahead of it, 0 erases before logging instead
 } flashConfig_t;
 
 PG_DECLARE(flashConfig_t, flashConfig);
@@ -25,6 +25,7 @@
 #include "platform.h"
 
 #include "common/maths.h"
+#include "common/memory.h"
 
 #include "pg.h"
 
@@ -41,6 +42,17 @@ static uint8_t *pgOffset(const pgRegistry_t* reg) {
     return reg->address;
 }
 
+// The copies are only needed while the CLI dumps or MSP stages a group, so rather than a static copy per group they
+// share the RAM the boot time arena has left.
+uint8_t *pgCopy(const pgRegistry_t *reg) {
+    // each group takes the space of the groups before it in the registry, so all copies can be in use together
+    size_t offset = 0;
+    for (const pgRegistry_t *before = __pg_registry_start; before < reg; before++) {
+        offset += (pgSize(before) + 3) & ~3;
+    }
+    return offset + pgSize(reg) <= memGetAvailableBytes() ? memUnallocated() + offset : NULL;
+}
+
 void pgResetInstance(const pgRegistry_t *reg, uint8_t *base) {
     const uint16_t regSize = pgSize(reg);
     memset(base, 0, regSize);
@@ -67,13 +79,17 @@ bool pgResetCopy(void *copy, pgn_t pgn) {
 }
 
 bool pgLoad(const pgRegistry_t* reg, const void *from, int size, int version) {
-    pgResetInstance(reg, pgOffset(reg));
     // restore only matching version, keep defaults otherwise
     if (version == pgVersion(reg)) {
         const int take = MIN(size, pgSize(reg));
+        // defaults are only needed for the tail a short (older) record doesn't cover
+        if (take < pgSize(reg)) {
+            pgResetInstance(reg, pgOffset(reg));
+        }
         memcpy(pgOffset(reg), from, take);
         return true;
     }
+    pgResetInstance(reg, pgOffset(reg));
     return false;
 }
 
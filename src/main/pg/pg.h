@@ -47,7 +47,6 @@ typedef struct pgRegistry_s {
     pgn_t pgn;             // The parameter group number, the top 4 bits are reserved for version
     uint16_t size;         // Size of the group in RAM, the top 4 bits are reserved for flags
     uint8_t *address;      // Address of the group in RAM.
-    uint8_t *copy;         // Address of the copy in RAM.
     uint8_t **ptr;         // The pointer to update after loading the record into ram.
     union {
         void *ptr;         // Pointer to init template
@@ -65,6 +64,9 @@ static inline uint16_t pgSize(const pgRegistry_t* reg) {
     return reg->size & PGR_SIZE_MASK;
 }
 
+// Scratch copy of the group used by the CLI to diff against defaults and by MSP to stage a group, NULL if it does not fit.
+uint8_t *pgCopy(const pgRegistry_t *reg);
+
 #define PG_PACKED __attribute__((packed))
 
 #ifdef __APPLE__
@@ -102,18 +104,20 @@ extern const uint8_t __pg_resetdata_end[];
 // Declare system config
 #define PG_DECLARE(_type, _name)                                        \
     extern _type _name ## _System;                                      \
-    extern _type _name ## _Copy;                                        \
+    extern const pgRegistry_t _name ## _Registry;                       \
     static inline const _type* _name(void) { return &_name ## _System; }\
     static inline _type* _name ## Mutable(void) { return &_name ## _System; }\
+    static inline const _type* _name ## Copy(void) { return (const _type *)pgCopy(&_name ## _Registry); }\
     struct _dummy                                                       \
     /**/
 
 // Declare system config array
 #define PG_DECLARE_ARRAY(_type, _size, _name)                           \
     extern _type _name ## _SystemArray[_size];                          \
-    extern _type _name ## _CopyArray[_size];                            \
+    extern const pgRegistry_t _name ## _Registry;                       \
     static inline const _type* _name(int _index) { return &_name ## _SystemArray[_index]; } \
     static inline _type* _name ## Mutable(int _index) { return &_name ## _SystemArray[_index]; } \
+    static inline const _type* _name ## Copy(int _index) { return (const _type *)pgCopy(&_name ## _Registry) + _index; } \
     static inline _type (* _name ## _array(void))[_size] { return &_name ## _SystemArray; } \
     struct _dummy                                                       \
     /**/
@@ -121,14 +125,12 @@ extern const uint8_t __pg_resetdata_end[];
 // Register system config
 #define PG_REGISTER_I(_type, _name, _pgn, _version, _reset)             \
     _type _name ## _System;                                             \
-    _type _name ## _Copy;                                               \
     /* Force external linkage for g++. Catch multi registration */      \
     extern const pgRegistry_t _name ## _Registry;                       \
     const pgRegistry_t _name ##_Registry PG_REGISTER_ATTRIBUTES = {     \
         .pgn = _pgn | (_version << 12),                                 \
         .size = sizeof(_type) | PGR_SIZE_SYSTEM_FLAG,                   \
         .address = (uint8_t*)&_name ## _System,                         \
-        .copy = (uint8_t*)&_name ## _Copy,                              \
         .ptr = 0,                                                       \
         _reset,                                                         \
     }                                                                   \
@@ -151,13 +153,11 @@ extern const uint8_t __pg_resetdata_end[];
 // Register system config array
 #define PG_REGISTER_ARRAY_I(_type, _size, _name, _pgn, _version, _reset)  \
     _type _name ## _SystemArray[_size];                                 \
-    _type _name ## _CopyArray[_size];                                   \
     extern const pgRegistry_t _name ##_Registry;                        \
     const pgRegistry_t _name ## _Registry PG_REGISTER_ATTRIBUTES = {    \
         .pgn = _pgn | (_version << 12),                                 \
         .size = (sizeof(_type) * _size) | PGR_SIZE_SYSTEM_FLAG,         \
         .address = (uint8_t*)&_name ## _SystemArray,                    \
-        .copy = (uint8_t*)&_name ## _CopyArray,                         \
         .ptr = 0,                                                       \
         _reset,                                                         \
     }                                                                   \
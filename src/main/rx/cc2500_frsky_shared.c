@@ -377,12 +377,9 @@ void nextChannel(uint8_t skip) {
         channr -= listLength;
     }
     cc2500Strobe(CC2500_SIDLE);
-    cc2500WriteReg(CC2500_23_FSCAL3,
-                   calData[rxFrSkySpiConfig()->bindHopData[channr]][0]);
-    cc2500WriteReg(CC2500_24_FSCAL2,
-                   calData[rxFrSkySpiConfig()->bindHopData[channr]][1]);
-    cc2500WriteReg(CC2500_25_FSCAL1,
-                   calData[rxFrSkySpiConfig()->bindHopData[channr]][2]);
+    // FSCAL3..FSCAL1 are consecutive, write the stored calibration in one burst
+    cc2500WriteRegisterMulti(CC2500_23_FSCAL3 | CC2500_WRITE_BURST,
+                             calData[rxFrSkySpiConfig()->bindHopData[channr]], 3);
     cc2500WriteReg(CC2500_0A_CHANNR, rxFrSkySpiConfig()->bindHopData[channr]);
     if (spiProtocol == RX_SPI_FRSKY_D) {
         cc2500Strobe(CC2500_SFRX);
@@ -38,6 +38,7 @@
 
 #include "drivers/adc.h"
 #include "drivers/rx/rx_cc2500.h"
+#include "drivers/rx/rx_spi.h"
 #include "drivers/io.h"
 #include "drivers/io_def.h"
 #include "drivers/io_types.h"
@@ -295,6 +296,10 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
     static telemetryBuffer_t telemetryRxBuffer[TELEMETRY_SEQUENCE_LENGTH];
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
     static bool telemetryReceived = false;
+#endif
+#if defined(USE_RX_SPI_DMA)
+    static uint8_t fifoDmaLength = 0;
+    static timeUs_t fifoDmaStartUs;
 #endif
     rx_spi_received_e ret = RX_SPI_RECEIVED_NONE;
     switch (*protocolState) {
@@ -320,15 +325,47 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
         FALLTHROUGH;
     // here FS code could be
     case STATE_DATA:
+#if defined(USE_RX_SPI_DMA)
+        if (fifoDmaLength) {
+            if (rxSpiDmaReadBusy()) {
+                break;
+            }
+            memcpy(packet, rxSpiDmaReadData(), fifoDmaLength);
+        }
+        if ((fifoDmaLength || cc2500getGdo()) && (frameReceived == false)) {
+#else
         if (cc2500getGdo() && (frameReceived == false)) {
+#endif
             bool packetOk = false;
-            uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
-            ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F; // read 2 times to avoid reading errors
-            if (ccLen > 32) {
-                ccLen = 32;
+            uint8_t ccLen;
+            timeUs_t packetReadUs;
+#if defined(USE_RX_SPI_DMA)
+            if (fifoDmaLength) {
+                ccLen = fifoDmaLength;
+                fifoDmaLength = 0;
+                packetReadUs = fifoDmaStartUs;
+            } else
+#endif
+            {
+                ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+                ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F; // read 2 times to avoid reading errors
+                if (ccLen > 32) {
+                    ccLen = 32;
+                }
+#if defined(USE_RX_SPI_DMA)
+                // the packet is checked on the next pass, once the FIFO has been read in the background
+                if (ccLen && cc2500ReadFifoDma(ccLen)) {
+                    fifoDmaLength = ccLen;
+                    fifoDmaStartUs = micros();
+                    break;
+                }
+#endif
+                if (ccLen) {
+                    cc2500ReadFifo(packet, ccLen);
+                }
+                packetReadUs = micros();
             }
             if (ccLen) {
-                cc2500ReadFifo(packet, ccLen);
                 uint16_t lcrc = calculateCrc(&packet[3], (ccLen - 7));
                 if((lcrc >> 8) == packet[ccLen - 4] && (lcrc & 0x00FF) == packet[ccLen - 3]) { // check calculateCrc
                     if (packet[0] == 0x1D) {
@@ -391,7 +428,7 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                                 }
                                 receiveTelemetryRetryCount = 0;
                             }
-                            packetTimerUs = micros();
+                            packetTimerUs = packetReadUs;
                             frameReceived = true; // no need to process frame again.
                         }
                     }
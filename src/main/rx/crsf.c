@@ -32,6 +32,7 @@
 
 #include "common/crc.h"
 #include "common/maths.h"
+#include "common/ringbuffer.h"
 #include "common/utils.h"
 
 #include "pg/rx.h"
@@ -56,14 +57,23 @@
 
 #define CRSF_PAYLOAD_OFFSET offsetof(crsfFrameDef_t, type)
 
-STATIC_UNIT_TESTED bool crsfFrameDone = false;
 STATIC_UNIT_TESTED crsfFrame_t crsfFrame;
-STATIC_UNIT_TESTED crsfFrame_t crsfChannelDataFrame;
-STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+STATIC_UNIT_TESTED uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
+
+// packed rc channel payloads handed from the rx interrupt to crsfFrameStatus, room for a few frames
+#define CRSF_RC_CHANNELS_BUFFER_SIZE 128
+static uint8_t crsfRcChannelsData[CRSF_RC_CHANNELS_BUFFER_SIZE];
+STATIC_UNIT_TESTED ringBuffer_t crsfRcChannelsBuffer = {
+    .buffer = crsfRcChannelsData,
+    .mask = CRSF_RC_CHANNELS_BUFFER_SIZE - 1,
+};
 
 static serialPort_t *serialPort;
 static uint32_t crsfFrameStartAtUs = 0;
-static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
+static volatile timeUs_t crsfRcFrameEndAtUs = 0;  // last byte of the newest rc channels frame, stamped in the rx interrupt
+static timeUs_t lastRcFrameTimeUs = 0;
+// room for a short burst of telemetry frames, sent together in one telemetry slot
+static uint8_t telemetryBuf[CRSF_TELEMETRY_BUFFER_SIZE];
 static uint8_t telemetryBufLen = 0;
 
 /*
@@ -184,15 +194,17 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data) {
                 switch (crsfFrame.frame.type) {
                     case CRSF_FRAMETYPE_RC_CHANNELS_PACKED:
                         if (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) {
-                            crsfFrameDone = true;
-                            memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+                            ringBufferWrite(&crsfRcChannelsBuffer, crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
+                            crsfRcFrameEndAtUs = currentTimeUs;
                         }
                         break;
 #if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
                     case CRSF_FRAMETYPE_MSP_REQ:
                     case CRSF_FRAMETYPE_MSP_WRITE: {
                         uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        // take the whole frame, senders aren't limited to the 8 byte chunks the Lua scripts use
+                        const int mspFrameLength = MIN(crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_EXT_TYPE_CRC, CRSF_FRAME_TX_MSP_FRAME_SIZE);
+                        if (mspFrameLength > 0 && bufferCrsfMspFrame(frameStart, mspFrameLength)) {
                             crsfScheduleMspResponse();
                         }
                         break;
@@ -204,7 +216,7 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data) {
                         break;
                     case CRSF_FRAMETYPE_DISPLAYPORT_CMD: {
                         uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        crsfProcessDisplayPortCmd(frameStart);
+                        crsfProcessDisplayPortCmd(frameStart, crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_EXT_TYPE_CRC);
                         break;
                     }
 #endif
@@ -229,32 +241,25 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data) {
 
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig) {
     UNUSED(rxRuntimeConfig);
-    if (crsfFrameDone) {
-        crsfFrameDone = false;
-
+    crsfPayloadRcChannelsPacked_t rcChannelsFrame;
+    bool frameReceived = false;
+    // only the newest frame is of interest, older ones are dropped
+    while (ringBufferRead(&crsfRcChannelsBuffer, &rcChannelsFrame, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE)) {
+        frameReceived = true;
+    }
+    if (frameReceived) {
+        lastRcFrameTimeUs = crsfRcFrameEndAtUs;
         // unpack the RC channels
-        const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfChannelDataFrame.frame.payload;
-        crsfChannelData[0] = rcChannels->chan0;
-        crsfChannelData[1] = rcChannels->chan1;
-        crsfChannelData[2] = rcChannels->chan2;
-        crsfChannelData[3] = rcChannels->chan3;
-        crsfChannelData[4] = rcChannels->chan4;
-        crsfChannelData[5] = rcChannels->chan5;
-        crsfChannelData[6] = rcChannels->chan6;
-        crsfChannelData[7] = rcChannels->chan7;
-        crsfChannelData[8] = rcChannels->chan8;
-        crsfChannelData[9] = rcChannels->chan9;
-        crsfChannelData[10] = rcChannels->chan10;
-        crsfChannelData[11] = rcChannels->chan11;
-        crsfChannelData[12] = rcChannels->chan12;
-        crsfChannelData[13] = rcChannels->chan13;
-        crsfChannelData[14] = rcChannels->chan14;
-        crsfChannelData[15] = rcChannels->chan15;
+        rxUnpack11BitChannels(crsfChannelData, (const uint8_t *)&rcChannelsFrame, CRSF_MAX_CHANNEL);
         return RX_FRAME_COMPLETE;
     }
     return RX_FRAME_PENDING;
 }
 
+static timeUs_t crsfFrameTimeUs(void) {
+    return lastRcFrameTimeUs;
+}
+
 STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan) {
     UNUSED(rxRuntimeConfig);
     /* conversion from RC value to PWM
@@ -268,10 +273,17 @@ STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConf
     return (0.62477120195241f * crsfChannelData[chan]) + 881;
 }
 
+// Appends a frame to the telemetry burst, a frame that doesn't fit is dropped
 void crsfRxWriteTelemetryData(const void *data, int len) {
-    len = MIN(len, (int)sizeof(telemetryBuf));
-    memcpy(telemetryBuf, data, len);
-    telemetryBufLen = len;
+    if (len > (int)sizeof(telemetryBuf) - telemetryBufLen) {
+        return;
+    }
+    memcpy(&telemetryBuf[telemetryBufLen], data, len);
+    telemetryBufLen += len;
+}
+
+int crsfRxTelemetryBufferFree(void) {
+    return sizeof(telemetryBuf) - telemetryBufLen;
 }
 
 void crsfRxSendTelemetryData(void) {
@@ -290,6 +302,7 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     rxRuntimeConfig->rxRefreshRate = CRSF_TIME_BETWEEN_FRAMES_US; //!!TODO this needs checking
     rxRuntimeConfig->rcReadRawFn = crsfReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = crsfFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = crsfFrameTimeUs;
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
         return false;
@@ -40,8 +40,11 @@ typedef union crsfFrame_u {
     crsfFrameDef_t frame;
 } crsfFrame_t;
 
+#define CRSF_TELEMETRY_BUFFER_SIZE (2 * CRSF_FRAME_SIZE_MAX)
+
 void crsfRxWriteTelemetryData(const void *data, int len);
 void crsfRxSendTelemetryData(void);
+int crsfRxTelemetryBufferFree(void);
 
 struct rxConfig_s;
 struct rxRuntimeConfig_s;
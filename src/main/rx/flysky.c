@@ -222,11 +222,19 @@ static void buildAndWriteTelemetry (uint8_t *packet) {
     }
 }
 
-static rx_spi_received_e flySky2AReadAndProcess (uint8_t *payload, const uint32_t timeStamp) {
+static void readFifo (uint8_t *packet, const uint8_t *fifo, uint8_t bytesToRead) {
+    if (fifo) {
+        memcpy(packet, fifo, bytesToRead); // already read in the background
+    } else {
+        A7105ReadFIFO(packet, bytesToRead);
+    }
+}
+
+static rx_spi_received_e flySky2AReadAndProcess (uint8_t *payload, const uint8_t *fifo, const uint32_t timeStamp) {
     rx_spi_received_e result = RX_SPI_RECEIVED_NONE;
     uint8_t packet[FLYSKY_2A_PAYLOAD_SIZE];
     uint8_t bytesToRead = (bound) ? (9 + 2 * FLYSKY_2A_CHANNEL_COUNT) : (11 + FLYSKY_FREQUENCY_COUNT);
-    A7105ReadFIFO(packet, bytesToRead);
+    readFifo(packet, fifo, bytesToRead);
     switch (packet[0]) {
     case FLYSKY_2A_PACKET_RC_DATA:
     case FLYSKY_2A_PACKET_FS_SETTINGS: // failsafe settings
@@ -277,11 +285,11 @@ static rx_spi_received_e flySky2AReadAndProcess (uint8_t *payload, const uint32_
     return result;
 }
 
-static rx_spi_received_e flySkyReadAndProcess (uint8_t *payload, const uint32_t timeStamp) {
+static rx_spi_received_e flySkyReadAndProcess (uint8_t *payload, const uint8_t *fifo, const uint32_t timeStamp) {
     rx_spi_received_e result = RX_SPI_RECEIVED_NONE;
     uint8_t packet[FLYSKY_PAYLOAD_SIZE];
     uint8_t bytesToRead = (bound) ? (5 + 2 * FLYSKY_CHANNEL_COUNT) : (5);
-    A7105ReadFIFO(packet, bytesToRead);
+    readFifo(packet, fifo, bytesToRead);
     const flySkyRcDataPkt_t *rcPacket = (const flySkyRcDataPkt_t*) packet;
     if (bound && rcPacket->type == FLYSKY_PACKET_RC_DATA && rcPacket->txId == txId) {
         checkRSSI();
@@ -325,12 +333,18 @@ bool flySkyInit (const rxSpiConfig_t *rxSpiConfig, struct rxRuntimeConfig_s *rxR
         startRxChannel = flySky2ABindChannels[0];
         A7105Init(0x5475c52A);
         A7105Config(flySky2ARegs, sizeof(flySky2ARegs));
+#ifdef USE_RX_SPI_DMA
+        A7105EnableRxDma(FLYSKY_2A_PAYLOAD_SIZE);
+#endif
     } else {
         rxRuntimeConfig->channelCount = FLYSKY_CHANNEL_COUNT;
         timings = &flySkyTimings;
         startRxChannel = 0;
         A7105Init(0x5475c52A);
         A7105Config(flySkyRegs, sizeof(flySkyRegs));
+#ifdef USE_RX_SPI_DMA
+        A7105EnableRxDma(FLYSKY_PAYLOAD_SIZE);
+#endif
     }
     if ( !IORead(bindPin) || flySkyConfig()->txId == 0) {
         bound = false;
@@ -367,8 +381,18 @@ rx_spi_received_e flySkyDataReceived (uint8_t *payload) {
 #endif /* USE_RX_FLYSKY_SPI_LED */
     rx_spi_received_e result = RX_SPI_RECEIVED_NONE;
     uint32_t timeStamp;
-    if (A7105RxTxFinished(&timeStamp)) {
-        uint8_t modeReg = A7105ReadReg(A7105_00_MODE);
+    uint8_t modeReg;
+    const uint8_t *fifo = NULL;
+#ifdef USE_RX_SPI_DMA
+    bool event = A7105RxDmaPacket(&modeReg, &fifo, &timeStamp);
+#else
+    bool event = false;
+#endif
+    if (!event && A7105RxTxFinished(&timeStamp)) {
+        modeReg = A7105ReadReg(A7105_00_MODE);
+        event = true;
+    }
+    if (event) {
         if (((modeReg & A7105_MODE_TRSR) != 0) && ((modeReg & A7105_MODE_TRER) == 0)) { // TX complete
             if (bound) {
                 A7105WriteReg(A7105_0F_CHANNEL, getNextChannel(1));
@@ -376,9 +400,9 @@ rx_spi_received_e flySkyDataReceived (uint8_t *payload) {
             A7105Strobe(A7105_RX);
         } else if ((modeReg & (A7105_MODE_CRCF | A7105_MODE_TRER)) == 0) { // RX complete, CRC pass
             if (protocol == RX_SPI_A7105_FLYSKY_2A) {
-                result = flySky2AReadAndProcess(payload, timeStamp);
+                result = flySky2AReadAndProcess(payload, fifo, timeStamp);
             } else {
-                result = flySkyReadAndProcess(payload, timeStamp);
+                result = flySkyReadAndProcess(payload, fifo, timeStamp);
             }
         } else {
             A7105Strobe(A7105_RX);
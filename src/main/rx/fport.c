@@ -130,6 +130,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t endAtUs;
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -138,6 +139,7 @@ static volatile uint8_t rxBufferWriteIndex = 0;
 static volatile uint8_t rxBufferReadIndex = 0;
 
 static volatile timeUs_t lastTelemetryFrameReceivedUs;
+static timeUs_t lastRcFrameTimeUs = 0;
 static volatile bool clearToSend = false;
 
 static volatile uint8_t framePosition = 0;
@@ -176,6 +178,7 @@ static void fportDataReceive(uint16_t c, void *data) {
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].endAtUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
             if (telemetryFrame) {
@@ -213,10 +216,12 @@ static void fportDataReceive(uint16_t c, void *data) {
 #if defined(USE_TELEMETRY_SMARTPORT)
 static void smartPortWriteFrameFport(const smartPortPayload_t *payload) {
     framePosition = 0;
+    uint8_t frame[2 * 2 + SMARTPORT_STUFFED_FRAME_MAX_SIZE];
     uint16_t checksum = 0;
-    smartPortSendByte(FPORT_RESPONSE_FRAME_LENGTH, &checksum, fportPort);
-    smartPortSendByte(FPORT_FRAME_TYPE_TELEMETRY_RESPONSE, &checksum, fportPort);
-    smartPortWriteFrameSerial(payload, fportPort, checksum);
+    uint8_t length = smartPortStuffByte(FPORT_RESPONSE_FRAME_LENGTH, &checksum, frame);
+    length += smartPortStuffByte(FPORT_FRAME_TYPE_TELEMETRY_RESPONSE, &checksum, frame + length);
+    length += smartPortEncodeFrame(payload, checksum, frame + length);
+    serialWriteBuf(fportPort, frame, length);
 }
 #endif
 
@@ -255,6 +260,7 @@ static uint8_t fportFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig) {
                         result = sbusChannelsDecode(rxRuntimeConfig, &frame->data.controlData.channels);
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
                         lastRcFrameReceivedMs = millis();
+                        lastRcFrameTimeUs = rxBuffer[rxBufferReadIndex].endAtUs;
                     }
                     break;
                 case FPORT_FRAME_TYPE_TELEMETRY_REQUEST:
@@ -334,6 +340,10 @@ static bool fportProcessFrame(const rxRuntimeConfig_t *rxRuntimeConfig) {
     return true;
 }
 
+static timeUs_t fportFrameTimeUs(void) {
+    return lastRcFrameTimeUs;
+}
+
 bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
     rxRuntimeConfig->channelData = sbusChannelData;
@@ -341,6 +351,7 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     rxRuntimeConfig->channelCount = SBUS_MAX_CHANNEL;
     rxRuntimeConfig->rxRefreshRate = 11000;
     rxRuntimeConfig->rcFrameStatusFn = fportFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = fportFrameTimeUs;
     rxRuntimeConfig->rcProcessFrameFn = fportProcessFrame;
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
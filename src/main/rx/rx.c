@@ -41,6 +41,7 @@
 #include "drivers/time.h"
 
 #include "fc/config.h"
+#include "fc/fc_dispatch.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 
@@ -100,6 +101,8 @@ static timeUs_t rxNextUpdateAtUs = 0;
 static uint32_t needRxSignalBefore = 0;
 static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
+static void rxLinkWatchdogExpired(dispatchEntry_t *self);
+static dispatchEntry_t rxLinkWatchdog = { .dispatch = rxLinkWatchdogExpired };
 static uint8_t  skipRxSamples = 0;
 
 static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
@@ -245,6 +248,7 @@ void rxInit(void) {
     rxRuntimeConfig.rcProcessFrameFn = nullProcessFrame;
     rcSampleIndex = 0;
     needRxSignalMaxDelayUs = DELAY_10_HZ;
+    dispatchEnable();
     for (int i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
         rcData[i] = rxConfig()->midrc;
         rcInvalidPulsPeriod[i] = millis() + MAX_INVALID_PULS_TIME;
@@ -336,6 +340,32 @@ void resumeRxPwmPpmSignal(void) {
 #endif
 }
 
+// Signal loss is timed from the frame itself: the deadline counts from the ISR
+// timestamp of the last good frame where the protocol has one, and a dispatch
+// entry drops rxSignalReceived at the deadline instead of the RX task noticing
+// it on its next poll. The entry only re-arms when it expires early, so good
+// frames just move the deadline.
+static void rxLinkWatchdogExpired(dispatchEntry_t *self) {
+    const int32_t remainingUs = cmp32(needRxSignalBefore, micros());
+    if (remainingUs > 0) {
+        dispatchAdd(self, remainingUs);
+        return;
+    }
+    rxSignalReceived = false;
+    // apply stage 1 on the next RX task pass rather than the 33Hz fallback
+    rxDataProcessingRequired = true;
+}
+
+static void rxSignalReceivedAt(timeUs_t currentTimeUs) {
+    const timeUs_t frameTimeUs = rxFrameTimeUs();
+    // a stamp from before the task last ran is still the better reference
+    const timeUs_t receivedAtUs = (frameTimeUs && cmpTimeUs(currentTimeUs, frameTimeUs) >= 0) ? frameTimeUs : currentTimeUs;
+    needRxSignalBefore = receivedAtUs + needRxSignalMaxDelayUs;
+    if (!dispatchIsQueued(&rxLinkWatchdog)) {
+        dispatchAdd(&rxLinkWatchdog, cmp32(needRxSignalBefore, currentTimeUs));
+    }
+}
+
 bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime) {
     UNUSED(currentDeltaTime);
     bool signalReceived = false;
@@ -345,14 +375,14 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime) {
         if (isPPMDataBeingReceived()) {
             signalReceived = true;
             rxIsInFailsafeMode = false;
-            needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
+            rxSignalReceivedAt(currentTimeUs);
             resetPPMDataReceivedState();
         }
     } else if (feature(FEATURE_RX_PARALLEL_PWM)) {
         if (isPWMDataBeingReceived()) {
             signalReceived = true;
             rxIsInFailsafeMode = false;
-            needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
+            rxSignalReceivedAt(currentTimeUs);
             useDataDrivenProcessing = false;
         }
     } else
@@ -364,7 +394,7 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime) {
             bool rxFrameDropped = (frameStatus & RX_FRAME_DROPPED) != 0;
             signalReceived = !(rxIsInFailsafeMode || rxFrameDropped);
             if (signalReceived) {
-                needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
+                rxSignalReceivedAt(currentTimeUs);
             }
             if (frameStatus & (RX_FRAME_FAILSAFE | RX_FRAME_DROPPED)) {
                 // No (0%) signal
@@ -380,7 +410,8 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime) {
     }
     if (signalReceived) {
         rxSignalReceived = true;
-    } else if (currentTimeUs >= needRxSignalBefore) {
+    } else if (!dispatchIsQueued(&rxLinkWatchdog) && cmp32(currentTimeUs, needRxSignalBefore) >= 0) {
+        // the watchdog did not get a queue slot, poll for the deadline
         rxSignalReceived = false;
     }
     if ((signalReceived && useDataDrivenProcessing) || cmpTimeUs(currentTimeUs, rxNextUpdateAtUs) > 0) {
@@ -444,7 +475,10 @@ STATIC_UNIT_TESTED uint16_t applyRxChannelRangeConfiguraton(int sample, const rx
     if (sample == PPM_RCVR_TIMEOUT) {
         return PPM_RCVR_TIMEOUT;
     }
-    sample = scaleRange(sample, range->min, range->max, PWM_RANGE_MIN, PWM_RANGE_MAX);
+    // the default range maps onto itself, skip the division for it
+    if (range->min != PWM_RANGE_MIN || range->max != PWM_RANGE_MAX) {
+        sample = scaleRange(sample, range->min, range->max, PWM_RANGE_MIN, PWM_RANGE_MAX);
+    }
     sample = constrain(sample, PWM_PULSE_MIN, PWM_PULSE_MAX);
     return sample;
 }
@@ -669,6 +703,11 @@ uint16_t rxGetRefreshRate(void) {
     return rxRuntimeConfig.rxRefreshRate;
 }
 
+// time the last byte of the newest channel frame arrived, 0 if the protocol doesn't stamp its frames
+timeUs_t rxFrameTimeUs(void) {
+    return rxRuntimeConfig.rcFrameTimeUsFn ? rxRuntimeConfig.rcFrameTimeUsFn() : 0;
+}
+
 bool isRssiConfigured(void) {
     return rssiSource != RSSI_SOURCE_NONE;
 }
@@ -190,3 +190,21 @@ uint8_t CRSFgetSnR(void);
 uint16_t CRSFgetTXPower(void);
 
 uint16_t rxGetRefreshRate(void);
+timeUs_t rxFrameTimeUs(void);
+
+// Unpacks LSB-first 11 bit channels (SBUS/FPort/CRSF) with a running bit accumulator,
+// one byte read per 8 bits instead of a bitfield extraction per channel
+static inline void rxUnpack11BitChannels(uint16_t *channels, const uint8_t *packed, int count)
+{
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (int i = 0; i < count; i++) {
+        while (bitCount < 11) {
+            bits |= (uint32_t)*packed++ << bitCount;
+            bitCount += 8;
+        }
+        channels[i] = bits & 0x07FF;
+        bits >>= 11;
+        bitCount -= 11;
+    }
+}
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #define SBUS_MAX_CHANNEL 18
+#define SBUS_PACKED_CHANNEL_COUNT 16
 
 #define SBUS_FLAG_SIGNAL_LOSS       (1 << 2)
 #define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
@@ -27,12 +27,14 @@
 #include "platform.h"
 
 #include "build/build_config.h"
+#include "build/cycle_profile.h"
 #include "build/debug.h"
 
 #include "scheduler/scheduler.h"
 
 #include "config/config_unittest.h"
 
+#include "common/bitarray.h"
 #include "common/maths.h"
 #include "common/time.h"
 #include "common/utils.h"
@@ -51,8 +53,25 @@ static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasks;
 static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasksSamples;
 
 static FAST_RAM_ZERO_INIT bool calculateTaskStatistics;
+
+// Tasks only start when their execution time estimate fits before the next gyro run
+static FAST_RAM_ZERO_INIT cfTask_t *gyroTask = NULL;
 FAST_RAM_ZERO_INIT uint16_t averageSystemLoadPercent = 0;
 
+// Time of the passes that found nothing to run, including any sleep, for the share of time the CPU is busy
+static FAST_RAM_ZERO_INIT uint32_t totalIdleTimeUs;
+FAST_RAM_ZERO_INIT uint16_t averageCpuLoadPercent = 0;
+#ifdef USE_CYCLE_PROFILE
+// The same in cycles, without the interrupts taken during those passes
+static FAST_RAM_ZERO_INIT uint32_t totalIdleCycles;
+#endif
+
+#ifdef USE_SCHEDULER_IDLE_SLEEP
+// Wait for an interrupt when nothing is due, the gyro interrupt wakes us for the next loop at the latest
+#define SCHEDULER_IDLE_SLEEP_MIN_US 20  // busy wait when the gyro run is this close, waking up takes time too
+static FAST_RAM_ZERO_INIT bool idleSleepEnabled;
+#endif
+
 
 static FAST_RAM_ZERO_INIT int taskQueuePos = 0;
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskQueueSize = 0;
@@ -61,10 +80,81 @@ STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskQueueSize = 0;
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT cfTask_t* taskQueueArray[TASK_COUNT + 1]; // extra item for NULL pointer at end of queue
 
+#ifdef USE_SCHEDULER_WHEEL
+// Time driven tasks wait in a timer wheel slot keyed on lastExecutedAt + desiredPeriod
+// and only join the ready set when the wheel reaches that slot. Event driven tasks
+// have to be polled and stay in the poll set, so a scheduler pass only visits tasks
+// that can actually run. Bits are queue positions, so the ready set keeps priority order.
+#define SCHEDULER_WHEEL_SLOTS       32U
+#define SCHEDULER_WHEEL_TICK_SHIFT  8   // 256us per slot, 8ms horizon, later tasks are re-queued on wakeup
+#define SCHEDULER_WHEEL_TICK_US     (1 << SCHEDULER_WHEEL_TICK_SHIFT)
+
+static FAST_RAM_ZERO_INIT BITARRAY_DECLARE(wheelSlot[SCHEDULER_WHEEL_SLOTS], TASK_COUNT);
+static FAST_RAM_ZERO_INIT BITARRAY_DECLARE(readyTasks, TASK_COUNT);
+static FAST_RAM_ZERO_INIT BITARRAY_DECLARE(pollTasks, TASK_COUNT);
+static FAST_RAM_ZERO_INIT uint32_t wheelCursor;
+static FAST_RAM_ZERO_INIT timeUs_t wheelTimeUs;     // start of the slot at wheelCursor
+
+// Queue positions shift on every add or remove, so start over with every task ready
+static void wheelRebuild(void) {
+    memset(wheelSlot, 0, sizeof(wheelSlot));
+    BITARRAY_CLR_ALL(readyTasks);
+    BITARRAY_CLR_ALL(pollTasks);
+    for (int ii = 0; ii < taskQueueSize; ++ii) {
+        bitArraySet(taskQueueArray[ii]->checkFunc ? pollTasks : readyTasks, ii);
+    }
+}
+
+static FAST_CODE void wheelAdvance(timeUs_t currentTimeUs) {
+    const uint32_t elapsedSlots = (currentTimeUs - wheelTimeUs) >> SCHEDULER_WHEEL_TICK_SHIFT;
+    if (elapsedSlots == 0) {
+        return;
+    }
+    const uint32_t slotCount = MIN(elapsedSlots, SCHEDULER_WHEEL_SLOTS);
+    for (uint32_t ii = 1; ii <= slotCount; ++ii) {
+        bitarrayElement_t *slot = wheelSlot[(wheelCursor + ii) % SCHEDULER_WHEEL_SLOTS];
+        for (unsigned jj = 0; jj < ARRAYLEN(readyTasks); ++jj) {
+            readyTasks[jj] |= slot[jj];
+            slot[jj] = 0;
+        }
+    }
+    wheelCursor += elapsedSlots;
+    wheelTimeUs += elapsedSlots << SCHEDULER_WHEEL_TICK_SHIFT;
+}
+
+// Parks a time driven task until the slot holding its next execution time,
+// tasks due within the current slot stay ready and are checked on every pass
+static FAST_CODE void wheelInsert(int queuePos, const cfTask_t *task) {
+    const timeDelta_t untilDueUs = (task->lastExecutedAt + task->desiredPeriod) - wheelTimeUs;
+    if (untilDueUs < SCHEDULER_WHEEL_TICK_US) {
+        bitArraySet(readyTasks, queuePos);
+        return;
+    }
+    bitArrayClr(readyTasks, queuePos);
+    const uint32_t slots = MIN((uint32_t)untilDueUs >> SCHEDULER_WHEEL_TICK_SHIFT, SCHEDULER_WHEEL_SLOTS - 1);
+    bitArraySet(wheelSlot[(wheelCursor + slots) % SCHEDULER_WHEEL_SLOTS], queuePos);
+}
+
+static void wheelWakeTask(const cfTask_t *task) {
+    for (int ii = 0; ii < taskQueueSize; ++ii) {
+        if (taskQueueArray[ii] == task) {
+            if (!task->checkFunc) {
+                bitArraySet(readyTasks, ii);
+            }
+            return;
+        }
+    }
+}
+#endif
+
 void queueClear(void) {
     memset(taskQueueArray, 0, sizeof(taskQueueArray));
     taskQueuePos = 0;
     taskQueueSize = 0;
+    gyroTask = NULL;
+#ifdef USE_SCHEDULER_WHEEL
+    wheelRebuild();
+#endif
 }
 
 bool queueContains(cfTask_t *task) {
@@ -85,6 +175,13 @@ bool queueAdd(cfTask_t *task) {
             memmove(&taskQueueArray[ii + 1], &taskQueueArray[ii], sizeof(task) * (taskQueueSize - ii));
             taskQueueArray[ii] = task;
             ++taskQueueSize;
+            // an event driven gyro task has no predictable next run to keep clear
+            if (task == &cfTasks[TASK_GYROPID] && !task->checkFunc) {
+                gyroTask = task;
+            }
+#ifdef USE_SCHEDULER_WHEEL
+            wheelRebuild();
+#endif
             return true;
         }
     }
@@ -96,6 +193,12 @@ bool queueRemove(cfTask_t *task) {
         if (taskQueueArray[ii] == task) {
             memmove(&taskQueueArray[ii], &taskQueueArray[ii + 1], sizeof(task) * (taskQueueSize - ii));
             --taskQueueSize;
+            if (task == gyroTask) {
+                gyroTask = NULL;
+            }
+#ifdef USE_SCHEDULER_WHEEL
+            wheelRebuild();
+#endif
             return true;
         }
     }
@@ -118,15 +221,37 @@ FAST_CODE cfTask_t *queueNext(void) {
 }
 
 void taskSystemLoad(timeUs_t currentTimeUs) {
-    UNUSED(currentTimeUs);
+    static timeUs_t lastLoadTimeUs = 0;
     // Calculate system load
     if (totalWaitingTasksSamples > 0) {
         averageSystemLoadPercent = 100 * totalWaitingTasks / totalWaitingTasksSamples;
         totalWaitingTasksSamples = 0;
         totalWaitingTasks = 0;
     }
+    const timeDelta_t elapsedUs = currentTimeUs - lastLoadTimeUs;
+    if (lastLoadTimeUs && elapsedUs > 0) {
+        averageCpuLoadPercent = 100 - MIN(100, 100 * totalIdleTimeUs / elapsedUs);
+    }
+    lastLoadTimeUs = currentTimeUs;
+    totalIdleTimeUs = 0;
+#ifdef USE_CYCLE_PROFILE
+    if (cycleProfileEnabled) {
+        cycleProfileUpdateLoad(totalIdleCycles);
+        averageCpuLoadPercent = getCycleLoad()->busyPermille / 10;
+    }
+    totalIdleCycles = 0;
+#endif
 #if defined(SIMULATOR_BUILD)
     averageSystemLoadPercent = 0;
+    averageCpuLoadPercent = 0;
+#endif
+}
+
+void schedulerSetIdleSleep(bool enabled) {
+#ifdef USE_SCHEDULER_IDLE_SLEEP
+    idleSleepEnabled = enabled;
+#else
+    UNUSED(enabled);
 #endif
 }
 
@@ -162,6 +287,10 @@ void rescheduleTask(cfTaskId_e taskId, uint32_t newPeriodMicros) {
     } else if (taskId < TASK_COUNT) {
         cfTask_t *task = &cfTasks[taskId];
         task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+#ifdef USE_SCHEDULER_WHEEL
+        // a shorter period may make the task due before its wheel slot
+        wheelWakeTask(task);
+#endif
     }
 }
 
@@ -224,85 +353,134 @@ void schedulerInit(void) {
     queueAdd(&cfTasks[TASK_SYSTEM]);
 }
 
+// Updates the dynamic priority of a task, returns true if the task is waiting to be run
+static FAST_CODE bool schedulerUpdateTask(cfTask_t *task, timeUs_t currentTimeUs) {
+    bool waiting = false;
+    // Task has checkFunc - event driven
+    if (task->checkFunc) {
+#if defined(SCHEDULER_DEBUG)
+        const timeUs_t currentTimeBeforeCheckFuncCall = micros();
+#else
+        const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
+#endif
+        // Increase priority for event driven tasks
+        if (task->staticPriority == TASK_PRIORITY_TRIGGER) {
+            if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
+                task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAt) / task->desiredPeriod);
+                if (task->taskAgeCycles > 0) {
+                    task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+                    waiting = true;
+                }
+            } else {
+                task->taskAgeCycles = 0;
+            }
+        } else if (task->dynamicPriority > 0) {
+            task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
+            task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+            waiting = true;
+        } else if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
+#if defined(SCHEDULER_DEBUG)
+            DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
+#endif
+#ifndef SKIP_TASK_STATISTICS
+            if (calculateTaskStatistics) {
+                const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
+                checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
+                checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
+                checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
+            }
+#endif
+            task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
+            task->taskAgeCycles = 1;
+            task->dynamicPriority = 1 + task->staticPriority;
+            waiting = true;
+        } else {
+            task->taskAgeCycles = 0;
+        }
+    } else {
+        // Task is time-driven, dynamicPriority is last execution age (measured in desiredPeriods)
+        // Task age is calculated from last execution
+        task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAt) / task->desiredPeriod);
+        if (task->taskAgeCycles > 0) {
+            task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+            waiting = true;
+        }
+    }
+    return waiting;
+}
+
+static FAST_CODE bool schedulerTaskCanBeChosen(const cfTask_t *task, bool outsideRealtimeGuardInterval, timeDelta_t timeUntilGyroUs) {
+    if (task->staticPriority == TASK_PRIORITY_REALTIME || task == gyroTask || task->taskAgeCycles > 1) {
+        // realtime tasks always run, and a starved task runs even if it delays the gyro
+        return true;
+    }
+    return outsideRealtimeGuardInterval && task->executionTimeEstimate <= timeUntilGyroUs;
+}
+
+// Decaying maximum, follows a task that got slower at once and one that got faster slowly
+static FAST_CODE void schedulerUpdateExecutionTimeEstimate(cfTask_t *task, timeDelta_t taskExecutionTime) {
+    task->executionTimeEstimate = MAX(taskExecutionTime, task->executionTimeEstimate - task->executionTimeEstimate / TASK_EXECUTION_ESTIMATE_DECAY);
+}
+
 FAST_CODE void scheduler(void) {
     // Cache currentTime
     const timeUs_t currentTimeUs = micros();
+#ifdef USE_CYCLE_PROFILE
+    const uint32_t passStartCycles = CYCLE_COUNTER_NOW();
+    const uint32_t passStartIsrCycles = cycleIsrTotalCycles;
+#endif
     // Check for realtime tasks
     bool outsideRealtimeGuardInterval = true;
     for (const cfTask_t *task = queueFirst(); task != NULL && task->staticPriority == TASK_PRIORITY_REALTIME; task = queueNext()) {
         const timeUs_t nextExecuteAt = task->lastExecutedAt + task->desiredPeriod;
-        if ((timeDelta_t)(currentTimeUs - nextExecuteAt) >= 0) {
+        if (!task->checkFunc && (timeDelta_t)(currentTimeUs - nextExecuteAt) >= 0) {
             outsideRealtimeGuardInterval = false;
             break;
         }
     }
+    // Time left before the next gyro run is predicted, ignored when there is no gyro task
+    const timeDelta_t timeUntilGyroUs = gyroTask ? (timeDelta_t)(gyroTask->lastExecutedAt + gyroTask->desiredPeriod - currentTimeUs) : INT32_MAX;
     // The task to be invoked
     cfTask_t *selectedTask = NULL;
     uint16_t selectedTaskDynamicPriority = 0;
     // Update task dynamic priorities
     uint16_t waitingTasks = 0;
-    for (cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
-        // Task has checkFunc - event driven
-        if (task->checkFunc) {
-#if defined(SCHEDULER_DEBUG)
-            const timeUs_t currentTimeBeforeCheckFuncCall = micros();
-#else
-            const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
-#endif
-            // Increase priority for event driven tasks
-            if (task->staticPriority == TASK_PRIORITY_TRIGGER) {
-                if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
-                    task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAt) / task->desiredPeriod);
-                    if (task->taskAgeCycles > 0) {
-                        task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                        waitingTasks++;
-                    }
-                } else {
-                    task->taskAgeCycles = 0;
-                }
-            } else if (task->dynamicPriority > 0) {
-                task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
-                task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                waitingTasks++;
-            } else if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
-#if defined(SCHEDULER_DEBUG)
-                DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
-#endif
-#ifndef SKIP_TASK_STATISTICS
-                if (calculateTaskStatistics) {
-                    const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
-                    checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
-                    checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
-                    checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
-                }
-#endif
-                task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
-                task->taskAgeCycles = 1;
-                task->dynamicPriority = 1 + task->staticPriority;
-                waitingTasks++;
-            } else {
-                task->taskAgeCycles = 0;
-            }
-        } else {
-            // Task is time-driven, dynamicPriority is last execution age (measured in desiredPeriods)
-            // Task age is calculated from last execution
-            task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAt) / task->desiredPeriod);
-            if (task->taskAgeCycles > 0) {
-                task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                waitingTasks++;
+#ifdef USE_SCHEDULER_WHEEL
+    int selectedTaskQueuePos = -1;
+    wheelAdvance(currentTimeUs);
+    BITARRAY_DECLARE(candidateTasks, TASK_COUNT);
+    for (unsigned ii = 0; ii < ARRAYLEN(candidateTasks); ++ii) {
+        candidateTasks[ii] = readyTasks[ii] | pollTasks[ii];
+    }
+    for (int queuePos = BITARRAY_FIND_FIRST_SET(candidateTasks, 0); queuePos >= 0; queuePos = BITARRAY_FIND_FIRST_SET(candidateTasks, queuePos + 1)) {
+        cfTask_t *task = taskQueueArray[queuePos];
+        if (schedulerUpdateTask(task, currentTimeUs)) {
+            waitingTasks++;
+        } else if (!task->checkFunc) {
+            // woken early by its slot, park it again
+            wheelInsert(queuePos, task);
+        }
+        if (task->dynamicPriority > selectedTaskDynamicPriority) {
+            if (schedulerTaskCanBeChosen(task, outsideRealtimeGuardInterval, timeUntilGyroUs)) {
+                selectedTaskDynamicPriority = task->dynamicPriority;
+                selectedTask = task;
+                selectedTaskQueuePos = queuePos;
             }
         }
+    }
+#else
+    for (cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
+        if (schedulerUpdateTask(task, currentTimeUs)) {
+            waitingTasks++;
+        }
         if (task->dynamicPriority > selectedTaskDynamicPriority) {
-            const bool taskCanBeChosenForScheduling =
-                (outsideRealtimeGuardInterval) ||
-                (task->taskAgeCycles > 1) ||
-                (task->staticPriority == TASK_PRIORITY_REALTIME);
-            if (taskCanBeChosenForScheduling) {
+            if (schedulerTaskCanBeChosen(task, outsideRealtimeGuardInterval, timeUntilGyroUs)) {
                 selectedTaskDynamicPriority = task->dynamicPriority;
                 selectedTask = task;
             }
         }
     }
+#endif
     totalWaitingTasksSamples++;
     totalWaitingTasks += waitingTasks;
     currentTask = selectedTask;
@@ -312,24 +490,53 @@ FAST_CODE void scheduler(void) {
         selectedTask->lastExecutedAt = currentTimeUs;
         selectedTask->dynamicPriority = 0;
         // Execute task
+#ifdef USE_CYCLE_PROFILE
+        const uint32_t cyclesBeforeTaskCall = CYCLE_COUNTER_NOW();
+#endif
+        const timeUs_t currentTimeBeforeTaskCall = micros();
 #ifdef SKIP_TASK_STATISTICS
         selectedTask->taskFunc(currentTimeUs);
+        const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
 #else
+        selectedTask->taskFunc(calculateTaskStatistics ? currentTimeBeforeTaskCall : currentTimeUs);
+        const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
         if (calculateTaskStatistics) {
-            const timeUs_t currentTimeBeforeTaskCall = micros();
-            selectedTask->taskFunc(currentTimeBeforeTaskCall);
-            const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
             selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / MOVING_SUM_COUNT;
             selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
             selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
-        } else {
-            selectedTask->taskFunc(currentTimeUs);
+        }
+#endif
+#ifdef USE_CYCLE_PROFILE
+        if (cycleProfileEnabled) {
+            cycleProfileRecordTask(selectedTask - cfTasks, CYCLE_COUNTER_NOW() - cyclesBeforeTaskCall);
+        }
+#endif
+        schedulerUpdateExecutionTimeEstimate(selectedTask, taskExecutionTime);
+#ifdef USE_SCHEDULER_WHEEL
+        if (!selectedTask->checkFunc && taskQueueArray[selectedTaskQueuePos] == selectedTask) {
+            // the task may have changed its period or the queue while running
+            wheelInsert(selectedTaskQueuePos, selectedTask);
         }
 #endif
 #if defined(SCHEDULER_DEBUG)
         DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs - taskExecutionTime); // time spent in scheduler
+#endif
     } else {
-        DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs);
+#ifdef USE_SCHEDULER_IDLE_SLEEP
+        if (idleSleepEnabled && !waitingTasks && timeUntilGyroUs > SCHEDULER_IDLE_SLEEP_MIN_US) {
+            // masked, an interrupt that comes in just before the WFI still ends the wait instead of being taken first
+            __disable_irq();
+            __WFI();
+            __enable_irq();
+        }
+#endif
+        const timeUs_t idleTimeUs = micros() - currentTimeUs;
+        totalIdleTimeUs += idleTimeUs;
+#ifdef USE_CYCLE_PROFILE
+        totalIdleCycles += (CYCLE_COUNTER_NOW() - passStartCycles) - (cycleIsrTotalCycles - passStartIsrCycles);
+#endif
+#if defined(SCHEDULER_DEBUG)
+        DEBUG_SET(DEBUG_SCHEDULER, 2, idleTimeUs);
 #endif
     }
     GET_SCHEDULER_LOCALS();
@@ -26,6 +26,8 @@
 #define TASK_PERIOD_MS(ms) ((ms) * 1000)
 #define TASK_PERIOD_US(us) (us)
 
+#define TASK_EXECUTION_ESTIMATE_DECAY 64   // estimate drops by 1/64 per run when the task gets faster
+
 
 typedef enum {
     TASK_PRIORITY_IDLE = 0,     // Disables dynamic scheduling, task is executed only if no other task is active this cycle
@@ -120,9 +122,6 @@ typedef enum {
 #ifdef USE_VTX_CONTROL
     TASK_VTXCTRL,
 #endif
-#ifdef USE_CAMERA_CONTROL
-    TASK_CAMCTRL,
-#endif
 
 #ifdef USE_RCDEVICE
     TASK_RCDEVICE,
@@ -140,6 +139,14 @@ typedef enum {
     TASK_BEESIGN,
 #endif
 
+#ifdef USE_BLACKBOX_ENCODE_TASK
+    TASK_BLACKBOX,
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    TASK_DYN_NOTCH,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -163,6 +170,7 @@ typedef struct {
     timeDelta_t taskLatestDeltaTime;
     timeUs_t lastExecutedAt;        // last time of invocation
     timeUs_t lastSignaledAt;        // time of invocation event for event-driven tasks
+    timeDelta_t executionTimeEstimate;  // decaying worst case execution time, keeps the task clear of the next gyro run
 
 #ifndef SKIP_TASK_STATISTICS
     // Statistics
@@ -174,6 +182,7 @@ typedef struct {
 
 extern cfTask_t cfTasks[TASK_COUNT];
 extern uint16_t averageSystemLoadPercent;
+extern uint16_t averageCpuLoadPercent;
 
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo);
@@ -187,6 +196,7 @@ void schedulerResetTaskMaxExecutionTime(cfTaskId_e taskId);
 void schedulerInit(void);
 void scheduler(void);
 void taskSystemLoad(timeUs_t currentTime);
+void schedulerSetIdleSleep(bool enabled);
 
 #define LOAD_PERCENTAGE_ONE 100
 
@@ -27,6 +27,7 @@
 
 #include "build/debug.h"
 
+#include "common/accumulator.h"
 #include "common/axis.h"
 #include "common/filter.h"
 #include "common/utils.h"
@@ -89,8 +90,7 @@
 
 FAST_RAM_ZERO_INIT acc_t acc;                       // acc access functions
 
-static float accumulatedMeasurements[XYZ_AXIS_COUNT];
-static int accumulatedMeasurementCount;
+static accumulator_t accAccumulator;
 
 static uint16_t calibratingA = 0;      // the calibration is done is the main loop. Calibrating decreases at each cycle down to 0, then we enter in a normal mode.
 
@@ -383,6 +383,25 @@ bool accInit(void) {
     }
     acc.dev.acc_1G = 256; // set default
     acc.dev.initFn(&acc.dev); // driver initialisation
+#ifdef USE_GYRO_ACC_BURST
+    switch (detectedSensors[SENSOR_INDEX_ACC]) {
+    case ACC_MPU6000:
+    case ACC_MPU6500:
+    case ACC_MPU9250:
+    case ACC_ICM20601:
+    case ACC_ICM20602:
+    case ACC_ICM20608G:
+    case ACC_ICM20649:
+    case ACC_ICM20689:
+    case ACC_ICM42605:
+    case ACC_ICM42688P:
+        // same chip as the gyro, take the acc data from the gyro reads
+        gyroInitAccBurst(&acc.dev);
+        break;
+    default:
+        break;
+    }
+#endif
     // set the acc sampling interval according to the gyro sampling interval
     if (accLpfCutHz) {
         const float k = pt1FilterGain(accLpfCutHz, 1.0f / (float)DEFAULT_ACC_SAMPLE_INTERVAL);
@@ -511,23 +530,17 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims) {
     acc.accADC[X] -= accelerationTrims->raw[X];
     acc.accADC[Y] -= accelerationTrims->raw[Y];
     acc.accADC[Z] -= accelerationTrims->raw[Z];
-    ++accumulatedMeasurementCount;
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        accumulatedMeasurements[axis] += acc.accADC[axis];
-    }
+    accumulatorAdd(&accAccumulator, acc.accADC);
     acc.isAccelUpdatedAtLeastOnce = true;
 }
 
 bool accGetAverage(quaternion *vAverage) {
-    if (accumulatedMeasurementCount > 0) {
+    accumulatorSums_t measurements;
+    if (accumulatorTake(&accAccumulator, &measurements)) {
         vAverage->w = 0;
-        vAverage->x = accumulatedMeasurements[X] / accumulatedMeasurementCount;
-        vAverage->y = accumulatedMeasurements[Y] / accumulatedMeasurementCount;
-        vAverage->z = accumulatedMeasurements[Z] / accumulatedMeasurementCount;
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            accumulatedMeasurements[axis] = 0.0f;
-        }
-        accumulatedMeasurementCount = 0;
+        vAverage->x = measurements.sum[X] / measurements.count;
+        vAverage->y = measurements.sum[Y] / measurements.count;
+        vAverage->z = measurements.sum[Z] / measurements.count;
         return true;
     } else {
         quaternionInitVector(vAverage);
@@ -239,26 +239,39 @@ void baroSetCalibrationCycles(uint16_t calibrationCyclesRequired) {
     calibratingB = calibrationCyclesRequired;
 }
 
-static bool baroReady = false;
+#ifdef USE_WARM_BOOT
+void baroGetGroundReference(int32_t *groundPressure, int32_t *groundAltitude) {
+    *groundPressure = baroGroundPressure;
+    *groundAltitude = baroGroundAltitude;
+}
+
+// takes a ground reference kept from before a reset in place of calibrating again
+void baroSetGroundReference(int32_t groundPressure, int32_t groundAltitude) {
+    baroGroundPressure = groundPressure;
+    baroGroundAltitude = groundAltitude;
+    calibratingB = 0;
+}
+#endif
 
-#define PRESSURE_SAMPLES_MEDIAN 3
+static bool baroReady = false;
 
+// median of the last three readings, kept incrementally instead of copying and sorting a window
 static int32_t applyBarometerMedianFilter(int32_t newPressureReading) {
-    static int32_t barometerFilterSamples[PRESSURE_SAMPLES_MEDIAN];
-    static int currentFilterSampleIndex = 0;
-    static bool medianFilterReady = false;
-    int nextSampleIndex;
-    nextSampleIndex = (currentFilterSampleIndex + 1);
-    if (nextSampleIndex == PRESSURE_SAMPLES_MEDIAN) {
-        nextSampleIndex = 0;
-        medianFilterReady = true;
-    }
-    barometerFilterSamples[currentFilterSampleIndex] = newPressureReading;
-    currentFilterSampleIndex = nextSampleIndex;
-    if (medianFilterReady)
-        return quickMedianFilter3(barometerFilterSamples);
-    else
+    static int32_t previousReading[2];
+    static uint8_t readingCount = 0;
+    const int32_t a = previousReading[0];
+    const int32_t b = previousReading[1];
+    const int32_t c = newPressureReading;
+    previousReading[0] = b;
+    previousReading[1] = c;
+    if (readingCount < 2) {
+        readingCount++;
         return newPressureReading;
+    }
+    if (a > b) {
+        return (b > c) ? b : ((a > c) ? c : a);
+    }
+    return (a > c) ? a : ((b > c) ? c : b);
 }
 
 static uint32_t recalculateBarometerTotal(uint32_t pressureTotal, int32_t newPressureReading) {
@@ -281,8 +294,10 @@ static uint32_t recalculateBarometerTotal(uint32_t pressureTotal, int32_t newPre
 }
 
 typedef enum {
-    BAROMETER_NEEDS_SAMPLES = 0,
-    BAROMETER_NEEDS_CALCULATION
+    BAROMETER_NEEDS_TEMPERATURE_READ = 0,
+    BAROMETER_NEEDS_TEMPERATURE_SAMPLE,
+    BAROMETER_NEEDS_PRESSURE_READ,
+    BAROMETER_NEEDS_PRESSURE_SAMPLE
 } barometerState_e;
 
 
@@ -290,26 +305,58 @@ bool isBaroReady(void) {
     return baroReady;
 }
 
+// time an I2C result read takes to complete, the baro task is polled at this rate until it is done
+#define BARO_BUS_POLL_INTERVAL_US 250
+
 uint32_t baroUpdate(void) {
-    static barometerState_e state = BAROMETER_NEEDS_SAMPLES;
+    static barometerState_e state = BAROMETER_NEEDS_TEMPERATURE_READ;
+    bool busError = false;
     switch (state) {
     default:
-    case BAROMETER_NEEDS_SAMPLES:
-        baro.dev.get_ut(&baro.dev);
+    case BAROMETER_NEEDS_TEMPERATURE_READ:
+        if (baro.dev.read_ut) {
+            if (baro.dev.read_ut(&baro.dev)) {
+                state = BAROMETER_NEEDS_TEMPERATURE_SAMPLE;
+            }
+            return BARO_BUS_POLL_INTERVAL_US;
+        }
+        FALLTHROUGH;
+    case BAROMETER_NEEDS_TEMPERATURE_SAMPLE:
+        if (busBusy(&baro.dev.busdev, &busError)) {
+            return BARO_BUS_POLL_INTERVAL_US;
+        }
+        if (!busError) {
+            baro.dev.get_ut(&baro.dev);
+        }
         baro.dev.start_up(&baro.dev);
-        state = BAROMETER_NEEDS_CALCULATION;
+        state = BAROMETER_NEEDS_PRESSURE_READ;
         return baro.dev.up_delay;
-        break;
-    case BAROMETER_NEEDS_CALCULATION:
-        baro.dev.get_up(&baro.dev);
+    case BAROMETER_NEEDS_PRESSURE_READ:
+        if (baro.dev.read_up) {
+            if (baro.dev.read_up(&baro.dev)) {
+                state = BAROMETER_NEEDS_PRESSURE_SAMPLE;
+            }
+            return BARO_BUS_POLL_INTERVAL_US;
+        }
+        FALLTHROUGH;
+    case BAROMETER_NEEDS_PRESSURE_SAMPLE:
+        if (busBusy(&baro.dev.busdev, &busError)) {
+            return BARO_BUS_POLL_INTERVAL_US;
+        }
+        // a failed read keeps the previous pressure instead of feeding garbage into the sum
+        if (!busError) {
+            baro.dev.get_up(&baro.dev);
+        }
         baro.dev.start_ut(&baro.dev);
+        state = BAROMETER_NEEDS_TEMPERATURE_READ;
+        if (busError) {
+            return baro.dev.ut_delay;
+        }
         baro.dev.calculate(&baroPressure, &baroTemperature);
         baro.baroPressure = baroPressure;
         baro.baroTemperature = baroTemperature;
         baroPressureSum = recalculateBarometerTotal(baroPressureSum, baroPressure);
-        state = BAROMETER_NEEDS_SAMPLES;
         return baro.dev.ut_delay;
-        break;
     }
 }
 
@@ -62,6 +62,10 @@ extern baro_t baro;
 bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse);
 bool isBaroCalibrationComplete(void);
 void baroSetCalibrationCycles(uint16_t calibrationCyclesRequired);
+#ifdef USE_WARM_BOOT
+void baroGetGroundReference(int32_t *groundPressure, int32_t *groundAltitude);
+void baroSetGroundReference(int32_t groundPressure, int32_t groundAltitude);
+#endif
 uint32_t baroUpdate(void);
 bool isBaroReady(void);
 int32_t baroCalculateAltitude(void);
@@ -40,6 +40,8 @@
 #include "fc/controlrate_profile.h"
 #include "fc/rc_controls.h"
 
+#include "flight/pid.h"
+
 #include "io/beeper.h"
 
 #include "sensors/battery.h"
@@ -73,6 +75,11 @@ static batteryState_e batteryState;
 static batteryState_e voltageState;
 static batteryState_e consumptionState;
 
+// factor for the mixer, updated with the voltage so applying it is a single multiply
+static float batteryCompensationFactor = 1.0f;
+static bool sagCompensationActive;
+static pt1Filter_t sagCompensationFilter;
+
 #ifndef DEFAULT_CURRENT_METER_SOURCE
 #ifdef USE_VIRTUAL_CURRENT_METER
 #define DEFAULT_CURRENT_METER_SOURCE CURRENT_METER_VIRTUAL
@@ -89,7 +96,7 @@ static batteryState_e consumptionState;
 #define DEFAULT_VOLTAGE_METER_SOURCE VOLTAGE_METER_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 3);
+PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 4);
 
 PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
                   // voltage
@@ -119,8 +126,32 @@ PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
                   .ibatLpfPeriod = 10,
                   .vbatDurationForWarning = 0,
                   .vbatDurationForCritical = 0,
+                  .vbatSagLpfHz = 0,
                  );
 
+static float batteryCompensationFactorFor(float voltage) {
+    if (currentControlRateProfile->vbat_comp_type == VBAT_COMP_TYPE_OFF
+        || batteryConfig()->voltageMeterSource == VOLTAGE_METER_NONE
+        || batteryCellCount == 0) {
+        return 1.0f;
+    }
+
+    float vbat = voltage / batteryCellCount;
+    vbat = constrainf(vbat, batteryConfig()->vbatmincellvoltage, batteryConfig()->vbatmaxcellvoltage);
+
+    float factor = currentControlRateProfile->vbat_comp_ref / vbat;
+
+    switch (currentControlRateProfile->vbat_comp_type) {
+        case VBAT_COMP_TYPE_BOOST:
+            return MAX(factor, 1.0f);
+        case VBAT_COMP_TYPE_LIMIT:
+            return MIN(factor, 1.0f);
+        case VBAT_COMP_TYPE_BOTH: // or it would be unused
+        default:
+            return factor;
+    }
+}
+
 void batteryUpdateVoltage(timeUs_t currentTimeUs) {
     UNUSED(currentTimeUs);
     switch (batteryConfig()->voltageMeterSource) {
@@ -141,9 +172,12 @@ void batteryUpdateVoltage(timeUs_t currentTimeUs) {
         voltageMeterReset(&voltageMeter);
         break;
     }
-    if (debugMode == DEBUG_BATTERY) {
-        debug[0] = voltageMeter.unfiltered;
-        debug[1] = voltageMeter.filtered;
+    if (debugModeIsActive(DEBUG_BATTERY)) {
+        DEBUG_SET(DEBUG_BATTERY, 0, voltageMeter.unfiltered);
+        DEBUG_SET(DEBUG_BATTERY, 1, voltageMeter.filtered);
+    }
+    if (!sagCompensationActive) {
+        batteryCompensationFactor = batteryCompensationFactorFor(voltageMeter.filtered);
     }
 }
 
@@ -205,9 +239,9 @@ void batteryUpdatePresence(void) {
         batteryWarningVoltage = 0;
         batteryCriticalVoltage = 0;
     }
-    if (debugMode == DEBUG_BATTERY) {
-        debug[2] = batteryCellCount;
-        debug[3] = isVoltageStable();
+    if (debugModeIsActive(DEBUG_BATTERY)) {
+        DEBUG_SET(DEBUG_BATTERY, 2, batteryCellCount);
+        DEBUG_SET(DEBUG_BATTERY, 3, isVoltageStable());
     }
 }
 
@@ -322,6 +356,8 @@ void batteryInit(void) {
     lowVoltageCutoff.percentage = 100;
     lowVoltageCutoff.startTime = 0;
     voltageMeterReset(&voltageMeter);
+    batteryCompensationFactor = 1.0f;
+    sagCompensationActive = false;
     switch (batteryConfig()->voltageMeterSource) {
     case VOLTAGE_METER_ESC:
 #ifdef USE_ESC_SENSOR
@@ -330,6 +366,10 @@ void batteryInit(void) {
         break;
     case VOLTAGE_METER_ADC:
         voltageMeterADCInit();
+        if (batteryConfig()->vbatSagLpfHz) {
+            pt1FilterInit(&sagCompensationFilter, pt1FilterGain(batteryConfig()->vbatSagLpfHz, targetPidLooptime * 1e-6f));
+            sagCompensationActive = true;
+        }
         break;
     default:
         break;
@@ -408,28 +448,22 @@ void batteryUpdateCurrentMeter(timeUs_t currentTimeUs) {
     }
 }
 
-float calculateBatteryCompensationFactor()
-{
-    if (currentControlRateProfile->vbat_comp_type == VBAT_COMP_TYPE_OFF
-        || batteryConfig()->voltageMeterSource == VOLTAGE_METER_NONE
-        || batteryCellCount == 0) {
-        return 1.0f;
+// With vbat_sag_lpf_hz set and an ADC voltage meter, the compensation follows the sag every loop
+// rather than the slow filtered voltage. Called by the mixer once per loop.
+void batteryUpdateSagCompensation(void) {
+    if (!sagCompensationActive) {
+        return;
     }
-
-    float vbat = (float) voltageMeter.filtered / batteryCellCount;
-    vbat = constrainf(vbat, batteryConfig()->vbatmincellvoltage, batteryConfig()->vbatmaxcellvoltage);
-
-    float factor = currentControlRateProfile->vbat_comp_ref / vbat;
-
-    switch (currentControlRateProfile->vbat_comp_type) {
-        case VBAT_COMP_TYPE_BOOST:
-            return MAX(factor, 1.0f);
-        case VBAT_COMP_TYPE_LIMIT:
-            return MIN(factor, 1.0f);
-        case VBAT_COMP_TYPE_BOTH: // or it would be unused
-        default:
-            return factor;
+    const uint16_t voltage = getBatteryVoltageSample();
+    if (batteryCellCount == 0) {
+        // no battery yet, start from the pack voltage rather than ramping up from zero
+        sagCompensationFilter.state = voltage;
     }
+    batteryCompensationFactor = batteryCompensationFactorFor(pt1FilterApply(&sagCompensationFilter, voltage));
+}
+
+float getBatteryCompensationFactor(void) {
+    return batteryCompensationFactor;
 }
 
 uint8_t calculateBatteryPercentageRemaining(void) {
@@ -464,6 +498,15 @@ uint16_t getBatteryVoltageLatest(void) {
     return voltageMeter.unfiltered;
 }
 
+// Unlike getBatteryVoltageLatest() this is not held between battery task runs when the meter is the ADC,
+// so it follows the sag with the motors.
+uint16_t getBatteryVoltageSample(void) {
+    if (batteryConfig()->voltageMeterSource == VOLTAGE_METER_ADC) {
+        return voltageMeterADCSample(VOLTAGE_SENSOR_ADC_VBAT);
+    }
+    return voltageMeter.unfiltered;
+}
+
 uint8_t getBatteryCellCount(void) {
     return batteryCellCount;
 }
@@ -484,6 +527,13 @@ int32_t getAmperageLatest(void) {
     return currentMeter.amperageLatest;
 }
 
+int32_t getAmperageSample(void) {
+    if (batteryConfig()->currentMeterSource == CURRENT_METER_ADC) {
+        return currentMeterADCSample();
+    }
+    return currentMeter.amperageLatest;
+}
+
 int32_t getMAhDrawn(void) {
     return currentMeter.mAhDrawn;
 }
@@ -65,6 +65,7 @@ typedef struct batteryConfig_s {
     uint8_t ibatLpfPeriod;                  // Period of the cutoff frequency for the Ibat filter (in 0.1 s)
     uint8_t vbatDurationForWarning;         // Period voltage has to sustain before the battery state is set to BATTERY_WARNING (in 0.1 s)
     uint8_t vbatDurationForCritical;        // Period voltage has to sustain before the battery state is set to BATTERY_CRIT (in 0.1 s)
+    uint8_t vbatSagLpfHz;                   // Cutoff of the per loop voltage filter driving battery compensation, 0 uses the filtered voltage
 } batteryConfig_t;
 
 PG_DECLARE(batteryConfig_t, batteryConfig);
@@ -97,17 +98,20 @@ void batteryUpdateAlarms(void);
 
 struct rxConfig_s;
 
-float calculateBatteryCompensationFactor();
+void batteryUpdateSagCompensation(void);
+float getBatteryCompensationFactor(void);
 uint8_t calculateBatteryPercentageRemaining(void);
 bool isBatteryVoltageConfigured(void);
 uint16_t getBatteryVoltage(void);
 uint16_t getBatteryVoltageLatest(void);
+uint16_t getBatteryVoltageSample(void);
 uint8_t getBatteryCellCount(void);
 uint16_t getBatteryAverageCellVoltage(void);
 
 bool isAmperageConfigured(void);
 int32_t getAmperage(void);
 int32_t getAmperageLatest(void);
+int32_t getAmperageSample(void);
 int32_t getMAhDrawn(void);
 
 void batteryUpdateCurrentMeter(timeUs_t currentTimeUs);
@@ -116,3 +116,16 @@ FAST_CODE void alignSensors(float *dest, uint8_t rotation) {
     if (!standardBoardAlignment)
         alignBoard(dest);
 }
+
+// Matrix doing what alignSensors() does for the rotation, board alignment included, so a sample
+// is aligned with one multiply whatever the mounting. Each column is an aligned unit vector
+void buildAlignmentMatrix(uint8_t rotation, float matrix[3][3]) {
+    for (int axis = X; axis <= Z; axis++) {
+        float unit[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+        unit[axis] = 1.0f;
+        alignSensors(unit, rotation);
+        matrix[X][axis] = unit[X];
+        matrix[Y][axis] = unit[Y];
+        matrix[Z][axis] = unit[Z];
+    }
+}
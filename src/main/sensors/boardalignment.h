@@ -31,5 +31,6 @@ typedef struct boardAlignment_s {
 PG_DECLARE(boardAlignment_t, boardAlignment);
 
 void alignSensors(float *dest, uint8_t rotation);
+void buildAlignmentMatrix(uint8_t rotation, float matrix[3][3]);
 void initBoardAlignment(const boardAlignment_t *boardAlignment);
 bool isBoardAlignmentStandard(const boardAlignment_t *boardAlignment);
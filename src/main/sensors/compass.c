@@ -26,6 +26,7 @@
 
 #include "build/debug.h"
 #include "common/axis.h"
+#include "common/sphere_fit.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -64,7 +65,7 @@ mag_t mag;                   // mag access functions
 #define COMPASS_INTERRUPT_TAG   IO_TAG_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 2);
 
 void pgResetFn_compassConfig(compassConfig_t *compassConfig) {
     compassConfig->mag_align = ALIGN_DEFAULT;
@@ -107,6 +108,83 @@ void pgResetFn_compassConfig(compassConfig_t *compassConfig) {
     compassConfig->mag_spi_csn = IO_TAG_NONE;
 #endif
     compassConfig->interruptTag = COMPASS_INTERRUPT_TAG;
+    compassConfig->mag_calibration_inflight = 0;
+}
+
+#define MAG_CALIBRATION_TIME_US         30000000    // 30s: you have 30s to turn the multi in all directions
+#define MAG_CALIBRATION_MIN_SAMPLES     50
+#define MAG_CALIBRATION_AXIS_COVERAGE   1.2f        // each axis has to sweep this much of the fitted radius, a full turn is 2
+#define MAG_INFLIGHT_WINDOW_SAMPLES     300
+#define MAG_INFLIGHT_MAX_SHIFT          0.25f       // of the radius
+
+typedef struct magCalibration_s {
+    sphereFit_t fit;
+    float min[XYZ_AXIS_COUNT];
+    float max[XYZ_AXIS_COUNT];
+    uint16_t samples;
+} magCalibration_t;
+
+static magCalibration_t magCalibration;
+static magCalibration_t magInflightCalibration;
+
+static void magCalibrationStart(magCalibration_t *cal, const float *sample) {
+    const float scale = sqrtf(sample[X] * sample[X] + sample[Y] * sample[Y] + sample[Z] * sample[Z]);
+    sphereFitInit(&cal->fit, sample, scale);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        cal->min[axis] = sample[axis];
+        cal->max[axis] = sample[axis];
+    }
+    cal->samples = 0;
+}
+
+static void magCalibrationAddSample(magCalibration_t *cal, const float *sample) {
+    sphereFitAddSample(&cal->fit, sample);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        cal->min[axis] = MIN(cal->min[axis], sample[axis]);
+        cal->max[axis] = MAX(cal->max[axis], sample[axis]);
+    }
+    cal->samples++;
+}
+
+// fails until the samples cover enough of the sphere on every axis
+static bool magCalibrationSolve(const magCalibration_t *cal, float *center, float *radius) {
+    if (cal->samples < MAG_CALIBRATION_MIN_SAMPLES || !sphereFitSolve(&cal->fit, center, radius)) {
+        return false;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (cal->max[axis] - cal->min[axis] < MAG_CALIBRATION_AXIS_COVERAGE * *radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void magInflightRefine(flightDynamicsTrims_t *magZero, const float *sample) {
+    if (!ARMING_FLAG(ARMED)) {
+        magInflightCalibration.samples = 0;
+        return;
+    }
+    if (magInflightCalibration.samples == 0) {
+        magCalibrationStart(&magInflightCalibration, sample);
+    }
+    magCalibrationAddSample(&magInflightCalibration, sample);
+    if (magInflightCalibration.samples < MAG_INFLIGHT_WINDOW_SAMPLES) {
+        return;
+    }
+    float center[XYZ_AXIS_COUNT];
+    float radius;
+    if (magCalibrationSolve(&magInflightCalibration, center, &radius)) {
+        float shift = 0.0f;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            shift += sq(center[axis] - magZero->raw[axis]);
+        }
+        if (sqrtf(shift) < MAG_INFLIGHT_MAX_SHIFT * radius) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                magZero->raw[axis] = lrintf(center[axis]);
+            }
+        }
+    }
+    magInflightCalibration.samples = 0;
 }
 
 #if defined(USE_MAG)
@@ -262,8 +340,6 @@ bool compassIsHealthy(quaternion *q) {
 
 void compassUpdate(timeUs_t currentTimeUs) {
     static timeUs_t tCal = 0;
-    static flightDynamicsTrims_t magZeroTempMin;
-    static flightDynamicsTrims_t magZeroTempMax;
     magDev.read(&magDev, magADCRaw);
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         mag.magADC[axis] = magADCRaw[axis];
@@ -274,32 +350,36 @@ void compassUpdate(timeUs_t currentTimeUs) {
         tCal = currentTimeUs;
         for (int axis = 0; axis < 3; axis++) {
             magZero->raw[axis] = 0;
-            magZeroTempMin.raw[axis] = mag.magADC[axis];
-            magZeroTempMax.raw[axis] = mag.magADC[axis];
         }
+        magCalibrationStart(&magCalibration, mag.magADC);
         DISABLE_STATE(CALIBRATE_MAG);
     }
-    if (magInit) {              // we apply offset only once mag calibration is done
-        mag.magADC[X] -= magZero->raw[X];
-        mag.magADC[Y] -= magZero->raw[Y];
-        mag.magADC[Z] -= magZero->raw[Z];
-    }
     if (tCal != 0) {
-        if ((currentTimeUs - tCal) < 30000000) {    // 30s: you have 30s to turn the multi in all directions
-            LED0_TOGGLE;
-            for (int axis = 0; axis < 3; axis++) {
-                if (mag.magADC[axis] < magZeroTempMin.raw[axis])
-                    magZeroTempMin.raw[axis] = mag.magADC[axis];
-                if (mag.magADC[axis] > magZeroTempMax.raw[axis])
-                    magZeroTempMax.raw[axis] = mag.magADC[axis];
-            }
-        } else {
+        LED0_TOGGLE;
+        magCalibrationAddSample(&magCalibration, mag.magADC);
+        float center[XYZ_AXIS_COUNT];
+        float radius;
+        const bool fitted = magCalibrationSolve(&magCalibration, center, &radius);
+        if (fitted || (currentTimeUs - tCal) >= MAG_CALIBRATION_TIME_US) {
             tCal = 0;
+            if (!fitted) {
+                // too little of the sphere was seen to trust the fit, fall back to min/max
+                for (int axis = 0; axis < 3; axis++) {
+                    center[axis] = (magCalibration.min[axis] + magCalibration.max[axis]) / 2; // Calculate offsets
+                }
+            }
             for (int axis = 0; axis < 3; axis++) {
-                magZero->raw[axis] = (magZeroTempMin.raw[axis] + magZeroTempMax.raw[axis]) / 2; // Calculate offsets
+                magZero->raw[axis] = lrintf(center[axis]);
             }
             saveConfigAndNotify();
         }
+    } else if (compassConfig()->mag_calibration_inflight) {
+        magInflightRefine(magZero, mag.magADC);
+    }
+    if (magInit) {              // we apply offset only once mag calibration is done
+        mag.magADC[X] -= magZero->raw[X];
+        mag.magADC[Y] -= magZero->raw[Y];
+        mag.magADC[Z] -= magZero->raw[Z];
     }
 }
 
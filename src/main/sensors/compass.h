@@ -57,6 +57,7 @@ typedef struct compassConfig_s {
     ioTag_t mag_spi_csn;
     ioTag_t interruptTag;
     flightDynamicsTrims_t magZero;
+    uint8_t mag_calibration_inflight;       // refine magZero from sphere fits while armed, not saved
 } compassConfig_t;
 
 PG_DECLARE(compassConfig_t, compassConfig);
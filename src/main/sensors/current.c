@@ -158,6 +158,15 @@ void currentMeterADCRead(currentMeter_t *meter) {
     DEBUG_SET(DEBUG_CURRENT, 3, meter->mAhDrawn);
 }
 
+// converts the ADC as of its last scan on demand, for callers that want the current every loop
+int32_t currentMeterADCSample(void) {
+#ifdef USE_ADC
+    return currentMeterADCToCentiamps(adcGetChannel(ADC_CURRENT));
+#else
+    return 0;
+#endif
+}
+
 //
 // VIRTUAL
 //
@@ -121,6 +121,7 @@ void currentMeterReset(currentMeter_t *meter);
 void currentMeterADCInit(void);
 void currentMeterADCRefresh(int32_t lastUpdateAt);
 void currentMeterADCRead(currentMeter_t *meter);
+int32_t currentMeterADCSample(void);
 
 void currentMeterVirtualInit(void);
 void currentMeterVirtualRefresh(int32_t lastUpdateAt, bool armed, bool throttleLowAndMotorStop, int32_t throttleOffset);
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "platform.h"
 
@@ -64,6 +65,10 @@ Byte 7: Rpm high byte
 Byte 8: Rpm low byte
 Byte 9: 8-bit CRC
 
+
+With dshot_edt the ESCs send temperature, voltage and current as extended telemetry frames between the
+bidirectional DShot eRPM frames instead, no uart is opened and the consumption is integrated from the current.
+
 */
 
 PG_REGISTER_WITH_RESET_TEMPLATE(escSensorConfig_t, escSensorConfig, PG_ESC_SENSOR_CONFIG, 0);
@@ -106,9 +111,9 @@ typedef enum {
 #define TELEMETRY_FRAME_SIZE 10
 static uint8_t telemetryBuffer[TELEMETRY_FRAME_SIZE] = { 0, };
 
-static volatile uint8_t *buffer;
-static volatile uint8_t bufferSize = 0;
-static volatile uint8_t bufferPosition = 0;
+static uint8_t *buffer;
+static uint8_t bufferSize = 0;
+static uint8_t bufferPosition = 0;
 
 static serialPort_t *escSensorPort = NULL;
 
@@ -117,6 +122,7 @@ static escSensorData_t escSensorData[MAX_SUPPORTED_MOTORS];
 static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
 static uint32_t escTriggerTimestamp;
 static uint8_t escSensorMotor = 0;      // motor index
+static timeUs_t escSensorUpdatedAtUs[MAX_SUPPORTED_MOTORS];
 
 static escSensorData_t combinedEscSensorData;
 static bool combinedDataNeedsUpdate = true;
@@ -124,24 +130,61 @@ static bool combinedDataNeedsUpdate = true;
 static uint16_t totalTimeoutCount = 0;
 static uint16_t totalCrcErrorCount = 0;
 
+#ifdef USE_DSHOT_TELEMETRY
+static bool escSensorEdtActive = false;
+static bool escSensorEdtRequested = false;
+static timeUs_t escSensorEdtLastUs;
+static float escSensorEdtConsumption[MAX_SUPPORTED_MOTORS]; // mAh
+#endif
+
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength) {
+    // bytes left over from an earlier reply must not end up in the new frame
+    while (escSensorPort && serialRxBytesWaiting(escSensorPort)) {
+        serialRead(escSensorPort);
+    }
     buffer = frameBuffer;
     bufferPosition = 0;
     bufferSize = frameLength;
 }
 
+static void collectEscDataBytes(void) {
+    if (!escSensorPort) {
+        return;
+    }
+    while (bufferPosition < bufferSize && serialRxBytesWaiting(escSensorPort)) {
+        buffer[bufferPosition++] = serialRead(escSensorPort);
+    }
+}
+
 uint8_t getNumberEscBytesRead(void) {
+    collectEscDataBytes();
     return bufferPosition;
 }
 
 static bool isFrameComplete(void) {
+    collectEscDataBytes();
     return bufferPosition == bufferSize;
 }
 
 bool isEscSensorActive(void) {
+#ifdef USE_DSHOT_TELEMETRY
+    if (escSensorEdtActive) {
+        return true;
+    }
+#endif
     return escSensorPort != NULL;
 }
 
+// Whether the configuration takes the esc data from extended DShot telemetry rather than a uart
+bool escSensorUseDshotEdt(void) {
+#ifdef USE_DSHOT_TELEMETRY
+    return motorConfig()->dev.motorPwmProtocol >= PWM_TYPE_DSHOT150
+           && motorConfig()->dev.useDshotTelemetry && motorConfig()->dev.useDshotEdt;
+#else
+    return false;
+#endif
+}
+
 escSensorData_t *getEscSensorData(uint8_t motorNumber) {
     if (!feature(FEATURE_ESC_SENSOR)) {
         return NULL;
@@ -175,28 +218,25 @@ escSensorData_t *getEscSensorData(uint8_t motorNumber) {
     }
 }
 
-// Receive ISR callback
-static void escSensorDataReceive(uint16_t c, void *data) {
-    UNUSED(data);
-    // KISS ESC sends some data during startup, ignore this for now (maybe future use)
-    // startup data could be firmware version and serialnumber
-    if (isFrameComplete()) {
-        return;
-    }
-    buffer[bufferPosition++] = (uint8_t)c;
-}
-
 bool escSensorInit(void) {
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
+        escSensorData[i].dataAge = ESC_DATA_INVALID;
+    }
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotEdt) {
+        escSensorEdtActive = true;
+        return true;
+    }
+#endif
     serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
     if (!portConfig) {
         return false;
     }
     portOptions_e options = SERIAL_NOT_INVERTED  | (escSensorConfig()->halfDuplex ? SERIAL_BIDIR : 0);
-    // Initialize serial port
-    escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorDataReceive, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
-    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
-        escSensorData[i].dataAge = ESC_DATA_INVALID;
-    }
+    // No rx callback, the uart collects the replies into its rx buffer by DMA where the port has a stream
+    // assigned and frames are picked up in task context. KISS ESCs send some data during startup,
+    // it is flushed when the first frame is requested
+    escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, NULL, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
     return escSensorPort != NULL;
 }
 
@@ -217,7 +257,7 @@ uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen) {
     return crc;
 }
 
-static uint8_t decodeEscFrame(void) {
+static uint8_t decodeEscFrame(timeUs_t currentTimeUs) {
     if (!isFrameComplete()) {
         return ESC_SENSOR_FRAME_PENDING;
     }
@@ -227,6 +267,7 @@ static uint8_t decodeEscFrame(void) {
     uint8_t frameStatus;
     if (chksum == tlmsum) {
         escSensorData[escSensorMotor].dataAge = 0;
+        escSensorUpdatedAtUs[escSensorMotor] = currentTimeUs;
         escSensorData[escSensorMotor].temperature = telemetryBuffer[0];
         escSensorData[escSensorMotor].voltage = telemetryBuffer[1] << 8 | telemetryBuffer[2];
         escSensorData[escSensorMotor].current = telemetryBuffer[3] << 8 | telemetryBuffer[4];
@@ -256,8 +297,78 @@ static void selectNextMotor(void) {
     }
 }
 
+static void requestEscData(timeMs_t currentTimeMs) {
+    escTriggerTimestamp = currentTimeMs;
+    startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
+    motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
+    motor->requestTelemetry = true;
+    escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
+    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
+}
+
+// Time since the last valid frame of a motor, UINT32_MAX when there is none
+uint32_t getEscSensorDataAgeUs(uint8_t motorNumber, timeUs_t currentTimeUs) {
+    if (motorNumber >= getMotorCount() || escSensorData[motorNumber].dataAge == ESC_DATA_INVALID) {
+        return UINT32_MAX;
+    }
+    return cmpTimeUs(currentTimeUs, escSensorUpdatedAtUs[motorNumber]);
+}
+
+#ifdef USE_DSHOT_TELEMETRY
+static void escSensorProcessEdt(timeUs_t currentTimeUs) {
+    if (!escSensorEdtRequested) {
+        // the ESCs only listen once they are through their startup
+        if (currentTimeUs / 1000 >= ESC_BOOTTIME) {
+            pwmWriteDshotCommand(ALL_MOTORS, getMotorCount(), DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE, false);
+            escSensorEdtRequested = true;
+            escSensorEdtLastUs = currentTimeUs;
+        }
+        return;
+    }
+    const float hours = cmpTimeUs(currentTimeUs, escSensorEdtLastUs) / (3600.0f * 1000000.0f);
+    escSensorEdtLastUs = currentTimeUs;
+    for (int i = 0; i < getMotorCount(); i++) {
+        motorDmaOutput_t *const motor = getMotorDmaOutput(i);
+        escSensorData_t *const escData = &escSensorData[i];
+        const uint8_t updated = motor->dshotEdtUpdated;
+        motor->dshotEdtUpdated &= ~updated;
+        if (updated) {
+            escSensorUpdatedAtUs[i] = currentTimeUs;
+        }
+        if (updated & (1 << DSHOT_EDT_TEMPERATURE)) {
+            escData->temperature = motor->dshotEdtValue[DSHOT_EDT_TEMPERATURE];
+            DEBUG_SET(DEBUG_ESC_SENSOR_TMP, i, escData->temperature);
+        }
+        if (updated & (1 << DSHOT_EDT_VOLTAGE)) {
+            escData->voltage = motor->dshotEdtValue[DSHOT_EDT_VOLTAGE] * 25;
+        }
+        if (updated & (1 << DSHOT_EDT_CURRENT)) {
+            escData->current = motor->dshotEdtValue[DSHOT_EDT_CURRENT] * 100;
+        }
+        if (escData->dataAge == ESC_DATA_INVALID && !updated) {
+            continue;
+        }
+        // same unit as the KISS frame, eRPM / 100
+        escData->rpm = getDshotTelemetry(i);
+        escSensorEdtConsumption[i] += escData->current * 10 * hours;
+        escData->consumption = lrintf(escSensorEdtConsumption[i]);
+        // one step per missed request period, like the uart polling would count it
+        escData->dataAge = MIN(cmpTimeUs(currentTimeUs, escSensorUpdatedAtUs[i]) / (ESC_REQUEST_TIMEOUT * 1000), ESC_DATA_INVALID - 1);
+    }
+    combinedDataNeedsUpdate = true;
+}
+#endif
+
 void escSensorProcess(timeUs_t currentTimeUs) {
     const timeMs_t currentTimeMs = currentTimeUs / 1000;
+#ifdef USE_DSHOT_TELEMETRY
+    if (escSensorEdtActive) {
+        if (pwmAreMotorsEnabled()) {
+            escSensorProcessEdt(currentTimeUs);
+        }
+        return;
+    }
+#endif
     if (!escSensorPort || !pwmAreMotorsEnabled()) {
         return;
     }
@@ -269,37 +380,29 @@ void escSensorProcess(timeUs_t currentTimeUs) {
         }
         break;
     case ESC_SENSOR_TRIGGER_READY:
-        escTriggerTimestamp = currentTimeMs;
-        startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
-        motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
-        motor->requestTelemetry = true;
-        escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
-        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
+        requestEscData(currentTimeMs);
         break;
     case ESC_SENSOR_TRIGGER_PENDING:
         if (currentTimeMs < escTriggerTimestamp + ESC_REQUEST_TIMEOUT) {
-            uint8_t state = decodeEscFrame();
+            uint8_t state = decodeEscFrame(currentTimeUs);
             switch (state) {
             case ESC_SENSOR_FRAME_COMPLETE:
-                selectNextMotor();
-                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
                 break;
             case ESC_SENSOR_FRAME_FAILED:
                 increaseDataAge();
-                selectNextMotor();
-                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
                 DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
                 break;
             case ESC_SENSOR_FRAME_PENDING:
-                break;
+                return;
             }
         } else {
             // Move on to next ESC, we'll come back to this one
             increaseDataAge();
-            selectNextMotor();
-            escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
             DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
         }
+        // the line is free again, request the next motor right away instead of idling a task period
+        selectNextMotor();
+        requestEscData(currentTimeMs);
         break;
     }
 }
@@ -43,12 +43,17 @@ typedef struct {
 
 #define ESC_BATTERY_AGE_MAX 10
 
+#define ESC_SENSOR_EDT_TASK_RATE_HZ 50  // the ESCs send each extended telemetry value a few times per second
+
 bool escSensorInit(void);
+bool isEscSensorActive(void);
+bool escSensorUseDshotEdt(void);
 void escSensorProcess(timeUs_t currentTime);
 
 #define ESC_SENSOR_COMBINED 255
 
 escSensorData_t *getEscSensorData(uint8_t motorNumber);
+uint32_t getEscSensorDataAgeUs(uint8_t motorNumber, timeUs_t currentTimeUs);
 
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength);
 uint8_t getNumberEscBytesRead(void);
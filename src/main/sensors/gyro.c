@@ -26,11 +26,15 @@
 
 #include "platform.h"
 
+#include "build/atomic.h"
+#include "build/cycle_profile.h"
 #include "build/debug.h"
 
+#include "common/accumulator.h"
 #include "common/axis.h"
 #include "common/maths.h"
 #include "common/filter.h"
+#include "common/ringbuffer.h"
 
 #include "config/feature.h"
 
@@ -68,6 +72,7 @@
 #include "drivers/bus_spi.h"
 #include "drivers/dma_spi.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 #include "drivers/accgyro/gyro_sync.h"
 #include "drivers/bus_spi.h"
@@ -85,12 +90,23 @@
 #include "fc/rc_controls.h"
 #include "rx/rx.h"
 
+#include "flight/rpm_filter.h"
+
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "sensors/gyroanalyse.h"
 #endif
 #include "sensors/sensors.h"
+
+#ifdef USE_GYRO_SPI_DMA
+#include "pg/flash.h"
+#include "pg/max7456.h"
+#include "pg/rx_spi.h"
+#include "pg/sdcard.h"
+#include "sensors/barometer.h"
+#include "sensors/compass.h"
+#endif
 #ifdef USE_GYRO_IMUF9001
 
 #include "drivers/accgyro/accgyro_imuf9001.h"
@@ -124,9 +140,19 @@ static FAST_RAM_ZERO_INIT int yawSpinRecoveryThreshold;
 static FAST_RAM_ZERO_INIT bool yawSpinDetected;
 #endif
 
-static FAST_RAM_ZERO_INIT float accumulatedMeasurements[XYZ_AXIS_COUNT];
+// The settings the gyro loop reads on every sample, copied out of gyroConfig and the feature mask whenever
+// the filters are set up so a sample loads them from one place. gyroInitSensorFilters() rebuilds it
+typedef struct gyroRuntime_s {
+    uint8_t dynNotchCount;
+    uint8_t checkOverflow;
+    uint8_t movementCalibrationThreshold;
+    bool dynamicFilterActive;
+} __attribute__((packed)) gyroRuntime_t;
+
+static FAST_RAM_ZERO_INIT gyroRuntime_t gyroRuntime __attribute__((aligned(4)));
+
+static FAST_RAM_ZERO_INIT accumulator_t gyroAccumulator;
 static FAST_RAM_ZERO_INIT float gyroPrevious[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT int accumulatedMeasurementCount;
 
 float FAST_RAM_ZERO_INIT vGyroStdDevModulus;
 
@@ -136,10 +162,22 @@ static FAST_RAM_ZERO_INIT int16_t gyroSensorTemperature;
 
 static bool gyroHasOverflowProtection = true;
 
+// Calibration samples are taken in blocks. A block the model moved in is dropped on its own, the
+// blocks before it are kept. It ends once the mean of the kept samples is known to within
+// GYRO_CALIBRATION_TOLERANCE_DPS, at the latest when gyro_calib_duration runs out.
+#define GYRO_CALIBRATION_BLOCK_US           50000
+#define GYRO_CALIBRATION_MIN_US             200000  // kept before it may end, so slow noise averages out
+#define GYRO_CALIBRATION_TOLERANCE_DPS      0.02f   // half width of the 95% confidence interval of the mean
+#define GYRO_CALIBRATION_SHIFT_TOLERANCES   4.0f    // a block mean this far off the kept one means the model turned
+
 typedef struct gyroCalibration_s {
-    float sum[XYZ_AXIS_COUNT];
-    stdev_t var[XYZ_AXIS_COUNT];
-    int32_t cyclesRemaining;
+    float sum[XYZ_AXIS_COUNT];          // current block
+    stdev_t var[XYZ_AXIS_COUNT];        // current block
+    float mean[XYZ_AXIS_COUNT];         // kept blocks
+    float m2[XYZ_AXIS_COUNT];           // kept blocks, sum of squared differences from the mean
+    int32_t blockSamples;
+    int32_t keptSamples;
+    int32_t cyclesRemaining;            // until gyro_calib_duration runs out, 0 once calibrated
 } gyroCalibration_t;
 
 bool firstArmingCalibrationWasStarted = false;
@@ -150,36 +188,80 @@ typedef union gyroLowpassFilter_u {
     ptnFilter_t ptnFilterState;
 } gyroLowpassFilter_t;
 
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+typedef union gyroLowpassFilterFixed_u {
+    pt1FilterFixed_t pt1FilterState;
+    biquadFilterFixed_t biquadFilterState;
+} gyroLowpassFilterFixed_t;
+#endif
+
+#ifdef USE_FILTER_RETUNE
+// coefficients of the lowpass and static notch stages, only the b/a or k members are used
+typedef struct gyroFilterCoeffs_s {
+    gyroLowpassFilter_t lowpassFilter[XYZ_AXIS_COUNT];
+#ifdef USE_GYRO_LPF2
+    gyroLowpassFilter_t lowpass2Filter[XYZ_AXIS_COUNT];
+#endif
+    biquadFilterX3_t notchFilter1;
+    biquadFilterX3_t notchFilter2;
+} gyroFilterCoeffs_t;
+#endif
+
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    timeUs_t sampleTimeUs;                   // data ready interrupt time of the sample in gyroADCRaw
+#endif
+    float alignment[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];  // sensor rotation and board alignment, see buildAlignmentMatrix()
+
+    // filter chain selected in gyroInitFilterChain(), runs when gyro debugging is off
+    void (*filterChainFn)(struct gyroSensor_s *gyroSensor);
 
     // lowpass gyro soft filter
-    filterApplyFnPtr lowpassFilterApplyFn;
+    uint8_t lowpassFilterKind;
     gyroLowpassFilter_t lowpassFilter[XYZ_AXIS_COUNT];
 
     // lowpass2 gyro soft filter
 #ifdef USE_GYRO_LPF2
-    filterApplyFnPtr lowpass2FilterApplyFn;
+    uint8_t lowpass2FilterKind;
     gyroLowpassFilter_t lowpass2Filter[XYZ_AXIS_COUNT];
 #endif
 
     // ABG filter
-    filterApplyFnPtr gyroABGFilterApplyFn;
-    alphaBetaGammaFilter_t gyroABGFilter[XYZ_AXIS_COUNT];
+    bool gyroABGFilterActive;
+    alphaBetaGammaFilterX3_t gyroABGFilter;
 
     // notch filters
-    filterApplyFnPtr notchFilter1ApplyFn;
-    biquadFilter_t notchFilter1[XYZ_AXIS_COUNT];
+    bool notchFilter1Active;
+    biquadFilterX3_t notchFilter1;
 
-    filterApplyFnPtr notchFilter2ApplyFn;
-    biquadFilter_t notchFilter2[XYZ_AXIS_COUNT];
+    bool notchFilter2Active;
+    biquadFilterX3_t notchFilter2;
 
-    filterApplyFnPtr notchFilterDynApplyFn;
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+    // quantised copies of the lowpass and static notch filters, used by filterGyroFixed()
+    float fixedScale;
+    gyroLowpassFilterFixed_t lowpassFilterFixed[XYZ_AXIS_COUNT];
+#ifdef USE_GYRO_LPF2
+    gyroLowpassFilterFixed_t lowpass2FilterFixed[XYZ_AXIS_COUNT];
+#endif
+    biquadFilterFixed_t notchFilter1Fixed[XYZ_AXIS_COUNT];
+    biquadFilterFixed_t notchFilter2Fixed[XYZ_AXIS_COUNT];
+#endif
+
+#ifdef USE_FILTER_RETUNE
+    // second set made by gyroRetuneFilters(), the gyro loop swaps it in before its next sample
+    gyroFilterCoeffs_t retuneCoeffs;
+#endif
 
     // overflow and recovery
     timeUs_t overflowTimeUs;
     bool overflowDetected;
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    float overflowTriggerRate;
+    float overflowResetRate;
+#endif
 #ifdef USE_YAW_SPIN_RECOVERY
     timeUs_t yawSpinTimeUs;
     bool yawSpinDetected;
@@ -190,6 +272,7 @@ typedef struct gyroSensor_s {
 #endif
 
 #ifdef USE_SMITH_PREDICTOR
+    bool smithPredictorActive;
     smithPredictor_t smithPredictor[XYZ_AXIS_COUNT];
 #endif // USE_SMITH_PREDICTOR
 } gyroSensor_t;
@@ -197,6 +280,21 @@ typedef struct gyroSensor_s {
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor1;
 #ifdef USE_DUAL_GYRO
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor2;
+
+typedef struct gyroFusion_s {
+    float smoothing;                                // per sample weight of the noise variance average
+    float previous[2][XYZ_AXIS_COUNT];
+    float noiseVariance[2][XYZ_AXIS_COUNT];
+    float weight2[XYZ_AXIS_COUNT];                  // share of gyro 2 in the fused sample
+} gyroFusion_t;
+
+static FAST_RAM_ZERO_INIT gyroFusion_t gyroFusion;
+static FAST_RAM_ZERO_INIT bool gyroStaggerSecond;  // the next staggered read goes to gyro 2
+#endif
+
+#ifdef USE_FILTER_RETUNE
+static volatile FAST_RAM_ZERO_INIT bool gyroFilterCoeffsPending;
+static gyroConfig_t gyroFiltersConfig;  // the config the filters were set up or last retuned with
 #endif
 
 #ifdef UNIT_TEST
@@ -204,9 +302,24 @@ STATIC_UNIT_TESTED gyroSensor_t * const gyroSensorPtr = &gyroSensor1;
 STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyroSensor1.gyroDev;
 #endif
 
+typedef enum {
+    GYRO_LOWPASS_KIND_NONE = 0,
+    GYRO_LOWPASS_KIND_PT1,
+    GYRO_LOWPASS_KIND_BIQUAD,
+    GYRO_LOWPASS_KIND_PT2,
+    GYRO_LOWPASS_KIND_PT3,
+    GYRO_LOWPASS_KIND_PT4,
+} gyroLowpassKind_e;
+
 static void gyroInitSensorFilters(gyroSensor_t *gyroSensor);
+static void gyroInitFilterChain(gyroSensor_t *gyroSensor);
 static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type);
 
+#ifdef USE_DYN_LPF
+// the first lowpass follows the dynamic lowpass schedule instead of gyro_lowpass_hz
+static FAST_RAM_ZERO_INIT bool dynLpfGyroActive;
+#endif
+
 #define DEBUG_GYRO_CALIBRATION 3
 
 #ifdef STM32F10X
@@ -221,7 +334,7 @@ static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int typ
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 6);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 9);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -258,6 +371,7 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
                   .dyn_notch_count = 3, // default of 3 is similar to the matrix filter.
                   .dyn_notch_min_hz = 150,
                   .dyn_notch_max_hz = 600,
+                  .dyn_notch_task = false,
                   .imuf_mode = GTBCM_GYRO_ACC_FILTER_F,
                   .imuf_rate = IMUF_RATE_16K,
                   .imuf_roll_q = 6000,
@@ -273,10 +387,11 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
                   .gyro_ABG_alpha = 0,
                   .gyro_ABG_boost = 275,
                   .gyro_ABG_half_life = 50,
-                  .smithPredictorEnabled = true,
+                  .smithPredictorEnabled = false,
                   .smithPredictorStrength = 50,
                   .smithPredictorDelay = 40,
                   .smithPredictorFilterHz = 5,
+                  .gyro_fifo_batch = 1,
                  );
 #else //USE_GYRO_IMUF9001
 PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
@@ -314,13 +429,15 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
                   .dyn_notch_count = 3, // default of 3 is similar to the matrix filter.
                   .dyn_notch_min_hz = 150,
                   .dyn_notch_max_hz = 600,
+                  .dyn_notch_task = false,
                   .gyro_ABG_alpha = 0,
                   .gyro_ABG_boost = 275,
                   .gyro_ABG_half_life = 50,
-                  .smithPredictorEnabled = true,
+                  .smithPredictorEnabled = false,
                   .smithPredictorStrength = 50,
                   .smithPredictorDelay = 40,
                   .smithPredictorFilterHz = 5,
+                  .gyro_fifo_batch = 1,
                  );
 #endif //USE_GYRO_IMUF9001
 
@@ -337,6 +454,28 @@ const busDevice_t *gyroSensorBus(void) {
 #endif
 }
 
+// The gyro interrupt wakes the MCU for every sample, so it is safe to wait for an interrupt between the loops
+bool gyroHasDataReadyInterrupt(void) {
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.gyroDev.dataReadyInterrupt;
+    }
+#endif
+    return gyroSensor1.gyroDev.dataReadyInterrupt;
+}
+
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+// When the sample the loop last read was taken, 0 when the gyro has no data ready interrupt
+timeUs_t gyroSampleTimeUs(void) {
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.sampleTimeUs;
+    }
+#endif
+    return gyroSensor1.sampleTimeUs;
+}
+#endif
+
 #ifdef USE_GYRO_REGISTER_DUMP
 const busDevice_t *gyroSensorBusByDevice(uint8_t whichSensor) {
 #ifdef USE_DUAL_GYRO
@@ -364,6 +503,57 @@ const mpuConfiguration_t *gyroMpuConfiguration(void) {
 #endif
 }
 
+#ifdef USE_GYRO_CAPTURE
+static gyroSensor_t *gyroCaptureSensor;
+static ringBuffer_t * volatile gyroCaptureRing;
+static volatile uint32_t gyroCaptureDroppedSamples;
+
+// Start handing every calibrated and aligned, but unfiltered, sample of the gyro in use to the ring
+void gyroCaptureStart(ringBuffer_t *ring) {
+#ifdef USE_DUAL_GYRO
+    gyroCaptureSensor = (gyroToUse == GYRO_CONFIG_USE_GYRO_2) ? &gyroSensor2 : &gyroSensor1;
+#else
+    gyroCaptureSensor = &gyroSensor1;
+#endif
+    gyroCaptureDroppedSamples = 0;
+    gyroCaptureRing = ring;
+}
+
+void gyroCaptureStop(void) {
+    gyroCaptureRing = NULL;
+}
+
+// Samples that didn't fit in the ring since the capture started
+uint32_t gyroCaptureDropped(void) {
+    return gyroCaptureDroppedSamples;
+}
+
+// Scale from the captured values to deg/s
+float gyroCaptureScale(void) {
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.gyroDev.scale;
+    }
+#endif
+    return gyroSensor1.gyroDev.scale;
+}
+
+static FAST_CODE void gyroCaptureSample(const gyroSensor_t *gyroSensor) {
+    ringBuffer_t *ring = gyroCaptureRing;
+    if (!ring || gyroSensor != gyroCaptureSensor) {
+        return;
+    }
+    const int16_t sample[XYZ_AXIS_COUNT] = {
+        constrain(lrintf(gyroSensor->gyroDev.gyroADC[X]), INT16_MIN, INT16_MAX),
+        constrain(lrintf(gyroSensor->gyroDev.gyroADC[Y]), INT16_MIN, INT16_MAX),
+        constrain(lrintf(gyroSensor->gyroDev.gyroADC[Z]), INT16_MIN, INT16_MAX),
+    };
+    if (!ringBufferWrite(ring, sample, sizeof(sample))) {
+        gyroCaptureDroppedSamples++;
+    }
+}
+#endif
+
 const mpuDetectionResult_t *gyroMpuDetectionResult(void) {
 #ifdef USE_DUAL_GYRO
     if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
@@ -606,12 +796,32 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor) {
     gyro.targetLooptime = gyroSetSampleRate(&gyroSensor->gyroDev, gyroConfig()->gyro_hardware_lpf, gyroConfig()->gyro_sync_denom, gyroConfig()->gyro_use_32khz);
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
     gyroSensor->gyroDev.hardware_32khz_lpf = gyroConfig()->gyro_32khz_hardware_lpf;
+#ifdef USE_GYRO_FIFO_BATCH
+    // filters keep running at the sensor sample rate, only the gyro task is slowed down by the batch size
+    switch (gyroHardware) {
+#ifndef USE_DMA_SPI_DEVICE
+    case GYRO_ICM42605:
+    case GYRO_ICM42688P:
+    case GYRO_BMI270:
+        gyroSensor->gyroDev.fifoBatchSize = constrain(gyroConfig()->gyro_fifo_batch, 1, GYRO_FIFO_BATCH_MAX);
+        break;
+#endif
+    default:
+        gyroSensor->gyroDev.fifoBatchSize = 1;
+        break;
+    }
+#endif
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
 #ifndef USE_GYRO_IMUF9001
     if (gyroConfig()->gyro_align != ALIGN_DEFAULT) {
         gyroSensor->gyroDev.gyroAlign = gyroConfig()->gyro_align;
     }
 #endif //!USE_GYRO_IMUF9001
+    buildAlignmentMatrix(gyroSensor->gyroDev.gyroAlign, gyroSensor->alignment);
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    gyroSensor->overflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyroSensor->gyroDev.scale;
+    gyroSensor->overflowResetRate = GYRO_OVERFLOW_RESET_THRESHOLD * gyroSensor->gyroDev.scale;
+#endif
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
     switch (gyroHardware) {
@@ -653,25 +863,27 @@ bool gyroInit(void) {
 #ifdef USE_GYRO_OVERFLOW_CHECK
     overflowAxisMask = gyroConfig()->checkOverflow;
 #endif //USE_GYRO_OVERFLOW_CHECK
-    switch (debugMode) {
-    case DEBUG_FFT:
-    case DEBUG_FFT_FREQ:
-    case DEBUG_GYRO_RAW:
-    case DEBUG_GYRO_SCALED:
-    case DEBUG_GYRO_FILTERED:
-        gyroDebugMode = debugMode;
-        break;
-    default:
-        // debugMode is not gyro-related
-        gyroDebugMode = DEBUG_NONE;
-        break;
+    // The filter chain runs its debug variant when any of the debug modes is gyro-related
+    gyroDebugMode = DEBUG_NONE;
+    for (int i = 0; i < DEBUG_MODE_SLOT_COUNT && gyroDebugMode == DEBUG_NONE; i++) {
+        switch (debugModes[i]) {
+        case DEBUG_FFT:
+        case DEBUG_FFT_FREQ:
+        case DEBUG_GYRO_RAW:
+        case DEBUG_GYRO_SCALED:
+        case DEBUG_GYRO_FILTERED:
+            gyroDebugMode = debugModes[i];
+            break;
+        default:
+            break;
+        }
     }
     firstArmingCalibrationWasStarted = false;
     bool ret = false;
     memset(&gyro, 0, sizeof(gyro));
     gyroToUse = gyroConfig()->gyro_to_use;
 #if defined(USE_DUAL_GYRO) && defined(GYRO_1_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
         gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_1_CS_PIN));
         IOInit(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(0));
         IOHi(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
@@ -679,7 +891,7 @@ bool gyroInit(void) {
     }
 #endif
 #if defined(USE_DUAL_GYRO) && defined(GYRO_2_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
         gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_2_CS_PIN));
         IOInit(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(1));
         IOHi(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
@@ -702,7 +914,7 @@ bool gyroInit(void) {
 #endif
     gyroSensor1.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor1.gyroDev.bus, GYRO_1_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
         ret = gyroInitSensor(&gyroSensor1);
         if (!ret) {
             return false; // TODO handle failure of first gyro detection better. - Perhaps update the config to use second gyro then indicate a new failure mode and reboot.
@@ -727,7 +939,7 @@ bool gyroInit(void) {
 #endif
     gyroSensor2.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor2.gyroDev.bus, GYRO_2_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
         ret = gyroInitSensor(&gyroSensor2);
         if (!ret) {
             return false; // TODO handle failure of second gyro detection better. - Perhaps update the config to use first gyro then indicate a new failure mode and reboot.
@@ -736,9 +948,12 @@ bool gyroInit(void) {
     }
 #endif // USE_DUAL_GYRO
 #ifdef USE_DUAL_GYRO
+    memset(&gyroFusion, 0, sizeof(gyroFusion));
+    // average the noise over the same window the kalman filter uses for its variance
+    gyroFusion.smoothing = 1.0f / MAX(gyroConfig()->imuf_w, 1);
     // Only allow using both gyros simultaneously if they are the same hardware type.
-    // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    // If the user selected "BOTH" or "FUSED" and they are not the same type, then reset to using only the first gyro.
+    if (GYRO_CONFIG_USES_BOTH(gyroToUse)) {
         if (gyroSensor1.gyroDev.gyroHardware != gyroSensor2.gyroDev.gyroHardware) {
             gyroToUse = GYRO_CONFIG_USE_GYRO_1;
             gyroConfigMutable()->gyro_to_use = GYRO_CONFIG_USE_GYRO_1;
@@ -746,70 +961,156 @@ bool gyroInit(void) {
             sensorsSet(SENSOR_GYRO);
         }
     }
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_STAGGERED) {
+#ifdef USE_GYRO_FIFO_BATCH
+        // a batch holds several samples of one sensor, they can't be interleaved with the other one
+        if (gyroSensor1.gyroDev.fifoBatchSize > 1) {
+            gyroToUse = GYRO_CONFIG_USE_GYRO_FUSED;
+        }
+    }
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_STAGGERED) {
+#endif
+        // the gyros are read alternately at twice the sensor rate, everything downstream runs on the
+        // interleaved stream. Rounded up so a late read skips a sample rather than repeating one
+        gyro.targetLooptime = (gyro.targetLooptime + 1) / 2;
+        gyroStaggerSecond = false;
+        gyroInitSensorFilters(&gyroSensor1);
+    }
 #endif // USE_DUAL_GYRO
     return ret;
 }
 
-void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type) {
-    filterApplyFnPtr *lowpassFilterApplyFn;
-    gyroLowpassFilter_t *lowpassFilter = NULL;
-    uint16_t lpfHz[3];
+#ifdef USE_DYN_LPF
+// a pt1 or ptn takes a new cutoff without a step in its output, a biquad keeps the static one
+static bool gyroDynLpfConfigured(const gyroConfig_t *config) {
+    return config->dyn_lpf_gyro_min_hz && config->dyn_lpf_gyro_max_hz > config->dyn_lpf_gyro_min_hz
+           && config->gyro_lowpass_type != FILTER_BIQUAD;
+}
+#endif
+
+// Cutoffs of a lowpass slot, while the dynamic lowpass is on the first one starts at its minimum
+static bool gyroLowpassCutoffs(const gyroConfig_t *config, int slot, uint16_t *lpfHz) {
     switch (slot) {
     case FILTER_LOWPASS:
-        lowpassFilterApplyFn = &gyroSensor->lowpassFilterApplyFn;
-        lowpassFilter = gyroSensor->lowpassFilter;
-        lpfHz[ROLL] = gyroConfig()->gyro_lowpass_hz[ROLL];
-        lpfHz[PITCH] = gyroConfig()->gyro_lowpass_hz[PITCH];
-        lpfHz[YAW] = gyroConfig()->gyro_lowpass_hz[YAW];
-        break;
+        lpfHz[ROLL] = config->gyro_lowpass_hz[ROLL];
+        lpfHz[PITCH] = config->gyro_lowpass_hz[PITCH];
+        lpfHz[YAW] = config->gyro_lowpass_hz[YAW];
+#ifdef USE_DYN_LPF
+        if (gyroDynLpfConfigured(config)) {
+            lpfHz[ROLL] = lpfHz[PITCH] = lpfHz[YAW] = config->dyn_lpf_gyro_min_hz;
+        }
+#endif
+        return true;
 #ifdef USE_GYRO_LPF2
     case FILTER_LOWPASS2:
-        lowpassFilterApplyFn = &gyroSensor->lowpass2FilterApplyFn;
-        lowpassFilter = gyroSensor->lowpass2Filter;
-        lpfHz[ROLL] = gyroConfig()->gyro_lowpass2_hz[ROLL];
-        lpfHz[PITCH] = gyroConfig()->gyro_lowpass2_hz[PITCH];
-        lpfHz[YAW] = gyroConfig()->gyro_lowpass2_hz[YAW];
-        break;
+        lpfHz[ROLL] = config->gyro_lowpass2_hz[ROLL];
+        lpfHz[PITCH] = config->gyro_lowpass2_hz[PITCH];
+        lpfHz[YAW] = config->gyro_lowpass2_hz[YAW];
+        return true;
 #endif
     default:
-        return;
+        return false;
     }
+}
+
+// Sets up the lowpass of the axes with a cutoff below nyquist and returns the kind of filter they got
+static uint8_t gyroInitLowpassFilters(gyroLowpassFilter_t *lowpassFilter, const uint16_t *lpfHz, int type) {
     // Establish some common constants
     const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
     const float gyroDt = gyro.targetLooptime * 1e-6f;
     // Gain could be calculated a little later as it is specific to the pt1/bqrcf2/fkf branches
-    // Dereference the pointer to null before checking valid cutoff and filter
+    // Default to no filter before checking valid cutoff and filter
     // type. It will be overridden for positive cases.
-    *lowpassFilterApplyFn = &nullFilterApply;
+    uint8_t lowpassFilterKind = GYRO_LOWPASS_KIND_NONE;
     // If lowpass cutoff has been specified and is less than the Nyquist frequency
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         float gain = pt1FilterGain(lpfHz[axis], gyroDt);
         if (lpfHz[axis] && lpfHz[axis] <= gyroFrequencyNyquist) {
             switch (type) {
             case FILTER_BIQUAD:
-                *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApply;
+                lowpassFilterKind = GYRO_LOWPASS_KIND_BIQUAD;
                 biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz[axis], gyro.targetLooptime);
                 break;
             case FILTER_PT4:
-                *lowpassFilterApplyFn = (filterApplyFnPtr) ptnFilterApply;
+                lowpassFilterKind = GYRO_LOWPASS_KIND_PT4;
                 ptnFilterInit(&lowpassFilter[axis].ptnFilterState, FILTER_PT4, lpfHz[axis], gyroDt);
                 break;
             case FILTER_PT3:
-                *lowpassFilterApplyFn = (filterApplyFnPtr) ptnFilterApply;
+                lowpassFilterKind = GYRO_LOWPASS_KIND_PT3;
                 ptnFilterInit(&lowpassFilter[axis].ptnFilterState, FILTER_PT3, lpfHz[axis], gyroDt);
                 break;
             case FILTER_PT2:
-                *lowpassFilterApplyFn = (filterApplyFnPtr) ptnFilterApply;
+                lowpassFilterKind = GYRO_LOWPASS_KIND_PT2;
                 ptnFilterInit(&lowpassFilter[axis].ptnFilterState, FILTER_PT2, lpfHz[axis], gyroDt);
                 break;
             default: // case FILTER_PT1:
-                *lowpassFilterApplyFn = (filterApplyFnPtr) pt1FilterApply;
+                lowpassFilterKind = GYRO_LOWPASS_KIND_PT1;
                 pt1FilterInit(&lowpassFilter[axis].pt1FilterState, gain);
                 break;
             }
         }
     }
+    return lowpassFilterKind;
+}
+
+void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type) {
+    uint16_t lpfHz[XYZ_AXIS_COUNT];
+    if (!gyroLowpassCutoffs(gyroConfig(), slot, lpfHz)) {
+        return;
+    }
+#ifdef USE_GYRO_LPF2
+    if (slot == FILTER_LOWPASS2) {
+        gyroSensor->lowpass2FilterKind = gyroInitLowpassFilters(gyroSensor->lowpass2Filter, lpfHz, type);
+        return;
+    }
+#endif
+    gyroSensor->lowpassFilterKind = gyroInitLowpassFilters(gyroSensor->lowpassFilter, lpfHz, type);
+#ifdef USE_DYN_LPF
+    dynLpfGyroActive = gyroDynLpfConfigured(gyroConfig()) && gyroSensor->lowpassFilterKind != GYRO_LOWPASS_KIND_NONE;
+#endif
+}
+
+#ifdef USE_DYN_LPF
+bool gyroDynLpfEnabled(void) {
+    return dynLpfGyroActive;
+}
+
+static void gyroDynLpfUpdateSensor(gyroSensor_t *gyroSensor, uint16_t cutoffHz, float gyroDt) {
+    gyroLowpassFilter_t *lowpassFilter = gyroSensor->lowpassFilter;
+    switch (gyroSensor->lowpassFilterKind) {
+    case GYRO_LOWPASS_KIND_PT1: {
+        const float k = pt1FilterGain(cutoffHz, gyroDt);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            pt1FilterUpdateCutoff(&lowpassFilter[axis].pt1FilterState, k);
+        }
+        break;
+    }
+    case GYRO_LOWPASS_KIND_PT2:
+    case GYRO_LOWPASS_KIND_PT3:
+    case GYRO_LOWPASS_KIND_PT4:
+        ptnFilterUpdateCutoff(&lowpassFilter[X].ptnFilterState, cutoffHz, gyroDt);
+        for (int axis = Y; axis < XYZ_AXIS_COUNT; axis++) {
+            lowpassFilter[axis].ptnFilterState.k = lowpassFilter[X].ptnFilterState.k;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// New cutoff for the first lowpass of both sensors, clamped to nyquist
+void gyroDynLpfUpdate(uint16_t cutoffHz) {
+    if (!dynLpfGyroActive) {
+        return;
+    }
+    const float gyroDt = gyro.targetLooptime * 1e-6f;
+    cutoffHz = MIN(cutoffHz, 1000000 / 2 / gyro.targetLooptime);
+    gyroDynLpfUpdateSensor(&gyroSensor1, cutoffHz, gyroDt);
+#ifdef USE_DUAL_GYRO
+    gyroDynLpfUpdateSensor(&gyroSensor2, cutoffHz, gyroDt);
+#endif
 }
+#endif
 
 static uint16_t calculateNyquistAdjustedNotchHz(uint16_t notchHz, uint16_t notchCutoffHz) {
     const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
@@ -831,28 +1132,15 @@ void gyroInitSlewLimiter(gyroSensor_t *gyroSensor) {
 }
 #endif
 
-static void gyroInitFilterNotch1(gyroSensor_t *gyroSensor, uint16_t notchHz, uint16_t notchCutoffHz) {
-    gyroSensor->notchFilter1ApplyFn = nullFilterApply;
-    notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
-    if (notchHz != 0 && notchCutoffHz != 0) {
-        gyroSensor->notchFilter1ApplyFn = (filterApplyFnPtr)biquadFilterApply;
-        const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter1[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-        }
-    }
-}
-
-static void gyroInitFilterNotch2(gyroSensor_t *gyroSensor, uint16_t notchHz, uint16_t notchCutoffHz) {
-    gyroSensor->notchFilter2ApplyFn = nullFilterApply;
+// Sets up a static notch and returns whether it is active
+static bool gyroInitFilterNotch(biquadFilterX3_t *notch, uint16_t notchHz, uint16_t notchCutoffHz) {
     notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
-    if (notchHz != 0 && notchCutoffHz != 0) {
-        gyroSensor->notchFilter2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
-        const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter2[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-        }
+    if (notchHz == 0 || notchCutoffHz == 0) {
+        return false;
     }
+    const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
+    biquadFilterInitX3(notch, notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+    return true;
 }
 
 #ifdef USE_GYRO_DATA_ANALYSE
@@ -861,12 +1149,11 @@ bool isDynamicFilterActive(void) {
 }
 
 static void gyroInitFilterDynamicNotch(gyroSensor_t *gyroSensor) {
-    gyroSensor->notchFilterDynApplyFn = nullFilterApply;
     if (isDynamicFilterActive()) {
-        gyroSensor->notchFilterDynApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
         for (int axis = 0; axis < gyroConfig()->dyn_notch_axis+1; axis++) {
             for (int axis2 = 0; axis2 < gyroConfig()->dyn_notch_count; axis2++) {
                 biquadFilterInit(&gyroSensor->gyroAnalyseState.notchFilterDyn[axis][axis2], 400, gyro.targetLooptime, gyroConfig()->dyn_notch_q / 100.0f, FILTER_NOTCH);
+                gyroSensor->gyroAnalyseState.notchFreqStep[axis][axis2] = 0;
             }
         }
     }
@@ -874,30 +1161,42 @@ static void gyroInitFilterDynamicNotch(gyroSensor_t *gyroSensor) {
 #endif
 
 static void gyroInitABGFilter(gyroSensor_t *gyroSensor, uint16_t alpha, uint16_t boost, uint16_t halfLife) {
-    gyroSensor->gyroABGFilterApplyFn = nullFilterApply;
+    gyroSensor->gyroABGFilterActive = alpha != 0;
     if (alpha) {
-        gyroSensor->gyroABGFilterApplyFn = (filterApplyFnPtr)alphaBetaGammaApply;
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            ABGInit(&gyroSensor->gyroABGFilter[axis], alpha, boost, halfLife, gyro.targetLooptime * 1e-6f);
-        }
+        ABGInitX3(&gyroSensor->gyroABGFilter, alpha, boost, halfLife, gyro.targetLooptime * 1e-6f);
     }
 }
 
 #ifdef USE_SMITH_PREDICTOR
-void smithPredictorInit(gyroSensor_t *gyroSensor) {
-    if (gyroConfig()->smithPredictorDelay > 1) {
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            gyroSensor->smithPredictor[axis].enabled = gyroConfig()->smithPredictorEnabled;
-            gyroSensor->smithPredictor[axis].samples = gyroConfig()->smithPredictorDelay / (gyro.targetLooptime / 100.0f);
-            gyroSensor->smithPredictor[axis].idx = 0;
-            gyroSensor->smithPredictor[axis].smithPredictorStrength = gyroConfig()->smithPredictorStrength / 100.0f;
-            pt1FilterInit(&gyroSensor->smithPredictor[axis].smithPredictorFilter, pt1FilterGain(gyroConfig()->smithPredictorFilterHz, gyro.targetLooptime * 1e-6f));
-        }
+static void smithPredictorInit(gyroSensor_t *gyroSensor) {
+    gyroSensor->smithPredictorActive = false;
+    // smith_predict_delay is in 0.1ms steps
+    const int samples = MIN(lrintf(gyroConfig()->smithPredictorDelay * 100.0f / gyro.targetLooptime), SMITH_PREDICTOR_BUFFER_SIZE - 1);
+    if (!gyroConfig()->smithPredictorEnabled || gyroConfig()->smithPredictorStrength == 0 || samples < 2) {
+        return;
     }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        smithPredictor_t *smithPredictor = &gyroSensor->smithPredictor[axis];
+        memset(smithPredictor, 0, sizeof(*smithPredictor));
+        smithPredictor->samples = samples;
+        smithPredictor->strength = gyroConfig()->smithPredictorStrength / 100.0f;
+        smithPredictor->filterK = pt1FilterGain(gyroConfig()->smithPredictorFilterHz, gyro.targetLooptime * 1e-6f);
+    }
+    gyroSensor->smithPredictorActive = true;
 }
 #endif // USE_SMITH_PREDICTOR
 
+static void gyroRuntimeUpdate(void) {
+    gyroRuntime.dynNotchCount = gyroConfig()->dyn_notch_count;
+    gyroRuntime.checkOverflow = gyroConfig()->checkOverflow;
+    gyroRuntime.movementCalibrationThreshold = gyroConfig()->gyroMovementCalibrationThreshold;
+#ifdef USE_GYRO_DATA_ANALYSE
+    gyroRuntime.dynamicFilterActive = isDynamicFilterActive();
+#endif
+}
+
 static void gyroInitSensorFilters(gyroSensor_t *gyroSensor) {
+    gyroRuntimeUpdate();
 #if defined(USE_GYRO_SLEW_LIMITER)
     gyroInitSlewLimiter(gyroSensor);
 #endif
@@ -916,8 +1215,8 @@ static void gyroInitSensorFilters(gyroSensor_t *gyroSensor) {
         gyroConfig()->gyro_lowpass2_type
     );
 #endif
-    gyroInitFilterNotch1(gyroSensor, gyroConfig()->gyro_soft_notch_hz_1, gyroConfig()->gyro_soft_notch_cutoff_1);
-    gyroInitFilterNotch2(gyroSensor, gyroConfig()->gyro_soft_notch_hz_2, gyroConfig()->gyro_soft_notch_cutoff_2);
+    gyroSensor->notchFilter1Active = gyroInitFilterNotch(&gyroSensor->notchFilter1, gyroConfig()->gyro_soft_notch_hz_1, gyroConfig()->gyro_soft_notch_cutoff_1);
+    gyroSensor->notchFilter2Active = gyroInitFilterNotch(&gyroSensor->notchFilter2, gyroConfig()->gyro_soft_notch_hz_2, gyroConfig()->gyro_soft_notch_cutoff_2);
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroInitFilterDynamicNotch(gyroSensor);
 #endif
@@ -927,6 +1226,12 @@ static void gyroInitSensorFilters(gyroSensor_t *gyroSensor) {
 #ifdef USE_SMITH_PREDICTOR
     smithPredictorInit(gyroSensor);
 #endif // USE_SMITH_PREDICTOR
+
+    gyroInitFilterChain(gyroSensor);
+#ifdef USE_FILTER_RETUNE
+    gyroFiltersConfig = *gyroConfig();
+    gyroFilterCoeffsPending = false;
+#endif
 }
 
 void gyroInitFilters(void) {
@@ -950,7 +1255,9 @@ FAST_CODE bool isGyroCalibrationComplete(void) {
     case GYRO_CONFIG_USE_GYRO_2: {
         return isGyroSensorCalibrationComplete(&gyroSensor2);
     }
-    case GYRO_CONFIG_USE_GYRO_BOTH: {
+    case GYRO_CONFIG_USE_GYRO_BOTH:
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+    case GYRO_CONFIG_USE_GYRO_STAGGERED: {
         return isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2);
     }
     }
@@ -959,25 +1266,48 @@ FAST_CODE bool isGyroCalibrationComplete(void) {
 #endif
 }
 
-static bool isOnFinalGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration) {
-    return gyroCalibration->cyclesRemaining == 1;
-}
-
 static int32_t gyroCalculateCalibratingCycles(void) {
     return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.targetLooptime;
 }
 
-static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration) {
-    return gyroCalibration->cyclesRemaining == gyroCalculateCalibratingCycles();
+static int32_t gyroCalibrationCycles(timeDelta_t durationUs) {
+    return MAX(durationUs / (timeDelta_t)gyro.targetLooptime, 2);
 }
 
 static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor) {
 #ifdef USE_GYRO_IMUF9001
     imufStartCalibration();
 #endif
+    gyroSensor->calibration.blockSamples = 0;
+    gyroSensor->calibration.keptSamples = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // gyroZero is set to zero until calibration complete
+        gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
+    }
     gyroSensor->calibration.cyclesRemaining = gyroCalculateCalibratingCycles();
 }
 
+#ifdef USE_WARM_BOOT
+void gyroGetCalibratedZero(float zero[GYRO_ZERO_COUNT][XYZ_AXIS_COUNT]) {
+    memcpy(zero[0], gyroSensor1.gyroDev.gyroZero, sizeof(zero[0]));
+#ifdef USE_DUAL_GYRO
+    memcpy(zero[1], gyroSensor2.gyroDev.gyroZero, sizeof(zero[1]));
+#else
+    memset(zero[1], 0, sizeof(zero[1]));
+#endif
+}
+
+// takes a zero kept from before a reset in place of calibrating again
+void gyroSetCalibratedZero(const float zero[GYRO_ZERO_COUNT][XYZ_AXIS_COUNT]) {
+    memcpy(gyroSensor1.gyroDev.gyroZero, zero[0], sizeof(zero[0]));
+    gyroSensor1.calibration.cyclesRemaining = 0;
+#ifdef USE_DUAL_GYRO
+    memcpy(gyroSensor2.gyroDev.gyroZero, zero[1], sizeof(zero[1]));
+    gyroSensor2.calibration.cyclesRemaining = 0;
+#endif
+}
+#endif
+
 void gyroStartCalibration(bool isFirstArmingCalibration) {
     if (!(isFirstArmingCalibration && firstArmingCalibrationWasStarted)) {
         gyroSetCalibrationCycles(&gyroSensor1);
@@ -994,56 +1324,127 @@ bool isFirstArmingGyroCalibrationRunning(void) {
     return firstArmingCalibrationWasStarted && !isGyroCalibrationComplete();
 }
 
+static float gyroCalibrationToleranceLsb(const gyroSensor_t *gyroSensor) {
+    return GYRO_CALIBRATION_TOLERANCE_DPS / gyroSensor->gyroDev.scale;
+}
+
+// drops the block if the model moved, otherwise adds it to the kept samples
+static void gyroCalibrationEndBlock(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold) {
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    const int32_t blockSamples = calibration->blockSamples;
+    const float shiftLimit = GYRO_CALIBRATION_SHIFT_TOLERANCES * gyroCalibrationToleranceLsb(gyroSensor);
+    bool shifted = false;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float stddev = devStandardDeviation(&calibration->var[axis]);
+        // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
+        // into the spare field - debug[3], in DEBUG_GYRO_RAW
+        if (axis == X) {
+            DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
+        }
+        // the model was moved during this block, keep what was collected before it
+        if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
+            return;
+        }
+        if (calibration->keptSamples && fabsf(calibration->sum[axis] / blockSamples - calibration->mean[axis]) > shiftLimit) {
+            shifted = true;
+        }
+    }
+    // a steady turn doesn't show in the deviation, only in a mean that moved away from the kept one.
+    // Either the kept blocks or this one were taken turning, start over from here
+    if (shifted) {
+        calibration->keptSamples = 0;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float blockMean = calibration->sum[axis] / blockSamples;
+        const float blockM2 = devVariance(&calibration->var[axis]) * (blockSamples - 1);
+        if (calibration->keptSamples) {
+            // merge the block statistics into the kept ones
+            const float total = calibration->keptSamples + blockSamples;
+            const float delta = blockMean - calibration->mean[axis];
+            calibration->mean[axis] += delta * blockSamples / total;
+            calibration->m2[axis] += blockM2 + delta * delta * calibration->keptSamples * blockSamples / total;
+        } else {
+            calibration->mean[axis] = blockMean;
+            calibration->m2[axis] = blockM2;
+        }
+    }
+    calibration->keptSamples += blockSamples;
+}
+
+static bool gyroCalibrationConverged(const gyroSensor_t *gyroSensor) {
+    const gyroCalibration_t *calibration = &gyroSensor->calibration;
+    if (calibration->keptSamples < gyroCalibrationCycles(GYRO_CALIBRATION_MIN_US)) {
+        return false;
+    }
+    const float toleranceLsb = gyroCalibrationToleranceLsb(gyroSensor);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float variance = calibration->m2[axis] / (calibration->keptSamples - 1);
+        // 1.96 standard errors of the mean within tolerance, squared
+        if (3.8416f * variance > sq(toleranceLsb) * calibration->keptSamples) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void gyroCalibrationComplete(gyroSensor_t *gyroSensor) {
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // please take care with exotic boardalignment !!
+        gyroSensor->gyroDev.gyroZero[axis] = calibration->mean[axis];
+    }
+    gyroSensor->gyroDev.gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+    calibration->cyclesRemaining = 0;
+    schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
+    if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
+        // calculate gyro noise standard deviation modulus
+        static quaternion vStdDev = VECTOR_INITIALIZE;
+        vStdDev.x = sqrtf(calibration->m2[X] / (calibration->keptSamples - 1));
+        vStdDev.y = sqrtf(calibration->m2[Y] / (calibration->keptSamples - 1));
+        vStdDev.z = sqrtf(calibration->m2[Z] / (calibration->keptSamples - 1));
+        vGyroStdDevModulus = quaternionModulus(&vStdDev) / 1000.0f;
+        beeper(BEEPER_GYRO_CALIBRATED);
+    }
+}
+
 STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold) {
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    if (calibration->cyclesRemaining <= 0) {
+        return;
+    }
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        // Reset g[axis] at start of calibration
-        if (isOnFirstGyroCalibrationCycle(&gyroSensor->calibration)) {
-            gyroSensor->calibration.sum[axis] = 0.0f;
-            devClear(&gyroSensor->calibration.var[axis]);
-            // gyroZero is set to zero until calibration complete
-            gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
+        if (calibration->blockSamples == 0) {
+            calibration->sum[axis] = 0.0f;
+            devClear(&calibration->var[axis]);
         }
-        // Sum up CALIBRATING_GYRO_TIME_US readings
-        gyroSensor->calibration.sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
-        devPush(&gyroSensor->calibration.var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
-        if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-            const float stddev = devStandardDeviation(&gyroSensor->calibration.var[axis]);
-            // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
-            // into the spare field - debug[3], in DEBUG_GYRO_RAW
-            if (axis == X) {
-                DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
-            }
-            // check deviation and startover in case the model was moved
-            if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
-                gyroSetCalibrationCycles(gyroSensor);
-                return;
-            }
-            // please take care with exotic boardalignment !!
-            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroCalculateCalibratingCycles();
-            if (axis == Z) {
-                gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
-            }
+        calibration->sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
+        devPush(&calibration->var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+    }
+    calibration->blockSamples++;
+    --calibration->cyclesRemaining;
+    if (calibration->blockSamples >= gyroCalibrationCycles(GYRO_CALIBRATION_BLOCK_US)) {
+        gyroCalibrationEndBlock(gyroSensor, gyroMovementCalibrationThreshold);
+        calibration->blockSamples = 0;
+        if (gyroCalibrationConverged(gyroSensor)) {
+            gyroCalibrationComplete(gyroSensor);
+            return;
         }
     }
-    if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-        schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
-        if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
-            // calculate gyro noise standard deviation modulus
-            static quaternion vStdDev = VECTOR_INITIALIZE;
-            vStdDev.x =  devStandardDeviation(&gyroSensor->calibration.var[X]);
-            vStdDev.y =  devStandardDeviation(&gyroSensor->calibration.var[Y]);
-            vStdDev.z =  devStandardDeviation(&gyroSensor->calibration.var[Z]);
-            vGyroStdDevModulus =  quaternionModulus(&vStdDev) / 1000.0f;
-            beeper(BEEPER_GYRO_CALIBRATED);
+    if (calibration->cyclesRemaining <= 0) {
+        // out of time, a noisy gyro keeps what the fixed length calibration would have given it
+        if (calibration->keptSamples >= gyroCalibrationCycles(GYRO_CALIBRATION_MIN_US)) {
+            gyroCalibrationComplete(gyroSensor);
+        } else {
+            // the model kept moving, start over
+            gyroSetCalibrationCycles(gyroSensor);
         }
     }
-    --gyroSensor->calibration.cyclesRemaining;
 }
 
 #if defined(USE_GYRO_SLEW_LIMITER)
 FAST_CODE_NOINLINE int32_t gyroSlewLimiter(gyroSensor_t *gyroSensor, int axis) {
     int32_t ret = (int32_t)gyroSensor->gyroDev.gyroADCRaw[axis];
-    if (gyroConfig()->checkOverflow || gyroHasOverflowProtection) {
+    if (gyroRuntime.checkOverflow || gyroHasOverflowProtection) {
         // don't use the slew limiter if overflow checking is on or gyro is not subject to overflow bug
         return ret;
     }
@@ -1058,43 +1459,31 @@ FAST_CODE_NOINLINE int32_t gyroSlewLimiter(gyroSensor_t *gyroSensor, int axis) {
 #endif
 
 #ifdef USE_GYRO_OVERFLOW_CHECK
-static FAST_CODE_NOINLINE void handleOverflow(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs) {
-    const float gyroOverflowResetRate = GYRO_OVERFLOW_RESET_THRESHOLD * gyroSensor->gyroDev.scale;
-    if ((fabsf(gyroSensor->gyroDev.gyroADCf[X]) < gyroOverflowResetRate)
-            && (fabsf(gyroSensor->gyroDev.gyroADCf[Y]) < gyroOverflowResetRate)
-            && (fabsf(gyroSensor->gyroDev.gyroADCf[Z]) < gyroOverflowResetRate)) {
-        // if we have 50ms of consecutive OK gyro vales, then assume yaw readings are OK again and reset overflowDetected
-        // reset requires good OK values on all axes
-        if (cmpTimeUs(currentTimeUs, gyroSensor->overflowTimeUs) > 50000) {
-            gyroSensor->overflowDetected = false;
-        }
-    } else {
-        // not a consecutive OK value, so reset the overflow time
-        gyroSensor->overflowTimeUs = currentTimeUs;
-    }
-}
-
-static FAST_CODE void checkForOverflow(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs) {
+static FAST_CODE void checkForOverflow(gyroSensor_t *gyroSensor, const float absRate[XYZ_AXIS_COUNT], float maxAbsRate, timeUs_t currentTimeUs) {
     // check for overflow to handle Yaw Spin To The Moon (YSTTM)
     // ICM gyros are specified to +/- 2000 deg/sec, in a crash they can go out of spec.
     // This can cause an overflow and sign reversal in the output.
     // Overflow and sign reversal seems to result in a gyro value of +1996 or -1996.
     if (gyroSensor->overflowDetected) {
-        handleOverflow(gyroSensor, currentTimeUs);
+        if (maxAbsRate < gyroSensor->overflowResetRate) {
+            // if we have 50ms of consecutive OK gyro vales, then assume yaw readings are OK again and reset overflowDetected
+            // reset requires good OK values on all axes
+            if (cmpTimeUs(currentTimeUs, gyroSensor->overflowTimeUs) > 50000) {
+                gyroSensor->overflowDetected = false;
+            }
+        } else {
+            // not a consecutive OK value, so reset the overflow time
+            gyroSensor->overflowTimeUs = currentTimeUs;
+        }
     } else {
 #ifndef SIMULATOR_BUILD
-        // check for overflow in the axes set in overflowAxisMask
-        gyroOverflow_e overflowCheck = GYRO_OVERFLOW_NONE;
-        const float gyroOverflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyroSensor->gyroDev.scale;
-        if (fabsf(gyroSensor->gyroDev.gyroADCf[X]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_X;
-        }
-        if (fabsf(gyroSensor->gyroDev.gyroADCf[Y]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Y;
-        }
-        if (fabsf(gyroSensor->gyroDev.gyroADCf[Z]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Z;
+        if (maxAbsRate <= gyroSensor->overflowTriggerRate) {
+            return;
         }
+        // check for overflow in the axes set in overflowAxisMask
+        const uint8_t overflowCheck = (absRate[X] > gyroSensor->overflowTriggerRate ? GYRO_OVERFLOW_X : 0)
+            | (absRate[Y] > gyroSensor->overflowTriggerRate ? GYRO_OVERFLOW_Y : 0)
+            | (absRate[Z] > gyroSensor->overflowTriggerRate ? GYRO_OVERFLOW_Z : 0);
         if (overflowCheck & overflowAxisMask) {
             gyroSensor->overflowDetected = true;
             gyroSensor->overflowTimeUs = currentTimeUs;
@@ -1102,26 +1491,15 @@ static FAST_CODE void checkForOverflow(gyroSensor_t *gyroSensor, timeUs_t curren
             gyroSensor->yawSpinDetected = false;
 #endif // USE_YAW_SPIN_RECOVERY
         }
+#else
+        UNUSED(absRate);
 #endif // SIMULATOR_BUILD
     }
 }
 #endif // USE_GYRO_OVERFLOW_CHECK
 
 #ifdef USE_YAW_SPIN_RECOVERY
-static FAST_CODE_NOINLINE void handleYawSpin(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs) {
-    const float yawSpinResetRate = yawSpinRecoveryThreshold - 100.0f;
-    if (fabsf(gyroSensor->gyroDev.gyroADCf[Z]) < yawSpinResetRate) {
-        // testing whether 20ms of consecutive OK gyro yaw values is enough
-        if (cmpTimeUs(currentTimeUs, gyroSensor->yawSpinTimeUs) > 20000) {
-            gyroSensor->yawSpinDetected = false;
-        }
-    } else {
-        // reset the yaw spin time
-        gyroSensor->yawSpinTimeUs = currentTimeUs;
-    }
-}
-
-static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs) {
+static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, float absYawRate, timeUs_t currentTimeUs) {
     // if not in overflow mode, handle yaw spins above threshold
 #ifdef USE_GYRO_OVERFLOW_CHECK
     if (gyroSensor->overflowDetected) {
@@ -1130,11 +1508,19 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
     }
 #endif // USE_GYRO_OVERFLOW_CHECK
     if (gyroSensor->yawSpinDetected) {
-        handleYawSpin(gyroSensor, currentTimeUs);
+        if (absYawRate < yawSpinRecoveryThreshold - 100.0f) {
+            // testing whether 20ms of consecutive OK gyro yaw values is enough
+            if (cmpTimeUs(currentTimeUs, gyroSensor->yawSpinTimeUs) > 20000) {
+                gyroSensor->yawSpinDetected = false;
+            }
+        } else {
+            // reset the yaw spin time
+            gyroSensor->yawSpinTimeUs = currentTimeUs;
+        }
     } else {
 #ifndef SIMULATOR_BUILD
         // check for spin on yaw axis only
-        if (fabsf(gyroSensor->gyroDev.gyroADCf[Z]) > yawSpinRecoveryThreshold) {
+        if (absYawRate > yawSpinRecoveryThreshold) {
             gyroSensor->yawSpinDetected = true;
             gyroSensor->yawSpinTimeUs = currentTimeUs;
         }
@@ -1143,99 +1529,642 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
 }
 #endif // USE_YAW_SPIN_RECOVERY
 
+#if defined(USE_GYRO_OVERFLOW_CHECK) || defined(USE_YAW_SPIN_RECOVERY)
+// Both detectors work on the magnitudes of the filtered rates, taken once here for the two of them
+static FAST_CODE void checkForOverflowAndYawSpin(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs) {
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    const bool overflowCheckActive = gyroRuntime.checkOverflow && !gyroHasOverflowProtection;
+#else
+    const bool overflowCheckActive = false;
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+    const bool yawSpinCheckActive = yawSpinRecoveryEnabled;
+#else
+    const bool yawSpinCheckActive = false;
+#endif
+    if (!overflowCheckActive && !yawSpinCheckActive) {
+        return;
+    }
+    float absRate[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        absRate[axis] = fabsf(gyroSensor->gyroDev.gyroADCf[axis]);
+    }
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    if (overflowCheckActive) {
+        checkForOverflow(gyroSensor, absRate, MAX(MAX(absRate[X], absRate[Y]), absRate[Z]), currentTimeUs);
+    }
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+    if (yawSpinCheckActive) {
+        checkForYawSpin(gyroSensor, absRate[Z], currentTimeUs);
+    }
+#endif
+}
+#endif
+
 #ifdef USE_SMITH_PREDICTOR
-float applySmithPredictor(smithPredictor_t *smithPredictor, float gyroFiltered) {
-  if (smithPredictor->samples > 1 && smithPredictor->enabled) {
+// Adds the smoothed change over the filter delay to the filtered gyro. The pt1 runs on the
+// difference before the strength is applied, which is the same result as filtering the scaled one
+static FAST_CODE float applySmithPredictor(smithPredictor_t *smithPredictor, float gyroFiltered) {
     smithPredictor->data[smithPredictor->idx] = gyroFiltered;
+    const float delayedGyro = smithPredictor->data[(smithPredictor->idx - smithPredictor->samples) & SMITH_PREDICTOR_BUFFER_MASK];
+    smithPredictor->idx = (smithPredictor->idx + 1) & SMITH_PREDICTOR_BUFFER_MASK;
+    smithPredictor->filterState += smithPredictor->filterK * (gyroFiltered - delayedGyro - smithPredictor->filterState);
+    return gyroFiltered + smithPredictor->strength * smithPredictor->filterState;
+}
+#endif
 
-    smithPredictor->idx++;
-    if (smithPredictor->idx > smithPredictor->samples) {
-        smithPredictor->idx = 0;
+static FAST_CODE float gyroLowpassApply(uint8_t kind, gyroLowpassFilter_t *filter, float input) {
+    switch (kind) {
+    case GYRO_LOWPASS_KIND_PT1:
+        return pt1FilterApply(&filter->pt1FilterState, input);
+    case GYRO_LOWPASS_KIND_BIQUAD:
+        return biquadFilterApply(&filter->biquadFilterState, input);
+    case GYRO_LOWPASS_KIND_PT2:
+        return pt2FilterApply(&filter->ptnFilterState, input);
+    case GYRO_LOWPASS_KIND_PT3:
+        return pt3FilterApply(&filter->ptnFilterState, input);
+    case GYRO_LOWPASS_KIND_PT4:
+        return pt4FilterApply(&filter->ptnFilterState, input);
+    default:
+        return input;
     }
-
-    // filter the delayedGyro to help reduce the overall noise this prediction adds
-    float delayedGyro = smithPredictor->data[smithPredictor->idx];
-
-    float delayCompensatedGyro = smithPredictor->smithPredictorStrength * (gyroFiltered - delayedGyro);
-    delayCompensatedGyro = pt1FilterApply(&smithPredictor->smithPredictorFilter, delayCompensatedGyro);
-    gyroFiltered += delayCompensatedGyro;
-
-    return gyroFiltered;
-  }
-  return gyroFiltered;
 }
-#endif
 
+// lowpass stages of a filter chain, the fixed ones ignore the configured kind
+#define GYRO_LOWPASS_NONE(kind, filter, input)      (input)
+#define GYRO_LOWPASS_PT1(kind, filter, input)       pt1FilterApply(&(filter)->pt1FilterState, input)
+#define GYRO_LOWPASS_BIQUAD(kind, filter, input)    biquadFilterApply(&(filter)->biquadFilterState, input)
+#define GYRO_LOWPASS_PT2(kind, filter, input)       pt2FilterApply(&(filter)->ptnFilterState, input)
+#define GYRO_LOWPASS_PT3(kind, filter, input)       pt3FilterApply(&(filter)->ptnFilterState, input)
+#define GYRO_LOWPASS_PT4(kind, filter, input)       pt4FilterApply(&(filter)->ptnFilterState, input)
+#define GYRO_LOWPASS_ANY(kind, filter, input)       gyroLowpassApply(kind, filter, input)
+
+// generic chains, every stage is checked at runtime
 #define GYRO_FILTER_FUNCTION_NAME filterGyro
 #define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_ANY
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_ANY
+#define GYRO_FILTER_NOTCH1_ACTIVE gyroSensor->notchFilter1Active
+#define GYRO_FILTER_NOTCH2_ACTIVE gyroSensor->notchFilter2Active
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE gyroRuntime.dynamicFilterActive
+#define GYRO_FILTER_SMITH_ACTIVE gyroSensor->smithPredictorActive
+#define GYRO_FILTER_ABG_ACTIVE gyroSensor->gyroABGFilterActive
 #include "gyro_filter_impl.h"
-#undef GYRO_FILTER_FUNCTION_NAME
-#undef GYRO_FILTER_DEBUG_SET
 
 #define GYRO_FILTER_FUNCTION_NAME filterGyroDebug
 #define GYRO_FILTER_DEBUG_SET DEBUG_SET
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_ANY
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_ANY
+#define GYRO_FILTER_NOTCH1_ACTIVE gyroSensor->notchFilter1Active
+#define GYRO_FILTER_NOTCH2_ACTIVE gyroSensor->notchFilter2Active
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE gyroRuntime.dynamicFilterActive
+#define GYRO_FILTER_SMITH_ACTIVE gyroSensor->smithPredictorActive
+#define GYRO_FILTER_ABG_ACTIVE gyroSensor->gyroABGFilterActive
 #include "gyro_filter_impl.h"
-#undef GYRO_FILTER_FUNCTION_NAME
-#undef GYRO_FILTER_DEBUG_SET
 
+// fused chains for the common configurations without static notches, no per stage dispatch
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt1
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT1
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
 
-static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs) {
-#ifndef USE_DMA_SPI_DEVICE
-    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+#define GYRO_FILTER_FUNCTION_NAME filterGyroBiquad
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_BIQUAD
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt2
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT2
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt3
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT3
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt4
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT4
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#ifdef USE_GYRO_LPF2
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt1Pt1
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT1
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_PT1
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE false
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt1Dyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT1
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroBiquadDyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_BIQUAD
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt2Dyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT2
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt3Dyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT3
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt4Dyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT4
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_NONE
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+
+#ifdef USE_GYRO_LPF2
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt1Pt1Dyn
+#define GYRO_FILTER_DEBUG_SET(...)
+#define GYRO_FILTER_LOWPASS GYRO_LOWPASS_PT1
+#define GYRO_FILTER_LOWPASS2 GYRO_LOWPASS_PT1
+#define GYRO_FILTER_NOTCH1_ACTIVE false
+#define GYRO_FILTER_NOTCH2_ACTIVE false
+#define GYRO_FILTER_DYN_NOTCH_ACTIVE true
+#define GYRO_FILTER_SMITH_ACTIVE false
+#define GYRO_FILTER_ABG_ACTIVE false
+#include "gyro_filter_impl.h"
+#endif
+#endif // USE_GYRO_DATA_ANALYSE
+
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+// gyro samples carry this many fractional bits through the fixed point chain
+#define GYRO_FIXED_SAMPLE_SHIFT 8
+
+static FAST_CODE int32_t gyroLowpassFixedApply(uint8_t kind, gyroLowpassFilterFixed_t *filter, int32_t input) {
+    switch (kind) {
+    case GYRO_LOWPASS_KIND_PT1:
+        return pt1FilterFixedApply(&filter->pt1FilterState, input);
+    case GYRO_LOWPASS_KIND_BIQUAD:
+        return biquadFilterFixedApply(&filter->biquadFilterState, input);
+    default:
+        return input;
+    }
+}
+
+// lowpass and static notches in integer arithmetic, the sample is only converted on the way in and out
+static FAST_CODE void filterGyroFixed(gyroSensor_t *gyroSensor) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        int32_t sample = lrintf(gyroSensor->gyroDev.gyroADC[axis] * (1 << GYRO_FIXED_SAMPLE_SHIFT));
+#ifdef USE_GYRO_LPF2
+        sample = gyroLowpassFixedApply(gyroSensor->lowpass2FilterKind, &gyroSensor->lowpass2FilterFixed[axis], sample);
+#endif
+        sample = gyroLowpassFixedApply(gyroSensor->lowpassFilterKind, &gyroSensor->lowpassFilterFixed[axis], sample);
+        if (gyroSensor->notchFilter1Active) {
+            sample = biquadFilterFixedApply(&gyroSensor->notchFilter1Fixed[axis], sample);
+        }
+        if (gyroSensor->notchFilter2Active) {
+            sample = biquadFilterFixedApply(&gyroSensor->notchFilter2Fixed[axis], sample);
+        }
+        gyroSensor->gyroDev.gyroADCf[axis] = sample * gyroSensor->fixedScale;
+    }
+}
+
+static bool gyroInitLowpassFilterFixed(uint8_t kind, gyroLowpassFilter_t *filter, gyroLowpassFilterFixed_t *filterFixed) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        switch (kind) {
+        case GYRO_LOWPASS_KIND_NONE:
+            break;
+        case GYRO_LOWPASS_KIND_PT1:
+            pt1FilterFixedInit(&filterFixed[axis].pt1FilterState, filter[axis].pt1FilterState.k);
+            break;
+        case GYRO_LOWPASS_KIND_BIQUAD: {
+            const biquadFilter_t *biquad = &filter[axis].biquadFilterState;
+            biquadFilterFixedInit(&filterFixed[axis].biquadFilterState, biquad->b0, biquad->b1, biquad->b2, biquad->a1, biquad->a2);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+static void gyroInitNotchFilterFixed(const biquadFilterX3_t *notch, biquadFilterFixed_t *notchFixed) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterFixedInit(&notchFixed[axis], notch->b0[axis], notch->b1[axis], notch->b2[axis], notch->a1[axis], notch->a2[axis]);
+    }
+}
+
+// Only the lowpass and static notch stages have fixed point versions, any other active stage keeps the float chain
+static bool gyroInitFilterChainFixed(gyroSensor_t *gyroSensor) {
+#ifndef USE_GYRO_IMUF9001
+    if (gyroConfig()->imuf_w >= 3) { // kalman active
+        return false;
+    }
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    if (isDynamicFilterActive()) {
+        return false;
+    }
+#endif
+#ifdef USE_RPM_FILTER
+    if (isRpmFilterEnabled()) {
+        return false;
+    }
+#endif
+#ifdef USE_DYN_LPF
+    // the quantised copy would keep the cutoff it was made with
+    if (dynLpfGyroActive) {
+        return false;
+    }
+#endif
+#ifdef USE_SMITH_PREDICTOR
+    if (gyroSensor->smithPredictorActive) {
+        return false;
+    }
+#endif
+    if (gyroSensor->gyroABGFilterActive) {
+        return false;
+    }
+    if (!gyroInitLowpassFilterFixed(gyroSensor->lowpassFilterKind, gyroSensor->lowpassFilter, gyroSensor->lowpassFilterFixed)) {
+        return false;
+    }
+#ifdef USE_GYRO_LPF2
+    if (!gyroInitLowpassFilterFixed(gyroSensor->lowpass2FilterKind, gyroSensor->lowpass2Filter, gyroSensor->lowpass2FilterFixed)) {
+        return false;
+    }
+#endif
+    gyroInitNotchFilterFixed(&gyroSensor->notchFilter1, gyroSensor->notchFilter1Fixed);
+    gyroInitNotchFilterFixed(&gyroSensor->notchFilter2, gyroSensor->notchFilter2Fixed);
+    gyroSensor->fixedScale = gyroSensor->gyroDev.scale / (1 << GYRO_FIXED_SAMPLE_SHIFT);
+    gyroSensor->filterChainFn = filterGyroFixed;
+    return true;
+}
+#endif // USE_GYRO_FILTER_FIXED_POINT
+
+typedef struct gyroFilterChain_s {
+    uint8_t lowpassFilterKind;
+    uint8_t lowpass2FilterKind;
+    bool dynamicNotch;
+    void (*filterChainFn)(gyroSensor_t *gyroSensor);
+} gyroFilterChain_t;
+
+static const gyroFilterChain_t gyroFilterChains[] = {
+    { GYRO_LOWPASS_KIND_PT1,    GYRO_LOWPASS_KIND_NONE, false, filterGyroPt1 },
+    { GYRO_LOWPASS_KIND_BIQUAD, GYRO_LOWPASS_KIND_NONE, false, filterGyroBiquad },
+    { GYRO_LOWPASS_KIND_PT2,    GYRO_LOWPASS_KIND_NONE, false, filterGyroPt2 },
+    { GYRO_LOWPASS_KIND_PT3,    GYRO_LOWPASS_KIND_NONE, false, filterGyroPt3 },
+    { GYRO_LOWPASS_KIND_PT4,    GYRO_LOWPASS_KIND_NONE, false, filterGyroPt4 },
+#ifdef USE_GYRO_LPF2
+    { GYRO_LOWPASS_KIND_PT1,    GYRO_LOWPASS_KIND_PT1,  false, filterGyroPt1Pt1 },
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    { GYRO_LOWPASS_KIND_PT1,    GYRO_LOWPASS_KIND_NONE, true,  filterGyroPt1Dyn },
+    { GYRO_LOWPASS_KIND_BIQUAD, GYRO_LOWPASS_KIND_NONE, true,  filterGyroBiquadDyn },
+    { GYRO_LOWPASS_KIND_PT2,    GYRO_LOWPASS_KIND_NONE, true,  filterGyroPt2Dyn },
+    { GYRO_LOWPASS_KIND_PT3,    GYRO_LOWPASS_KIND_NONE, true,  filterGyroPt3Dyn },
+    { GYRO_LOWPASS_KIND_PT4,    GYRO_LOWPASS_KIND_NONE, true,  filterGyroPt4Dyn },
+#ifdef USE_GYRO_LPF2
+    { GYRO_LOWPASS_KIND_PT1,    GYRO_LOWPASS_KIND_PT1,  true,  filterGyroPt1Pt1Dyn },
+#endif
+#endif
+};
+
+static void gyroInitFilterChain(gyroSensor_t *gyroSensor) {
+    gyroSensor->filterChainFn = filterGyro;
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+    if (gyroInitFilterChainFixed(gyroSensor)) {
         return;
     }
 #endif
-    gyroSensor->gyroDev.dataReady = false;
+    if (gyroSensor->notchFilter1Active || gyroSensor->notchFilter2Active || gyroSensor->gyroABGFilterActive) {
+        return;
+    }
+#ifdef USE_SMITH_PREDICTOR
+    if (gyroSensor->smithPredictorActive) {
+        return;
+    }
+#endif
+#ifdef USE_GYRO_LPF2
+    const uint8_t lowpass2FilterKind = gyroSensor->lowpass2FilterKind;
+#else
+    const uint8_t lowpass2FilterKind = GYRO_LOWPASS_KIND_NONE;
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    const bool dynamicNotch = isDynamicFilterActive();
+#else
+    const bool dynamicNotch = false;
+#endif
+    for (unsigned i = 0; i < ARRAYLEN(gyroFilterChains); i++) {
+        const gyroFilterChain_t *chain = &gyroFilterChains[i];
+        if (chain->lowpassFilterKind == gyroSensor->lowpassFilterKind && chain->lowpass2FilterKind == lowpass2FilterKind && chain->dynamicNotch == dynamicNotch) {
+            gyroSensor->filterChainFn = chain->filterChainFn;
+            return;
+        }
+    }
+}
+
+#ifdef USE_FILTER_RETUNE
+static FAST_CODE void gyroLowpassCopyCoeffs(uint8_t kind, gyroLowpassFilter_t *lowpassFilter, const gyroLowpassFilter_t *coeffs) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        switch (kind) {
+        case GYRO_LOWPASS_KIND_PT1:
+            lowpassFilter[axis].pt1FilterState.k = coeffs[axis].pt1FilterState.k;
+            break;
+        case GYRO_LOWPASS_KIND_BIQUAD:
+            biquadFilterCopyCoeffs(&lowpassFilter[axis].biquadFilterState, &coeffs[axis].biquadFilterState);
+            break;
+        case GYRO_LOWPASS_KIND_PT2:
+        case GYRO_LOWPASS_KIND_PT3:
+        case GYRO_LOWPASS_KIND_PT4:
+            lowpassFilter[axis].ptnFilterState.k = coeffs[axis].ptnFilterState.k;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+static void gyroLowpassFixedCopyCoeffs(uint8_t kind, const gyroLowpassFilter_t *filter, gyroLowpassFilterFixed_t *filterFixed) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        switch (kind) {
+        case GYRO_LOWPASS_KIND_PT1:
+            pt1FilterFixedUpdateCutoff(&filterFixed[axis].pt1FilterState, filter[axis].pt1FilterState.k);
+            break;
+        case GYRO_LOWPASS_KIND_BIQUAD: {
+            const biquadFilter_t *biquad = &filter[axis].biquadFilterState;
+            biquadFilterFixedUpdate(&filterFixed[axis].biquadFilterState, biquad->b0, biquad->b1, biquad->b2, biquad->a1, biquad->a2);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+static void gyroNotchFixedCopyCoeffs(const biquadFilterX3_t *notch, biquadFilterFixed_t *notchFixed) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterFixedUpdate(&notchFixed[axis], notch->b0[axis], notch->b1[axis], notch->b2[axis], notch->a1[axis], notch->a2[axis]);
+    }
+}
+#endif
+
+// Only the coefficients are taken over, the filter state carries on so the output doesn't step
+static FAST_CODE void gyroSwapSensorFilterCoeffs(gyroSensor_t *gyroSensor) {
+    const gyroFilterCoeffs_t *coeffs = &gyroSensor->retuneCoeffs;
+    gyroLowpassCopyCoeffs(gyroSensor->lowpassFilterKind, gyroSensor->lowpassFilter, coeffs->lowpassFilter);
+#ifdef USE_GYRO_LPF2
+    gyroLowpassCopyCoeffs(gyroSensor->lowpass2FilterKind, gyroSensor->lowpass2Filter, coeffs->lowpass2Filter);
+#endif
+    if (gyroSensor->notchFilter1Active) {
+        biquadFilterCopyCoeffsX3(&gyroSensor->notchFilter1, &coeffs->notchFilter1);
+    }
+    if (gyroSensor->notchFilter2Active) {
+        biquadFilterCopyCoeffsX3(&gyroSensor->notchFilter2, &coeffs->notchFilter2);
+    }
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+    if (gyroSensor->filterChainFn == filterGyroFixed) {
+        gyroLowpassFixedCopyCoeffs(gyroSensor->lowpassFilterKind, gyroSensor->lowpassFilter, gyroSensor->lowpassFilterFixed);
+#ifdef USE_GYRO_LPF2
+        gyroLowpassFixedCopyCoeffs(gyroSensor->lowpass2FilterKind, gyroSensor->lowpass2Filter, gyroSensor->lowpass2FilterFixed);
+#endif
+        if (gyroSensor->notchFilter1Active) {
+            gyroNotchFixedCopyCoeffs(&gyroSensor->notchFilter1, gyroSensor->notchFilter1Fixed);
+        }
+        if (gyroSensor->notchFilter2Active) {
+            gyroNotchFixedCopyCoeffs(&gyroSensor->notchFilter2, gyroSensor->notchFilter2Fixed);
+        }
+    }
+#endif
+}
+
+// Called at the start of a gyro update, so every sample goes through one consistent set of coefficients
+static FAST_CODE_NOINLINE void gyroSwapFilterCoeffs(void) {
+    gyroSwapSensorFilterCoeffs(&gyroSensor1);
+#ifdef USE_DUAL_GYRO
+    gyroSwapSensorFilterCoeffs(&gyroSensor2);
+#endif
+    gyroFilterCoeffsPending = false;
+}
+
+static uint8_t gyroLowpassAxes(const uint16_t *lpfHz) {
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
+    uint8_t axes = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (lpfHz[axis] && lpfHz[axis] <= gyroFrequencyNyquist) {
+            axes |= 1 << axis;
+        }
+    }
+    return axes;
+}
+
+static bool gyroNotchConfigured(uint16_t notchHz, uint16_t notchCutoffHz) {
+    return calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz) != 0 && notchCutoffHz != 0;
+}
+
+// Whether the stages the filters are made of stay the same, only their cutoffs may change
+static bool gyroFilterLayoutUnchanged(const gyroConfig_t *config) {
+    gyroConfig_t retuned = *config;
+    memcpy(retuned.gyro_lowpass_hz, gyroFiltersConfig.gyro_lowpass_hz, sizeof(retuned.gyro_lowpass_hz));
+    memcpy(retuned.gyro_lowpass2_hz, gyroFiltersConfig.gyro_lowpass2_hz, sizeof(retuned.gyro_lowpass2_hz));
+    retuned.gyro_soft_notch_hz_1 = gyroFiltersConfig.gyro_soft_notch_hz_1;
+    retuned.gyro_soft_notch_cutoff_1 = gyroFiltersConfig.gyro_soft_notch_cutoff_1;
+    retuned.gyro_soft_notch_hz_2 = gyroFiltersConfig.gyro_soft_notch_hz_2;
+    retuned.gyro_soft_notch_cutoff_2 = gyroFiltersConfig.gyro_soft_notch_cutoff_2;
+    retuned.dyn_lpf_gyro_min_hz = gyroFiltersConfig.dyn_lpf_gyro_min_hz;
+    retuned.dyn_lpf_gyro_max_hz = gyroFiltersConfig.dyn_lpf_gyro_max_hz;
+    if (memcmp(&retuned, &gyroFiltersConfig, sizeof(retuned)) != 0) {
+        return false;
+    }
+#ifdef USE_DYN_LPF
+    if (gyroDynLpfConfigured(config) != gyroDynLpfConfigured(&gyroFiltersConfig)) {
+        return false;
+    }
+#endif
+    for (int slot = FILTER_LOWPASS; slot <= FILTER_LOWPASS2; slot++) {
+        uint16_t lpfHz[XYZ_AXIS_COUNT];
+        uint16_t activeLpfHz[XYZ_AXIS_COUNT];
+        if (gyroLowpassCutoffs(config, slot, lpfHz) && gyroLowpassCutoffs(&gyroFiltersConfig, slot, activeLpfHz)
+            && gyroLowpassAxes(lpfHz) != gyroLowpassAxes(activeLpfHz)) {
+            return false;
+        }
+    }
+    return gyroNotchConfigured(config->gyro_soft_notch_hz_1, config->gyro_soft_notch_cutoff_1)
+           == gyroNotchConfigured(gyroFiltersConfig.gyro_soft_notch_hz_1, gyroFiltersConfig.gyro_soft_notch_cutoff_1)
+        && gyroNotchConfigured(config->gyro_soft_notch_hz_2, config->gyro_soft_notch_cutoff_2)
+           == gyroNotchConfigured(gyroFiltersConfig.gyro_soft_notch_hz_2, gyroFiltersConfig.gyro_soft_notch_cutoff_2);
+}
+
+static void gyroRetuneSensorFilters(gyroSensor_t *gyroSensor, const gyroConfig_t *config) {
+    gyroFilterCoeffs_t *coeffs = &gyroSensor->retuneCoeffs;
+    uint16_t lpfHz[XYZ_AXIS_COUNT];
+    // axes without a lowpass keep the coefficients they have
+    memcpy(coeffs->lowpassFilter, gyroSensor->lowpassFilter, sizeof(coeffs->lowpassFilter));
+    gyroLowpassCutoffs(config, FILTER_LOWPASS, lpfHz);
+    gyroInitLowpassFilters(coeffs->lowpassFilter, lpfHz, config->gyro_lowpass_type);
+#ifdef USE_GYRO_LPF2
+    memcpy(coeffs->lowpass2Filter, gyroSensor->lowpass2Filter, sizeof(coeffs->lowpass2Filter));
+    gyroLowpassCutoffs(config, FILTER_LOWPASS2, lpfHz);
+    gyroInitLowpassFilters(coeffs->lowpass2Filter, lpfHz, config->gyro_lowpass2_type);
+#endif
+    gyroInitFilterNotch(&coeffs->notchFilter1, config->gyro_soft_notch_hz_1, config->gyro_soft_notch_cutoff_1);
+    gyroInitFilterNotch(&coeffs->notchFilter2, config->gyro_soft_notch_hz_2, config->gyro_soft_notch_cutoff_2);
+}
+
+// Hands new lowpass and static notch cutoffs to the running filters without resetting them, the gyro
+// loop swaps the coefficients in at its next update. False when more than the cutoffs changed, the
+// filters then have to be set up again with gyroInitFilters()
+bool gyroRetuneFilters(void) {
+    const gyroConfig_t *config = gyroConfig();
+    if (!gyroFilterLayoutUnchanged(config)) {
+        return false;
+    }
+    // the gyro loop may interrupt us, it must not take a half written set
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        gyroFilterCoeffsPending = false;
+    }
+    gyroRetuneSensorFilters(&gyroSensor1, config);
+#ifdef USE_DUAL_GYRO
+    gyroRetuneSensorFilters(&gyroSensor2, config);
+#endif
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        gyroFilterCoeffsPending = true;
+    }
+    gyroFiltersConfig = *config;
+    return true;
+}
+#endif // USE_FILTER_RETUNE
+
+
+// Calibrates, zeroes and aligns the latest raw sample into gyroADC, false while the sensor is still calibrating
+static FAST_CODE bool gyroPrepareSample(gyroSensor_t* gyroSensor) {
 #ifdef USE_GYRO_IMUF9001
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // NOTE: this branch optimized for when there is no gyro debugging, ensure it is kept in step with non-optimized branch
         DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroSensor->gyroDev.gyroADCf[axis]));
     }
     if (!isGyroSensorCalibrationComplete(gyroSensor)) {
-        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        performGyroCalibration(gyroSensor, gyroRuntime.movementCalibrationThreshold);
         // Reset gyro values to zero to prevent other code from using uncalibrated data
         gyroSensor->gyroDev.gyroADCf[X] = 0.0f;
         gyroSensor->gyroDev.gyroADCf[Y] = 0.0f;
         gyroSensor->gyroDev.gyroADCf[Z] = 0.0f;
         // still calibrating, so no need to further process gyro data
     }
+    return true;
 #else
     if (isGyroSensorCalibrationComplete(gyroSensor)) {
         // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
+        float sample[XYZ_AXIS_COUNT];
 #if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
+        sample[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
+        sample[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
+        sample[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
 #else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+        sample[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
+        sample[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
+        sample[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
 #endif
-        alignSensors(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
+        // sensor rotation and board alignment in one multiply, no per sample switch on the mounting
+        const float (*alignment)[XYZ_AXIS_COUNT] = gyroSensor->alignment;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroSensor->gyroDev.gyroADC[axis] = alignment[axis][X] * sample[X] + alignment[axis][Y] * sample[Y] + alignment[axis][Z] * sample[Z];
+        }
     } else {
-        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        performGyroCalibration(gyroSensor, gyroRuntime.movementCalibrationThreshold);
         // still calibrating, so no need to further process gyro data
-        return;
+        return false;
     }
+    return true;
 #endif
+}
+
+static FAST_CODE void gyroFilterSample(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs) {
+#ifdef USE_GYRO_CAPTURE
+    gyroCaptureSample(gyroSensor);
+#endif
+    CYCLE_SECTION_BEGIN(GYRO_FILTER);
     if (gyroDebugMode == DEBUG_NONE) {
-        filterGyro(gyroSensor);
+        gyroSensor->filterChainFn(gyroSensor);
     } else {
         filterGyroDebug(gyroSensor);
     }
-#ifdef USE_GYRO_OVERFLOW_CHECK
-    if (gyroConfig()->checkOverflow && !gyroHasOverflowProtection) {
-        checkForOverflow(gyroSensor, currentTimeUs);
-    }
-#endif
-#ifdef USE_YAW_SPIN_RECOVERY
-    if (yawSpinRecoveryEnabled) {
-        checkForYawSpin(gyroSensor, currentTimeUs);
-    }
+    CYCLE_SECTION_END(GYRO_FILTER);
+#if defined(USE_GYRO_OVERFLOW_CHECK) || defined(USE_YAW_SPIN_RECOVERY)
+    checkForOverflowAndYawSpin(gyroSensor, currentTimeUs);
 #endif
 #ifdef USE_GYRO_DATA_ANALYSE
-    if (isDynamicFilterActive()) {
+    if (gyroRuntime.dynamicFilterActive) {
+        CYCLE_SECTION_BEGIN(GYRO_FFT);
         gyroDataAnalyse(&gyroSensor->gyroAnalyseState);
+        CYCLE_SECTION_END(GYRO_FFT);
     }
 #endif
 #if (!defined(USE_GYRO_OVERFLOW_CHECK) && !defined(USE_YAW_SPIN_RECOVERY))
@@ -1243,6 +2172,307 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
 #endif
 }
 
+static FAST_CODE void gyroUpdateSample(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs) {
+    if (gyroPrepareSample(gyroSensor)) {
+        gyroFilterSample(gyroSensor, currentTimeUs);
+    }
+}
+
+#ifdef USE_CYCLE_BENCH
+// One pass of the configured filter chain over the last sample of the active gyro, for the cli bench
+void gyroFilterBenchmark(void) {
+    gyroSensor_t *gyroSensor = &gyroSensor1;
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        gyroSensor = &gyroSensor2;
+    }
+#endif
+    gyroSensor->filterChainFn(gyroSensor);
+}
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+// TASK_DYN_NOTCH, analyses the spectrum the active gyro's filter path has been pushing
+void gyroDynNotchUpdate(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    gyroSensor_t *gyroSensor = &gyroSensor1;
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        gyroSensor = &gyroSensor2;
+    }
+#endif
+    gyroDataAnalyseTask(&gyroSensor->gyroAnalyseState);
+}
+#endif
+
+static FAST_CODE bool gyroReadSensor(gyroSensor_t* gyroSensor) {
+#ifndef USE_DMA_SPI_DEVICE
+    CYCLE_SECTION_BEGIN(GYRO_READ);
+    const bool gyroReadOk = gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev);
+    CYCLE_SECTION_END(GYRO_READ);
+    if (!gyroReadOk) {
+        return false;
+    }
+#endif
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    gyroSensor->sampleTimeUs = gyroSensor->gyroDev.dataReadyAtUs;
+#endif
+    gyroSensor->gyroDev.dataReady = false;
+    return true;
+}
+
+static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs) {
+    if (!gyroReadSensor(gyroSensor)) {
+        return;
+    }
+#ifdef USE_GYRO_FIFO_BATCH
+    if (gyroSensor->gyroDev.fifoBatchSize > 1) {
+        // run every sample drained from the fifo through the filter chain so the
+        // filters and the dynamic notch analysis still see the full sensor rate
+        for (int i = 0; i < gyroSensor->gyroDev.fifoSampleCount; i++) {
+            gyroSensor->gyroDev.gyroADCRaw[X] = gyroSensor->gyroDev.gyroADCRawFifo[i][X];
+            gyroSensor->gyroDev.gyroADCRaw[Y] = gyroSensor->gyroDev.gyroADCRawFifo[i][Y];
+            gyroSensor->gyroDev.gyroADCRaw[Z] = gyroSensor->gyroDev.gyroADCRawFifo[i][Z];
+            gyroUpdateSample(gyroSensor, currentTimeUs);
+        }
+        return;
+    }
+#endif
+    gyroUpdateSample(gyroSensor, currentTimeUs);
+}
+
+#ifdef USE_DUAL_GYRO
+// Weights the two time aligned raw samples by the inverse of their noise variance and runs the
+// result through gyro 1's filter chain only. The sample to sample change is tracked per sensor,
+// the motion part of it is common to both so the difference in variance is the sensor noise.
+static FAST_CODE void gyroUpdateFusedSample(timeUs_t currentTimeUs) {
+    const bool gyro1Ready = gyroPrepareSample(&gyroSensor1);
+    const bool gyro2Ready = gyroPrepareSample(&gyroSensor2);
+    if (!gyro1Ready || !gyro2Ready) {
+        return;
+    }
+    // gyro 2 is brought onto gyro 1's scale so the fused sample can use gyro 1's filters
+    const float gyro2Scale = gyroSensor2.gyroDev.scale / gyroSensor1.gyroDev.scale;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float sample1 = gyroSensor1.gyroDev.gyroADC[axis];
+        const float sample2 = gyroSensor2.gyroDev.gyroADC[axis] * gyro2Scale;
+        const float delta1 = sample1 - gyroFusion.previous[0][axis];
+        const float delta2 = sample2 - gyroFusion.previous[1][axis];
+        gyroFusion.previous[0][axis] = sample1;
+        gyroFusion.previous[1][axis] = sample2;
+        gyroFusion.noiseVariance[0][axis] += gyroFusion.smoothing * (delta1 * delta1 - gyroFusion.noiseVariance[0][axis]);
+        gyroFusion.noiseVariance[1][axis] += gyroFusion.smoothing * (delta2 * delta2 - gyroFusion.noiseVariance[1][axis]);
+        const float varianceSum = gyroFusion.noiseVariance[0][axis] + gyroFusion.noiseVariance[1][axis];
+        const float weight2 = varianceSum > 0.0f ? gyroFusion.noiseVariance[0][axis] / varianceSum : 0.5f;
+        gyroFusion.weight2[axis] = weight2;
+        gyroSensor1.gyroDev.gyroADC[axis] = sample1 + (sample2 - sample1) * weight2;
+    }
+    gyroFilterSample(&gyroSensor1, currentTimeUs);
+}
+
+static FAST_CODE_NOINLINE void gyroUpdateFusedSensors(timeUs_t currentTimeUs) {
+    const bool gyro1ReadOk = gyroReadSensor(&gyroSensor1);
+    const bool gyro2ReadOk = gyroReadSensor(&gyroSensor2);
+    if (!gyro1ReadOk || !gyro2ReadOk) {
+        return;
+    }
+#ifdef USE_GYRO_FIFO_BATCH
+    if (gyroSensor1.gyroDev.fifoBatchSize > 1) {
+        // both sensors are the same hardware on the same batch size, fuse the samples pairwise
+        const int sampleCount = MIN(gyroSensor1.gyroDev.fifoSampleCount, gyroSensor2.gyroDev.fifoSampleCount);
+        for (int i = 0; i < sampleCount; i++) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                gyroSensor1.gyroDev.gyroADCRaw[axis] = gyroSensor1.gyroDev.gyroADCRawFifo[i][axis];
+                gyroSensor2.gyroDev.gyroADCRaw[axis] = gyroSensor2.gyroDev.gyroADCRawFifo[i][axis];
+            }
+            gyroUpdateFusedSample(currentTimeUs);
+        }
+        return;
+    }
+#endif
+    gyroUpdateFusedSample(currentTimeUs);
+}
+
+// Reads one gyro per tick and feeds its sample, on gyro 1's scale, through gyro 1's filter chain.
+// The sensors run from their own clocks so the half period offset is nominal, it drifts with the
+// difference of the two sample clocks.
+static FAST_CODE_NOINLINE void gyroUpdateStaggeredSensors(timeUs_t currentTimeUs) {
+    gyroSensor_t *gyroSensor = gyroStaggerSecond ? &gyroSensor2 : &gyroSensor1;
+    gyroStaggerSecond = !gyroStaggerSecond;
+    if (!gyroReadSensor(gyroSensor) || !gyroPrepareSample(gyroSensor)) {
+        return;
+    }
+    if (!isGyroSensorCalibrationComplete(&gyroSensor1) || !isGyroSensorCalibrationComplete(&gyroSensor2)) {
+        return;
+    }
+    if (gyroSensor == &gyroSensor2) {
+        const float gyro2Scale = gyroSensor2.gyroDev.scale / gyroSensor1.gyroDev.scale;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroSensor1.gyroDev.gyroADC[axis] = gyroSensor2.gyroDev.gyroADC[axis] * gyro2Scale;
+        }
+    }
+    gyroFilterSample(&gyroSensor1, currentTimeUs);
+}
+#endif
+
+uint32_t gyroTaskLooptime(void) {
+#ifdef USE_GYRO_FIFO_BATCH
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyro.targetLooptime * gyroSensor2.gyroDev.fifoBatchSize;
+    }
+#endif
+    return gyro.targetLooptime * gyroSensor1.gyroDev.fifoBatchSize;
+#else
+    return gyro.targetLooptime;
+#endif
+}
+
+#ifdef USE_GYRO_SPI_DMA
+// Some of the other SPI drivers bypass the bus locking, so the EXTI started
+// DMA read is only used when the gyro has its bus to itself.
+static bool gyroSpiBusIsExclusive(const gyroDev_t *gyroDev) {
+    const SPIDevice device = spiDeviceByInstance(gyroDev->bus.busdev_u.spi.instance);
+    if (device == SPIINVALID) {
+        return false;
+    }
+#if defined(USE_FLASHFS) && defined(USE_FLASH)
+    if (SPI_CFG_TO_DEV(flashConfig()->spiDevice) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_MAX7456
+    if (SPI_CFG_TO_DEV(max7456Config()->spiDevice) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_RX_SPI
+    if (SPI_CFG_TO_DEV(rxSpiConfig()->spibus) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_BARO
+    if (barometerConfig()->baro_bustype == BUSTYPE_SPI && SPI_CFG_TO_DEV(barometerConfig()->baro_spi_device) == device) {
+        return false;
+    }
+#endif
+#ifdef USE_MAG
+    if (compassConfig()->mag_bustype == BUSTYPE_SPI && SPI_CFG_TO_DEV(compassConfig()->mag_spi_device) == device) {
+        return false;
+    }
+#endif
+#if defined(USE_SDCARD) && defined(SDCARD_SPI_INSTANCE)
+    if (sdcardConfig()->enabled && sdcardConfig()->device == device) {
+        return false;
+    }
+#endif
+#ifdef RTC6705_SPI_INSTANCE
+    if (spiDeviceByInstance(RTC6705_SPI_INSTANCE) == device) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void gyroInitSensorSpiDma(gyroSensor_t *gyroSensor) {
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+    switch (gyroDev->gyroHardware) {
+    case GYRO_MPU6000:
+    case GYRO_MPU6500:
+    case GYRO_MPU9250:
+    case GYRO_ICM20601:
+    case GYRO_ICM20602:
+    case GYRO_ICM20608G:
+    case GYRO_ICM20649:
+    case GYRO_ICM20689:
+    case GYRO_ICM42605:
+    case GYRO_ICM42688P:
+        if (gyroSpiBusIsExclusive(gyroDev)) {
+            mpuGyroSpiDmaInit(gyroDev);
+        }
+        break;
+    default:
+        // BMI sensors use their own EXTI handlers and little endian data
+        break;
+    }
+}
+
+// Called once all other DMA users are set up so the SPI streams are only
+// claimed when they are still free.
+void gyroInitSpiDma(void) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
+        gyroInitSensorSpiDma(&gyroSensor1);
+    }
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || GYRO_CONFIG_USES_BOTH(gyroToUse)) {
+        gyroInitSensorSpiDma(&gyroSensor2);
+    }
+#endif
+}
+
+#ifdef USE_GYRO_PID_INTERRUPT
+// Hands every DMA sample of the active gyro to fn in interrupt context, which
+// needs a single gyro that gyroInitSpiDma() managed to put on DMA.
+bool gyroSetSpiDmaSampleHandler(void (*fn)(void)) {
+    if (GYRO_CONFIG_USES_BOTH(gyroToUse)) {
+        return false;
+    }
+    gyroDev_t *gyroDev = &gyroSensor1.gyroDev;
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        gyroDev = &gyroSensor2.gyroDev;
+    }
+#endif
+    if (!gyroDev->useSpiDma) {
+        return false;
+    }
+    gyroDev->spiDmaSampleFn = fn;
+    return true;
+}
+#endif
+#endif
+
+#ifdef USE_GYRO_ACC_BURST
+// Lets the acc of the active gyro ride along on its data reads, so TASK_ACCEL
+// copies the last sample instead of starting a bus transaction of its own.
+bool gyroInitAccBurst(accDev_t *acc) {
+#ifdef USE_DMA_SPI_DEVICE
+    // the dma spi device already fetches acc and gyro together
+    UNUSED(acc);
+    return false;
+#else
+    gyroDev_t *gyroDev = &gyroSensor1.gyroDev;
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        gyroDev = &gyroSensor2.gyroDev;
+    }
+#endif
+    switch (gyroDev->gyroHardware) {
+    case GYRO_MPU6000:
+    case GYRO_MPU6500:
+    case GYRO_MPU9250:
+    case GYRO_ICM20601:
+    case GYRO_ICM20602:
+    case GYRO_ICM20608G:
+    case GYRO_ICM20649:
+    case GYRO_ICM20689:
+    case GYRO_ICM42605:
+    case GYRO_ICM42688P:
+        break;
+    default:
+        // BMI sensors read little endian data behind a dummy byte
+        return false;
+    }
+    if (!mpuGyroAccBurstInit(gyroDev)) {
+        return false;
+    }
+    acc->burstGyro = gyroDev;
+    acc->readFn = mpuAccReadGyroBurst;
+    return true;
+#endif
+}
+#endif
+
 #ifdef USE_DMA_SPI_DEVICE
 FAST_CODE_NOINLINE void gyroDmaSpiFinishRead(void) {
     //called by dma callback
@@ -1251,11 +2481,19 @@ FAST_CODE_NOINLINE void gyroDmaSpiFinishRead(void) {
 
 FAST_CODE_NOINLINE void gyroDmaSpiStartRead(void) {
     //called by exti
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+    gyroSensor1.gyroDev.dataReadyAtUs = microsISR();
+#endif
     mpuGyroDmaSpiReadStart(&gyroSensor1.gyroDev);
 }
 #endif
 
 FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs) {
+#ifdef USE_FILTER_RETUNE
+    if (gyroFilterCoeffsPending) {
+        gyroSwapFilterCoeffs();
+    }
+#endif
 #ifdef USE_DUAL_GYRO
     switch (gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
@@ -1326,6 +2564,50 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs) {
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyroSensor1.gyroDev.gyroADCf[Y] - gyroSensor2.gyroDev.gyroADCf[Y]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyroSensor1.gyroDev.gyroADCf[Z] - gyroSensor2.gyroDev.gyroADCf[Z]));
         break;
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+        gyroUpdateFusedSensors(currentTimeUs);
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
+            gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
+            gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
+#ifdef USE_GYRO_OVERFLOW_CHECK
+            overflowDetected = gyroSensor1.overflowDetected;
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+            yawSpinDetected = gyroSensor1.yawSpinDetected;
+#endif
+        }
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyroSensor2.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
+        // only one filter chain runs, show the share of gyro 2 per axis instead of per sensor outputs
+        DEBUG_SET(DEBUG_DUAL_GYRO, 0, lrintf(gyroFusion.weight2[X] * 1000.0f));
+        DEBUG_SET(DEBUG_DUAL_GYRO, 1, lrintf(gyroFusion.weight2[Y] * 1000.0f));
+        DEBUG_SET(DEBUG_DUAL_GYRO, 2, lrintf(gyroFusion.weight2[Z] * 1000.0f));
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[X]));
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[Y]));
+        break;
+    case GYRO_CONFIG_USE_GYRO_STAGGERED:
+        gyroUpdateStaggeredSensors(currentTimeUs);
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
+            gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
+            gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
+#ifdef USE_GYRO_OVERFLOW_CHECK
+            overflowDetected = gyroSensor1.overflowDetected;
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+            yawSpinDetected = gyroSensor1.yawSpinDetected;
+#endif
+        }
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyroSensor2.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[X]));
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[Y]));
+        break;
     }
 #else
     gyroUpdateSensor(&gyroSensor1, currentTimeUs);
@@ -1340,26 +2622,23 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs) {
 #endif
 #endif
     if (!overflowDetected) {
+        float trapezium[XYZ_AXIS_COUNT];
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             // integrate using trapezium rule to avoid bias
-            accumulatedMeasurements[axis] += (gyroPrevious[axis] + gyro.gyroADCf[axis]);
+            trapezium[axis] = gyroPrevious[axis] + gyro.gyroADCf[axis];
             gyroPrevious[axis] = gyro.gyroADCf[axis];
         }
-        accumulatedMeasurementCount++;
+        accumulatorAdd(&gyroAccumulator, trapezium);
     }
 }
 
 bool gyroGetAverage(quaternion *vAverage) {
-    if (accumulatedMeasurementCount) {
-        const timeUs_t accumulatedMeasurementTimeUs = accumulatedMeasurementCount;
+    accumulatorSums_t measurements;
+    if (accumulatorTake(&gyroAccumulator, &measurements)) {
         vAverage->w = 0;
-        vAverage->x = 0.5f * DEGREES_TO_RADIANS(accumulatedMeasurements[X] / accumulatedMeasurementTimeUs);
-        vAverage->y = 0.5f * DEGREES_TO_RADIANS(accumulatedMeasurements[Y] / accumulatedMeasurementTimeUs);
-        vAverage->z = 0.5f * DEGREES_TO_RADIANS(accumulatedMeasurements[Z] / accumulatedMeasurementTimeUs);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            accumulatedMeasurements[axis] = 0.0f;
-        }
-        accumulatedMeasurementCount = 0;
+        vAverage->x = 0.5f * DEGREES_TO_RADIANS(measurements.sum[X] / measurements.count);
+        vAverage->y = 0.5f * DEGREES_TO_RADIANS(measurements.sum[Y] / measurements.count);
+        vAverage->z = 0.5f * DEGREES_TO_RADIANS(measurements.sum[Z] / measurements.count);
         return true;
     } else {
         quaternionInitVector(vAverage);
@@ -1384,6 +2663,8 @@ void gyroReadTemperature(void) {
         gyroSensorTemperature = gyroReadSensorTemperature(gyroSensor2);
         break;
     case GYRO_CONFIG_USE_GYRO_BOTH:
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+    case GYRO_CONFIG_USE_GYRO_STAGGERED:
         gyroSensorTemperature = MAX(gyroReadSensorTemperature(gyroSensor1), gyroReadSensorTemperature(gyroSensor2));
         break;
 #endif // USE_DUAL_GYRO
@@ -29,7 +29,9 @@
 #include "drivers/sensor.h"
 
 #ifdef USE_SMITH_PREDICTOR
-#define MAX_SMITH_SAMPLES 12 * 32
+// power of two delay line, the delay is limited to one sample less (8ms at 32khz)
+#define SMITH_PREDICTOR_BUFFER_SIZE 256
+#define SMITH_PREDICTOR_BUFFER_MASK (SMITH_PREDICTOR_BUFFER_SIZE - 1)
 #endif // USE_SMITH_PREDICTOR
 
 #ifdef USE_YAW_SPIN_RECOVERY
@@ -37,6 +39,10 @@
 #define YAW_SPIN_RECOVERY_THRESHOLD_MAX 1950
 #endif
 
+#ifdef USE_GYRO_FIFO_BATCH
+#define GYRO_FIFO_BATCH_MAX 4
+#endif
+
 extern float vGyroStdDevModulus;
 typedef enum {
     GYRO_NONE = 0,
@@ -83,6 +89,10 @@ typedef enum {
 #define GYRO_CONFIG_USE_GYRO_1      0
 #define GYRO_CONFIG_USE_GYRO_2      1
 #define GYRO_CONFIG_USE_GYRO_BOTH   2
+#define GYRO_CONFIG_USE_GYRO_FUSED  3       // both gyros, raw samples weighted by their noise before one filter chain
+#define GYRO_CONFIG_USE_GYRO_STAGGERED 4    // both gyros read alternately, one filter chain at twice the sample rate
+
+#define GYRO_CONFIG_USES_BOTH(gyroToUse) ((gyroToUse) == GYRO_CONFIG_USE_GYRO_BOTH || (gyroToUse) == GYRO_CONFIG_USE_GYRO_FUSED || (gyroToUse) == GYRO_CONFIG_USE_GYRO_STAGGERED)
 
 typedef enum {
     FILTER_LOWPASS = 0,
@@ -102,15 +112,14 @@ typedef enum {
 
 #ifdef USE_SMITH_PREDICTOR
 typedef struct smithPredictor_s {
-    uint8_t enabled;
     uint8_t samples;
     uint8_t idx;
 
-    float data[MAX_SMITH_SAMPLES + 1]; // This is gonna be a ring buffer. Max of 8ms delay at 8khz
+    float data[SMITH_PREDICTOR_BUFFER_SIZE];
 
-    pt1Filter_t smithPredictorFilter; // filter the smith predictor output for RPY
-
-    float smithPredictorStrength;
+    float filterK;                    // pt1 smoothing the prediction, reduces the noise it adds
+    float filterState;
+    float strength;
 } smithPredictor_t;
 #endif // USE_SMITH_PREDICTOR
 
@@ -119,6 +128,11 @@ typedef enum {
     RPY = 1
 } dynamicGyroAxisType_e;
 
+typedef enum {
+    DYN_LPF_SOURCE_THROTTLE = 0,
+    DYN_LPF_SOURCE_RPM              // the slowest motor, needs the rpm filter running
+} dynLpfSource_e;
+
 typedef struct gyroConfig_s {
     uint8_t  gyro_align;                       // gyro alignment
     uint8_t  gyroMovementCalibrationThreshold; // people keep forgetting that moving model while init results in wrong gyro offsets. and then they never reset gyro. so this is now on by default.
@@ -147,16 +161,20 @@ typedef struct gyroConfig_s {
     // Lowpass primary/secondary
     uint8_t  gyro_lowpass_type;
     uint8_t  gyro_lowpass2_type;
+    uint16_t dyn_lpf_gyro_min_hz;      // first lowpass cutoff at low throttle or slow motors, 0 keeps gyro_lowpass_hz
+    uint16_t dyn_lpf_gyro_max_hz;      // cutoff at full throttle or fast motors
+    uint8_t  dyn_lpf_source;           // what both the gyro and the dterm dynamic lowpass follow
 
     uint8_t  yaw_spin_recovery;
     int16_t  yaw_spin_threshold;
 
-    uint16_t gyroCalibrationDuration;  // Gyro calibration duration in 1/100 second
+    uint16_t gyroCalibrationDuration;  // Longest gyro calibration in 1/100 second, it ends earlier once the zero is settled
     uint8_t dyn_notch_axis;
     uint16_t dyn_notch_q;
     uint8_t dyn_notch_count;
     uint16_t dyn_notch_min_hz;
     uint16_t dyn_notch_max_hz;
+    uint8_t dyn_notch_task;            // run the dynamic notch analysis in its own task instead of the gyro loop
 #if defined(USE_GYRO_IMUF9001)
     uint16_t imuf_mode;
     uint16_t imuf_rate;
@@ -176,6 +194,8 @@ typedef struct gyroConfig_s {
     uint8_t smithPredictorDelay;
     uint8_t smithPredictorFilterHz;
 
+    uint8_t gyro_fifo_batch;                   // gyro samples drained from the sensor fifo per gyro task run
+
     //MSP 1.54
     uint16_t gyroSampleRateHz;
     //End MSP 1.54
@@ -186,20 +206,57 @@ PG_DECLARE(gyroConfig_t, gyroConfig);
 bool gyroInit(void);
 
 void gyroInitFilters(void);
+#ifdef USE_FILTER_RETUNE
+bool gyroRetuneFilters(void);
+#endif
 
 #ifdef USE_DMA_SPI_DEVICE
 void gyroDmaSpiFinishRead(void);
 void gyroDmaSpiStartRead(void);
 #endif
 void gyroUpdate(timeUs_t currentTimeUs);
+uint32_t gyroTaskLooptime(void);
+#ifdef USE_GYRO_SPI_DMA
+void gyroInitSpiDma(void);
+#endif
+#ifdef USE_GYRO_PID_INTERRUPT
+bool gyroSetSpiDmaSampleHandler(void (*fn)(void));
+#endif
+#ifdef USE_CYCLE_BENCH
+void gyroFilterBenchmark(void);
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+void gyroDynNotchUpdate(timeUs_t currentTimeUs);
+#endif
+#ifdef USE_GYRO_ACC_BURST
+struct accDev_s;
+bool gyroInitAccBurst(struct accDev_s *acc);
+#endif
 bool gyroGetAverage(quaternion *vAverage);
 const busDevice_t *gyroSensorBus(void);
+bool gyroHasDataReadyInterrupt(void);
+#ifdef USE_DSHOT_OUTPUT_ALIGN
+timeUs_t gyroSampleTimeUs(void);
+#endif
 struct mpuConfiguration_s;
 const struct mpuConfiguration_s *gyroMpuConfiguration(void);
 struct mpuDetectionResult_s;
 const struct mpuDetectionResult_s *gyroMpuDetectionResult(void);
+#ifdef USE_GYRO_CAPTURE
+struct ringBuffer_s;
+void gyroCaptureStart(struct ringBuffer_s *ring);
+void gyroCaptureStop(void);
+uint32_t gyroCaptureDropped(void);
+float gyroCaptureScale(void);
+#endif
 void gyroStartCalibration(bool isFirstArmingCalibration);
 bool isFirstArmingGyroCalibrationRunning(void);
+#ifdef USE_WARM_BOOT
+// gyroSensor1 and gyroSensor2, the second is left alone without USE_DUAL_GYRO
+#define GYRO_ZERO_COUNT 2
+void gyroGetCalibratedZero(float zero[GYRO_ZERO_COUNT][XYZ_AXIS_COUNT]);
+void gyroSetCalibratedZero(const float zero[GYRO_ZERO_COUNT][XYZ_AXIS_COUNT]);
+#endif
 bool isGyroCalibrationComplete(void);
 void gyroReadTemperature(void);
 int16_t gyroGetTemperature(void);
@@ -208,10 +265,13 @@ bool gyroOverflowDetected(void);
 bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
 uint8_t gyroReadRegister(uint8_t whichSensor, uint8_t reg);
-float applySmithPredictor(smithPredictor_t *smithPredictor, float gyroFiltered);
 #ifdef USE_GYRO_DATA_ANALYSE
 bool isDynamicFilterActive(void);
 #endif
+#ifdef USE_DYN_LPF
+bool gyroDynLpfEnabled(void);
+void gyroDynLpfUpdate(uint16_t cutoffHz);
+#endif
 #ifdef USE_YAW_SPIN_RECOVERY
 void initYawSpinRecovery(int maxYawRate);
 #endif
@@ -18,8 +18,11 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+// The includer selects the stages: GYRO_FILTER_LOWPASS/LOWPASS2 expand to a lowpass call and the
+// *_ACTIVE conditions are either runtime checks or constants the compiler folds away.
 static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(gyroSensor_t *gyroSensor) {
     DEBUG_SET(DEBUG_KALMAN, 0, gyroSensor->gyroDev.gyroADC[X] * gyroSensor->gyroDev.scale); //Gyro input
+    float gyroADCfAxis[XYZ_AXIS_COUNT];
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_RAW, axis, gyroSensor->gyroDev.gyroADCRaw[axis] * gyroSensor->gyroDev.scale);
         // scale gyro output to degrees per second
@@ -30,39 +33,68 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(gyroSensor_t *gyroSensor) {
 #endif
         // DEBUG_GYRO_SCALED records the unfiltered, scaled gyro output
         GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCf));
+        gyroADCfAxis[axis] = gyroADCf;
+    }
 
 #ifndef USE_GYRO_IMUF9001
-        gyroADCf = kalman_update(gyroADCf, axis);
+    kalman_update_x3(gyroADCfAxis);
 #endif
 
-        // apply static notch filters and software lowpass filters
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float gyroADCf = gyroADCfAxis[axis];
+        // apply software lowpass filters
 #ifdef USE_GYRO_LPF2
-        gyroADCf = gyroSensor->lowpass2FilterApplyFn((filter_t *)&gyroSensor->lowpass2Filter[axis], gyroADCf);
+        gyroADCf = GYRO_FILTER_LOWPASS2(gyroSensor->lowpass2FilterKind, &gyroSensor->lowpass2Filter[axis], gyroADCf);
+#endif
+        gyroADCfAxis[axis] = GYRO_FILTER_LOWPASS(gyroSensor->lowpassFilterKind, &gyroSensor->lowpassFilter[axis], gyroADCf);
+    }
+
+    // apply static notch filters, all three axes in one pass
+    if (GYRO_FILTER_NOTCH1_ACTIVE) {
+        biquadFilterApplyX3(&gyroSensor->notchFilter1, gyroADCfAxis);
+    }
+    if (GYRO_FILTER_NOTCH2_ACTIVE) {
+        biquadFilterApplyX3(&gyroSensor->notchFilter2, gyroADCfAxis);
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float gyroADCf = gyroADCfAxis[axis];
+#ifdef USE_RPM_FILTER
+        gyroADCf = rpmFilterGyro(axis, gyroADCf);
 #endif
-        gyroADCf = gyroSensor->lowpassFilterApplyFn((filter_t *)&gyroSensor->lowpassFilter[axis], gyroADCf);
-        gyroADCf = gyroSensor->notchFilter1ApplyFn((filter_t *)&gyroSensor->notchFilter1[axis], gyroADCf);
-        gyroADCf = gyroSensor->notchFilter2ApplyFn((filter_t *)&gyroSensor->notchFilter2[axis], gyroADCf);
 #ifdef USE_GYRO_DATA_ANALYSE
-        if (isDynamicFilterActive()) {
+        if (GYRO_FILTER_DYN_NOTCH_ACTIVE) {
           if (axis == X) {
               GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 0, lrintf(gyroADCf));
               GYRO_FILTER_DEBUG_SET(DEBUG_FFT_FREQ, 3, lrintf(gyroADCf));
           }
 
           gyroDataAnalysePush(&gyroSensor->gyroAnalyseState, axis, gyroADCf);
-          for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
-              gyroADCf = gyroSensor->notchFilterDynApplyFn((filter_t *)&gyroSensor->gyroAnalyseState.notchFilterDyn[axis][p], gyroADCf);
-          }
+          // must be DF1, the coefficients change at runtime
+          gyroADCf = biquadFilterCascadeApplyDF1(gyroSensor->gyroAnalyseState.notchFilterDyn[axis], gyroRuntime.dynNotchCount, gyroADCf);
             if (axis == X) {
                 GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 1, lrintf(gyroADCf)); // store data after dynamic notch
             }
         }
 #endif
+        gyroADCfAxis[axis] = gyroADCf;
+    }
 
 #ifndef USE_GYRO_IMUF9001
-        update_kalman_covariance(gyroADCf, axis);
+    update_kalman_covariance_x3(gyroADCfAxis);
+#endif
+    // the ABG filter follows the notches, all three axes in one pass
+    if (GYRO_FILTER_ABG_ACTIVE) {
+        alphaBetaGammaApplyX3(&gyroSensor->gyroABGFilter, gyroADCfAxis);
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float gyroADCf = gyroADCfAxis[axis];
+#ifdef USE_SMITH_PREDICTOR
+        if (GYRO_FILTER_SMITH_ACTIVE) {
+            gyroADCf = applySmithPredictor(&gyroSensor->smithPredictor[axis], gyroADCf);
+        }
 #endif
-        applySmithPredictor(gyroSensor->smithPredictor, gyroADCf);
 
 #ifdef USE_GYRO_IMUF9001
         // DEBUG_GYRO_FILTERED records the scaled, filtered, after all software filtering has been applied.
@@ -74,3 +106,13 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(gyroSensor_t *gyroSensor) {
         gyroSensor->gyroDev.gyroADCf[axis] = gyroADCf;
     }
 }
+
+#undef GYRO_FILTER_FUNCTION_NAME
+#undef GYRO_FILTER_DEBUG_SET
+#undef GYRO_FILTER_LOWPASS
+#undef GYRO_FILTER_LOWPASS2
+#undef GYRO_FILTER_NOTCH1_ACTIVE
+#undef GYRO_FILTER_NOTCH2_ACTIVE
+#undef GYRO_FILTER_DYN_NOTCH_ACTIVE
+#undef GYRO_FILTER_SMITH_ACTIVE
+#undef GYRO_FILTER_ABG_ACTIVE
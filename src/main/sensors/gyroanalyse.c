@@ -30,10 +30,13 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #ifdef USE_GYRO_DATA_ANALYSE
+#include "build/atomic.h"
+#include "build/cycle_profile.h"
 #include "build/debug.h"
 
 #include "common/filter.h"
@@ -43,6 +46,7 @@
 #include "common/utils.h"
 
 #include "drivers/accgyro/accgyro.h"
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "sensors/gyro.h"
@@ -85,6 +89,8 @@
 #define DYN_NOTCH_SMOOTH_HZ        4
 #define DYN_NOTCH_CALC_TICKS       (XYZ_AXIS_COUNT * STEP_COUNT) // 3 axes and 4 steps per axis
 #define DYN_NOTCH_OSD_MIN_THROTTLE 20
+#define DYN_NOTCH_TRACK_BINS       2  // bins either side of a previous peak searched by the peak tracker
+#define DYN_NOTCH_FULL_SEARCH_INTERVAL 8  // tracked searches on an axis between two full searches
 
 typedef enum {
 
@@ -96,6 +102,8 @@ typedef enum {
 
 } step_e;
 
+STATIC_ASSERT(STEP_COUNT == DYN_NOTCH_STEP_COUNT, dyn_notch_step_count_mismatch);
+
 typedef struct peak_s {
 
     uint8_t bin;
@@ -111,14 +119,29 @@ static float FAST_RAM_ZERO_INIT      sdftResolutionHz;
 static uint8_t FAST_RAM_ZERO_INIT    sdftStartBin;
 static uint8_t FAST_RAM_ZERO_INIT    sdftEndBin;
 static float FAST_RAM_ZERO_INIT      sdftMeanSq;
-static uint16_t FAST_RAM_ZERO_INIT   dynNotchQ;
+static float FAST_RAM_ZERO_INIT      dynNotchQ;
 static uint16_t FAST_RAM_ZERO_INIT   dynNotchMinHz;
 static uint16_t FAST_RAM_ZERO_INIT   dynNotchMaxHz;
 static uint16_t FAST_RAM_ZERO_INIT   dynNotchMaxFFT;
+static uint8_t FAST_RAM_ZERO_INIT    dynNotchCount;
 static float FAST_RAM_ZERO_INIT      smoothFactor;
 static uint8_t FAST_RAM_ZERO_INIT    numSamples;
 static float FAST_RAM_ZERO_INIT      centerFreq[3][5];
 
+// dyn_notch_task: the analysis runs in TASK_DYN_NOTCH on a copy of the bins, the gyro path only pushes samples
+static bool FAST_RAM_ZERO_INIT       dynNotchInTask;
+static volatile uint32_t FAST_RAM_ZERO_INIT sdftPushSequence; // odd while the gyro path is updating the bins
+static sdftComplex_t                 sdftBins[SDFT_BIN_COUNT];
+// The windowed bins of an axis are copied here on the next analysis of that axis after getGyroSpectrum() asked for them
+static float                         spectrumData[XYZ_AXIS_COUNT][SDFT_BIN_COUNT];
+static volatile bool                 spectrumWanted[XYZ_AXIS_COUNT];
+
+// D-term notches follow the gyro notches, their coefficients are published here whenever a gyro notch moves
+static biquadFilter_t FAST_RAM_ZERO_INIT dtermNotchCoeffs[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX]; // only b0..a2 are used
+static uint8_t FAST_RAM_ZERO_INIT    dtermNotchUpdateCount[XYZ_AXIS_COUNT];
+static float FAST_RAM_ZERO_INIT      dtermNotchQ;
+static uint32_t FAST_RAM_ZERO_INIT   dtermNotchLooptimeUs;
+
 void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
 {
 #ifdef USE_MULTI_GYRO
@@ -129,6 +152,8 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     gyroAnalyseInitialized = true;
 #endif
 
+    dynNotchInTask = gyroConfig()->dyn_notch_task;
+    dynNotchCount = gyroConfig()->dyn_notch_count;
     dynNotchQ = gyroConfig()->dyn_notch_q / 100.0f;
     dynNotchMinHz = gyroConfig()->dyn_notch_min_hz;
     dynNotchMaxHz = MAX(2 * dynNotchMinHz, gyroConfig()->dyn_notch_max_hz);
@@ -163,10 +188,13 @@ void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptime
     state->maxSampleCountRcp = 1.0f / state->maxSampleCount;
 
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+        for (int p = 0; p < dynNotchCount; p++) {
             // any init value is fine, but evenly spreading centerFreqs across frequency range makes notch filters stick to peaks quicker
-            state->centerFreq[axis][p] = (p + 0.5f) * (dynNotchMaxHz - dynNotchMinHz) / (float)gyroConfig()->dyn_notch_count + dynNotchMinHz;
+            state->centerFreq[axis][p] = (p + 0.5f) * (dynNotchMaxHz - dynNotchMinHz) / (float)dynNotchCount + dynNotchMinHz;
+            state->notchFreqStep[axis][p] = 0;
+            state->peakBin[axis][p] = 0;
         }
+        state->fullSearchCountdown[axis] = 0;
     }
 }
 
@@ -178,6 +206,62 @@ void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float
 
 static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state);
 
+// Called from STEP_UPDATE_FILTERS right after the gyro notch got new coefficients
+static void dtermNotchUpdate(int axis, int peak, const biquadFilter_t *gyroNotch, float notchFreq)
+{
+    if (!dtermNotchLooptimeUs) {
+        return;
+    }
+    if (dtermNotchQ == dynNotchQ && dtermNotchLooptimeUs == gyro.targetLooptime) {
+        // same Q at the same rate, the gyro coefficients are the D-term coefficients
+        biquadFilterCopyCoeffs(&dtermNotchCoeffs[axis][peak], gyroNotch);
+    } else {
+        biquadFilterUpdate(&dtermNotchCoeffs[axis][peak], notchFreq, dtermNotchLooptimeUs, dtermNotchQ, FILTER_NOTCH);
+    }
+    dtermNotchUpdateCount[axis]++;
+}
+
+// Q of 0 stops publishing D-term coefficients
+void gyroDataAnalyseSetDtermNotch(float q, uint32_t looptimeUs)
+{
+    dtermNotchQ = q;
+    dtermNotchLooptimeUs = q > 0 ? looptimeUs : 0;
+    if (!dtermNotchLooptimeUs) {
+        return;
+    }
+    // start from where the gyro notches currently are, so a profile change doesn't wait for the next peak movement
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int p = 0; p < DYN_NOTCH_COUNT_MAX; p++) {
+            const float notchFreq = centerFreq[axis][p] > 0 ? centerFreq[axis][p] : 400;
+            biquadFilterUpdate(&dtermNotchCoeffs[axis][p], notchFreq, dtermNotchLooptimeUs, dtermNotchQ, FILTER_NOTCH);
+        }
+        dtermNotchUpdateCount[axis]++;
+    }
+}
+
+uint8_t getDtermNotchUpdateCount(int axis)
+{
+    return dtermNotchUpdateCount[axis];
+}
+
+void getDtermNotchCoeffs(int axis, biquadFilter_t *filters, int count)
+{
+    for (int p = 0; p < count; p++) {
+        biquadFilterCopyCoeffs(&filters[p], &dtermNotchCoeffs[axis][p]);
+    }
+}
+
+// bits lowBin to highBin, clipped to the bins that have a neighbour on both sides
+static FAST_CODE uint64_t dynNotchBinMask(int lowBin, int highBin)
+{
+    lowBin = MAX(lowBin, sdftStartBin + 1);
+    highBin = MIN(highBin, sdftEndBin - 1);
+    if (lowBin > highBin) {
+        return 0;
+    }
+    return (2ULL << highBin) - (1ULL << lowBin);
+}
+
 // Downsample and analyse gyro data
 FAST_CODE void gyroDataAnalyse(gyroAnalyseState_t *state)
 {
@@ -205,33 +289,56 @@ FAST_CODE void gyroDataAnalyse(gyroAnalyseState_t *state)
 
     // 2us @ F722
     // SDFT processing in batches to synchronize with incoming downsampled data
+    sdftPushSequence++;
+    asm volatile ("": : :"memory"); // compiler memory barrier
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         sdftPushBatch(&sdft[axis], &state->downsampledGyroData[axis], &state->sampleCount);
     }
+    asm volatile ("": : :"memory"); // compiler memory barrier
+    sdftPushSequence++;
     state->sampleCount++;
 
-    // Find frequency peaks and update filters
-    if (state->updateTicks > 0) {
+    // Find frequency peaks and update filters, unless TASK_DYN_NOTCH does it
+    if (!dynNotchInTask && state->updateTicks > 0) {
         gyroDataAnalyseUpdate(state);
         --state->updateTicks;
     }
 }
 
-// Find frequency peaks and update filters
-static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
+// TASK_DYN_NOTCH, runs all steps for the next axis
+void gyroDataAnalyseTask(gyroAnalyseState_t *state)
 {
-    uint32_t startTime = 0;
-    if (debugMode == (DEBUG_FFT_TIME)) {
-        startTime = micros();
+    for (int step = 0; step < STEP_COUNT; step++) {
+        gyroDataAnalyseUpdate(state);
     }
+}
 
-    DEBUG_SET(DEBUG_FFT_TIME, 0, state->updateStep);
+// Copies the bins of one axis, retrying if the gyro path pushed a sample meanwhile
+static void sdftSnapshotBins(const sdft_t *sdftAxis)
+{
+    uint32_t sequence;
+    do {
+        sequence = sdftPushSequence;
+        asm volatile ("": : :"memory"); // compiler memory barrier
+        sdftCopyBins(sdftAxis, sdftBins);
+        asm volatile ("": : :"memory"); // compiler memory barrier
+    } while ((sequence & 1) || sequence != sdftPushSequence);
+}
 
+// Find frequency peaks and update filters
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
+{
     switch (state->updateStep) {
 
         case STEP_WINDOW: // 6us @ F722
         {
-            sdftWinSq(&sdft[state->updateAxis], sdftData);
+            CYCLE_SECTION_BEGIN(FFT_WINDOW);
+            if (dynNotchInTask) {
+                sdftSnapshotBins(&sdft[state->updateAxis]);
+                sdftWinSqBins(&sdft[state->updateAxis], sdftBins, sdftData);
+            } else {
+                sdftWinSq(&sdft[state->updateAxis], sdftData);
+            }
 
             // Calculate mean square over frequency range (= average power of vibrations)
             sdftMeanSq = 0.0f;
@@ -240,27 +347,56 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
             }
             sdftMeanSq /= sdftEndBin - sdftStartBin - 1;
 
-            DEBUG_SET(DEBUG_FFT_TIME, 0, micros() - startTime);
+            if (spectrumWanted[state->updateAxis]) {
+                memcpy(spectrumData[state->updateAxis], sdftData, sizeof(sdftData));
+                spectrumWanted[state->updateAxis] = false;
+            }
+
+            CYCLE_SECTION_END(FFT_WINDOW);
 
             break;
         }
         case STEP_DETECT_PEAKS: // 6us @ F722
         {
+            CYCLE_SECTION_BEGIN(FFT_DETECT);
             // Get memory ready for new peak data on current axis
-            for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+            for (int p = 0; p < dynNotchCount; p++) {
                 peaks[p].bin = 0;
                 peaks[p].value = 0.0f;
             }
 
-            // Search for N biggest peaks in frequency spectrum
-            for (int bin = (sdftStartBin + 1); bin < sdftEndBin; bin++) {
+            // Search for N biggest peaks, only around the peaks of the last update unless a full search is due
+            const int axis = state->updateAxis;
+            uint64_t searchBins = 0;
+            int trackedPeaks = 0;
+            if (state->fullSearchCountdown[axis] > 0) {
+                state->fullSearchCountdown[axis]--;
+                for (int p = 0; p < dynNotchCount; p++) {
+                    const int bin = state->peakBin[axis][p];
+                    if (bin != 0) {
+                        searchBins |= dynNotchBinMask(bin - DYN_NOTCH_TRACK_BINS, bin + DYN_NOTCH_TRACK_BINS);
+                        trackedPeaks++;
+                    }
+                }
+            }
+            if (trackedPeaks < dynNotchCount) {
+                // some notch has no peak to follow, look at the whole spectrum for one
+                searchBins = dynNotchBinMask(sdftStartBin + 1, sdftEndBin - 1);
+                state->fullSearchCountdown[axis] = DYN_NOTCH_FULL_SEARCH_INTERVAL;
+                trackedPeaks = 0;
+            }
+
+            int foundPeaks = 0;
+            while (searchBins) {
+                const int bin = __builtin_ctzll(searchBins);
+                searchBins &= searchBins - 1;
                 // Check if bin is peak
                 if ((sdftData[bin] > sdftData[bin - 1]) && (sdftData[bin] > sdftData[bin + 1])) {
                     // Check if peak is big enough to be one of N biggest peaks.
                     // If so, insert peak and sort peaks in descending height order
-                    for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+                    for (int p = 0; p < dynNotchCount; p++) {
                         if (sdftData[bin] > peaks[p].value) {
-                            for (int k = gyroConfig()->dyn_notch_count - 1; k > p; k--) {
+                            for (int k = dynNotchCount - 1; k > p; k--) {
                                 peaks[k] = peaks[k - 1];
                             }
                             peaks[p].bin = bin;
@@ -268,12 +404,17 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
                             break;
                         }
                     }
-                    bin++; // If bin is peak, next bin can't be peak => jump it
+                    foundPeaks++;
+                    searchBins &= ~(1ULL << (bin + 1)); // If bin is peak, next bin can't be peak => jump it
                 }
             }
+            if (foundPeaks < trackedPeaks) {
+                // a tracked peak got lost, search everything next time
+                state->fullSearchCountdown[axis] = 0;
+            }
 
             // Sort N biggest peaks in ascending bin order (example: 3, 8, 25, 0, 0, ..., 0)
-            for (int p = gyroConfig()->dyn_notch_count - 1; p > 0; p--) {
+            for (int p = dynNotchCount - 1; p > 0; p--) {
                 for (int k = 0; k < p; k++) {
                     // Swap peaks but ignore swapping void peaks (bin = 0). This leaves
                     // void peaks at the end of peaks array without moving them
@@ -285,84 +426,85 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
                 }
             }
 
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            for (int p = 0; p < dynNotchCount; p++) {
+                state->peakBin[axis][p] = peaks[p].bin;
+            }
+
+            CYCLE_SECTION_END(FFT_DETECT);
 
             break;
         }
         case STEP_CALC_FREQUENCIES: // 4us @ F722
         {
-            for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+            CYCLE_SECTION_BEGIN(FFT_CALC);
+            for (int p = 0; p < dynNotchCount; p++) {
 
                 if (peaks[p].bin != 0) {
 
-                    // accumulate sdftSum and sdftWeightedSum from peak bin, and shoulder bins either side of peak
-                    float squaredData = peaks[p].value; // peak data already squared (see sdftWinSq)
-                    float sdftSum = squaredData;
-                    float sdftWeightedSum = squaredData * peaks[p].bin;
-
-                    // accumulate upper shoulder unless it would be sdftEndBin
-                    int shoulderBin = peaks[p].bin + 1;
-                    if (shoulderBin < sdftEndBin) {
-                        squaredData = sdftData[shoulderBin]; // sdftData already squared (see sdftWinSq)
-                        sdftSum += squaredData;
-                        sdftWeightedSum += squaredData * shoulderBin  * 1.25;
-                    }
-
-                    // accumulate lower shoulder unless lower shoulder would be bin 0 (DC)
-                    if (peaks[p].bin > 1) {
-                        shoulderBin = peaks[p].bin - 1;
-                        squaredData = sdftData[shoulderBin]; // sdftData already squared (see sdftWinSq)
-                        sdftSum += squaredData;
-                        sdftWeightedSum += squaredData * shoulderBin * 0.95;
-                    }
-
-                    // get centerFreq in Hz from weighted bins
-                    float centerFreq = dynNotchMaxHz;
-
-                    if (sdftSum > 0) {
-                        // Height of peak bin (y1) and shoulder bins (y0, y2)
-                        float sdftMeanBin = (sdftWeightedSum / sdftSum);
-                        centerFreq = sdftMeanBin * sdftResolutionHz;
-                        
-                        centerFreq = constrainf(centerFreq, dynNotchMinHz, dynNotchMaxHz);
-                        // In theory, the index points to the centre frequency of the bin.
-                        // at 1333hz, bin widths are 13.3Hz, so bin 2 (26.7Hz) has the range 20Hz to 33.3Hz
-
-                        // PT1 style dynamic smoothing moves rapidly towards big peaks and slowly away, up to 8x faster
-                        // DYN_NOTCH_SMOOTH_HZ = 8 & dynamicFactor = 1 .. 5  =>  PT1 -3dB cutoff frequency = 4Hz .. 40Hz
-                        const float dynamicFactor = constrainf(peaks[p].value / sdftMeanSq, 1.0f, 8.0f);
-                        state->centerFreq[state->updateAxis][p] += smoothFactor * dynamicFactor * (centerFreq - state->centerFreq[state->updateAxis][p]);
-                    }
+                    // parabolic interpolation over the magnitudes of the peak bin and its neighbours, which
+                    // always exist because peaks are only searched between sdftStartBin and sdftEndBin
+                    const int bin = peaks[p].bin;
+                    const float y0 = sqrtf(sdftData[bin - 1]); // sdftData already squared (see sdftWinSq)
+                    const float y1 = sqrtf(peaks[p].value);
+                    const float y2 = sqrtf(sdftData[bin + 1]);
+                    const float denom = y0 - 2.0f * y1 + y2;
+                    // y1 is bigger than both neighbours, so denom < 0 and the offset stays within half a bin
+                    const float binOffset = denom < 0.0f ? 0.5f * (y0 - y2) / denom : 0.0f;
+
+                    // get centerFreq in Hz from the interpolated bin
+                    // at 1333hz, bin widths are 13.3Hz, so bin 2 (26.7Hz) has the range 20Hz to 33.3Hz
+                    const float centerFreq = constrainf((bin + binOffset) * sdftResolutionHz, dynNotchMinHz, dynNotchMaxHz);
+
+                    // PT1 style dynamic smoothing moves rapidly towards big peaks and slowly away, up to 8x faster
+                    // DYN_NOTCH_SMOOTH_HZ = 8 & dynamicFactor = 1 .. 5  =>  PT1 -3dB cutoff frequency = 4Hz .. 40Hz
+                    const float dynamicFactor = constrainf(peaks[p].value / sdftMeanSq, 1.0f, 8.0f);
+                    state->centerFreq[state->updateAxis][p] += smoothFactor * dynamicFactor * (centerFreq - state->centerFreq[state->updateAxis][p]);
                 }
             }
 
             if(calculateThrottlePercentAbs() > DYN_NOTCH_OSD_MIN_THROTTLE) {
-                for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+                for (int p = 0; p < dynNotchCount; p++) {
                     dynNotchMaxFFT = MAX(dynNotchMaxFFT, state->centerFreq[state->updateAxis][p]);
                 }
             }
 
             if (state->updateAxis == X) {
-                for (int p = 0; p < gyroConfig()->dyn_notch_count && p < 3; p++) {
+                for (int p = 0; p < dynNotchCount && p < 3; p++) {
                     DEBUG_SET(DEBUG_FFT_FREQ, p, lrintf(state->centerFreq[state->updateAxis][p]));
                 }
             }
 
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            CYCLE_SECTION_END(FFT_CALC);
 
             break;
         }
         case STEP_UPDATE_FILTERS: // 7us @ F722
         {
-            for (int p = 0; p < gyroConfig()->dyn_notch_count; p++) {
+            CYCLE_SECTION_BEGIN(FFT_UPDATE);
+            for (int p = 0; p < dynNotchCount; p++) {
                 // Only update notch filter coefficients if the corresponding peak got its center frequency updated in the previous step
                 if (peaks[p].bin != 0 && peaks[p].value > sdftMeanSq) {
-                    biquadFilterUpdate(&state->notchFilterDyn[state->updateAxis][p], state->centerFreq[state->updateAxis][p], gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
+                    // Q is fixed after init, so the quantised frequency identifies the coefficients and steady peaks skip the trig
+                    const uint16_t freqStep = lrintf(state->centerFreq[state->updateAxis][p] / DYN_NOTCH_FREQ_STEP_HZ);
+                    if (freqStep != state->notchFreqStep[state->updateAxis][p]) {
+                        if (dynNotchInTask) {
+                            // the gyro path may interrupt the task, so it must never see half updated coefficients
+                            biquadFilter_t notch;
+                            biquadFilterUpdate(&notch, freqStep * DYN_NOTCH_FREQ_STEP_HZ, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
+                            ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+                                biquadFilterCopyCoeffs(&state->notchFilterDyn[state->updateAxis][p], &notch);
+                            }
+                        } else {
+                            biquadFilterUpdate(&state->notchFilterDyn[state->updateAxis][p], freqStep * DYN_NOTCH_FREQ_STEP_HZ, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
+                        }
+                        state->notchFreqStep[state->updateAxis][p] = freqStep;
+                        dtermNotchUpdate(state->updateAxis, p, &state->notchFilterDyn[state->updateAxis][p], freqStep * DYN_NOTCH_FREQ_STEP_HZ);
+                    }
                     centerFreq[state->updateAxis][p] = state->centerFreq[state->updateAxis][p];
                 }
             }
 
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            CYCLE_SECTION_END(FFT_UPDATE);
 
             state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
         }
@@ -372,6 +514,10 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
 }
 
 
+bool isDynNotchInTask(void) {
+    return dynNotchInTask;
+}
+
 uint16_t getMaxFFT(void) {
     return dynNotchMaxFFT;
 }
@@ -384,4 +530,31 @@ float getCenterFreq(int axis, int peak) {
     return centerFreq[axis][peak];
 }
 
+const gyroSpectrum_t *getGyroSpectrum(void) {
+    static gyroSpectrum_t spectrum;
+    // the same bins as the peak search, the first and last one are not windowed properly
+    const int firstBin = sdftStartBin + 1;
+    const int binCount = MAX(sdftEndBin - firstBin, 0);
+    // keep the highest of the merged bins, so peaks stay as high as the notches see them
+    const int merge = MAX((binCount + GYRO_SPECTRUM_BIN_COUNT - 1) / GYRO_SPECTRUM_BIN_COUNT, 1);
+    spectrum.binCount = (binCount + merge - 1) / merge;
+    spectrum.binWidthHz = merge * sdftResolutionHz;
+    spectrum.firstBinHz = (firstBin + 0.5f * (merge - 1)) * sdftResolutionHz;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (spectrumWanted[axis]) {
+            // not analysed since the last call, the previous values stay
+            continue;
+        }
+        for (int i = 0; i < spectrum.binCount; i++) {
+            float power = 0.0f;
+            for (int bin = firstBin + i * merge; bin < MIN(firstBin + (i + 1) * merge, sdftEndBin); bin++) {
+                power = MAX(power, spectrumData[axis][bin]);
+            }
+            spectrum.power[axis][i] = power > 1.0f ? constrainf(20.0f * log10f(power), 0.0f, 255.0f) : 0;
+        }
+        spectrumWanted[axis] = true;
+    }
+    return &spectrum;
+}
+
 #endif // USE_GYRO_DATA_ANALYSE
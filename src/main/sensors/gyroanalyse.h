@@ -21,6 +21,17 @@
 #pragma once
 
 #define DYN_NOTCH_COUNT_MAX 5
+#define DYN_NOTCH_STEP_COUNT 4     // window, detect peaks, calc frequencies and update filters, per axis
+#define DYN_NOTCH_FREQ_STEP_HZ 0.5f  // notch coefficients are only recalculated when the center frequency moves by a step
+#define GYRO_SPECTRUM_BIN_COUNT 32   // the analysed range is merged into at most this many bins per axis
+
+// Power spectrum of each axis as found by the last analysis, for live viewing
+typedef struct gyroSpectrum_s {
+    float firstBinHz;      // center of the first bin
+    float binWidthHz;
+    uint8_t binCount;
+    uint8_t power[XYZ_AXIS_COUNT][GYRO_SPECTRUM_BIN_COUNT];   // half dB steps above a power of 1
+} gyroSpectrum_t;
 
 typedef struct gyroAnalyseState_s {
 
@@ -39,13 +50,24 @@ typedef struct gyroAnalyseState_s {
     uint8_t updateAxis;
 
     float centerFreq[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
-    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][5];
+    uint16_t notchFreqStep[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];   // quantised center frequency the coefficients were calculated for, 0 if none
+    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
+
+    // peak tracking, the bins found by the last search are searched first
+    uint8_t peakBin[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
+    uint8_t fullSearchCountdown[XYZ_AXIS_COUNT];
 
 } gyroAnalyseState_t;
 
 void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptimeUs);
 void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float sample);
 void gyroDataAnalyse(gyroAnalyseState_t *state);
+void gyroDataAnalyseTask(gyroAnalyseState_t *state);
+bool isDynNotchInTask(void);
 uint16_t getMaxFFT(void);
 void resetMaxFFT(void);
 float getCenterFreq(int axis, int peak);
+const gyroSpectrum_t *getGyroSpectrum(void);
+void gyroDataAnalyseSetDtermNotch(float q, uint32_t looptimeUs);
+uint8_t getDtermNotchUpdateCount(int axis);
+void getDtermNotchCoeffs(int axis, biquadFilter_t *filters, int count);
@@ -30,7 +30,9 @@
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
+#include "drivers/time.h"
 #include "fc/config.h"
+#include "fc/fc_init.h"
 #include "fc/runtime_config.h"
 
 #include "sensors/sensors.h"
@@ -52,12 +54,15 @@ bool sensorsAutodetect(void) {
     if (gyroDetected) {
         accInit();
     }
+    initStepTimeUs[INIT_STEP_GYRO] = micros();
 #ifdef USE_MAG
     compassInit();
 #endif
+    initStepTimeUs[INIT_STEP_MAG] = micros();
 #ifdef USE_BARO
     baroDetect(&baro.dev, barometerConfig()->baro_hardware);
 #endif
+    initStepTimeUs[INIT_STEP_BARO] = micros();
 #ifdef USE_RANGEFINDER
     rangefinderInit();
 #endif
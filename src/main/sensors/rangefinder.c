@@ -238,6 +238,14 @@ static int16_t computePseudoSnr(int32_t newReading) {
  * This is called periodically by the scheduler
  */
 // XXX Returns timeDelta_t for iNav for pseudo-RT scheduling.
+bool rangefinderUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs) {
+    UNUSED(currentTimeUs);
+    if (rangefinder.dev.isDataReady) {
+        return rangefinder.dev.isDataReady(&rangefinder.dev);
+    }
+    return currentDeltaTimeUs >= (timeDelta_t)(rangefinder.dev.delayMs * 1000);
+}
+
 void rangefinderUpdate(timeUs_t currentTimeUs) {
     UNUSED(currentTimeUs);
     if (rangefinder.dev.update) {
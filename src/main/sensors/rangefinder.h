@@ -64,6 +64,7 @@ bool rangefinderInit(void);
 int32_t rangefinderGetLatestAltitude(void);
 int32_t rangefinderGetLatestRawAltitude(void);
 
+bool rangefinderUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void rangefinderUpdate(timeUs_t currentTimeUs);
 bool rangefinderProcess(float cosTiltAngle);
 bool rangefinderIsHealthy(void);
@@ -174,6 +174,16 @@ void voltageMeterADCRead(voltageSensorADC_e adcChannel, voltageMeter_t *voltageM
     voltageMeter->unfiltered = state->voltageUnfiltered;
 }
 
+// converts the ADC as of its last scan on demand, for callers that want the voltage sag every loop
+uint16_t voltageMeterADCSample(voltageSensorADC_e adcChannel) {
+#ifdef USE_ADC
+    return voltageAdcToVoltage(adcGetChannel(voltageMeterAdcChannelMap[adcChannel]), voltageSensorADCConfig(adcChannel));
+#else
+    UNUSED(adcChannel);
+    return 0;
+#endif
+}
+
 void voltageMeterADCInit(void) {
     for (uint8_t i = 0; i < MAX_VOLTAGE_SENSOR_ADC; i++) {
         // store the battery voltage with some other recent battery voltage readings
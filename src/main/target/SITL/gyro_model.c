@@ -0,0 +1,224 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "gyro_model.h"
+
+typedef struct gyroModelConfig_s {
+    uint32_t odrHz;
+    float motorHz;          // first harmonic of a motor at full throttle
+    float motorDps;         // its amplitude at full throttle, harmonic n has 1/n of it
+    uint8_t harmonics;
+    float frameHz;          // frame resonance, excited by the motors and the white noise
+    float frameDps;
+    float frameQ;
+    float noiseDps;         // white noise rms
+    uint32_t seed;
+} gyroModelConfig_t;
+
+static gyroModelConfig_t config = {
+    .motorHz = 300.0f,
+    .harmonics = 3,
+    .frameHz = 150.0f,
+    .frameQ = 10.0f,
+    .seed = 1,
+};
+
+static pthread_mutex_t inputLock = PTHREAD_MUTEX_INITIALIZER;
+static float bodyRatesDps[XYZ_AXIS_COUNT];
+static float motorSpeed[GYRO_MODEL_MOTOR_COUNT];
+
+static uint64_t sampleUs;
+static uint32_t samplePeriodNs;
+static uint64_t sampleNs;           // sub microsecond part of the sample clock
+static float motorPhase[GYRO_MODEL_MOTOR_COUNT];
+static biquadFilter_t frameFilter[XYZ_AXIS_COUNT];
+static float frameGain;
+static uint32_t randomState;
+
+// how much each motor of a quad X shakes roll, pitch and yaw
+static const float motorCoupling[GYRO_MODEL_MOTOR_COUNT][XYZ_AXIS_COUNT] = {
+    {  1.0f,  1.0f,  0.3f },
+    {  1.0f, -1.0f, -0.3f },
+    { -1.0f,  1.0f, -0.3f },
+    { -1.0f, -1.0f,  0.3f },
+};
+
+// xorshift32, the same seed gives the same noise on every run
+static float randomUniform(void) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState / 4294967296.0f;
+}
+
+// sum of four uniforms, close enough to a unit gaussian for noise
+static float randomGaussian(void) {
+    return (randomUniform() + randomUniform() + randomUniform() + randomUniform() - 2.0f) * 1.7320508f;
+}
+
+static bool parseOption(const char *key, const char *value) {
+    const float number = atof(value);
+    if (strcmp(key, "odr") == 0) {
+        config.odrHz = constrain(atoi(value), 0, GYRO_MODEL_MAX_ODR_HZ);
+    } else if (strcmp(key, "motor_hz") == 0) {
+        config.motorHz = number;
+    } else if (strcmp(key, "motor_dps") == 0) {
+        config.motorDps = number;
+    } else if (strcmp(key, "harmonics") == 0) {
+        config.harmonics = constrain(atoi(value), 1, 8);
+    } else if (strcmp(key, "frame_hz") == 0) {
+        config.frameHz = number;
+    } else if (strcmp(key, "frame_dps") == 0) {
+        config.frameDps = number;
+    } else if (strcmp(key, "frame_q") == 0) {
+        config.frameQ = MAX(number, 0.5f);
+    } else if (strcmp(key, "noise_dps") == 0) {
+        config.noiseDps = number;
+    } else if (strcmp(key, "seed") == 0) {
+        config.seed = MAX(strtoul(value, NULL, 0), 1UL);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// SITL_GYRO_MODEL is a comma separated list of key=value, the model is off unless odr is given
+bool gyroModelInit(void) {
+    const char *env = getenv(GYRO_MODEL_ENV);
+    if (!env) {
+        return false;
+    }
+    char options[256];
+    snprintf(options, sizeof(options), "%s", env);
+    char *context;
+    for (char *option = strtok_r(options, ",", &context); option; option = strtok_r(NULL, ",", &context)) {
+        char *value = strchr(option, '=');
+        if (value) {
+            *value++ = '\0';
+        }
+        if (!value || !parseOption(option, value)) {
+            printf("[gyro model]unknown option '%s'\n", option);
+        }
+    }
+    if (config.odrHz == 0) {
+        return false;
+    }
+    samplePeriodNs = 1000000000 / config.odrHz;
+    randomState = config.seed;
+    const float nyquistHz = config.odrHz / 2.0f;
+    config.frameHz = constrainf(config.frameHz, 1.0f, nyquistHz * 0.9f);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInit(&frameFilter[axis], config.frameHz, samplePeriodNs / 1000, config.frameQ, FILTER_BPF);
+    }
+    // white noise through a unity peak band pass keeps pi * f0 / (Q * odr) of its power
+    frameGain = config.frameDps * sqrtf(config.frameQ * config.odrHz / (M_PIf * config.frameHz));
+    printf("[gyro model]odr %uHz, motors %.0fHz %.1fdps x%u, frame %.0fHz %.1fdps q %.1f, noise %.1fdps\n",
+        config.odrHz, (double)config.motorHz, (double)config.motorDps, config.harmonics,
+        (double)config.frameHz, (double)config.frameDps, (double)config.frameQ, (double)config.noiseDps);
+    return true;
+}
+
+uint32_t gyroModelOdrHz(void) {
+    return config.odrHz;
+}
+
+void gyroModelSetRates(const double ratesDps[3]) {
+    pthread_mutex_lock(&inputLock);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        bodyRatesDps[axis] = ratesDps[axis];
+    }
+    pthread_mutex_unlock(&inputLock);
+}
+
+void gyroModelSetMotors(const float speed[GYRO_MODEL_MOTOR_COUNT]) {
+    pthread_mutex_lock(&inputLock);
+    for (int motor = 0; motor < GYRO_MODEL_MOTOR_COUNT; motor++) {
+        motorSpeed[motor] = constrainf(fabsf(speed[motor]), 0.0f, 1.0f);
+    }
+    pthread_mutex_unlock(&inputLock);
+}
+
+static void gyroModelStep(float ratesDps[3]) {
+    float rates[XYZ_AXIS_COUNT];
+    float speed[GYRO_MODEL_MOTOR_COUNT];
+    pthread_mutex_lock(&inputLock);
+    memcpy(rates, bodyRatesDps, sizeof(rates));
+    memcpy(speed, motorSpeed, sizeof(speed));
+    pthread_mutex_unlock(&inputLock);
+
+    const float dt = samplePeriodNs * 1e-9f;
+    float vibration[XYZ_AXIS_COUNT] = { 0 };
+    for (int motor = 0; motor < GYRO_MODEL_MOTOR_COUNT; motor++) {
+        motorPhase[motor] += 2.0f * M_PIf * config.motorHz * speed[motor] * dt;
+        if (motorPhase[motor] > 2.0f * M_PIf) {
+            motorPhase[motor] -= 2.0f * M_PIf;
+        }
+        // spread the phases so the motors don't all peak together
+        const float phase = motorPhase[motor] + motor * 1.1f;
+        float shake = 0.0f;
+        for (int harmonic = 1; harmonic <= config.harmonics; harmonic++) {
+            shake += sinf(phase * harmonic) / harmonic;
+        }
+        shake *= config.motorDps * speed[motor];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            vibration[axis] += shake * motorCoupling[motor][axis];
+        }
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float frame = biquadFilterApply(&frameFilter[axis], randomGaussian() * frameGain + vibration[axis]);
+        ratesDps[axis] = rates[axis] + vibration[axis] + frame + randomGaussian() * config.noiseDps;
+    }
+}
+
+/*
+ * Runs the model up to nowUs, one step per sample period so the noise doesn't depend on how often it is called.
+ * ratesDps gets the newest sample, returns false when no sample was due.
+ */
+bool gyroModelUpdate(uint64_t nowUs, float ratesDps[3]) {
+    if (!samplePeriodNs) {
+        return false;
+    }
+    if (sampleUs == 0 || nowUs > sampleUs + 100000) {
+        // first call, or the clock jumped, don't try to catch up
+        sampleUs = nowUs;
+        sampleNs = 0;
+    }
+    bool sampled = false;
+    while (sampleUs <= nowUs) {
+        gyroModelStep(ratesDps);
+        sampled = true;
+        sampleNs += samplePeriodNs;
+        sampleUs += sampleNs / 1000;
+        sampleNs %= 1000;
+    }
+    return sampled;
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Internal gyro model for filter and cpu benchmarks on the host. It samples the body rates of the last fdm packet
+// at its own output data rate and adds motor harmonics, a frame resonance and white noise, so the whole
+// gyro -> fft -> notch -> pid chain sees a noise spectrum like a real quad without a simulator in the loop.
+// It is set up from the SITL_GYRO_MODEL environment variable, see README.md.
+
+#define GYRO_MODEL_ENV          "SITL_GYRO_MODEL"
+#define GYRO_MODEL_MAX_ODR_HZ   32000
+#define GYRO_MODEL_MOTOR_COUNT  4
+
+bool gyroModelInit(void);
+uint32_t gyroModelOdrHz(void);
+void gyroModelSetRates(const double ratesDps[3]);
+void gyroModelSetMotors(const float motorSpeed[GYRO_MODEL_MOTOR_COUNT]);
+bool gyroModelUpdate(uint64_t nowUs, float ratesDps[3]);
@@ -0,0 +1,128 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "shmlink.h"
+
+static void ringReset(shmRing_t *ring) {
+    memset(ring, 0, sizeof(*ring));
+    sem_init(&ring->ready, 1, 0); // shared between processes
+}
+
+int shmLinkInit(shmLink_t* link, const char* name, bool isServer) {
+    memset(link, 0, sizeof(*link));
+    snprintf(link->name, sizeof(link->name), "%s", name);
+    link->isServer = isServer;
+
+    const int fd = shm_open(link->name, isServer ? O_CREAT | O_RDWR : O_RDWR, 0600);
+    if (fd == -1) {
+        return -2;
+    }
+    if (isServer && ftruncate(fd, sizeof(shmLinkRegion_t)) == -1) {
+        close(fd);
+        return -2;
+    }
+    void *region = mmap(NULL, sizeof(shmLinkRegion_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        return -2;
+    }
+    link->region = region;
+
+    if (isServer) {
+        // a client still attached from a previous run sees the magic drop and has to attach again
+        __atomic_store_n(&link->region->magic, 0, __ATOMIC_RELEASE);
+        link->region->version = SHM_LINK_VERSION;
+        ringReset(&link->region->toServer);
+        ringReset(&link->region->toClient);
+        __atomic_store_n(&link->region->magic, SHM_LINK_MAGIC, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&link->region->magic, __ATOMIC_ACQUIRE) != SHM_LINK_MAGIC || link->region->version != SHM_LINK_VERSION) {
+        munmap(region, sizeof(shmLinkRegion_t));
+        link->region = NULL;
+        return -1;
+    }
+    link->rx = isServer ? &link->region->toServer : &link->region->toClient;
+    link->tx = isServer ? &link->region->toClient : &link->region->toServer;
+    return 0;
+}
+
+// Like a full udp socket buffer a packet is dropped when the reader fell behind,
+// the ring can't drop the oldest one as only the reader owns the tail.
+int shmLinkSend(shmLink_t* link, const void* data, size_t size) {
+    shmRing_t *ring = link->tx;
+    if (!ring || size > SHM_LINK_SLOT_SIZE) {
+        return -1;
+    }
+    const uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= SHM_LINK_SLOTS) {
+        return -1;
+    }
+    const uint32_t slot = head & (SHM_LINK_SLOTS - 1);
+    memcpy(ring->data[slot], data, size);
+    ring->length[slot] = size;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    sem_post(&ring->ready);
+    return size;
+}
+
+int shmLinkRecv(shmLink_t* link, void* data, size_t size, uint32_t timeout_ms) {
+    shmRing_t *ring = link->rx;
+    if (!ring) {
+        return -1;
+    }
+    struct timespec timeout;
+    clock_gettime(CLOCK_REALTIME, &timeout); // sem_timedwait() takes CLOCK_REALTIME
+    timeout.tv_sec += timeout_ms / 1000;
+    timeout.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (timeout.tv_nsec >= 1000000000L) {
+        timeout.tv_sec++;
+        timeout.tv_nsec -= 1000000000L;
+    }
+    int ret;
+    while ((ret = sem_timedwait(&ring->ready, &timeout)) == -1 && errno == EINTR) ;
+    if (ret == -1) {
+        return -1;
+    }
+    const uint32_t tail = ring->tail;
+    const uint32_t slot = tail & (SHM_LINK_SLOTS - 1);
+    const size_t length = ring->length[slot] < size ? ring->length[slot] : size;
+    memcpy(data, ring->data[slot], length);
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return length;
+}
+
+void shmLinkClose(shmLink_t* link) {
+    if (link->region) {
+        munmap(link->region, sizeof(shmLinkRegion_t));
+        link->region = NULL;
+        link->rx = link->tx = NULL;
+    }
+    if (link->isServer) {
+        shm_unlink(link->name);
+    }
+}
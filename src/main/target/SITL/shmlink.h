@@ -0,0 +1,78 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SHMLINK_H
+#define __SHMLINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <semaphore.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Packet transport over a POSIX shared memory region, as a drop in for udplink
+// when many SITL instances run on one host. The region holds one single producer,
+// single consumer ring per direction, so a simulator plugin can include this file
+// and shmlink.c as they are.
+
+#define SHM_LINK_MAGIC      0x4d485345  // "ESHM"
+#define SHM_LINK_VERSION    1
+#define SHM_LINK_SLOTS      16          // power of 2
+#define SHM_LINK_SLOT_SIZE  256         // fits fdm_packet and servo_packet
+
+typedef struct {
+    sem_t ready;                        // counts the filled slots
+    volatile uint32_t head;             // written by the producer only
+    volatile uint32_t tail;             // written by the consumer only
+    uint32_t length[SHM_LINK_SLOTS];
+    uint8_t data[SHM_LINK_SLOTS][SHM_LINK_SLOT_SIZE];
+} shmRing_t;
+
+typedef struct {
+    volatile uint32_t magic;            // set last by the server once the rings are ready
+    uint32_t version;
+    shmRing_t toServer;                 // simulator -> betaflight, fdm packets
+    shmRing_t toClient;                 // betaflight -> simulator, servo packets
+} shmLinkRegion_t;
+
+typedef struct {
+    shmLinkRegion_t *region;
+    shmRing_t *rx;
+    shmRing_t *tx;
+    char name[32];
+    bool isServer;
+} shmLink_t;
+
+// The server creates and resets the region, a client attaches to an existing one
+// and fails until the server is up.
+int shmLinkInit(shmLink_t* link, const char* name, bool isServer);
+int shmLinkRecv(shmLink_t* link, void* data, size_t size, uint32_t timeout_ms);
+int shmLinkSend(shmLink_t* link, const void* data, size_t size);
+void shmLinkClose(shmLink_t* link);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -52,8 +52,9 @@ const timerHardware_t timerHardware[1]; // unused
 
 #include "rx/rx.h"
 
-#include "dyad.h"
 #include "target/SITL/udplink.h"
+#include "target/SITL/shmlink.h"
+#include "target/SITL/gyro_model.h"
 
 static fdm_packet fdmPkt;
 static servo_packet pwmPkt;
@@ -61,12 +62,112 @@ static servo_packet pwmPkt;
 static struct timespec start_time;
 static double simRate = 1.0;
 static pthread_t tcpWorker, udpWorker;
+#ifndef SIMULATOR_LOCKSTEP
+static pthread_t gyroModelWorker;
+#endif
 static bool workerRunning = true;
+static bool useGyroModel = false;
 static udpLink_t stateLink, pwmLink;
+static shmLink_t fdmShmLink;
+static bool useShmLink = false;
+static int instanceId = 0;
+static char eepromFilename[32] = EEPROM_FILENAME;
 static pthread_mutex_t updateLock;
 static pthread_mutex_t mainLoopLock;
 
 int timeval_sub(struct timespec *result, struct timespec *x, struct timespec *y);
+void microsleep(uint32_t usec);
+static void gyroModelSample(uint64_t nowUs);
+
+#ifdef SIMULATOR_LOCKSTEP
+#define LOCKSTEP_TICK_NS            10000       // virtual time per main loop pass, 10us
+#define LOCKSTEP_MAX_GRANT_NS       20000000    // same 50Hz limit as the simRate estimate
+#define LOCKSTEP_IDLE_NS            10000000    // free running slice while no simulator is connected
+#define LOCKSTEP_IDLE_TIMEOUT_US    500000
+
+// the main loop owns lockstepNowNs, the udp thread extends lockstepGrantNs once per fdm packet
+static uint64_t lockstepNowNs;
+static uint64_t lockstepGrantNs;
+static uint64_t lockstepLastPacketUs;
+static pthread_mutex_t lockstepLock;
+static pthread_cond_t lockstepGrantCond;    // a packet extended the grant
+static pthread_cond_t lockstepDoneCond;     // the main loop used up the grant
+
+static void lockstepInit(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (pthread_mutex_init(&lockstepLock, NULL) != 0
+        || pthread_cond_init(&lockstepGrantCond, &attr) != 0
+        || pthread_cond_init(&lockstepDoneCond, NULL) != 0) {
+        printf("Create lockstep lock error!\n");
+        exit(1);
+    }
+    pthread_condattr_destroy(&attr);
+}
+
+// Waits for the main loop to finish the last grant before the sensors change,
+// so every run sees the packets at exactly the same virtual times.
+static void lockstepWaitDone(void) {
+    pthread_mutex_lock(&lockstepLock);
+    while (workerRunning && lockstepNowNs < lockstepGrantNs) {
+        pthread_cond_wait(&lockstepDoneCond, &lockstepLock);
+    }
+    pthread_mutex_unlock(&lockstepLock);
+}
+
+static void lockstepGrant(double deltaSim) {
+    pthread_mutex_lock(&lockstepLock);
+    lockstepLastPacketUs = micros64_real();
+    if (deltaSim > 0) {
+        lockstepGrantNs = MAX(lockstepGrantNs, lockstepNowNs) + MIN(deltaSim * 1e9, LOCKSTEP_MAX_GRANT_NS);
+    }
+    pthread_cond_signal(&lockstepGrantCond);
+    pthread_mutex_unlock(&lockstepLock);
+}
+
+void simulatorLockstepStep(void) {
+    pthread_mutex_lock(&lockstepLock);
+    if (lockstepNowNs >= lockstepGrantNs) {
+        pthread_cond_signal(&lockstepDoneCond);
+        struct timespec timeout;
+        clock_gettime(CLOCK_MONOTONIC, &timeout);
+        timeout.tv_nsec += LOCKSTEP_IDLE_NS;
+        if (timeout.tv_nsec >= 1000000000) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000;
+        }
+        const int ret = pthread_cond_timedwait(&lockstepGrantCond, &lockstepLock, &timeout);
+        if (ret == ETIMEDOUT && micros64_real() - lockstepLastPacketUs > LOCKSTEP_IDLE_TIMEOUT_US) {
+            // no simulator, keep the cli and the tasks going at about real time
+            lockstepGrantNs = lockstepNowNs + LOCKSTEP_IDLE_NS;
+        }
+    }
+    if (lockstepNowNs < lockstepGrantNs) {
+        lockstepNowNs += LOCKSTEP_TICK_NS;
+    }
+    const uint64_t nowUs = lockstepNowNs / 1000;
+    pthread_mutex_unlock(&lockstepLock);
+    if (useGyroModel) {
+        // sampled on the virtual clock, so odr above the real main loop rate still gets every sample
+        gyroModelSample(nowUs);
+    }
+}
+
+static void lockstepStop(void) {
+    pthread_mutex_lock(&lockstepLock);
+    workerRunning = false;
+    pthread_cond_broadcast(&lockstepDoneCond);
+    pthread_mutex_unlock(&lockstepLock);
+}
+
+// delays pass instantly in virtual time
+static void lockstepDelayNs(uint64_t ns) {
+    pthread_mutex_lock(&lockstepLock);
+    lockstepNowNs += ns;
+    pthread_mutex_unlock(&lockstepLock);
+}
+#endif
 
 int lockMainPID(void) {
     return pthread_mutex_trylock(&mainLoopLock);
@@ -76,7 +177,11 @@ int lockMainPID(void) {
 #define ACC_SCALE (256 / 9.80665)
 #define GYRO_SCALE (16.4)
 void sendMotorUpdate() {
-    udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
+    if (useShmLink) {
+        shmLinkSend(&fdmShmLink, &pwmPkt, sizeof(servo_packet));
+    } else {
+        udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
+    }
 }
 void updateState(const fdm_packet* pkt) {
     static double last_timestamp = 0; // in seconds
@@ -88,6 +193,9 @@ void updateState(const fdm_packet* pkt) {
     if (realtime_now > last_realtime + 500 * 1e3) { // 500ms timeout
         last_timestamp = pkt->timestamp;
         last_realtime = realtime_now;
+#ifdef SIMULATOR_LOCKSTEP
+        lockstepGrant(0);
+#endif
         sendMotorUpdate();
         return;
     }
@@ -95,16 +203,28 @@ void updateState(const fdm_packet* pkt) {
     if (deltaSim < 0) { // don't use old packet
         return;
     }
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepWaitDone();
+#endif
     int16_t x, y, z;
     x = constrain(-pkt->imu_linear_acceleration_xyz[0] * ACC_SCALE, -32767, 32767);
     y = constrain(-pkt->imu_linear_acceleration_xyz[1] * ACC_SCALE, -32767, 32767);
     z = constrain(-pkt->imu_linear_acceleration_xyz[2] * ACC_SCALE, -32767, 32767);
     fakeAccSet(fakeAccDev, x, y, z);
 //    printf("[acc]%lf,%lf,%lf\n", pkt->imu_linear_acceleration_xyz[0], pkt->imu_linear_acceleration_xyz[1], pkt->imu_linear_acceleration_xyz[2]);
-    x = constrain(pkt->imu_angular_velocity_rpy[0] * GYRO_SCALE * RAD2DEG, -32767, 32767);
-    y = constrain(-pkt->imu_angular_velocity_rpy[1] * GYRO_SCALE * RAD2DEG, -32767, 32767);
-    z = constrain(-pkt->imu_angular_velocity_rpy[2] * GYRO_SCALE * RAD2DEG, -32767, 32767);
-    fakeGyroSet(fakeGyroDev, x, y, z);
+    if (useGyroModel) {
+        const double ratesDps[3] = {
+            pkt->imu_angular_velocity_rpy[0] * RAD2DEG,
+            -pkt->imu_angular_velocity_rpy[1] * RAD2DEG,
+            -pkt->imu_angular_velocity_rpy[2] * RAD2DEG,
+        };
+        gyroModelSetRates(ratesDps);
+    } else {
+        x = constrain(pkt->imu_angular_velocity_rpy[0] * GYRO_SCALE * RAD2DEG, -32767, 32767);
+        y = constrain(-pkt->imu_angular_velocity_rpy[1] * GYRO_SCALE * RAD2DEG, -32767, 32767);
+        z = constrain(-pkt->imu_angular_velocity_rpy[2] * GYRO_SCALE * RAD2DEG, -32767, 32767);
+        fakeGyroSet(fakeGyroDev, x, y, z);
+    }
 //    printf("[gyr]%lf,%lf,%lf\n", pkt->imu_angular_velocity_rpy[0], pkt->imu_angular_velocity_rpy[1], pkt->imu_angular_velocity_rpy[2]);
 #if defined(SKIP_IMU_CALC)
 #if defined(SET_IMU_FROM_EULER)
@@ -149,6 +269,9 @@ void updateState(const fdm_packet* pkt) {
     last_ts.tv_sec = now_ts.tv_sec;
     last_ts.tv_nsec = now_ts.tv_nsec;
     pthread_mutex_unlock(&updateLock); // can send PWM output now
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepGrant(deltaSim);
+#endif
 #if defined(SIMULATOR_GYROPID_SYNC)
     pthread_mutex_unlock(&mainLoopLock); // can run main loop
 #endif
@@ -158,7 +281,11 @@ static void* udpThread(void* data) {
     UNUSED(data);
     int n = 0;
     while (workerRunning) {
-        n = udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 100);
+        if (useShmLink) {
+            n = shmLinkRecv(&fdmShmLink, &fdmPkt, sizeof(fdm_packet), 100);
+        } else {
+            n = udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 100);
+        }
         if (n == sizeof(fdm_packet)) {
 //            printf("[data]new fdm %d\n", n);
             updateState(&fdmPkt);
@@ -170,22 +297,86 @@ static void* udpThread(void* data) {
 
 static void* tcpThread(void* data) {
     UNUSED(data);
-    dyad_init();
-    dyad_setTickInterval(0.2f);
-    dyad_setUpdateTimeout(0.5f);
     while (workerRunning) {
-        dyad_update();
+        tcpUpdate(100);
     }
-    dyad_shutdown();
     printf("tcpThread end!!\n");
     return NULL;
 }
 
+static void gyroModelSample(uint64_t nowUs) {
+    float ratesDps[3];
+    if (fakeGyroDev && gyroModelUpdate(nowUs, ratesDps)) {
+        fakeGyroSet(fakeGyroDev,
+            constrain((double)ratesDps[0] * GYRO_SCALE, -32767, 32767),
+            constrain((double)ratesDps[1] * GYRO_SCALE, -32767, 32767),
+            constrain((double)ratesDps[2] * GYRO_SCALE, -32767, 32767));
+    }
+}
+
+#ifndef SIMULATOR_LOCKSTEP
+// Runs the gyro model on its own clock, scaled by simRate like micros64() but kept apart from it
+static void* gyroModelThread(void* data) {
+    UNUSED(data);
+    const uint32_t periodUs = MAX(1000000 / gyroModelOdrHz(), 1u);
+    uint64_t lastNs = nanos64_real();
+    double modelUs = 0;
+    while (workerRunning) {
+        const uint64_t nowNs = nanos64_real();
+        modelUs += (nowNs - lastNs) * 1e-3 * simRate;
+        lastNs = nowNs;
+        gyroModelSample(modelUs);
+        microsleep(periodUs);
+    }
+    printf("gyroModelThread end!!\n");
+    return NULL;
+}
+#endif
+
+int simulatorInstance(void) {
+    return instanceId;
+}
+
+// SITL_INSTANCE shifts all ports and the eeprom file so several copies can run side by side,
+// SITL_TRANSPORT=shm exchanges the fdm and servo packets through shared memory instead of udp
+static void instanceInit(void) {
+    const char *instance = getenv(SIMULATOR_INSTANCE_ENV);
+    if (instance) {
+        instanceId = constrain(atoi(instance), 0, SIMULATOR_MAX_INSTANCES - 1);
+    }
+    if (instanceId > 0) {
+        snprintf(eepromFilename, sizeof(eepromFilename), "eeprom_%d.bin", instanceId);
+    }
+    const char *transport = getenv(SIMULATOR_TRANSPORT_ENV);
+    useShmLink = transport && strcmp(transport, "shm") == 0;
+    printf("[system]instance %d, %s transport\n", instanceId, useShmLink ? "shm" : "udp");
+}
+
+static void fdmLinkInit(void) {
+    int ret;
+    if (useShmLink) {
+        char name[32];
+        snprintf(name, sizeof(name), SIMULATOR_SHM_NAME, instanceId);
+        ret = shmLinkInit(&fdmShmLink, name, true);
+        printf("init shm link %s...%d\n", name, ret);
+        if (ret != 0) {
+            exit(1);
+        }
+        return;
+    }
+    const int port = SIMULATOR_PWM_PORT + instanceId * SIMULATOR_PORT_STRIDE;
+    ret = udpInit(&pwmLink, "127.0.0.1", port, false);
+    printf("init PwnOut UDP link %d...%d\n", port, ret);
+    ret = udpInit(&stateLink, NULL, port + 1, true);
+    printf("start UDP server %d...%d\n", port + 1, ret);
+}
+
 // system
 void systemInit(void) {
     int ret;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
     printf("[system]Init...\n");
+    instanceInit();
     SystemCoreClock = 500 * 1e6; // fake 500MHz
     FLASH_Unlock();
     if (pthread_mutex_init(&updateLock, NULL) != 0) {
@@ -196,36 +387,68 @@ void systemInit(void) {
         printf("Create mainLoopLock error!\n");
         exit(1);
     }
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepInit();
+#endif
     ret = pthread_create(&tcpWorker, NULL, tcpThread, NULL);
     if (ret != 0) {
         printf("Create tcpWorker error!\n");
         exit(1);
     }
-    ret = udpInit(&pwmLink, "127.0.0.1", 9002, false);
-    printf("init PwnOut UDP link...%d\n", ret);
-    ret = udpInit(&stateLink, NULL, 9003, true);
-    printf("start UDP server...%d\n", ret);
+    fdmLinkInit();
     ret = pthread_create(&udpWorker, NULL, udpThread, NULL);
     if (ret != 0) {
         printf("Create udpWorker error!\n");
         exit(1);
     }
+    useGyroModel = gyroModelInit();
+#ifndef SIMULATOR_LOCKSTEP
+    if (useGyroModel) {
+        ret = pthread_create(&gyroModelWorker, NULL, gyroModelThread, NULL);
+        if (ret != 0) {
+            printf("Create gyroModelWorker error!\n");
+            exit(1);
+        }
+    }
+#endif
     // serial can't been slow down
     rescheduleTask(TASK_SERIAL, 1);
 }
 
 void systemReset(void) {
     printf("[system]Reset!\n");
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepStop();
+#endif
     workerRunning = false;
     pthread_join(tcpWorker, NULL);
     pthread_join(udpWorker, NULL);
+#ifndef SIMULATOR_LOCKSTEP
+    if (useGyroModel) {
+        pthread_join(gyroModelWorker, NULL);
+    }
+#endif
+    if (useShmLink) {
+        shmLinkClose(&fdmShmLink);
+    }
     exit(0);
 }
 void systemResetToBootloader(void) {
     printf("[system]ResetToBootloader!\n");
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepStop();
+#endif
     workerRunning = false;
     pthread_join(tcpWorker, NULL);
     pthread_join(udpWorker, NULL);
+#ifndef SIMULATOR_LOCKSTEP
+    if (useGyroModel) {
+        pthread_join(gyroModelWorker, NULL);
+    }
+#endif
+    if (useShmLink) {
+        shmLinkClose(&fdmShmLink);
+    }
     exit(0);
 }
 
@@ -266,6 +489,15 @@ uint64_t millis64_real() {
     return 1.0e3 * ((ts.tv_sec + (ts.tv_nsec * 1.0e-9)) - (start_time.tv_sec + (start_time.tv_nsec * 1.0e-9)));
 }
 
+#ifdef SIMULATOR_LOCKSTEP
+uint64_t micros64() {
+    return lockstepNowNs / 1000;
+}
+
+uint64_t millis64() {
+    return lockstepNowNs / 1000000;
+}
+#else
 uint64_t micros64() {
     static uint64_t last = 0;
     static uint64_t out = 0;
@@ -285,6 +517,7 @@ uint64_t millis64() {
     return out * 1e-6;
 //    return millis64_real();
 }
+#endif
 
 uint32_t micros(void) {
     return micros64() & 0xFFFFFFFF;
@@ -302,7 +535,11 @@ void microsleep(uint32_t usec) {
 }
 
 void delayMicroseconds(uint32_t us) {
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepDelayNs(us * 1000ULL);
+#else
     microsleep(us / simRate);
+#endif
 }
 
 void delayMicroseconds_real(uint32_t us) {
@@ -310,10 +547,14 @@ void delayMicroseconds_real(uint32_t us) {
 }
 
 void delay(uint32_t ms) {
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepDelayNs(ms * 1000000ULL);
+#else
     uint64_t start = millis64();
     while ((millis64() - start) < ms) {
         microsleep(1000);
     }
+#endif
 }
 
 // Subtract the ‘struct timespec’ values X and Y,  storing the result in RESULT.
@@ -401,9 +642,12 @@ void pwmCompleteMotorUpdate(uint8_t motorCount) {
     pwmPkt.motor_speed[0] = motorsPwm[1] / outScale;
     pwmPkt.motor_speed[1] = motorsPwm[2] / outScale;
     pwmPkt.motor_speed[2] = motorsPwm[3] / outScale;
+    if (useGyroModel) {
+        gyroModelSetMotors(pwmPkt.motor_speed);
+    }
     // get one "fdm_packet" can only send one "servo_packet"!!
     if (pthread_mutex_trylock(&updateLock) != 0) return;
-    udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
+    sendMotorUpdate();
 //    printf("[pwm]%u:%u,%u,%u,%u\n", idlePulse, motorsPwm[0], motorsPwm[1], motorsPwm[2], motorsPwm[3]);
 }
 
@@ -431,7 +675,7 @@ void FLASH_Unlock(void) {
         return;
     }
     // open or create
-    eepromFd = fopen(EEPROM_FILENAME, "r+");
+    eepromFd = fopen(eepromFilename, "r+");
     if (eepromFd != NULL) {
         // obtain file size:
         fseek(eepromFd, 0, SEEK_END);
@@ -439,15 +683,15 @@ void FLASH_Unlock(void) {
         rewind(eepromFd);
         size_t n = fread(eepromData, 1, sizeof(eepromData), eepromFd);
         if (n == lSize) {
-            printf("[FLASH_Unlock] loaded '%s', size = %ld / %ld\n", EEPROM_FILENAME, lSize, sizeof(eepromData));
+            printf("[FLASH_Unlock] loaded '%s', size = %ld / %ld\n", eepromFilename, lSize, sizeof(eepromData));
         } else {
-            fprintf(stderr, "[FLASH_Unlock] failed to load '%s'\n", EEPROM_FILENAME);
+            fprintf(stderr, "[FLASH_Unlock] failed to load '%s'\n", eepromFilename);
             return;
         }
     } else {
-        printf("[FLASH_Unlock] created '%s', size = %ld\n", EEPROM_FILENAME, sizeof(eepromData));
-        if ((eepromFd = fopen(EEPROM_FILENAME, "w+")) == NULL) {
-            fprintf(stderr, "[FLASH_Unlock] failed to create '%s'\n", EEPROM_FILENAME);
+        printf("[FLASH_Unlock] created '%s', size = %ld\n", eepromFilename, sizeof(eepromData));
+        if ((eepromFd = fopen(eepromFilename, "w+")) == NULL) {
+            fprintf(stderr, "[FLASH_Unlock] failed to create '%s'\n", eepromFilename);
             return;
         }
         if (fwrite(eepromData, sizeof(eepromData), 1, eepromFd) != 1) {
@@ -463,7 +707,7 @@ void FLASH_Lock(void) {
         fwrite(eepromData, 1, sizeof(eepromData), eepromFd);
         fclose(eepromFd);
         eepromFd = NULL;
-        printf("[FLASH_Lock] saved '%s'\n", EEPROM_FILENAME);
+        printf("[FLASH_Lock] saved '%s'\n", eepromFilename);
     } else {
         fprintf(stderr, "[FLASH_Lock] eeprom is not unlocked\n");
     }
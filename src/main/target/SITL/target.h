@@ -40,6 +40,22 @@
 //#define SIMULATOR_IMU_SYNC
 //#define SIMULATOR_GYROPID_SYNC
 
+// simulated time only advances as far as the fdm packets allow, so a flight runs
+// as fast as the host and the simulator can go and repeats exactly, e.g. for tuning
+// sweeps in CI. Build with `make TARGET=SITL EXTRA_FLAGS=-DSIMULATOR_LOCKSTEP`
+//#define SIMULATOR_LOCKSTEP
+
+// several instances can run on one host, SITL_INSTANCE=n moves the udp ports and the
+// tcp uart ports up by n * SIMULATOR_PORT_STRIDE and saves config to eeprom_n.bin.
+// SITL_TRANSPORT=shm swaps the fdm/servo udp link for the shm ring in shmlink.h
+#define SIMULATOR_INSTANCE_ENV      "SITL_INSTANCE"
+#define SIMULATOR_TRANSPORT_ENV     "SITL_TRANSPORT"
+#define SIMULATOR_TCP_NODELAY_ENV   "SITL_TCP_NODELAY"
+#define SIMULATOR_MAX_INSTANCES     100
+#define SIMULATOR_PORT_STRIDE       10
+#define SIMULATOR_PWM_PORT          9002    // fdm packets come in on the next port
+#define SIMULATOR_SHM_NAME          "/emuflight_sitl_%d"
+
 // file name to save config
 #define EEPROM_FILENAME "eeprom.bin"
 #define EEPROM_IN_RAM
@@ -259,3 +275,7 @@ uint64_t micros64(void);
 uint64_t millis64(void);
 
 int lockMainPID(void);
+int simulatorInstance(void);
+#ifdef SIMULATOR_LOCKSTEP
+void simulatorLockstepStep(void);
+#endif
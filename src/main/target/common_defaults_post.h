@@ -228,3 +228,14 @@
 #ifndef DEFAULT_RX_FEATURE
 #define DEFAULT_RX_FEATURE FEATURE_RX_SERIAL
 #endif
+
+// io/asyncfatfs and drivers/sdcard_sdio_baremetal: sector cache and multi-block write queue depth
+
+#ifdef STM32F7
+#ifndef AFATFS_NUM_CACHE_SECTORS
+#define AFATFS_NUM_CACHE_SECTORS 16
+#endif
+#ifndef FATFS_BLOCK_CACHE_SIZE
+#define FATFS_BLOCK_CACHE_SIZE 32
+#endif
+#endif
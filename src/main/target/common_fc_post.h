@@ -32,6 +32,55 @@
 
 #ifndef USE_DSHOT
 #undef USE_ESC_SENSOR
+#undef USE_DSHOT_TELEMETRY
+#endif
+
+#ifndef USE_DSHOT_TELEMETRY
+#undef USE_RPM_FILTER
+#endif
+
+// the dedicated dma spi device owns its own streams and read path
+#if !defined(USE_SPI) || defined(USE_DMA_SPI_DEVICE)
+#undef USE_GYRO_SPI_DMA
+#endif
+
+// the gyro stage runs in the gyro spi dma completion interrupt
+#ifndef USE_GYRO_SPI_DMA
+#undef USE_GYRO_PID_INTERRUPT
+#endif
+
+// the motor timers are only started together when they run dshot bursts
+#if !defined(USE_DSHOT) || !defined(USE_DSHOT_DMAR)
+#undef USE_DSHOT_BURST_SYNC
+#endif
+
+// the bench reads the same DWT cycle counter as the profiler
+#ifndef USE_CYCLE_PROFILE
+#undef USE_CYCLE_BENCH
+#endif
+
+#ifndef USE_BLACKBOX
+#undef USE_BLACKBOX_ENCODE_TASK
+#endif
+
+// the imu-f driver keeps the crc unit set up for its 32 bit frames
+#ifdef USE_GYRO_IMUF9001
+#undef USE_CRC_HW
+#endif
+
+// the imu-f runs the gyro filters, only the pid ones could be retuned
+#ifdef USE_GYRO_IMUF9001
+#undef USE_FILTER_RETUNE
+#endif
+
+// the raw gyro capture is written to the onboard flash only
+#if !defined(USE_BLACKBOX) || !defined(USE_FLASHFS)
+#undef USE_GYRO_CAPTURE
+#endif
+
+// the log compression codes the flash blocks with the MSP dataflash read huffman table
+#if !defined(USE_BLACKBOX) || !defined(USE_FLASHFS) || !defined(USE_HUFFMAN)
+#undef USE_BLACKBOX_COMPRESSION
 #endif
 
 // XXX Followup implicit dependencies among DASHBOARD, display_xxx and USE_I2C.
@@ -176,6 +225,11 @@
 #define USE_FLASH
 #endif
 
+// background page programs go through the spi dma api of the m25p16 driver
+#if !defined(USE_GYRO_SPI_DMA) || !defined(USE_FLASH_M25P16)
+#undef USE_FLASH_SPI_DMA
+#endif
+
 #if defined(USE_MAX7456)
 #define USE_OSD
 #endif
@@ -39,6 +39,8 @@
 // Using RX DMA disables the use of receive callbacks
 #define USE_UART1_RX_DMA
 #define USE_UART1_TX_DMA
+// no FPU, run the gyro lowpass and static notch filters in fixed point
+#define USE_GYRO_FILTER_FIXED_POINT
 #endif
 
 #ifdef STM32F3
@@ -70,6 +72,7 @@
 #define USE_SRAM2
 #define USE_ITCM_RAM
 #define USE_FAST_RAM
+#define USE_DMA_RAM
 #define USE_DSHOT
 #define I2C3_OVERCLOCK true
 #define I2C4_OVERCLOCK true
@@ -78,6 +81,41 @@
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
+#define USE_CRC_HW
+#endif
+
+#if defined(STM32F4) || defined(STM32F7)
+#define USE_DSHOT_TELEMETRY
+#define USE_RPM_FILTER
+#define USE_DYN_LPF
+#define USE_FILTER_RETUNE
+#define USE_GYRO_FIFO_BATCH
+#define USE_GYRO_SPI_DMA
+#define USE_GYRO_ACC_BURST
+#define USE_SCHEDULER_WHEEL
+#define USE_SCHEDULER_IDLE_SLEEP
+#define USE_CYCLE_PROFILE
+#define USE_CYCLE_BENCH
+#define USE_LOOP_JITTER
+#define USE_WARM_BOOT
+#define USE_GYRO_PID_INTERRUPT
+#define USE_DSHOT_BURST_SYNC
+#define USE_DSHOT_OUTPUT_ALIGN
+#define USE_UART_RX_DMA_IDLE
+#define USE_BLACKBOX_ENCODE_TASK
+#define USE_GYRO_CAPTURE
+#define USE_FLASH_SPI_DMA
+#define USE_RX_SPI_DMA
+#define USE_SOFTSERIAL_DMA
+#define USE_PPM_DMA
+#define USE_STACK_CHECK_IRQ
+#define USE_EXTI_DIRECT
+#define USE_MSP_JUMBO_FRAMES
+#endif
+
+#if defined(STM32F411xE) || defined(STM32F722xx)
+// exponentially weighted kalman measurement variance, frees the per axis sample windows on small ram parts
+#define USE_KALMAN_STREAMING_VARIANCE
 #endif
 
 #if defined(STM32F4) || defined(STM32F7)
@@ -110,9 +148,11 @@
 #define FAST_RAM
 #endif // USE_FAST_RAM
 
-#ifdef STM32F4
+#if defined(STM32F4) || defined(STM32F7)
 // Data in RAM which is guaranteed to not be reset on hot reboot
 #define PERSISTENT                  __attribute__ ((section(".persistent_data"), aligned(4)))
+#else
+#define PERSISTENT
 #endif
 
 #ifdef USE_SRAM2
@@ -121,6 +161,13 @@
 #define SRAM2
 #endif
 
+#ifdef USE_DMA_RAM
+// Zero initialised, non-cacheable RAM for DMA buffers, aligned to the 32 byte D-cache line
+#define DMA_RAM                     __attribute__ ((section(".dmaram_bss"), aligned(32)))
+#else
+#define DMA_RAM
+#endif
+
 #define USE_BRUSHED_ESC_AUTODETECT  // Detect if brushed motors are connected and set defaults appropriately to avoid motors spinning on boot
 #define USE_CLI
 #define USE_GYRO_REGISTER_DUMP  // Adds gyroregisters command to cli to dump configured register values
@@ -165,6 +212,7 @@
 #define USE_GYRO_OVERFLOW_CHECK
 #define USE_YAW_SPIN_RECOVERY
 #define USE_HUFFMAN
+#define USE_BLACKBOX_COMPRESSION
 #define USE_MSP_DISPLAYPORT
 #define USE_MSP_OVER_TELEMETRY
 #define MSP_OVER_CLI
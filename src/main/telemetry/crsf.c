@@ -58,6 +58,7 @@
 #include "io/serial.h"
 
 #include "rx/crsf.h"
+#include "rx/rx.h"
 
 #include "sensors/battery.h"
 #include "sensors/sensors.h"
@@ -70,7 +71,7 @@
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
-#define CRSF_MSP_BUFFER_SIZE 96
+#define CRSF_MSP_BUFFER_SIZE 128 // two full size request frames
 #define CRSF_MSP_LENGTH_OFFSET 1
 
 static bool crsfTelemetryEnabled;
@@ -101,26 +102,33 @@ bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength) {
     }
 }
 
+// Sends the next chunk of the reply in progress, otherwise works through the buffered request
+// frames until one completes a request and starts its reply. Frames behind that request stay
+// buffered, so requests can be pipelined without one reply overwriting another.
+// Returns true while there is more to send or process.
 bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn) {
-    bool requestHandled = false;
-    if (!mspRxBuffer.len) {
-        return false;
+    static bool replyPending = false;
+    if (replyPending) {
+        replyPending = sendMspReply(payloadSize, responseFn);
+        return replyPending || mspRxBuffer.len;
     }
+    // frames appended by the rx interrupt from here on are left for the next call
+    const int bufferedLength = mspRxBuffer.len;
     int pos = 0;
-    while (true) {
+    while (pos < bufferedLength) {
         const int mspFrameLength = mspRxBuffer.bytes[pos];
-        if (handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL)) {
-            requestHandled |= sendMspReply(payloadSize, responseFn);
-        }
+        uint8_t *mspFrame = &mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos];
         pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
-        ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
-            if (pos >= mspRxBuffer.len) {
-                mspRxBuffer.len = 0;
-                return requestHandled;
-            }
+        if (handleMspFrame(mspFrame, mspFrameLength, NULL)) {
+            replyPending = sendMspReply(payloadSize, responseFn);
+            break;
         }
     }
-    return requestHandled;
+    ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
+        memmove(mspRxBuffer.bytes, &mspRxBuffer.bytes[pos], mspRxBuffer.len - pos);
+        mspRxBuffer.len -= pos;
+    }
+    return replyPending || mspRxBuffer.len;
 }
 #endif
 
@@ -330,10 +338,12 @@ void crsfFrameDeviceInfo(sbuf_t *dst) {
 
 #if defined(USE_CRSF_CMS_TELEMETRY)
 
-static void crsfFrameDisplayPortRow(sbuf_t *dst, uint8_t row) {
+static void crsfFrameDisplayPortRow(sbuf_t *dst, uint8_t row, uint8_t rowCount) {
     uint8_t *lengthPtr = sbufPtr(dst);
-    uint8_t buflen = crsfDisplayPortScreen()->cols;
-    char *rowStart = &crsfDisplayPortScreen()->buffer[row * buflen];
+    const uint8_t cols = crsfDisplayPortScreen()->cols;
+    char *rowStart = &crsfDisplayPortScreen()->buffer[row * cols];
+    // rows are contiguous in the buffer, consecutive ones go out back to back
+    const uint8_t buflen = cols * rowCount;
     const uint8_t frameLength = CRSF_FRAME_LENGTH_EXT_TYPE_CRC + buflen;
     sbufWriteU8(dst, frameLength);
     sbufWriteU8(dst, CRSF_FRAMETYPE_DISPLAYPORT_CMD);
@@ -461,14 +471,15 @@ bool checkCrsfTelemetryState(void) {
 }
 
 #if defined(USE_CRSF_CMS_TELEMETRY)
-void crsfProcessDisplayPortCmd(uint8_t *frameStart) {
+void crsfProcessDisplayPortCmd(uint8_t *frameStart, int frameLength) {
     uint8_t cmd = *frameStart;
     switch (cmd) {
     case CRSF_DISPLAYPORT_SUBCMD_OPEN:
         ;
         const uint8_t rows = *(frameStart + CRSF_DISPLAYPORT_OPEN_ROWS_OFFSET);
         const uint8_t cols = *(frameStart + CRSF_DISPLAYPORT_OPEN_COLS_OFFSET);
-        crsfDisplayPortSetDimensions(rows, cols);
+        const uint8_t flags = frameLength > CRSF_DISPLAYPORT_OPEN_FLAGS_OFFSET ? *(frameStart + CRSF_DISPLAYPORT_OPEN_FLAGS_OFFSET) : 0;
+        crsfDisplayPortSetDimensions(rows, cols, flags & CRSF_DISPLAYPORT_OPEN_FLAG_MULTI_ROW);
         crsfDisplayPortMenuOpen();
         break;
     case CRSF_DISPLAYPORT_SUBCMD_CLOSE:
@@ -484,6 +495,18 @@ void crsfProcessDisplayPortCmd(uint8_t *frameStart) {
 
 #endif
 
+// Crossfire reports 0 = 4Hz, 1 = 50Hz, 2 = 150Hz, ELRS reports higher values for its faster packet rates
+#define CRSF_RF_MODE_150HZ 2
+
+// Frames handed to the receiver per telemetry slot, a fast link takes a burst between two rc frames
+static int crsfFramesPerSlot(void) {
+    return CRSFgetRFMode() >= CRSF_RF_MODE_150HZ ? CRSF_TELEMETRY_BUFFER_SIZE / CRSF_FRAME_SIZE_MAX : 1;
+}
+
+static bool crsfSlotHasRoom(int framesLeft) {
+    return framesLeft > 0 && crsfRxTelemetryBufferFree() >= CRSF_FRAME_SIZE_MAX;
+}
+
 /*
  * Called periodically by the scheduler
  */
@@ -496,53 +519,59 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs) {
     // This needs to be done at high frequency, to enable the RX to send the telemetry frame
     // in between the RX frames.
     crsfRxSendTelemetryData();
-    // Send ad-hoc response frames as soon as possible
-#if defined(USE_MSP_OVER_TELEMETRY)
-    if (mspReplyPending) {
-        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+    int framesLeft = crsfFramesPerSlot();
+    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
+    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
+    // These few frames a second go first so ad-hoc traffic can't starve them.
+    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+        crsfLastCycleTime = currentTimeUs;
+        processCrsf();
+        framesLeft--;
     }
-#endif
-    if (deviceInfoReplyPending) {
+    // Send ad-hoc response frames with whatever is left of the slot
+    if (deviceInfoReplyPending && crsfSlotHasRoom(framesLeft)) {
         sbuf_t crsfPayloadBuf;
         sbuf_t *dst = &crsfPayloadBuf;
         crsfInitializeFrame(dst);
         crsfFrameDeviceInfo(dst);
         crsfFinalize(dst);
         deviceInfoReplyPending = false;
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+        framesLeft--;
+    }
+#if defined(USE_MSP_OVER_TELEMETRY)
+    // MSP replies are what configuration over the link waits on, they take every remaining frame
+    while (mspReplyPending && crsfSlotHasRoom(framesLeft)) {
+        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+        framesLeft--;
     }
+#endif
 #if defined(USE_CRSF_CMS_TELEMETRY)
-    if (crsfDisplayPortScreen()->reset) {
+    if (crsfDisplayPortScreen()->reset && crsfSlotHasRoom(framesLeft)) {
         crsfDisplayPortScreen()->reset = false;
         sbuf_t crsfDisplayPortBuf;
         sbuf_t *dst = &crsfDisplayPortBuf;
         crsfInitializeFrame(dst);
         crsfFrameDisplayPortClear(dst);
         crsfFinalize(dst);
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        framesLeft--;
     }
-    const int nextRow = crsfDisplayPortNextRow();
-    if (nextRow >= 0) {
+    const uint8_t cols = crsfDisplayPortScreen()->cols;
+    const uint8_t rowsPerFrame = cols ? MAX(CRSF_DISPLAYPORT_UPDATE_DATA_MAX / cols, 1) : 1;
+    while (!crsfDisplayPortScreen()->reset && crsfSlotHasRoom(framesLeft)) {
+        uint8_t rowCount;
+        const int nextRow = crsfDisplayPortNextRow(rowsPerFrame, &rowCount);
+        if (nextRow < 0) {
+            break;
+        }
         sbuf_t crsfDisplayPortBuf;
         sbuf_t *dst = &crsfDisplayPortBuf;
         crsfInitializeFrame(dst);
-        crsfFrameDisplayPortRow(dst, nextRow);
+        crsfFrameDisplayPortRow(dst, nextRow, rowCount);
         crsfFinalize(dst);
-        crsfDisplayPortScreen()->pendingTransport[nextRow] = false;
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        crsfDisplayPortRowsSent(nextRow, rowCount);
+        framesLeft--;
     }
 #endif
-    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
-    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
-        crsfLastCycleTime = currentTimeUs;
-        processCrsf();
-    }
 }
 
 int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType) {
@@ -532,7 +532,9 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs) {
 
 void handleFrSkyHubTelemetry(timeUs_t currentTimeUs) {
     if (telemetryState == TELEMETRY_STATE_INITIALIZED_SERIAL && frSkyHubPort) {
+        serialBeginWrite(frSkyHubPort);
         processFrSkyHubTelemetry(currentTimeUs);
+        serialEndWrite(frSkyHubPort);
     }
 }
 #endif
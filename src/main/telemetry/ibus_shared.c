@@ -161,11 +161,11 @@ static uint8_t transmitIbusPacket() {
     }
     unsigned payloadLength = frameLength - IBUS_CHECKSUM_SIZE;
     uint16_t checksum = calculateChecksum(sendBuffer);
-    for (unsigned i = 0; i < payloadLength; i++) {
-        serialWrite(ibusSerialPort, sendBuffer[i]);
-    }
-    serialWrite(ibusSerialPort, checksum & 0xFF);
-    serialWrite(ibusSerialPort, checksum >> 8);
+    const uint8_t checksumBytes[IBUS_CHECKSUM_SIZE] = { checksum & 0xFF, checksum >> 8 };
+    serialBeginWrite(ibusSerialPort);
+    serialWriteBuf(ibusSerialPort, sendBuffer, payloadLength);
+    serialWriteBuf(ibusSerialPort, checksumBytes, IBUS_CHECKSUM_SIZE);
+    serialEndWrite(ibusSerialPort);
     return frameLength;
 }
 
@@ -91,6 +91,7 @@ static uint8_t ltm_crc;
 
 static void ltm_initialise_packet(uint8_t ltm_id) {
     ltm_crc = 0;
+    serialBeginWrite(ltmPort);
     serialWrite(ltmPort, '$');
     serialWrite(ltmPort, 'T');
     serialWrite(ltmPort, ltm_id);
@@ -115,6 +116,7 @@ static void ltm_serialise_32(uint32_t v) {
 
 static void ltm_finalise(void) {
     serialWrite(ltmPort, ltm_crc);
+    serialEndWrite(ltmPort);
 }
 
 /*
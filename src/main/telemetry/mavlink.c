@@ -80,8 +80,8 @@
 #pragma GCC diagnostic pop
 
 #define TELEMETRY_MAVLINK_INITIAL_PORT_MODE MODE_TX
-#define TELEMETRY_MAVLINK_MAXRATE 50
-#define TELEMETRY_MAVLINK_DELAY ((1000 * 1000) / TELEMETRY_MAVLINK_MAXRATE)
+// link time that can be saved up while the streams are quiet, sent as a burst when they come due together
+#define TELEMETRY_MAVLINK_BUDGET_BURST_US 20000
 
 extern uint16_t rssi; // FIXME dependency on mw.c
 
@@ -91,44 +91,65 @@ static serialPortConfig_t *portConfig;
 static bool mavlinkTelemetryEnabled =  false;
 static portSharing_e mavlinkPortSharing;
 
-/* MAVLink datastream rates in Hz */
-static const uint8_t mavRates[] = {
-    [MAV_DATA_STREAM_EXTENDED_STATUS] = 2, //2Hz
-    [MAV_DATA_STREAM_RC_CHANNELS] = 5, //5Hz
-    [MAV_DATA_STREAM_POSITION] = 2, //2Hz
-    [MAV_DATA_STREAM_EXTRA1] = 10, //10Hz
-    [MAV_DATA_STREAM_EXTRA2] = 10 //2Hz
+/* MAVLink datastream rates in Hz, from telemetryConfig */
+static uint8_t mavRates[] = {
+    [MAV_DATA_STREAM_EXTENDED_STATUS] = 0,
+    [MAV_DATA_STREAM_RC_CHANNELS] = 0,
+    [MAV_DATA_STREAM_POSITION] = 0,
+    [MAV_DATA_STREAM_EXTRA1] = 0,
+    [MAV_DATA_STREAM_EXTRA2] = 0
 };
 
 #define MAXSTREAMS (sizeof(mavRates) / sizeof(mavRates[0]))
 
-static uint8_t mavTicks[MAXSTREAMS];
+static timeUs_t mavNextDueUs[MAXSTREAMS];
 static mavlink_message_t mavMsg;
 static uint8_t mavBuffer[MAVLINK_MAX_PACKET_LEN];
-static uint32_t lastMavlinkMessage = 0;
 
-static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum) {
-    uint8_t rate = (uint8_t) mavRates[streamNum];
-    if (rate == 0) {
-        return 0;
+// bytes the link can carry before the streams get ahead of it, may go negative by the last message sent
+static int32_t mavBudget = 0;
+static timeUs_t mavBudgetUpdatedUs = 0;
+
+// transmit buffer lent by the port, messages are packed straight into it
+static uint8_t *mavTxBuf = NULL;
+static uint32_t mavTxBufSize;
+static uint32_t mavTxLength;
+
+static bool mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum, timeUs_t currentTimeUs) {
+    const uint8_t rate = mavRates[streamNum];
+    if (rate == 0 || mavBudget <= 0 || cmpTimeUs(currentTimeUs, mavNextDueUs[streamNum]) < 0) {
+        return false;
     }
-    if (mavTicks[streamNum] == 0) {
-        // we're triggering now, setup the next trigger point
-        if (rate > TELEMETRY_MAVLINK_MAXRATE) {
-            rate = TELEMETRY_MAVLINK_MAXRATE;
-        }
-        mavTicks[streamNum] = (TELEMETRY_MAVLINK_MAXRATE / rate);
-        return 1;
+    const timeDelta_t periodUs = 1000000 / rate;
+    mavNextDueUs[streamNum] += periodUs;
+    if (cmpTimeUs(currentTimeUs, mavNextDueUs[streamNum]) >= 0) {
+        // fell more than a period behind, out of budget or after a stall: keep the rate from now on rather than catch up
+        mavNextDueUs[streamNum] = currentTimeUs + periodUs;
     }
-    // count down at TASK_RATE_HZ
-    mavTicks[streamNum]--;
-    return 0;
+    return true;
 }
 
+static void mavlinkUpdateBudget(timeUs_t currentTimeUs) {
+    const int32_t bytesPerSecond = serialGetBaudRate(mavlinkPort) / 10; // 8N1
+    const int32_t burst = (int64_t)bytesPerSecond * TELEMETRY_MAVLINK_BUDGET_BURST_US / 1000000;
+    const timeDelta_t elapsedUs = constrain(cmpTimeUs(currentTimeUs, mavBudgetUpdatedUs), 0, TELEMETRY_MAVLINK_BUDGET_BURST_US);
+    mavBudget = MIN(mavBudget + (int32_t)((int64_t)bytesPerSecond * elapsedUs / 1000000), burst);
+    mavBudgetUpdatedUs = currentTimeUs;
+}
 
-static void mavlinkSerialWrite(uint8_t * buf, uint16_t length) {
-    for (int i = 0; i < length; i++)
-        serialWrite(mavlinkPort, buf[i]);
+static void mavlinkSendMessage(void) {
+    const uint32_t length = MAVLINK_NUM_NON_PAYLOAD_BYTES + mavMsg.len;
+    mavBudget -= length;
+    if (mavTxBuf) {
+        if (mavTxLength + length <= mavTxBufSize) {
+            mavTxLength += mavlink_msg_to_send_buffer(mavTxBuf + mavTxLength, &mavMsg);
+            return;
+        }
+        // out of room, hand back what is there and queue the rest behind it
+        serialCommitTxBuf(mavlinkPort, mavTxLength);
+        mavTxBuf = NULL;
+    }
+    serialWriteBuf(mavlinkPort, mavBuffer, mavlink_msg_to_send_buffer(mavBuffer, &mavMsg));
 }
 
 void freeMAVLinkTelemetryPort(void) {
@@ -140,6 +161,11 @@ void freeMAVLinkTelemetryPort(void) {
 void initMAVLinkTelemetry(void) {
     portConfig = findSerialPortConfig(FUNCTION_TELEMETRY_MAVLINK);
     mavlinkPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_MAVLINK);
+    mavRates[MAV_DATA_STREAM_EXTENDED_STATUS] = telemetryConfig()->mavlink_extended_status_rate;
+    mavRates[MAV_DATA_STREAM_RC_CHANNELS] = telemetryConfig()->mavlink_rc_channels_rate;
+    mavRates[MAV_DATA_STREAM_POSITION] = telemetryConfig()->mavlink_position_rate;
+    mavRates[MAV_DATA_STREAM_EXTRA1] = telemetryConfig()->mavlink_extra1_rate;
+    mavRates[MAV_DATA_STREAM_EXTRA2] = telemetryConfig()->mavlink_extra2_rate;
 }
 
 void configureMAVLinkTelemetryPort(void) {
@@ -177,7 +203,6 @@ void checkMAVLinkTelemetryState(void) {
 }
 
 void mavlinkSendSystemStatus(void) {
-    uint16_t msgLength;
     uint32_t onboardControlAndSensors = 35843;
     /*
     onboard_control_sensors_present Bitmask
@@ -230,12 +255,10 @@ void mavlinkSendSystemStatus(void) {
                                 0,
                                 // errors_count4 Autopilot-specific errors
                                 0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 void mavlinkSendRCChannelsAndRSSI(void) {
-    uint16_t msgLength;
     mavlink_msg_rc_channels_raw_pack(0, 200, &mavMsg,
                                      // time_boot_ms Timestamp (milliseconds since system boot)
                                      millis(),
@@ -259,13 +282,11 @@ void mavlinkSendRCChannelsAndRSSI(void) {
                                      (rxRuntimeConfig.channelCount >= 8) ? rcData[7] : 0,
                                      // rssi Receive signal strength indicator, 0: 0%, 254: 100%
                                      scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 254));
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 #if defined(USE_GPS)
 void mavlinkSendPosition(void) {
-    uint16_t msgLength;
     uint8_t gpsFixType = 0;
     if (!sensors(SENSOR_GPS))
         return;
@@ -299,8 +320,7 @@ void mavlinkSendPosition(void) {
                                  gpsSol.groundCourse * 10,
                                  // satellites_visible Number of satellites visible. If unknown, set to 255
                                  gpsSol.numSat);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
     // Global position
     mavlink_msg_global_position_int_pack(0, 200, &mavMsg,
                                          // time_usec Timestamp (microseconds since UNIX epoch or microseconds since system boot)
@@ -326,8 +346,7 @@ void mavlinkSendPosition(void) {
                                          // heading Current heading in degrees, in compass units (0..360, 0=north)
                                          DECIDEGREES_TO_DEGREES(attitude.values.yaw)
                                         );
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
     mavlink_msg_gps_global_origin_pack(0, 200, &mavMsg,
                                        // latitude Latitude (WGS84), expressed as * 1E7
                                        GPS_home[LAT],
@@ -335,13 +354,11 @@ void mavlinkSendPosition(void) {
                                        GPS_home[LON],
                                        // altitude Altitude(WGS84), expressed as * 1000
                                        0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 #endif
 
 void mavlinkSendAttitude(void) {
-    uint16_t msgLength;
     mavlink_msg_attitude_pack(0, 200, &mavMsg,
                               // time_boot_ms Timestamp (milliseconds since system boot)
                               millis(),
@@ -357,12 +374,10 @@ void mavlinkSendAttitude(void) {
                               0,
                               // yawspeed Yaw angular speed (rad/s)
                               0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 void mavlinkSendHUDAndHeartbeat(void) {
-    uint16_t msgLength;
     float mavAltitude = 0;
     float mavGroundSpeed = 0;
     float mavAirSpeed = 0;
@@ -404,8 +419,7 @@ void mavlinkSendHUDAndHeartbeat(void) {
                              mavAltitude,
                              // climb Current climb rate in meters/second
                              mavClimbRate);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
     uint8_t mavModes = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
     if (ARMING_FLAG(ARMED))
         mavModes |= MAV_MODE_FLAG_SAFETY_ARMED;
@@ -479,29 +493,37 @@ void mavlinkSendHUDAndHeartbeat(void) {
                                mavCustomMode,
                                // system_status System status flag, see MAV_STATE ENUM
                                mavSystemState);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
-void processMAVLinkTelemetry(void) {
-    // is executed @ TELEMETRY_MAVLINK_MAXRATE rate
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS)) {
-        mavlinkSendSystemStatus();
+void processMAVLinkTelemetry(timeUs_t currentTimeUs) {
+    mavlinkUpdateBudget(currentTimeUs);
+    mavTxLength = 0;
+    mavTxBuf = serialGetTxBuf(mavlinkPort, &mavTxBufSize);
+    serialBeginWrite(mavlinkPort);
+    // attitude first, it gets the budget when the link is short of it
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1, currentTimeUs)) {
+        mavlinkSendAttitude();
     }
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS)) {
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2, currentTimeUs)) {
+        mavlinkSendHUDAndHeartbeat();
+    }
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS, currentTimeUs)) {
         mavlinkSendRCChannelsAndRSSI();
     }
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS, currentTimeUs)) {
+        mavlinkSendSystemStatus();
+    }
 #ifdef USE_GPS
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION)) {
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION, currentTimeUs)) {
         mavlinkSendPosition();
     }
 #endif
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1)) {
-        mavlinkSendAttitude();
-    }
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2)) {
-        mavlinkSendHUDAndHeartbeat();
+    if (mavTxBuf) {
+        serialCommitTxBuf(mavlinkPort, mavTxLength);
+        mavTxBuf = NULL;
     }
+    serialEndWrite(mavlinkPort);
 }
 
 void handleMAVLinkTelemetry(void) {
@@ -511,11 +533,7 @@ void handleMAVLinkTelemetry(void) {
     if (!mavlinkPort) {
         return;
     }
-    uint32_t now = micros();
-    if ((now - lastMavlinkMessage) >= TELEMETRY_MAVLINK_DELAY) {
-        processMAVLinkTelemetry();
-        lastMavlinkMessage = now;
-    }
+    processMAVLinkTelemetry(micros());
 }
 
 #endif
@@ -204,6 +204,20 @@ static smartPortWriteFrameFn *smartPortWriteFrame;
 static bool smartPortMspReplyPending = false;
 #endif
 
+// Sensor frames are computed ahead of the poll, the response window is too short to
+// find and format a value in. Kept small so the values sent are at most a few polls old.
+#define SMARTPORT_FRAME_QUEUE_SIZE 2
+
+typedef struct smartPortQueuedFrame_s {
+    smartPortPayload_t payload;
+    uint8_t length; // of the byte stuffed frame in data, 0 when sent through smartPortWriteFrame
+    uint8_t data[SMARTPORT_STUFFED_FRAME_MAX_SIZE];
+} smartPortQueuedFrame_t;
+
+static smartPortQueuedFrame_t smartPortFrameQueue[SMARTPORT_FRAME_QUEUE_SIZE];
+static uint8_t smartPortFrameQueueTail = 0;
+static uint8_t smartPortFrameQueueCount = 0;
+
 smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPortCheckQueueEmptyFn *checkQueueEmpty, bool useChecksum) {
     static uint8_t rxBuffer[sizeof(smartPortPayload_t)];
     static uint8_t smartPortRxBytes = 0;
@@ -258,17 +272,29 @@ smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPor
     return NULL;
 }
 
-void smartPortSendByte(uint8_t c, uint16_t *checksum, serialPort_t *port) {
+uint8_t smartPortStuffByte(uint8_t c, uint16_t *checksum, uint8_t *buf) {
+    if (checksum != NULL) {
+        *checksum += c;
+    }
     // smart port escape sequence
     if (c == FSSP_DLE || c == FSSP_START_STOP) {
-        serialWrite(port, FSSP_DLE);
-        serialWrite(port, c ^ FSSP_DLE_XOR);
-    } else {
-        serialWrite(port, c);
+        buf[0] = FSSP_DLE;
+        buf[1] = c ^ FSSP_DLE_XOR;
+        return 2;
     }
-    if (checksum != NULL) {
-        *checksum += c;
+    buf[0] = c;
+    return 1;
+}
+
+uint8_t smartPortEncodeFrame(const smartPortPayload_t *payload, uint16_t checksum, uint8_t *buf) {
+    const uint8_t *data = (const uint8_t *)payload;
+    uint8_t length = 0;
+    for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
+        length += smartPortStuffByte(*data++, &checksum, buf + length);
     }
+    checksum = 0xff - ((checksum & 0xff) + (checksum >> 8));
+    length += smartPortStuffByte((uint8_t)checksum, NULL, buf + length);
+    return length;
 }
 
 bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload) {
@@ -276,24 +302,43 @@ bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload) {
 }
 
 void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum) {
-    uint8_t *data = (uint8_t *)payload;
-    for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
-        smartPortSendByte(*data++, &checksum, port);
-    }
-    checksum = 0xff - ((checksum & 0xff) + (checksum >> 8));
-    smartPortSendByte((uint8_t)checksum, NULL, port);
+    uint8_t frame[SMARTPORT_STUFFED_FRAME_MAX_SIZE];
+    const uint8_t length = smartPortEncodeFrame(payload, checksum, frame);
+    serialBeginWrite(port);
+    serialWriteBuf(port, frame, length);
+    serialEndWrite(port);
 }
 
 static void smartPortWriteFrameInternal(const smartPortPayload_t *payload) {
     smartPortWriteFrameSerial(payload, smartPortSerialPort, 0);
 }
 
-static void smartPortSendPackage(uint16_t id, uint32_t val) {
-    smartPortPayload_t payload;
-    payload.frameId = FSSP_DATA_FRAME;
-    payload.valueId = id;
-    payload.data = val;
-    smartPortWriteFrame(&payload);
+static void smartPortQueuePackage(uint16_t id, uint32_t val) {
+    smartPortQueuedFrame_t *frame = &smartPortFrameQueue[(smartPortFrameQueueTail + smartPortFrameQueueCount) % SMARTPORT_FRAME_QUEUE_SIZE];
+    frame->payload.frameId = FSSP_DATA_FRAME;
+    frame->payload.valueId = id;
+    frame->payload.data = val;
+    // on our own port the frame is stuffed now, so answering a poll is a single buffer write
+    frame->length = (telemetryState == TELEMETRY_STATE_INITIALIZED_SERIAL) ? smartPortEncodeFrame(&frame->payload, 0, frame->data) : 0;
+    smartPortFrameQueueCount++;
+}
+
+static void smartPortSendQueuedFrame(void) {
+    const smartPortQueuedFrame_t *frame = &smartPortFrameQueue[smartPortFrameQueueTail];
+    if (frame->length) {
+        serialBeginWrite(smartPortSerialPort);
+        serialWriteBuf(smartPortSerialPort, frame->data, frame->length);
+        serialEndWrite(smartPortSerialPort);
+    } else {
+        smartPortWriteFrame(&frame->payload);
+    }
+    smartPortFrameQueueTail = (smartPortFrameQueueTail + 1) % SMARTPORT_FRAME_QUEUE_SIZE;
+    smartPortFrameQueueCount--;
+}
+
+static void smartPortResetFrameQueue(void) {
+    smartPortFrameQueueTail = 0;
+    smartPortFrameQueueCount = 0;
 }
 
 #ifdef USE_ESC_SENSOR
@@ -363,6 +408,7 @@ bool initSmartPortTelemetry(void) {
             smartPortPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_SMARTPORT);
             smartPortWriteFrame = smartPortWriteFrameInternal;
             initSmartPortSensors();
+            smartPortResetFrameQueue();
             telemetryState = TELEMETRY_STATE_INITIALIZED_SERIAL;
         }
         return true;
@@ -374,6 +420,7 @@ bool initSmartPortTelemetryExternal(smartPortWriteFrameFn *smartPortWriteFrameEx
     if (telemetryState == TELEMETRY_STATE_UNINITIALIZED) {
         smartPortWriteFrame = smartPortWriteFrameExternal;
         initSmartPortSensors();
+        smartPortResetFrameQueue();
         telemetryState = TELEMETRY_STATE_INITIALIZED_EXTERNAL;
         return true;
     }
@@ -383,6 +430,7 @@ bool initSmartPortTelemetryExternal(smartPortWriteFrameFn *smartPortWriteFrameEx
 static void freeSmartPortTelemetryPort(void) {
     closeSerialPort(smartPortSerialPort);
     smartPortSerialPort = NULL;
+    smartPortResetFrameQueue();
 }
 
 static void configureSmartPortTelemetryPort(void) {
@@ -412,349 +460,343 @@ static void smartPortSendMspResponse(uint8_t *data) {
 }
 #endif
 
-void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout) {
+// Formats the value of the next sensor in the tables into the frame queue, if it has one to report
+static void smartPortQueueNextSensor(void) {
     static uint8_t smartPortIdCycleCnt = 0;
     static uint8_t t1Cnt = 0;
     static uint8_t t2Cnt = 0;
-    static uint8_t skipRequests = 0;
 #ifdef USE_ESC_SENSOR
     static uint8_t smartPortIdOffset = 0;
 #endif
-#if defined(USE_MSP_OVER_TELEMETRY)
-    if (skipRequests) {
-        skipRequests--;
-    } else if (payload && smartPortPayloadContainsMSP(payload)) {
-        // Do not check the physical ID here again
-        // unless we start receiving other sensors' packets
-        // Pass only the payload: skip frameId
-        uint8_t *frameStart = (uint8_t *)&payload->valueId;
-        smartPortMspReplyPending = handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE, &skipRequests);
-        // Don't send MSP response after write to eeprom
-        // CPU just got out of suspended state after writeEEPROM()
-        // We don't know if the receiver is listening again
-        // Skip a few telemetry requests before sending response
-        if (skipRequests) {
-            *clearToSend = false;
-        }
-    }
-#else
-    UNUSED(payload);
-#endif
-    bool doRun = true;
-    while (doRun && *clearToSend && !skipRequests) {
-        // Ensure we won't get stuck in the loop if there happens to be nothing available to send in a timely manner - dump the slot if we loop in there for too long.
-        if (requestTimeout) {
-            if (cmpTimeUs(micros(), *requestTimeout) >= 0) {
-                *clearToSend = false;
-                return;
-            }
-        } else {
-            doRun = false;
-        }
-#if defined(USE_MSP_OVER_TELEMETRY)
-        if (smartPortMspReplyPending) {
-            smartPortMspReplyPending = sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
-            *clearToSend = false;
-            return;
-        }
-#endif
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+    // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
+    frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
 #ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
-                smartPortIdCycleCnt = 0;
-                smartPortIdOffset++;
-                if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
-                    smartPortIdOffset = 0;
-                }
+    if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
+        // send ESC sensors
+        tableInfo = &frSkyEscDataIdTableInfo;
+        if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
+            tableInfo->index = 0;
+            smartPortIdCycleCnt = 0;
+            smartPortIdOffset++;
+            if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
+                smartPortIdOffset = 0;
             }
         }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
+    }
+    if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
+        // send other sensors
+        tableInfo = &frSkyDataIdTableInfo;
 #endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
-            }
-#ifdef USE_ESC_SENSOR
+        if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
+            tableInfo->index = 0;
         }
+#ifdef USE_ESC_SENSOR
+    }
 #endif
-        uint16_t id = tableInfo->table[tableInfo->index];
+    uint16_t id = tableInfo->table[tableInfo->index];
 #ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
-        }
+    if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
+        id += smartPortIdOffset;
+    }
 #endif
-        smartPortIdCycleCnt++;
-        tableInfo->index++;
-        int32_t tmpi;
-        uint32_t tmp2 = 0;
-        uint16_t vfasVoltage;
-        uint8_t cellCount;
+    smartPortIdCycleCnt++;
+    tableInfo->index++;
+    int32_t tmpi;
+    uint32_t tmp2 = 0;
+    uint16_t vfasVoltage;
+    uint8_t cellCount;
 #ifdef USE_ESC_SENSOR
-        escSensorData_t *escData;
+    escSensorData_t *escData;
 #endif
-        switch (id) {
-        case FSSP_DATAID_VFAS       :
-            vfasVoltage = getBatteryVoltage();
-            if (telemetryConfig()->report_cell_voltage) {
-                cellCount = getBatteryCellCount();
-                vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
-            }
-            smartPortSendPackage(id, vfasVoltage * 10); // given in 0.1V, convert to volts
-            *clearToSend = false;
-            break;
+    switch (id) {
+    case FSSP_DATAID_VFAS       :
+        vfasVoltage = getBatteryVoltage();
+        if (telemetryConfig()->report_cell_voltage) {
+            cellCount = getBatteryCellCount();
+            vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
+        }
+        smartPortQueuePackage(id, vfasVoltage * 10); // given in 0.1V, convert to volts
+        break;
 #ifdef USE_ESC_SENSOR
-        case FSSP_DATAID_VFAS1      :
-        case FSSP_DATAID_VFAS2      :
-        case FSSP_DATAID_VFAS3      :
-        case FSSP_DATAID_VFAS4      :
-        case FSSP_DATAID_VFAS5      :
-        case FSSP_DATAID_VFAS6      :
-        case FSSP_DATAID_VFAS7      :
-        case FSSP_DATAID_VFAS8      :
-            escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
-            if (escData != NULL) {
-                smartPortSendPackage(id, escData->voltage);
-                *clearToSend = false;
-            }
-            break;
+    case FSSP_DATAID_VFAS1      :
+    case FSSP_DATAID_VFAS2      :
+    case FSSP_DATAID_VFAS3      :
+    case FSSP_DATAID_VFAS4      :
+    case FSSP_DATAID_VFAS5      :
+    case FSSP_DATAID_VFAS6      :
+    case FSSP_DATAID_VFAS7      :
+    case FSSP_DATAID_VFAS8      :
+        escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, escData->voltage);
+        }
+        break;
 #endif
-        case FSSP_DATAID_CURRENT    :
-            smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
-            *clearToSend = false;
-            break;
+    case FSSP_DATAID_CURRENT    :
+        smartPortQueuePackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
+        break;
 #ifdef USE_ESC_SENSOR
-        case FSSP_DATAID_CURRENT1   :
-        case FSSP_DATAID_CURRENT2   :
-        case FSSP_DATAID_CURRENT3   :
-        case FSSP_DATAID_CURRENT4   :
-        case FSSP_DATAID_CURRENT5   :
-        case FSSP_DATAID_CURRENT6   :
-        case FSSP_DATAID_CURRENT7   :
-        case FSSP_DATAID_CURRENT8   :
-            escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
-            if (escData != NULL) {
-                smartPortSendPackage(id, escData->current);
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_RPM        :
-            escData = getEscSensorData(ESC_SENSOR_COMBINED);
-            if (escData != NULL) {
-                smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_RPM1       :
-        case FSSP_DATAID_RPM2       :
-        case FSSP_DATAID_RPM3       :
-        case FSSP_DATAID_RPM4       :
-        case FSSP_DATAID_RPM5       :
-        case FSSP_DATAID_RPM6       :
-        case FSSP_DATAID_RPM7       :
-        case FSSP_DATAID_RPM8       :
-            escData = getEscSensorData(id - FSSP_DATAID_RPM1);
-            if (escData != NULL) {
-                smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_TEMP        :
-            escData = getEscSensorData(ESC_SENSOR_COMBINED);
-            if (escData != NULL) {
-                smartPortSendPackage(id, escData->temperature);
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_TEMP1      :
-        case FSSP_DATAID_TEMP2      :
-        case FSSP_DATAID_TEMP3      :
-        case FSSP_DATAID_TEMP4      :
-        case FSSP_DATAID_TEMP5      :
-        case FSSP_DATAID_TEMP6      :
-        case FSSP_DATAID_TEMP7      :
-        case FSSP_DATAID_TEMP8      :
-            escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
-            if (escData != NULL) {
-                smartPortSendPackage(id, escData->temperature);
-                *clearToSend = false;
-            }
-            break;
+    case FSSP_DATAID_CURRENT1   :
+    case FSSP_DATAID_CURRENT2   :
+    case FSSP_DATAID_CURRENT3   :
+    case FSSP_DATAID_CURRENT4   :
+    case FSSP_DATAID_CURRENT5   :
+    case FSSP_DATAID_CURRENT6   :
+    case FSSP_DATAID_CURRENT7   :
+    case FSSP_DATAID_CURRENT8   :
+        escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, escData->current);
+        }
+        break;
+    case FSSP_DATAID_RPM        :
+        escData = getEscSensorData(ESC_SENSOR_COMBINED);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, calcEscRpm(escData->rpm));
+        }
+        break;
+    case FSSP_DATAID_RPM1       :
+    case FSSP_DATAID_RPM2       :
+    case FSSP_DATAID_RPM3       :
+    case FSSP_DATAID_RPM4       :
+    case FSSP_DATAID_RPM5       :
+    case FSSP_DATAID_RPM6       :
+    case FSSP_DATAID_RPM7       :
+    case FSSP_DATAID_RPM8       :
+        escData = getEscSensorData(id - FSSP_DATAID_RPM1);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, calcEscRpm(escData->rpm));
+        }
+        break;
+    case FSSP_DATAID_TEMP        :
+        escData = getEscSensorData(ESC_SENSOR_COMBINED);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, escData->temperature);
+        }
+        break;
+    case FSSP_DATAID_TEMP1      :
+    case FSSP_DATAID_TEMP2      :
+    case FSSP_DATAID_TEMP3      :
+    case FSSP_DATAID_TEMP4      :
+    case FSSP_DATAID_TEMP5      :
+    case FSSP_DATAID_TEMP6      :
+    case FSSP_DATAID_TEMP7      :
+    case FSSP_DATAID_TEMP8      :
+        escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
+        if (escData != NULL) {
+            smartPortQueuePackage(id, escData->temperature);
+        }
+        break;
 #endif
-        case FSSP_DATAID_ALTITUDE   :
-            smartPortSendPackage(id, getEstimatedAltitude()); // unknown given unit, requested 100 = 1 meter
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_FUEL       :
-            smartPortSendPackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_VARIO      :
-            smartPortSendPackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_HEADING    :
-            smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_ACCX       :
-            smartPortSendPackage(id, lrintf(100 * acc.accADC[X] / acc.dev.acc_1G)); // Multiply by 100 to show as x.xx g on Taranis
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_ACCY       :
-            smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] / acc.dev.acc_1G));
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_ACCZ       :
-            smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] / acc.dev.acc_1G));
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_T1         :
-            // we send all the flags as decimal digits for easy reading
-            // the t1Cnt simply allows the telemetry view to show at least some changes
-            t1Cnt++;
-            if (t1Cnt == 4) {
-                t1Cnt = 1;
-            }
-            tmpi = t1Cnt * 10000; // start off with at least one digit so the most significant 0 won't be cut off
-            // the Taranis seems to be able to fit 5 digits on the screen
-            // the Taranis seems to consider this number a signed 16 bit integer
-            if (!isArmingDisabled()) {
-                tmpi += 1;
-            } else {
-                tmpi += 2;
-            }
-            if (ARMING_FLAG(ARMED)) {
-                tmpi += 4;
-            }
-            if (FLIGHT_MODE(ANGLE_MODE)) {
-                tmpi += 10;
-            }
-            if (FLIGHT_MODE(HORIZON_MODE)) {
-                tmpi += 20;
-            }
-            if (FLIGHT_MODE(PASSTHRU_MODE)) {
-                tmpi += 40;
-            }
-            if (FLIGHT_MODE(MAG_MODE)) {
-                tmpi += 100;
-            }
-            if (FLIGHT_MODE(BARO_MODE)) {
-                tmpi += 200;
-            }
-            if (FLIGHT_MODE(GPS_HOLD_MODE)) {
-                tmpi += 1000;
-            }
-            if (FLIGHT_MODE(GPS_HOME_MODE)) {
-                tmpi += 2000;
-            }
-            if (FLIGHT_MODE(HEADFREE_MODE)) {
-                tmpi += 4000;
-            }
-            smartPortSendPackage(id, (uint32_t)tmpi);
-            *clearToSend = false;
-            break;
-        case FSSP_DATAID_T2         :
+    case FSSP_DATAID_ALTITUDE   :
+        smartPortQueuePackage(id, getEstimatedAltitude()); // unknown given unit, requested 100 = 1 meter
+        break;
+    case FSSP_DATAID_FUEL       :
+        smartPortQueuePackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
+        break;
+    case FSSP_DATAID_VARIO      :
+        smartPortQueuePackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
+        break;
+    case FSSP_DATAID_HEADING    :
+        smartPortQueuePackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
+        break;
+    case FSSP_DATAID_ACCX       :
+        smartPortQueuePackage(id, lrintf(100 * acc.accADC[X] / acc.dev.acc_1G)); // Multiply by 100 to show as x.xx g on Taranis
+        break;
+    case FSSP_DATAID_ACCY       :
+        smartPortQueuePackage(id, lrintf(100 * acc.accADC[Y] / acc.dev.acc_1G));
+        break;
+    case FSSP_DATAID_ACCZ       :
+        smartPortQueuePackage(id, lrintf(100 * acc.accADC[Z] / acc.dev.acc_1G));
+        break;
+    case FSSP_DATAID_T1         :
+        // we send all the flags as decimal digits for easy reading
+        // the t1Cnt simply allows the telemetry view to show at least some changes
+        t1Cnt++;
+        if (t1Cnt == 4) {
+            t1Cnt = 1;
+        }
+        tmpi = t1Cnt * 10000; // start off with at least one digit so the most significant 0 won't be cut off
+        // the Taranis seems to be able to fit 5 digits on the screen
+        // the Taranis seems to consider this number a signed 16 bit integer
+        if (!isArmingDisabled()) {
+            tmpi += 1;
+        } else {
+            tmpi += 2;
+        }
+        if (ARMING_FLAG(ARMED)) {
+            tmpi += 4;
+        }
+        if (FLIGHT_MODE(ANGLE_MODE)) {
+            tmpi += 10;
+        }
+        if (FLIGHT_MODE(HORIZON_MODE)) {
+            tmpi += 20;
+        }
+        if (FLIGHT_MODE(PASSTHRU_MODE)) {
+            tmpi += 40;
+        }
+        if (FLIGHT_MODE(MAG_MODE)) {
+            tmpi += 100;
+        }
+        if (FLIGHT_MODE(BARO_MODE)) {
+            tmpi += 200;
+        }
+        if (FLIGHT_MODE(GPS_HOLD_MODE)) {
+            tmpi += 1000;
+        }
+        if (FLIGHT_MODE(GPS_HOME_MODE)) {
+            tmpi += 2000;
+        }
+        if (FLIGHT_MODE(HEADFREE_MODE)) {
+            tmpi += 4000;
+        }
+        smartPortQueuePackage(id, (uint32_t)tmpi);
+        break;
+    case FSSP_DATAID_T2         :
 #ifdef USE_GPS
-            if (sensors(SENSOR_GPS)) {
-                // provide GPS lock status
-                smartPortSendPackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + gpsSol.numSat);
-                *clearToSend = false;
-            } else if (feature(FEATURE_GPS)) {
-                smartPortSendPackage(id, 0);
-                *clearToSend = false;
-            } else
+        if (sensors(SENSOR_GPS)) {
+            // provide GPS lock status
+            smartPortQueuePackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + gpsSol.numSat);
+        } else if (feature(FEATURE_GPS)) {
+            smartPortQueuePackage(id, 0);
+        } else
 #endif
-                if (telemetryConfig()->pidValuesAsTelemetry) {
-                    switch (t2Cnt) {
-                    case 0:
-                        tmp2 = currentPidProfile->pid[PID_ROLL].P;
-                        tmp2 += (currentPidProfile->pid[PID_PITCH].P << 8);
-                        tmp2 += (currentPidProfile->pid[PID_YAW].P << 16);
-                        break;
-                    case 1:
-                        tmp2 = currentPidProfile->pid[PID_ROLL].I;
-                        tmp2 += (currentPidProfile->pid[PID_PITCH].I << 8);
-                        tmp2 += (currentPidProfile->pid[PID_YAW].I << 16);
-                        break;
-                    case 2:
-                        tmp2 = currentPidProfile->pid[PID_ROLL].D;
-                        tmp2 += (currentPidProfile->pid[PID_PITCH].D << 8);
-                        tmp2 += (currentPidProfile->pid[PID_YAW].D << 16);
-                        break;
-                    case 3:
-                        tmp2 = currentControlRateProfile->rates[FD_ROLL];
-                        tmp2 += (currentControlRateProfile->rates[FD_PITCH] << 8);
-                        tmp2 += (currentControlRateProfile->rates[FD_YAW] << 16);
-                        break;
-                    }
-                    tmp2 += t2Cnt << 24;
-                    t2Cnt++;
-                    if (t2Cnt == 4) {
-                        t2Cnt = 0;
-                    }
-                    smartPortSendPackage(id, tmp2);
-                    *clearToSend = false;
+            if (telemetryConfig()->pidValuesAsTelemetry) {
+                switch (t2Cnt) {
+                case 0:
+                    tmp2 = currentPidProfile->pid[PID_ROLL].P;
+                    tmp2 += (currentPidProfile->pid[PID_PITCH].P << 8);
+                    tmp2 += (currentPidProfile->pid[PID_YAW].P << 16);
+                    break;
+                case 1:
+                    tmp2 = currentPidProfile->pid[PID_ROLL].I;
+                    tmp2 += (currentPidProfile->pid[PID_PITCH].I << 8);
+                    tmp2 += (currentPidProfile->pid[PID_YAW].I << 16);
+                    break;
+                case 2:
+                    tmp2 = currentPidProfile->pid[PID_ROLL].D;
+                    tmp2 += (currentPidProfile->pid[PID_PITCH].D << 8);
+                    tmp2 += (currentPidProfile->pid[PID_YAW].D << 16);
+                    break;
+                case 3:
+                    tmp2 = currentControlRateProfile->rates[FD_ROLL];
+                    tmp2 += (currentControlRateProfile->rates[FD_PITCH] << 8);
+                    tmp2 += (currentControlRateProfile->rates[FD_YAW] << 16);
+                    break;
                 }
-            break;
-#ifdef USE_GPS
-        case FSSP_DATAID_SPEED      :
-            if (STATE(GPS_FIX)) {
-                //convert to knots: 1cm/s = 0.0194384449 knots
-                //Speed should be sent in knots/1000 (GPS speed is in cm/s)
-                uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
-                smartPortSendPackage(id, tmpui);
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_LATLONG    :
-            if (STATE(GPS_FIX)) {
-                uint32_t tmpui = 0;
-                // the same ID is sent twice, one for longitude, one for latitude
-                // the MSB of the sent uint32_t helps FrSky keep track
-                // the even/odd bit of our counter helps us keep track
-                if (tableInfo->index & 1) {
-                    tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
-                    tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
-                    if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
-                } else {
-                    tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
-                    tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
-                    if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
+                tmp2 += t2Cnt << 24;
+                t2Cnt++;
+                if (t2Cnt == 4) {
+                    t2Cnt = 0;
                 }
-                smartPortSendPackage(id, tmpui);
-                *clearToSend = false;
+                smartPortQueuePackage(id, tmp2);
             }
-            break;
-        case FSSP_DATAID_HOME_DIST  :
-            if (STATE(GPS_FIX)) {
-                smartPortSendPackage(id, GPS_distanceToHome);
-                *clearToSend = false;
-            }
-            break;
-        case FSSP_DATAID_GPS_ALT    :
-            if (STATE(GPS_FIX)) {
-                smartPortSendPackage(id, gpsSol.llh.alt); // given in 0.01m
-                *clearToSend = false;
+        break;
+#ifdef USE_GPS
+    case FSSP_DATAID_SPEED      :
+        if (STATE(GPS_FIX)) {
+            //convert to knots: 1cm/s = 0.0194384449 knots
+            //Speed should be sent in knots/1000 (GPS speed is in cm/s)
+            uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
+            smartPortQueuePackage(id, tmpui);
+        }
+        break;
+    case FSSP_DATAID_LATLONG    :
+        if (STATE(GPS_FIX)) {
+            uint32_t tmpui = 0;
+            // the same ID is sent twice, one for longitude, one for latitude
+            // the MSB of the sent uint32_t helps FrSky keep track
+            // the even/odd bit of our counter helps us keep track
+            if (tableInfo->index & 1) {
+                tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
+                tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
+                if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
+            } else {
+                tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
+                tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
+                if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
             }
-            break;
+            smartPortQueuePackage(id, tmpui);
+        }
+        break;
+    case FSSP_DATAID_HOME_DIST  :
+        if (STATE(GPS_FIX)) {
+            smartPortQueuePackage(id, GPS_distanceToHome);
+        }
+        break;
+    case FSSP_DATAID_GPS_ALT    :
+        if (STATE(GPS_FIX)) {
+            smartPortQueuePackage(id, gpsSol.llh.alt); // given in 0.01m
+        }
+        break;
 #endif
-        case FSSP_DATAID_A4         :
-            cellCount = getBatteryCellCount();
-            vfasVoltage = cellCount ? (getBatteryVoltage() * 10 / cellCount) : 0; // given in 0.1V, convert to volts
-            smartPortSendPackage(id, vfasVoltage);
+    case FSSP_DATAID_A4         :
+        cellCount = getBatteryCellCount();
+        vfasVoltage = cellCount ? (getBatteryVoltage() * 10 / cellCount) : 0; // given in 0.1V, convert to volts
+        smartPortQueuePackage(id, vfasVoltage);
+        break;
+    default:
+        break;
+        // nothing to report for this sensor, the counters already moved on to the next one
+    }
+}
+
+// Tops up the frame queue, stops at the deadline or after a pass over the tables that found nothing to report
+static void smartPortFillFrameQueue(const timeUs_t *deadline) {
+    for (unsigned tries = 0; smartPortFrameQueueCount < SMARTPORT_FRAME_QUEUE_SIZE && tries < 2 * MAX_DATAIDS; tries++) {
+        if (deadline && cmpTimeUs(micros(), *deadline) >= 0) {
+            return;
+        }
+        smartPortQueueNextSensor();
+    }
+}
+
+void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout) {
+    static uint8_t skipRequests = 0;
+#if defined(USE_MSP_OVER_TELEMETRY)
+    if (skipRequests) {
+        skipRequests--;
+    } else if (payload && smartPortPayloadContainsMSP(payload)) {
+        // Do not check the physical ID here again
+        // unless we start receiving other sensors' packets
+        // Pass only the payload: skip frameId
+        uint8_t *frameStart = (uint8_t *)&payload->valueId;
+        smartPortMspReplyPending = handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE, &skipRequests);
+        // Don't send MSP response after write to eeprom
+        // CPU just got out of suspended state after writeEEPROM()
+        // We don't know if the receiver is listening again
+        // Skip a few telemetry requests before sending response
+        if (skipRequests) {
             *clearToSend = false;
-            break;
-        default:
-            break;
-            // if nothing is sent, hasRequest isn't cleared, we already incremented the counter, just loop back to the start
         }
     }
+#else
+    UNUSED(payload);
+#endif
+    if (!*clearToSend || skipRequests) {
+        return;
+    }
+#if defined(USE_MSP_OVER_TELEMETRY)
+    if (smartPortMspReplyPending) {
+        smartPortMspReplyPending = sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
+        *clearToSend = false;
+        return;
+    }
+#endif
+    if (!smartPortFrameQueueCount) {
+        // nothing computed ahead, look for a value within the response window
+        smartPortFillFrameQueue(requestTimeout);
+    }
+    if (smartPortFrameQueueCount) {
+        smartPortSendQueuedFrame();
+        *clearToSend = false;
+        // prepare the answer to the next poll while this one is being sent
+        smartPortFillFrameQueue(NULL);
+    } else if (requestTimeout) {
+        // dump the slot rather than answer late
+        *clearToSend = false;
+    }
 }
 
 static bool serialCheckQueueEmpty(void) {
@@ -59,6 +59,9 @@ typedef struct smartPortPayload_s {
     uint32_t data;
 } __attribute__((packed)) smartPortPayload_t;
 
+// payload and checksum with every byte escaped
+#define SMARTPORT_STUFFED_FRAME_MAX_SIZE ((sizeof(smartPortPayload_t) + 1) * 2)
+
 typedef void smartPortWriteFrameFn(const smartPortPayload_t *payload);
 typedef bool smartPortCheckQueueEmptyFn(void);
 
@@ -73,5 +76,6 @@ smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPor
 
 struct serialPort_s;
 void smartPortWriteFrameSerial(const smartPortPayload_t *payload, struct serialPort_s *port, uint16_t checksum);
-void smartPortSendByte(uint8_t c, uint16_t *checksum, struct serialPort_s *port);
+uint8_t smartPortStuffByte(uint8_t c, uint16_t *checksum, uint8_t *buf);
+uint8_t smartPortEncodeFrame(const smartPortPayload_t *payload, uint16_t checksum, uint8_t *buf);
 bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload);
@@ -59,7 +59,7 @@
 #include "telemetry/ibus.h"
 #include "telemetry/msp_shared.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 3);
 
 PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
                   .telemetry_inverted = false,
@@ -78,6 +78,11 @@ PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     IBUS_SENSOR_TYPE_EXTERNAL_VOLTAGE
 },
 .smartport_use_extra_sensors = false,
+.mavlink_extended_status_rate = 2,
+.mavlink_rc_channels_rate = 5,
+.mavlink_position_rate = 2,
+.mavlink_extra1_rate = 10,
+.mavlink_extra2_rate = 10,
                  );
 
 void telemetryInit(void) {
@@ -54,6 +54,11 @@ typedef struct telemetryConfig_s {
     uint8_t report_cell_voltage;
     uint8_t flysky_sensors[IBUS_SENSOR_COUNT];
     uint8_t smartport_use_extra_sensors;
+    uint8_t mavlink_extended_status_rate;   // MAVLink stream rates in Hz, 0 to disable the stream
+    uint8_t mavlink_rc_channels_rate;
+    uint8_t mavlink_position_rate;
+    uint8_t mavlink_extra1_rate;
+    uint8_t mavlink_extra2_rate;
 } telemetryConfig_t;
 
 PG_DECLARE(telemetryConfig_t, telemetryConfig);
@@ -55,6 +55,7 @@
 #include "usbd_cdc.h"
 #include "usbd_cdc_interface.h"
 #include "stdbool.h"
+#include <string.h>
 
 #include "drivers/nvic.h"
 #include "build/atomic.h"
@@ -349,15 +350,23 @@ uint32_t CDC_Send_FreeBytes(void) {
  * @retval Bytes sent
  */
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength) {
-    for (uint32_t i = 0; i < sendLength; i++) {
-        while (CDC_Send_FreeBytes() == 0) {
+    uint32_t remaining = sendLength;
+    while (remaining > 0) {
+        uint32_t freeBytes;
+        while ((freeBytes = CDC_Send_FreeBytes()) == 0) {
             // block until there is free space in the ring buffer
             delay(1);
         }
-        ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) { // Paranoia
-            UserTxBuffer[UserTxBufPtrIn] = ptrBuffer[i];
-            UserTxBufPtrIn = (UserTxBufPtrIn + 1) % APP_TX_DATA_SIZE;
+        // the timer only moves UserTxBufPtrOut once a block has been sent, so the free
+        // part can be copied without the lock and published with a single store
+        const uint32_t in = UserTxBufPtrIn;
+        const uint32_t chunk = MIN(remaining, MIN(freeBytes, APP_TX_DATA_SIZE - in));
+        memcpy((uint8_t *)&UserTxBuffer[in], ptrBuffer, chunk);
+        ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) {
+            UserTxBufPtrIn = (in + chunk) % APP_TX_DATA_SIZE;
         }
+        ptrBuffer += chunk;
+        remaining -= chunk;
     }
     return sendLength;
 }
@@ -66,7 +66,7 @@
 #define USBD_SUPPORT_USER_STRING              0
 #define USBD_SELF_POWERED                     1
 #define USBD_DEBUG_LEVEL                      0
-#define MSC_MEDIA_PACKET                      512
+#define MSC_MEDIA_PACKET                      4096
 #define USE_USB_FS
 
 /* Exported macro ------------------------------------------------------------*/
@@ -27,11 +27,12 @@
 #include "usbd_cdc_vcp.h"
 #include "stm32f4xx_conf.h"
 #include "stdbool.h"
+#include <string.h>
+#include "common/maths.h"
 #include "drivers/time.h"
 
 LINE_CODING g_lc;
 
-extern __IO uint8_t USB_Tx_State;
 __IO uint32_t bDeviceState = UNCONNECTED; /* USB device status */
 
 /* These are external variables imported from CDC core to be used for IN transfer management. */
@@ -183,17 +184,23 @@ uint32_t CDC_Send_FreeBytes(void) {
  */
 static uint16_t VCP_DataTx(const uint8_t* Buf, uint32_t Len) {
     /*
-        make sure that any paragraph end frame is not in play
-        could just check for: USB_CDC_ZLP, but better to be safe
-        and wait for any existing transmission to complete.
+        the stack moves APP_Rx_ptr_out past a packet as soon as it is queued, but the
+        fifo only reads it when the endpoint empties, so one packet behind the out
+        pointer stays reserved. Everything else can be filled while the endpoint
+        is busy, the sof handler picks up the new data once the transfer ends.
     */
-    while (USB_Tx_State != 0);
-    for (uint32_t i = 0; i < Len; i++) {
-        APP_Rx_Buffer[APP_Rx_ptr_in] = Buf[i];
-        APP_Rx_ptr_in = (APP_Rx_ptr_in + 1) % APP_RX_DATA_SIZE;
-        while (CDC_Send_FreeBytes() == 0) {
+    while (Len > 0) {
+        uint32_t freeBytes;
+        while ((freeBytes = CDC_Send_FreeBytes()) <= CDC_DATA_MAX_PACKET_SIZE) {
             delay(1);
         }
+        freeBytes -= CDC_DATA_MAX_PACKET_SIZE;
+        const uint32_t in = APP_Rx_ptr_in;
+        const uint32_t chunk = MIN(Len, MIN(freeBytes, APP_RX_DATA_SIZE - in));
+        memcpy(&APP_Rx_Buffer[in], Buf, chunk);
+        APP_Rx_ptr_in = (in + chunk) % APP_RX_DATA_SIZE; // publish the whole chunk at once
+        Buf += chunk;
+        Len -= chunk;
     }
     return USBD_OK;
 }
@@ -0,0 +1,369 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Host micro-benchmarks of the gyro and D term filter kernels. Every case processes one
+// gyro sample on all three axes, the way the gyro task does, and reports the cost per sample.
+// Host numbers don't translate to F4/F7 cycles, compare them against a run of the base revision.
+// Each case also has a budget in multiples of the cost of the pt1 case, which follows the speed of the host
+// well enough to be checked anywhere: with -c a case over its budget fails the run.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/kalman.h"
+#include "common/lulu.h"
+#include "common/maths.h"
+#include "common/sdft.h"
+#include "common/utils.h"
+
+#include "fc/fc_rc.h"
+
+#include "sensors/gyro.h"
+
+#define BENCHMARK_SAMPLE_RATE_HZ    8000
+#define BENCHMARK_LOOPTIME_US       (1000000 / BENCHMARK_SAMPLE_RATE_HZ)
+#define BENCHMARK_SAMPLE_COUNT      4096
+#define BENCHMARK_MIN_DURATION_NS   200000000LL
+#define BENCHMARK_DYN_NOTCH_COUNT   3
+
+// stubs for what the benchmarked sources reference
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+uint8_t debugModeSlot[DEBUG_COUNT];
+volatile bool isSetpointNew;
+gyro_t gyro;
+gyroConfig_t gyroConfig_System;
+
+typedef struct benchmark_s {
+    const char *name;
+    void (*init)(void);
+    float (*apply)(const float *sample);
+    float budget;       // most it may cost in pt1 runs, about twice what it takes now, 0 for no limit
+} benchmark_t;
+
+static float benchmarkInput[BENCHMARK_SAMPLE_COUNT][XYZ_AXIS_COUNT];
+static volatile float benchmarkSink;
+
+static pt1Filter_t pt1[2][XYZ_AXIS_COUNT];
+static ptnFilter_t ptn[XYZ_AXIS_COUNT];
+static biquadFilter_t biquad[2][XYZ_AXIS_COUNT];
+static biquadFilterX3_t notchX3[2];
+static biquadFilter_t dynNotch[XYZ_AXIS_COUNT][BENCHMARK_DYN_NOTCH_COUNT];
+static alphaBetaGammaFilterX3_t abg;
+static luluFilter_t lulu[XYZ_AXIS_COUNT];
+static sdft_t sdft[XYZ_AXIS_COUNT];
+
+static const float dT = BENCHMARK_LOOPTIME_US * 1e-6f;
+
+static int64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// gyro like input: a few motor noise lines on top of slow stick movement and broadband noise
+static void generateInput(void) {
+    srand(1);
+    for (int i = 0; i < BENCHMARK_SAMPLE_COUNT; i++) {
+        const float t = i * dT;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const float noise = ((float)rand() / RAND_MAX - 0.5f) * 20.0f;
+            benchmarkInput[i][axis] = 200.0f * sinf(2.0f * M_PIf * 2.0f * t + axis)
+                + 30.0f * sinf(2.0f * M_PIf * (180.0f + 20.0f * axis) * t)
+                + 10.0f * sinf(2.0f * M_PIf * 360.0f * t)
+                + noise;
+        }
+    }
+}
+
+static void initPt1(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&pt1[0][axis], pt1FilterGain(100, dT));
+        pt1FilterInit(&pt1[1][axis], pt1FilterGain(150, dT));
+    }
+}
+
+static float applyPt1(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += pt1FilterApply(&pt1[0][axis], sample[axis]);
+    }
+    return out;
+}
+
+static void initPt4(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        ptnFilterInit(&ptn[axis], 4, 100, dT);
+    }
+}
+
+static float applyPtn(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += ptnFilterApply(&ptn[axis], sample[axis]);
+    }
+    return out;
+}
+
+static void initBiquadLpf(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInitLPF(&biquad[0][axis], 150, BENCHMARK_LOOPTIME_US);
+        biquadFilterInitLPF(&biquad[1][axis], 250, BENCHMARK_LOOPTIME_US);
+    }
+}
+
+static float applyBiquadLpf(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += biquadFilterApply(&biquad[0][axis], sample[axis]);
+    }
+    return out;
+}
+
+static float applyBiquadLpfDF1(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += biquadFilterApplyDF1(&biquad[0][axis], sample[axis]);
+    }
+    return out;
+}
+
+static void initNotchX3(void) {
+    biquadFilterInitX3(&notchX3[0], 260, BENCHMARK_LOOPTIME_US, filterGetNotchQ(260, 160), FILTER_NOTCH);
+    biquadFilterInitX3(&notchX3[1], 400, BENCHMARK_LOOPTIME_US, filterGetNotchQ(400, 300), FILTER_NOTCH);
+}
+
+static float applyNotchX3(const float *sample) {
+    float axes[XYZ_AXIS_COUNT] = { sample[X], sample[Y], sample[Z] };
+    biquadFilterApplyX3(&notchX3[0], axes);
+    return axes[X] + axes[Y] + axes[Z];
+}
+
+static void initDynNotch(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int i = 0; i < BENCHMARK_DYN_NOTCH_COUNT; i++) {
+            const float center = 180.0f + 100.0f * i;
+            biquadFilterInit(&dynNotch[axis][i], center, BENCHMARK_LOOPTIME_US, filterGetNotchQ(center, center * 0.8f), FILTER_NOTCH);
+        }
+    }
+}
+
+static float applyDynNotch(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += biquadFilterCascadeApplyDF1(dynNotch[axis], BENCHMARK_DYN_NOTCH_COUNT, sample[axis]);
+    }
+    return out;
+}
+
+static void initAbg(void) {
+    ABGInitX3(&abg, 0.3f, 35, 50, dT);
+}
+
+static float applyAbg(const float *sample) {
+    float axes[XYZ_AXIS_COUNT] = { sample[X], sample[Y], sample[Z] };
+    alphaBetaGammaApplyX3(&abg, axes);
+    return axes[X] + axes[Y] + axes[Z];
+}
+
+static void initLulu(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        luluFilterInit(&lulu[axis], 3);
+    }
+}
+
+static float applyLulu(const float *sample) {
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        out += luluFilterApply(&lulu[axis], sample[axis]);
+    }
+    return out;
+}
+
+static void initSdft(void) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sdftInit(&sdft[axis], 1, SDFT_BIN_COUNT - 1, 1);
+    }
+}
+
+static float applySdft(const float *sample) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sdftPush(&sdft[axis], &sample[axis]);
+    }
+    return sample[X];
+}
+
+static void initKalman(void) {
+    gyroConfig_System.imuf_w = 32;
+    gyroConfig_System.imuf_roll_q = 3000;
+    gyroConfig_System.imuf_pitch_q = 3000;
+    gyroConfig_System.imuf_yaw_q = 3000;
+    gyro.targetLooptime = BENCHMARK_LOOPTIME_US;
+    kalman_init();
+}
+
+static float applyKalman(const float *sample) {
+    float axes[XYZ_AXIS_COUNT] = { sample[X], sample[Y], sample[Z] };
+    kalman_update_x3(axes);
+    update_kalman_covariance_x3(axes);
+    return axes[X] + axes[Y] + axes[Z];
+}
+
+// the gyro_filter_impl.h stage order with the default stages enabled
+static void initGyroChainDefault(void) {
+    initKalman();
+    initPt1();
+    initNotchX3();
+    initDynNotch();
+}
+
+static float applyGyroChainDefault(const float *sample) {
+    float axes[XYZ_AXIS_COUNT] = { sample[X], sample[Y], sample[Z] };
+    kalman_update_x3(axes);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        axes[axis] = pt1FilterApply(&pt1[0][axis], axes[axis]);
+    }
+    biquadFilterApplyX3(&notchX3[0], axes);
+    biquadFilterApplyX3(&notchX3[1], axes);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        axes[axis] = biquadFilterCascadeApplyDF1(dynNotch[axis], BENCHMARK_DYN_NOTCH_COUNT, axes[axis]);
+    }
+    update_kalman_covariance_x3(axes);
+    return axes[X] + axes[Y] + axes[Z];
+}
+
+static void initGyroChainBiquad(void) {
+    initKalman();
+    initBiquadLpf();
+    initDynNotch();
+}
+
+static float applyGyroChainBiquad(const float *sample) {
+    float axes[XYZ_AXIS_COUNT] = { sample[X], sample[Y], sample[Z] };
+    kalman_update_x3(axes);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float filtered = biquadFilterApply(&biquad[1][axis], axes[axis]);
+        filtered = biquadFilterApply(&biquad[0][axis], filtered);
+        axes[axis] = biquadFilterCascadeApplyDF1(dynNotch[axis], BENCHMARK_DYN_NOTCH_COUNT, filtered);
+    }
+    update_kalman_covariance_x3(axes);
+    return axes[X] + axes[Y] + axes[Z];
+}
+
+// D term: derivative followed by the two lowpass stages
+static float applyDtermChain(const float *sample) {
+    static float previous[XYZ_AXIS_COUNT];
+    float out = 0;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float delta = (previous[axis] - sample[axis]) / dT;
+        previous[axis] = sample[axis];
+        delta = pt1FilterApply(&pt1[0][axis], delta);
+        out += pt1FilterApply(&pt1[1][axis], delta);
+    }
+    return out;
+}
+
+static const benchmark_t benchmarks[] = {
+    { "pt1",                    initPt1,                applyPt1,               0 },
+    { "pt4",                    initPt4,                applyPtn,               5 },
+    { "biquad lpf df2t",        initBiquadLpf,          applyBiquadLpf,         2.5f },
+    { "biquad lpf df1",         initBiquadLpf,          applyBiquadLpfDF1,      3 },
+    { "biquad notch x3",        initNotchX3,            applyNotchX3,           2.5f },
+    { "dyn notch cascade",      initDynNotch,           applyDynNotch,          7 },
+    { "alpha beta gamma",       initAbg,                applyAbg,               10 },
+    { "lulu n=3",               initLulu,               applyLulu,              70 },
+    { "sdft push",              initSdft,               applySdft,              75 },
+    { "kalman",                 initKalman,             applyKalman,            6 },
+    { "chain gyro default",     initGyroChainDefault,   applyGyroChainDefault,  16 },
+    { "chain gyro biquad",      initGyroChainBiquad,    applyGyroChainBiquad,   12 },
+    { "chain dterm",            initPt1,                applyDtermChain,        4 },
+};
+
+static double runBenchmark(const benchmark_t *benchmark) {
+    benchmark->init();
+    float sum = 0;
+    // one untimed pass to settle the filter state and warm the caches
+    for (int i = 0; i < BENCHMARK_SAMPLE_COUNT; i++) {
+        sum += benchmark->apply(benchmarkInput[i]);
+    }
+    int64_t samples = 0;
+    const int64_t startNs = nowNs();
+    int64_t elapsedNs;
+    do {
+        for (int i = 0; i < BENCHMARK_SAMPLE_COUNT; i++) {
+            sum += benchmark->apply(benchmarkInput[i]);
+        }
+        samples += BENCHMARK_SAMPLE_COUNT;
+        elapsedNs = nowNs() - startNs;
+    } while (elapsedNs < BENCHMARK_MIN_DURATION_NS);
+    benchmarkSink = sum;
+    return (double)elapsedNs / samples;
+}
+
+// usage: dsp_benchmark [-c] [name filter]
+int main(int argc, char *argv[]) {
+    memset(debugModeSlot, DEBUG_SLOT_NONE, sizeof(debugModeSlot));
+    bool check = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "c")) != -1) {
+        if (opt == 'c') {
+            check = true;
+        } else {
+            fprintf(stderr, "usage: %s [-c] [name filter]\n", argv[0]);
+            return 2;
+        }
+    }
+    const char *filter = optind < argc ? argv[optind] : NULL;
+    generateInput();
+    printf("%d axis samples at %dHz\n", XYZ_AXIS_COUNT, BENCHMARK_SAMPLE_RATE_HZ);
+    printf("%-24s %10s %13s %8s %8s\n", "", "ns/sample", "Msamples/s", "x pt1", "budget");
+    // the reference every budget is relative to
+    const double referenceNs = runBenchmark(&benchmarks[0]);
+    int overBudget = 0;
+    for (unsigned i = 0; i < ARRAYLEN(benchmarks); i++) {
+        const benchmark_t *benchmark = &benchmarks[i];
+        if (filter && !strstr(benchmark->name, filter)) {
+            continue;
+        }
+        const double nsPerSample = i == 0 ? referenceNs : runBenchmark(benchmark);
+        const double cost = nsPerSample / referenceNs;
+        const bool over = benchmark->budget > 0 && cost > benchmark->budget;
+        printf("%-24s %10.2f %13.2f %8.2f %8.2f%s\n", benchmark->name, nsPerSample, 1000.0 / nsPerSample,
+            cost, (double)benchmark->budget, over ? "  OVER BUDGET" : "");
+        overBudget += over;
+    }
+    if (check && overBudget) {
+        printf("%d over budget\n", overBudget);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,512 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays the raw gyro capture of a blackbox log (blackbox_gyro_capture_ms) through the
+// firmware gyro stack, gyroUpdate() with its filter chain and the dynamic notch analysis,
+// once per config given on the command line, and reports the noise left, the delay added
+// and the host cost per sample of each. Every config runs in its own process so the
+// static filter state of one can't leak into the next.
+//
+// usage: gyro_replay [-l log] <log.bbl> [name=value[,name=value...]]...
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "config/feature.h"
+
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_fake.h"
+#include "drivers/accgyro/gyro_sync.h"
+#include "drivers/sensor.h"
+
+#include "fc/fc_core.h"
+
+#include "io/beeper.h"
+
+#include "pg/pg.h"
+
+#include "scheduler/scheduler.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/gyro.h"
+#include "sensors/sensors.h"
+
+#define REPLAY_MAX_LAG_US           20000   // longest filter delay searched for
+#define REPLAY_REFERENCE_HZ         100     // noise is what is left above this
+#define REPLAY_SETTLE_US            200000  // skipped while the filters settle
+
+// the device of the first gyro in gyro.c, exported to the unit test build
+extern gyroDev_t * const gyroDevPtr;
+
+// stubs for what the replayed sources reference
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+uint8_t debugModeSlot[DEBUG_COUNT];
+volatile bool isSetpointNew;
+uint8_t detectedSensors[SENSOR_INDEX_COUNT] = { GYRO_NONE, ACC_NONE };
+static bool dynamicFilterEnabled = true;
+static timeUs_t replayTimeUs;
+static uint32_t replayLooptimeUs;
+
+bool feature(uint32_t mask) {
+    return (mask & FEATURE_DYNAMIC_FILTER) && dynamicFilterEnabled;
+}
+uint32_t micros(void) {
+    return replayTimeUs;
+}
+void beeper(beeperMode_e mode) {
+    UNUSED(mode);
+}
+void sensorsSet(uint32_t mask) {
+    UNUSED(mask);
+}
+void schedulerResetTaskStatistics(cfTaskId_e taskId) {
+    UNUSED(taskId);
+}
+int getArmingDisableFlags(void) {
+    return 0;
+}
+uint8_t calculateThrottlePercentAbs(void) {
+    return 0;
+}
+// the fake gyro samples at the logged rate, which sets gyro.targetLooptime before the filters are set up
+uint32_t gyroSetSampleRate(gyroDev_t *gyro, uint8_t lpf, uint8_t gyroSyncDenominator, bool gyro_use_32khz) {
+    UNUSED(lpf);
+    UNUSED(gyroSyncDenominator);
+    UNUSED(gyro_use_32khz);
+    gyro->mpuDividerDrops = 0;
+    gyroConfigMutable()->gyroSampleRateHz = 1000000 / replayLooptimeUs;
+    return replayLooptimeUs;
+}
+
+typedef struct replayLog_s {
+    uint32_t looptimeUs;
+    float scale;                // capture units to deg/s
+    bool delta;
+    uint32_t dropped;
+    int sampleCount;
+    int16_t (*samples)[XYZ_AXIS_COUNT];
+} replayLog_t;
+
+typedef struct replaySetting_s {
+    const char *name;
+    uint16_t offset;
+    uint8_t size;
+} replaySetting_t;
+
+#define REPLAY_SETTING(name, field) { name, offsetof(gyroConfig_t, field), sizeof(((gyroConfig_t *)0)->field) }
+
+// the gyro filter settings, under their cli names
+static const replaySetting_t replaySettings[] = {
+    REPLAY_SETTING("gyro_lowpass_type",          gyro_lowpass_type),
+    REPLAY_SETTING("gyro_lowpass_hz_roll",       gyro_lowpass_hz[FD_ROLL]),
+    REPLAY_SETTING("gyro_lowpass_hz_pitch",      gyro_lowpass_hz[FD_PITCH]),
+    REPLAY_SETTING("gyro_lowpass_hz_yaw",        gyro_lowpass_hz[FD_YAW]),
+    REPLAY_SETTING("gyro_lowpass2_type",         gyro_lowpass2_type),
+    REPLAY_SETTING("gyro_lowpass2_hz_roll",      gyro_lowpass2_hz[FD_ROLL]),
+    REPLAY_SETTING("gyro_lowpass2_hz_pitch",     gyro_lowpass2_hz[FD_PITCH]),
+    REPLAY_SETTING("gyro_lowpass2_hz_yaw",       gyro_lowpass2_hz[FD_YAW]),
+    REPLAY_SETTING("gyro_abg_alpha",             gyro_ABG_alpha),
+    REPLAY_SETTING("gyro_abg_boost",             gyro_ABG_boost),
+    REPLAY_SETTING("gyro_abg_half_life",         gyro_ABG_half_life),
+    REPLAY_SETTING("gyro_notch1_hz",             gyro_soft_notch_hz_1),
+    REPLAY_SETTING("gyro_notch1_cutoff",         gyro_soft_notch_cutoff_1),
+    REPLAY_SETTING("gyro_notch2_hz",             gyro_soft_notch_hz_2),
+    REPLAY_SETTING("gyro_notch2_cutoff",         gyro_soft_notch_cutoff_2),
+    REPLAY_SETTING("dynamic_gyro_notch_axis",    dyn_notch_axis),
+    REPLAY_SETTING("dynamic_gyro_notch_q",       dyn_notch_q),
+    REPLAY_SETTING("dynamic_gyro_notch_count",   dyn_notch_count),
+    REPLAY_SETTING("dynamic_gyro_notch_min_hz",  dyn_notch_min_hz),
+    REPLAY_SETTING("dynamic_gyro_notch_max_hz",  dyn_notch_max_hz),
+    REPLAY_SETTING("imuf_roll_q",                imuf_roll_q),
+    REPLAY_SETTING("imuf_pitch_q",               imuf_pitch_q),
+    REPLAY_SETTING("imuf_yaw_q",                 imuf_yaw_q),
+    REPLAY_SETTING("imuf_w",                     imuf_w),
+    REPLAY_SETTING("smith_predict_enabled",      smithPredictorEnabled),
+    REPLAY_SETTING("smith_predict_str",          smithPredictorStrength),
+    REPLAY_SETTING("smith_predict_delay",        smithPredictorDelay),
+    REPLAY_SETTING("smith_predict_filt_hz",      smithPredictorFilterHz),
+};
+
+static uint8_t *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    *length = ftell(file);
+    rewind(file);
+    uint8_t *data = malloc(*length + 1);
+    if (data && fread(data, 1, *length, file) != *length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+typedef struct replayReader_s {
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool eof;
+} replayReader_t;
+
+static uint8_t readByte(replayReader_t *reader) {
+    if (reader->pos >= reader->end) {
+        reader->eof = true;
+        return 0;
+    }
+    return *reader->pos++;
+}
+
+static uint32_t readUnsignedVB(replayReader_t *reader) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        const uint8_t byte = readByte(reader);
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+static int32_t readSignedVB(replayReader_t *reader) {
+    const uint32_t value = readUnsignedVB(reader);
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static int16_t readS16(replayReader_t *reader) {
+    const uint8_t low = readByte(reader);
+    return (int16_t)(low | (readByte(reader) << 8));
+}
+
+static const char *headerValue(const char *line, const char *name) {
+    const size_t length = strlen(name);
+    if (strncmp(line, "H ", 2) == 0 && strncmp(line + 2, name, length) == 0 && line[2 + length] == ':') {
+        return line + 3 + length;
+    }
+    return NULL;
+}
+
+// Finds log number logIndex (from 1) in the file and reads its header and the 'R' frames that follow it
+static bool parseLog(const uint8_t *data, size_t length, int logIndex, replayLog_t *log) {
+    static const char logStart[] = "H Product:";
+    const uint8_t *pos = data;
+    const uint8_t *end = data + length;
+    for (int i = 0; i < logIndex; i++) {
+        pos = memmem(pos + (i ? 1 : 0), end - pos - (i ? 1 : 0), logStart, strlen(logStart));
+        if (!pos) {
+            fprintf(stderr, "log %d not found\n", logIndex);
+            return false;
+        }
+    }
+    bool hasCapture = false;
+    uint32_t scaleBits = 0;
+    while (pos < end && *pos == 'H') {
+        char line[256];
+        const uint8_t *eol = memchr(pos, '\n', end - pos);
+        const size_t lineLength = MIN((size_t)((eol ? eol : end) - pos), sizeof(line) - 1);
+        memcpy(line, pos, lineLength);
+        line[lineLength] = '\0';
+        pos = eol ? eol + 1 : end;
+        const char *value;
+        if ((value = headerValue(line, "looptime"))) {
+            log->looptimeUs = strtoul(value, NULL, 10);
+        } else if ((value = headerValue(line, "gyro_capture"))) {
+            int captureMs = 0;
+            int delta = 0;
+            sscanf(value, "%d,%d", &captureMs, &delta);
+            hasCapture = captureMs > 0;
+            log->delta = delta;
+        } else if ((value = headerValue(line, "gyro_capture_scale"))) {
+            scaleBits = strtoul(value, NULL, 16);
+        }
+    }
+    memcpy(&log->scale, &scaleBits, sizeof(log->scale));
+    if (!hasCapture || log->looptimeUs == 0 || log->scale <= 0.0f) {
+        fprintf(stderr, "log %d has no raw gyro capture, record it with blackbox_gyro_capture_ms set\n", logIndex);
+        return false;
+    }
+
+    replayReader_t reader = { .pos = pos, .end = end };
+    int capacity = 0;
+    int16_t previous[XYZ_AXIS_COUNT] = { 0, 0, 0 };
+    // the capture takes the place of the main frames, so it ends at the first other frame
+    while (reader.pos < reader.end && *reader.pos == 'R') {
+        reader.pos++;
+        const int count = readUnsignedVB(&reader);
+        log->dropped += readUnsignedVB(&reader);
+        if (log->sampleCount + count > capacity) {
+            capacity = MAX(capacity * 2, log->sampleCount + count);
+            log->samples = realloc(log->samples, capacity * sizeof(*log->samples));
+        }
+        for (int i = 0; i < count; i++) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                if (log->delta) {
+                    previous[axis] += readSignedVB(&reader);
+                } else {
+                    previous[axis] = readS16(&reader);
+                }
+                log->samples[log->sampleCount + i][axis] = previous[axis];
+            }
+        }
+        if (reader.eof) {
+            break;
+        }
+        log->sampleCount += count;
+    }
+    if (log->sampleCount == 0) {
+        fprintf(stderr, "log %d has no gyro capture frames\n", logIndex);
+        return false;
+    }
+    return true;
+}
+
+static bool applySetting(const char *assignment) {
+    const char *equals = strchr(assignment, '=');
+    if (!equals) {
+        return false;
+    }
+    const size_t nameLength = equals - assignment;
+    if (nameLength == strlen("dynamic_filter") && strncmp(assignment, "dynamic_filter", nameLength) == 0) {
+        dynamicFilterEnabled = atoi(equals + 1);
+        return true;
+    }
+    for (unsigned i = 0; i < ARRAYLEN(replaySettings); i++) {
+        const replaySetting_t *setting = &replaySettings[i];
+        if (strlen(setting->name) == nameLength && strncmp(setting->name, assignment, nameLength) == 0) {
+            uint8_t *field = (uint8_t *)gyroConfigMutable() + setting->offset;
+            const int value = atoi(equals + 1);
+            if (setting->size == 1) {
+                *field = value;
+            } else {
+                *(uint16_t *)field = value;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool applyConfig(const char *config) {
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "%s", config);
+    for (char *saveptr, *assignment = strtok_r(buffer, ",", &saveptr); assignment; assignment = strtok_r(NULL, ",", &saveptr)) {
+        if (!applySetting(assignment)) {
+            fprintf(stderr, "unknown setting '%s'\n", assignment);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Zero phase reference: the input run forward and backward through a biquad lowpass
+static void referenceSignal(const float *input, float *reference, int count, uint32_t looptimeUs) {
+    biquadFilter_t filter;
+    biquadFilterInitLPF(&filter, REPLAY_REFERENCE_HZ, looptimeUs);
+    for (int i = 0; i < count; i++) {
+        reference[i] = biquadFilterApply(&filter, input[i]);
+    }
+    biquadFilterInitLPF(&filter, REPLAY_REFERENCE_HZ, looptimeUs);
+    for (int i = count - 1; i >= 0; i--) {
+        reference[i] = biquadFilterApply(&filter, reference[i]);
+    }
+}
+
+static float rmsDifference(const float *signal, const float *reference, int start, int count, int lag) {
+    double sum = 0;
+    for (int i = start + lag; i < count; i++) {
+        const double difference = signal[i] - reference[i - lag];
+        sum += difference * difference;
+    }
+    return sqrt(sum / (count - start - lag));
+}
+
+// The lag in samples at which the output lines up best with the zero phase reference,
+// what is left over at that lag is the noise the filters let through
+static int estimateDelay(const float *output, const float *reference, int start, int count, int maxLag, float *noise) {
+    int bestLag = 0;
+    *noise = INFINITY;
+    for (int lag = 0; lag <= maxLag; lag++) {
+        const float rms = rmsDifference(output, reference, start, count, lag);
+        if (rms < *noise) {
+            *noise = rms;
+            bestLag = lag;
+        }
+    }
+    return bestLag;
+}
+
+static void printRow(const char *name, const float noise[XYZ_AXIS_COUNT], const int delayUs[XYZ_AXIS_COUNT], int nsPerSample) {
+    printf("%-40s", name);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (delayUs) {
+            printf(" %8.2f %6d", noise[axis], delayUs[axis]);
+        } else {
+            printf(" %8.2f %6s", noise[axis], "-");
+        }
+    }
+    if (nsPerSample >= 0) {
+        printf(" %9d", nsPerSample);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static int replayConfig(const replayLog_t *log, const char *name, const char *config, float (*reference)[XYZ_AXIS_COUNT]) {
+    pgResetAll();
+    if (config && !applyConfig(config)) {
+        return 1;
+    }
+    replayLooptimeUs = log->looptimeUs;
+    if (!gyroInit()) {
+        fprintf(stderr, "gyroInit failed\n");
+        return 1;
+    }
+    // the captured samples are already calibrated and aligned, gyroInit() leaves the zero at 0
+    // and no calibration running, only the scale to deg/s has to match the logging gyro
+    gyroDevPtr->scale = log->scale;
+
+    float (*output)[XYZ_AXIS_COUNT] = malloc(log->sampleCount * sizeof(*output));
+    replayTimeUs = 0;
+    const int64_t startNs = nowNs();
+    for (int i = 0; i < log->sampleCount; i++) {
+        replayTimeUs += log->looptimeUs;
+        fakeGyroSet(gyroDevPtr, log->samples[i][X], log->samples[i][Y], log->samples[i][Z]);
+        gyroUpdate(replayTimeUs);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            output[i][axis] = gyro.gyroADCf[axis];
+        }
+    }
+    const int nsPerSample = (nowNs() - startNs) / log->sampleCount;
+
+    const int start = MIN(REPLAY_SETTLE_US / log->looptimeUs, (uint32_t)log->sampleCount / 2);
+    const int maxLag = MIN(REPLAY_MAX_LAG_US / log->looptimeUs, (uint32_t)(log->sampleCount - start) / 2);
+    float noise[XYZ_AXIS_COUNT];
+    int delayUs[XYZ_AXIS_COUNT];
+    float *axisOutput = malloc(log->sampleCount * sizeof(float));
+    float *axisReference = malloc(log->sampleCount * sizeof(float));
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int i = 0; i < log->sampleCount; i++) {
+            axisOutput[i] = output[i][axis];
+            axisReference[i] = reference[i][axis];
+        }
+        delayUs[axis] = estimateDelay(axisOutput, axisReference, start, log->sampleCount, maxLag, &noise[axis]) * log->looptimeUs;
+    }
+    printRow(name, noise, delayUs, nsPerSample);
+    free(axisOutput);
+    free(axisReference);
+    free(output);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int logIndex = 1;
+    memset(debugModeSlot, DEBUG_SLOT_NONE, sizeof(debugModeSlot));
+    int opt;
+    while ((opt = getopt(argc, argv, "l:")) != -1) {
+        if (opt == 'l') {
+            logIndex = atoi(optarg);
+        } else {
+            optind = argc + 1;
+        }
+    }
+    if (optind >= argc || logIndex < 1) {
+        fprintf(stderr, "usage: %s [-l log] <log.bbl> [name=value[,name=value...]]...\n", argv[0]);
+        fprintf(stderr, "settings: dynamic_filter");
+        for (unsigned i = 0; i < ARRAYLEN(replaySettings); i++) {
+            fprintf(stderr, " %s", replaySettings[i].name);
+        }
+        fprintf(stderr, "\n");
+        return 1;
+    }
+
+    size_t length;
+    uint8_t *data = readFile(argv[optind], &length);
+    if (!data) {
+        fprintf(stderr, "can't read %s\n", argv[optind]);
+        return 1;
+    }
+    replayLog_t log = { 0 };
+    if (!parseLog(data, length, logIndex, &log)) {
+        return 1;
+    }
+    printf("log %d: %d samples at %uus, %.2fs, %u dropped\n", logIndex, log.sampleCount, log.looptimeUs,
+        log.sampleCount * log.looptimeUs * 1e-6, log.dropped);
+
+    float (*reference)[XYZ_AXIS_COUNT] = malloc(log.sampleCount * sizeof(*reference));
+    float *axisInput = malloc(log.sampleCount * sizeof(float));
+    float *axisReference = malloc(log.sampleCount * sizeof(float));
+    float rawNoise[XYZ_AXIS_COUNT];
+    const int start = MIN(REPLAY_SETTLE_US / log.looptimeUs, (uint32_t)log.sampleCount / 2);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int i = 0; i < log.sampleCount; i++) {
+            axisInput[i] = log.samples[i][axis] * log.scale;
+        }
+        referenceSignal(axisInput, axisReference, log.sampleCount, log.looptimeUs);
+        for (int i = 0; i < log.sampleCount; i++) {
+            reference[i][axis] = axisReference[i];
+        }
+        rawNoise[axis] = rmsDifference(axisInput, axisReference, start, log.sampleCount, 0);
+    }
+
+    printf("noise in deg/s rms above %dHz, delay in us, cost in host ns per sample\n", REPLAY_REFERENCE_HZ);
+    printf("%-40s %8s %6s %8s %6s %8s %6s %9s\n", "config", "roll", "delay", "pitch", "delay", "yaw", "delay", "ns");
+    printRow("raw", rawNoise, NULL, -1);
+
+    int failures = 0;
+    for (int i = optind; i < argc; i++) {
+        const char *config = i == optind ? NULL : argv[i];
+        const pid_t pid = fork();
+        if (pid == 0) {
+            exit(replayConfig(&log, config ? config : "defaults", config, reference));
+        }
+        int status = 1;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/accumulator.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(AccumulatorTest, EmptyTake)
+{
+    // given
+    accumulator_t accumulator;
+    memset(&accumulator, 0, sizeof(accumulator));
+    accumulatorSums_t sums;
+
+    // expect
+    EXPECT_FALSE(accumulatorTake(&accumulator, &sums));
+}
+
+TEST(AccumulatorTest, AddTake)
+{
+    // given
+    accumulator_t accumulator;
+    memset(&accumulator, 0, sizeof(accumulator));
+    accumulatorSums_t sums;
+    const float sample[3] = { 1.0f, -2.0f, 4.0f };
+
+    // when
+    for (int i = 0; i < 5; i++) {
+        accumulatorAdd(&accumulator, sample);
+    }
+
+    // then
+    EXPECT_TRUE(accumulatorTake(&accumulator, &sums));
+    EXPECT_EQ(5, sums.count);
+    EXPECT_FLOAT_EQ(5.0f, sums.sum[0]);
+    EXPECT_FLOAT_EQ(-10.0f, sums.sum[1]);
+    EXPECT_FLOAT_EQ(20.0f, sums.sum[2]);
+
+    // and nothing is taken twice
+    EXPECT_FALSE(accumulatorTake(&accumulator, &sums));
+}
+
+TEST(AccumulatorTest, TakenSamplesAreRemoved)
+{
+    // given
+    accumulator_t accumulator;
+    memset(&accumulator, 0, sizeof(accumulator));
+    accumulatorSums_t sums;
+    const float first[3] = { 1.0f, 1.0f, 1.0f };
+    const float second[3] = { 3.0f, 5.0f, 7.0f };
+
+    // when
+    accumulatorAdd(&accumulator, first);
+    accumulatorAdd(&accumulator, first);
+    EXPECT_TRUE(accumulatorTake(&accumulator, &sums));
+    accumulatorAdd(&accumulator, second);
+
+    // then
+    EXPECT_TRUE(accumulatorTake(&accumulator, &sums));
+    EXPECT_EQ(1, sums.count);
+    EXPECT_FLOAT_EQ(3.0f, sums.sum[0]);
+    EXPECT_FLOAT_EQ(5.0f, sums.sum[1]);
+    EXPECT_FLOAT_EQ(7.0f, sums.sum[2]);
+}
+
+TEST(AccumulatorTest, TakeDuringWriteReadsLastCompleteCopy)
+{
+    // given
+    accumulator_t accumulator;
+    memset(&accumulator, 0, sizeof(accumulator));
+    accumulatorSums_t sums;
+    const float sample[3] = { 2.0f, 2.0f, 2.0f };
+    accumulatorAdd(&accumulator, sample);
+
+    // when the producer is preempted half way through writing copy[0]
+    accumulator.seq++;
+    accumulator.copy[0].sum[0] = 1000.0f;
+    accumulator.copy[0].count = 1000;
+
+    // then the consumer reads copy[1]
+    EXPECT_TRUE(accumulatorTake(&accumulator, &sums));
+    EXPECT_EQ(1, sums.count);
+    EXPECT_FLOAT_EQ(2.0f, sums.sum[0]);
+}
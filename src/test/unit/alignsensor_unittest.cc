@@ -265,3 +265,38 @@ TEST(AlignSensorTest, ClockwiseTwoSeventyDegreesFlip)
 {
     testCWFlip(CW270_DEG_FLIP, 270);
 }
+
+static void expectMatrixMatchesAlignSensors(sensor_align_e rotation, float tolerance)
+{
+    float matrix[3][3];
+    buildAlignmentMatrix(rotation, matrix);
+
+    float src[XYZ_AXIS_COUNT] = { 3.0f, -1.5f, 0.25f };
+    float test[XYZ_AXIS_COUNT];
+    for (int axis = X; axis <= Z; axis++) {
+        test[axis] = matrix[axis][X] * src[X] + matrix[axis][Y] * src[Y] + matrix[axis][Z] * src[Z];
+    }
+
+    alignSensors(src, rotation);
+
+    EXPECT_NEAR(src[X], test[X], tolerance) << "rotation " << rotation;
+    EXPECT_NEAR(src[Y], test[Y], tolerance) << "rotation " << rotation;
+    EXPECT_NEAR(src[Z], test[Z], tolerance) << "rotation " << rotation;
+}
+
+TEST(AlignSensorTest, AlignmentMatrixMatchesRotations)
+{
+    for (int rotation = CW0_DEG; rotation <= CW270_DEG_FLIP; rotation++) {
+        expectMatrixMatchesAlignSensors((sensor_align_e)rotation, 0.0f);
+    }
+}
+
+// runs last, a custom board alignment can't be taken back within the test binary
+TEST(AlignSensorTest, AlignmentMatrixIncludesBoardAlignment)
+{
+    const boardAlignment_t boardAlignment = { 10, -20, 135 };
+    initBoardAlignment(&boardAlignment);
+    for (int rotation = CW0_DEG; rotation <= CW270_DEG_FLIP; rotation++) {
+        expectMatrixMatchesAlignSensors((sensor_align_e)rotation, 1e-5f);
+    }
+}
@@ -60,6 +60,8 @@ extern "C" {
     uint16_t averageSystemLoadPercent = 0;
     uint8_t cliMode = 0;
     uint8_t debugMode = 0;
+    uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+    uint8_t debugModeSlot[DEBUG_COUNT];
     int16_t debug[DEBUG16_VALUE_COUNT];
     pidProfile_t *currentPidProfile;
     controlRateConfig_t *currentControlRateProfile;
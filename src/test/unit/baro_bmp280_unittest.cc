@@ -144,8 +144,11 @@ TEST(baroBmp280Test, TestBmp280CalculateZeroP)
 extern "C" {
 
 void delay(uint32_t) {}
+uint32_t millis(void) { return 0; }
 bool busReadRegisterBuffer(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
 bool busWriteRegister(const busDevice_t*, uint8_t, uint8_t) {return true;}
+bool busReadRegisterBufferStart(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
+bool busWriteRegisterStart(const busDevice_t*, uint8_t, uint8_t) {return true;}
 
 void spiSetDivisor() {
 }
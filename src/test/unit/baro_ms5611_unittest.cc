@@ -144,10 +144,13 @@ TEST(baroMS5611Test, TestMs5611CalculatePressureLTMinus15Deg)
 extern "C" {
 
 void delay(uint32_t) {}
+uint32_t millis(void) { return 0; }
 void delayMicroseconds(uint32_t) {}
 
 bool busReadRegisterBuffer(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
 bool busWriteRegister(const busDevice_t*, uint8_t, uint8_t) {return true;}
+bool busReadRegisterBufferStart(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
+bool busWriteRegisterStart(const busDevice_t*, uint8_t, uint8_t) {return true;}
 
 void spiSetDivisor() {
 }
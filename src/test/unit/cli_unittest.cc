@@ -63,6 +63,7 @@ extern "C" {
         { "array_unit_test",             VAR_INT8  | MODE_ARRAY | MASTER_VALUE, .config.array.length = 3, PG_RESERVED_FOR_TESTING_1, 0 }
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+    uint16_t valueTableIndex[ARRAYLEN(valueTable)];
     const lookupTableEntry_t lookupTables[] = {};
 
 
@@ -24,6 +24,8 @@
 
 extern "C" {
     #include "common/filter.h"
+    #include "common/lulu.h"
+    #include "common/utils.h"
 }
 
 #include "unittest_macros.h"
@@ -114,3 +116,183 @@ TEST(FilterUnittest, TestSlewFilter)
     slewFilterApply(&filter, 200.0f);
     EXPECT_EQ(200, filter.state);
 }
+
+TEST(FilterUnittest, TestBiquadFilterApplyX3)
+{
+    biquadFilter_t single[3];
+    biquadFilterX3_t batch;
+    for (int i = 0; i < 3; i++) {
+        biquadFilterInit(&single[i], 200, 125, filterGetNotchQ(200, 160), FILTER_NOTCH);
+    }
+    biquadFilterInitX3(&batch, 200, 125, filterGetNotchQ(200, 160), FILTER_NOTCH);
+
+    for (int n = 0; n < 64; n++) {
+        float input[3];
+        for (int i = 0; i < 3; i++) {
+            input[i] = 500.0f * sinf(0.3f * n + i);
+        }
+        float expected[3];
+        for (int i = 0; i < 3; i++) {
+            expected[i] = biquadFilterApply(&single[i], input[i]);
+        }
+        biquadFilterApplyX3(&batch, input);
+        for (int i = 0; i < 3; i++) {
+            EXPECT_FLOAT_EQ(expected[i], input[i]);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilterCascadeApplyDF1)
+{
+    biquadFilter_t single[3];
+    biquadFilter_t cascade[3];
+    for (int i = 0; i < 3; i++) {
+        biquadFilterInit(&single[i], 150 + 100 * i, 125, 3.5f, FILTER_NOTCH);
+        biquadFilterInit(&cascade[i], 150 + 100 * i, 125, 3.5f, FILTER_NOTCH);
+    }
+
+    for (int n = 0; n < 64; n++) {
+        const float input = 500.0f * sinf(0.3f * n);
+        float expected = input;
+        for (int i = 0; i < 3; i++) {
+            expected = biquadFilterApplyDF1(&single[i], expected);
+        }
+        EXPECT_FLOAT_EQ(expected, biquadFilterCascadeApplyDF1(cascade, 3, input));
+    }
+}
+
+TEST(FilterUnittest, TestPtnFilterUnrolledMatchesLoop)
+{
+    float (*const applyFns[])(ptnFilter_t *, float) = { pt2FilterApply, pt3FilterApply, pt4FilterApply };
+    for (int order = FILTER_PT2; order <= FILTER_PT4; order++) {
+        ptnFilter_t loop, unrolled;
+        ptnFilterInit(&loop, order, 90, 0.000125f);
+        ptnFilterInit(&unrolled, order, 90, 0.000125f);
+        for (int n = 0; n < 64; n++) {
+            const float input = 500.0f * sinf(0.3f * n) + 200.0f;
+            EXPECT_FLOAT_EQ(ptnFilterApply(&loop, input), applyFns[order - FILTER_PT2](&unrolled, input)) << "order " << order;
+        }
+    }
+}
+
+TEST(FilterUnittest, TestAlphaBetaGammaMatchesUnfoldedUpdate)
+{
+    const float dT = 0.000125f;
+    const float alpha = 0.3f;
+    const float xi = powf(1.0f - alpha, 0.25f);
+    const float b = (1.0f / 6.0f) * powf(1.0f - xi, 2) * (11.0f + 14.0f * xi + 11 * xi * xi);
+    const float g = 2 * powf(1.0f - xi, 3) * (1 + xi);
+    const float e = (1.0f / 6.0f) * powf(1 - xi, 4);
+    const float halfLife = powf(0.5f, dT / 0.5f);
+    const float boost = (1500 * 1500 / 1000000) * 0.003f;
+    pt1Filter_t boostFilter, velFilter, accFilter, jerkFilter;
+    pt1FilterInit(&boostFilter, pt1FilterGain(100, dT));
+    pt1FilterInit(&velFilter, pt1FilterGain(75, dT));
+    pt1FilterInit(&accFilter, pt1FilterGain(50, dT));
+    pt1FilterInit(&jerkFilter, pt1FilterGain(25, dT));
+    float xk = 0, vk = 0, ak = 0, jk = 0;
+
+    alphaBetaGammaFilter_t single;
+    alphaBetaGammaFilterX3_t batch;
+    ABGInit(&single, alpha * 1000, 1500, 50, dT);
+    ABGInitX3(&batch, alpha * 1000, 1500, 50, dT);
+
+    for (int n = 0; n < 256; n++) {
+        const float input = 300.0f * sinf(0.05f * n) + ((n % 8) - 4) * 20.0f;
+        // the per sample update as it was before the invariant terms were folded at init
+        xk *= halfLife;
+        vk *= halfLife;
+        ak *= halfLife;
+        jk *= halfLife;
+        xk += dT * vk + 0.5f * dT * dT * ak + (1.0f / 6.0f) * dT * dT * dT * jk;
+        vk += dT * ak + 0.5f * dT * dT * jk;
+        ak += dT * jk;
+        float rk = input - xk;
+        rk += pt1FilterApply(&boostFilter, fabsf(rk) * rk * boost);
+        xk += alpha * rk;
+        vk = pt1FilterApply(&velFilter, vk + b / dT * rk);
+        ak = pt1FilterApply(&accFilter, ak + g / (2.0f * dT * dT) * rk);
+        jk = pt1FilterApply(&jerkFilter, jk + e / (6.0f * dT * dT * dT) * rk);
+
+        const float output = alphaBetaGammaApply(&single, input);
+        EXPECT_NEAR(xk, output, 1e-3f * fmaxf(1.0f, fabsf(xk))) << "sample " << n;
+        float axes[3] = { input, input, input };
+        alphaBetaGammaApplyX3(&batch, axes);
+        for (int i = 0; i < 3; i++) {
+            EXPECT_FLOAT_EQ(output, axes[i]);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestPt1FilterFixedTracksFloat)
+{
+    pt1Filter_t reference;
+    pt1FilterFixed_t fixed;
+    const float k = pt1FilterGain(100, 0.000125f);
+    pt1FilterInit(&reference, k);
+    pt1FilterFixedInit(&fixed, k);
+
+    // Q8 samples, as the gyro chain feeds them
+    for (int n = 0; n < 256; n++) {
+        const float input = 500.0f * sinf(0.05f * n) + 200.0f;
+        const float expected = pt1FilterApply(&reference, input);
+        const int32_t result = pt1FilterFixedApply(&fixed, lrintf(input * 256));
+        EXPECT_NEAR(expected, result / 256.0f, 0.1f);
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilterFixedTracksFloat)
+{
+    biquadFilter_t lowpass, notch;
+    biquadFilterFixed_t lowpassFixed, notchFixed;
+    biquadFilterInitLPF(&lowpass, 150, 125);
+    biquadFilterInit(&notch, 200, 125, filterGetNotchQ(200, 160), FILTER_NOTCH);
+    biquadFilterFixedInit(&lowpassFixed, lowpass.b0, lowpass.b1, lowpass.b2, lowpass.a1, lowpass.a2);
+    biquadFilterFixedInit(&notchFixed, notch.b0, notch.b1, notch.b2, notch.a1, notch.a2);
+
+    for (int n = 0; n < 256; n++) {
+        const float input = 500.0f * sinf(0.3f * n) + 100.0f * sinf(0.02f * n);
+        const float expected = biquadFilterApplyDF1(&notch, biquadFilterApplyDF1(&lowpass, input));
+        const int32_t result = biquadFilterFixedApply(&notchFixed, biquadFilterFixedApply(&lowpassFixed, lrintf(input * 256)));
+        EXPECT_NEAR(expected, result / 256.0f, 0.1f);
+    }
+}
+
+TEST(FilterUnittest, TestLuluFilterRemovesSpikes)
+{
+    luluFilter_t filter;
+    luluFilterInit(&filter, 3);
+    for (int i = 0; i < 20; i++) {
+        luluFilterApply(&filter, 10.0f);
+    }
+    // peaks and pits up to N samples wide are flattened
+    const float input[] = { 50.0f, 50.0f, 50.0f, 10.0f, -30.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f };
+    for (unsigned i = 0; i < ARRAYLEN(input); i++) {
+        EXPECT_FLOAT_EQ(10.0f, luluFilterApply(&filter, input[i]));
+    }
+}
+
+TEST(FilterUnittest, TestLuluFilterDelaysStepByN)
+{
+    luluFilter_t filter;
+    luluFilterInit(&filter, 15);
+    for (int i = 0; i < 40; i++) {
+        luluFilterApply(&filter, 0.0f);
+    }
+    // a step wider than the window comes out unchanged, N samples late
+    for (int i = 0; i < 15; i++) {
+        EXPECT_FLOAT_EQ(0.0f, luluFilterApply(&filter, 100.0f));
+    }
+    for (int i = 0; i < 20; i++) {
+        EXPECT_FLOAT_EQ(100.0f, luluFilterApply(&filter, 100.0f));
+    }
+}
+
+TEST(FilterUnittest, TestLuluFilterClampsN)
+{
+    luluFilter_t filter;
+    luluFilterInit(&filter, 40);
+    EXPECT_EQ(LULU_MAX_N, filter.N);
+    luluFilterInit(&filter, 0);
+    EXPECT_EQ(1, filter.N);
+}
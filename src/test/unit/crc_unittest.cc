@@ -0,0 +1,91 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t checkString[] = "123456789";
+
+static uint16_t crc16CcittBitwise(uint16_t crc, uint8_t a)
+{
+    crc ^= (uint16_t)a << 8;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static uint8_t crc8DvbS2Bitwise(uint8_t crc, uint8_t a)
+{
+    crc ^= a;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1;
+    }
+    return crc;
+}
+
+TEST(CrcTest, TestCrc16CcittCheckValue)
+{
+    // CRC-16/XMODEM check value
+    EXPECT_EQ(0x31C3, crc16_ccitt_update(0, checkString, 9));
+}
+
+TEST(CrcTest, TestCrc8DvbS2CheckValue)
+{
+    EXPECT_EQ(0xBC, crc8_dvb_s2_update(0, checkString, 9));
+}
+
+TEST(CrcTest, TestTablesMatchBitwise)
+{
+    for (int crc = 0; crc < 256; crc += 17) {
+        for (int a = 0; a < 256; a++) {
+            EXPECT_EQ(crc16CcittBitwise(crc << 8 | a, a), crc16_ccitt(crc << 8 | a, a));
+            EXPECT_EQ(crc8DvbS2Bitwise(crc, a), crc8_dvb_s2(crc, a));
+        }
+    }
+}
+
+TEST(CrcTest, TestUpdateContinues)
+{
+    // a block split in two gives the crc of the whole block
+    EXPECT_EQ(crc16_ccitt_update(0, checkString, 9), crc16_ccitt_update(crc16_ccitt_update(0, checkString, 4), checkString + 4, 5));
+    EXPECT_EQ(crc8_dvb_s2_update(0, checkString, 9), crc8_dvb_s2_update(crc8_dvb_s2_update(0, checkString, 4), checkString + 4, 5));
+}
+
+TEST(CrcTest, TestSbufAppend)
+{
+    uint8_t buffer[16];
+    sbuf_t sbuf;
+    sbufInit(&sbuf, buffer, buffer + sizeof(buffer));
+    sbufWriteData(&sbuf, checkString, 9);
+    crc8_dvb_s2_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(0xBC, buffer[9]);
+
+    sbufInit(&sbuf, buffer, buffer + sizeof(buffer));
+    sbufWriteData(&sbuf, checkString, 9);
+    crc16_ccitt_sbuf_append(&sbuf, buffer);
+    // written little endian
+    EXPECT_EQ(0xC3, buffer[9]);
+    EXPECT_EQ(0x31, buffer[10]);
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/fc_dispatch.h"
+    #include "scheduler/scheduler.h"
+
+    uint8_t atomic_BASEPRI;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static uint32_t simulatedTime;
+static int32_t lastReschedule;
+static int callOrder[DISPATCH_QUEUE_SIZE + 1];
+static int callCount;
+
+static void recordCall(dispatchEntry_t *self);
+
+static dispatchEntry_t entries[DISPATCH_QUEUE_SIZE + 1];
+
+static void recordCall(dispatchEntry_t *self) {
+    callOrder[callCount++] = self - entries;
+}
+
+static void resetEntries(void) {
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i <= DISPATCH_QUEUE_SIZE; i++) {
+        entries[i].dispatch = recordCall;
+    }
+    callCount = 0;
+}
+
+TEST(DispatchTest, RunsEntriesInDeadlineOrder)
+{
+    // given
+    resetEntries();
+    simulatedTime = 1000;
+    const int delays[] = { 500, 100, 900, 300, 700, 200 };
+    for (int i = 0; i < 6; i++) {
+        EXPECT_TRUE(dispatchAdd(&entries[i], delays[i]));
+    }
+
+    // when nothing is due
+    dispatchProcess(1050);
+
+    // then
+    EXPECT_EQ(0, callCount);
+    EXPECT_EQ(50, lastReschedule);
+
+    // when
+    dispatchProcess(1600);
+
+    // then
+    EXPECT_EQ(4, callCount);
+    EXPECT_EQ(1, callOrder[0]);
+    EXPECT_EQ(5, callOrder[1]);
+    EXPECT_EQ(3, callOrder[2]);
+    EXPECT_EQ(0, callOrder[3]);
+    EXPECT_EQ(100, lastReschedule);
+
+    // when
+    dispatchProcess(5000);
+
+    // then
+    EXPECT_EQ(6, callCount);
+    EXPECT_EQ(4, callOrder[4]);
+    EXPECT_EQ(2, callOrder[5]);
+    EXPECT_EQ(DISPATCH_POLL_PERIOD_US, lastReschedule);
+}
+
+TEST(DispatchTest, CancelAndRequeue)
+{
+    // given
+    resetEntries();
+    simulatedTime = 0xfffffff0; // across the timer wrap
+    EXPECT_TRUE(dispatchAdd(&entries[0], 100));
+    EXPECT_TRUE(dispatchAdd(&entries[1], 200));
+    EXPECT_TRUE(dispatchAdd(&entries[2], 300));
+
+    // expect an entry to be queued once
+    EXPECT_FALSE(dispatchAdd(&entries[1], 10));
+    EXPECT_TRUE(dispatchIsQueued(&entries[1]));
+
+    // when
+    dispatchCancel(&entries[0]);
+    dispatchCancel(&entries[0]);
+
+    // then
+    EXPECT_FALSE(dispatchIsQueued(&entries[0]));
+
+    // when
+    dispatchProcess(simulatedTime + 1000);
+
+    // then
+    EXPECT_EQ(2, callCount);
+    EXPECT_EQ(1, callOrder[0]);
+    EXPECT_EQ(2, callOrder[1]);
+    EXPECT_FALSE(dispatchIsQueued(&entries[1]));
+    EXPECT_TRUE(dispatchAdd(&entries[1], 10));
+    dispatchCancel(&entries[1]);
+}
+
+TEST(DispatchTest, QueueFull)
+{
+    // given
+    resetEntries();
+    simulatedTime = 0;
+    for (int i = 0; i < DISPATCH_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(dispatchAdd(&entries[i], (i * 7919) % 1000));
+    }
+
+    // expect
+    EXPECT_FALSE(dispatchAdd(&entries[DISPATCH_QUEUE_SIZE], 0));
+
+    // when
+    dispatchProcess(1000);
+
+    // then all of them ran, in deadline order
+    EXPECT_EQ(DISPATCH_QUEUE_SIZE, callCount);
+    for (int i = 1; i < DISPATCH_QUEUE_SIZE; i++) {
+        EXPECT_LE(entries[callOrder[i - 1]].delayedUntil, entries[callOrder[i]].delayedUntil);
+    }
+}
+
+// STUBS
+
+extern "C" {
+    uint32_t micros(void) { return simulatedTime; }
+    void rescheduleTask(cfTaskId_e, uint32_t newPeriodMicros) { lastReschedule = newPeriodMicros; }
+}
@@ -83,6 +83,10 @@ gpsSolutionData_t gpsSol;
 uint16_t GPS_distanceToHome = 0;
 
 uint8_t debugMode;
+
+uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+
+uint8_t debugModeSlot[DEBUG_COUNT];
 int16_t debug[DEBUG16_VALUE_COUNT];
 
 uint8_t stateFlags;
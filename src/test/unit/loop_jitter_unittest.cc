@@ -0,0 +1,105 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "build/loop_jitter.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define CENTRE_BUCKET LOOP_JITTER_RANGE_US
+
+TEST(LoopJitterTest, OnTimeLoopsLandInCentreBucket)
+{
+    // given
+    loopJitterReset(125);
+
+    // when
+    for (int i = 0; i < 10; i++) {
+        loopJitterRecord(125);
+    }
+
+    // then
+    const loopJitter_t *jitter = getLoopJitter();
+    EXPECT_EQ(125, jitter->targetLooptimeUs);
+    EXPECT_EQ(10, jitter->count);
+    EXPECT_EQ(0, jitter->minDeviationUs);
+    EXPECT_EQ(0, jitter->maxDeviationUs);
+    EXPECT_EQ(10, jitter->buckets[CENTRE_BUCKET]);
+    EXPECT_EQ(0, loopJitterBucketDeviationUs(CENTRE_BUCKET));
+}
+
+TEST(LoopJitterTest, DeviationsUseOneMicrosecondBuckets)
+{
+    // given
+    loopJitterReset(125);
+
+    // when
+    loopJitterRecord(122);
+    loopJitterRecord(126);
+    loopJitterRecord(126);
+
+    // then
+    const loopJitter_t *jitter = getLoopJitter();
+    EXPECT_EQ(3, jitter->count);
+    EXPECT_EQ(-3, jitter->minDeviationUs);
+    EXPECT_EQ(1, jitter->maxDeviationUs);
+    EXPECT_EQ(1, jitter->buckets[CENTRE_BUCKET - 3]);
+    EXPECT_EQ(2, jitter->buckets[CENTRE_BUCKET + 1]);
+    EXPECT_EQ(0, jitter->buckets[CENTRE_BUCKET]);
+}
+
+TEST(LoopJitterTest, LargeDeviationsLandInOuterBuckets)
+{
+    // given
+    loopJitterReset(125);
+
+    // when
+    loopJitterRecord(20);
+    loopJitterRecord(125 + LOOP_JITTER_RANGE_US);
+    loopJitterRecord(1000);
+
+    // then
+    const loopJitter_t *jitter = getLoopJitter();
+    EXPECT_EQ(-105, jitter->minDeviationUs);
+    EXPECT_EQ(875, jitter->maxDeviationUs);
+    EXPECT_EQ(1, jitter->buckets[0]);
+    EXPECT_EQ(2, jitter->buckets[LOOP_JITTER_BUCKET_COUNT - 1]);
+    EXPECT_EQ(-LOOP_JITTER_RANGE_US, loopJitterBucketDeviationUs(0));
+    EXPECT_EQ(LOOP_JITTER_RANGE_US, loopJitterBucketDeviationUs(LOOP_JITTER_BUCKET_COUNT - 1));
+}
+
+TEST(LoopJitterTest, ResetClearsHistogram)
+{
+    // given
+    loopJitterReset(125);
+    loopJitterRecord(130);
+
+    // when
+    loopJitterReset(250);
+
+    // then
+    const loopJitter_t *jitter = getLoopJitter();
+    EXPECT_EQ(250, jitter->targetLooptimeUs);
+    EXPECT_EQ(0, jitter->count);
+    for (int i = 0; i < LOOP_JITTER_BUCKET_COUNT; i++) {
+        EXPECT_EQ(0, jitter->buckets[i]);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "build/loop_rate.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(LoopRateTest, LoadCountsTheGyroPathEverySample)
+{
+    // given
+    const loopRate_t rate = { .samplePeriodUs = 125, .gyroSyncDenom = 1, .pidProcessDenom = 2 };
+    const loopWcet_t wcet = { .gyro = 300, .pid = 500 };
+
+    // then
+    EXPECT_EQ(250, loopRatePidLooptimeUs(&rate));
+    EXPECT_EQ(440, loopRateLoadPermille(&rate, &wcet));
+    EXPECT_TRUE(loopRateFits(&rate, &wcet));
+}
+
+TEST(LoopRateTest, RateMustLeaveTheMargin)
+{
+    // given
+    const loopRate_t rate = { .samplePeriodUs = 125, .gyroSyncDenom = 1, .pidProcessDenom = 1 };
+    const loopWcet_t fits = { .gyro = 300, .pid = 637 };
+    const loopWcet_t over = { .gyro = 300, .pid = 638 };
+
+    // then
+    EXPECT_TRUE(loopRateFits(&rate, &fits));
+    EXPECT_FALSE(loopRateFits(&rate, &over));
+}
+
+TEST(LoopRateTest, RecommendsHighestPidRateAtTheFasterGyroRate)
+{
+    // given
+    loopRate_t rate = { .samplePeriodUs = 125, .gyroSyncDenom = 1, .pidProcessDenom = 1 };
+    const loopWcet_t wcet = { .gyro = 300, .pid = 700 };
+
+    // when
+    EXPECT_TRUE(loopRateRecommend(&rate, 32, 16, &wcet));
+
+    // then 8k gyro and 4k pid, rather than 4k gyro and 4k pid
+    EXPECT_EQ(125, rate.samplePeriodUs);
+    EXPECT_EQ(1, rate.gyroSyncDenom);
+    EXPECT_EQ(2, rate.pidProcessDenom);
+}
+
+TEST(LoopRateTest, SlowGyroPathNeedsGyroSyncDenom)
+{
+    // given
+    loopRate_t rate = { .samplePeriodUs = 125, .gyroSyncDenom = 1, .pidProcessDenom = 1 };
+    const loopWcet_t wcet = { .gyro = 1000, .pid = 100 };
+
+    // when
+    EXPECT_TRUE(loopRateRecommend(&rate, 32, 16, &wcet));
+
+    // then
+    EXPECT_EQ(2, rate.gyroSyncDenom);
+    EXPECT_EQ(1, rate.pidProcessDenom);
+}
+
+TEST(LoopRateTest, NoRecommendationKeepsTheRate)
+{
+    // given gyro_sync_denom isn't available
+    loopRate_t rate = { .samplePeriodUs = 125, .gyroSyncDenom = 1, .pidProcessDenom = 4 };
+    const loopWcet_t wcet = { .gyro = 1000, .pid = 100 };
+
+    // then
+    EXPECT_FALSE(loopRateRecommend(&rate, 1, 16, &wcet));
+    EXPECT_EQ(1, rate.gyroSyncDenom);
+    EXPECT_EQ(4, rate.pidProcessDenom);
+}
+
+TEST(LoopRateTest, UnknownSamplePeriodNeverFits)
+{
+    // given
+    const loopRate_t rate = { .samplePeriodUs = 0, .gyroSyncDenom = 1, .pidProcessDenom = 1 };
+    const loopWcet_t wcet = { .gyro = 1, .pid = 1 };
+
+    // then
+    EXPECT_FALSE(loopRateFits(&rate, &wcet));
+}
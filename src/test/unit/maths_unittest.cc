@@ -250,3 +250,56 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     EXPECT_LE(error, 1e-4);
 }
 #endif
+
+TEST(MathsUnittest, TestInvSqrt)
+{
+    double error = 0;
+    for (float x = 1e-4f; x < 1e4f; x *= 1.01f) {
+        error = MAX(error, fabs(invSqrtf(x) * sqrt(x) - 1.0));
+    }
+    EXPECT_LE(error, 5e-6);
+}
+
+TEST(MathsUnittest, TestQuaternionNormalize)
+{
+    quaternion q = { .w = 2.0f, .x = -1.0f, .y = 0.5f, .z = 3.0f };
+    const float modulus = quaternionModulus(&q);
+    quaternion expected = { .w = 2.0f / modulus, .x = -1.0f / modulus, .y = 0.5f / modulus, .z = 3.0f / modulus };
+    quaternionNormalize(&q);
+    EXPECT_NEAR(expected.w, q.w, 1e-5f);
+    EXPECT_NEAR(expected.x, q.x, 1e-5f);
+    EXPECT_NEAR(expected.y, q.y, 1e-5f);
+    EXPECT_NEAR(expected.z, q.z, 1e-5f);
+    EXPECT_NEAR(1.0f, quaternionModulus(&q), 1e-5f);
+
+    quaternion zero = VECTOR_INITIALIZE;
+    quaternionNormalize(&zero);
+    EXPECT_FLOAT_EQ(0.0f, zero.w);
+}
+
+TEST(MathsUnittest, TestQuaternionTransformVector)
+{
+    // same result as the full q * v * q' product, to the precision invSqrtf() normalises with
+    quaternion reference = { .w = 0.8f, .x = 0.1f, .y = -0.3f, .z = 0.5f };
+    quaternionNormalize(&reference);
+    const quaternion vector = { .w = 0.0f, .x = 1.0f, .y = -2.0f, .z = 0.5f };
+
+    quaternion conjugate, product;
+    quaternion expected = vector;
+    quaternionConjugate(&reference, &conjugate);
+    quaternionMultiply(&reference, &expected, &product);
+    quaternionMultiply(&product, &conjugate, &expected);
+
+    quaternion v = vector;
+    quaternionTransformVectorBodyToEarth(&v, &reference);
+    EXPECT_NEAR(expected.x, v.x, 5e-5f);
+    EXPECT_NEAR(expected.y, v.y, 5e-5f);
+    EXPECT_NEAR(expected.z, v.z, 5e-5f);
+    EXPECT_FLOAT_EQ(0.0f, v.w);
+
+    // and back again
+    quaternionTransformVectorEarthToBody(&v, &reference);
+    EXPECT_NEAR(vector.x, v.x, 5e-5f);
+    EXPECT_NEAR(vector.y, v.y, 5e-5f);
+    EXPECT_NEAR(vector.z, v.z, 5e-5f);
+}
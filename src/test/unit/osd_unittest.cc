@@ -1051,9 +1051,7 @@ extern "C" {
         return false;
     }
 
-    bool IS_RC_MODE_ACTIVE(boxId_e) {
-        return false;
-    }
+    boxBitmask_t rcModeActivationMask;
 
     uint32_t micros() {
         return simulationTime;
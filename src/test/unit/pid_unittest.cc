@@ -32,6 +32,8 @@ float simulatedControllerMixRange = 0.0f;
 
 int16_t debug[DEBUG16_VALUE_COUNT];
 uint8_t debugMode;
+uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+uint8_t debugModeSlot[DEBUG_COUNT];
 
 extern "C" {
     #include "build/debug.h"
@@ -67,6 +69,8 @@ extern "C" {
     float getThrottlePIDAttenuation(void) { return simulatedThrottlePIDAttenuation; }
     float getControllerMixRange(void) { return simulatedControllerMixRange; }
     float getSetpointRate(int axis) { return simulatedSetpointRate[axis]; }
+    float getSetpointDerivative(int) { return 0.0f; }
+    bool setpointDerivativeIsValid(void) { return false; }
     bool mixerIsOutputSaturated(int, float) { return simulateMixerSaturated; }
     float getRcDeflectionAbs(int axis) { return ABS(simulatedRcDeflection[axis]); }
     void systemBeep(bool) { }
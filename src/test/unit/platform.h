@@ -31,6 +31,7 @@
 #define FAST_CODE_NOINLINE
 #define FAST_RAM_ZERO_INIT
 #define FAST_RAM
+#define DMA_RAM
 
 #define PID_PROFILE_COUNT 3
 #define USE_MAG
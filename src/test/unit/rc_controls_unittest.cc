@@ -145,6 +145,8 @@ TEST_F(RcControlsModesTest, updateActivatedModesUsingValidAuxConfigurationAndRXV
     EXPECT_EQ(1, modeActivationConditions(6)->range.startStep);
     EXPECT_EQ(2, modeActivationConditions(6)->range.endStep);
 
+    analyzeModeActivationConditions();
+
     // and
     boxBitmask_t mask;
     memset(&mask, 0, sizeof(mask));
@@ -702,8 +704,12 @@ TEST_F(RcControlsAdjustmentsTest, processPIDIncreasePidController2)
 extern "C" {
 void saveConfigAndNotify(void) {}
 void initRcProcessing(void) {}
+void initRcThrottleLookup(void) {}
+void initRcRatesAxis(int) {}
 void changePidProfile(uint8_t) {}
 void pidInitConfig(const pidProfile_t *) {}
+void pidInitAxisGains(const pidProfile_t *, int) {}
+void pidInitLevelConfig(const pidProfile_t *) {}
 void accSetCalibrationCycles(uint16_t) {}
 void gyroStartCalibration(bool isFirstArmingCalibration)
 {
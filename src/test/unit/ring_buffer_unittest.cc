@@ -0,0 +1,153 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/ringbuffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(RingBufferTest, PushPop)
+{
+    // given
+    uint8_t data[8];
+    ringBuffer_t ring;
+    ringBufferInit(&ring, data, sizeof(data));
+    uint8_t value;
+
+    // expect
+    EXPECT_EQ(0, ringBufferUsed(&ring));
+    EXPECT_EQ(8, ringBufferFree(&ring));
+    EXPECT_FALSE(ringBufferPop(&ring, &value));
+
+    // when
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ringBufferPush(&ring, i));
+    }
+
+    // then
+    EXPECT_FALSE(ringBufferPush(&ring, 8));
+    EXPECT_EQ(8, ringBufferUsed(&ring));
+    EXPECT_EQ(0, ringBufferFree(&ring));
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ringBufferPop(&ring, &value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ringBufferPop(&ring, &value));
+}
+
+TEST(RingBufferTest, WrapAround)
+{
+    // given
+    uint8_t data[4];
+    ringBuffer_t ring;
+    ringBufferInit(&ring, data, sizeof(data));
+    uint8_t value;
+
+    // expect the indexes to keep running past the buffer size
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(ringBufferPush(&ring, i));
+        EXPECT_TRUE(ringBufferPush(&ring, i + 1));
+        EXPECT_TRUE(ringBufferPop(&ring, &value));
+        EXPECT_EQ(i, value);
+        EXPECT_TRUE(ringBufferPop(&ring, &value));
+        EXPECT_EQ(i + 1, value);
+    }
+    EXPECT_EQ(0, ringBufferUsed(&ring));
+}
+
+TEST(RingBufferTest, IndexOverflow)
+{
+    // given
+    uint8_t data[4];
+    ringBuffer_t ring;
+    ringBufferInit(&ring, data, sizeof(data));
+    ring.head = ring.tail = UINT32_MAX - 1;
+    uint8_t value;
+
+    // when
+    EXPECT_TRUE(ringBufferPush(&ring, 1));
+    EXPECT_TRUE(ringBufferPush(&ring, 2));
+    EXPECT_TRUE(ringBufferPush(&ring, 3));
+
+    // then
+    EXPECT_EQ(3, ringBufferUsed(&ring));
+    EXPECT_EQ(1, ringBufferFree(&ring));
+    EXPECT_TRUE(ringBufferPop(&ring, &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(ringBufferPop(&ring, &value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(ringBufferPop(&ring, &value));
+    EXPECT_EQ(3, value);
+}
+
+TEST(RingBufferTest, BlockWriteRead)
+{
+    // given
+    uint8_t data[16];
+    ringBuffer_t ring;
+    ringBufferInit(&ring, data, sizeof(data));
+    const uint8_t frame[6] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t out[6];
+
+    // when
+    EXPECT_TRUE(ringBufferWrite(&ring, frame, sizeof(frame)));
+    EXPECT_TRUE(ringBufferWrite(&ring, frame, sizeof(frame)));
+
+    // then a block that does not fit is refused as a whole
+    EXPECT_FALSE(ringBufferWrite(&ring, frame, sizeof(frame)));
+    EXPECT_EQ(12, ringBufferUsed(&ring));
+
+    EXPECT_TRUE(ringBufferRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(frame, out, sizeof(frame)));
+
+    // and the next block wraps around the end of the buffer
+    EXPECT_TRUE(ringBufferWrite(&ring, frame, sizeof(frame)));
+    EXPECT_TRUE(ringBufferRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(frame, out, sizeof(frame)));
+    EXPECT_TRUE(ringBufferRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(frame, out, sizeof(frame)));
+
+    // a partial block is not consumed
+    EXPECT_TRUE(ringBufferPush(&ring, 7));
+    EXPECT_FALSE(ringBufferRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(1, ringBufferUsed(&ring));
+}
+
+TEST(RingBufferTest, Flush)
+{
+    // given
+    uint8_t data[8];
+    ringBuffer_t ring;
+    ringBufferInit(&ring, data, sizeof(data));
+    uint8_t value;
+
+    // when
+    ringBufferPush(&ring, 1);
+    ringBufferPush(&ring, 2);
+    ringBufferFlush(&ring);
+
+    // then
+    EXPECT_EQ(0, ringBufferUsed(&ring));
+    EXPECT_FALSE(ringBufferPop(&ring, &value));
+    EXPECT_TRUE(ringBufferPush(&ring, 3));
+    EXPECT_TRUE(ringBufferPop(&ring, &value));
+    EXPECT_EQ(3, value);
+}
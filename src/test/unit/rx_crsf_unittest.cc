@@ -31,6 +31,7 @@ extern "C" {
     #include "pg/rx.h"
 
     #include "common/crc.h"
+    #include "common/ringbuffer.h"
     #include "common/utils.h"
 
     #include "drivers/serial.h"
@@ -46,10 +47,9 @@ extern "C" {
     uint8_t crsfFrameStatus(void);
     uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan);
 
-    extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
-    extern crsfFrame_t crsfChannelDataFrame;
-    extern uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+    extern ringBuffer_t crsfRcChannelsBuffer;
+    extern uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
     uint32_t dummyTimeUs;
 
@@ -119,17 +119,17 @@ TEST(CrossFireTest, CRC)
 
 TEST(CrossFireTest, TestCrsfFrameStatus)
 {
-    crsfFrameDone = true;
     crsfFrame.frame.deviceAddress = CRSF_ADDRESS_CRSF_RECEIVER;
     crsfFrame.frame.frameLength = 0;
     crsfFrame.frame.type = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
     memset(crsfFrame.frame.payload, 0, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
     const uint8_t crc = crsfFrameCRC();
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
+    ringBufferWrite(&crsfRcChannelsBuffer, crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
 
     const uint8_t status = crsfFrameStatus();
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
 
     EXPECT_EQ(CRSF_ADDRESS_CRSF_RECEIVER, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -147,7 +147,6 @@ TEST(CrossFireTest, TestCrsfFrameStatus)
  */
 TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
 {
-    crsfFrameDone = true;
     crsfFrame.frame.deviceAddress = CRSF_ADDRESS_CRSF_RECEIVER;
     crsfFrame.frame.frameLength = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;;
     crsfFrame.frame.type = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
@@ -177,10 +176,10 @@ TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
     const uint8_t crc = crsfFrameCRC();
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
 
-    memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+    ringBufferWrite(&crsfRcChannelsBuffer, crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
     const uint8_t status = crsfFrameStatus();
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
 
     EXPECT_EQ(CRSF_ADDRESS_CRSF_RECEIVER, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
@@ -221,13 +220,12 @@ TEST(CrossFireTest, TestCapturedData)
     //const int frameCount = sizeof(capturedData) / sizeof(crsfRcChannelsFrame_t);
     const crsfRcChannelsFrame_t *framePtr = (const crsfRcChannelsFrame_t*)capturedData;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
-    memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+    ringBufferWrite(&crsfRcChannelsBuffer, crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
     uint8_t status = crsfFrameStatus();
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -244,13 +242,12 @@ TEST(CrossFireTest, TestCapturedData)
 
     ++framePtr;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
-    memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+    ringBufferWrite(&crsfRcChannelsBuffer, crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
     status = crsfFrameStatus();
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_EQ(0, ringBufferUsed(&crsfRcChannelsBuffer));
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -265,12 +262,12 @@ TEST(CrossFireTest, TestCapturedData)
 
 TEST(CrossFireTest, TestCrsfDataReceive)
 {
-    crsfFrameDone = false; // data is not a valid rc channels frame so don't expect crsfFrameDone to be true
+    ringBufferFlush(&crsfRcChannelsBuffer);
     const uint8_t *pData = capturedData;
     for (unsigned int ii = 0; ii < sizeof(crsfRcChannelsFrame_t); ++ii) {
         crsfDataReceive(*pData++);
     }
-    EXPECT_EQ(true, crsfFrameDone);
+    EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE, ringBufferUsed(&crsfRcChannelsBuffer));
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
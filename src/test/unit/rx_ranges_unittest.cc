@@ -28,6 +28,7 @@ extern "C" {
     #include "pg/pg.h"
     #include "pg/pg_ids.h"
     #include "pg/rx.h"
+    #include "fc/fc_dispatch.h"
     #include "fc/rc_controls.h"
     #include "fc/rc_modes.h"
     #include "rx/rx.h"
@@ -43,6 +44,8 @@ PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
 boxBitmask_t rcModeActivationMask;
 int16_t debug[DEBUG16_VALUE_COUNT];
 uint8_t debugMode = 0;
+uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+uint8_t debugModeSlot[DEBUG_COUNT];
 
 extern uint16_t applyRxChannelRangeConfiguraton(int sample, const rxChannelRangeConfig_t *range);
 }
@@ -223,4 +226,8 @@ void failsafeOnValidDataFailed(void)
 {
 }
 
+void dispatchEnable(void) {}
+bool dispatchAdd(dispatchEntry_t *, int) { return true; }
+bool dispatchIsQueued(const dispatchEntry_t *) { return false; }
+
 }
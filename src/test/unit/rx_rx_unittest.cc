@@ -26,6 +26,7 @@ extern "C" {
     #include "pg/rx.h"
     #include "build/debug.h"
     #include "drivers/io.h"
+    #include "fc/fc_dispatch.h"
     #include "fc/rc_controls.h"
     #include "rx/rx.h"
     #include "fc/rc_modes.h"
@@ -39,6 +40,8 @@ extern "C" {
     boxBitmask_t rcModeActivationMask;
     int16_t debug[DEBUG16_VALUE_COUNT];
     uint8_t debugMode = 0;
+    uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+    uint8_t debugModeSlot[DEBUG_COUNT];
 
     bool isPulseValid(uint16_t pulseDuration);
 
@@ -204,6 +207,9 @@ extern "C" {
 
     void failsafeOnRxSuspend(uint32_t ) {}
     void failsafeOnRxResume(void) {}
+    void dispatchEnable(void) {}
+    bool dispatchAdd(dispatchEntry_t *, int) { return true; }
+    bool dispatchIsQueued(const dispatchEntry_t *) { return false; }
 
     uint32_t micros(void) { return 0; }
     uint32_t millis(void) { return 0; }
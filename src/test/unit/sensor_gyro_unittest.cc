@@ -46,6 +46,10 @@ extern "C" {
     STATIC_UNIT_TESTED bool fakeGyroRead(gyroDev_t *gyro);
 
     uint8_t debugMode;
+
+    uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+
+    uint8_t debugModeSlot[DEBUG_COUNT];
     int16_t debug[DEBUG16_VALUE_COUNT];
 }
 
@@ -0,0 +1,91 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+extern "C" {
+    #include "common/sphere_fit.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void addCirclePoints(sphereFit_t *fit, const float *center, float radius, float elevation, int count) {
+    for (int i = 0; i < count; i++) {
+        const float azimuth = 2.0f * M_PI * i / count;
+        const float sample[3] = {
+            center[0] + radius * cosf(elevation) * cosf(azimuth),
+            center[1] + radius * cosf(elevation) * sinf(azimuth),
+            center[2] + radius * sinf(elevation),
+        };
+        sphereFitAddSample(fit, sample);
+    }
+}
+
+TEST(SphereFitTest, FindsCenterAndRadius) {
+    const float center[3] = { 120.0f, -340.0f, 55.0f };
+    const float radius = 450.0f;
+    sphereFit_t fit;
+    const float reference[3] = { center[0] + radius, center[1], center[2] };
+    sphereFitInit(&fit, reference, radius);
+    for (int ring = -3; ring <= 3; ring++) {
+        addCirclePoints(&fit, center, radius, ring * 0.4f, 24);
+    }
+
+    float fitCenter[3];
+    float fitRadius;
+    EXPECT_TRUE(sphereFitSolve(&fit, fitCenter, &fitRadius));
+    EXPECT_NEAR(center[0], fitCenter[0], 0.5f);
+    EXPECT_NEAR(center[1], fitCenter[1], 0.5f);
+    EXPECT_NEAR(center[2], fitCenter[2], 0.5f);
+    EXPECT_NEAR(radius, fitRadius, 0.5f);
+}
+
+TEST(SphereFitTest, PartialCoverageStillFits) {
+    // a cap of the sphere is enough for noise free samples
+    const float center[3] = { -20.0f, 80.0f, -600.0f };
+    const float radius = 300.0f;
+    sphereFit_t fit;
+    sphereFitInit(&fit, center, radius);
+    addCirclePoints(&fit, center, radius, 0.9f, 16);
+    addCirclePoints(&fit, center, radius, 1.2f, 16);
+
+    float fitCenter[3];
+    float fitRadius;
+    EXPECT_TRUE(sphereFitSolve(&fit, fitCenter, &fitRadius));
+    EXPECT_NEAR(center[0], fitCenter[0], 1.0f);
+    EXPECT_NEAR(center[1], fitCenter[1], 1.0f);
+    EXPECT_NEAR(center[2], fitCenter[2], 1.0f);
+    EXPECT_NEAR(radius, fitRadius, 1.0f);
+}
+
+TEST(SphereFitTest, RejectsDegenerateSamples) {
+    const float center[3] = { 0.0f, 0.0f, 0.0f };
+    sphereFit_t fit;
+    sphereFitInit(&fit, center, 1.0f);
+
+    float fitCenter[3];
+    float fitRadius;
+    // too few samples
+    addCirclePoints(&fit, center, 1.0f, 0.3f, 5);
+    EXPECT_FALSE(sphereFitSolve(&fit, fitCenter, &fitRadius));
+
+    // a single circle lies on many spheres
+    sphereFitInit(&fit, center, 1.0f);
+    addCirclePoints(&fit, center, 1.0f, 0.0f, 36);
+    EXPECT_FALSE(sphereFitSolve(&fit, fitCenter, &fitRadius));
+}
@@ -84,7 +84,6 @@ extern "C" {
     PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
     PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG,0);
 
-    extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
     extern mspPackage_t mspPackage;
     extern uint8_t checksum;
@@ -116,7 +115,6 @@ TEST(CrossFireMSPTest, RequestBufferTest)
     initSharedMsp();
     const crsfMspFrame_t *framePtr = (const crsfMspFrame_t*)crsfPidRequest;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_EXT_TYPE_CRC + CRSF_FRAME_RX_MSP_FRAME_SIZE, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_MSP_REQ, crsfFrame.frame.type);
@@ -135,7 +133,6 @@ TEST(CrossFireMSPTest, ResponsePacketTest)
     initSharedMsp();
     const crsfMspFrame_t *framePtr = (const crsfMspFrame_t*)crsfPidRequest;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
     uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + 2;
     handleMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     for (unsigned int ii=1; ii<30; ii++) {
@@ -155,7 +152,6 @@ TEST(CrossFireMSPTest, WriteResponseTest)
     initSharedMsp();
     const crsfMspFrame_t *framePtr1 = (const crsfMspFrame_t*)crsfPidWrite1;
     crsfFrame = *(const crsfFrame_t*)framePtr1;
-    crsfFrameDone = true;
     uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool pending1 = handleMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_FALSE(pending1); // not done yet*/
@@ -167,7 +163,6 @@ TEST(CrossFireMSPTest, WriteResponseTest)
 
     const crsfMspFrame_t *framePtr2 = (const crsfMspFrame_t*)crsfPidWrite2;
     crsfFrame = *(const crsfFrame_t*)framePtr2;
-    crsfFrameDone = true;
     uint8_t *frameStart2 = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool pending2 = handleMspFrame(frameStart2, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_FALSE(pending2); // not done yet
@@ -181,7 +176,6 @@ TEST(CrossFireMSPTest, WriteResponseTest)
 
     const crsfMspFrame_t *framePtr3 = (const crsfMspFrame_t*)crsfPidWrite3;
     crsfFrame = *(const crsfFrame_t*)framePtr3;
-    crsfFrameDone = true;
     uint8_t *frameStart3 = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool pending3 = handleMspFrame(frameStart3, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_FALSE(pending3); // not done yet
@@ -195,7 +189,6 @@ TEST(CrossFireMSPTest, WriteResponseTest)
 
     const crsfMspFrame_t *framePtr4 = (const crsfMspFrame_t*)crsfPidWrite4;
     crsfFrame = *(const crsfFrame_t*)framePtr4;
-    crsfFrameDone = true;
     uint8_t *frameStart4 = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool pending4 = handleMspFrame(frameStart4, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_FALSE(pending4); // not done yet
@@ -210,7 +203,6 @@ TEST(CrossFireMSPTest, WriteResponseTest)
 
     const crsfMspFrame_t *framePtr5 = (const crsfMspFrame_t*)crsfPidWrite5;
     crsfFrame = *(const crsfFrame_t*)framePtr5;
-    crsfFrameDone = true;
     uint8_t *frameStart5 = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool pending5 = handleMspFrame(frameStart5, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_TRUE(pending5); // not done yet
@@ -232,7 +224,6 @@ TEST(CrossFireMSPTest, SendMspReply) {
     initSharedMsp();
     const crsfMspFrame_t *framePtr = (const crsfMspFrame_t*)crsfPidRequest;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
     uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + 2;
     bool handled = handleMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL);
     EXPECT_TRUE(handled);
@@ -239,6 +239,26 @@ void serialWrite(serialPort_t *instance, uint8_t ch)
 }
 
 
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    while (count--) {
+        serialWrite(instance, *data++);
+    }
+}
+
+
+void serialBeginWrite(serialPort_t *instance)
+{
+    EXPECT_EQ(&serialTestInstance, instance);
+}
+
+
+void serialEndWrite(serialPort_t *instance)
+{
+    EXPECT_EQ(&serialTestInstance, instance);
+}
+
+
 uint32_t serialRxBytesWaiting(const serialPort_t *instance)
 {
     EXPECT_EQ(&serialTestInstance, instance);
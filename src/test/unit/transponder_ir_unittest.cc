@@ -37,6 +37,10 @@ extern "C" {
     STATIC_UNIT_TESTED void updateTransponderDMABufferArcitimer(transponder_t *transponder, const uint8_t* transponderData);
 }
 
+static uint8_t toggleValue(const transponder_t *transponder, unsigned index) {
+    return transponderIrToggleHasCarrier(transponder, index) ? transponder->bitToggleOne : 0;
+}
+
 TEST(transponderTest, updateTransponderDMABufferArcitimer) {
     //input
     uint8_t data[9] = {0x1F, 0xFC, 0x8F, 0x3, 0xF0, 0x1, 0xF8, 0x1F, 0x0};
@@ -58,14 +62,14 @@ TEST(transponderTest, updateTransponderDMABufferArcitimer) {
     };
     uint8_t* transponderData = data;
     transponder_t transponder;
-    transponder.dma_buffer_size = TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER;
+    transponder.toggle_count = TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER;
     transponder.bitToggleOne = 78;
-    memset(&(transponder.transponderIrDMABuffer.arcitimer), 0, TRANSPONDER_DMA_BUFFER_SIZE_ARCITIMER);
+    memset(transponder.toggles, 0, sizeof(transponder.toggles));
 
     updateTransponderDMABufferArcitimer(&transponder, transponderData);
     uint16_t i;
-    for(i = 0; i < transponder.dma_buffer_size; i++) {
-        EXPECT_EQ(transponder.transponderIrDMABuffer.arcitimer[i], excepted[i]);
+    for(i = 0; i < transponder.toggle_count; i++) {
+        EXPECT_EQ(toggleValue(&transponder, i), excepted[i]);
     }
 }
 
@@ -94,13 +98,41 @@ TEST(transponderTest, updateTransponderDMABufferIlap) {
 
     uint8_t* transponderData = data;
     transponder_t transponder;
-    transponder.dma_buffer_size = TRANSPONDER_DMA_BUFFER_SIZE_ILAP;
+    transponder.toggle_count = TRANSPONDER_DMA_BUFFER_SIZE_ILAP;
     transponder.bitToggleOne = 78;
 
     updateTransponderDMABufferIlap(&transponder, transponderData);
 
      uint16_t i;
-     for(i = 0; i < transponder.dma_buffer_size; i++) {
-        EXPECT_EQ(transponder.transponderIrDMABuffer.ilap[i], excepted[i]);
+     for(i = 0; i < transponder.toggle_count; i++) {
+        EXPECT_EQ(toggleValue(&transponder, i), excepted[i]);
      }
 }
+
+TEST(transponderTest, dmaRingSendsPulseTrain) {
+    uint8_t data[9] = {0x1F, 0xFC, 0x8F, 0x3, 0xF0, 0x1, 0x0, 0x0, 0x0};
+    transponder_t transponder;
+    transponder.toggle_count = TRANSPONDER_DMA_BUFFER_SIZE_ILAP;
+    transponder.bitToggleOne = 78;
+    updateTransponderDMABufferIlap(&transponder, data);
+
+    // play the DMA: read the ring in a circle and refill each half when it has been sent
+    transponderIrStartDMARing(&transponder);
+    unsigned sent = 0;
+    bool complete = false;
+    while (!complete) {
+        ASSERT_LT(sent, 2u * TRANSPONDER_DMA_BUFFER_SIZE_ILAP);
+        const unsigned slot = sent % TRANSPONDER_DMA_RING_SIZE;
+        const uint8_t expected = sent < transponder.toggle_count ? toggleValue(&transponder, sent) : 0;
+        EXPECT_EQ(expected, transponder.dmaRing[slot]);
+        sent++;
+        if (slot == TRANSPONDER_DMA_RING_SIZE / 2 - 1) {
+            complete = transponderIrRefillDMARing(&transponder, false);
+        } else if (slot == TRANSPONDER_DMA_RING_SIZE - 1) {
+            complete = transponderIrRefillDMARing(&transponder, true);
+        }
+    }
+    // all of the train and a quiet period after it went out, stopping within a half of the end
+    EXPECT_GT(sent, transponder.toggle_count);
+    EXPECT_LE(sent, transponder.toggle_count + TRANSPONDER_DMA_RING_SIZE / 2 + 1);
+}
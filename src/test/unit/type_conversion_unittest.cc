@@ -0,0 +1,84 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/typeconversion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(TypeConversionTest, FormatInt)
+{
+    char buf[16];
+
+    EXPECT_EQ(buf + 3, formatInt(buf, 125, 0, ' '));
+    EXPECT_STREQ("125", buf);
+    formatInt(buf, 0, 0, ' ');
+    EXPECT_STREQ("0", buf);
+    formatInt(buf, 7, 3, ' ');
+    EXPECT_STREQ("  7", buf);
+    formatInt(buf, 7, 3, '0');
+    EXPECT_STREQ("007", buf);
+    formatInt(buf, -7, 3, ' ');
+    EXPECT_STREQ(" -7", buf);
+    formatInt(buf, -7, 4, '0');
+    EXPECT_STREQ("-007", buf);
+    // wider than the field
+    formatInt(buf, 12345, 3, ' ');
+    EXPECT_STREQ("12345", buf);
+    formatInt(buf, INT32_MIN, 0, ' ');
+    EXPECT_STREQ("-2147483648", buf);
+}
+
+TEST(TypeConversionTest, FormatFixed)
+{
+    char buf[16];
+
+    EXPECT_EQ(buf + 4, formatFixed(buf, 126, 1, 0));
+    EXPECT_STREQ("12.6", buf);
+    formatFixed(buf, 56, 1, 4);
+    EXPECT_STREQ(" 5.6", buf);
+    formatFixed(buf, 5, 2, 0);
+    EXPECT_STREQ("0.05", buf);
+    formatFixed(buf, -1234, 2, 7);
+    EXPECT_STREQ(" -12.34", buf);
+    formatFixed(buf, -5, 1, 0);
+    EXPECT_STREQ("-0.5", buf);
+    formatFixed(buf, 42, 0, 3);
+    EXPECT_STREQ(" 42", buf);
+}
+
+TEST(TypeConversionTest, FormatTime)
+{
+    char buf[16];
+
+    EXPECT_EQ(buf + 5, formatTime(buf, 0));
+    EXPECT_STREQ("00:00", buf);
+    formatTime(buf, 65);
+    EXPECT_STREQ("01:05", buf);
+    formatTime(buf, 100 * 60 + 59);
+    EXPECT_STREQ("100:59", buf);
+
+    // chains with the other formatters
+    char *end = formatTime(buf, 3599);
+    *end++ = '.';
+    formatInt(end, 7, 2, '0');
+    EXPECT_STREQ("59:59.07", buf);
+}
@@ -65,6 +65,8 @@ extern "C" {
     uint16_t averageSystemLoadPercent = 0;
     uint8_t cliMode = 0;
     uint8_t debugMode = 0;
+    uint8_t debugModes[DEBUG_MODE_SLOT_COUNT];
+    uint8_t debugModeSlot[DEBUG_COUNT];
     int16_t debug[DEBUG16_VALUE_COUNT];
     pidProfile_t *currentPidProfile;
     controlRateConfig_t *currentControlRateProfile;
@@ -102,6 +104,7 @@ TEST(VtxTest, PitMode)
     modeActivationConditionsMutable(0)->modeId = BOXVTXPITMODE;
     modeActivationConditionsMutable(0)->range.startStep = CHANNEL_VALUE_TO_STEP(1750);
     modeActivationConditionsMutable(0)->range.endStep = CHANNEL_VALUE_TO_STEP(CHANNEL_RANGE_MAX);
+    analyzeModeActivationConditions();
 
     // and
     vtxSettingsConfigMutable()->band = 0;
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Turn a flash dump with blackbox_compression = ON logs back into plain logs.
+
+usage: blackbox_inflate.py <flash dump> <output.bbl>
+
+Compressed logs are written as blocks of 'B' 'Z', method, log byte count,
+payload length, payload. Method 1 payloads are coded with the huffman table of
+src/main/common/huffman_table.c, method 0 payloads are the log bytes as they
+are. Plain logs in the dump are copied through unchanged.
+"""
+
+import os
+import re
+import sys
+
+SYNC = b"BZ"
+HEADER_SIZE = 5
+STORED = 0
+HUFFMAN = 1
+LOG_START = b"H Product:"
+
+TABLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "main", "common", "huffman_table.c")
+TABLE_ENTRY = re.compile(r"^\s*\{\s*(\d+),\s*0x([0-9A-Fa-f]+)\s*\},")
+
+
+def read_codes(path):
+    """{(length, code): byte} from the C table, without the EOF code"""
+    codes = {}
+    with open(path) as table:
+        for line in table:
+            match = TABLE_ENTRY.match(line)
+            if match and len(codes) < 256:
+                length = int(match.group(1))
+                codes[(length, int(match.group(2), 16) >> (16 - length))] = len(codes)
+    return codes
+
+
+def huffman_decode(payload, count, codes):
+    out = bytearray()
+    length = code = 0
+    for byte in payload:
+        for bit in range(7, -1, -1):
+            code = (code << 1) | ((byte >> bit) & 1)
+            length += 1
+            symbol = codes.get((length, code))
+            if symbol is not None:
+                out.append(symbol)
+                if len(out) == count:
+                    return bytes(out)
+                length = code = 0
+            elif length > 16:
+                return None
+    return None
+
+
+def decode_block(data, pos, codes):
+    """(log bytes, block size) for a block at pos, None when there isn't a valid one"""
+    if data[pos:pos + 2] != SYNC or pos + HEADER_SIZE > len(data):
+        return None
+    method, count, size = data[pos + 2], data[pos + 3], data[pos + 4]
+    payload = data[pos + HEADER_SIZE:pos + HEADER_SIZE + size]
+    if not count or len(payload) != size:
+        return None
+    if method == STORED and size == count:
+        return payload, HEADER_SIZE + size
+    if method == HUFFMAN and size < count:
+        decoded = huffman_decode(payload, count, codes)
+        if decoded is not None:
+            return decoded, HEADER_SIZE + size
+    return None
+
+
+def compressed_log_at(data, pos, codes):
+    block = decode_block(data, pos, codes)
+    return block is not None and block[0].startswith(LOG_START[:len(block[0])])
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+    codes = read_codes(TABLE)
+    with open(sys.argv[1], "rb") as dump:
+        data = dump.read()
+    logs = blocks = 0
+    pos = 0
+    with open(sys.argv[2], "wb") as out:
+        while pos < len(data):
+            start = data.find(SYNC, pos)
+            while start >= 0 and not compressed_log_at(data, start, codes):
+                start = data.find(SYNC, start + 1)
+            if start < 0:
+                out.write(data[pos:])
+                break
+            out.write(data[pos:start])
+            logs += 1
+            pos = start
+            while True:
+                block = decode_block(data, pos, codes)
+                if block is None:
+                    break
+                out.write(block[0])
+                pos += block[1]
+                blocks += 1
+    print("%d compressed logs, %d blocks" % (logs, blocks))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
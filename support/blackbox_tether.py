@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Collect a blackbox log streamed with blackbox_device = USB into a .bbl file.
+
+usage: blackbox_tether.py <serial device or capture file> <output.bbl>
+
+Packets are 0xBB 0x7E, sequence, length (u16 LE), payload, crc16 ccitt (u16 LE)
+over sequence, length and payload. Anything else on the port, like MSP replies,
+is skipped. Runs until ctrl-c, or to the end of a capture file.
+"""
+
+import os
+import sys
+import termios
+
+SYNC = b"\xbb\x7e"
+HEADER_SIZE = 5
+CRC_SIZE = 2
+MAX_PAYLOAD = 512
+
+
+def crc16_ccitt(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def open_input(path):
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        attrs = termios.tcgetattr(fd)
+        attrs[0] = 0                                    # iflag
+        attrs[1] = 0                                    # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                    # lflag, raw
+        attrs[6][termios.VMIN] = 1
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+    fd = open_input(sys.argv[1])
+    packets = lost = bad = 0
+    expected = None
+    pending = b""
+    with open(sys.argv[2], "wb") as out:
+        try:
+            while True:
+                data = os.read(fd, 4096)
+                if not data:
+                    break
+                pending += data
+                while True:
+                    start = pending.find(SYNC)
+                    if start < 0:
+                        pending = pending[-1:]
+                        break
+                    pending = pending[start:]
+                    if len(pending) < HEADER_SIZE:
+                        break
+                    length = pending[3] | (pending[4] << 8)
+                    if length > MAX_PAYLOAD:
+                        pending = pending[1:]
+                        continue
+                    size = HEADER_SIZE + length + CRC_SIZE
+                    if len(pending) < size:
+                        break
+                    crc = pending[size - 2] | (pending[size - 1] << 8)
+                    if crc16_ccitt(pending[2:HEADER_SIZE + length]) != crc:
+                        bad += 1
+                        pending = pending[1:]
+                        continue
+                    sequence = pending[2]
+                    if expected is not None and sequence != expected:
+                        lost += (sequence - expected) & 0xFF
+                    expected = (sequence + 1) & 0xFF
+                    out.write(pending[HEADER_SIZE:HEADER_SIZE + length])
+                    packets += 1
+                    pending = pending[size:]
+        except KeyboardInterrupt:
+            pass
+    os.close(fd)
+    print("%d packets, %d lost, %d bad crc" % (packets, lost, bad))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Generate the compact CLI setting names for interface/settings.c.
+
+usage: cli_name_pool.py <preprocessed settings.c> <output.inc>
+
+The input is settings.c run through the preprocessor of the target build
+without USE_CLI_NAME_POOL, so every #ifdef of valueTable is already resolved.
+The setting names are split at '_' into tokens. Every distinct token is stored
+once in cliNameTokens[], and each name becomes a string of token codes in
+cliNameCodes[], terminated by 0. The 239 most used tokens have one byte codes
+(1 to 0xEF), the rest two bytes (0xF0 + high bits, low byte). Names whose codes
+are the tail of another name, and tokens that end another token, share the
+bytes of the longer one. The output is valueTable again with the name of each
+entry swapped for the position of its codes; settings.c includes it in place
+of its own table and clivalueName() turns the codes back into the name.
+
+The output file is only rewritten when its content changes.
+"""
+
+import os
+import re
+import sys
+
+SHORT_CODES = 0xF0
+MAX_TOKENS = SHORT_CODES - 1 + 16 * 256
+
+TABLE_START = re.compile(r"\bconst\s+clivalue_t\s+valueTable\s*\[\s*\]\s*=\s*\{")
+ENTRY_NAME = re.compile(r'^\{\s*"([^"\\]*)"\s*,')
+
+
+def table_entries(source):
+    """the initializer text of every valueTable entry"""
+    match = TABLE_START.search(source)
+    if not match:
+        raise ValueError("valueTable not found")
+    entries = []
+    depth = 0
+    start = None
+    in_string = False
+    pos = match.end()
+    while pos < len(source):
+        char = source[pos]
+        if in_string:
+            if char == "\\":
+                pos += 1
+            elif char == '"':
+                in_string = False
+        elif char == '"':
+            in_string = True
+        elif char == "{":
+            if depth == 0:
+                start = pos
+            depth += 1
+        elif char == "}":
+            if depth == 0:
+                return entries
+            depth -= 1
+            if depth == 0:
+                entries.append(" ".join(source[start:pos + 1].split()))
+        pos += 1
+    raise ValueError("valueTable is not terminated")
+
+
+def shared_tails(items):
+    """{item: position} in a pool where an item ending a longer one is stored as its tail"""
+    pool = []
+    position = {}
+    size = 0
+    for item in sorted(set(items), key=len, reverse=True):
+        for placed, at in pool:
+            if placed.endswith(item):
+                position[item] = at + len(placed) - len(item)
+                break
+        else:
+            pool.append((item, size))
+            position[item] = size
+            size += len(item) + 1  # terminator
+    return pool, position
+
+
+def encode(token_rank):
+    if token_rank < SHORT_CODES - 1:
+        return bytes([token_rank + 1])
+    token_rank -= SHORT_CODES - 1
+    return bytes([SHORT_CODES + (token_rank >> 8), token_rank & 0xFF])
+
+
+def c_string(text):
+    return '"%s\\0"' % text
+
+
+def generate(source):
+    entries = table_entries(source)
+    names = []
+    for entry in entries:
+        match = ENTRY_NAME.match(entry)
+        if not match:
+            raise ValueError("entry without a name: %s" % entry)
+        names.append(match.group(1))
+
+    uses = {}
+    for name in names:
+        for token in name.split("_"):
+            uses[token] = uses.get(token, 0) + 1
+    tokens = sorted(uses, key=lambda token: (-uses[token], token))
+    if len(tokens) > MAX_TOKENS:
+        raise ValueError("%d tokens, at most %d have codes" % (len(tokens), MAX_TOKENS))
+    rank = {token: index for index, token in enumerate(tokens)}
+
+    token_pool, token_position = shared_tails(tokens)
+    codes = {name: b"".join(encode(rank[token]) for token in name.split("_")) for name in names}
+    code_pool, code_position = shared_tails(codes.values())
+
+    lines = [
+        "/* generated by support/cli_name_pool.py from interface/settings.c, do not edit */",
+        "",
+        "static const char cliNameTokens[] =",
+    ]
+    lines += ["    %s" % c_string(token) for token, _ in token_pool]
+    lines[-1] += ";"
+    lines += ["", "static const uint16_t cliNameTokenOffset[] = {"]
+    for first in range(0, len(tokens), 12):
+        lines.append("    " + " ".join("%d," % token_position[token] for token in tokens[first:first + 12]))
+    lines += ["};", "", "static const uint8_t cliNameCodes[] = {"]
+    for placed, _ in code_pool:
+        lines.append("    " + " ".join("0x%02x," % byte for byte in placed) + " 0,")
+    lines += ["};", "", "const clivalue_t valueTable[] = {"]
+    for name, entry in zip(names, entries):
+        lines.append("    " + ENTRY_NAME.sub("{ %d," % code_position[codes[name]], entry) + ",")
+    lines += [
+        "};",
+        "",
+        "STATIC_ASSERT(%d < CLIVALUE_NAME_LENGTH, cli_name_too_long);" % max(len(name) for name in names),
+        "",
+    ]
+    sizes = (len(names), sum(len(name) + 1 for name in names),
+             sum(len(token) + 1 for token, _ in token_pool) + 2 * len(tokens) + sum(len(placed) + 1 for placed, _ in code_pool))
+    return "\n".join(lines), sizes
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+    with open(sys.argv[1]) as preprocessed:
+        source = preprocessed.read()
+    try:
+        output, sizes = generate(source)
+    except ValueError as error:
+        sys.stderr.write("cli_name_pool.py: %s\n" % error)
+        return 1
+    if os.path.exists(sys.argv[2]):
+        with open(sys.argv[2]) as current:
+            if current.read() == output:
+                return 0
+    with open(sys.argv[2], "w") as inc:
+        inc.write(output)
+    print("CLI names: %d settings, %d bytes of names packed into %d" % sizes)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
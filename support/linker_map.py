@@ -0,0 +1,204 @@
+"""GNU ld map file parsing shared by the support/ build reports.
+
+parse() returns the memory regions, the allocated output and input sections
+and the cross reference table (-Wl,--cref). attribute() splits an input
+section between the modules (object paths below the object directory, like
+flight/pid) that defined it. With LTO the input sections come from ltrans
+objects, so their symbols are looked up in the cross reference table.
+"""
+
+import os
+import re
+
+# sections the map lists at address 0, on top of the ITCM, without taking memory
+NOT_ALLOCATED = (".debug", ".comment", ".ARM.attributes", ".stab", ".note", "/DISCARD/")
+
+HEX = r"0x[0-9a-fA-F]+"
+OUTPUT_SECTION = re.compile(r"^(\S+)\s+(%s)\s+(%s)(.*)$" % (HEX, HEX))
+INPUT_SECTION = re.compile(r"^ (\.\S+|COMMON)(?:\s+(%s)\s+(%s)\s+(.+))?$" % (HEX, HEX))
+SECTION_TAIL = re.compile(r"^\s+(%s)\s+(%s)(.*)$" % (HEX, HEX))
+SYMBOL_LINE = re.compile(r"^\s+(%s)\s+([A-Za-z_][A-Za-z0-9_.$]*)$" % HEX)
+REGION_LINE = re.compile(r"^(\S+)\s+(%s)\s+(%s)\s*(\S*)" % (HEX, HEX))
+
+
+class Region(object):
+    def __init__(self, name, origin, length, attributes):
+        self.name = name
+        self.origin = origin
+        self.length = length
+        self.attributes = attributes
+
+    def contains(self, address):
+        return self.origin <= address < self.origin + self.length
+
+    def is_read_only(self):
+        return "x" in self.attributes and "w" not in self.attributes
+
+
+class OutputSection(object):
+    def __init__(self, name, address, size, loaded):
+        self.name = name
+        self.address = address
+        self.size = size
+        self.loaded = loaded  # has a separate load address, initialised RAM or code copied to a TCM
+
+
+class InputSection(object):
+    def __init__(self, name, address, size, objfile, output):
+        self.name = name
+        self.address = address
+        self.size = size
+        self.objfile = objfile
+        self.output = output
+        self.symbols = []
+
+
+class LinkerMap(object):
+    def __init__(self):
+        self.regions = {}
+        self.output_sections = []
+        self.input_sections = []
+        self.cref = {}
+
+    def region_of(self, address):
+        for region in self.regions.values():
+            if region.name != "*default*" and region.contains(address):
+                return region
+        return None
+
+
+def parse(path):
+    result = LinkerMap()
+    with open(path) as mapfile:
+        lines = mapfile.read().splitlines()
+
+    state = None
+    pending_output = None
+    pending_input = None
+    output = None
+    current = None
+    cref_symbol = None
+
+    def start_output(name, address, size, rest):
+        section = OutputSection(name, int(address, 16), int(size, 16), "load address" in rest)
+        if not name.startswith(NOT_ALLOCATED):
+            result.output_sections.append(section)
+            return section
+        return None
+
+    def start_input(name, address, size, objfile):
+        if output is None:
+            return None
+        section = InputSection(name, int(address, 16), int(size, 16), objfile.strip(), output)
+        result.input_sections.append(section)
+        return section
+
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            state = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "layout"
+            continue
+        if line.startswith("Cross Reference Table"):
+            state = "cref"
+            continue
+
+        if state == "memory":
+            match = REGION_LINE.match(line)
+            if match:
+                result.regions[match.group(1)] = Region(match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4))
+        elif state == "layout":
+            # long section names are on a line of their own, address and size follow
+            if pending_output is not None:
+                match = SECTION_TAIL.match(line)
+                output = start_output(pending_output, match.group(1), match.group(2), match.group(3)) if match else None
+                pending_output = None
+                current = None
+                continue
+            if pending_input is not None:
+                match = SECTION_TAIL.match(line)
+                current = start_input(pending_input, match.group(1), match.group(2), match.group(3)) if match else None
+                pending_input = None
+                continue
+            match = OUTPUT_SECTION.match(line)
+            if match:
+                output = start_output(*match.groups())
+                current = None
+                continue
+            if line.startswith((".", "/")) and len(line.split()) == 1:
+                pending_output = line
+                continue
+            match = INPUT_SECTION.match(line)
+            if match:
+                if match.group(2) is None:
+                    pending_input = match.group(1)
+                    current = None
+                else:
+                    current = start_input(*match.groups())
+                continue
+            match = SYMBOL_LINE.match(line)
+            if match and current is not None:
+                current.symbols.append((int(match.group(1), 16), match.group(2)))
+        elif state == "cref":
+            if not line.strip() or line.startswith("Symbol"):
+                continue
+            if not line[0].isspace():
+                words = line.split(None, 1)
+                cref_symbol = words[0]
+                defined = words[1] if len(words) > 1 else ""
+            elif cref_symbol is not None:
+                defined = line
+            else:
+                continue
+            # the defining file comes first, skip the ltrans copy LTO adds
+            defined = defined.replace("(symbol from plugin)", "").strip()
+            if defined and "ltrans" not in defined:
+                result.cref.setdefault(cref_symbol, defined)
+    return result
+
+
+def module_of(objfile, objdir):
+    """flight/pid for <objdir>/flight/pid.o, the archive or object name outside it, None for LTO output"""
+    if "ltrans" in objfile:
+        return None
+    objfile = os.path.normpath(objfile)
+    objdir = os.path.normpath(objdir)
+    if objfile.startswith(objdir + os.sep):
+        return os.path.splitext(objfile[len(objdir) + 1:])[0]
+    archive = re.match(r"^(.*\.a)\(", objfile)
+    if archive:
+        return os.path.splitext(os.path.basename(archive.group(1)))[0]
+    return os.path.splitext(os.path.basename(objfile))[0]
+
+
+def subsystem_of(module):
+    """the directory under src/main, library code and top level objects are 'lib'"""
+    if module == "unattributed":
+        return module
+    return module.split(os.sep)[0] if os.sep in module else "lib"
+
+
+def attribute(section, cref, objdir):
+    """[(module, bytes)] for an input section"""
+    owner = module_of(section.objfile, objdir)
+    if owner is not None:
+        return [(owner, section.size)]
+
+    # LTO output: split the section at its global symbols and look each one up
+    def lookup(symbol):
+        defined = cref.get(symbol)
+        return module_of(defined, objdir) if defined else None
+
+    parts = section.name.split(".")
+    fallback = lookup(parts[2]) if len(parts) > 2 else None
+    end_of_section = section.address + section.size
+    boundaries = sorted(s for s in section.symbols if section.address <= s[0] < end_of_section)
+    if not boundaries or boundaries[0][0] != section.address:
+        boundaries.insert(0, (section.address, None))
+    chunks = []
+    for index, (start, symbol) in enumerate(boundaries):
+        end = boundaries[index + 1][0] if index + 1 < len(boundaries) else end_of_section
+        owner = (lookup(symbol) if symbol else None) or fallback or "unattributed"
+        chunks.append((owner, end - start))
+    return chunks
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Per subsystem and per module flash and RAM usage from the linker map.
+
+usage: size_report.py <map file> <object dir> [<modules to list>]
+
+text is code and constants, data initialised variables (in flash and RAM),
+bss zeroed variables. Modules are the object paths below the object
+directory, like flight/pid, subsystems their directory under src/main.
+Sections from LTO ltrans objects are split at their global symbols and
+attributed through the cross reference table (-Wl,--cref), code inlined into
+another module is counted there. The largest 40 modules are listed unless
+another count is given, 0 lists all of them.
+"""
+
+import sys
+
+from linker_map import attribute, subsystem_of
+from linker_map import parse as linker_map_parse
+
+TEXT, DATA, BSS = range(3)
+
+
+def add(usage, owner, kind, size):
+    sizes = usage.setdefault(owner, [0, 0, 0])
+    sizes[kind] += size
+
+
+def print_table(title, usage, limit=0):
+    rows = sorted(usage.items(), key=lambda item: (-(item[1][TEXT] + item[1][DATA]), item[0]))
+    if limit:
+        rows = rows[:limit]
+    print("%8s %8s %8s %8s  %s" % ("text", "data", "bss", "flash", title))
+    for owner, sizes in rows:
+        print("%8d %8d %8d %8d  %s" % (sizes[TEXT], sizes[DATA], sizes[BSS], sizes[TEXT] + sizes[DATA], owner))
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        sys.stderr.write(__doc__)
+        return 1
+    linker_map = linker_map_parse(sys.argv[1])
+    objdir = sys.argv[2]
+    limit = int(sys.argv[3]) if len(sys.argv) == 4 else 40
+
+    modules = {}
+    for section in linker_map.input_sections:
+        region = linker_map.region_of(section.address)
+        if region is None or not section.size:
+            continue
+        if region.is_read_only():
+            kind = TEXT
+        elif section.output.loaded:
+            kind = DATA
+        else:
+            kind = BSS
+        for module, size in attribute(section, linker_map.cref, objdir):
+            add(modules, module, kind, size)
+
+    subsystems = {}
+    for module, sizes in modules.items():
+        for kind in (TEXT, DATA, BSS):
+            add(subsystems, subsystem_of(module), kind, sizes[kind])
+    totals = [sum(sizes[kind] for sizes in modules.values()) for kind in (TEXT, DATA, BSS)]
+
+    print_table("subsystem", subsystems)
+    print("%8d %8d %8d %8d  total" % (totals[TEXT], totals[DATA], totals[BSS], totals[TEXT] + totals[DATA]))
+    print("")
+    print_table("module", modules, limit)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Profile driven ITCM/DTCM placement for F7 builds, and a usage report.
+
+usage: tcm_profile.py ld <profile> <output dir>
+       tcm_profile.py report <map file> <object dir>
+
+The profile is a text file with one symbol per line, taken from a profiling
+run (e.g. sampled PCs or the blackbox loop timings of the hot tasks):
+
+    # filters, PID, mixer, scheduler, DShot
+    code pidController
+    code biquadFilterApply
+    data gyro
+
+'code' symbols are linked into ITCM (.tcm_code), 'data' symbols into DTCM
+(.fastram_data / .fastram_bss). A bare symbol is taken as code. The build is
+done with -ffunction-sections -fdata-sections so every symbol has its own
+input section, and 'ld' writes the linker script fragments included by
+stm32_flash_f7_split.ld. The fragments are only rewritten when their content
+changes, so an unchanged profile does not force a relink.
+
+'report' reads the linker map and prints how much of ITCM_RAM and DTCM_RAM
+each subsystem (the directory under src/main) takes. With LTO the input
+sections come from ltrans objects, so symbols are attributed through the
+cross reference table (-Wl,--cref).
+"""
+
+import os
+import re
+import sys
+
+from linker_map import attribute, subsystem_of
+from linker_map import parse as linker_map_parse
+
+FRAGMENTS = {
+    "tcm_profile_code.ld": ("code", (".text",)),
+    "tcm_profile_data.ld": ("data", (".data",)),
+    "tcm_profile_bss.ld": ("data", (".bss",)),
+}
+
+REGIONS = ("ITCM_RAM", "DTCM_RAM")
+
+SYMBOL = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+
+def read_profile(path):
+    entries = {"code": [], "data": []}
+    with open(path) as profile:
+        for number, line in enumerate(profile, 1):
+            words = line.split("#", 1)[0].split()
+            if not words:
+                continue
+            if len(words) == 1:
+                words.insert(0, "code")
+            kind, name = words[0], words[1]
+            if len(words) != 2 or kind not in entries or not SYMBOL.match(name):
+                raise SystemExit("%s:%d: expected '[code|data] <symbol>'" % (path, number))
+            if name not in entries[kind]:
+                entries[kind].append(name)
+    return entries
+
+
+def write_if_changed(path, text):
+    try:
+        with open(path) as current:
+            if current.read() == text:
+                return
+    except OSError:
+        pass
+    with open(path, "w") as out:
+        out.write(text)
+
+
+def generate_fragments(profile, outdir):
+    entries = read_profile(profile)
+    os.makedirs(outdir, exist_ok=True)
+    for filename, (kind, prefixes) in FRAGMENTS.items():
+        lines = ["/* generated by support/tcm_profile.py from %s */\n" % profile]
+        for name in entries[kind]:
+            # .lto_priv.N, .constprop.N, .isra.N... clones keep the base name
+            patterns = " ".join("%s.%s %s.%s.*" % (p, name, p, name) for p in prefixes)
+            lines.append("    *(%s)\n" % patterns)
+        write_if_changed(os.path.join(outdir, filename), "".join(lines))
+    return 0
+
+
+def report(mappath, objdir):
+    linker_map = linker_map_parse(mappath)
+    status = 0
+    for name in REGIONS:
+        region = linker_map.regions.get(name)
+        if region is None:
+            continue
+        used = sum(section.size for section in linker_map.output_sections if region.contains(section.address))
+        usage = {}
+        for section in linker_map.input_sections:
+            if region.contains(section.address) and section.size:
+                for module, size in attribute(section, linker_map.cref, objdir):
+                    owner = subsystem_of(module)
+                    usage[owner] = usage.get(owner, 0) + size
+        attributed = sum(usage.values())
+        if used > attributed:
+            usage["(stack, heap, alignment)"] = used - attributed
+
+        print("%s: %d of %d bytes (%.1f%%)" % (name, used, region.length, 100.0 * used / region.length))
+        for owner, size in sorted(usage.items(), key=lambda item: -item[1]):
+            print("    %-28s %7d  %5.1f%%" % (owner, size, 100.0 * size / region.length))
+        if used > region.length:
+            status = 1
+    return status
+
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == "ld":
+        return generate_fragments(sys.argv[2], sys.argv[3])
+    if len(sys.argv) == 4 and sys.argv[1] == "report":
+        return report(sys.argv[2], sys.argv[3])
+    sys.stderr.write(__doc__)
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())